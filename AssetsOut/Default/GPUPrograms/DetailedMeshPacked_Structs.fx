@@ -0,0 +1,38 @@
+#ifndef HLSL_DETAILEDMESHPACKED_STRUCTS
+#define HLSL_DETAILEDMESHPACKED_STRUCTS
+
+#include "DetailedMesh_Structs.fx"
+#include "vertexpackinghelper.fx"
+
+//------------------------------------------------------------------------------
+// structures
+//------------------------------------------------------------------------------
+
+// tex coord is half float, normal and tangent are octahedral encoded snorm16
+// output is the same as DetailedMesh so pixel shaders are shared
+struct DETAILED_MESH_PACKED_VS_IN
+{
+    float3 iPosL      API_SEMANTIC(VSIN_POSITION);
+    float2 iTexCoord  API_SEMANTIC(TEXCOORD0);
+    float2 iNormal    API_SEMANTIC(VSIN_NORMAL);
+    float2 iTangent   API_SEMANTIC(VSIN_TANGENT);
+};
+
+// packed formats are only supported on d3d9 and d3d11
+
+// shader function entry and exit decalration /////////////////////////////////////////////
+
+#define VS_wrapper_DETAILED_MESH_PACKED(func) \
+    DETAILED_MESH_PS_IN main(DETAILED_MESH_PACKED_VS_IN API_NOSTRIP vIn) { \
+        DETAILED_MESH_PS_IN pIn; \
+        pIn = func(vIn); \
+        return pIn; \
+    }
+#define VS_wrapper_DETAILED_MESH_PACKED_SHADOWED(func) \
+    DETAILED_MESH_SHADOWED_PS_IN main(DETAILED_MESH_PACKED_VS_IN API_NOSTRIP vIn) { \
+        DETAILED_MESH_SHADOWED_PS_IN pIn; \
+        pIn = func(vIn); \
+        return pIn; \
+    }
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef HLSL_DETAILEDSKINPACKED_STRUCTS
+#define HLSL_DETAILEDSKINPACKED_STRUCTS
+
+#include "DetailedMeshPacked_Structs.fx"
+
+//------------------------------------------------------------------------------
+// structures
+//------------------------------------------------------------------------------
+
+// joint weights and indices are unorm8. unused slots have 0 weight and joint 0
+struct DETAILED_SKIN_PACKED_VS_IN
+{
+	float3 iPosL        API_SEMANTIC(VSIN_POSITION);
+	float4 jointWeights  API_SEMANTIC(VSIN_JOINTWEIGHTS0);
+	#if DEFAULT_SKIN_WEIGHTS_PER_VERTEX == 8
+		float4 jointWeights1 API_SEMANTIC(VSIN_JOINTWEIGHTS1);
+	#endif
+
+	float4 jointIndices  API_SEMANTIC(VSIN_BONEINDICES0);
+	#if DEFAULT_SKIN_WEIGHTS_PER_VERTEX == 8
+		float4 jointIndices1 API_SEMANTIC(VSIN_BONEINDICES1);
+	#endif
+
+	float2 iTexCoord    API_SEMANTIC(TEXCOORD0);
+	float2 iNormal      API_SEMANTIC(VSIN_NORMAL);
+	float2 iTangent     API_SEMANTIC(VSIN_TANGENT);
+};
+
+// shader function entry and exit decalration /////////////////////////////////////////////
+
+#define VS_wrapper_DETAILED_SKIN_PACKED(func) \
+    DETAILED_MESH_PS_IN main(DETAILED_SKIN_PACKED_VS_IN API_NOSTRIP vIn) { \
+    DETAILED_MESH_PS_IN pIn; \
+    pIn = func(vIn); \
+    return pIn; \
+}
+
+#define VS_wrapper_DETAILED_SKIN_PACKED_SHADOWED(func) \
+    DETAILED_MESH_SHADOWED_PS_IN main(DETAILED_SKIN_PACKED_VS_IN API_NOSTRIP vIn) { \
+    DETAILED_MESH_SHADOWED_PS_IN pIn; \
+    pIn = func(vIn); \
+    return pIn; \
+}
+
+// skinning of position, normal and tangent with first 5 weights (same as DetailedSkin_Shadowed_VS)
+#define SKIN_PACKED_WEIGHT(w, i) \
+	if (w > 0.0) { \
+		matrix J = gJoints[decodeJointIndex(i)]; \
+		result += w * mul(position, J); \
+		normResult += w * mul(normal, J); \
+		tangResult += w * mul(tangent, J); \
+	}
+
+#endif
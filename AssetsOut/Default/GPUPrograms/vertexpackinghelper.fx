@@ -0,0 +1,23 @@
+#ifndef HLSL_VERTEXPACKINGHELPER
+#define HLSL_VERTEXPACKINGHELPER
+
+// decoding of packed vertex formats (DetailedMeshPacked, DetailedSkinPacked)
+// see PrimeEngine/APIAbstraction/GPUBuffers/VertexPacking.h for encoding
+
+// unit vector from octahedral encoding (snorm16 x 2 already converted to [-1, 1] by vertex fetch)
+float3 decodeOctahedral(float2 e)
+{
+	float3 n = make_float3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+	// lower hemisphere was folded over the diagonals
+	float t = saturate(-n.z);
+	n.xy -= (step(0.0, n.xy) * 2.0 - 1.0) * t;
+	return normalize(n);
+}
+
+// joint indices are stored as unorm8
+int decodeJointIndex(float i)
+{
+	return int(i * 255.0 + 0.5);
+}
+
+#endif
@@ -0,0 +1,85 @@
+-- Benchmark scenarios run by the Benchmark executable (see PrimeEngine/Profiling/Benchmark.h for types and parameters).
+-- Keep names stable: reports of different commits are compared by scenario name.
+-- Run a subset with --filter <part of name>
+
+Scenarios = {
+	{ name = 'navmesh_soldiers_64',   type = 'navmesh',  count = 64,  frames = 600, navmesh = 'ccontrollvl0.navmesh', package = 'CharacterControl' },
+	{ name = 'navmesh_soldiers_256',  type = 'navmesh',  count = 256, frames = 300, navmesh = 'ccontrollvl0.navmesh', package = 'CharacterControl' },
+
+	{ name = 'physics_bodies_256',    type = 'physics',  count = 256,  statics = 64,  frames = 600 },
+	{ name = 'physics_bodies_1024',   type = 'physics',  count = 1024, statics = 256, frames = 300 },
+
+	{ name = 'skinning_soldiers_16',  type = 'skinning', count = 16, frames = 300, mesh = 'SoldierTransform.mesha',
+		skeleton = 'soldier_Soldier_Skeleton.skela', animSet = 'soldier_Soldier_Skeleton.animseta', package = 'Soldier' },
+	{ name = 'skinning_soldiers_64',  type = 'skinning', count = 64, frames = 120, mesh = 'SoldierTransform.mesha',
+		skeleton = 'soldier_Soldier_Skeleton.skela', animSet = 'soldier_Soldier_Skeleton.animseta', package = 'Soldier' },
+	{ name = 'skinning_soldiers_64_1thread', type = 'skinning', count = 64, frames = 120, threads = 0, mesh = 'SoldierTransform.mesha',
+		skeleton = 'soldier_Soldier_Skeleton.skela', animSet = 'soldier_Soldier_Skeleton.animseta', package = 'Soldier' },
+
+	{ name = 'particles_16x4096',     type = 'particles', count = 16, particles = 4096, frames = 300 },
+	{ name = 'particles_16x4096_1thread', type = 'particles', count = 16, particles = 4096, frames = 300, threads = 0 },
+
+	{ name = 'renderstate_2000',      type = 'renderstate', count = 2000, techniques = 16, frames = 300 },
+	{ name = 'renderstate_2000_sorted', type = 'renderstate', count = 2000, techniques = 16, frames = 300, sorted = 1 },
+
+	{ name = 'constants_2000',        type = 'constants', count = 2000, size = 336, frames = 300, ringKB = 4096, gpuLatency = 2 },
+	{ name = 'constants_2000_smallring', type = 'constants', count = 2000, size = 336, frames = 300, ringKB = 1536, gpuLatency = 2 },
+
+	{ name = 'lights_1',              type = 'lights',   count = 1, frames = 300 },
+	{ name = 'lights_100',            type = 'lights',   count = 100, frames = 300 },
+	{ name = 'lights_1000',           type = 'lights',   count = 1000, frames = 300, verifyEvery = 100 },
+
+	{ name = 'log_async',             type = 'log',      count = 1000000, queued = 100000, parallel = 100000 },
+
+	{ name = 'text_10k_glyphs',       type = 'text',     strings = 250, chars = 40, frames = 300, world = 0.1 },
+
+	{ name = 'hotreload_edits',       type = 'hotreload', edits = 5, timeout = 2000 },
+
+	{ name = 'lua_cache_profile',     type = 'lua',      level = 'ccontrollvl0.x_level.levela', package = 'CharacterControl', passes = 10, frames = 300 },
+
+	{ name = 'crowd_100',             type = 'crowd',    count = 100, ticks = 300 },
+	{ name = 'crowd_1000',            type = 'crowd',    count = 1000, ticks = 300 },
+	{ name = 'crowd_5000',            type = 'crowd',    count = 5000, ticks = 300 },
+
+	{ name = 'level_city',            type = 'level',    level = 'ccontrollvl0.x_level.levela', package = 'CharacterControl' },
+
+	{ name = 'net_ghosts_32',         type = 'ghosts',   clients = 32, objects = 64, frames = 600 },
+	{ name = 'net_udp_loss10',        type = 'udp',      frames = 600, loss = 10, latency = 50, jitter = 10 },
+	{ name = 'net_sockets_256',       type = 'sockets',  clients = 256, frames = 600, active = 10, packetsPerReply = 3 },
+	{ name = 'net_server_churn',      type = 'server',   clients = 64, rounds = 10 },
+}
+
+-- used by 'level' scenarios: runs level script with LevelLoader.CreateGameObject() replaced by a collector
+-- that runs each object's meta script and collects referenced meshes instead of creating objects.
+-- returns number of objects and array of {mesh, package}
+function collectLevelAssets(level, package)
+	local delim = l_getPathDelimeter()
+	local assetsRoot = l_getGameProjRoot(l_getGameContext())..'AssetsOut'..delim
+	local numObjects = 0
+	local meshes = {}
+
+	local createGameObject = LevelLoader.CreateGameObject
+	LevelLoader.CreateGameObject = function(name, m00, m10, m20, m30, m01, m11, m21, m31, m02, m12, m22, m32, m03, m13, m23, m33, metaScriptFilename, metaScriptPackage)
+		numObjects = numObjects + 1
+		if metaScriptPackage == 'Raw' then
+			return
+		end
+		dofile(assetsRoot..metaScriptPackage..delim..'Levels'..delim..metaScriptFilename) -- defines fillMetaInfoTable
+		local args = {}
+		fillMetaInfoTable(args)
+		for k, v in pairs(args) do
+			if type(v) == 'string' and string.find(v, '%.mesha$') then
+				local packageKey = string.gsub(k, 'Name$', 'Package')
+				table.insert(meshes, { v, args[packageKey] or metaScriptPackage })
+			end
+		end
+	end
+
+	local ok, err = pcall(dofile, assetsRoot..package..delim..'Levels'..delim..level)
+	LevelLoader.CreateGameObject = createGameObject
+	if not ok then
+		error(err)
+	end
+
+	return numObjects, meshes
+end
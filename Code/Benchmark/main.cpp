@@ -0,0 +1,62 @@
+// Headless engine benchmark. Run from workspace root (like the dedicated server):
+//   Benchmark --scenarios Code/Benchmark/Scenarios.lua --out benchmark.json --tag <commit> --filter <name substring>
+// Boots engine without window, renderer or network listening, runs the scripted scenarios
+// and writes per subsystem timings and memory stats as json so runs of different commits can be compared.
+
+#include "PrimeEngine/PrimeEngineIncludes.h"
+#include "PrimeEngine/Game/Server/ServerGame.h"
+#include "PrimeEngine/Profiling/Benchmark.h"
+
+int main(int argc, char *argv[])
+{
+	const char *outFilename = "benchmark.json";
+	const char *scenarios = "Code/Benchmark/Scenarios.lua";
+	const char *filter = NULL;
+	const char *tag = "";
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--out") == 0)
+			outFilename = argv[i + 1];
+		else if (strcmp(argv[i], "--scenarios") == 0)
+			scenarios = argv[i + 1];
+		else if (strcmp(argv[i], "--filter") == 0)
+			filter = argv[i + 1];
+		else if (strcmp(argv[i], "--tag") == 0)
+			tag = argv[i + 1];
+		else
+		{
+			printf("usage: %s [--scenarios file.lua] [--out file.json] [--filter name] [--tag build]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	PE::GameContext &context = PE::Components::ServerGame::s_context;
+	memset(&context, 0, sizeof(context));
+	context.m_defaultArena = PE::MemoryArena_Server;
+	context.m_luaCommandServerPort = 0; // any free port so that a running server is not disturbed. commands are not serviced
+	context.m_isServer = true;
+
+	if (!PE::Benchmark::initEngine(context, PE::MemoryArena_Server, ""))
+		return 1;
+
+	std::vector<PE::BenchmarkResult *> results;
+	bool ran = PE::Benchmark::runScenarioScript(context, PE::MemoryArena_Server, scenarios, filter, results);
+	PE::AsyncLog::Stop();
+	if (!ran)
+		return 1;
+
+	if (!PE::Benchmark::writeReport(outFilename, tag, results))
+		return 1;
+
+	int numFailed = 0;
+	for (unsigned int i = 0; i < results.size(); ++i)
+	{
+		if (!results[i]->m_ok)
+			++numFailed;
+		delete results[i];
+	}
+
+	// failed scenarios still have their results written, but make it visible to scripts
+	return numFailed ? 2 : 0;
+}
@@ -0,0 +1,31 @@
+-- Headless engine benchmark: boots PrimeEngine without window or renderer, runs Scenarios.lua and writes a json report.
+-- Run from workspace root so that Code/ and AssetsOut/ resolve
+project("Benchmark-".._OPTIONS["platformapi"])
+
+	configurations {"Debug", "Release"}
+
+	kind "ConsoleApp"
+
+	language "C++"
+
+	files { "**.h", "**.cpp", "**.lua" }
+
+	links { "lua_dist-".._OPTIONS["platformapi"], "luasocket_dist-".._OPTIONS["platformapi"], "PrimeEngine-".._OPTIONS["platformapi"] }
+
+	if (_OPTIONS["platformapi"] == "win32d3d11" or _OPTIONS["platformapi"] == "win32d3d9" or _OPTIONS["platformapi"] == "win32gl") then
+		links { "ws2_32", "winmm" }
+		linkoptions { ' /NODEFAULTLIB:LIBC /SAFESEH:NO' }
+	end
+
+	-- engine library references the api even though benchmark never creates a device
+	if (_OPTIONS["platformapi"] == "win32d3d11") then
+		links { "DXGI", "d3d11", "Xinput9_1_0", "d3dcompiler" }
+	elseif (_OPTIONS["platformapi"] == "win32d3d9") then
+		links { "d3d9", "Xinput9_1_0", "d3dcompiler" }
+	elseif(_OPTIONS["platformapi"] == "win32gl") then
+		links { "glew32", "opengl32", "glu32", "cg", "cgGL" }
+	end
+
+	if _OPTIONS["platformapi"] == "linux-headless" then
+		links { "pthread", "rt", "dl" }
+	end
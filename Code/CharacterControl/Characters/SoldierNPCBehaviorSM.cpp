@@ -132,9 +132,7 @@ void SoldierNPCBehaviorSM::do_SoldierNPCMovementSM_Event_TARGET_REACHED(PE::Even
 				char selectedWaypoint[32];
 				pickRandomFromList(pWP->m_nextWayPointName, selectedWaypoint);
 
-				char debugMsg[64];
-				sprintf(debugMsg, "Next waypoint: %s\n", selectedWaypoint);
-				OutputDebugStringA(debugMsg);
+				PEINFO("Next waypoint: %s", selectedWaypoint);
 				
 				// have next waypoint to go to
 				pWP = pGameObjectManagerAddon->getWayPoint(selectedWaypoint);
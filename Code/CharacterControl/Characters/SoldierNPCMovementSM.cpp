@@ -35,6 +35,9 @@ PE_IMPLEMENT_CLASS1(SoldierNPCMovementSM, Component);
 SoldierNPCMovementSM::SoldierNPCMovementSM(PE::GameContext &context, PE::MemoryArena arena, PE::Handle hMyself) 
 : Component(context, arena, hMyself)
 , m_state(STANDING)
+, m_stepped(false)
+, m_stepReachedTarget(false)
+, m_blockedTime(0)
 {}
 
 SceneNode *SoldierNPCMovementSM::getParentsSceneNode()
@@ -66,8 +69,11 @@ void SoldierNPCMovementSM::do_SoldierNPCMovementSM_Event_MOVE_TO(PE::Events::Eve
 	// change state of this state machine
 	m_targetPostion = pRealEvt->m_targetPosition;
 
-	OutputDebugStringA("PE: PROGRESS: SoldierNPCMovementSM::do_SoldierNPCMovementSM_Event_MOVE_TO(): ");
-	OutputDebugStringA(pRealEvt->m_running ? "running\n" : "walking\n");
+	if (m_state == STANDING)
+		m_crowdVelocity = Vector3();
+	m_blockedTime = 0;
+
+	PEINFO("PROGRESS: SoldierNPCMovementSM::do_SoldierNPCMovementSM_Event_MOVE_TO(): %s", pRealEvt->m_running ? "running" : "walking");
 
 	if (pRealEvt->m_running) {
 		m_state = RUNNING_TO_TARGET;
@@ -121,71 +127,139 @@ void SoldierNPCMovementSM::do_SoldierNPCMovementSM_Event_STOP(PE::Events::Event
 	}
 }
 
+void SoldierNPCMovementSM::stepTowardsTarget(float frameTime)
+{
+	m_stepped = true;
+	m_stepTarget = m_targetPostion;
+	m_stepReachedTarget = false;
+
+	// see if parent has scene node component
+	SceneNode* pSN = getParentsSceneNode();
+	if (!pSN)
+		return;
+
+	Vector3 curPos = pSN->m_base.getPos();
+	float dsqr = (m_targetPostion - curPos).lengthSqr();
+
+	bool reached = true;
+	// Increased threshold from 0.01 (0.1 units) to 0.25 (0.5 units) for smoother stop
+	// This prevents "walking in place" when physics micro-adjusts position
+	if (dsqr > 0.25f)  // Stop within 0.5 units of waypoint
+	{
+		// not at the spot yet
+		float speed = (m_state == WALKING_TO_TARGET) ? 8.0f : 16.0f;
+		float allowedDisp = speed * frameTime;
+
+		Vector3 dir = (m_targetPostion - curPos);
+		dir.normalize();
+		float dist = sqrt(dsqr);
+		if (dist > allowedDisp)
+		{
+			dist = allowedDisp; // can move up to allowedDisp
+			reached = false; // not reaching destination yet
+		}
+
+		// instantaneous turn
+		pSN->m_base.turnInDirection(dir, 3.1415f);
+		pSN->m_base.setPos(curPos + dir * dist);
+	}
+	m_stepReachedTarget = reached;
+}
+
+Vector3 SoldierNPCMovementSM::getPreferredVelocity(float frameTime)
+{
+	SceneNode* pSN = getParentsSceneNode();
+	if (!pSN)
+		return Vector3();
+
+	Vector3 toTarget = m_targetPostion - pSN->m_base.getPos();
+	float dsqr = toTarget.lengthSqr();
+	if (dsqr <= 0.25f)
+		return Vector3();
+
+	// arrive at the spot at the end of the frame instead of passing it
+	float dist = sqrt(dsqr);
+	float speed = getMaxSpeed();
+	if (dist < speed * frameTime)
+		speed = dist / frameTime;
+	return toTarget * (speed / dist);
+}
+
+void SoldierNPCMovementSM::applyCrowdVelocity(const Vector3 &velocity, const Vector3 &preferredVelocity, float frameTime)
+{
+	m_stepped = true;
+	m_stepTarget = m_targetPostion;
+	m_stepReachedTarget = false;
+	m_crowdVelocity = velocity;
+
+	SceneNode* pSN = getParentsSceneNode();
+	if (!pSN)
+		return;
+
+	Vector3 pos = pSN->m_base.getPos() + frameTime * velocity;
+	pSN->m_base.setPos(pos);
+
+	Vector3 dir(velocity.m_x, 0, velocity.m_z);
+	if (dir.lengthSqr() > 0.0001f)
+	{
+		dir.normalize();
+		pSN->m_base.turnInDirection(dir, 3.1415f);
+	}
+
+	// held back: less than half of preferred speed
+	Vector3 v = velocity, preferred = preferredVelocity;
+	if (v.lengthSqr() < 0.25f * preferred.lengthSqr())
+		m_blockedTime += frameTime;
+	else
+		m_blockedTime = 0;
+
+	float dsqr = (m_targetPostion - pos).lengthSqr();
+	m_stepReachedTarget = dsqr <= 0.25f
+		|| (m_blockedTime >= PE_CROWD_BLOCKED_TIME && dsqr <= PE_CROWD_ARRIVAL_SLACK * PE_CROWD_ARRIVAL_SLACK);
+}
+
 void SoldierNPCMovementSM::do_UPDATE(PE::Events::Event *pEvt)
 {
 	if (m_state == WALKING_TO_TARGET || m_state == RUNNING_TO_TARGET)
 	{
-		// see if parent has scene node component
-		SceneNode* pSN = getParentsSceneNode();
-		if (pSN)
+		// usually already stepped by game object manager addon for all soldiers at once.
+		// step here if it didn't, or if target changed since then
+		if (!m_stepped || (m_stepTarget - m_targetPostion).lengthSqr() > 0.0f)
 		{
-		Vector3 curPos = pSN->m_base.getPos();
-		float dsqr = (m_targetPostion - curPos).lengthSqr();
+			Event_UPDATE* pRealEvt = (Event_UPDATE*)(pEvt);
+			stepTowardsTarget(pRealEvt->m_frameTime);
+		}
+		m_stepped = false;
 
-		bool reached = true;
-		// Increased threshold from 0.01 (0.1 units) to 0.25 (0.5 units) for smoother stop
-		// This prevents "walking in place" when physics micro-adjusts position
-		if (dsqr > 0.25f)  // Stop within 0.5 units of waypoint
+		if (m_stepReachedTarget)
 		{
-			// not at the spot yet
-			Event_UPDATE* pRealEvt = (Event_UPDATE*)(pEvt);
-			float speed = (m_state == WALKING_TO_TARGET) ? 8.0f : 16.0f;
-			float allowedDisp = speed * pRealEvt->m_frameTime;
+			m_state = STANDING;
+
+			// target has been reached. need to notify all same level state machines (components of parent)
+			{
+				PE::Handle h("SoldierNPCMovementSM_Event_TARGET_REACHED", sizeof(SoldierNPCMovementSM_Event_TARGET_REACHED));
+				Events::SoldierNPCMovementSM_Event_TARGET_REACHED* pOutEvt = new(h) SoldierNPCMovementSM_Event_TARGET_REACHED();
 
-				Vector3 dir = (m_targetPostion - curPos);
-				dir.normalize();
-				float dist = sqrt(dsqr);
-				if (dist > allowedDisp)
+				PE::Handle hParent = getFirstParentByType<Component>();
+				if (hParent.isValid())
 				{
-					dist = allowedDisp; // can move up to allowedDisp
-					reached = false; // not reaching destination yet
+					hParent.getObject<Component>()->handleEvent(pOutEvt);
 				}
 
-				// instantaneous turn
-				pSN->m_base.turnInDirection(dir, 3.1415f);
-				pSN->m_base.setPos(curPos + dir * dist);
+				// release memory now that event is processed
+				h.release();
 			}
 
-			if (reached)
+			if (m_state == STANDING)
 			{
-				m_state = STANDING;
-
-				// target has been reached. need to notify all same level state machines (components of parent)
+				// no one has modified our state based on TARGET_REACHED callback
+				// this means we are not going anywhere right now
+				// so can send event to animation state machine to stop
 				{
-					PE::Handle h("SoldierNPCMovementSM_Event_TARGET_REACHED", sizeof(SoldierNPCMovementSM_Event_TARGET_REACHED));
-					Events::SoldierNPCMovementSM_Event_TARGET_REACHED* pOutEvt = new(h) SoldierNPCMovementSM_Event_TARGET_REACHED();
+					Events::SoldierNPCAnimSM_Event_STOP evt;
 
-					PE::Handle hParent = getFirstParentByType<Component>();
-					if (hParent.isValid())
-					{
-						hParent.getObject<Component>()->handleEvent(pOutEvt);
-					}
-
-					// release memory now that event is processed
-					h.release();
-				}
-
-				if (m_state == STANDING)
-				{
-					// no one has modified our state based on TARGET_REACHED callback
-					// this means we are not going anywhere right now
-					// so can send event to animation state machine to stop
-					{
-						Events::SoldierNPCAnimSM_Event_STOP evt;
-
-						SoldierNPC* pSol = getFirstParentByTypePtr<SoldierNPC>();
-						pSol->getFirstComponent<PE::Components::SceneNode>()->handleEvent(&evt);
-					}
+					SoldierNPC* pSol = getFirstParentByTypePtr<SoldierNPC>();
+					pSol->getFirstComponent<PE::Components::SceneNode>()->handleEvent(&evt);
 				}
 			}
 		}
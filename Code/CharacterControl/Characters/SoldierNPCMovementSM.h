@@ -64,6 +64,18 @@ struct SoldierNPCMovementSM : public PE::Components::Component
 	//////////////////////////////////////////////////////////////////////////
 	PE::Components::SceneNode *getParentsSceneNode();
 
+	// moves and turns scene node towards m_targetPostion, result is kept for do_UPDATE() of this frame.
+	// doesn't send events so ClientGameObjectManagerAddon runs it for all walking soldiers on job system workers
+	void stepTowardsTarget(float frameTime);
+
+	// crowd movement (PE_CROWD): ClientGameObjectManagerAddon steers all soldiers with PE::CrowdSimulation instead of
+	// stepTowardsTarget(). velocity it wants to go towards m_targetPostion with, and its speed
+	Vector3 getPreferredVelocity(float frameTime);
+	float getMaxSpeed() { return (m_state == WALKING_TO_TARGET) ? 8.0f : 16.0f; }
+	// moves and turns scene node by velocity avoidance picked, result is kept for do_UPDATE() like stepTowardsTarget().
+	// target also counts as reached when crowd held soldier back for a while close to it (others stand on the spot)
+	void applyCrowdVelocity(const Vector3 &velocity, const Vector3 &preferredVelocity, float frameTime);
+
 	//////////////////////////////////////////////////////////////////////////
 	// Component API and Event Handlers
 	//////////////////////////////////////////////////////////////////////////
@@ -88,6 +100,15 @@ struct SoldierNPCMovementSM : public PE::Components::Component
 	Vector3 m_targetPostion;
 	SoldierNPC *m_shootTargetPtr;
 	States m_state;
+	//
+	// result of stepTowardsTarget() for this frame
+	bool m_stepped;
+	bool m_stepReachedTarget;
+	Vector3 m_stepTarget;
+	//
+	// crowd movement
+	Vector3 m_crowdVelocity; // of last frame
+	float m_blockedTime; // seconds going much slower than preferred
 };
 
 };
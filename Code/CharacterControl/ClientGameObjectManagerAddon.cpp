@@ -31,6 +31,8 @@ void ClientGameObjectManagerAddon::addDefaultComponents()
 
 	PE_REGISTER_EVENT_HANDLER(Event_MoveTank_S_to_C, ClientGameObjectManagerAddon::do_MoveTank);
 
+	PE_REGISTER_EVENT_HANDLER(Event_UPDATE, ClientGameObjectManagerAddon::do_UPDATE);
+
 	// ========================================================================
 	// Load navmesh for current level
 	// ========================================================================
@@ -241,6 +243,10 @@ void ClientGameObjectManagerAddon::createTank(int index, int &threadOwnershipMas
 	TankController *pTankController = new(hTankController) TankController(*m_pContext, m_arena, hTankController, 0.05f, spawnPos,  0.05f);
 	pTankController->addDefaultComponents();
 
+	// receives ghosted transform from server
+	pTankController->m_networkId = TankController::GetNetworkId(index);
+	pTankController->registerWithNetwork(m_pContext->getNetworkManager());
+
 	addComponent(hTankController);
 
 	// add the same scene node to tank controller
@@ -298,6 +304,85 @@ void ClientGameObjectManagerAddon::createSpaceShip(int &threadOwnershipMask)
 }
 
 
+// parallelFor body, steps soldiers [begin, end) of m_movingSoldiers
+static void stepMovingSoldiers(void *pParams, int begin, int end)
+{
+	ClientGameObjectManagerAddon *pAddon = static_cast<ClientGameObjectManagerAddon *>(pParams);
+	for (int i = begin; i < end; ++i)
+		pAddon->m_movingSoldiers[i]->stepTowardsTarget(pAddon->m_movingSoldiersFrameTime);
+}
+
+#if PE_CROWD
+static void applyCrowdToMovingSoldiers(void *pParams, int begin, int end)
+{
+	ClientGameObjectManagerAddon *pAddon = static_cast<ClientGameObjectManagerAddon *>(pParams);
+	for (int i = begin; i < end; ++i)
+	{
+		PE::CrowdAgent &agent = pAddon->m_crowd.getAgent(i);
+		pAddon->m_movingSoldiers[i]->applyCrowdVelocity(agent.m_newVelocity, agent.m_preferredVelocity, pAddon->m_movingSoldiersFrameTime);
+	}
+}
+#endif
+
+void ClientGameObjectManagerAddon::do_UPDATE(PE::Events::Event *pEvt)
+{
+	Event_UPDATE *pRealEvt = (Event_UPDATE *)(pEvt);
+
+	m_movingSoldiers.clear();
+	m_standingSoldiers.clear();
+	m_movingSoldiersFrameTime = pRealEvt->m_frameTime;
+
+	PE::Handle *pHC = m_components.getFirstPtr();
+	for (PrimitiveTypes::UInt32 i = 0; i < m_components.m_size; i++, pHC++) // fast array traversal (increasing ptr)
+	{
+		Component *pC = (*pHC).getObject<Component>();
+
+		if (pC->isInstanceOf<SoldierNPC>() && pC->isEnabled())
+		{
+			SoldierNPCMovementSM *pMovementSM = pC->getFirstComponent<SoldierNPCMovementSM>();
+			if (pMovementSM && (pMovementSM->m_state == SoldierNPCMovementSM::WALKING_TO_TARGET || pMovementSM->m_state == SoldierNPCMovementSM::RUNNING_TO_TARGET))
+				m_movingSoldiers.add(pMovementSM);
+			else if (SceneNode *pSN = pC->getFirstComponent<SceneNode>())
+				m_standingSoldiers.add(pSN);
+		}
+	}
+
+#if PE_CROWD
+	if (m_movingSoldiers.m_size)
+	{
+		m_crowd.clear();
+		for (PrimitiveTypes::UInt32 i = 0; i < m_movingSoldiers.m_size; ++i)
+		{
+			SoldierNPCMovementSM *pMovementSM = m_movingSoldiers[i];
+			SceneNode *pSN = pMovementSM->getParentsSceneNode();
+
+			PE::CrowdAgent agent;
+			agent.m_pos = pSN ? pSN->m_base.getPos() : Vector3();
+			agent.m_velocity = pMovementSM->m_crowdVelocity;
+			agent.m_preferredVelocity = pMovementSM->getPreferredVelocity(m_movingSoldiersFrameTime);
+			agent.m_maxSpeed = pMovementSM->getMaxSpeed();
+			m_crowd.addAgent(agent);
+		}
+		for (PrimitiveTypes::UInt32 i = 0; i < m_standingSoldiers.m_size; ++i)
+		{
+			PE::CrowdAgent agent;
+			agent.m_pos = m_standingSoldiers[i]->m_base.getPos();
+			agent.m_static = true;
+			m_crowd.addAgent(agent);
+		}
+
+		// waypoints of navmesh paths are goals of agents, avoidance only bends the way between them.
+		// then each soldier only touches its own scene node, like without crowd
+		m_crowd.step(m_movingSoldiersFrameTime);
+		PE::JobSystem::parallelFor(m_movingSoldiers.m_size, 8, &applyCrowdToMovingSoldiers, this);
+		return;
+	}
+#endif
+
+	// only touches each soldier's own scene node. events (target reached) are sent by the soldiers' do_UPDATE after this
+	PE::JobSystem::parallelFor(m_movingSoldiers.m_size, 8, &stepMovingSoldiers, this);
+}
+
 void ClientGameObjectManagerAddon::do_SERVER_CLIENT_CONNECTION_ACK(PE::Events::Event *pEvt)
 {
 	Event_SERVER_CLIENT_CONNECTION_ACK *pRealEvt = (Event_SERVER_CLIENT_CONNECTION_ACK *)(pEvt);
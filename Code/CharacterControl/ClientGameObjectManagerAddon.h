@@ -4,9 +4,11 @@
 #include "GameObjectMangerAddon.h"
 #include "Events/Events.h"
 #include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/Scene/CrowdSimulation.h"
 
 #include "WayPoint.h"
 #include "Characters/SoldierNPC.h"
+#include "Characters/SoldierNPCMovementSM.h"
 
 namespace CharacterControl
 {
@@ -21,6 +23,10 @@ struct ClientGameObjectManagerAddon : public GameObjectManagerAddon
 	PE_DECLARE_CLASS(ClientGameObjectManagerAddon); // creates a static handle and GteInstance*() methods. still need to create construct
 
 	ClientGameObjectManagerAddon(PE::GameContext &context, PE::MemoryArena arena, PE::Handle hMyself) : GameObjectManagerAddon(context, arena, hMyself)
+		, m_movingSoldiers(context, arena, 64)
+		, m_movingSoldiersFrameTime(0)
+		, m_standingSoldiers(context, arena, 64)
+		, m_crowd(context, arena)
 	{}
 
 	// sub-component and event registration
@@ -40,6 +46,11 @@ struct ClientGameObjectManagerAddon : public GameObjectManagerAddon
 	PE_DECLARE_IMPLEMENT_EVENT_HANDLER_WRAPPER(do_MoveTank);
 	virtual void do_MoveTank(PE::Events::Event *pEvt);
 
+	// registered before soldiers are added, so runs before their state machines.
+	// steps all walking soldiers towards their targets on job system workers, around each other with PE_CROWD
+	PE_DECLARE_IMPLEMENT_EVENT_HANDLER_WRAPPER(do_UPDATE);
+	virtual void do_UPDATE(PE::Events::Event *pEvt);
+
 
 	// no need to implement this as eent since tank creation will be hardcoded
 	void createTank(int index, int &threadOwnershipMask);
@@ -61,6 +72,15 @@ struct ClientGameObjectManagerAddon : public GameObjectManagerAddon
 
 	// Navmesh for pathfinding
 	PE::Handle m_hNavmesh;
+
+	// walking soldiers of current frame, filled by do_UPDATE()
+	Array<SoldierNPCMovementSM *, 1> m_movingSoldiers;
+	PrimitiveTypes::Float32 m_movingSoldiersFrameTime;
+
+	// PE_CROWD: standing soldiers of current frame, walking ones go around them.
+	// agents of m_crowd are m_movingSoldiers, then m_standingSoldiers
+	Array<PE::Components::SceneNode *, 1> m_standingSoldiers;
+	PE::CrowdSimulation m_crowd;
 };
 
 
@@ -109,13 +109,13 @@ void *Event_MoveTank_C_to_S::FactoryConstruct(PE::GameContext& context, PE::Memo
 
 int Event_MoveTank_C_to_S::packCreationData(char *pDataStream)
 {
-	return PE::Components::StreamManager::WriteMatrix4x4(m_transform, pDataStream);
+	return PE::Components::StreamManager::WriteTransform(m_transform, pDataStream);
 }
 
 int Event_MoveTank_C_to_S::constructFromStream(char *pDataStream)
 {
 	int read = 0;
-	read += PE::Components::StreamManager::ReadMatrix4x4(&pDataStream[read], m_transform);
+	read += PE::Components::StreamManager::ReadTransform(&pDataStream[read], m_transform);
 	return read;
 }
 
@@ -138,7 +138,7 @@ int Event_MoveTank_S_to_C::packCreationData(char *pDataStream)
 {
 	int size = 0;
 	size += Event_MoveTank_C_to_S::packCreationData(&pDataStream[size]);
-	size += PE::Components::StreamManager::WriteInt32(m_clientTankId, &pDataStream[size]);
+	size += PE::Components::StreamManager::WriteVarInt32(m_clientTankId, &pDataStream[size]);
 	return size;
 }
 
@@ -146,7 +146,7 @@ int Event_MoveTank_S_to_C::constructFromStream(char *pDataStream)
 {
 	int read = 0;
 	read += Event_MoveTank_C_to_S::constructFromStream(&pDataStream[read]);
-	read += PE::Components::StreamManager::ReadInt32(&pDataStream[read], m_clientTankId);
+	read += PE::Components::StreamManager::ReadVarInt32(&pDataStream[read], m_clientTankId);
 	return read;
 }
 
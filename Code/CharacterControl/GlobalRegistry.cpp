@@ -14,6 +14,7 @@
 #include "ClientCharacterControlGame.h"
 #include "ServerCharacterControlGame.h"
 #include "Tank/ClientTank.h"
+#include "Tank/ServerTank.h"
 #include "CharacterControl/Client/ClientSpaceShip.h"
 #include "CharacterControl/Client/ClientSpaceShipControls.h"
 
@@ -46,6 +47,7 @@ void CharacterControl::Register(PE::Components::LuaEnvironment *pLuaEnv, PE::Glo
 				SoldierNPCBehaviorSM::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
 				TankController::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
 				TankGameControls::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
+				ServerTankGhost::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
 				GameObjectManagerAddon::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
 					ClientGameObjectManagerAddon::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
 					ServerGameObjectManagerAddon::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
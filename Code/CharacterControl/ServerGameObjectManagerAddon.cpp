@@ -23,6 +23,7 @@ void ServerGameObjectManagerAddon::addDefaultComponents()
 	GameObjectManagerAddon::addDefaultComponents();
 
 	PE_REGISTER_EVENT_HANDLER(Event_MoveTank_C_to_S, ServerGameObjectManagerAddon::do_MoveTank);
+	PE_REGISTER_EVENT_HANDLER(Event_SERVER_CLIENT_DISCONNECTED, ServerGameObjectManagerAddon::do_SERVER_CLIENT_DISCONNECTED);
 }
 
 void ServerGameObjectManagerAddon::do_MoveTank(PE::Events::Event *pEvt)
@@ -31,15 +32,46 @@ void ServerGameObjectManagerAddon::do_MoveTank(PE::Events::Event *pEvt)
 
 	Event_MoveTank_C_to_S *pTrueEvent = (Event_MoveTank_C_to_S*)(pEvt);
 
-	// need to send this event to all clients except the client it came from
+	// tank transform is ghosted to all clients except the client it came from
+	// ghost manager only sends what changed, when there is room for it, instead of a guaranteed event per move
 
-	Event_MoveTank_S_to_C fwdEvent(*m_pContext);
-	fwdEvent.m_transform = pTrueEvent->m_transform;
-	fwdEvent.m_clientTankId = pTrueEvent->m_networkClientId; // need to tell cleints which tank to move
+	int clientId = pTrueEvent->m_networkClientId;
+	PEASSERT(clientId >= 0 && clientId < PE_SERVER_MAX_CONNECTIONS, "Bad client id %d", clientId);
 
-	ServerNetworkManager *pNM = (ServerNetworkManager *)(m_pContext->getNetworkManager());
-	pNM->scheduleEventToAllExcept(&fwdEvent, m_pContext->getGameObjectManager(), pTrueEvent->m_networkClientId);
+	if (!m_tankGhosts[clientId])
+	{
+		PE::Handle hGhost("ServerTankGhost", sizeof(ServerTankGhost));
+		ServerTankGhost *pGhost = new(hGhost) ServerTankGhost(*m_pContext, m_arena, hGhost, clientId);
+		pGhost->addDefaultComponents();
+		pGhost->m_ppAllTanks = &m_tankGhosts[0];
+		pGhost->m_numAllTanks = PE_SERVER_MAX_CONNECTIONS;
+		pGhost->m_transform = pTrueEvent->m_transform;
 
+		m_tankGhosts[clientId] = pGhost;
+
+		ServerNetworkManager *pNM = (ServerNetworkManager *)(m_pContext->getNetworkManager());
+		pNM->ghostToAllExcept(pGhost, clientId);
+	}
+
+	m_tankGhosts[clientId]->m_transform = pTrueEvent->m_transform;
+
+}
+
+void ServerGameObjectManagerAddon::do_SERVER_CLIENT_DISCONNECTED(PE::Events::Event *pEvt)
+{
+	Event_SERVER_CLIENT_DISCONNECTED *pTrueEvent = (Event_SERVER_CLIENT_DISCONNECTED*)(pEvt);
+
+	int clientId = pTrueEvent->m_clientId;
+	ServerTankGhost *pGhost = m_tankGhosts[clientId];
+	if (!pGhost)
+		return;
+
+	// network manager stopped ghosting it. next client in this slot gets new tank
+	m_tankGhosts[clientId] = NULL;
+
+	PE::Handle hGhost = pGhost->getHandle();
+	pGhost->~ServerTankGhost();
+	hGhost.release();
 }
 
 
@@ -5,6 +5,9 @@
 #include "Events/Events.h"
 
 #include "WayPoint.h"
+#include "Tank/ServerTank.h"
+
+#include "../../GlobalConfig/GlobalConfig.h"
 
 namespace CharacterControl
 {
@@ -19,7 +22,9 @@ struct ServerGameObjectManagerAddon : public GameObjectManagerAddon
 	PE_DECLARE_SINGLETON_CLASS(ServerGameObjectManagerAddon); // creates a static handle and GteInstance*() methods. still need to create construct
 
 	ServerGameObjectManagerAddon(PE::GameContext &context, PE::MemoryArena arena, PE::Handle hMyself) : GameObjectManagerAddon(context, arena, hMyself)
-	{}
+	{
+		memset(m_tankGhosts, 0, sizeof(m_tankGhosts));
+	}
 
 	// sub-component and event registration
 	virtual void addDefaultComponents() ;
@@ -27,10 +32,14 @@ struct ServerGameObjectManagerAddon : public GameObjectManagerAddon
 	PE_DECLARE_IMPLEMENT_EVENT_HANDLER_WRAPPER(do_MoveTank);
 	virtual void do_MoveTank(PE::Events::Event *pEvt);
 
+	PE_DECLARE_IMPLEMENT_EVENT_HANDLER_WRAPPER(do_SERVER_CLIENT_DISCONNECTED);
+	virtual void do_SERVER_CLIENT_DISCONNECTED(PE::Events::Event *pEvt);
+
 	//////////////////////////////////////////////////////////////////////////
 	// Game Specific functionality
 	//////////////////////////////////////////////////////////////////////////
 	//
+	ServerTankGhost *m_tankGhosts[PE_SERVER_MAX_CONNECTIONS]; // created when client first moves its tank
 };
 
 
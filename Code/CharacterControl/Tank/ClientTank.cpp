@@ -6,6 +6,7 @@
 #include "PrimeEngine/Scene/Mesh.h"
 #include "PrimeEngine/Scene/SceneNode.h"
 #include "PrimeEngine/Networking/EventManager.h"
+#include "PrimeEngine/Networking/StreamManager.h"
 #include "PrimeEngine/Networking/Client/ClientNetworkManager.h"
 #include "CharacterControl/Events/Events.h"
 #include "PrimeEngine/GameObjectModel/GameObjectManager.h"
@@ -319,6 +320,7 @@ TankController::TankController(PE::GameContext &context, PE::MemoryArena arena,
 	PE::Handle myHandle, float speed, Vector3 spawnPos,
 	float networkPingInterval)
 : Component(context, arena, myHandle)
+, Networkable(context, this) // network id is assigned by game object manager addon once tank index is known
 , m_timeSpeed(speed)
 , m_time(0)
 , m_counter(0)
@@ -471,6 +473,14 @@ void TankController::overrideTransform(Matrix4x4 &t)
 	m_transformOverride = t;
 }
 
+int TankController::unpackGhostState(char *pDataStream)
+{
+	Matrix4x4 t;
+	int read = PE::Components::StreamManager::ReadTransform(pDataStream, t);
+	overrideTransform(t);
+	return read;
+}
+
 void TankController::activate()
 {
 	m_active = true;
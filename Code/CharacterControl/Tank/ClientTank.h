@@ -3,6 +3,7 @@
 
 #include "PrimeEngine/Events/Component.h"
 #include "PrimeEngine/Math/Vector3.h"
+#include "PrimeEngine/Utils/Networkable.h"
 
 namespace PE {
     namespace Events{
@@ -41,10 +42,11 @@ namespace Components {
 		PrimitiveTypes::Float32 m_frameTime;
 	};
 
-    struct TankController : public PE::Components::Component
+    struct TankController : public PE::Components::Component, public PE::Networkable
     {
         // component API
         PE_DECLARE_CLASS(TankController);
+        PE_DECLARE_NETWORKABLE_CLASS
         
         TankController(PE::GameContext &context, PE::MemoryArena arena,
 			PE::Handle myHandle, float speed,
@@ -66,6 +68,12 @@ namespace Components {
 		void overrideTransform(Matrix4x4 &t);
 		void activate();
 
+		// Networkable: transforms of other clients' tanks are ghosted from server (ServerTankGhost)
+		virtual int unpackGhostState(char *pDataStream);
+
+		// tanks have preassigned network ids so that server ghosts can find client tanks
+		static PE::Networkable::NetworkId GetNetworkId(int tankIndex) {return 100 + tankIndex;}
+
         float m_timeSpeed;
         float m_time;
 		float m_networkPingTimer;
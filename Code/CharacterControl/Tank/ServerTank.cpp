@@ -0,0 +1,42 @@
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Inter-Engine includes
+#include "PrimeEngine/Lua/LuaEnvironment.h"
+#include "PrimeEngine/Networking/StreamManager.h"
+
+#include "ServerTank.h"
+#include "ClientTank.h"
+
+namespace CharacterControl {
+namespace Components {
+
+PE_IMPLEMENT_CLASS1(ServerTankGhost, PE::Components::Component);
+
+ServerTankGhost::ServerTankGhost(PE::GameContext &context, PE::MemoryArena arena, PE::Handle hMyself, int clientId)
+: Component(context, arena, hMyself)
+, Networkable(context, this) // not registered with network manager on server, only ghosted
+, m_clientId(clientId)
+, m_ppAllTanks(NULL)
+, m_numAllTanks(0)
+{
+	m_networkId = TankController::GetNetworkId(clientId);
+	m_transform.loadIdentity();
+}
+
+int ServerTankGhost::packGhostState(char *pDataStream)
+{
+	return PE::Components::StreamManager::WriteTransform(m_transform, pDataStream);
+}
+
+PrimitiveTypes::Float32 ServerTankGhost::getGhostPriority(int clientId)
+{
+	// tanks close to client's own tank get updated first
+	if (clientId < 0 || clientId >= m_numAllTanks || !m_ppAllTanks[clientId])
+		return 1.0f;
+
+	Vector3 d = m_transform.getPos() - m_ppAllTanks[clientId]->m_transform.getPos();
+	return 1.0f / (1.0f + d.length() * 0.1f);
+}
+
+}; // namespace Components
+}; // namespace CharacterControl
@@ -0,0 +1,35 @@
+#ifndef _SERVER_TANK_H_
+#define _SERVER_TANK_H_
+
+#include "PrimeEngine/Events/Component.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+#include "PrimeEngine/Utils/Networkable.h"
+
+namespace CharacterControl {
+namespace Components {
+
+	// server side copy of a client's tank. client sends its transform in Event_MoveTank_C_to_S
+	// and server ghosts it to all other clients (see TankController::unpackGhostState)
+	struct ServerTankGhost : public PE::Components::Component, public PE::Networkable
+	{
+		PE_DECLARE_CLASS(ServerTankGhost);
+		PE_DECLARE_NETWORKABLE_CLASS
+
+		ServerTankGhost(PE::GameContext &context, PE::MemoryArena arena, PE::Handle hMyself, int clientId);
+
+		// Networkable:
+		virtual int packGhostState(char *pDataStream);
+		virtual PrimitiveTypes::Float32 getGhostPriority(int clientId);
+
+		int m_clientId;
+		Matrix4x4 m_transform;
+
+		// all tank ghosts, indexed by client id. used to find how close this tank is to a client's tank
+		ServerTankGhost **m_ppAllTanks;
+		int m_numAllTanks;
+	};
+
+}; // namespace Components
+}; // namespace CharacterControl
+
+#endif
@@ -44,7 +44,7 @@ project("CharacterControl-".._OPTIONS["platformapi"])
 	
 	if (_OPTIONS["platformapi"] == "win32d3d11" or _OPTIONS["platformapi"] == "win32d3d9" or _OPTIONS["platformapi"] == "win32gl") then
 		-- pc
-		links { "ws2_32" }
+		links { "ws2_32", "winmm" }
 		
 		-- prebuildcommands { 'ml.exe /c /nologo /Zi /Fo "$(IntDir)test.obj" /Fl"" /W3 /errorReport:prompt  /Ta test.asm' }
 		linkoptions { ' /NODEFAULTLIB:LIBC /SAFESEH:NO' }
@@ -70,6 +70,11 @@ project("CharacterControl-".._OPTIONS["platformapi"])
 		files { "info.plist" }
 	end
 	
+	if _OPTIONS["platformapi"] == "linux-headless" then
+		-- dedicated server. run from workspace root so that Code/ and AssetsOut/ resolve
+		links { "pthread", "rt", "dl" }
+	end
+	
 	--configuration { "*.asm" }
 	--buildoptions { "`wx-config --cxxflags`", "-ansi", "-pedantic" }
 	
@@ -14,6 +14,8 @@
 
 // APIABSTRACTION_OGL AND APIABSTRACTION_IOS iOS
 
+// APIABSTRACTION_HEADLESS AND PE_PLAT_IS_LINUX - Linux, no graphics (dedicated server, load tests)
+
 #ifndef PE_64_BIT
 #define PE_64_BIT 0
 #endif
@@ -34,6 +36,10 @@
 #	define APIABSTRACTION_GLPC 0
 #endif
 
+#ifndef APIABSTRACTION_HEADLESS
+#	define APIABSTRACTION_HEADLESS 0
+#endif
+
 
 
 #	define OGL_USE_VERTEX_BUFFER_ARRAYS 0
@@ -83,10 +89,13 @@
 
 #define PE_DETAILED_GPU_PROFILING 1
 
+// headless has no gpu: code choosing api specific values gets 0 and api specific calls are compiled out
 #if APIABSTRACTION_D3D11
 	#define API_CHOOSE_DX11_DX9_OGL(dx11, dx9, ogl) (dx11)
 #elif APIABSTRACTION_D3D9
 	#define API_CHOOSE_DX11_DX9_OGL(dx11, dx9, ogl) (dx9)
+#elif APIABSTRACTION_HEADLESS
+	#define API_CHOOSE_DX11_DX9_OGL(dx11, dx9, ogl) (0)
 #else
 	#define API_CHOOSE_DX11_DX9_OGL(dx11, dx9, ogl) (ogl)
 #endif
@@ -98,20 +107,24 @@
 #define API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(dx11, dx9, ogl, vita) dx11
 #elif APIABSTRACTION_D3D9
 #define API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(dx11, dx9, ogl, vita) dx9
-#elif PE_PLAT_IS_PSVITA
+#elif PE_PLAT_IS_PSVITA || APIABSTRACTION_HEADLESS
 #define API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(dx11, dx9, ogl, vita) vita
 #else
 #define API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(dx11, dx9, ogl, vita) ogl
 #endif
 
+#if APIABSTRACTION_HEADLESS
+#define API_CHOOSE_DX11_DX9_OGL_PSVITA(dx11, dx9, ogl, vita) (0)
+#else
 #define API_CHOOSE_DX11_DX9_OGL_PSVITA(dx11, dx9, ogl, vita) ( API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(dx11, dx9, ogl, vita) )
+#endif
 
 
 #if APIABSTRACTION_D3D11
 #define API_CHOOSE_DX11_DX9_OGL_IOS_PSVITA(dx11, dx9, ogl, ios, vita) (dx11)
 #elif APIABSTRACTION_D3D9
 #define API_CHOOSE_DX11_DX9_OGL_IOS_PSVITA(dx11, dx9, ogl, ios, vita) (dx9)
-#elif PE_PLAT_IS_PSVITA
+#elif PE_PLAT_IS_PSVITA || APIABSTRACTION_HEADLESS
 #define API_CHOOSE_DX11_DX9_OGL_IOS_PSVITA(dx11, dx9, ogl, ios, vita) (vita)
 #elif PE_PLAT_IS_IOS
 #define API_CHOOSE_DX11_DX9_OGL_IOS_PSVITA(dx11, dx9, ogl, ios, vita) (ios)
@@ -166,10 +179,12 @@
 #define PE_API_BIT_D3D9 0x0001
 #define PE_API_BIT_D3D11 0x0002
 #define PE_API_BIT_GL 0x0004
+#define PE_API_BIT_HEADLESS 0x0008
 #define PE_PLAT_BIT_WIN32 0x0100
 #define PE_PLAT_BIT_XBOX360 0x0200
 #define PE_PLAT_BIT_PS3 0x0400
 #define PE_PLAT_BIT_IOS 0x0800
+#define PE_PLAT_BIT_LINUX 0x1000
 
 #ifndef PE_API_IS_D3D9
 #define PE_API_IS_D3D9 0
@@ -184,6 +199,10 @@
 #define PE_API_IS_GL 0
 #endif
 
+#ifndef PE_API_IS_HEADLESS
+#define PE_API_IS_HEADLESS 0
+#endif
+
 
 #ifndef PE_PLAT_IS_WIN32
 #define PE_PLAT_IS_WIN32 0
@@ -198,6 +217,10 @@
 #define PE_PLAT_IS_IOS 0
 #endif
 
+#ifndef PE_PLAT_IS_LINUX
+#define PE_PLAT_IS_LINUX 0
+#endif
+
 #if PE_PLAT_IS_IOS
 #define MAX_TEXTURE_LOAD_WIDTH 512
 #elif PE_PLAT_IS_PS3
@@ -209,7 +232,7 @@
 #define DEBUG_DRAW_CALLS 0
 
 
-#if APIABSTRACTION_PSVITA || APIABSTRACTION_IOS || PE_PLAT_IS_PS4
+#if APIABSTRACTION_PSVITA || APIABSTRACTION_IOS || PE_PLAT_IS_PS4 || PE_PLAT_IS_LINUX
 #define PE_INLINE inline
 #else
 #define PE_INLINE __forceinline
@@ -246,6 +246,14 @@ void Effect::loadTechniqueAsync()
 	}
 }
 
+// sends state unless it is what was last sent to the api
+template <typename State>
+static inline void bindStateIfChanged(Effect *pEffect, RenderStateType type, State *pState)
+{
+	if (pEffect->m_pContext->getGPUScreen()->m_stateShadow.shouldApply(type, 0, pState))
+		pState->bindToPipeline(pEffect);
+}
+
 void Effect::setCurrent(PE::VertexBufferGPU *pCurVertexBuffer)
 {
 	/*if (!lock())
@@ -271,13 +279,13 @@ void Effect::setCurrent(PE::VertexBufferGPU *pCurVertexBuffer)
 		pDevice->SetRenderState( D3DRS_LIGHTING, FALSE );
 
 		PEASSERT(m_pBlendState != NULL, "Every Technique has to have a blend state");
-		m_pBlendState->bindToPipeline(this);
+		bindStateIfChanged(this, RenderStateType_Blend, m_pBlendState);
 
 		PEASSERT(m_pRasterizerState != NULL, "Every Technique has to have a rasterizer state");
-		m_pRasterizerState->bindToPipeline(this);
+		bindStateIfChanged(this, RenderStateType_Rasterizer, m_pRasterizerState);
         
         PEASSERT(m_pDepthStencilState != NULL, "Every Technique has to have a depth stencil state");
-        m_pDepthStencilState->bindToPipeline(this);
+        bindStateIfChanged(this, RenderStateType_DepthStencil, m_pDepthStencilState);
 	}
 
 #	elif APIABSTRACTION_D3D11
@@ -293,15 +301,15 @@ void Effect::setCurrent(PE::VertexBufferGPU *pCurVertexBuffer)
 
 	PEASSERT(m_CS || m_pBlendState != NULL, "Every Non-CS Technique has to have a blend state");
 	if (m_pBlendState)
-		m_pBlendState->bindToPipeline(this);
+		bindStateIfChanged(this, RenderStateType_Blend, m_pBlendState);
 
 	PEASSERT(m_CS || m_pRasterizerState != NULL, "Every Non-CS Technique has to have a rasterizer state");
 	if (m_pRasterizerState)
-		m_pRasterizerState->bindToPipeline(this);
+		bindStateIfChanged(this, RenderStateType_Rasterizer, m_pRasterizerState);
 
     PEASSERT(m_CS || m_pDepthStencilState != NULL, "Every Non-CS Technique has to have a depth stencil state");
 	if (m_pDepthStencilState)
-		m_pDepthStencilState->bindToPipeline(this);
+		bindStateIfChanged(this, RenderStateType_DepthStencil, m_pDepthStencilState);
 
 #elif APIABSTRACTION_OGL
 
@@ -334,13 +342,13 @@ void Effect::setCurrent(PE::VertexBufferGPU *pCurVertexBuffer)
     #endif
 
 	PEASSERT(m_pRasterizerState != NULL, "Every Technique has to have a rasterizer state");
-	m_pRasterizerState->bindToPipeline(this);
+	bindStateIfChanged(this, RenderStateType_Rasterizer, m_pRasterizerState);
 
 	PEASSERT(m_pBlendState != NULL, "Every Technique has to have a blend state");
-	m_pBlendState->bindToPipeline(this);
+	bindStateIfChanged(this, RenderStateType_Blend, m_pBlendState);
     
     PEASSERT(m_pDepthStencilState != NULL, "Every Technique has to have a depth stencil state");
-	m_pDepthStencilState->bindToPipeline(this);
+	bindStateIfChanged(this, RenderStateType_DepthStencil, m_pDepthStencilState);
 
 	
 #endif
@@ -181,6 +181,49 @@ void EffectManager::setupConstantBuffersAndShaderResources()
 #	endif
 }
 
+static bool effectUsesShaderFile(Effect *pEffect, const char *filename)
+{
+	return StringOps::strcmp(pEffect->m_vsFilename, filename) == 0 || StringOps::strcmp(pEffect->m_psFilename, filename) == 0
+		|| StringOps::strcmp(pEffect->m_gsFilename, filename) == 0 || StringOps::strcmp(pEffect->m_csFilename, filename) == 0;
+}
+
+PrimitiveTypes::UInt32 EffectManager::reloadShaderFile_needsRC(const char *filename)
+{
+	bool used = false;
+	for (PrimitiveTypes::UInt32 i = 0; i < m_map.m_pairs.m_size && !used; i++)
+		used = effectUsesShaderFile(m_map.m_pairs[i].m_handle.getObject<Effect>(), filename);
+
+#if !PE_PLAT_IS_PSVITA
+	// shaders are shared by entry point name, have to be compiled again. old ones are not released, techniques
+	// that are not recompiled may use them
+	if (!used)
+	{
+		m_pixelShaders.m_pairs.clear();
+		m_vertexShaders.m_pairs.clear();
+	}
+#endif
+
+	PrimitiveTypes::UInt32 n = 0;
+	for (PrimitiveTypes::UInt32 i = 0; i < m_map.m_pairs.m_size; i++)
+	{
+		Effect *pEffect = m_map.m_pairs[i].m_handle.getObject<Effect>();
+		if (used ? !effectUsesShaderFile(pEffect, filename) : StringOps::length(pEffect->m_vsFilename) == 0)
+			continue;
+
+#if !PE_PLAT_IS_PSVITA
+		if (used)
+		{
+			m_pixelShaders.remove(pEffect->m_psName);
+			m_vertexShaders.remove(pEffect->m_vsName);
+		}
+#endif
+		pEffect->loadTechniqueAsync();
+		++n;
+	}
+	PEINFO("EffectManager: %s changed, recompiled %d techniques\n", filename, n);
+	return n;
+}
+
 void EffectManager::createSetShadowMapShaderValue(PE::Components::DrawList *pDrawList)
 {
 	Handle &h = pDrawList->nextGlobalShaderValue();
@@ -71,6 +71,10 @@ struct EffectManager : public PE::PEAllocatableAndDefragmentable
 		EffectManager::s_myHandle = handle;
 	}
 
+	// hot reload: recompiles techniques that use the shader file (name without path) into the same Effects.
+	// a file no technique uses is an include, then all techniques are recompiled. returns number recompiled
+	PrimitiveTypes::UInt32 reloadShaderFile_needsRC(const char *filename);
+
 	void setTextureAndDepthTextureRenderTargetForGlow();
 	void setTextureAndDepthTextureRenderTargetForDefaultRendering();
 
@@ -138,6 +142,9 @@ public:
 #	elif APIABSTRACTION_OGL
 	PEMap<GLuint> m_vertexShaders;
 	PEMap<GLuint> m_pixelShaders;
+#	elif APIABSTRACTION_HEADLESS
+	PEMap<int> m_vertexShaders;
+	PEMap<int> m_pixelShaders;
 #	elif PE_PLAT_IS_PSVITA
 #	endif
 
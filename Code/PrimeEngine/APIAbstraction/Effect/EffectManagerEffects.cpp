@@ -9,6 +9,7 @@
 // Inter-Engine includes
 #include "PrimeEngine/Lua/LuaEnvironment.h"
 #include "../../Lua/EventGlue/EventDataCreators.h"
+#include "PrimeEngine/APIAbstraction/GPUBuffers/VertexPacking.h"
 	
 // Sibling/Children includes
 #include "EffectManager.h"
@@ -371,6 +372,74 @@ namespace PE {
 		m_map.add("DetailedMesh_ZOnly_Tech", htexturedskinzonly);
 	}
 
+#if PE_HAS_PACKED_VERTEX_FORMATS
+	// packed vertex format permutations. same pixel shaders, vertex shaders decode packed inputs
+	{
+		Handle hEffect("EFFECT", sizeof(Effect));
+		Effect *pEffect = new(hEffect) Effect(*m_pContext, m_arena, hEffect);
+		pEffect->loadTechnique(
+			"DetailedMeshPacked_Shadowed_VS", "main",
+			NULL, NULL, // geometry shader
+			"DetailedMesh_Shadowed_A_Glow_PS", "main",
+			NULL, NULL, // compute shader
+			PERasterizerState_SolidTriBackCull,
+			PEDepthStencilState_ZBuffer, PEAlphaBlendState_NoBlend, // depth stencil, blend states
+			"DetailedMeshPacked_Shadowed_A_Glow_Tech");
+
+		pEffect->m_psInputFamily = EffectPSInputFamily::DETAILED_MESH_PS_IN;
+		pEffect->m_effectDrawOrder = EffectDrawOrder::First;
+		m_map.add("DetailedMeshPacked_Shadowed_A_Glow_Tech", hEffect);
+	}
+
+	{
+		Handle hEffect("EFFECT", sizeof(Effect));
+		Effect *pEffect = new(hEffect) Effect(*m_pContext, m_arena, hEffect);
+		pEffect->loadTechnique(
+			"DetailedSkinPacked_Shadowed_VS", "main",
+			NULL, NULL, // geometry shader
+			"DetailedMesh_Shadowed_A_Glow_PS", "main",
+			NULL, NULL, // compute shader
+			PERasterizerState_SolidTriBackCull,
+			PEDepthStencilState_ZBuffer, PEAlphaBlendState_NoBlend, // depth stencil, blend states
+			"DetailedSkinPacked_Shadowed_A_Glow_Tech");
+
+		pEffect->m_psInputFamily = EffectPSInputFamily::DETAILED_MESH_PS_IN;
+		m_map.add("DetailedSkinPacked_Shadowed_A_Glow_Tech", hEffect);
+	}
+
+	{
+		Handle hEffect("EFFECT", sizeof(Effect));
+		Effect *pEffect = new(hEffect) Effect(*m_pContext, m_arena, hEffect);
+		pEffect->loadTechnique(
+			"DetailedMeshPacked_ZOnly_VS", "main",
+			NULL, NULL, // geometry shader
+			API_CHOOSE_DX11_ELSE(NULL, "DetailedMesh_ZOnly_PS"), "main",
+			NULL, NULL, // compute shader
+			PERasterizerState_SolidTriBackCull,
+			PEDepthStencilState_ZBuffer, PEAlphaBlendState_NoBlend, // depth stencil, blend states
+			"DetailedMeshPacked_ZOnly_Tech");
+		pEffect->m_psInputFamily = EffectPSInputFamily::REDUCED_MESH_PS_IN;
+
+		m_map.add("DetailedMeshPacked_ZOnly_Tech", hEffect);
+	}
+
+	{
+		Handle hEffect("EFFECT", sizeof(Effect));
+		Effect *pEffect = new(hEffect) Effect(*m_pContext, m_arena, hEffect);
+		pEffect->loadTechnique(
+			"DetailedSkinPacked_ZOnly_VS", "main",
+			NULL, NULL, // geometry shader
+			API_CHOOSE_DX11_ELSE(NULL, "DetailedMesh_ZOnly_PS"), "main",
+			NULL, NULL, // compute shader
+			PERasterizerState_SolidTriBackCull,
+			PEDepthStencilState_ZBuffer, PEAlphaBlendState_NoBlend, // depth stencil, blend states
+			"DetailedSkinPacked_ZOnly_Tech");
+		pEffect->m_psInputFamily = EffectPSInputFamily::REDUCED_MESH_PS_IN;
+
+		m_map.add("DetailedSkinPacked_ZOnly_Tech", hEffect);
+	}
+#endif
+
 
 	{
 		Handle hflattex2dfx("EFFECT", sizeof(Effect));
@@ -36,7 +36,7 @@ void Effect::SetLuaFunctions(PE::Components::LuaEnvironment *pLuaEnv, lua_State
 
 	// run a script to add additional functionality to Lua side of Effect
 	// that is accessible from Lua
-#if APIABSTRACTION_IOS
+#if APIABSTRACTION_IOS || PE_PLAT_IS_LINUX
 	pLuaEnv->runScriptWorkspacePath("Code/PrimeEngine/APIAbstraction/Effect/Effect.lua");
 #else
 	pLuaEnv->runScriptWorkspacePath("Code\\PrimeEngine\\APIAbstraction\\Effect\\Effect.lua");
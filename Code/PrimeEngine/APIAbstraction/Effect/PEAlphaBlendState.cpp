@@ -44,6 +44,13 @@ PEAlphaBlendState::APIBlendType PEAlphaBlendState::PEBlendFactorToAPIBlendFactor
 	case PEBlendFactor_SrcA: return GL_SRC_ALPHA;
 	case PEBlendFactor_InvSrcA: return GL_ONE_MINUS_SRC_ALPHA;
 	case PEBlendFactor_DestA: return GL_DST_ALPHA;
+#elif APIABSTRACTION_HEADLESS
+	// no api, keep engine values
+	case PEBlendFactor_0:
+	case PEBlendFactor_1:
+	case PEBlendFactor_SrcA:
+	case PEBlendFactor_InvSrcA:
+	case PEBlendFactor_DestA: return peVal;
 #elif PE_PLAT_IS_PSVITA
 #endif
 	default: assert(!"This PEBlendFactor is not supported yet"); return API_CHOOSE_DX11_DX9_OGL(D3D11_BLEND_ZERO, 0, 0);
@@ -130,6 +137,18 @@ void PEAlphaBlendState::setAPIValues()
 #endif
 }
 
+RenderStateDesc PEAlphaBlendState::getDesc() const
+{
+	PrimitiveTypes::UInt32 bits = 0;
+	if (m_blendEnabled)
+	{
+		bits = 1 | (m_rgbBlendOp << 2) | (m_srcRGBBlendFactor << 4) | (m_dstRGBBlendFactor << 7);
+		if (m_useSeparateSettingForAlphaChannel)
+			bits |= 2 | (m_alphaBlendOp << 10) | (m_srcAlphaBlendFactor << 12) | (m_dstAlphaBlendFactor << 15);
+	}
+	return RenderStateDesc(RenderStateType_Blend, bits);
+}
+
 void PEAlphaBlendState::bindToPipeline(Components::Effect *pCurEffect)
 {
 	#if APIABSTRACTION_D3D9
@@ -236,8 +255,7 @@ void PEAlphaBlendState::bindToPipeline(Components::Effect *pCurEffect)
             // RtA = TexA
             PEAlphaBlendState blendState(context, arena);
             blendState.m_blendEnabled = false;
-            blendState.setAPIValues();
-            m_alphaBlendStates[PEAlphaBlendState_NoBlend] = blendState;
+            setUniqueState(PEAlphaBlendState_NoBlend, blendState);
         }
         
         {
@@ -254,16 +272,28 @@ void PEAlphaBlendState::bindToPipeline(Components::Effect *pCurEffect)
             blendState.m_alphaBlendOp = PEAlphaBlendState::PEBlendOp_Add;
             blendState.m_srcAlphaBlendFactor = PEAlphaBlendState::PEBlendFactor_0;
             blendState.m_dstAlphaBlendFactor = PEAlphaBlendState::PEBlendFactor_1;
-            blendState.setAPIValues();
-            
-            m_alphaBlendStates[PEAlphaBlendState_DefaultRGBLerp_A_DestUnchanged] = blendState;
+            setUniqueState(PEAlphaBlendState_DefaultRGBLerp_A_DestUnchanged, blendState);
         }
         
     }
     
+    void PEAlphaBlendStateManager::setUniqueState(E_PEAlphaBlendState id, PEAlphaBlendState &state)
+    {
+        RenderStateDesc desc = state.getDesc();
+        PEAlphaBlendState *pUnique = (PEAlphaBlendState *)(RenderStateCache::Instance()->find(desc));
+        if (!pUnique)
+        {
+            state.setAPIValues();
+            m_alphaBlendStates[id] = state;
+            pUnique = &m_alphaBlendStates[id];
+            RenderStateCache::Instance()->add(desc, pUnique);
+        }
+        m_pUniqueStates[id] = pUnique;
+    }
+
     PEAlphaBlendState *PEAlphaBlendStateManager::getAlphaBlendState(E_PEAlphaBlendState state)
     {
-        return &m_alphaBlendStates[state];
+        return m_pUniqueStates[state];
     }
     
     
@@ -39,6 +39,9 @@ namespace Components
 	
 	void setAPIValues();
 
+	// settings for RenderStateCache
+	RenderStateDesc getDesc() const;
+
 	enum PEBlendOp
 	{
 		PEBlendOp_Add, // default, example: source * source_alpha + dest * dest_alpha
@@ -95,8 +98,12 @@ struct PEAlphaBlendStateManager : public PEAllocatable
 	void Initialize(PE::GameContext &context, PE::MemoryArena arena);
     
 	PEAlphaBlendState *getAlphaBlendState(E_PEAlphaBlendState state);
+
+	// shares state object with an earlier one with same settings, creates api object otherwise
+	void setUniqueState(E_PEAlphaBlendState id, PEAlphaBlendState &state);
     
 	PEAlphaBlendState *m_alphaBlendStates;
+	PEAlphaBlendState *m_pUniqueStates[PEAlphaBlendState_Count]; // into m_alphaBlendStates
         
 };
     
@@ -69,6 +69,11 @@ namespace PE {
         #endif
     }
     
+    RenderStateDesc PEDepthStencilState::getDesc() const
+    {
+        return RenderStateDesc(RenderStateType_DepthStencil, m_depthTestEnabled ? 1 : 0);
+    }
+
     void PEDepthStencilState::bindToPipeline(Components::Effect *pCurEffect)
     {
         #if APIABSTRACTION_D3D9
@@ -117,23 +122,35 @@ namespace PE {
         {
             PEDepthStencilState dss(context, arena);
             dss.m_depthTestEnabled = true;
-            dss.setAPIValues();
-            m_depthStencilStates[PEDepthStencilState_ZBuffer] = dss;
+            setUniqueState(PEDepthStencilState_ZBuffer, dss);
         }
         
         {
             PEDepthStencilState dss(context, arena);
             dss.m_depthTestEnabled = false;
-            dss.setAPIValues();
-            m_depthStencilStates[PEDepthStencilState_NoZBuffer] = dss;
+            setUniqueState(PEDepthStencilState_NoZBuffer, dss);
         }
         
         
     }
     
+    void PEDepthStencilStateManager::setUniqueState(E_PEDepthStencilState id, PEDepthStencilState &state)
+    {
+        RenderStateDesc desc = state.getDesc();
+        PEDepthStencilState *pUnique = (PEDepthStencilState *)(RenderStateCache::Instance()->find(desc));
+        if (!pUnique)
+        {
+            state.setAPIValues();
+            m_depthStencilStates[id] = state;
+            pUnique = &m_depthStencilStates[id];
+            RenderStateCache::Instance()->add(desc, pUnique);
+        }
+        m_pUniqueStates[id] = pUnique;
+    }
+
     PEDepthStencilState *PEDepthStencilStateManager::getDepthStencilState(E_PEDepthStencilState state)
     {
-        return &m_depthStencilStates[state];
+        return m_pUniqueStates[state];
     }
     
     
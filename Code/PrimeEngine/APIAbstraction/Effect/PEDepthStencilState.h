@@ -44,6 +44,9 @@ namespace PE {
         void bindToPipeline(Components::Effect *pCurEffect);
         
         void setAPIValues();
+
+        // settings for RenderStateCache
+        RenderStateDesc getDesc() const;
         
         bool m_depthTestEnabled;
         
@@ -61,8 +64,12 @@ namespace PE {
         void Initialize(PE::GameContext &context, PE::MemoryArena arena);
         
         PEDepthStencilState *getDepthStencilState(E_PEDepthStencilState state);
+
+        // shares state object with an earlier one with same settings, creates api object otherwise
+        void setUniqueState(E_PEDepthStencilState id, PEDepthStencilState &state);
         
         PEDepthStencilState *m_depthStencilStates;
+        PEDepthStencilState *m_pUniqueStates[PEDepthStencilState_Count]; // into m_depthStencilStates
     };
     
 }; // namespace PE
@@ -79,6 +79,11 @@ void PERasterizerState::setAPIValues()
 #endif
 }
 
+RenderStateDesc PERasterizerState::getDesc() const
+{
+	return RenderStateDesc(RenderStateType_Rasterizer, m_cullMode | (m_fillMode << 2));
+}
+
 void PERasterizerState::bindToPipeline(Components::Effect *pCurEffect)
 {
 	#if APIABSTRACTION_D3D9
@@ -136,22 +141,33 @@ void PERasterizerStateManager::Initialize(PE::GameContext &context, PE::MemoryAr
 	PERasterizerState rs(context, arena);
 	rs.m_cullMode = PERasterizerState::PERasterizerCullMode_Back;
 	rs.m_fillMode = PERasterizerState::PERasterizerFillMode_Solid;
-	rs.setAPIValues();
-	m_rasterizerStates[PERasterizerState_SolidTriBackCull] = rs;
+	setUniqueState(PERasterizerState_SolidTriBackCull, rs);
 
 	rs.m_cullMode = PERasterizerState::PERasterizerCullMode_None;
-	rs.setAPIValues();
-	m_rasterizerStates[PERasterizerState_SolidTriNoCull] = rs;
+	setUniqueState(PERasterizerState_SolidTriNoCull, rs);
 
 	rs.m_cullMode = PERasterizerState::PERasterizerCullMode_None;
 	rs.m_fillMode = PERasterizerState::PERasterizerFillMode_SolidLine;
-	rs.setAPIValues();
-	m_rasterizerStates[PERasterizerState_Line] = rs;
+	setUniqueState(PERasterizerState_Line, rs);
+}
+
+void PERasterizerStateManager::setUniqueState(E_PERasterizerState id, PERasterizerState &state)
+{
+	RenderStateDesc desc = state.getDesc();
+	PERasterizerState *pUnique = (PERasterizerState *)(RenderStateCache::Instance()->find(desc));
+	if (!pUnique)
+	{
+		state.setAPIValues();
+		m_rasterizerStates[id] = state;
+		pUnique = &m_rasterizerStates[id];
+		RenderStateCache::Instance()->add(desc, pUnique);
+	}
+	m_pUniqueStates[id] = pUnique;
 }
 
 PERasterizerState *PERasterizerStateManager::getRasterizerState(E_PERasterizerState state)
 {
-	return &m_rasterizerStates[state];
+	return m_pUniqueStates[state];
 }
 
 
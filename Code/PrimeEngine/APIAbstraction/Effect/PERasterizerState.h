@@ -47,6 +47,9 @@ struct PERasterizerState : PEAllocatable
 
 	void setAPIValues();
 
+	// settings for RenderStateCache
+	RenderStateDesc getDesc() const;
+
 	enum E_PERasterizerCullMode
 	{
 		PERasterizerCullMode_None   = 0,
@@ -79,7 +82,11 @@ struct PERasterizerStateManager : public PEAllocatable
 
 	PERasterizerState *getRasterizerState(E_PERasterizerState state);
 
+	// shares state object with an earlier one with same settings, creates api object otherwise
+	void setUniqueState(E_PERasterizerState id, PERasterizerState &state);
+
 	PERasterizerState *m_rasterizerStates;
+	PERasterizerState *m_pUniqueStates[PERasterizerState_Count]; // into m_rasterizerStates
 };
 
 }; // namespace PE
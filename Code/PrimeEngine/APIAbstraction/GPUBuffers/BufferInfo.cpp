@@ -22,6 +22,8 @@ const char *toString(EPEVertexFormat f)
 	case PEVertexFormat_ReducedSkin: return "ReducedSkin";
 	case PEVertexFormat_StdSkin: return "StdSkin";
 	case PEVertexFormat_DetailedSkin: return "DetailedSkin";
+	case PEVertexFormat_DetailedMeshPacked: return "DetailedMeshPacked";
+	case PEVertexFormat_DetailedSkinPacked: return "DetailedSkinPacked";
 	
 	default: PEASSERT(false, "Unknown format. Have you added new one and not modify this function?"); return "";
 	};
@@ -39,6 +41,10 @@ EPEVertexFormat getFormatFromVSName(const char *vsFilename)
 		return PEVertexFormat_DetailedMesh;
 	if (StringOps::startsswith(vsFilename, "DetailedSkin_"))
 		return PEVertexFormat_DetailedSkin;
+	if (StringOps::startsswith(vsFilename, "DetailedMeshPacked_"))
+		return PEVertexFormat_DetailedMeshPacked;
+	if (StringOps::startsswith(vsFilename, "DetailedSkinPacked_"))
+		return PEVertexFormat_DetailedSkinPacked;
 
 	return PEVertexFormat_Count;
 }
@@ -63,6 +69,8 @@ const char *toString(EPEVertexFormatLayout v)
 	#if !PE_PLAT_IS_PSVITA // vita supports up to 4 vertex streams
 	case PEVertexFormatLayout_DetailedSkin_B0__P0f3_B1__TC0f2_B2__N0f3_B3__T0f3_B4__BW0f4_B5__BW1f4_B6__BI0f4_B7__BI1f4: return "PEVertexFormatLayout_DetailedSkin_B0__P0f3_B1__TC0f2_B2__N0f3_B3__T0f3_B4__BW0f4_B5__BW1f4_B6__BI0f4_B7__BI1f4";
 	#endif
+	case PEVertexFormatLayout_DetailedMeshPacked_B0__P0f3_TC0h2_N0s2_T0s2: return "PEVertexFormatLayout_DetailedMeshPacked_B0__P0f3_TC0h2_N0s2_T0s2";
+	case PEVertexFormatLayout_DetailedSkinPacked_B0__P0f3_BW0b4_BW1b4_BI0b4_BI1b4_TC0h2_N0s2_T0s2: return "PEVertexFormatLayout_DetailedSkinPacked_B0__P0f3_BW0b4_BW1b4_BI0b4_BI1b4_TC0h2_N0s2_T0s2";
 	default: PEASSERT(false, "Unknown layout. Have you added new one and not modify this function?"); return "";
 	};
 }
@@ -220,6 +228,29 @@ int PEVertexAttributeInfo::elementScalarTypeAndNumScalarsToD3DElementScalarType(
 		default: assert(!"This number of PEScalarType is not supported, make sure value is correct and if needed add support for this number fo scalars"); break;
 		};
 		break;
+	case PEScalarType_Float16:
+		switch(numScalars)
+		{
+		case 2: return API_CHOOSE_DX11_DX9(DXGI_FORMAT_R16G16_FLOAT, D3DDECLTYPE_FLOAT16_2);
+		case 4: return API_CHOOSE_DX11_DX9(DXGI_FORMAT_R16G16B16A16_FLOAT, D3DDECLTYPE_FLOAT16_4);
+		default: assert(!"This number of PEScalarType is not supported, make sure value is correct and if needed add support for this number fo scalars"); break;
+		};
+		break;
+	case PEScalarType_SNorm16:
+		switch(numScalars)
+		{
+		case 2: return API_CHOOSE_DX11_DX9(DXGI_FORMAT_R16G16_SNORM, D3DDECLTYPE_SHORT2N);
+		case 4: return API_CHOOSE_DX11_DX9(DXGI_FORMAT_R16G16B16A16_SNORM, D3DDECLTYPE_SHORT4N);
+		default: assert(!"This number of PEScalarType is not supported, make sure value is correct and if needed add support for this number fo scalars"); break;
+		};
+		break;
+	case PEScalarType_UNorm8:
+		switch(numScalars)
+		{
+		case 4: return API_CHOOSE_DX11_DX9(DXGI_FORMAT_R8G8B8A8_UNORM, D3DDECLTYPE_UBYTE4N);
+		default: assert(!"This number of PEScalarType is not supported, make sure value is correct and if needed add support for this number fo scalars"); break;
+		};
+		break;
 	default:assert(!"This PEScalarType is not supported, make sure value is correct and if needed add support for this type"); break;
 	}
 	return 0;
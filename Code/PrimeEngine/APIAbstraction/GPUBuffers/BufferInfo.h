@@ -22,7 +22,11 @@ enum PEScalarType
 {
 	PEScalarType_Undefined,
 	PEScalarType_Float,
-	PEScalarType_UInt16
+	PEScalarType_UInt16,
+	// packed vertex formats. these are converted to floats when fetched by vertex shader
+	PEScalarType_Float16,
+	PEScalarType_SNorm16, // [-32767, 32767] -> [-1, 1]
+	PEScalarType_UNorm8 // [0, 255] -> [0, 1]
 };
 
 enum PESemanticType
@@ -57,6 +61,10 @@ enum EPEVertexFormat
 	PEVertexFormat_ReducedSkin,
 	PEVertexFormat_StdSkin,
 	PEVertexFormat_DetailedSkin,
+	// same as Detailed* but with half float tex coords, octahedral snorm16 normals and tangents
+	// and 8 bit skin weights and indices. see VertexPacking.h
+	PEVertexFormat_DetailedMeshPacked,
+	PEVertexFormat_DetailedSkinPacked,
 	PEVertexFormat_Count
 };
 
@@ -81,6 +89,9 @@ enum EPEVertexFormatLayout
 	#if !PE_PLAT_IS_PSVITA 
 	PEVertexFormatLayout_DetailedSkin_B0__P0f3_B1__TC0f2_B2__N0f3_B3__T0f3_B4__BW0f4_B5__BW1f4_B6__BI0f4_B7__BI1f4,
 	#endif
+	// h - half float, s - snorm16, b - unorm8
+	PEVertexFormatLayout_DetailedMeshPacked_B0__P0f3_TC0h2_N0s2_T0s2,
+	PEVertexFormatLayout_DetailedSkinPacked_B0__P0f3_BW0b4_BW1b4_BI0b4_BI1b4_TC0h2_N0s2_T0s2,
 	PEVertexFormatLayout_Count
 };
 
@@ -72,6 +72,7 @@ void IndexBufferGPU::releaseGPUBuffer()
 
 		OGL_IndexBufferGPU::releaseGPUBuffer(m_buf);
 		m_buf = 0;
+	#elif APIABSTRACTION_HEADLESS
 	#else
 		if (!m_pBuf)
 			return;
@@ -4,6 +4,7 @@
 
 #include "PrimeEngine/APIAbstraction/Effect/Effect.h"
 #include "VertexBufferGPUManager.h"
+#include "VertexPacking.h"
 namespace PE {
 
 VertexBufferGPU::VertexBufferGPU(PE::GameContext &context, PE::MemoryArena arena)
@@ -19,6 +20,11 @@ VertexBufferGPU::~VertexBufferGPU()
 }
 
 void VertexBufferGPU::internalCreateGPUBufferFromCombined(PositionBufferCPU &vb, PrimitiveTypes::UInt32 vertexSize, WRITE_MODES writeMode/* = CONTANT*/)
+{
+	internalCreateGPUBufferFromData(vb.getStartAddress(), vb.getByteSize(), vertexSize, writeMode);
+}
+
+void VertexBufferGPU::internalCreateGPUBufferFromData(void *pData, PrimitiveTypes::UInt32 byteSize, PrimitiveTypes::UInt32 vertexSize, WRITE_MODES writeMode/* = CONTANT*/)
 {
 	#if PE_PLAT_IS_PSVITA
 
@@ -27,9 +33,9 @@ void VertexBufferGPU::internalCreateGPUBufferFromCombined(PositionBufferCPU &vb,
 		LPDIRECT3DDEVICE9 pDevice = pD3D9Renderer->m_pD3D9Device;
 
 		m_pBuf = D3D9_VertexBufferGPU::CreateVertexBufferInGPUFromVb(
-			pDevice, vb.getStartAddress(), vb.getByteSize());
+			pDevice, pData, byteSize);
 		m_vertexSize = vertexSize;
-		m_length = vb.getByteSize() / vertexSize;
+		m_length = byteSize / vertexSize;
 	#elif APIABSTRACTION_D3D11
 		D3D11Renderer *pD3D11Renderer = static_cast<D3D11Renderer *>(m_pContext->getGPUScreen());
 		ID3D11Device *pDevice = pD3D11Renderer->m_pD3DDevice;
@@ -38,18 +44,18 @@ void VertexBufferGPU::internalCreateGPUBufferFromCombined(PositionBufferCPU &vb,
 		// Note that we use an abstract gpu handle to avoid a bunch of #if ..#endif
 		if (writeMode == CONSTANT)
 			m_pBuf = D3D11_VertexBufferGPU::CreateVertexBufferInGPUFromVb(
-			pDevice, vb.getStartAddress(), vb.getByteSize());
+			pDevice, pData, byteSize);
 		else if (writeMode == WRITABLE_BY_API)
 			m_pBuf = D3D11_VertexBufferGPU::CreateVertexBufferInGPUFromVb(
-			pDevice, vb.getStartAddress(), vb.getByteSize(),
+			pDevice, pData, byteSize,
 			false, false); // not constant, not stream output
 		else if (writeMode == STREAM_OUTPUT)
 			m_pBuf = D3D11_VertexBufferGPU::CreateVertexBufferInGPUFromVb(
-			pDevice, vb.getStartAddress(), vb.getByteSize(),
+			pDevice, pData, byteSize,
 			false, true); // not constant, stream output
 
 		m_vertexSize = vertexSize;
-		m_length = vb.getByteSize() / vertexSize;
+		m_length = byteSize / vertexSize;
 	#endif
 }
 
@@ -722,6 +728,162 @@ void VertexBufferGPU::createGPUBufferFromSource_StdMesh(PositionBufferCPU &vb, T
 }
 
 
+void VertexBufferGPU::createDynamicGPUBuffer_StdMesh(PrimitiveTypes::UInt32 maxVertices)
+{
+	#if APIABSTRACTION_OGL
+		// zeroed sources just to size the buffers
+		PositionBufferCPU vb(*m_pContext, m_arena);
+		TexCoordBufferCPU tcb(*m_pContext, m_arena);
+		NormalBufferCPU nb(*m_pContext, m_arena);
+		vb.m_values.reset(maxVertices * 3);
+		tcb.m_values.reset(maxVertices * 2);
+		nb.m_values.reset(maxVertices * 3);
+		memset(vb.m_values.getFirstPtr(), 0, maxVertices * 3 * sizeof(PrimitiveTypes::Float32));
+		memset(tcb.m_values.getFirstPtr(), 0, maxVertices * 2 * sizeof(PrimitiveTypes::Float32));
+		memset(nb.m_values.getFirstPtr(), 0, maxVertices * 3 * sizeof(PrimitiveTypes::Float32));
+		vb.m_values.m_size = maxVertices * 3;
+		tcb.m_values.m_size = maxVertices * 2;
+		nb.m_values.m_size = maxVertices * 3;
+
+		memset(m_bufs, 0, sizeof(m_bufs));
+		m_buf = OGL_VertexBufferGPU::CreateVertexBufferInGPUFromVbNbTb(
+			*m_pContext, m_arena,
+			&vb, NULL, &tcb, &nb, NULL, NULL, false, &m_bufs[0]);
+		m_vertexSize = sizeof(PrimitiveTypes::Float32) * 8;
+		m_length = maxVertices;
+
+		vb.m_values.reset(0);
+		tcb.m_values.reset(0);
+		nb.m_values.reset(0);
+
+		m_pBufferSetInfo = &VertexBufferGPUManager::Instance()->m_vertexBufferInfos[PEVertexFormatLayout_StdMesh_B0__P0f3_B1__TC0f2_B2__N0f3];
+	#elif PE_PLAT_IS_PSVITA || APIABSTRACTION_HEADLESS
+		m_vertexSize = sizeof(PrimitiveTypes::Float32) * 8;
+		m_length = maxVertices;
+		m_pBufferSetInfo = &VertexBufferGPUManager::Instance()->m_vertexBufferInfos[PEVertexFormatLayout_StdMesh_B0__P0f3_TC0f2_N0f3];
+	#else
+		// zeroed so that normals are 0
+		PositionBufferCPU res(*m_pContext, m_arena);
+		res.m_values.reset(maxVertices * (3 + 2 + 3));
+		memset(res.m_values.getFirstPtr(), 0, maxVertices * (3 + 2 + 3) * sizeof(PrimitiveTypes::Float32));
+		res.m_values.m_size = maxVertices * (3 + 2 + 3);
+
+		internalCreateGPUBufferFromCombined(res, sizeof(PrimitiveTypes::Float32) * (3 + 2 + 3), WRITABLE_BY_API);
+		res.m_values.reset(0);
+		m_pBufferSetInfo = &VertexBufferGPUManager::Instance()->m_vertexBufferInfos[PEVertexFormatLayout_StdMesh_B0__P0f3_TC0f2_N0f3];
+	#endif
+
+	setAPIValues();
+}
+
+void VertexBufferGPU::updateDynamicStdMesh(const PrimitiveTypes::Float32 *pData, const PrimitiveTypes::Float32 *pTexCoords, PrimitiveTypes::UInt32 numVertices)
+{
+	PEASSERT(numVertices <= m_length, "Dynamic vertex buffer overflow");
+	if (numVertices == 0)
+		return;
+
+	#if APIABSTRACTION_OGL
+		glBindBuffer(GL_ARRAY_BUFFER, m_bufs[0]);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, numVertices * 3 * sizeof(GLfloat), pData);
+		glBindBuffer(GL_ARRAY_BUFFER, m_bufs[1]);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, numVertices * 2 * sizeof(GLfloat), pTexCoords);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		PE::IRenderer::checkForErrors("");
+	#elif APIABSTRACTION_D3D9
+		void *pDst = NULL;
+		m_pBuf->Lock(0, numVertices * m_vertexSize, &pDst, 0);
+		memcpy(pDst, pData, numVertices * m_vertexSize);
+		m_pBuf->Unlock();
+	#elif APIABSTRACTION_D3D11
+		D3D11Renderer *pD3D11Renderer = static_cast<D3D11Renderer *>(m_pContext->getGPUScreen());
+		ID3D11DeviceContext *pDeviceContext = pD3D11Renderer->m_pD3DContext;
+
+		D3D11_BOX box;
+		box.left = 0; box.right = numVertices * m_vertexSize;
+		box.top = 0; box.bottom = 1;
+		box.front = 0; box.back = 1;
+		pDeviceContext->UpdateSubresource(m_pBuf, 0, &box, pData, 0, 0);
+	#endif
+}
+
+#if PE_HAS_PACKED_VERTEX_FORMATS
+void VertexBufferGPU::createGPUBufferFromSource_DetailedMeshPacked(PositionBufferCPU &vb, TexCoordBufferCPU &tcb, NormalBufferCPU &nb, TangentBufferCPU &tb)
+{
+	// position f3, tex coord h2, normal s2, tangent s2 = 24 bytes vs 44 bytes of DetailedMesh
+	const PrimitiveTypes::UInt32 vertexWordSize = 3 + 1 + 1 + 1;
+
+	// words, not floats: packed words can be signaling nan patterns that a float copy could quiet
+	Array<PrimitiveTypes::UInt32> res(*m_pContext, m_arena);
+	res.reset((vb.m_values.m_size / 3) * vertexWordSize);
+
+	for (PrimitiveTypes::UInt32 iv = 0; iv < vb.m_values.m_size / 3; iv++)
+	{
+		PrimitiveTypes::UInt32 curInex = iv * 3;
+		res.add(VertexPacking::asUInt(vb.m_values[curInex])); res.add(VertexPacking::asUInt(vb.m_values[curInex + 1])); res.add(VertexPacking::asUInt(vb.m_values[curInex + 2]));
+		res.add(VertexPacking::packHalf2(tcb.m_values[iv * 2], tcb.m_values[iv * 2 + 1]));
+		res.add(VertexPacking::packOctahedralSNorm16(nb.m_values[curInex], nb.m_values[curInex + 1], nb.m_values[curInex + 2]));
+		res.add(VertexPacking::packOctahedralSNorm16(tb.m_values[curInex], tb.m_values[curInex + 1], tb.m_values[curInex + 2]));
+	}
+
+	internalCreateGPUBufferFromData(res.getFirstPtr(), res.m_size * sizeof(PrimitiveTypes::UInt32), sizeof(PrimitiveTypes::UInt32) * vertexWordSize);
+	res.reset(0);
+
+	m_pBufferSetInfo = &VertexBufferGPUManager::Instance()->m_vertexBufferInfos[PEVertexFormatLayout_DetailedMeshPacked_B0__P0f3_TC0h2_N0s2_T0s2];
+
+	setAPIValues();
+}
+
+void VertexBufferGPU::createGPUBufferFromSource_DetailedSkinPacked(PositionBufferCPU &vb, TexCoordBufferCPU &tcb, SkinWeightsCPU &weights, NormalBufferCPU &nb, TangentBufferCPU &tb)
+{
+	// position f3, weights and indices 4 x unorm8 each, tex coord h2, normal s2, tangent s2 = 40 bytes vs 108 bytes of DetailedSkin
+	PEASSERT(DEFAULT_SKIN_WEIGHTS_PER_VERTEX == 4 || DEFAULT_SKIN_WEIGHTS_PER_VERTEX == 8, "Invlaid default number of skin weights");
+	const PrimitiveTypes::UInt32 numWeightWords = DEFAULT_SKIN_WEIGHTS_PER_VERTEX / 4;
+	const PrimitiveTypes::UInt32 vertexWordSize = 3 + numWeightWords * 2 + 1 + 1 + 1;
+
+	// words, not floats: packed words can be signaling nan patterns that a float copy could quiet
+	Array<PrimitiveTypes::UInt32> res(*m_pContext, m_arena);
+	res.reset((vb.m_values.m_size / 3) * vertexWordSize);
+
+	for (PrimitiveTypes::UInt32 iv = 0; iv < vb.m_values.m_size / 3; iv++)
+	{
+		PrimitiveTypes::UInt32 curInex = iv * 3;
+
+		// unused slots have 0 weight and joint 0, so they dont need to be skipped in shader
+		PrimitiveTypes::Float32 vweights[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		unsigned char qweights[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		unsigned char jointIndices[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		PrimitiveTypes::UInt32 nWeights = weights.m_weightsPerVertex[iv].m_size;
+		assert(nWeights <= DEFAULT_SKIN_WEIGHTS_PER_VERTEX);
+
+		for (PrimitiveTypes::UInt32 ivw = 0; ivw < nWeights; ivw++)
+		{
+			vweights[ivw] = weights.m_weightsPerVertex[iv][ivw].m_weight;
+			PEASSERT(weights.m_weightsPerVertex[iv][ivw].m_localJointIndex < 256, "Joint index does not fit into packed skin format");
+			jointIndices[ivw] = (unsigned char)(weights.m_weightsPerVertex[iv][ivw].m_localJointIndex);
+		}
+		VertexPacking::quantizeWeights(vweights, DEFAULT_SKIN_WEIGHTS_PER_VERTEX, qweights);
+
+		res.add(VertexPacking::asUInt(vb.m_values[curInex])); res.add(VertexPacking::asUInt(vb.m_values[curInex + 1])); res.add(VertexPacking::asUInt(vb.m_values[curInex + 2]));
+
+		for (PrimitiveTypes::UInt32 iw = 0; iw < numWeightWords; iw++)
+			res.add(VertexPacking::packUNorm8x4(&qweights[iw * 4]));
+		for (PrimitiveTypes::UInt32 iw = 0; iw < numWeightWords; iw++)
+			res.add(VertexPacking::packUNorm8x4(&jointIndices[iw * 4]));
+
+		res.add(VertexPacking::packHalf2(tcb.m_values[iv * 2], tcb.m_values[iv * 2 + 1]));
+		res.add(VertexPacking::packOctahedralSNorm16(nb.m_values[curInex], nb.m_values[curInex + 1], nb.m_values[curInex + 2]));
+		res.add(VertexPacking::packOctahedralSNorm16(tb.m_values[curInex], tb.m_values[curInex + 1], tb.m_values[curInex + 2]));
+	}
+
+	internalCreateGPUBufferFromData(res.getFirstPtr(), res.m_size * sizeof(PrimitiveTypes::UInt32), sizeof(PrimitiveTypes::UInt32) * vertexWordSize);
+	res.reset(0);
+
+	m_pBufferSetInfo = &VertexBufferGPUManager::Instance()->m_vertexBufferInfos[PEVertexFormatLayout_DetailedSkinPacked_B0__P0f3_BW0b4_BW1b4_BI0b4_BI1b4_TC0h2_N0s2_T0s2];
+
+	setAPIValues();
+}
+#endif
+
 void VertexBufferGPU::setAPIValues()
 {
 #if APIABSTRACTION_OGL
@@ -736,7 +898,7 @@ void VertexBufferGPU::releaseGPUBuffer()
 		OGL_VertexBufferGPU::releaseGPUBuffers(m_buf, &m_bufs[0], MAX_BUFFERS); 
 		memset(m_bufs, 0, sizeof(m_bufs));
 		m_buf = 0;
-	#elif PE_PLAT_IS_PSVITA
+	#elif PE_PLAT_IS_PSVITA || APIABSTRACTION_HEADLESS
 	#else
 		if (!m_pBuf)
 			return;
@@ -54,6 +54,9 @@ private:
 	///
 	void internalCreateGPUBufferFromCombined(PositionBufferCPU &vb, PrimitiveTypes::UInt32 vertexSize, WRITE_MODES writeMode = CONSTANT);
 
+	// same for raw vertex data of byteSize bytes. packed formats use it so that their words are uploaded bit exact
+	void internalCreateGPUBufferFromData(void *pData, PrimitiveTypes::UInt32 byteSize, PrimitiveTypes::UInt32 vertexSize, WRITE_MODES writeMode = CONSTANT);
+
 public:
 
 	VertexBufferGPU(PE::GameContext &context, PE::MemoryArena arena);
@@ -71,6 +74,11 @@ public:
 	void createGPUBufferFromSource_ColoredMinimalMesh(PositionBufferCPU &vb, ColorBufferCPU &cb, WRITE_MODES writeMode = CONSTANT);
 	void createGPUBufferFromSource_ReducedMesh(PositionBufferCPU &vb, TexCoordBufferCPU &tcb, WRITE_MODES writeMode = CONSTANT);
 	void createGPUBufferFromSource_StdMesh(PositionBufferCPU &vb, TexCoordBufferCPU &tcb, NormalBufferCPU &nb);
+	// StdMesh buffer of maxVertices vertices that is rewritten with updateDynamicStdMesh()
+	void createDynamicGPUBuffer_StdMesh(PrimitiveTypes::UInt32 maxVertices);
+	// writes first numVertices vertices. on ogl pData is positions (3 floats) and pTexCoords tex coords (2 floats),
+	// otherwise pData is interleaved StdMesh vertices and pTexCoords is not used. normals are left as created (0)
+	void updateDynamicStdMesh(const PrimitiveTypes::Float32 *pData, const PrimitiveTypes::Float32 *pTexCoords, PrimitiveTypes::UInt32 numVertices);
 	void createGPUBufferFromSource_DetailedMesh(PositionBufferCPU &vb, TexCoordBufferCPU &tcb, NormalBufferCPU &nb, TangentBufferCPU &tb);
 	
 	void createGPUBufferFromSource_MinimalSkin(PositionBufferCPU &vb, SkinWeightsCPU &weights);
@@ -78,6 +86,10 @@ public:
 	void createGPUBufferFromSource_StdSkin(PositionBufferCPU &vb, TexCoordBufferCPU &tcb, SkinWeightsCPU &weights, NormalBufferCPU &nb);
 	void createGPUBufferFromSource_DetailedSkin(PositionBufferCPU &vb, TexCoordBufferCPU &tcb, SkinWeightsCPU &weights, NormalBufferCPU &nb, TangentBufferCPU &tb);
 
+	// packed versions of Detailed* (see VertexPacking.h). only available when PE_HAS_PACKED_VERTEX_FORMATS
+	void createGPUBufferFromSource_DetailedMeshPacked(PositionBufferCPU &vb, TexCoordBufferCPU &tcb, NormalBufferCPU &nb, TangentBufferCPU &tb);
+	void createGPUBufferFromSource_DetailedSkinPacked(PositionBufferCPU &vb, TexCoordBufferCPU &tcb, SkinWeightsCPU &weights, NormalBufferCPU &nb, TangentBufferCPU &tb);
+
 	void createGPUBuffer(PositionBufferCPU &vb, NormalBufferCPU &nb);
 
 	template <typename Particle_type>
@@ -3,6 +3,7 @@
 #include "VertexBufferGPUManager.h"
 #include "../GPUMaterial/GPUMaterialSet.h"
 #include "PrimeEngine/APIAbstraction/GPUBuffers/AnimSetBufferGPU.h"
+#include "VertexPacking.h"
 
 namespace PE {
 
@@ -10,10 +11,15 @@ Handle VertexBufferGPUManager::s_myHandle;
 
 VertexBufferGPUManager::VertexBufferGPUManager(PE::GameContext &context, PE::MemoryArena arena)
 : m_map(context, arena, 1024)
+, m_packedMap(context, arena, 256)
 , m_matSetGPUMap(context, arena, 512)
 , m_IndexGPUMap(context, arena, 1024)
 {
 	m_arena = arena; m_pContext = &context;
+
+	// layouts not supported on this platform dont map to any format
+	for (int i = 0; i < PEVertexFormatLayout_Count; ++i)
+		m_layoutToFormatMap[i] = PEVertexFormat_Count;
 }
 // Reads the specified buffer from file
 Handle VertexBufferGPUManager::createGPUBuffer(Handle hvb, Handle htcb, Handle hnb, bool useBufferRegistry)
@@ -108,6 +114,84 @@ Handle VertexBufferGPUManager::createGPUBufferFromVBufTCBufSWBufNBufTBuf(Handle
 	return res;
 }
 
+Handle VertexBufferGPUManager::createPackedGPUBufferFromVBufTCBufSWBufNBufTBuf(Handle hvb, Handle htcb, Handle hSWBuf, Handle hnb, Handle hTBuf, bool useBufferRegistry)
+{
+	Handle handles[] = {hvb, htcb, hSWBuf, hnb, hTBuf};
+
+	Handle res;
+
+	if (useBufferRegistry)
+	{
+		res = m_packedMap.findHandle(handles);
+		if (res.isValid())
+		{
+			// already have it
+			return res;
+		}
+	}
+
+	res = Handle("VERTEX_BUFFER_GPU", sizeof(VertexBufferGPU));
+	VertexBufferGPU *pvbgpu = new(res) VertexBufferGPU(*m_pContext, m_arena);
+
+#if PE_HAS_PACKED_VERTEX_FORMATS
+	if (hSWBuf.isValid())
+	{
+		pvbgpu->createGPUBufferFromSource_DetailedSkinPacked(
+			*hvb.getObject<PositionBufferCPU>(),
+			*htcb.getObject<TexCoordBufferCPU>(),
+			*hSWBuf.getObject<SkinWeightsCPU>(),
+			*hnb.getObject<NormalBufferCPU>(),
+			*hTBuf.getObject<TangentBufferCPU>());
+	}
+	else
+	{
+		pvbgpu->createGPUBufferFromSource_DetailedMeshPacked(
+			*hvb.getObject<PositionBufferCPU>(),
+			*htcb.getObject<TexCoordBufferCPU>(),
+			*hnb.getObject<NormalBufferCPU>(),
+			*hTBuf.getObject<TangentBufferCPU>());
+	}
+#else
+	PEASSERT(false, "Packed vertex formats are not supported on this platform");
+#endif
+
+	if (useBufferRegistry)
+		m_packedMap.add(handles, res);
+
+	return res;
+}
+
+bool VertexBufferGPUManager::canUsePackedVertexFormat(Handle htcb, Handle hSWBuf)
+{
+#if PE_HAS_PACKED_VERTEX_FORMATS
+	// half float tex coords lose precision quickly for tiled textures
+	TexCoordBufferCPU *ptcb = htcb.getObject<TexCoordBufferCPU>();
+	for (PrimitiveTypes::UInt32 i = 0; i < ptcb->m_values.m_size; ++i)
+	{
+		PrimitiveTypes::Float32 v = ptcb->m_values[i];
+		if (v > PE_PACKED_VERTEX_FORMATS_MAX_TEXCOORD || v < -PE_PACKED_VERTEX_FORMATS_MAX_TEXCOORD)
+			return false;
+	}
+
+	// joint indices are stored in 8 bits
+	if (hSWBuf.isValid())
+	{
+		SkinWeightsCPU *psw = hSWBuf.getObject<SkinWeightsCPU>();
+		for (PrimitiveTypes::UInt32 iv = 0; iv < psw->m_weightsPerVertex.m_size; ++iv)
+		{
+			for (PrimitiveTypes::UInt32 iw = 0; iw < psw->m_weightsPerVertex[iv].m_size; ++iw)
+			{
+				if (psw->m_weightsPerVertex[iv][iw].m_localJointIndex > 255)
+					return false;
+			}
+		}
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
 Handle VertexBufferGPUManager::createGPUBufferFromVBufTCBufSWBufNBuf(Handle hvb, Handle htcb, Handle hSWBuf, Handle hnb, bool useBufferRegistry)
 {
 	Handle handles[] = {hvb, htcb, hSWBuf, hnb, Handle()};
@@ -520,6 +604,60 @@ void VertexBufferGPUManager::setupVertexBufferInfos()
 	}
 	#endif
 
+#if PE_HAS_PACKED_VERTEX_FORMATS
+	// DetailedMeshPacked has only one buffer with all elements within one stride
+	{
+		PEVertexBufferInfo info(*m_pContext, m_arena, PEVertexFormatLayout_DetailedMeshPacked_B0__P0f3_TC0h2_N0s2_T0s2);
+		info.m_bufferInfos.reset(1);
+		PEVertexAttributeBufferInfo buf0;
+		// position
+		buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(0, PEScalarType_Float, 3, PESemanticType_Position, "position", 0);
+		buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(3 * 4, PEScalarType_Float16, 2, PESemanticType_TexCoord, "texcoord", 0);
+		buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(4 * 4, PEScalarType_SNorm16, 2, PESemanticType_Normal, "normal", 0);
+		buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(5 * 4, PEScalarType_SNorm16, 2, PESemanticType_Tangent, "tangent", 0);
+
+		info.m_bufferInfos.add(buf0);
+		info.setAPIValues();
+
+		m_vertexBufferInfos[info.m_vertexFormatLayout] = info;
+		m_layoutToFormatMap[info.m_vertexFormatLayout] = PEVertexFormat_DetailedMeshPacked;
+	}
+
+	// DetailedSkinPacked has only one buffer with all elements within one stride
+	{
+		PEVertexBufferInfo info(*m_pContext, m_arena, PEVertexFormatLayout_DetailedSkinPacked_B0__P0f3_BW0b4_BW1b4_BI0b4_BI1b4_TC0h2_N0s2_T0s2);
+		info.m_bufferInfos.reset(1);
+		PEVertexAttributeBufferInfo buf0;
+		// position
+
+		if (DEFAULT_SKIN_WEIGHTS_PER_VERTEX == 4)
+		{
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(0, PEScalarType_Float, 3, PESemanticType_Position, "position", 0);
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(3 * 4, PEScalarType_UNorm8, 4, PESemanticType_JointWeights, "jointWeights", 0);
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(4 * 4, PEScalarType_UNorm8, 4, PESemanticType_JointIndices, "jointIndices", 0);
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(5 * 4, PEScalarType_Float16, 2, PESemanticType_TexCoord, "texcoord", 0);
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(6 * 4, PEScalarType_SNorm16, 2, PESemanticType_Normal, "normal", 0);
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(7 * 4, PEScalarType_SNorm16, 2, PESemanticType_Tangent, "tangent", 0);
+		}
+		else if (DEFAULT_SKIN_WEIGHTS_PER_VERTEX == 8)
+		{
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(0, PEScalarType_Float, 3, PESemanticType_Position, "position", 0);
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(3 * 4, PEScalarType_UNorm8, 4, PESemanticType_JointWeights, "jointWeights", 0);
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(4 * 4, PEScalarType_UNorm8, 4, PESemanticType_JointWeights, "jointWeights", 1);
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(5 * 4, PEScalarType_UNorm8, 4, PESemanticType_JointIndices, "jointIndices", 0);
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(6 * 4, PEScalarType_UNorm8, 4, PESemanticType_JointIndices, "jointIndices", 1);
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(7 * 4, PEScalarType_Float16, 2, PESemanticType_TexCoord, "texcoord", 0);
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(8 * 4, PEScalarType_SNorm16, 2, PESemanticType_Normal, "normal", 0);
+			buf0.m_attributeInfos[buf0.m_numAttributes++] = PEVertexAttributeInfo(9 * 4, PEScalarType_SNorm16, 2, PESemanticType_Tangent, "tangent", 0);
+		}
+
+		info.m_bufferInfos.add(buf0);
+		info.setAPIValues();
+		m_vertexBufferInfos[info.m_vertexFormatLayout] = info;
+		m_layoutToFormatMap[info.m_vertexFormatLayout] = PEVertexFormat_DetailedSkinPacked;
+	}
+#endif
+
 }
 
 }; // namespace PE
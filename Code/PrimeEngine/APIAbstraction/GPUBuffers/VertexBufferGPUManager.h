@@ -55,6 +55,12 @@ struct VertexBufferGPUManager : public PE::PEAllocatableAndDefragmentable
 	Handle createGPUBufferFromVBufTCBufSWBufNBufTBuf(Handle hvb, Handle htcb, Handle hSWBuf, Handle hnb, Handle hTBuf, bool useBufferRegistry);
 	Handle createGPUBufferFromVBufTCBufSWBufNBuf(Handle hvb, Handle htcb, Handle hSWBuf, Handle hnb, bool useBufferRegistry);
 
+	// DetailedMeshPacked/DetailedSkinPacked versions. hSWBuf is invalid for static mesh
+	Handle createPackedGPUBufferFromVBufTCBufSWBufNBufTBuf(Handle hvb, Handle htcb, Handle hSWBuf, Handle hnb, Handle hTBuf, bool useBufferRegistry);
+
+	// whether geometry can be stored in packed formats without visible precision loss
+	static bool canUsePackedVertexFormat(Handle htcb, Handle hSWBuf);
+
 	Handle createFromSource_ColoredMinimalMesh(Handle hpb, Handle hcb, bool useBufferRegistry);
 
 	Handle createMatSetGPUFromMatSetCPU(Handle hMatSetCPU);
@@ -66,6 +72,7 @@ struct VertexBufferGPUManager : public PE::PEAllocatableAndDefragmentable
 	static Handle s_myHandle;
 
 	HandlesToHandleMap<5> m_map;
+	HandlesToHandleMap<5> m_packedMap; // same source buffers can be used with and without packing
 	HandlesToHandleMap<1> m_matSetGPUMap;
 
 	HandlesToHandleMap<1> m_IndexGPUMap;
@@ -0,0 +1,128 @@
+#ifndef __PYENGINE_2_0_VERTEX_PACKING__
+#define __PYENGINE_2_0_VERTEX_PACKING__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <math.h>
+#include <string.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+// gl path binds vertex data through fixed function pointers (glTexCoordPointer..) that can't
+// read normalized or half float data, so packed formats are d3d only for now
+#define PE_HAS_PACKED_VERTEX_FORMATS (PE_PACKED_VERTEX_FORMATS && (APIABSTRACTION_D3D9 || APIABSTRACTION_D3D11))
+
+namespace PE {
+
+// Helpers to build packed vertex buffers. Each function returns one 32 bit word of vertex data,
+// first component in low bits (little endian, matches d3d vertex element layout).
+// Decoding is done by vertex fetch (normalized formats) and vertexpackinghelper.fx (octahedral)
+struct VertexPacking
+{
+	static PrimitiveTypes::UInt16 floatToHalf(PrimitiveTypes::Float32 f)
+	{
+		PrimitiveTypes::UInt32 bits;
+		memcpy(&bits, &f, 4);
+
+		PrimitiveTypes::UInt32 sign = (bits >> 16) & 0x8000;
+		PrimitiveTypes::Int32 exp = (PrimitiveTypes::Int32)((bits >> 23) & 0xff) - 127 + 15;
+		PrimitiveTypes::UInt32 mantissa = bits & 0x007fffff;
+
+		if (exp <= 0)
+			return (PrimitiveTypes::UInt16)sign; // too small for half normals, flush to 0
+		if (exp >= 31)
+			return (PrimitiveTypes::UInt16)(sign | 0x7bff); // clamp to max half, we dont need inf/nan in vertex data
+
+		// round to nearest
+		mantissa += 0x00001000;
+		if (mantissa & 0x00800000)
+		{
+			mantissa = 0;
+			++exp;
+			if (exp >= 31)
+				return (PrimitiveTypes::UInt16)(sign | 0x7bff);
+		}
+		return (PrimitiveTypes::UInt16)(sign | (exp << 10) | (mantissa >> 13));
+	}
+
+	static PrimitiveTypes::UInt32 packHalf2(PrimitiveTypes::Float32 x, PrimitiveTypes::Float32 y)
+	{
+		return (PrimitiveTypes::UInt32)floatToHalf(x) | ((PrimitiveTypes::UInt32)floatToHalf(y) << 16);
+	}
+
+	static PrimitiveTypes::UInt16 floatToSNorm16(PrimitiveTypes::Float32 f)
+	{
+		if (f > 1.0f) f = 1.0f;
+		if (f < -1.0f) f = -1.0f;
+		PrimitiveTypes::Int32 i = (PrimitiveTypes::Int32)floorf(f * 32767.0f + 0.5f);
+		return (PrimitiveTypes::UInt16)(PrimitiveTypes::Int16)i;
+	}
+
+	// octahedral encoding of unit vector: project onto octahedron |x|+|y|+|z| = 1 and fold lower hemisphere over
+	static PrimitiveTypes::UInt32 packOctahedralSNorm16(PrimitiveTypes::Float32 x, PrimitiveTypes::Float32 y, PrimitiveTypes::Float32 z)
+	{
+		PrimitiveTypes::Float32 l1 = fabsf(x) + fabsf(y) + fabsf(z);
+		if (l1 < 1e-20f)
+			return packSNorm16x2(0.0f, 0.0f); // decodes to (0, 0, 1)
+
+		PrimitiveTypes::Float32 u = x / l1, v = y / l1;
+		if (z < 0.0f)
+		{
+			PrimitiveTypes::Float32 fu = (1.0f - fabsf(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+			PrimitiveTypes::Float32 fv = (1.0f - fabsf(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+			u = fu; v = fv;
+		}
+		return packSNorm16x2(u, v);
+	}
+
+	static PrimitiveTypes::UInt32 packSNorm16x2(PrimitiveTypes::Float32 x, PrimitiveTypes::Float32 y)
+	{
+		return (PrimitiveTypes::UInt32)floatToSNorm16(x) | ((PrimitiveTypes::UInt32)floatToSNorm16(y) << 16);
+	}
+
+	static PrimitiveTypes::UInt32 packUNorm8x4(const unsigned char v[4])
+	{
+		return (PrimitiveTypes::UInt32)v[0] | ((PrimitiveTypes::UInt32)v[1] << 8) | ((PrimitiveTypes::UInt32)v[2] << 16) | ((PrimitiveTypes::UInt32)v[3] << 24);
+	}
+
+	// quantizes weights to 8 bits so that they still add up to exactly 255 (the error goes to the biggest weight)
+	static void quantizeWeights(const PrimitiveTypes::Float32 *weights, PrimitiveTypes::UInt32 numWeights, unsigned char *out)
+	{
+		PrimitiveTypes::Float32 sum = 0;
+		for (PrimitiveTypes::UInt32 i = 0; i < numWeights; ++i)
+			sum += weights[i] > 0.0f ? weights[i] : 0.0f;
+
+		PrimitiveTypes::Int32 total = 0;
+		PrimitiveTypes::UInt32 biggest = 0;
+		for (PrimitiveTypes::UInt32 i = 0; i < numWeights; ++i)
+		{
+			PrimitiveTypes::Float32 w = (sum > 0.0f && weights[i] > 0.0f) ? weights[i] / sum : 0.0f;
+			PrimitiveTypes::Int32 q = (PrimitiveTypes::Int32)floorf(w * 255.0f + 0.5f);
+			out[i] = (unsigned char)q;
+			total += q;
+			if (out[i] > out[biggest])
+				biggest = i;
+		}
+		if (sum > 0.0f)
+			out[biggest] = (unsigned char)(out[biggest] + (255 - total));
+	}
+
+	// packed vertex data is built as array of 32 bit words, positions are copied in bit exact
+	static PrimitiveTypes::UInt32 asUInt(PrimitiveTypes::Float32 f)
+	{
+		PrimitiveTypes::UInt32 word;
+		memcpy(&word, &f, 4);
+		return word;
+	}
+};
+
+}; // namespace PE
+
+#endif
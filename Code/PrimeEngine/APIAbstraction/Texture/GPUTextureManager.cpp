@@ -5,6 +5,32 @@ namespace PE {
 Handle GPUTextureManager::s_myHandle;
 Handle GPUTextureManager::s_randomTexture;
 
+void GPUTextureManager::addToResidency(Handle hTexture)
+{
+	TextureResidencyManager *pTRM = TextureResidencyManager::Instance();
+	TextureGPU *pTex = hTexture.getObject<TextureGPU>();
+	if (pTex->m_streamed)
+		pTRM->addStreamedTexture(hTexture);
+	else
+		pTRM->addStaticTextureBytes(pTex->m_residentBytes);
+}
+
+bool GPUTextureManager::reloadTexture_needsRC(const char *textureFilename, const char *package)
+{
+	char path[256];
+	StringOps::concat(textureFilename, package, path, 256);
+
+	Handle hTex = m_map.findHandle(path);
+	if (!hTex.isValid())
+		return false; // not loaded yet, will be read on first use
+
+	TextureResidencyManager *pTRM = TextureResidencyManager::Instance();
+	pTRM->removeTexture(hTex);
+	bool reloaded = hTex.getObject<TextureGPU>()->reloadFromFile_needsRC(package);
+	addToResidency(hTex);
+	return reloaded;
+}
+
 Handle GPUTextureManager::createColorTextureGPU(const PrimitiveTypes::String textureFilename, const char *package, ESamplerState samplerState/* = SamplerState_Count*/)
 {
 	char path[256];
@@ -18,6 +44,7 @@ Handle GPUTextureManager::createColorTextureGPU(const PrimitiveTypes::String tex
 	TextureGPU *pTex = new(res) TextureGPU(*m_pContext, m_arena);
 
 	pTex->createColorTextureGPU(textureFilename, package, samplerState);
+	addToResidency(res);
 
 	m_map.add(path, res);
 	return res;
@@ -36,6 +63,7 @@ Handle GPUTextureManager::createBumpTextureGPU(const PrimitiveTypes::String text
 	TextureGPU *pTex = new(res) TextureGPU(*m_pContext, m_arena);
 
 	pTex->createBumpTextureGPU(textureFilename, package);
+	addToResidency(res);
 	
 	m_map.add(path, res);
 	return res;
@@ -54,6 +82,7 @@ Handle GPUTextureManager::createSpecularTextureGPU(const PrimitiveTypes::String
 	TextureGPU *pTex = new(res) TextureGPU(*m_pContext, m_arena);
 
 	pTex->createSpecularTextureGPU(textureFilename, package);
+	addToResidency(res);
 
 	m_map.add(path, res);
 	return res;
@@ -72,6 +101,7 @@ Handle GPUTextureManager::createGlowTextureGPU(const PrimitiveTypes::String text
 	TextureGPU *pTex = new(res) TextureGPU(*m_pContext, m_arena);
 
 	pTex->createGlowTextureGPU(textureFilename, package);
+	addToResidency(res);
 	
 	m_map.add(path, res);
 	return res;
@@ -19,6 +19,7 @@
 #endif
 // Sibling/Children includes
 #include "Texture.h"
+#include "TextureResidencyManager.h"
 
 namespace PE {
 
@@ -58,6 +59,10 @@ struct GPUTextureManager : PE::PEAllocatableAndDefragmentable
 
 	Handle createGlowTextureGPU(const PrimitiveTypes::String textureFilename, const char *package);
 	
+	// hot reload: loads texture file again into the same TextureGPU, so handles to it stay valid.
+	// false if texture was not loaded. needs render context
+	bool reloadTexture_needsRC(const char *textureFilename, const char *package);
+
 	static void buildRandomTexture(PE::GameContext &context, PE::MemoryArena arena)
 	{
 		s_randomTexture = Handle("TEXTURE_GPU", sizeof(TextureGPU));
@@ -70,6 +75,10 @@ struct GPUTextureManager : PE::PEAllocatableAndDefragmentable
 
 	StrToHandleMap m_map;
 	PE::MemoryArena m_arena; PE::GameContext *m_pContext;
+
+private:
+	// lets residency manager know about memory newly created texture uses
+	void addToResidency(Handle hTexture);
 };
 
 };// namespace PE
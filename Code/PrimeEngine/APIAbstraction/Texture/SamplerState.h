@@ -10,6 +10,8 @@
 #include "PrimeEngine/Render/D3D11Renderer.h"
 #include "PrimeEngine/Render/D3D9Renderer.h"
 #include "PrimeEngine/Render/GLRenderer.h"
+#include "PrimeEngine/Utils/PEClassDecl.h"
+#include "PrimeEngine/Game/Common/GameContext.h"
 
 // Sibling/Children includes
 
@@ -65,6 +67,12 @@ namespace PE {
 
 		bool needsMipMaps() { return val_GL_TEXTURE_MIN_FILTER != GL_LINEAR && val_GL_TEXTURE_MIN_FILTER != GL_NEAREST; }
 	};
+#elif APIABSTRACTION_HEADLESS
+	// no gpu. keeps sampler state tables valid for code shared with other platforms
+	struct SamplerState
+	{
+		bool needsMipMaps() { return false; }
+	};
 #elif PE_PLAT_IS_PS4
 	
 #elif PE_PLAT_IS_PSVITA
@@ -7,6 +7,7 @@
 #include "Texture.h"
 
 #include "Texture_DDS_Loader_GL.h"
+#include "TextureResidencyManager.h"
 
 // Inter-Engine includes
 #include "../../Utils/ErrorHandling.h"
@@ -52,12 +53,56 @@ void TextureGPU::createTextureNoFamily(const char *textureFilename, const char *
 	HRESULT hr = pDevice->CreateShaderResourceView(m_pTexture, NULL, &m_pShaderResourceView);
 	PEASSERT(SUCCEEDED(hr), "Creating shader resource view");
 #elif APIABSTRACTION_OGL
+#	if PE_TEXTURE_STREAMING
+	// textures that can be streamed start with low mips only. TextureResidencyManager brings in the rest on demand
+	if (gfxCreateStreamedDDSTexture(PEString::s_buf))
+		return;
+#	endif
 	m_texture = gfxLoadDDSTexture(PEString::s_buf);
 #elif PE_PLAT_IS_PSVITA
 	m_texture = gfxLoadDDSTexture(PEString::s_buf);
+#elif APIABSTRACTION_HEADLESS
+	// nothing is loaded, size from dds header is tracked for memory report and budget
+	DDS::DDSMipLayout layout;
+	if (DDS::readDDSMipLayout(PEString::s_buf, &layout))
+	{
+		for (PrimitiveTypes::UInt32 i = 0; i < layout.mips; ++i)
+			m_residentBytes += layout.mipSizes[i] * layout.surfaces;
+	}
 #	endif
 }
 
+bool TextureGPU::reloadFromFile_needsRC(const char *package)
+{
+	if (m_family != TextureFamily::COLOR_MAP && m_family != TextureFamily::NORMAL_MAP &&
+		m_family != TextureFamily::SPECULAR_MAP && m_family != TextureFamily::GLOW_MAP)
+		return false;
+
+#if APIABSTRACTION_D3D9
+	if (m_pTexture)
+		m_pTexture->Release();
+	m_pTexture = NULL;
+#elif APIABSTRACTION_D3D11
+	if (m_pShaderResourceView)
+		m_pShaderResourceView->Release();
+	if (m_pTexture)
+		m_pTexture->Release();
+	m_pShaderResourceView = NULL;
+	m_pTexture = NULL;
+#elif APIABSTRACTION_OGL
+	glDeleteTextures(1, &m_texture);
+	m_texture = 0;
+#endif
+
+	// m_name is overwritten with the same name
+	char filename[256];
+	StringOps::writeToString(m_name, filename, 256);
+	m_streamed = false;
+	m_residentBytes = 0;
+	createTextureNoFamily(filename, package);
+	return true;
+}
+
 void TextureGPU::createColorTextureGPU(const char* textureFilename, const char *package, ESamplerState samplerState /*= = SamplerState_Count*/)
 {
 	//default
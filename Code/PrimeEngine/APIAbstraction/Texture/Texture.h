@@ -34,6 +34,13 @@ struct TextureGPU : PE::PEAllocatableAndDefragmentable
 #if APIABSTRACTION_OGL
 	GLuint gfxLoadDDSTexture(char *filename, bool genMips = true);
 	GLuint gfxLoadDDSTextureCubeMap(char *filename);
+
+	// texture streaming (see TextureResidencyManager). creates texture with only low mips resident.
+	// returns false if the file can't be streamed, in which case it has to be loaded with gfxLoadDDSTexture()
+	bool gfxCreateStreamedDDSTexture(char *filename);
+	// next more detailed mip. both need render context. return amount of bytes uploaded/freed
+	PrimitiveTypes::UInt32 gfxStreamInMip();
+	PrimitiveTypes::UInt32 gfxEvictMip();
 #elif APIABSTRACTION_D3D9
 	IDirect3DTexture9 *gfxLoadDDSTexture(char *filename, bool genMips = true);
 #elif APIABSTRACTION_D3D11
@@ -47,6 +54,8 @@ struct TextureGPU : PE::PEAllocatableAndDefragmentable
 		m_arena = arena; m_pContext = &context;
 		m_samplerState = SamplerState_INVALID;
 		StringOps::writeToString("no name", m_name, 256);
+		m_streamed = false;
+		m_residentBytes = 0;
 	}
 	
 	void createTextureNoFamily(const char* textureFilename, const char *package = NULL);
@@ -67,6 +76,10 @@ struct TextureGPU : PE::PEAllocatableAndDefragmentable
 
 	void createColorCubeTextureGPU(const char *textureFilename, const char *package = NULL);
 
+	// hot reload: releases api texture and loads file m_name again, with same family and sampler state. only textures
+	// created from one file (color, normal, specular, glow maps). false for others. needs render context
+	bool reloadFromFile_needsRC(const char *package);
+
 	// not implemented for DX9
 	void createColorTextureArrayGPU(const PrimitiveTypes::String textureFilenames[], PrimitiveTypes::UInt32 nTextures, const char *package = NULL);
 
@@ -119,6 +132,17 @@ struct TextureGPU : PE::PEAllocatableAndDefragmentable
 	Viewport m_viewport;
 #endif
 
+	// streaming state. only valid if m_streamed (except m_residentBytes which is set for all dds textures)
+	bool m_streamed;
+	DDS::DDSMipLayout m_mipLayout;
+	PrimitiveTypes::UInt32 m_minMip; // most detailed mip we can ever have (limited by MAX_TEXTURE_LOAD_WIDTH)
+	PrimitiveTypes::UInt32 m_initialMip; // mips at or below this detail are loaded on creation and never evicted
+	PrimitiveTypes::UInt32 m_residentMip; // most detailed mip currently on gpu
+	PrimitiveTypes::UInt32 m_requestedMip; // most detailed mip requested during draw gathering
+	PrimitiveTypes::UInt32 m_lastRequestFrame;
+	PrimitiveTypes::UInt32 m_residentBytes;
+	char m_streamingPath[256];
+
 	PE::MemoryArena m_arena; PE::GameContext *m_pContext;
 	char m_name[256];
 };
@@ -0,0 +1,188 @@
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Utils/ErrorHandling.h"
+
+// Sibling/Children includes
+#include "TextureResidencyManager.h"
+#include "Texture.h"
+
+namespace PE {
+
+Handle TextureResidencyManager::s_myHandle;
+
+TextureResidencyManager::TextureResidencyManager(PE::GameContext &context, PE::MemoryArena arena)
+	: m_budgetBytes(PE_TEXTURE_STREAMING_BUDGET_MB * 1024 * 1024)
+	, m_uploadBytesPerFrame(PE_TEXTURE_STREAMING_UPLOAD_KB_PER_FRAME * 1024)
+	, m_streamedResidentBytes(0)
+	, m_staticBytes(0)
+	, m_numPendingRequests(0)
+	, m_numMipsStreamedIn(0)
+	, m_numMipsEvicted(0)
+	, m_streamedTextures(context, arena, 256)
+	, m_frame(1)
+	, m_pStagingBuffer(NULL)
+	, m_stagingBufferSize(0)
+{
+	m_arena = arena; m_pContext = &context;
+}
+
+void TextureResidencyManager::addStreamedTexture(Handle hTexture)
+{
+	TextureGPU *pTex = hTexture.getObject<TextureGPU>();
+	PEASSERT(pTex->m_streamed, "Only streamed textures are tracked per texture");
+
+	m_streamedTextures.add(hTexture);
+	m_streamedResidentBytes += pTex->m_residentBytes;
+}
+
+void TextureResidencyManager::removeTexture(Handle hTexture)
+{
+	TextureGPU *pTex = hTexture.getObject<TextureGPU>();
+	if (!pTex->m_streamed)
+	{
+		m_staticBytes -= pTex->m_residentBytes < m_staticBytes ? pTex->m_residentBytes : m_staticBytes;
+		return;
+	}
+
+	PrimitiveTypes::UInt32 index = m_streamedTextures.indexOf(hTexture);
+	if (index == PrimitiveTypes::Constants::c_MaxUInt32)
+		return;
+	m_streamedTextures.remove(index);
+	m_streamedResidentBytes -= pTex->m_residentBytes < m_streamedResidentBytes ? pTex->m_residentBytes : m_streamedResidentBytes;
+}
+
+void TextureResidencyManager::requestMip(TextureGPU *pTex, PrimitiveTypes::UInt32 mip)
+{
+	if (!pTex->m_streamed)
+		return;
+
+	if (mip < pTex->m_minMip)
+		mip = pTex->m_minMip;
+
+	if (pTex->m_lastRequestFrame != m_frame || mip < pTex->m_requestedMip)
+		pTex->m_requestedMip = mip;
+
+	pTex->m_lastRequestFrame = m_frame;
+}
+
+void TextureResidencyManager::requestForScreenSize(TextureGPU *pTex, PrimitiveTypes::Float32 screenPixels)
+{
+	if (!pTex->m_streamed)
+		return;
+
+	// want about one texel per pixel: mip n is 2^n times smaller than mip 0
+	PrimitiveTypes::UInt32 size = pTex->m_mipLayout.width > pTex->m_mipLayout.height ? pTex->m_mipLayout.width : pTex->m_mipLayout.height;
+	PrimitiveTypes::UInt32 mip = 0;
+	if (screenPixels < 1.0f)
+		screenPixels = 1.0f;
+	while (mip + 1 < pTex->m_mipLayout.mips && (PrimitiveTypes::Float32)(size >> (mip + 1)) >= screenPixels)
+		++mip;
+
+	requestMip(pTex, mip);
+}
+
+bool TextureResidencyManager::makeRoom(PrimitiveTypes::UInt32 bytesNeeded)
+{
+	while (m_streamedResidentBytes + m_staticBytes + bytesNeeded > m_budgetBytes)
+	{
+		// least recently requested texture that has something above its initial mips.
+		// textures requested this frame are only candidates if they have more than they asked for
+		TextureGPU *pVictim = NULL;
+		for (PrimitiveTypes::UInt32 i = 0; i < m_streamedTextures.m_size; ++i)
+		{
+			TextureGPU *pTex = m_streamedTextures[i].getObject<TextureGPU>();
+			if (pTex->m_residentMip >= pTex->m_initialMip)
+				continue;
+			if (pTex->m_lastRequestFrame == m_frame && pTex->m_residentMip >= pTex->m_requestedMip)
+				continue;
+			if (!pVictim || pTex->m_lastRequestFrame < pVictim->m_lastRequestFrame)
+				pVictim = pTex;
+		}
+
+		if (!pVictim)
+			return false;
+
+#if APIABSTRACTION_OGL
+		PrimitiveTypes::UInt32 freed = pVictim->gfxEvictMip();
+		m_streamedResidentBytes -= freed;
+		++m_numMipsEvicted;
+#else
+		return false;
+#endif
+	}
+	return true;
+}
+
+void TextureResidencyManager::update(int &threadOwnershipMask)
+{
+	PEASSERT(threadOwnershipMask & Threading::RenderContext, "Texture streaming uploads need render context");
+
+	PrimitiveTypes::UInt32 uploaded = 0;
+	m_numPendingRequests = 0;
+
+	for (PrimitiveTypes::UInt32 i = 0; i < m_streamedTextures.m_size; ++i)
+	{
+		TextureGPU *pTex = m_streamedTextures[i].getObject<TextureGPU>();
+		if (pTex->m_lastRequestFrame != m_frame)
+			continue;
+
+		// one mip at a time, from small to large, so that texture is usable after each step
+		while (pTex->m_requestedMip < pTex->m_residentMip)
+		{
+			PrimitiveTypes::UInt32 bytes = pTex->m_mipLayout.mipSizes[pTex->m_residentMip - 1];
+			if ((uploaded && uploaded + bytes > m_uploadBytesPerFrame) || !makeRoom(bytes))
+			{
+				++m_numPendingRequests;
+				break;
+			}
+#if APIABSTRACTION_OGL
+			bytes = pTex->gfxStreamInMip();
+#endif
+			if (!bytes)
+				break; // failed to read file
+			m_streamedResidentBytes += bytes;
+			uploaded += bytes;
+			++m_numMipsStreamedIn;
+		}
+	}
+
+	// budget might have changed or static textures got added
+	makeRoom(0);
+
+	++m_frame;
+}
+
+void TextureResidencyManager::memoryReport(char *dest, PrimitiveTypes::UInt32 &size, PrimitiveTypes::UInt32 capacity)
+{
+	// section is well under 256 characters
+	if (size + 256 >= capacity)
+		return;
+
+	int written = sprintf(dest + size, ",'textures':{'resident':%u,'static':%u,'budget':%u,'pending':%u,'streamed':%u,'in':%u,'evicted':%u}",
+		(unsigned int)(m_streamedResidentBytes + m_staticBytes), (unsigned int)(m_staticBytes), (unsigned int)(m_budgetBytes),
+		(unsigned int)(m_numPendingRequests), (unsigned int)(m_streamedTextures.m_size),
+		(unsigned int)(m_numMipsStreamedIn), (unsigned int)(m_numMipsEvicted));
+
+	size += written;
+}
+
+unsigned char *TextureResidencyManager::getStagingBuffer(PrimitiveTypes::UInt32 size)
+{
+	if (size > m_stagingBufferSize)
+	{
+		free(m_pStagingBuffer);
+		m_pStagingBuffer = (unsigned char *)malloc(size);
+		PEASSERT(m_pStagingBuffer, "ERROR: failed to malloc %d bytes", size);
+		m_stagingBufferSize = size;
+	}
+	return m_pStagingBuffer;
+}
+
+}; // namespace PE
@@ -0,0 +1,94 @@
+#ifndef __PYENGINE_2_0_TEXTURE_RESIDENCY_MANAGER__
+#define __PYENGINE_2_0_TEXTURE_RESIDENCY_MANAGER__
+
+#define NOMINMAX
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+struct TextureGPU;
+
+// Keeps track of how much texture memory is on gpu and streams mips of 2d color/normal/spec/glow maps.
+// Streamed textures start with only low mips (PE_TEXTURE_STREAMING_INITIAL_MIP_SIZE) resident.
+// During draw gathering meshes request the mip they need based on their on-screen size (requestMip()).
+// update() is called once a frame while holding render context: it uploads requested mips within a per frame
+// upload limit and evicts least recently requested mips while over budget.
+struct TextureResidencyManager : PE::PEAllocatableAndDefragmentable
+{
+	TextureResidencyManager(PE::GameContext &context, PE::MemoryArena arena);
+
+	static void Construct(PE::GameContext &context, PE::MemoryArena arena)
+	{
+		s_myHandle = Handle("TEXTURE_RESIDENCY_MANAGER", sizeof(TextureResidencyManager));
+		/* TextureResidencyManager *pTRM = */ new(s_myHandle) TextureResidencyManager(context, arena);
+	}
+
+	static TextureResidencyManager *Instance()
+	{
+		return s_myHandle.isValid() ? s_myHandle.getObject<TextureResidencyManager>() : NULL;
+	}
+
+	// called by texture after it was created with only low mips resident
+	void addStreamedTexture(Handle hTexture);
+	// for textures that are always fully resident (render targets excluded)
+	void addStaticTextureBytes(PrimitiveTypes::UInt32 bytes) { m_staticBytes += bytes; }
+
+	// texture memory is about to be released (hot reload). forgets streamed texture and its resident bytes
+	void removeTexture(Handle hTexture);
+
+	// request mip for this frame. will keep the most detailed of all requests in the frame
+	void requestMip(TextureGPU *pTex, PrimitiveTypes::UInt32 mip);
+
+	// request mip needed for a texture covering screenPixels pixels on screen
+	void requestForScreenSize(TextureGPU *pTex, PrimitiveTypes::Float32 screenPixels);
+
+	// needs render context
+	void update(int &threadOwnershipMask);
+
+	// appends ,'textures':{...} to a memory report dictionary string
+	void memoryReport(char *dest, PrimitiveTypes::UInt32 &size, PrimitiveTypes::UInt32 capacity);
+
+	// grow-only buffer mips are read into before upload
+	unsigned char *getStagingBuffer(PrimitiveTypes::UInt32 size);
+
+	PrimitiveTypes::UInt32 getResidentBytes() { return m_streamedResidentBytes + m_staticBytes; }
+
+	PrimitiveTypes::UInt32 m_budgetBytes;
+	PrimitiveTypes::UInt32 m_uploadBytesPerFrame;
+
+	PrimitiveTypes::UInt32 m_streamedResidentBytes;
+	PrimitiveTypes::UInt32 m_staticBytes;
+	PrimitiveTypes::UInt32 m_numPendingRequests; // mip uploads that did not fit into last update
+	PrimitiveTypes::UInt32 m_numMipsStreamedIn;
+	PrimitiveTypes::UInt32 m_numMipsEvicted;
+
+	static Handle s_myHandle;
+
+private:
+	// evicts least recently requested mips until bytesNeeded fit into budget. false if could not make enough room
+	bool makeRoom(PrimitiveTypes::UInt32 bytesNeeded);
+
+	Array<Handle, 1> m_streamedTextures;
+	PrimitiveTypes::UInt32 m_frame;
+
+	unsigned char *m_pStagingBuffer;
+	PrimitiveTypes::UInt32 m_stagingBufferSize;
+
+	PE::MemoryArena m_arena; PE::GameContext *m_pContext;
+};
+
+}; // namespace PE
+
+#endif
@@ -392,5 +392,91 @@ bool loadDDSIntoSystemMemory(char *filename, DDS::DDSTextureInSystemMemory* dds)
 	return true;
 }
 
+bool readDDSMipLayout(char *filename, DDS::DDSMipLayout *layout)
+{
+	FILE *fp = fopen(filename, "rb");
+	if (!fp)
+	{
+		PEINFO("ERROR: failed to open %s", filename);
+		return false;
+	}
+
+	char marker[4];
+	DDS::DDSFileHeader ddsh;
+	bool read = fread(marker, 1, 4, fp) == 4 && fread(&ddsh, 1, sizeof(ddsh), fp) == sizeof(ddsh);
+	fclose(fp);
+
+	if (!read || strncmp(marker, "DDS ", 4) != 0)
+	{
+		printf("ERROR: %s is not a dds file", filename);
+		return false;
+	}
+
+#if APIABSTRACTION_PS3
+	uint32_t* t = (uint32_t*)&ddsh;
+	for(unsigned int ddsCounterHeader=0; ddsCounterHeader<sizeof(DDS::DDSFileHeader)/4; ddsCounterHeader++)
+	{
+		swapEndian(t+ddsCounterHeader);
+	}
+#endif
+
+	if ((ddsh.dwCaps2 & DDSF_VOLUME) && (ddsh.dwDepth > 0))
+	{
+		printf("ERROR: %s is a volume texture ",filename);
+		return false;
+	}
+
+	if (!DDS::decodeDDSFormat(&ddsh, &layout->compressedFormat, &layout->uncompressedFormat, &layout->components))
+		return false;
+
+	layout->width = ddsh.dwWidth;
+	layout->height = ddsh.dwHeight;
+	layout->mips = ddsh.dwMipMapCount ? ddsh.dwMipMapCount : 1;
+	if (layout->mips > DDSF_MAX_MIPMAPS)
+		layout->mips = DDSF_MAX_MIPMAPS;
+	layout->surfaces = (ddsh.dwCaps2 & DDSF_CUBEMAP) ? 6 : 1;
+
+	uint32_t offset = 4 + sizeof(DDS::DDSFileHeader);
+	for (uint32_t j = 0; j < layout->mips; j++)
+	{
+		layout->mipOffsets[j] = offset;
+		layout->mipSizes[j] = DDS::getImageSize(layout->mipWidth(j), layout->mipHeight(j), layout->components, layout->compressedFormat, layout->uncompressedFormat);
+		offset += layout->mipSizes[j];
+	}
+
+	return true;
+}
+
+uint32_t getLoadedDDSByteSize(const DDS::DDSTextureInSystemMemory &dds)
+{
+	uint32_t size = 0;
+	for (uint32_t j = 0; j < dds.mips; j++)
+	{
+		uint32_t w = dds.width >> j, h = dds.height >> j;
+		size += DDS::getImageSize(w ? w : 1, h ? h : 1, dds.components, dds.compressedFormat, dds.uncompressedFormat);
+	}
+	return size * dds.surfaces;
+}
+
+bool readDDSMipRange(char *filename, const DDS::DDSMipLayout &layout, uint32_t firstMip, uint32_t lastMip, unsigned char *dest)
+{
+	PEASSERT(firstMip <= lastMip && lastMip < layout.mips, "Invalid mip range %d-%d for %s", firstMip, lastMip, filename);
+
+	FILE *fp = fopen(filename, "rb");
+	if (!fp)
+	{
+		PEINFO("ERROR: failed to open %s", filename);
+		return false;
+	}
+
+	uint32_t size = layout.mipOffsets[lastMip] + layout.mipSizes[lastMip] - layout.mipOffsets[firstMip];
+	bool read = fseek(fp, layout.mipOffsets[firstMip], SEEK_SET) == 0 && fread(dest, 1, size, fp) == size;
+	fclose(fp);
+
+	if (!read)
+		PEINFO("ERROR: failed to read mips %d-%d of %s", firstMip, lastMip, filename);
+	return read;
+}
+
 }; // DDS
 }; // namespace PE
@@ -142,6 +142,24 @@ namespace DDS
 		_DDS_IMAGE image[6];
 	};
 
+	// where each mip of a flat dds lives in the file. used by texture streaming to read mips one at a time
+	// instead of loading the whole file
+	struct DDSMipLayout
+	{
+		uint32_t			compressedFormat;
+		uint32_t			uncompressedFormat;
+		uint32_t			components;
+		uint32_t			width;
+		uint32_t			height;
+		uint32_t			mips;
+		uint32_t			surfaces;
+		uint32_t			mipOffsets[DDSF_MAX_MIPMAPS]; // from start of file
+		uint32_t			mipSizes[DDSF_MAX_MIPMAPS];
+
+		uint32_t mipWidth(uint32_t mip) const { uint32_t w = width >> mip; return w ? w : 1; }
+		uint32_t mipHeight(uint32_t mip) const { uint32_t h = height >> mip; return h ? h : 1; }
+	};
+
 	//-----------------------------------------------------------------------------
 	// bool DDSFormatToApiFormat(DDS_HEADER *ddsh, uint32_t * compressedFormat, uint32_t * uncompressedFormat, uint32_t *components)
 	// Description: 
@@ -187,6 +205,32 @@ namespace DDS
 	//-----------------------------------------------------------------------------
 	bool loadDDSIntoSystemMemory(char *filename, DDS::DDSTextureInSystemMemory* dds);
 
+	//-----------------------------------------------------------------------------
+	// bool readDDSMipLayout(char *filename, DDSMipLayout *layout)
+	// Description: 
+	// reads only the dds header and computes file offsets and sizes of each mip
+	// Returns: 
+	// false on failure
+	//-----------------------------------------------------------------------------
+	bool readDDSMipLayout(char *filename, DDS::DDSMipLayout *layout);
+
+	//-----------------------------------------------------------------------------
+	// uint32_t getLoadedDDSByteSize(const DDSTextureInSystemMemory &dds)
+	// Description: 
+	// texel bytes of all mips and surfaces of a dds loaded by loadDDSIntoSystemMemory
+	//-----------------------------------------------------------------------------
+	uint32_t getLoadedDDSByteSize(const DDS::DDSTextureInSystemMemory &dds);
+
+	//-----------------------------------------------------------------------------
+	// bool readDDSMipRange(char *filename, const DDSMipLayout &layout, uint32_t firstMip, uint32_t lastMip, unsigned char *dest)
+	// Description: 
+	// reads mips [firstMip, lastMip] of the first surface into dest. mips are stored
+	// from largest to smallest so the range is one contiguous read
+	// Returns: 
+	// false on failure
+	//-----------------------------------------------------------------------------
+	bool readDDSMipRange(char *filename, const DDS::DDSMipLayout &layout, uint32_t firstMip, uint32_t lastMip, unsigned char *dest);
+
 }; // namespace DDS
 
 }; // namespace PE
@@ -27,6 +27,8 @@ TextureGPU::gfxLoadDDSTexture(char *filename, bool genMips /*= true*/)
 		printf("failed to load\n");
 		exit(0);
 	}
+	// fully resident. only the size is tracked for memory report and budget
+	m_residentBytes = DDS::getLoadedDDSByteSize(dds);
 	
 	bool haveMips = dds.mips > 1;
 	bool needToGenerateMips = !haveMips && genMips;
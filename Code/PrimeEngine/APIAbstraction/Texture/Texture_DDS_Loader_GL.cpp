@@ -14,6 +14,7 @@
 // Inter-Engine includes
 #include "../../Utils/ErrorHandling.h"
 #include "PrimeEngine/FileSystem/FileReader.h"
+#include "TextureResidencyManager.h"
 
 namespace PE {
 
@@ -28,6 +29,8 @@ GLuint TextureGPU::gfxLoadDDSTexture(char *filename, bool genMips /*= true*/)
 		printf("failed to load\n");
 		exit(0);
 	}
+	// fully resident. only the size is tracked for memory report and budget
+	m_residentBytes = DDS::getLoadedDDSByteSize(dds);
 
 	glGenTextures(1, &texture);
 	glBindTexture(GL_TEXTURE_2D, texture);
@@ -418,6 +421,144 @@ GLuint TextureGPU::gfxLoadDDSTextureCubeMap(char *filename)
 }
 //----------------------------------------------------------------------------
 
+#if APIABSTRACTION_GLPC
+// formats for the uncompressed layouts we can stream. mirrors what gfxLoadDDSTexture() picks
+static bool getStreamingGLFormats(const DDS::DDSMipLayout &layout, GLenum &destApiFormat, GLenum &sourceCpuFormatEnum)
+{
+	if (layout.compressedFormat || layout.surfaces != 1)
+		return false;
+
+	if (layout.components == 1 && layout.uncompressedFormat == DDSF_L)
+	{
+		destApiFormat = sourceCpuFormatEnum = GL_LUMINANCE;
+		return true;
+	}
+	if (layout.components == 4 && (layout.uncompressedFormat == DDSF_RGBA || layout.uncompressedFormat == DDSF_RGB))
+	{
+		destApiFormat = GL_RGBA;
+		sourceCpuFormatEnum = GL_BGRA;
+		return true;
+	}
+	return false;
+}
+
+static void uploadStreamedMip(const DDS::DDSMipLayout &layout, PrimitiveTypes::UInt32 mip, GLenum destApiFormat, GLenum sourceCpuFormatEnum, const unsigned char *pixels)
+{
+	if (sourceCpuFormatEnum == GL_LUMINANCE) glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, mip, destApiFormat, layout.mipWidth(mip), layout.mipHeight(mip), 0, sourceCpuFormatEnum, GL_UNSIGNED_BYTE, pixels);
+	if (sourceCpuFormatEnum == GL_LUMINANCE) glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+#endif
+
+bool TextureGPU::gfxCreateStreamedDDSTexture(char *filename)
+{
+#if APIABSTRACTION_GLPC && PE_TEXTURE_STREAMING
+	TextureResidencyManager *pTRM = TextureResidencyManager::Instance();
+	if (!pTRM)
+		return false;
+
+	DDS::DDSMipLayout &layout = m_mipLayout;
+	GLenum destApiFormat, sourceCpuFormatEnum;
+	if (!DDS::readDDSMipLayout(filename, &layout) || layout.mips < 2 || !getStreamingGLFormats(layout, destApiFormat, sourceCpuFormatEnum))
+		return false; // single mip textures need gluBuild2DMipmaps and compressed/cube textures go through regular path
+
+	// gl level index == mip index in file, so mips bigger than max size just never become resident
+	m_minMip = 0;
+	while (m_minMip + 1 < layout.mips && (layout.mipWidth(m_minMip) > MAX_TEXTURE_LOAD_WIDTH || layout.mipHeight(m_minMip) > MAX_TEXTURE_LOAD_WIDTH))
+		++m_minMip;
+
+	m_initialMip = m_minMip;
+	while (m_initialMip + 1 < layout.mips && (layout.mipWidth(m_initialMip) > PE_TEXTURE_STREAMING_INITIAL_MIP_SIZE || layout.mipHeight(m_initialMip) > PE_TEXTURE_STREAMING_INITIAL_MIP_SIZE))
+		++m_initialMip;
+
+	PrimitiveTypes::UInt32 lastMip = layout.mips - 1;
+	PrimitiveTypes::UInt32 tailSize = layout.mipOffsets[lastMip] + layout.mipSizes[lastMip] - layout.mipOffsets[m_initialMip];
+	unsigned char *pStaging = pTRM->getStagingBuffer(tailSize);
+	if (!DDS::readDDSMipRange(filename, layout, m_initialMip, lastMip, pStaging))
+		return false;
+
+	glGenTextures(1, &m_texture);
+	glBindTexture(GL_TEXTURE_2D, m_texture);
+
+	m_residentBytes = 0;
+	for (PrimitiveTypes::UInt32 i = m_initialMip; i <= lastMip; i++)
+	{
+		uploadStreamedMip(layout, i, destApiFormat, sourceCpuFormatEnum, pStaging + layout.mipOffsets[i] - layout.mipOffsets[m_initialMip]);
+		m_residentBytes += layout.mipSizes[i];
+	}
+
+	// only [base, max] has to be defined for texture to be complete
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, m_initialMip);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, lastMip);
+
+	assert(m_samplerState != SamplerState_INVALID);
+	SamplerState &ss = SamplerStateManager::getInstance()->getSamplerState(m_samplerState);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, ss.val_GL_TEXTURE_MIN_FILTER);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, ss.val_GL_TEXTURE_MAG_FILTER);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, ss.val_GL_TEXTURE_WRAP_S);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, ss.val_GL_TEXTURE_WRAP_T);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	m_residentMip = m_initialMip;
+	m_requestedMip = m_initialMip;
+	m_lastRequestFrame = 0;
+	StringOps::writeToString(filename, m_streamingPath, 256);
+	m_streamed = true;
+	return true;
+#else
+	return false;
+#endif
+}
+
+PrimitiveTypes::UInt32 TextureGPU::gfxStreamInMip()
+{
+#if APIABSTRACTION_GLPC
+	PEASSERT(m_streamed && m_residentMip > m_minMip, "Nothing to stream in");
+	PrimitiveTypes::UInt32 mip = m_residentMip - 1;
+
+	GLenum destApiFormat, sourceCpuFormatEnum;
+	getStreamingGLFormats(m_mipLayout, destApiFormat, sourceCpuFormatEnum);
+
+	unsigned char *pStaging = TextureResidencyManager::Instance()->getStagingBuffer(m_mipLayout.mipSizes[mip]);
+	if (!DDS::readDDSMipRange(m_streamingPath, m_mipLayout, mip, mip, pStaging))
+		return 0;
+
+	glBindTexture(GL_TEXTURE_2D, m_texture);
+	uploadStreamedMip(m_mipLayout, mip, destApiFormat, sourceCpuFormatEnum, pStaging);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, mip);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	m_residentMip = mip;
+	m_residentBytes += m_mipLayout.mipSizes[mip];
+	return m_mipLayout.mipSizes[mip];
+#else
+	return 0;
+#endif
+}
+
+PrimitiveTypes::UInt32 TextureGPU::gfxEvictMip()
+{
+#if APIABSTRACTION_GLPC
+	PEASSERT(m_streamed && m_residentMip < m_initialMip, "Initial mips are never evicted");
+	PrimitiveTypes::UInt32 mip = m_residentMip;
+
+	GLenum destApiFormat, sourceCpuFormatEnum;
+	getStreamingGLFormats(m_mipLayout, destApiFormat, sourceCpuFormatEnum);
+
+	glBindTexture(GL_TEXTURE_2D, m_texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, mip + 1);
+	// redefine the level as empty so that driver can release its storage
+	glTexImage2D(GL_TEXTURE_2D, mip, destApiFormat, 0, 0, 0, sourceCpuFormatEnum, GL_UNSIGNED_BYTE, NULL);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	m_residentMip = mip + 1;
+	m_residentBytes -= m_mipLayout.mipSizes[mip];
+	return m_mipLayout.mipSizes[mip];
+#else
+	return 0;
+#endif
+}
 
 }; // namespace PE
 #endif
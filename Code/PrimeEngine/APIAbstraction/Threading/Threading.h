@@ -6,8 +6,20 @@
 
 #include "PrimeEngine/Utils/ErrorHandling.h"
 
+// ios and linux use pthreads. on linux (glibc) mutexes and condition variables are futex based,
+// uncontended lock/unlock doesn't enter the kernel
+#if APIABSTRACTION_IOS || PE_PLAT_IS_LINUX
+#define PE_USE_PTHREADS 1
+#else
+#define PE_USE_PTHREADS 0
+#endif
+
 #if APIABSTRACTION_IOS
 #include <pthread/pthread.h>
+#include <unistd.h>
+#elif PE_PLAT_IS_LINUX
+#include <pthread.h>
+#include <unistd.h>
 #endif
 
 #if PE_PLAT_IS_PS4
@@ -38,7 +50,7 @@ namespace Threading {
 	struct Mutex
 	{
 		int memCheck;
-#if APIABSTRACTION_IOS
+#if PE_USE_PTHREADS
 		pthread_mutex_t m_osLock;
 #elif PE_PLAT_IS_PS4
 		
@@ -52,7 +64,7 @@ namespace Threading {
 		{
 			memCheck = 0x12121212;
 			PEINFO("memCheck addr: %x", &m_osLock);
-#if  APIABSTRACTION_IOS
+#if PE_USE_PTHREADS
 			pthread_mutex_init(&m_osLock, 0);
 #elif PE_PLAT_IS_PS4
 			
@@ -65,7 +77,7 @@ namespace Threading {
 
 		~Mutex()
 		{
-#if  APIABSTRACTION_IOS
+#if PE_USE_PTHREADS
 			pthread_mutex_destroy(&m_osLock);
 #elif PE_PLAT_IS_PS4
 			
@@ -79,7 +91,7 @@ namespace Threading {
 		bool lock(ThreadId threadId = 0)
 		{
 			m_threadId = threadId;
-#if  APIABSTRACTION_IOS
+#if PE_USE_PTHREADS
 			return pthread_mutex_lock(&m_osLock) == 0;
 #elif PE_PLAT_IS_PS4
 			
@@ -93,7 +105,7 @@ namespace Threading {
 
 		void unlock()
 		{
-#if APIABSTRACTION_IOS
+#if PE_USE_PTHREADS
 			pthread_mutex_unlock(&m_osLock);
 #elif PE_PLAT_IS_PS4
 			
@@ -107,7 +119,7 @@ namespace Threading {
 
 	struct ConditionVariable
 	{
-#if  APIABSTRACTION_IOS
+#if PE_USE_PTHREADS
 		pthread_cond_t m_osCV;
 #elif PE_PLAT_IS_PS4
 		
@@ -120,7 +132,7 @@ namespace Threading {
 		ConditionVariable(Mutex &lock)
 			: m_associatedLock(lock)
 		{
-#if APIABSTRACTION_IOS
+#if PE_USE_PTHREADS
 			pthread_cond_init(&m_osCV, 0);
 #elif PE_PLAT_IS_PS4
 			
@@ -133,7 +145,7 @@ namespace Threading {
 
 		~ConditionVariable()
 		{
-#if APIABSTRACTION_IOS
+#if PE_USE_PTHREADS
 			pthread_cond_destroy(&m_osCV);
 #elif PE_PLAT_IS_PS4
 			
@@ -148,7 +160,7 @@ namespace Threading {
 		bool sleep()
 		{
 			
-#if  APIABSTRACTION_IOS
+#if PE_USE_PTHREADS
 			return pthread_cond_wait(&m_osCV, &m_associatedLock.m_osLock) == 0;
 #elif PE_PLAT_IS_PS4
 			
@@ -161,7 +173,7 @@ namespace Threading {
 
 		void signal()
 		{
-#if APIABSTRACTION_IOS
+#if PE_USE_PTHREADS
 			pthread_cond_signal(&m_osCV);
 #elif PE_PLAT_IS_PS4
 			
@@ -171,10 +183,24 @@ namespace Threading {
 			
 			WakeConditionVariable(&m_osCV);
 			
+#endif
+		}
+
+		// wakes all sleeping threads
+		void broadcast()
+		{
+#if PE_USE_PTHREADS
+			pthread_cond_broadcast(&m_osCV);
+#elif PE_PLAT_IS_PS4
+			
+#elif PE_PLAT_IS_PSVITA
+			
+#else
+			WakeAllConditionVariable(&m_osCV);
 #endif
 		}
 	};
-#if APIABSTRACTION_IOS
+#if PE_USE_PTHREADS
 	typedef pthread_t PEOsThread;
 #elif PE_PLAT_IS_PSVITA
 	
@@ -184,6 +210,141 @@ namespace Threading {
 	typedef HANDLE PEOsThread;
 #endif
 
+	// 0 gives up rest of time slice. granularity is os scheduler tick (on windows 15.6ms unless timeBeginPeriod() is used)
+	inline void SleepMilliseconds(unsigned int ms)
+	{
+#if PE_USE_PTHREADS
+		usleep(ms * 1000);
+#elif PE_PLAT_IS_PS4
+		
+#elif PE_PLAT_IS_PSVITA
+		
+#else
+		Sleep(ms);
+#endif
+	}
+
+	// number of cpus available to this process
+	inline int GetNumHardwareThreads()
+	{
+#if PE_USE_PTHREADS
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+		return n > 0 ? (int)(n) : 1;
+#elif PE_PLAT_IS_PS4
+		return 1;
+#elif PE_PLAT_IS_PSVITA
+		return 1;
+#else
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return info.dwNumberOfProcessors > 0 ? (int)(info.dwNumberOfProcessors) : 1;
+#endif
+	}
+
+	// atomic operations on 32 bit values. all of them are full memory barriers
+	typedef volatile long AtomicInt;
+
+	// returns new value
+	inline long AtomicIncrement(AtomicInt *pValue)
+	{
+#if PE_USE_PTHREADS
+		return __sync_add_and_fetch(pValue, 1);
+#elif PE_PLAT_IS_PS4
+		return ++(*pValue);
+#elif PE_PLAT_IS_PSVITA
+		return ++(*pValue);
+#else
+		return InterlockedIncrement(pValue);
+#endif
+	}
+
+	// returns new value
+	inline long AtomicDecrement(AtomicInt *pValue)
+	{
+#if PE_USE_PTHREADS
+		return __sync_sub_and_fetch(pValue, 1);
+#elif PE_PLAT_IS_PS4
+		return --(*pValue);
+#elif PE_PLAT_IS_PSVITA
+		return --(*pValue);
+#else
+		return InterlockedDecrement(pValue);
+#endif
+	}
+
+	// returns new value
+	inline long AtomicAdd(AtomicInt *pValue, long amount)
+	{
+#if PE_USE_PTHREADS
+		return __sync_add_and_fetch(pValue, amount);
+#elif PE_PLAT_IS_PS4
+		return (*pValue += amount);
+#elif PE_PLAT_IS_PSVITA
+		return (*pValue += amount);
+#else
+		return InterlockedExchangeAdd(pValue, amount) + amount;
+#endif
+	}
+
+	// read with barrier, so that writes of other threads that happened before their last atomic op are visible
+	inline long AtomicLoad(AtomicInt *pValue)
+	{
+#if PE_USE_PTHREADS
+		return __sync_add_and_fetch(pValue, 0);
+#elif PE_PLAT_IS_PS4
+		return *pValue;
+#elif PE_PLAT_IS_PSVITA
+		return *pValue;
+#else
+		return InterlockedCompareExchange(pValue, 0, 0);
+#endif
+	}
+
+	// sets *pValue to exchange if it is comparand. returns old value
+	inline long AtomicCompareExchange(AtomicInt *pValue, long exchange, long comparand)
+	{
+#if PE_USE_PTHREADS
+		return __sync_val_compare_and_swap(pValue, comparand, exchange);
+#elif PE_PLAT_IS_PS4
+		long old = *pValue; if (old == comparand) *pValue = exchange; return old;
+#elif PE_PLAT_IS_PSVITA
+		long old = *pValue; if (old == comparand) *pValue = exchange; return old;
+#else
+		return InterlockedCompareExchange(pValue, exchange, comparand);
+#endif
+	}
+
+	// one way barriers for single producer single consumer handoff, cheaper than the full barriers above:
+	// writes before AtomicStoreRelease are visible to a thread that reads the value with AtomicLoadAcquire
+	inline void AtomicStoreRelease(AtomicInt *pValue, long value)
+	{
+#if PE_USE_PTHREADS
+		__atomic_store_n(pValue, value, __ATOMIC_RELEASE);
+#else
+		// volatile stores have release semantics on msvc
+		*pValue = value;
+#endif
+	}
+
+	inline long AtomicLoadAcquire(AtomicInt *pValue)
+	{
+#if PE_USE_PTHREADS
+		return __atomic_load_n(pValue, __ATOMIC_ACQUIRE);
+#else
+		// volatile loads have acquire semantics on msvc
+		return *pValue;
+#endif
+	}
+
+	// thread local storage of plain data (pointers, ints)
+#if PE_USE_PTHREADS
+	#define PE_THREAD_LOCAL __thread
+#elif PE_PLAT_IS_PS4 || PE_PLAT_IS_PSVITA
+	#define PE_THREAD_LOCAL
+#else
+	#define PE_THREAD_LOCAL __declspec(thread)
+#endif
+
 	 typedef void (*ThreadFunction)(void *params);
 
 
@@ -195,7 +356,7 @@ namespace Threading {
 		void *m_pParams;
 		const static int PE_THREAD_STACK_SIZE = 1024 * 1024;
 		// wrapper to call m_function
-#if APIABSTRACTION_IOS
+#if PE_USE_PTHREADS
 		static void *OSThreadFunction(void *params)
         {
 #elif PE_PLAT_IS_PSVITA
@@ -214,7 +375,7 @@ namespace Threading {
 		void run()
 		{
 			m_start = 0xdeadbeef;
-#if APIABSTRACTION_PS3 || APIABSTRACTION_IOS
+#if APIABSTRACTION_PS3 || PE_USE_PTHREADS
 			pthread_create(&m_osThread, NULL, PEThread::OSThreadFunction, this);
 #elif PE_PLAT_IS_PS4
 			
@@ -15,6 +15,8 @@
 // Inter-Engine includes
 #if APIABSTRACTION_D3D9 || APIABSTRACTION_D3D11 || APIABSTRACTION_GLPC
 #include "WinTimer.h"
+#elif PE_PLAT_IS_LINUX
+#include <time.h>
 #elif APIABSTRACTION_OGL
 #include "PrimeEngine/Render/GLRenderer.h"
 #elif PE_PLAT_IS_PSVITA
@@ -25,6 +27,7 @@
 #endif
 
 #include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/Utils/PEClassDecl.h"
 
 // Sibling/Children includes
 
@@ -60,6 +63,9 @@ public:
 		#elif APIABSTRACTION_IOS
             m_before = m_now;
             m_now = CFAbsoluteTimeGetCurrent();
+		#elif PE_PLAT_IS_LINUX
+			m_before = m_now;
+			m_now = GetMonotonicTime();
 		#elif PE_PLAT_IS_PSVITA
 			
 		#elif PE_PLAT_IS_PS4
@@ -74,6 +80,8 @@ public:
 			return (float)(WinTimer::TimeDifferenceInSeconds(m_before, m_now));
 		#elif APIABSTRACTION_IOS
             return (float)(((double)(m_now - m_before)) * 1.0);
+		#elif PE_PLAT_IS_LINUX
+			return (float)(m_now - m_before);
 		#elif APIABSTRACTION_PS3
 			return (float)(((double)(m_now - m_before)) * .000001);
 		#elif PE_PLAT_IS_PSVITA
@@ -93,6 +101,8 @@ public:
 	typedef system_time_t TimeType;
 	#elif APIABSTRACTION_IOS
     typedef CFTimeInterval TimeType;
+	#elif PE_PLAT_IS_LINUX
+	typedef double TimeType; // seconds
 	#elif PE_PLAT_IS_PSVITA
 	#elif PE_PLAT_IS_PS4
 	#endif
@@ -114,6 +124,8 @@ public:
 		return (float)(WinTimer::TimeDifferenceInSeconds(t0, t1));
 #elif APIABSTRACTION_IOS
         return (float)(((double)(t1 - t0)) * 1.0);
+#elif PE_PLAT_IS_LINUX
+		return (float)(t1 - t0);
 #elif PE_PLAT_IS_PS4
 #elif PE_PLAT_IS_PSVITA
 #endif
@@ -122,9 +134,22 @@ public:
 public:
 	
 private:
+#if PE_PLAT_IS_LINUX
+	// CLOCK_MONOTONIC is not affected by system time changes. resolution is ns
+	static TimeType GetMonotonicTime()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (double)(ts.tv_sec) + (double)(ts.tv_nsec) * 1.0e-9;
+	}
+#endif
+
 	#if APIABSTRACTION_D3D9 || APIABSTRACTION_D3D11 || APIABSTRACTION_GLPC
 		TimeType m_now;
 		TimeType m_before;
+	#elif PE_PLAT_IS_LINUX
+		TimeType m_now;
+		TimeType m_before;
 	#elif APIABSTRACTION_PS3
 		TimeType m_now;
 		TimeType m_before;
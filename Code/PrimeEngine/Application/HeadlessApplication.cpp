@@ -0,0 +1,27 @@
+#define NOMINMAX
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+#if APIABSTRACTION_HEADLESS
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "HeadlessApplication.h"
+
+namespace PE {
+
+Application* Application::Construct(PE::GameContext &context, unsigned int width, unsigned int height, const char *caption)
+{
+	Handle h("HeadlessApplication", sizeof(HeadlessApplication));
+	HeadlessApplication *pApp = new (h) HeadlessApplication(context, width, height, caption);
+	context.m_pApplication = pApp;
+	return pApp;
+}
+
+}; // namespace PE
+
+#endif // APIABSTRACTION_HEADLESS
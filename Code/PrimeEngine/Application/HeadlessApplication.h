@@ -0,0 +1,37 @@
+#ifndef __pe_headlessapplication_h__
+#define __pe_headlessapplication_h__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+#if APIABSTRACTION_HEADLESS
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/MainFunction/MainFunctionArgs.h"
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "Application.h"
+
+// Sibling/Children includes
+
+// This class is implementation of Application for builds without window or input
+
+namespace PE {
+
+class HeadlessApplication : public Application
+{
+public:
+	HeadlessApplication(PE::GameContext &context, unsigned int width, unsigned int height, const char *caption) {}
+
+	// no window, no os events
+	virtual void processOSEventsIntoGlobalEventQueue() {}
+
+	virtual void exit() {}
+};
+
+}; // namespace PE
+
+#endif // APIABSTRACTION_HEADLESS
+#endif // File guard
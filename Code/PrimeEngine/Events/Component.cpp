@@ -413,7 +413,7 @@ void Component::SetLuaFunctions(PE::Components::LuaEnvironment *pLuaEnv, lua_Sta
 
 	// register the functions in current lua table which is the table for Event_MOVE
 	luaL_register(luaVM, 0, l_Component);
-#if APIABSTRACTION_IOS
+#if APIABSTRACTION_IOS || PE_PLAT_IS_LINUX
 	pLuaEnv->runScriptWorkspacePath("Code/PrimeEngine/Events/Component.lua");
 #else
     pLuaEnv->runScriptWorkspacePath("Code\\PrimeEngine\\Events\\Component.lua");
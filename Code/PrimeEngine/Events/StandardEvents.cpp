@@ -499,17 +499,19 @@ void *Event_SERVER_CLIENT_CONNECTION_ACK::FactoryConstruct(PE::GameContext& cont
 int Event_SERVER_CLIENT_CONNECTION_ACK::packCreationData(char *pDataStream)
 {
 	int written = 0;
-	written += PE::Components::StreamManager::WriteInt32(m_clientId, pDataStream);
+	written += PE::Components::StreamManager::WriteVarInt32(m_clientId, pDataStream);
 	return written;
 }
 
 int Event_SERVER_CLIENT_CONNECTION_ACK::constructFromStream(char *pDataStream)
 {
 	int read = 0;
-	read += PE::Components::StreamManager::ReadInt32(&pDataStream[read], m_clientId);
+	read += PE::Components::StreamManager::ReadVarInt32(&pDataStream[read], m_clientId);
 	return read;
 }
 
+PE_IMPLEMENT_CLASS1(Event_SERVER_CLIENT_DISCONNECTED, Event);
+
 };
 };
 
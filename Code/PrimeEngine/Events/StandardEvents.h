@@ -90,6 +90,15 @@ struct Event_GATHER_DRAWCALLS : public Event {
 			float dotProduct = normal.dotProduct(center);
 			return (dotProduct + distance) <= radius;  // Inside if within radius margin
 		}
+
+		// true only if whole box is on the outside of the plane (tests the corner closest to the inside)
+		bool isAABBOutside(const Vector3& aabbMin, const Vector3& aabbMax) {
+			Vector3 negativeVertex(
+				normal.m_x >= 0.0f ? aabbMin.m_x : aabbMax.m_x,
+				normal.m_y >= 0.0f ? aabbMin.m_y : aabbMax.m_y,
+				normal.m_z >= 0.0f ? aabbMin.m_z : aabbMax.m_z);
+			return !isPointInside(negativeVertex);
+		}
 	};
 	FrustumPlane m_frustumPlanes[6]; // Left, Right, Bottom, Top, Near, Far
 
@@ -105,7 +114,7 @@ struct Event_GATHER_DRAWCALLS : public Event {
 struct Event_GATHER_DRAWCALLS_Z_ONLY : public Event {
 	PE_DECLARE_CLASS(Event_GATHER_DRAWCALLS_Z_ONLY);
 
-	Event_GATHER_DRAWCALLS_Z_ONLY() : m_pZOnlyDrawListOverride(NULL) {}
+	Event_GATHER_DRAWCALLS_Z_ONLY() : m_pZOnlyDrawListOverride(NULL), m_cullShadowCasters(false) {}
 	virtual ~Event_GATHER_DRAWCALLS_Z_ONLY(){}
 
 	Matrix4x4 m_projectionViewTransform;
@@ -113,6 +122,10 @@ struct Event_GATHER_DRAWCALLS_Z_ONLY : public Event {
 	Matrix4x4 m_parentWorldTransform;
 	Vector3 m_eyePos;
 	void *m_pZOnlyDrawListOverride;
+
+	// shadow caster volume (light frustum cropped by camera frustum). only used if m_cullShadowCasters is set
+	Event_GATHER_DRAWCALLS::FrustumPlane m_frustumPlanes[6];
+	bool m_cullShadowCasters;
 };
 
 struct Event_CALCULATE_TRANSFORMATIONS : public Event {
@@ -437,6 +450,17 @@ struct Event_SERVER_CLIENT_CONNECTION_ACK : public Event, public Networkable {
 	PrimitiveTypes::Int32 m_clientId; // id given to client by server
 };
 
+// server only, sent to game object manager when connection of client died and its slot is released.
+// network manager already stopped ghosting objects of the client, game code frees them
+struct Event_SERVER_CLIENT_DISCONNECTED : public Event {
+	PE_DECLARE_CLASS(Event_SERVER_CLIENT_DISCONNECTED);
+
+	Event_SERVER_CLIENT_DISCONNECTED() : m_clientId(-1) {}
+	virtual ~Event_SERVER_CLIENT_DISCONNECTED(){}
+
+	PrimitiveTypes::Int32 m_clientId; // slot can be given to next client that connects
+};
+
 
 
 };
@@ -7,7 +7,7 @@
 
 // Outer-Engine includes
 #include <assert.h>
-#if APIABSTRACTION_D3D9 | APIABSTRACTION_D3D11 | APIABSTRACTION_OGL
+#if APIABSTRACTION_D3D9 | APIABSTRACTION_D3D11 | APIABSTRACTION_OGL | PE_PLAT_IS_LINUX
 #include <iostream>
 #include <fstream>
 #endif
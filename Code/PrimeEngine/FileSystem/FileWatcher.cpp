@@ -0,0 +1,189 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdio.h>
+#include <string.h>
+#if PE_PLAT_IS_LINUX
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+// Inter-Engine includes
+#include "PrimeEngine/APIAbstraction/Threading/Threading.h"
+#include "PrimeEngine/Utils/StringOps.h"
+#include "PrimeEngine/Utils/ErrorHandling.h"
+
+// Sibling/Children includes
+#include "FileWatcher.h"
+
+namespace PE {
+
+FileWatcher::FileWatcher(PE::GameContext &context, PE::MemoryArena arena)
+	: m_watches(context, arena, 64)
+	, m_fd(-1)
+{
+#if PE_PLAT_IS_LINUX
+	m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_fd < 0)
+		PEWARN("FileWatcher: inotify_init1 failed: %s\n", strerror(errno));
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#if PE_PLAT_IS_LINUX
+	if (m_fd >= 0)
+		close(m_fd); // removes all watches
+#endif
+	m_watches.reset(0);
+}
+
+bool FileWatcher::IsSupported()
+{
+	return PE_PLAT_IS_LINUX;
+}
+
+const char *FileWatcher::findWatchPath(int wd)
+{
+	for (PrimitiveTypes::UInt32 i = 0; i < m_watches.m_size; ++i)
+		if (m_watches[i].m_wd == wd)
+			return m_watches[i].m_path;
+	return NULL;
+}
+
+bool FileWatcher::addDirectoryRecursive(const char *path)
+{
+#if PE_PLAT_IS_LINUX
+	if (m_fd < 0)
+		return false;
+
+	int wd = inotify_add_watch(m_fd, path, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+	if (wd < 0)
+	{
+		PEWARN("FileWatcher: can't watch %s: %s\n", path, strerror(errno));
+		return false;
+	}
+
+	// same directory added again gets same watch
+	if (!findWatchPath(wd))
+	{
+		Watch w;
+		w.m_wd = wd;
+		StringOps::writeToString(path, w.m_path, 256);
+		PrimitiveTypes::UInt32 len = StringOps::length(w.m_path);
+		if (len > 1 && w.m_path[len - 1] == '/')
+			w.m_path[len - 1] = '\0';
+		m_watches.add(w);
+	}
+
+	DIR *pDir = opendir(path);
+	if (!pDir)
+		return true;
+	while (struct dirent *pEntry = readdir(pDir))
+	{
+		if (pEntry->d_name[0] == '.')
+			continue; // ., .. and hidden directories
+
+		// watch path + '/' + name. watched paths are kept in 256 bytes
+		char sub[256 + 1 + 256];
+		int len = snprintf(sub, sizeof(sub), "%s/%s", findWatchPath(wd), pEntry->d_name);
+		if (len < 0 || len >= 256)
+		{
+			PEWARN("FileWatcher: %s/%s not watched: path too long\n", findWatchPath(wd), pEntry->d_name);
+			continue;
+		}
+		struct stat st;
+		if (stat(sub, &st) == 0 && S_ISDIR(st.st_mode))
+			addDirectoryRecursive(sub);
+	}
+	closedir(pDir);
+	return true;
+#else
+	return false;
+#endif
+}
+
+PrimitiveTypes::UInt32 FileWatcher::waitForChanges(int timeoutMs, ChangeFunction onChange, void *pUser)
+{
+#if PE_PLAT_IS_LINUX
+	if (m_fd < 0)
+	{
+		Threading::SleepMilliseconds(timeoutMs);
+		return 0;
+	}
+
+	struct pollfd pfd;
+	pfd.fd = m_fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	if (poll(&pfd, 1, timeoutMs) <= 0)
+		return 0;
+
+	PrimitiveTypes::UInt32 n = 0;
+	char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	for (;;)
+	{
+		ssize_t len = read(m_fd, buf, sizeof(buf));
+		if (len <= 0)
+			break; // EAGAIN, all events read
+
+		const struct inotify_event *pEvent;
+		for (char *p = buf; p < buf + len; p += sizeof(struct inotify_event) + pEvent->len)
+		{
+			pEvent = (const struct inotify_event *)(p);
+			if (pEvent->mask & IN_Q_OVERFLOW)
+			{
+				PEWARN("FileWatcher: event queue overflow, some changes were missed\n");
+				continue;
+			}
+			if (pEvent->mask & IN_IGNORED)
+			{
+				// directory was removed
+				for (PrimitiveTypes::UInt32 i = 0; i < m_watches.m_size; ++i)
+				{
+					if (m_watches[i].m_wd == pEvent->wd)
+					{
+						m_watches.remove(i);
+						break;
+					}
+				}
+				continue;
+			}
+
+			const char *dir = findWatchPath(pEvent->wd);
+			if (!pEvent->len || !dir || pEvent->name[0] == '.')
+				continue;
+
+			char path[256 + 1 + 256];
+			int len = snprintf(path, sizeof(path), "%s/%s", dir, pEvent->name);
+			if (len < 0 || len >= 256)
+			{
+				PEWARN("FileWatcher: change of %s/%s ignored: path too long\n", dir, pEvent->name);
+				continue;
+			}
+			if (pEvent->mask & IN_ISDIR)
+			{
+				if (pEvent->mask & (IN_CREATE | IN_MOVED_TO))
+					addDirectoryRecursive(path);
+			}
+			else if (pEvent->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+			{
+				onChange(pUser, path);
+				++n;
+			}
+		}
+	}
+	return n;
+#else
+	Threading::SleepMilliseconds(timeoutMs);
+	return 0;
+#endif
+}
+
+}; // namespace PE
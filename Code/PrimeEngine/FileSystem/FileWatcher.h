@@ -0,0 +1,55 @@
+#ifndef __PYENGINE_2_0_FILE_WATCHER_H__
+#define __PYENGINE_2_0_FILE_WATCHER_H__
+// Reports files changed in watched directories
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+// inotify on linux. other platforms have no implementation (IsSupported() is false) and never report changes.
+// not thread safe, meant to be used by one watcher thread
+struct FileWatcher
+{
+	// path is directory of the watch + '/' + file name
+	typedef void (*ChangeFunction)(void *pUser, const char *path);
+
+	FileWatcher(PE::GameContext &context, PE::MemoryArena arena);
+	~FileWatcher();
+
+	static bool IsSupported();
+
+	// watches directory and all directories under it, including ones created later. hidden directories are skipped
+	bool addDirectoryRecursive(const char *path);
+
+	// waits up to timeoutMs for changes and calls onChange for every file that was closed after writing or moved
+	// into a watched directory. returns number of calls
+	PrimitiveTypes::UInt32 waitForChanges(int timeoutMs, ChangeFunction onChange, void *pUser);
+
+	PrimitiveTypes::UInt32 getNumWatchedDirectories() { return m_watches.m_size; }
+
+private:
+	struct Watch
+	{
+		int m_wd;
+		char m_path[256];
+	};
+
+	const char *findWatchPath(int wd);
+
+	Array<Watch, 1> m_watches;
+	int m_fd;
+};
+
+}; // namespace PE
+
+#endif
@@ -7,7 +7,7 @@
 
 // Outer-Engine includes
 #include <assert.h>
-#if APIABSTRACTION_D3D9 || APIABSTRACTION_D3D11 || APIABSTRACTION_OGL || PE_PLAT_IS_PSVITA
+#if APIABSTRACTION_D3D9 || APIABSTRACTION_D3D11 || APIABSTRACTION_OGL || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
 #include <iostream>
 #include <fstream>
 #endif
@@ -28,7 +28,7 @@ struct FileWriter : public PE::PEAllocatableAndDefragmentable
 
 	void writeEOL();
 
-#	if APIABSTRACTION_D3D9 || APIABSTRACTION_D3D11 || APIABSTRACTION_OGL || PE_PLAT_IS_PSVITA
+#	if APIABSTRACTION_D3D9 || APIABSTRACTION_D3D11 || APIABSTRACTION_OGL || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
 		std::ofstream m_file;
 #	endif
 
@@ -0,0 +1,538 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if PE_PLAT_IS_LINUX
+#include <dirent.h>
+#endif
+
+extern "C" {
+#include "../../lua_dist/src/lua.h"
+#include "../../lua_dist/src/lualib.h"
+#include "../../lua_dist/src/lauxlib.h"
+}
+
+// Inter-Engine includes
+#include "PrimeEngine/Game/Common/GameContext.h"
+#include "PrimeEngine/MainFunction/MainFunctionArgs.h"
+#include "PrimeEngine/Utils/StringOps.h"
+#include "PrimeEngine/Utils/ErrorHandling.h"
+#include "PrimeEngine/Lua/LuaEnvironment.h"
+#include "PrimeEngine/APIAbstraction/Effect/EffectManager.h"
+#include "PrimeEngine/APIAbstraction/Texture/GPUTextureManager.h"
+#include "PrimeEngine/APIAbstraction/Texture/Texture_DDS_Loader_Common.h"
+#include "PrimeEngine/Scene/MeshManager.h"
+
+// Sibling/Children includes
+#include "HotReloadManager.h"
+
+namespace PE {
+
+using namespace Components;
+
+HotReloadManager *HotReloadManager::s_pInstance = NULL;
+
+namespace {
+
+enum ApplyResult
+{
+	ApplyResult_Applied,
+	ApplyResult_NotLive,
+	ApplyResult_Failed,
+};
+
+struct FileName
+{
+	char m_name[128];
+};
+
+const char *fileNameOf(const char *path)
+{
+	const char *pSlash = strrchr(path, '/');
+	return pSlash ? pSlash + 1 : path;
+}
+
+// true if text asset at path has a line that is exactly name (meshes list their files one per line)
+bool fileListsName(const char *path, const char *name)
+{
+	FILE *f = fopen(path, "r");
+	if (!f)
+		return false;
+
+	bool found = false;
+	char line[256];
+	while (!found && fgets(line, 256, f))
+	{
+		PrimitiveTypes::UInt32 len = StringOps::length(line);
+		while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r' || line[len - 1] == ' ' || line[len - 1] == '\t'))
+			line[--len] = '\0';
+		found = StringOps::strcmp(line, name) == 0;
+	}
+	fclose(f);
+	return found;
+}
+
+// files in dir with extension ext that list name
+void findFilesListing(const char *dir, const char *ext, const char *name, Array<FileName, 1> &out)
+{
+#if PE_PLAT_IS_LINUX
+	DIR *pDir = opendir(dir);
+	if (!pDir)
+		return;
+	while (struct dirent *pEntry = readdir(pDir))
+	{
+		if (pEntry->d_name[0] == '.' || !StringOps::endswith(pEntry->d_name, ext))
+			continue;
+
+		char path[512];
+		snprintf(path, 512, "%s%s", dir, pEntry->d_name);
+		if (fileListsName(path, name))
+		{
+			FileName fn;
+			StringOps::writeToString(pEntry->d_name, fn.m_name, 128);
+			out.add(fn);
+		}
+	}
+	closedir(pDir);
+#endif
+}
+
+struct ChunkBuffer
+{
+	char *m_pData; // malloc'd
+	PrimitiveTypes::UInt32 m_size;
+};
+
+int luaChunkWriter(lua_State *L, const void *p, size_t size, void *ud)
+{
+	ChunkBuffer *pBuffer = static_cast<ChunkBuffer *>(ud);
+	char *pGrown = (char *)(realloc(pBuffer->m_pData, pBuffer->m_size + size));
+	if (!pGrown)
+		return 1;
+	memcpy(pGrown + pBuffer->m_size, p, size);
+	pBuffer->m_pData = pGrown;
+	pBuffer->m_size += (PrimitiveTypes::UInt32)(size);
+	return 0;
+}
+
+}; // namespace
+
+HotReloadManager::HotReloadManager(PE::GameContext &context, PE::MemoryArena arena)
+	: m_watcher(context, arena)
+	, m_running(0)
+	, m_threadDone(1)
+	, m_changes(context, arena, 16)
+	, m_ready(context, arena, 16)
+{
+	m_arena = arena; m_pContext = &context;
+	memset(&m_stats, 0, sizeof(m_stats));
+	StringOps::concat(context.getMainFunctionArgs()->gameProjRoot(), "AssetsOut/", m_assetsOutRoot, 256);
+}
+
+HotReloadManager::~HotReloadManager()
+{
+	stop();
+}
+
+void HotReloadManager::Construct(PE::GameContext &context, PE::MemoryArena arena)
+{
+	Handle h("HOT_RELOAD_MANAGER", sizeof(HotReloadManager));
+	s_pInstance = new(h) HotReloadManager(context, arena);
+}
+
+bool HotReloadManager::start()
+{
+	char assetsOut[256], code[256];
+	StringOps::concat(m_pContext->getMainFunctionArgs()->gameProjRoot(), "AssetsOut", assetsOut, 256);
+	StringOps::concat(m_pContext->getMainFunctionArgs()->gameProjRoot(), "Code", code, 256);
+	const char *directories[] = {assetsOut, code};
+	return start(directories, 2);
+}
+
+bool HotReloadManager::start(const char *const *directories, PrimitiveTypes::UInt32 numDirectories)
+{
+	if (!FileWatcher::IsSupported())
+	{
+		PEINFO("HotReloadManager: file watching is not implemented on this platform, no hot reload\n");
+		return false;
+	}
+	if (m_running)
+		return true;
+
+	// watches are added before watcher thread starts, after that only watcher thread uses m_watcher
+	for (PrimitiveTypes::UInt32 i = 0; i < numDirectories; ++i)
+		m_watcher.addDirectoryRecursive(directories[i]);
+	m_stats.m_numWatchedDirectories = m_watcher.getNumWatchedDirectories();
+	PEINFO("HotReloadManager: watching %d directories\n", m_stats.m_numWatchedDirectories);
+
+	m_threadDone = 0;
+	Threading::AtomicStoreRelease(&m_running, 1);
+	m_thread.m_function = &HotReloadManager::WatchThreadFunction;
+	m_thread.m_pParams = this;
+	m_thread.run();
+	return true;
+}
+
+void HotReloadManager::stop()
+{
+	if (!m_running)
+		return;
+
+	Threading::AtomicStoreRelease(&m_running, 0);
+	while (!Threading::AtomicLoadAcquire(&m_threadDone))
+		Threading::SleepMilliseconds(1);
+
+	m_lock.lock();
+	for (PrimitiveTypes::UInt32 i = 0; i < m_ready.m_size; ++i)
+		free(m_ready[i].m_pChunk);
+	m_ready.clear();
+	m_stats.m_numPending = 0;
+	m_lock.unlock();
+}
+
+HotReloadManager::Kind HotReloadManager::KindOfFile(const char *path, bool &isReloadable)
+{
+	isReloadable = true;
+	if (strstr(path, "/GPUPrograms/"))
+		return Kind_Shader;
+	if (StringOps::endswith(path, ".lua") || StringOps::endswith(path, ".levela"))
+		return Kind_Script;
+	if (StringOps::endswith(path, ".mesha") || StringOps::endswith(path, ".bufa") || StringOps::endswith(path, ".mseta") ||
+		StringOps::endswith(path, ".mata") || StringOps::endswith(path, ".swghta"))
+		return Kind_Mesh;
+	if (StringOps::endswith(path, ".dds"))
+		return Kind_Texture;
+
+	isReloadable = false;
+	return Kind_Count;
+}
+
+void HotReloadManager::WatchThreadFunction(void *params)
+{
+	static_cast<HotReloadManager *>(params)->watchThreadRun();
+}
+
+void HotReloadManager::OnChange(void *pUser, const char *path)
+{
+	HotReloadManager *pManager = static_cast<HotReloadManager *>(pUser);
+	bool isReloadable;
+	KindOfFile(path, isReloadable);
+	if (!isReloadable)
+		return;
+
+	// editors write files in several steps. file is reloaded once it was not written to for settle time
+	Timer::TimeType now = pManager->m_watchTimer.TickAndGetCurrentTime();
+	for (PrimitiveTypes::UInt32 i = 0; i < pManager->m_changes.m_size; ++i)
+	{
+		if (StringOps::strcmp(pManager->m_changes[i].m_path, path) == 0)
+		{
+			pManager->m_changes[i].m_lastWriteTime = now;
+			return;
+		}
+	}
+
+	Change change;
+	StringOps::writeToString(path, change.m_path, 256);
+	change.m_lastWriteTime = now;
+	pManager->m_changes.add(change);
+}
+
+void HotReloadManager::watchThreadRun()
+{
+	int waitMs = PE_HOT_RELOAD_SETTLE_MS / 2 > 1 ? PE_HOT_RELOAD_SETTLE_MS / 2 : 1;
+	while (Threading::AtomicLoadAcquire(&m_running))
+	{
+		m_watcher.waitForChanges(waitMs, &HotReloadManager::OnChange, this);
+
+		Timer::TimeType now = m_watchTimer.TickAndGetCurrentTime();
+		for (PrimitiveTypes::UInt32 i = 0; i < m_changes.m_size;)
+		{
+			if (Timer::GetTimeDeltaInSeconds(m_changes[i].m_lastWriteTime, now) * 1000.0f >= PE_HOT_RELOAD_SETTLE_MS)
+			{
+				Change change = m_changes[i];
+				m_changes.remove(i);
+				prepare(change);
+			}
+			else
+				++i;
+		}
+	}
+	Threading::AtomicStoreRelease(&m_threadDone, 1);
+}
+
+void HotReloadManager::prepare(const Change &change)
+{
+	Reload r;
+	memset(&r, 0, sizeof(r));
+	bool isReloadable;
+	r.m_kind = KindOfFile(change.m_path, isReloadable);
+	r.m_changeTime = change.m_lastWriteTime;
+	StringOps::writeToString(change.m_path, r.m_path, 256);
+	StringOps::writeToString(fileNameOf(change.m_path), r.m_file, 128);
+
+	// AssetsOut/<package>/<asset type>/<file>
+	if (StringOps::startsswith(change.m_path, m_assetsOutRoot))
+	{
+		StringOps::writeToString(change.m_path + StringOps::length(m_assetsOutRoot), r.m_package, 64);
+		if (char *pSlash = strchr(r.m_package, '/'))
+			*pSlash = '\0';
+	}
+
+	m_lock.lock();
+	++m_stats.m_numChanges;
+	m_lock.unlock();
+
+	bool ok = true;
+	switch (r.m_kind)
+	{
+	case Kind_Script:
+		{
+			// compiled here, game thread only runs it. syntax errors keep old script
+			ChunkBuffer chunk = {NULL, 0};
+			lua_State *L = luaL_newstate();
+			ok = luaL_loadfile(L, r.m_path) == 0;
+			if (ok)
+				ok = lua_dump(L, &luaChunkWriter, &chunk) == 0;
+			if (!ok)
+				PEWARN("HotReloadManager: %s not reloaded: %s\n", r.m_path, lua_isstring(L, -1) ? lua_tostring(L, -1) : "can't compile");
+			lua_close(L);
+
+			r.m_pChunk = chunk.m_pData;
+			r.m_chunkSize = chunk.m_size;
+			if (ok)
+				pushReady(r);
+			else
+				free(r.m_pChunk);
+		}
+		break;
+	case Kind_Shader:
+		pushReady(r);
+		break;
+	case Kind_Texture:
+		{
+			DDS::DDSMipLayout layout;
+			ok = DDS::readDDSMipLayout(r.m_path, &layout);
+			if (ok)
+				pushReady(r);
+			else
+				PEWARN("HotReloadManager: %s not reloaded: not a dds texture\n", r.m_path);
+		}
+		break;
+	case Kind_Mesh:
+		if (r.m_package[0])
+			prepareMeshReloads(r);
+		break;
+	default:
+		break;
+	}
+
+	if (!ok)
+	{
+		m_lock.lock();
+		++m_stats.m_numFailed;
+		m_lock.unlock();
+	}
+}
+
+void HotReloadManager::prepareMeshReloads(Reload &reload)
+{
+	// assets out root + package + subdirectory
+	char meshesDir[256 + 64 + 16], materialSetsDir[256 + 64 + 16];
+	int meshesLen = snprintf(meshesDir, sizeof(meshesDir), "%s%s/Meshes/", m_assetsOutRoot, reload.m_package);
+	int materialSetsLen = snprintf(materialSetsDir, sizeof(materialSetsDir), "%s%s/MaterialSets/", m_assetsOutRoot, reload.m_package);
+	if (meshesLen < 0 || meshesLen >= (int)(sizeof(meshesDir)) || materialSetsLen < 0 || materialSetsLen >= (int)(sizeof(materialSetsDir)))
+	{
+		PEWARN("HotReloadManager: %s not reloaded: package path too long\n", reload.m_path);
+		m_lock.lock();
+		++m_stats.m_numFailed;
+		m_lock.unlock();
+		return;
+	}
+
+	Array<FileName, 1> meshes(*m_pContext, m_arena, 8);
+	if (StringOps::endswith(reload.m_file, ".mesha"))
+	{
+		FileName fn;
+		StringOps::writeToString(reload.m_file, fn.m_name, 128);
+		meshes.add(fn);
+	}
+	else if (StringOps::endswith(reload.m_file, ".mata"))
+	{
+		// material -> material sets that list it -> meshes that use those sets
+		Array<FileName, 1> sets(*m_pContext, m_arena, 8);
+		findFilesListing(materialSetsDir, ".mseta", reload.m_file, sets);
+		for (PrimitiveTypes::UInt32 iSet = 0; iSet < sets.m_size; ++iSet)
+		{
+			PrimitiveTypes::UInt32 first = meshes.m_size;
+			findFilesListing(meshesDir, ".mesha", sets[iSet].m_name, meshes);
+			for (PrimitiveTypes::UInt32 i = first; i < meshes.m_size; ++i)
+			{
+				Reload r = reload;
+				StringOps::writeToString(meshes[i].m_name, r.m_asset, 128);
+				StringOps::writeToString(sets[iSet].m_name, r.m_dependency, 128);
+				pushReady(r);
+			}
+		}
+		sets.reset(0);
+	}
+	else
+	{
+		findFilesListing(meshesDir, ".mesha", reload.m_file, meshes);
+	}
+
+	if (!StringOps::endswith(reload.m_file, ".mata"))
+	{
+		for (PrimitiveTypes::UInt32 i = 0; i < meshes.m_size; ++i)
+		{
+			Reload r = reload;
+			StringOps::writeToString(meshes[i].m_name, r.m_asset, 128);
+			pushReady(r);
+		}
+	}
+
+	if (meshes.m_size == 0)
+	{
+		m_lock.lock();
+		++m_stats.m_numNotLive;
+		m_lock.unlock();
+	}
+	meshes.reset(0);
+}
+
+void HotReloadManager::pushReady(Reload &reload)
+{
+	m_lock.lock();
+
+	// same file changed again before swap: newer one replaces older one
+	for (PrimitiveTypes::UInt32 i = 0; i < m_ready.m_size; ++i)
+	{
+		Reload &other = m_ready[i];
+		if (other.m_kind == reload.m_kind && StringOps::strcmp(other.m_path, reload.m_path) == 0 &&
+			StringOps::strcmp(other.m_asset, reload.m_asset) == 0)
+		{
+			free(other.m_pChunk);
+			m_ready.remove(i);
+			break;
+		}
+	}
+	m_ready.add(reload);
+	m_stats.m_numPending = m_ready.m_size;
+
+	m_lock.unlock();
+}
+
+bool HotReloadManager::hasReadyReloads(bool &replacesGPUResources)
+{
+	replacesGPUResources = false;
+	m_lock.lock();
+	bool any = m_ready.m_size > 0;
+	for (PrimitiveTypes::UInt32 i = 0; i < m_ready.m_size; ++i)
+		replacesGPUResources = replacesGPUResources || m_ready[i].m_kind != Kind_Script;
+	m_lock.unlock();
+	return any;
+}
+
+bool HotReloadManager::applyReload(Reload &reload, int &threadOwnershipMask)
+{
+	ApplyResult res = ApplyResult_NotLive;
+	switch (reload.m_kind)
+	{
+	case Kind_Script:
+		{
+			bool isLive = false;
+			LuaEnvironment *pLuaEnv = m_pContext->getLuaEnvironment();
+			if (pLuaEnv && pLuaEnv->reloadScript(reload.m_path, reload.m_pChunk, reload.m_chunkSize, isLive))
+				res = ApplyResult_Applied;
+			else if (isLive)
+				res = ApplyResult_Failed;
+		}
+		break;
+	case Kind_Shader:
+		if (EffectManager::s_myHandle.isValid() && EffectManager::Instance()->reloadShaderFile_needsRC(reload.m_file))
+			res = ApplyResult_Applied;
+		break;
+	case Kind_Texture:
+		if (GPUTextureManager::s_myHandle.isValid())
+		{
+			// textures loaded without package are from Default and keyed without it
+			GPUTextureManager *pTM = GPUTextureManager::Instance();
+			if (pTM->reloadTexture_needsRC(reload.m_file, reload.m_package) ||
+				(StringOps::strcmp(reload.m_package, "Default") == 0 && pTM->reloadTexture_needsRC(reload.m_file, "")))
+				res = ApplyResult_Applied;
+		}
+		break;
+	case Kind_Mesh:
+		{
+			MeshManager::forgetFile(reload.m_file);
+			if (reload.m_dependency[0])
+				MeshManager::forgetFile(reload.m_dependency);
+			MeshManager *pMeshManager = m_pContext->getMeshManager();
+			if (pMeshManager && pMeshManager->reloadAsset(reload.m_asset, reload.m_package, threadOwnershipMask))
+				res = ApplyResult_Applied;
+		}
+		break;
+	default:
+		break;
+	}
+
+	m_lock.lock();
+	if (res == ApplyResult_Applied)
+		++m_stats.m_numApplied[reload.m_kind];
+	else if (res == ApplyResult_NotLive)
+		++m_stats.m_numNotLive;
+	else
+		++m_stats.m_numFailed;
+	m_lock.unlock();
+	return res == ApplyResult_Applied;
+}
+
+void HotReloadManager::applyReadyReloads_needsRC(int &threadOwnershipMask)
+{
+	Timer::TimeType start = m_applyTimer.TickAndGetCurrentTime();
+	PrimitiveTypes::Float32 swapMs = 0;
+	PrimitiveTypes::Float32 latencyMs = -1.0f;
+
+	// one reload can't be split, so a big one can go over budget
+	while (swapMs < PE_HOT_RELOAD_FRAME_BUDGET_MS)
+	{
+		m_lock.lock();
+		if (m_ready.m_size == 0)
+		{
+			m_lock.unlock();
+			break;
+		}
+		Reload reload = m_ready[0];
+		m_ready.remove(0);
+		m_lock.unlock();
+
+		applyReload(reload, threadOwnershipMask);
+		free(reload.m_pChunk);
+
+		Timer::TimeType now = m_applyTimer.TickAndGetCurrentTime();
+		swapMs = Timer::GetTimeDeltaInSeconds(start, now) * 1000.0f;
+		latencyMs = Timer::GetTimeDeltaInSeconds(reload.m_changeTime, now) * 1000.0f;
+	}
+
+	m_lock.lock();
+	m_stats.m_lastSwapMs = swapMs;
+	if (swapMs > m_stats.m_maxSwapMs)
+		m_stats.m_maxSwapMs = swapMs;
+	if (latencyMs >= 0)
+		m_stats.m_lastLatencyMs = latencyMs;
+	m_stats.m_numPending = m_ready.m_size;
+	m_lock.unlock();
+}
+
+HotReloadManager::Stats HotReloadManager::getStats()
+{
+	m_lock.lock();
+	Stats stats = m_stats;
+	m_lock.unlock();
+	return stats;
+}
+
+}; // namespace PE
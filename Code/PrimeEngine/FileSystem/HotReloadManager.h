@@ -0,0 +1,132 @@
+#ifndef __PYENGINE_2_0_HOT_RELOAD_MANAGER_H__
+#define __PYENGINE_2_0_HOT_RELOAD_MANAGER_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/APIAbstraction/Threading/Threading.h"
+#include "PrimeEngine/APIAbstraction/Timer/Timer.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+#include "FileWatcher.h"
+
+namespace PE {
+
+// Reloads scripts and assets that change on disk while the game runs (PE_HOT_RELOAD).
+// A watcher thread gets changed files from FileWatcher, waits until a file was not written to for
+// PE_HOT_RELOAD_SETTLE_MS and prepares its reload: lua is compiled in a private lua state (syntax errors are reported
+// and old script stays), meshes built from a changed buffer, material set or material file are found by reading
+// .mesha and .mseta files of the package. Prepared reloads are swapped in on game thread at start of a frame
+// (applyReadyReloads_needsRC()) within PE_HOT_RELOAD_FRAME_BUDGET_MS, the rest waits for next frames.
+// Meshes, textures and effects are reloaded into the objects they were loaded into, so all Handles to them stay valid.
+// Mesh and material files are parsed at the swap, materials are read through lua
+struct HotReloadManager : PE::PEAllocatableAndDefragmentable
+{
+	enum Kind
+	{
+		Kind_Script, // .lua, .levela
+		Kind_Shader, // files in GPUPrograms
+		Kind_Mesh, // .mesha, and buffers, material sets, materials and skin weights meshes are read from
+		Kind_Texture, // .dds
+		Kind_Count
+	};
+
+	struct Stats
+	{
+		PrimitiveTypes::UInt32 m_numChanges; // file changes seen by watcher thread, after settling
+		PrimitiveTypes::UInt32 m_numApplied[Kind_Count];
+		PrimitiveTypes::UInt32 m_numNotLive; // nothing uses the file yet (level and object scripts), it is read when used
+		PrimitiveTypes::UInt32 m_numFailed; // compile errors, unreadable files. old data stays
+		PrimitiveTypes::UInt32 m_numPending; // prepared, waiting for swap
+		PrimitiveTypes::UInt32 m_numWatchedDirectories;
+		PrimitiveTypes::Float32 m_lastSwapMs; // swap work of last frame that had any
+		PrimitiveTypes::Float32 m_maxSwapMs;
+		PrimitiveTypes::Float32 m_lastLatencyMs; // from last write of file to its swap
+	};
+
+	HotReloadManager(PE::GameContext &context, PE::MemoryArena arena);
+	~HotReloadManager();
+
+	static void Construct(PE::GameContext &context, PE::MemoryArena arena);
+	static HotReloadManager *Instance() { return s_pInstance; }
+
+	// starts watcher thread on AssetsOut and Code of game project root, or on given directories.
+	// false if file watching is not supported on this platform
+	bool start();
+	bool start(const char *const *directories, PrimitiveTypes::UInt32 numDirectories);
+	void stop();
+
+	// true if prepared reloads wait for swap. replacesGPUResources is set if any of them releases gpu resources
+	// draw lists in flight may use. then the caller has to wait for render thread to finish those frames
+	bool hasReadyReloads(bool &replacesGPUResources);
+
+	// swaps in prepared reloads, at least one, then more while frame budget lasts. game thread, with render context
+	void applyReadyReloads_needsRC(int &threadOwnershipMask);
+
+	Stats getStats();
+
+	static Kind KindOfFile(const char *path, bool &isReloadable);
+
+	static HotReloadManager *s_pInstance;
+
+private:
+	struct Change
+	{
+		char m_path[256];
+		Timer::TimeType m_lastWriteTime;
+	};
+
+	struct Reload
+	{
+		Kind m_kind;
+		char m_path[256]; // changed file, full path
+		char m_package[64]; // AssetsOut/<package>/..., empty if not in AssetsOut
+		char m_file[128]; // name of changed file
+		char m_asset[128]; // Kind_Mesh: .mesha to reload
+		char m_dependency[128]; // Kind_Mesh: material set that includes changed material, read again too
+		char *m_pChunk; // Kind_Script: compiled script, malloc'd
+		PrimitiveTypes::UInt32 m_chunkSize;
+		Timer::TimeType m_changeTime;
+	};
+
+	static void WatchThreadFunction(void *params);
+	static void OnChange(void *pUser, const char *path);
+	void watchThreadRun();
+
+	// watcher thread: turns a settled change into ready reloads
+	void prepare(const Change &change);
+	void prepareMeshReloads(Reload &reload);
+	void pushReady(Reload &reload);
+	bool applyReload(Reload &reload, int &threadOwnershipMask);
+
+	FileWatcher m_watcher;
+	Threading::PEThread m_thread;
+	Threading::AtomicInt m_running;
+	Threading::AtomicInt m_threadDone;
+	char m_assetsOutRoot[256]; // game project root + AssetsOut/
+
+	// watcher thread only
+	Array<Change, 1> m_changes;
+	Timer m_watchTimer;
+
+	// shared, under m_lock
+	Threading::Mutex m_lock;
+	Array<Reload, 1> m_ready;
+	Stats m_stats;
+
+	// game thread only
+	Timer m_applyTimer;
+
+	PE::MemoryArena m_arena; PE::GameContext *m_pContext;
+};
+
+}; // namespace PE
+
+#endif
@@ -0,0 +1,131 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "FramePipeline.h"
+
+namespace PE {
+
+using namespace PrimitiveTypes;
+
+FramePipeline g_framePipeline;
+
+FramePipeline::FramePipeline()
+: m_frameSubmittedCV(m_lock)
+, m_frameRenderedCV(m_lock)
+, m_numSubmittedFrames(0)
+, m_numRenderedFrames(0)
+, m_exitRequested(false)
+, m_gameWaitTime(0)
+, m_renderWaitTime(0)
+, m_numFramesInFlightSum(0)
+, m_numStatsFrames(0)
+{
+	m_lastStats.m_numFrames = 0;
+	m_lastStats.m_gameWaitTime = 0;
+	m_lastStats.m_renderWaitTime = 0;
+	m_lastStats.m_avgFramesInFlight = 0;
+}
+
+float FramePipeline::waitForFreeSlot()
+{
+	Timer t;
+	m_lock.lock();
+	// slot of frame m_numSubmittedFrames was last used by frame m_numSubmittedFrames - PE_NUM_FRAMES_IN_FLIGHT
+	while (m_numSubmittedFrames - m_numRenderedFrames >= PE_NUM_FRAMES_IN_FLIGHT)
+	{
+		bool success = m_frameRenderedCV.sleep();
+		assert(success);
+	}
+	float waitTime = t.TickAndGetTimeDeltaInSeconds();
+	m_gameWaitTime += waitTime;
+	m_lock.unlock();
+	return waitTime;
+}
+
+void FramePipeline::submitFrame()
+{
+	m_lock.lock();
+	++m_numSubmittedFrames;
+	m_numFramesInFlightSum += m_numSubmittedFrames - m_numRenderedFrames;
+	if (++m_numStatsFrames == c_numStatsFrames)
+	{
+		m_lastStats.m_numFrames = m_numStatsFrames;
+		m_lastStats.m_gameWaitTime = (Float32)(m_gameWaitTime / m_numStatsFrames);
+		m_lastStats.m_renderWaitTime = (Float32)(m_renderWaitTime / m_numStatsFrames);
+		m_lastStats.m_avgFramesInFlight = (Float32)(m_numFramesInFlightSum) / m_numStatsFrames;
+		m_gameWaitTime = 0;
+		m_renderWaitTime = 0;
+		m_numFramesInFlightSum = 0;
+		m_numStatsFrames = 0;
+	}
+	m_lock.unlock();
+	m_frameSubmittedCV.signal();
+}
+
+void FramePipeline::waitForAllFrames()
+{
+	m_lock.lock();
+	while (m_numRenderedFrames != m_numSubmittedFrames && !m_exitRequested)
+	{
+		bool success = m_frameRenderedCV.sleep();
+		assert(success);
+	}
+	m_lock.unlock();
+}
+
+void FramePipeline::requestExit()
+{
+	m_lock.lock();
+	m_exitRequested = true;
+	m_lock.unlock();
+	m_frameSubmittedCV.broadcast();
+	m_frameRenderedCV.broadcast();
+}
+
+bool FramePipeline::beginRenderFrame()
+{
+	Timer t;
+	m_lock.lock();
+	while (m_numRenderedFrames == m_numSubmittedFrames && !m_exitRequested)
+	{
+		bool success = m_frameSubmittedCV.sleep();
+		assert(success);
+	}
+	m_renderWaitTime += t.TickAndGetTimeDeltaInSeconds();
+	bool exit = m_exitRequested;
+	m_lock.unlock();
+	return !exit;
+}
+
+void FramePipeline::endRenderFrame()
+{
+	m_lock.lock();
+	++m_numRenderedFrames;
+	m_lock.unlock();
+	m_frameRenderedCV.signal();
+}
+
+UInt32 FramePipeline::getNumFramesInFlight()
+{
+	m_lock.lock();
+	UInt32 res = m_numSubmittedFrames - m_numRenderedFrames;
+	m_lock.unlock();
+	return res;
+}
+
+FramePipeline::Stats FramePipeline::getLastStats()
+{
+	m_lock.lock();
+	Stats res = m_lastStats;
+	m_lock.unlock();
+	return res;
+}
+
+}; // namespace PE
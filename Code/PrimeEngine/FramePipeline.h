@@ -0,0 +1,90 @@
+#ifndef __PYENGINE_2_0_FRAME_PIPELINE_H__
+#define __PYENGINE_2_0_FRAME_PIPELINE_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/APIAbstraction/Threading/Threading.h"
+#include "PrimeEngine/APIAbstraction/Timer/Timer.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+// Fences between game thread (producer of frames) and render thread (consumer).
+// Every frame has its own slot of per frame data (draw lists, debug meshes..) out of PE_NUM_FRAMES_IN_FLIGHT.
+// Game thread waits for the fence of a slot only before it starts gathering into it,
+// so it waits only when render thread is PE_NUM_FRAMES_IN_FLIGHT - 1 frames behind.
+struct FramePipeline
+{
+	static const PrimitiveTypes::UInt32 c_numStatsFrames = 60;
+
+	// averaged over last c_numStatsFrames submitted frames
+	struct Stats
+	{
+		PrimitiveTypes::UInt32 m_numFrames;
+		PrimitiveTypes::Float32 m_gameWaitTime; // in waitForFreeSlot()
+		PrimitiveTypes::Float32 m_renderWaitTime; // in beginRenderFrame()
+		PrimitiveTypes::Float32 m_avgFramesInFlight; // sampled at submit
+	};
+
+	FramePipeline();
+
+	// game thread -------------------------------------------------------------
+
+	// fence: blocks until render thread is done with the frame that used the slot of the next frame.
+	// returns seconds waited
+	float waitForFreeSlot();
+
+	// frame in current slot is complete, wakes render thread
+	void submitFrame();
+
+	// blocks until render thread is done with all submitted frames
+	void waitForAllFrames();
+
+	// render thread exits after the frame it is drawing now
+	void requestExit();
+
+	// render thread ----------------------------------------------------------
+
+	// blocks until there is a submitted frame. false if render thread should exit
+	bool beginRenderFrame();
+
+	// frees the slot of the frame that was just drawn, wakes game thread
+	void endRenderFrame();
+
+	// ------------------------------------------------------------------------
+
+	PrimitiveTypes::UInt32 getNumFramesInFlight();
+
+	Stats getLastStats();
+
+private:
+	Threading::Mutex m_lock;
+	Threading::ConditionVariable m_frameSubmittedCV; // render thread sleeps on this
+	Threading::ConditionVariable m_frameRenderedCV; // game thread sleeps on this
+
+	// frame counters, protected by m_lock. slot of frame is counter % PE_NUM_FRAMES_IN_FLIGHT
+	PrimitiveTypes::UInt32 m_numSubmittedFrames;
+	PrimitiveTypes::UInt32 m_numRenderedFrames;
+	bool m_exitRequested;
+
+	// accumulated since last stats, protected by m_lock
+	double m_gameWaitTime;
+	double m_renderWaitTime;
+	PrimitiveTypes::UInt32 m_numFramesInFlightSum;
+	PrimitiveTypes::UInt32 m_numStatsFrames;
+	Stats m_lastStats;
+};
+
+extern FramePipeline g_framePipeline;
+
+}; // namespace PE
+
+#endif
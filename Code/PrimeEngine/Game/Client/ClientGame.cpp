@@ -7,6 +7,7 @@
 #include "PrimeEngine/GameThreadJob.h"
 #include "PrimeEngine/Application/Application.h"
 #include "PrimeEngine/APIAbstraction/Effect/PEDepthStencilState.h"
+#include "PrimeEngine/Profiling/Telemetry.h"
 
 #if APIABSTRACTION_PS3
 #include <cell/sysmodule.h>
@@ -33,8 +34,6 @@ using namespace Events;
 
 	// gloabl vars
 	volatile bool g_drawThreadInitialized;
-	volatile bool g_drawThreadCanStart;
-	volatile bool g_drawThreadShouldExit;
 	volatile bool g_drawThreadExited;
 
 	volatile bool g_gameThreadInitialized;
@@ -48,14 +47,12 @@ using namespace Events;
 	Threading::Mutex g_gameThreadInitializationLock;
 	Threading::ConditionVariable g_gameThreadInitializedCV(g_gameThreadInitializationLock);
 	
-	Threading::Mutex g_drawThreadLock;
-	Threading::ConditionVariable g_drawCanStartCV(g_drawThreadLock);
-
 	Threading::PEThread g_drawThread, g_gameThread;
 
 namespace Components {
 	int ClientGame::initEngine(GameContext &context, PE::MemoryArena arena, EngineInitParams &engineParams)
 {
+	AsyncLog::Start(PE_LOG_BINARY_FILE); // messages of all threads go through log thread from now on
     PEINFO("PYENGINE LAUNCHING\n");
     
 #if PE_PLAT_IS_PSVITA
@@ -105,6 +102,9 @@ namespace Components {
 	Handle handle("LUA_COMPONENT", sizeof(ClientLuaEnvironment));
 	context.m_pLuaEnv = new(handle) ClientLuaEnvironment(context, PE::MemoryArena_Client, handle);
 	context.getLuaEnvironment()->registerInitialLibrariesFunctions();
+	#if PE_LUA_PROFILER
+	context.getLuaEnvironment()->m_profiler.start(context.getLuaEnvironment()->L, PE_LUA_PROFILER_INSTRUCTIONS_PER_SAMPLE);
+	#endif
 	// non component classes that need to register..
 	MaterialCPU::SetLuaFunctions(context.getLuaEnvironment(), context.getLuaEnvironment()->L);
 	context.getLuaEnvironment()->run();
@@ -176,6 +176,7 @@ namespace Components {
     Events::EventQueueManager::Construct(context, PE::MemoryArena_Client);
     
 	SamplerStateManager::ConstructAndInitialize(context, arena);
+	RenderStateCache::Construct(arena); // state managers share state objects through it
 	PERasterizerStateManager::ConstructAndInitialize(context, arena);
     PEAlphaBlendStateManager::ConstructAndInitialize(context, arena);
     PEDepthStencilStateManager::ConstructAndInitialize(context, arena);
@@ -207,6 +208,8 @@ namespace Components {
     DrawList::Construct(context, MemoryArena_Client);
     
     RootSceneNode::Construct(context, MemoryArena_Client);
+	LightClusters::Construct(context, MemoryArena_Client); // RootSceneNode bins its lights with it every frame
+	TextBatcher::Construct(context, MemoryArena_Client); // DebugRenderer draws its text with it
 	DebugRenderer::Construct(context, MemoryArena_Client);
 	CameraManager::Construct(context, MemoryArena_Client);
 	PhysicsManager::Construct(context, MemoryArena_Client);
@@ -214,6 +217,19 @@ namespace Components {
     // initialize timer functionality
     Timer::Initialize();
 
+	// worker pool is shared with server context, constructed by whichever context starts first
+	JobSystem::Construct(MemoryArena_Client);
+
+	#if PE_ENABLE_TELEMETRY
+		Telemetry::Construct(context, MemoryArena_Client);
+	#endif
+
+	#if PE_HOT_RELOAD
+		// watcher thread reloads scripts and assets edited while the game runs
+		HotReloadManager::Construct(context, MemoryArena_Client);
+		HotReloadManager::Instance()->start();
+	#endif
+
 	context.getGameObjectManager()->addComponent(context.getNetworkManager()->getHandle());
 
 	context.getNetworkManager()->initNetwork();
@@ -260,14 +276,12 @@ int ClientGame::runGame()
     	#if PYENGINE_2_0_MULTI_THREADED
 	{
 		g_drawThreadInitialized = false;
-		g_drawThreadCanStart = false;
-		g_drawThreadShouldExit = false;
 	
 		g_drawThreadInitializationLock.lock();// lock the rendering thread initialization lock
 		
 		g_drawThread.m_function = drawThreadFunctionJob;
 		g_drawThread.m_pParams = m_pContext;
-		g_drawThread.run(); // thread will wait on rendering thread lock
+		g_drawThread.run(); // thread will wait for first frame in g_framePipeline
 
 		
 		while (!g_drawThreadInitialized)
@@ -277,7 +291,7 @@ int ClientGame::runGame()
 			assert(success);
 		}
 
-		// draw thread now initialized and will sleep on renderThreadLock
+		// draw thread now initialized and will sleep until first frame is submitted
 	}
 	#endif
     
@@ -286,6 +300,16 @@ int ClientGame::runGame()
         runGameFrame();
     } // while (runGame) -- game loop
 
+	if (HotReloadManager::Instance())
+		HotReloadManager::Instance()->stop();
+	#if PE_LUA_PROFILER
+	{
+		char profilePath[256];
+		StringOps::concat(m_pContext->getMainFunctionArgs()->gameProjRoot(), "LuaProfile", profilePath, 256);
+		m_pContext->getLuaEnvironment()->m_profiler.writeReport(profilePath);
+	}
+	#endif
+	AsyncLog::Stop();
 	return 0;
 }
 
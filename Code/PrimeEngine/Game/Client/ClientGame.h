@@ -19,8 +19,6 @@ extern int TestExternIntVar;
 
 namespace PE {
 	extern volatile bool g_drawThreadInitialized;
-	extern volatile bool g_drawThreadCanStart;
-	extern volatile bool g_drawThreadShouldExit;
 	extern volatile bool g_drawThreadExited;
 
 	extern volatile bool g_gameThreadInitialized;
@@ -35,9 +33,6 @@ namespace PE {
 	extern Threading::Mutex g_gameThreadInitializationLock;
 	extern Threading::ConditionVariable g_gameThreadInitializedCV;
 	
-	extern Threading::Mutex g_drawThreadLock;
-	extern Threading::ConditionVariable g_drawCanStartCV;
-	
 	extern Threading::PEThread g_drawThread, g_gameThread;
 
     namespace Components {
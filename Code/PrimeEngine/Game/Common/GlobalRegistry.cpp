@@ -34,6 +34,7 @@ void Register(PE::Components::LuaEnvironment *pLuaEnv, PE::GlobalRegistry *pRegi
 						PE::Components::Camera::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
 					PE::Components::StreamManager::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
 					PE::Components::EventManager::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
+					PE::Components::GhostManager::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
 					PE::Components::Input::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
 					PE::Components::DefaultGameControls::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
 					PE::Components::DrawList::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
@@ -194,6 +195,7 @@ void Register(PE::Components::LuaEnvironment *pLuaEnv, PE::GlobalRegistry *pRegi
 					PE::Events::Event_KEY_UP_HELD::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
 
 					PE::Events::Event_SERVER_CLIENT_CONNECTION_ACK::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
+					PE::Events::Event_SERVER_CLIENT_DISCONNECTED::InitializeAndRegister(pLuaEnv, pRegistry, setLuaMetaDataOnly);
 
 			}
 			// end root.PE.Events
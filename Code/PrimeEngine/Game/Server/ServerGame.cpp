@@ -5,6 +5,14 @@
 
 #include "PrimeEngine/RenderJob.h"
 
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+#if PE_PLAT_IS_WIN32
+#include <mmsystem.h> // timeBeginPeriod
+#elif PE_PLAT_IS_LINUX
+#include <signal.h>
+#endif
+
 #if APIABSTRACTION_PS3
 #include <cell/sysmodule.h>
 #include <sys/process.h>
@@ -31,6 +39,10 @@ namespace Components {
 
 	m_frameTime = 0;
 	m_gameTime = 0;
+
+	m_tickRate = PE_SERVER_TICK_RATE;
+	memset(&m_tickStats, 0, sizeof(m_tickStats));
+	memset(&m_lastTickStats, 0, sizeof(m_lastTickStats));
 }
 
 ServerGame::~ServerGame()
@@ -41,6 +53,7 @@ ServerGame::~ServerGame()
 
 int ServerGame::initEngine(GameContext &context, PE::MemoryArena arena, EngineInitParams &engineParams)
 {
+	AsyncLog::Start(PE_LOG_BINARY_FILE); // no-op if client started it
 	PEINFO("Server: ServerGame::initEngine()\n");
 
 	#if PE_PLAT_IS_WIN32
@@ -84,6 +97,9 @@ int ServerGame::initEngine(GameContext &context, PE::MemoryArena arena, EngineIn
 
 	PEINFO("PROGRESS: GameObjectManager Constructed\n");
 
+	// shared with client context if there is one
+	JobSystem::Construct(arena);
+
 	context.getGameObjectManager()->addComponent(context.getNetworkManager()->getHandle());
 
 	context.getNetworkManager()->initNetwork();
@@ -108,21 +124,121 @@ int ServerGame::runGame()
 	return 1;
 }
 
+#if PE_PLAT_IS_LINUX
+static void serverStopSignalHandler(int)
+{
+	// loop exits after current tick
+	ServerGame *pGame = ServerGlobalGameCallbacks::getGameInstance();
+	if (pGame)
+		pGame->m_runGame = false;
+}
+#endif
+
+int ServerGame::runGameOnThisThread()
+{
+	m_runGame = true;
+
+#if PE_PLAT_IS_LINUX
+	signal(SIGINT, serverStopSignalHandler);
+	signal(SIGTERM, serverStopSignalHandler);
+#endif
+
+	ServerThread(this);
+	return 1;
+}
+
+void ServerGame::setTickRate(int tickRate)
+{
+	PEASSERT(tickRate > 0, "Tick rate has to be positive");
+	m_tickRate = tickRate;
+}
+
 void ServerGame::ServerThread(void *params)
 {
 	ServerGame *pServerGame = (ServerGame*)(params);
+	Timer *pTimer = pServerGame->m_pTimer;
+
+#if PE_PLAT_IS_WIN32
+	timeBeginPeriod(1); // default sleep granularity is 15.6ms
+#endif
+
+	// seconds since start. accumulated from small deltas so that float precision of timer doesn't matter
+	double now = 0;
+	double nextTickTime = 0;
+	double nextReportTime = PE_SERVER_TICK_REPORT_INTERVAL;
+	pTimer->Tick();
+
 	while(pServerGame->m_runGame)
 	{
-		pServerGame->runGameFrame();
+		double tickInterval = 1.0 / (double)(pServerGame->m_tickRate);
+		TickStats &stats = pServerGame->m_tickStats;
+
+		double timeLeft = nextTickTime - now;
+		if (timeLeft > 0)
+		{
+			// os sleep overshoots, so sleep only until close to tick and yield the rest
+			if (timeLeft > PE_SERVER_SLEEP_MARGIN)
+				Threading::SleepMilliseconds((unsigned int)((timeLeft - PE_SERVER_SLEEP_MARGIN) * 1000.0));
+			else
+				Threading::SleepMilliseconds(0);
+
+			float idle = pTimer->TickAndGetTimeDeltaInSeconds();
+			now += idle;
+			stats.m_idleTime += idle;
+			continue;
+		}
+
+		for (int step = 0; step < PE_SERVER_MAX_CATCH_UP_TICKS && now >= nextTickTime; ++step)
+		{
+			pServerGame->m_frameTime = (PrimitiveTypes::Float32)(tickInterval);
+			pServerGame->runGameFrame();
+
+			float cpu = pTimer->TickAndGetTimeDeltaInSeconds();
+			now += cpu;
+			stats.m_numTicks++;
+			stats.m_cpuTime += cpu;
+			if (cpu > stats.m_maxTickCpuTime)
+				stats.m_maxTickCpuTime = cpu;
+			if (step)
+				stats.m_numCatchUpTicks++;
+
+			nextTickTime += tickInterval;
+		}
+
+		if (now >= nextTickTime)
+		{
+			// too far behind (long tick, debugger, machine overloaded). drop missed ticks instead of spiraling
+			int numSkipped = (int)((now - nextTickTime) / tickInterval) + 1;
+			stats.m_numSkippedTicks += numSkipped;
+			nextTickTime += numSkipped * tickInterval;
+		}
+
+		if (now >= nextReportTime)
+		{
+			double interval = now - nextReportTime + PE_SERVER_TICK_REPORT_INTERVAL;
+			PEINFO("Server: %d ticks at %d Hz: cpu avg %.2f ms max %.2f ms, idle %.1f%%, %d catch up, %d skipped\n",
+				stats.m_numTicks, pServerGame->m_tickRate,
+				stats.m_numTicks ? stats.m_cpuTime * 1000.0 / stats.m_numTicks : 0.0, stats.m_maxTickCpuTime * 1000.0,
+				stats.m_idleTime * 100.0 / interval, stats.m_numCatchUpTicks, stats.m_numSkippedTicks);
+
+			pServerGame->m_lastTickStats = stats;
+			memset(&stats, 0, sizeof(stats));
+			nextReportTime = now + PE_SERVER_TICK_REPORT_INTERVAL;
+		}
 	} // while (runGame) -- game loop
 
+#if PE_PLAT_IS_WIN32
+	timeEndPeriod(1);
+#endif
+
+	AsyncLog::Stop();
+
 	return;
 }
 
 int ServerGame::runGameFrame()
 {
-	//m_frameTime = m_pTimer->TickAndGetTimeDeltaInSeconds();
-	
+	// m_frameTime is fixed tick interval, set by ServerThread()
 	m_gameTime += m_frameTime;
 
 	Event_UPDATE updateEvent;
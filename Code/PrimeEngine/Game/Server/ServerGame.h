@@ -90,8 +90,18 @@ namespace PE {
 			~ServerGame();
 
 			static int initEngine(GameContext &context, PE::MemoryArena arena, EngineInitParams &engineParams);
+
+			// runs runGameFrame() at fixed tick rate with m_frameTime = 1 / tick rate.
+			// sleeps between ticks, if late runs up to PE_SERVER_MAX_CATCH_UP_TICKS ticks back to back and skips the rest
 			static void ServerThread(void *params);
 
+			// runs ServerThread() on calling thread until m_runGame is cleared.
+			// used by headless builds that have no client game loop to keep the process alive
+			int runGameOnThisThread();
+
+			// ticks per second. can be changed while running
+			void setTickRate(int tickRate);
+
             virtual int initGame();
             virtual int runGame();
             virtual int runGameFrame();
@@ -113,6 +123,20 @@ namespace PE {
             PrimitiveTypes::Float32 m_gameTime;
             PrimitiveTypes::Bool m_runGame;
 
+			int m_tickRate;
+
+			struct TickStats
+			{
+				int m_numTicks;
+				int m_numCatchUpTicks; // ran late, right after previous tick
+				int m_numSkippedTicks; // too late to catch up
+				double m_cpuTime; // seconds spent in runGameFrame()
+				double m_maxTickCpuTime;
+				double m_idleTime; // seconds spent sleeping/yielding
+			};
+			TickStats m_tickStats; // current report interval
+			TickStats m_lastTickStats; // last complete report interval (PE_SERVER_TICK_REPORT_INTERVAL), for display
+
 			Threading::PEThread m_thread;
 			static GameContext s_context;
         };
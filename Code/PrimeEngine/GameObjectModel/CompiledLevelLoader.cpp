@@ -0,0 +1,299 @@
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdio.h>
+#include <stdlib.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Lua/LuaEnvironment.h"
+#include "PrimeEngine/Events/StandardEvents.h"
+#include "PrimeEngine/Scene/MeshManager.h"
+#include "PrimeEngine/Render/IRenderer.h"
+#include "PrimeEngine/Utils/StringOps.h"
+#include "PrimeEngine/Utils/PEString.h"
+
+// Sibling/Children includes
+#include "CompiledLevelLoader.h"
+#include "GameObjectManager.h"
+
+namespace PE {
+
+using namespace PE::Components;
+using namespace PE::Events;
+
+namespace {
+
+// same scale that Event_CREATE_*::l_Construct() applies to positions coming from Lua
+const float kPositionFactor = 1.0f / 100.0f;
+
+void readBase(const CompiledLevelRecord &rec, Vector3 &pos, Vector3 &u, Vector3 &v, Vector3 &n)
+{
+	const PrimitiveTypes::Float32 *m = rec.m_matrix;
+	u = Vector3(m[0], m[1], m[2]);
+	v = Vector3(m[4], m[5], m[6]);
+	n = Vector3(m[8], m[9], m[10]);
+	pos = Vector3(m[12] * kPositionFactor, m[13] * kPositionFactor, m[14] * kPositionFactor);
+}
+
+// loads asset through MeshManager unless it is cached already. returns true if a load actually happened
+bool preloadAsset(PE::GameContext &context, const char *asset, const char *package, int &threadOwnershipMask)
+{
+	if (!asset[0])
+		return false;
+
+	char key[StrTPair<Handle>::StrSize];
+	sprintf(key, "%s/%s", package, asset);
+	if (context.getMeshManager()->m_assets.findIndex(key) != -1)
+		return false;
+
+	context.getMeshManager()->getAsset(asset, package, threadOwnershipMask);
+	return true;
+}
+
+// every string offset of record is inside string table, type is known
+bool recordIsValid(const CompiledLevelRecord &rec, PrimitiveTypes::UInt32 stringTableSize)
+{
+	if (rec.m_type > CompiledLevelRecordType_Script)
+		return false;
+
+	const PrimitiveTypes::UInt32 offsets[] = {
+		rec.m_name, rec.m_meshName, rec.m_meshPackage, rec.m_skelName, rec.m_skelPackage,
+		rec.m_animSetName, rec.m_animSetPackage, rec.m_metaScript, rec.m_metaScriptPackage,
+	};
+	for (PrimitiveTypes::UInt32 i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i)
+	{
+		if (offsets[i] >= stringTableSize)
+			return false;
+	}
+	return true;
+}
+
+// size and FNV-1a hash of file, same as levelcompiler.py writes. false if it can't be read
+bool hashSourceFile(const char *filename, PrimitiveTypes::UInt32 &size, PrimitiveTypes::UInt32 &hash)
+{
+	FILE *f = fopen(filename, "rb");
+	if (!f)
+		return false;
+
+	size = 0;
+	hash = 2166136261u;
+	unsigned char buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+	{
+		for (size_t i = 0; i < n; ++i)
+			hash = (hash ^ buf[i]) * 16777619u;
+		size += (PrimitiveTypes::UInt32)(n);
+	}
+	fclose(f);
+	return true;
+}
+
+}; // anonymous namespace
+
+bool CompiledLevelLoader::loadLevel(PE::GameContext &context, const char *filename, const char *sourceFilename)
+{
+	FILE *f = fopen(filename, "rb");
+	if (!f)
+		return false;
+
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	if (size < (long)(sizeof(CompiledLevelHeader)))
+	{
+		fclose(f);
+		return false;
+	}
+
+	// whole level is read in one go, records and string table are used in place
+	char *pData = (char *)malloc(size);
+	size_t read = fread(pData, 1, size, f);
+	fclose(f);
+
+	const CompiledLevelHeader *pHeader = (const CompiledLevelHeader *)(pData);
+	// counts are checked against file size first so that huge counts of a corrupt header can't wrap around
+	PrimitiveTypes::UInt32 bodySize = (PrimitiveTypes::UInt32)(size) - sizeof(CompiledLevelHeader);
+	bool sizeValid = pHeader->m_numRecords <= bodySize / sizeof(CompiledLevelRecord);
+	PrimitiveTypes::UInt32 restSize = sizeValid ? bodySize - pHeader->m_numRecords * sizeof(CompiledLevelRecord) : 0;
+	sizeValid = sizeValid && pHeader->m_numDependencies <= restSize / sizeof(CompiledLevelDependency)
+		&& pHeader->m_stringTableSize == restSize - pHeader->m_numDependencies * sizeof(CompiledLevelDependency);
+
+	if (read != (size_t)(size) || pHeader->m_magic != PE_COMPILED_LEVEL_MAGIC
+		|| pHeader->m_version != PE_COMPILED_LEVEL_VERSION || !sizeValid)
+	{
+		PEINFO("PE::Warning:: %s is not a valid compiled level (version %d expected). Recompile with levelcompiler.py", filename, PE_COMPILED_LEVEL_VERSION);
+		free(pData);
+		return false;
+	}
+
+	const CompiledLevelRecord *pRecords = (const CompiledLevelRecord *)(pData + sizeof(CompiledLevelHeader));
+	const CompiledLevelDependency *pDependencies = (const CompiledLevelDependency *)(pRecords + pHeader->m_numRecords);
+	const char *pStrings = (const char *)(pDependencies + pHeader->m_numDependencies);
+
+	// strings are used in place: table has to start with the empty string and end with a terminator,
+	// and every offset has to be inside it
+	bool stringsValid = pHeader->m_stringTableSize > 0 && pStrings[0] == '\0' && pStrings[pHeader->m_stringTableSize - 1] == '\0';
+	for (PrimitiveTypes::UInt32 i = 0; stringsValid && i < pHeader->m_numRecords; ++i)
+		stringsValid = recordIsValid(pRecords[i], pHeader->m_stringTableSize);
+	for (PrimitiveTypes::UInt32 i = 0; stringsValid && i < pHeader->m_numDependencies; ++i)
+		stringsValid = pDependencies[i].m_name < pHeader->m_stringTableSize && pDependencies[i].m_package < pHeader->m_stringTableSize;
+	if (!stringsValid)
+	{
+		PEINFO("PE::Warning:: %s is corrupt (bad record or string table). Recompile with levelcompiler.py", filename);
+		free(pData);
+		return false;
+	}
+
+	PrimitiveTypes::UInt32 sourceSize, sourceHash;
+	if (sourceFilename && hashSourceFile(sourceFilename, sourceSize, sourceHash)
+		&& (sourceSize != pHeader->m_sourceSize || sourceHash != pHeader->m_sourceHash))
+	{
+		PEINFO("PE::Warning:: %s was compiled from a different version of %s. Recompile with levelcompiler.py", filename, sourceFilename);
+		free(pData);
+		return false;
+	}
+
+	// meta scripts that were flattened into records
+	for (PrimitiveTypes::UInt32 i = 0; i < pHeader->m_numDependencies; ++i)
+	{
+		const CompiledLevelDependency &dep = pDependencies[i];
+		char path[512];
+		PEString::generatePathname(context, &pStrings[dep.m_name], &pStrings[dep.m_package], "Levels", path, 512);
+		if (!hashSourceFile(path, sourceSize, sourceHash) || sourceSize != dep.m_size || sourceHash != dep.m_hash)
+		{
+			PEINFO("PE::Warning:: %s was compiled from a different version of %s. Recompile with levelcompiler.py", filename, path);
+			free(pData);
+			return false;
+		}
+	}
+
+	int &threadOwnershipMask = context.m_gameThreadThreadOwnershipMask;
+
+	// pass 1: load every unique mesh and skeleton while holding the render context once.
+	// textures and materials are shared through the mesh, so they get deduplicated together with it.
+	// object creation below then only hits the MeshManager cache
+	PrimitiveTypes::UInt32 numLoaded = 0;
+	context.getGPUScreen()->AcquireRenderContextOwnership(threadOwnershipMask);
+	for (PrimitiveTypes::UInt32 i = 0; i < pHeader->m_numRecords; ++i)
+	{
+		const CompiledLevelRecord &rec = pRecords[i];
+		if (rec.m_type == CompiledLevelRecordType_Skin)
+			numLoaded += preloadAsset(context, &pStrings[rec.m_skelName], &pStrings[rec.m_skelPackage], threadOwnershipMask) ? 1 : 0;
+
+		if (rec.m_type == CompiledLevelRecordType_StaticMesh || rec.m_type == CompiledLevelRecordType_Skin)
+			numLoaded += preloadAsset(context, &pStrings[rec.m_meshName], &pStrings[rec.m_meshPackage], threadOwnershipMask) ? 1 : 0;
+	}
+	context.getGPUScreen()->ReleaseRenderContextOwnership(threadOwnershipMask);
+
+	// pass 2: create objects in file order (skins rely on GameObjectManager::m_lastAddedSkelInstanceHandle)
+	PrimitiveTypes::UInt32 numScripted = 0;
+	for (PrimitiveTypes::UInt32 i = 0; i < pHeader->m_numRecords; ++i)
+	{
+		const CompiledLevelRecord &rec = pRecords[i];
+		if (rec.m_type == CompiledLevelRecordType_Script)
+		{
+			runScriptedObject(context, rec, pStrings);
+			++numScripted;
+		}
+		else
+		{
+			createObject(context, rec, pStrings);
+		}
+	}
+
+	PEINFO("PE::Progress:: Loaded compiled level %s: %d objects (%d scripted), %d unique assets loaded",
+		filename, pHeader->m_numRecords, numScripted, numLoaded);
+
+	free(pData);
+	return true;
+}
+
+void CompiledLevelLoader::createObject(PE::GameContext &context, const CompiledLevelRecord &rec, const char *pStrings)
+{
+	GameObjectManager *pGOM = context.getGameObjectManager();
+
+	PEUUID peuuid;
+	peuuid.set(rec.m_peuuid[0], rec.m_peuuid[1], rec.m_peuuid[2], rec.m_peuuid[3]);
+
+	Vector3 pos, u, v, n;
+	readBase(rec, pos, u, v, n);
+
+	if (rec.m_type == CompiledLevelRecordType_Light)
+	{
+		Event_CREATE_LIGHT evt;
+		evt.m_pos = pos; evt.m_u = u; evt.m_v = v; evt.m_n = n;
+		evt.m_diffuse = Vector4(rec.m_diffuse[0], rec.m_diffuse[1], rec.m_diffuse[2], rec.m_diffuse[3]);
+		evt.m_spec = Vector4(rec.m_spec[0], rec.m_spec[1], rec.m_spec[2], rec.m_spec[3]);
+		evt.m_ambient = Vector4(rec.m_ambient[0], rec.m_ambient[1], rec.m_ambient[2], rec.m_ambient[3]);
+		evt.m_att = Vector3(rec.m_attenuation[0], rec.m_attenuation[1], rec.m_attenuation[2]);
+		evt.m_spotPower = rec.m_spotPower;
+		evt.m_range = rec.m_range;
+		evt.m_isShadowCaster = rec.m_isShadowCaster != 0;
+		evt.m_type = (float)(rec.m_lightType);
+		evt.m_peuuid = peuuid;
+		pGOM->handleEvent(&evt);
+		return;
+	}
+
+	if (rec.m_type == CompiledLevelRecordType_Skin)
+	{
+		Event_CREATE_SKELETON evt(context.m_gameThreadThreadOwnershipMask);
+		StringOps::writeToString(&pStrings[rec.m_skelName], evt.m_skelFilename, 255);
+		StringOps::writeToString(&pStrings[rec.m_skelPackage], evt.m_package, 255);
+		evt.m_pos = pos; evt.m_u = u; evt.m_v = v; evt.m_n = n;
+		evt.hasCustomOrientation = true;
+		evt.m_peuuid = peuuid;
+		pGOM->handleEvent(&evt);
+	}
+
+	{
+		Event_CREATE_MESH evt(context.m_gameThreadThreadOwnershipMask);
+		StringOps::writeToString(&pStrings[rec.m_meshName], evt.m_meshFilename, 255);
+		StringOps::writeToString(&pStrings[rec.m_meshPackage], evt.m_package, 255);
+		evt.m_pos = pos; evt.m_u = u; evt.m_v = v; evt.m_n = n;
+		evt.hasCustomOrientation = true;
+		evt.m_peuuid = peuuid;
+		pGOM->handleEvent(&evt);
+	}
+
+	if (rec.m_type == CompiledLevelRecordType_Skin)
+	{
+		Event_CREATE_ANIM_SET evt(context.m_gameThreadThreadOwnershipMask);
+		StringOps::writeToString(&pStrings[rec.m_animSetName], evt.animSetFilename, 255);
+		StringOps::writeToString(&pStrings[rec.m_animSetPackage], evt.m_package, 255);
+		evt.m_peuuid = peuuid;
+		pGOM->handleEvent(&evt);
+
+		if (rec.m_defaultAnimSet >= 0 && rec.m_defaultAnim >= 0)
+		{
+			// same as Skin.lua: default animation goes to the last added game object
+			Event_PLAY_ANIMATION playEvt;
+			playEvt.m_animSetIndex = rec.m_defaultAnimSet;
+			playEvt.m_animIndex = rec.m_defaultAnim;
+			if (pGOM->m_lastAddedObjHandle.isValid())
+				pGOM->m_lastAddedObjHandle.getObject<Component>()->handleEvent(&playEvt);
+		}
+	}
+}
+
+void CompiledLevelLoader::runScriptedObject(PE::GameContext &context, const CompiledLevelRecord &rec, const char *pStrings)
+{
+	// custom objects keep going through LevelLoader.CreateGameObject() with the same arguments .levela would pass
+	LuaEnvironment *pLuaEnv = context.getLuaEnvironment();
+	pLuaEnv->prepModuleFunctionCall("LevelLoader", "CreateGameObject");
+
+	pLuaEnv->pushString(&pStrings[rec.m_name]);
+	for (int i = 0; i < 16; ++i)
+		pLuaEnv->pushNumber(rec.m_matrix[i]);
+	pLuaEnv->pushString(&pStrings[rec.m_metaScript]);
+	pLuaEnv->pushString(&pStrings[rec.m_metaScriptPackage]);
+	for (int i = 0; i < 4; ++i)
+		pLuaEnv->pushNumber(rec.m_peuuid[i]);
+
+	pLuaEnv->callPreparedFunction(1 + 16 + 2 + 4, 0, 0);
+}
+
+}; // namespace PE
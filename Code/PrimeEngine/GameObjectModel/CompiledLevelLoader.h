@@ -0,0 +1,107 @@
+#ifndef __PYENGINE_2_0_COMPILEDLEVELLOADER_H__
+#define __PYENGINE_2_0_COMPILEDLEVELLOADER_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Game/Common/GameContext.h"
+
+// Sibling/Children includes
+
+// Compiled level (.levelb) format, produced by Tools/LevelCompiler/levelcompiler.py from a .levela
+// and the meta scripts it references. All values are little endian 32 bit.
+//
+// [CompiledLevelHeader][CompiledLevelRecord x m_numRecords][CompiledLevelDependency x m_numDependencies]
+// [string table of m_stringTableSize bytes]
+//
+// Strings are stored as offsets into the string table (null terminated). Offset 0 is always the empty string.
+// Header keeps size and FNV-1a hash of the .levela bytes it was compiled from and dependencies keep them for
+// every meta script that was read. A compiled level whose .levela or any of these meta scripts changed since
+// is not loaded.
+// Objects whose meta script resolves to StaticMesh.lua, Skin.lua or LightSource.lua are flattened into
+// native records. Anything else (custom game scripts, 'Raw' meta scripts) is stored as a Script record
+// and still goes through LevelLoader.CreateGameObject() in Lua.
+
+#define PE_COMPILED_LEVEL_MAGIC 0x424C4550 // 'PELB'
+#define PE_COMPILED_LEVEL_VERSION 3
+
+namespace PE {
+
+enum CompiledLevelRecordType
+{
+	CompiledLevelRecordType_StaticMesh = 0,
+	CompiledLevelRecordType_Skin = 1,
+	CompiledLevelRecordType_Light = 2,
+	CompiledLevelRecordType_Script = 3,
+};
+
+struct CompiledLevelHeader
+{
+	PrimitiveTypes::UInt32 m_magic;
+	PrimitiveTypes::UInt32 m_version;
+	PrimitiveTypes::UInt32 m_numRecords;
+	PrimitiveTypes::UInt32 m_stringTableSize;
+	PrimitiveTypes::UInt32 m_sourceSize; // of .levela
+	PrimitiveTypes::UInt32 m_sourceHash; // FNV-1a of .levela
+	PrimitiveTypes::UInt32 m_numDependencies;
+};
+
+// meta script records were flattened from: AssetsOut/<m_package>/Levels/<m_name>
+struct CompiledLevelDependency
+{
+	PrimitiveTypes::UInt32 m_name, m_package;
+	PrimitiveTypes::UInt32 m_size;
+	PrimitiveTypes::UInt32 m_hash; // FNV-1a
+};
+
+struct CompiledLevelRecord
+{
+	PrimitiveTypes::UInt32 m_type; // CompiledLevelRecordType
+	PrimitiveTypes::UInt32 m_name;
+
+	// matrix in the same order it is written to .levela: m00, m10, m20, m30, m01, ... m03, m13, m23, m33
+	PrimitiveTypes::Float32 m_matrix[16];
+	PrimitiveTypes::UInt32 m_peuuid[4];
+
+	// StaticMesh, Skin
+	PrimitiveTypes::UInt32 m_meshName, m_meshPackage;
+	// Skin
+	PrimitiveTypes::UInt32 m_skelName, m_skelPackage;
+	PrimitiveTypes::UInt32 m_animSetName, m_animSetPackage;
+	PrimitiveTypes::Int32 m_defaultAnimSet, m_defaultAnim; // -1 if no default animation
+
+	// Light
+	PrimitiveTypes::UInt32 m_lightType; // 0 = point, 1 = directional, 2 = spot
+	PrimitiveTypes::UInt32 m_isShadowCaster;
+	PrimitiveTypes::Float32 m_diffuse[4];
+	PrimitiveTypes::Float32 m_spec[4];
+	PrimitiveTypes::Float32 m_ambient[4];
+	PrimitiveTypes::Float32 m_attenuation[3];
+	PrimitiveTypes::Float32 m_spotPower;
+	PrimitiveTypes::Float32 m_range;
+
+	// Script: meta script passed to LevelLoader.CreateGameObject()
+	PrimitiveTypes::UInt32 m_metaScript, m_metaScriptPackage;
+};
+
+struct CompiledLevelLoader
+{
+	// loads a compiled level in one read. returns false if the file does not exist, is not a valid
+	// compiled level or was compiled from a different sourceFilename (.levela) or meta scripts than the ones
+	// on disk, so that the caller can fall back to running the .levela script. no check of .levela if
+	// sourceFilename can't be read, a meta script that can't be read any more is a change
+	static bool loadLevel(PE::GameContext &context, const char *filename, const char *sourceFilename);
+
+private:
+	static void createObject(PE::GameContext &context, const CompiledLevelRecord &rec, const char *pStrings);
+	static void runScriptedObject(PE::GameContext &context, const CompiledLevelRecord &rec, const char *pStrings);
+};
+
+}; // namespace PE
+
+#endif
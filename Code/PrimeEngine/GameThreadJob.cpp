@@ -3,6 +3,12 @@
 #include "RenderJob.h"
 
 #include "PrimeEngine/Scene/DrawList.h"
+#include "PrimeEngine/Scene/SH_DRAW.h"
+#include "PrimeEngine/APIAbstraction/Texture/TextureResidencyManager.h"
+#include "PrimeEngine/Profiling/Telemetry.h"
+#include "PrimeEngine/Jobs/JobSystem.h"
+#include "PrimeEngine/FileSystem/HotReloadManager.h"
+#include "FramePipeline.h"
 
 #if APIABSTRACTION_IOS
 #import <QuartzCore/QuartzCore.h>
@@ -52,6 +58,7 @@ int ClientGame::runGameFrame()
     float gameThreadPreDrawFrameTime = 0;
 	float gameThreadDrawFrameTime = 0;
 	float gameThreadDrawWaitFrameTime = 0;
+	bool haveFrameSlot = false; // draw lists of this frame are free to be gathered into
 
 	// cache root scene node pointer
     RootSceneNode *proot = RootSceneNode::Instance();
@@ -65,6 +72,22 @@ int ClientGame::runGameFrame()
     
     // CLOSED_WINDOW event will be pushed into global event queue if user closes window after this call
     m_pContext->getApplication()->processOSEventsIntoGlobalEventQueue();
+
+#if PE_HOT_RELOAD
+    // swap in scripts and assets changed on disk before anything in this frame uses them
+    bool reloadsReplaceGPUResources = false;
+    if (HotReloadManager::Instance() && HotReloadManager::Instance()->hasReadyReloads(reloadsReplaceGPUResources))
+    {
+        #if PYENGINE_2_0_MULTI_THREADED
+        // draw lists in flight may use gpu buffers and textures the reloads release
+        if (reloadsReplaceGPUResources)
+            g_framePipeline.waitForAllFrames();
+        #endif
+        m_pContext->getGPUScreen()->AcquireRenderContextOwnership(m_pContext->m_gameThreadThreadOwnershipMask);
+        HotReloadManager::Instance()->applyReadyReloads_needsRC(m_pContext->m_gameThreadThreadOwnershipMask);
+        m_pContext->getGPUScreen()->ReleaseRenderContextOwnership(m_pContext->m_gameThreadThreadOwnershipMask);
+    }
+#endif
     
     //Create Physics Events
     {
@@ -109,9 +132,11 @@ int ClientGame::runGameFrame()
     
     // Process general events (Draw, Update, Calculate transformations...)
     Handle gqh = Events::EventQueueManager::Instance()->getEventQueueHandle("general");
+    PrimitiveTypes::UInt32 numGeneralEvents = 0;
     while (!gqh.getObject<Events::EventQueue>()->empty())
     {
         Events::Event *pGeneralEvt = gqh.getObject<Events::EventQueue>()->getFront();
+        numGeneralEvents++;
         // this code is in process of conversion to new event style
         // first use new method then old (switch)
         if (Event_UPDATE::GetClassId() == pGeneralEvt->getClassId())
@@ -156,6 +181,8 @@ int ClientGame::runGameFrame()
                 
                 drawZOnlyEvt->m_pZOnlyDrawListOverride = 0;
 
+				static bool s_cullShadowCasters = true;
+
 				RootSceneNode *pRoot = RootSceneNode::Instance();
 
 				if (pRoot->m_lights.m_size)
@@ -167,6 +194,17 @@ int ClientGame::runGameFrame()
 
 							drawZOnlyEvt->m_projectionViewTransform = (pLight->m_viewToProjectedTransform * pLight->m_worldToViewTransform);
 							drawZOnlyEvt->m_eyePos = pLight->m_base.getPos();
+
+							// cull casters against light frustum cropped to what the camera can see
+							pLight->computeShadowCasterPlanes(pcam);
+							for (int iPlane = 0; iPlane < 6; iPlane++)
+							{
+								drawZOnlyEvt->m_frustumPlanes[iPlane] = Event_GATHER_DRAWCALLS::FrustumPlane(
+									pLight->m_shadowCasterPlanes[iPlane].normal,
+									pLight->m_shadowCasterPlanes[iPlane].distance
+								);
+							}
+							drawZOnlyEvt->m_cullShadowCasters = s_cullShadowCasters;
 							foundShadower=true;
 							break;
 						}
@@ -250,6 +288,17 @@ int ClientGame::runGameFrame()
 			|| Event_GATHER_DRAWCALLS_Z_ONLY::GetClassId() == pGeneralEvt->getClassId())
         {
 			bool zOnly = Event_GATHER_DRAWCALLS_Z_ONLY::GetClassId() == pGeneralEvt->getClassId();
+
+			if (!haveFrameSlot)
+			{
+				// frame fence: wait only if render thread still draws the frame that used this frame's draw lists
+				gameThreadPreDrawFrameTime += m_hTimer.getObject<Timer>()->TickAndGetTimeDeltaInSeconds();
+				#if PYENGINE_2_0_MULTI_THREADED
+					g_framePipeline.waitForFreeSlot();
+				#endif
+				gameThreadDrawWaitFrameTime += m_hTimer.getObject<Timer>()->TickAndGetTimeDeltaInSeconds();
+				haveFrameSlot = true;
+			}
 			
             Event_GATHER_DRAWCALLS *pDrawEvent = NULL;
 			Event_GATHER_DRAWCALLS_Z_ONLY *pDrawZOnlyEvent = NULL;
@@ -257,6 +306,7 @@ int ClientGame::runGameFrame()
 			{
 				pDrawZOnlyEvent = (Event_GATHER_DRAWCALLS_Z_ONLY *)(pGeneralEvt);
 				DrawList::ZOnlyInstance()->reset();
+				SingleHandler_DRAW::GetInstance()->m_numShadowDrawCallsCulled = 0;
 
 			}
 			else
@@ -266,7 +316,11 @@ int ClientGame::runGameFrame()
 			}
 
 			if (pDrawEvent)
-				EffectManager::Instance()->m_currentViewProjMatrix = pDrawEvent->m_projectionViewTransform;
+			{
+				// render thread copies these to EffectManager when it draws this frame
+				DrawList::Instance()->m_viewProjMatrix = pDrawEvent->m_projectionViewTransform;
+				DrawList::Instance()->m_doMotionBlur = false;
+			}
           
 			// Draw 1st order
 			proot->handleEvent(pGeneralEvt);
@@ -282,7 +336,7 @@ int ClientGame::runGameFrame()
 				//SkyVolume::Instance()->handleEvent(pGeneralEvt);
 				*/
 
-				EffectManager::Instance()->m_doMotionBlur = true;
+				DrawList::Instance()->m_doMotionBlur = true;
 
 				// Draw Last order
 				pDrawEvent->m_drawOrder = EffectDrawOrder::Last;
@@ -296,20 +350,16 @@ int ClientGame::runGameFrame()
 
 			if (!zOnly)
 			{
-				gameThreadPreDrawFrameTime = m_hTimer.getObject<Timer>()->TickAndGetTimeDeltaInSeconds();
+				gameThreadPreDrawFrameTime += m_hTimer.getObject<Timer>()->TickAndGetTimeDeltaInSeconds();
 
 				static bool s_RenderOnGameThread = false; // if this is true, render thread will never wake up
 
-				#if PYENGINE_2_0_MULTI_THREADED
-					g_drawThreadLock.lock(); // wait till previous draw is finished
-					//PEINFO("Game thread got g_drawThreadLock\n");
-				#endif
-
 				// this thread now can have control of rendering context for a little bit
 				// we will pass down this variable to different functions to let them know that we have both contexts
+				// render thread releases it while it executes draw lists, so this doesn't wait for the whole frame
 				m_pContext->getGPUScreen()->AcquireRenderContextOwnership(m_pContext->m_gameThreadThreadOwnershipMask);
 				 
-				gameThreadDrawWaitFrameTime = m_hTimer.getObject<Timer>()->TickAndGetTimeDeltaInSeconds();
+				gameThreadDrawWaitFrameTime += m_hTimer.getObject<Timer>()->TickAndGetTimeDeltaInSeconds();
 				
 				#if PE_ENABLE_GPU_PROFILING
 					// finalize results of gpu profiling. we want to do it in this thread to avoid race condition
@@ -325,6 +375,9 @@ int ClientGame::runGameFrame()
 				Event_PRE_RENDER_needsRC preRenderEvt(m_pContext->m_gameThreadThreadOwnershipMask);
 				m_pContext->getGameObjectManager()->handleEvent(&preRenderEvt);
 				proot->handleEvent(&preRenderEvt);
+
+				// upload texture mips requested while gathering draw calls, evict what is over budget
+				TextureResidencyManager::Instance()->update(m_pContext->m_gameThreadThreadOwnershipMask);
 				
                 PE::IRenderer::checkForErrors("");
 
@@ -348,6 +401,20 @@ int ClientGame::runGameFrame()
 						Vector3(.0f, .05f, 0), 1.0f, m_pContext->m_gameThreadThreadOwnershipMask);
 				}
 
+				// server tick budget (last report interval)
+				if (pServer->getGame())
+				{
+					ServerGame *pServerGame = (ServerGame *)(pServer->getGame());
+					ServerGame::TickStats stats = pServerGame->m_lastTickStats;
+					double total = stats.m_cpuTime + stats.m_idleTime;
+					sprintf(PEString::s_buf, "Server tick: %d Hz cpu avg %.2f ms max %.2f ms idle %.0f%% skipped %d", pServerGame->m_tickRate,
+						stats.m_numTicks ? stats.m_cpuTime * 1000.0 / stats.m_numTicks : 0.0, stats.m_maxTickCpuTime * 1000.0,
+						total > 0 ? stats.m_idleTime * 100.0 / total : 0.0, stats.m_numSkippedTicks);
+					DebugRenderer::Instance()->createTextMesh(
+						PEString::s_buf, true, false, false, false, 0,
+						Vector3(.0f, .075f, 0), 1.0f, m_pContext->m_gameThreadThreadOwnershipMask);
+				}
+
                 PE::IRenderer::checkForErrors("");
 
 				if (pServer->getLuaEnvironment()) // check if server context was initialized
@@ -365,6 +432,117 @@ int ClientGame::runGameFrame()
                 
                 PE::IRenderer::checkForErrors("");
 
+				//shadow caster culling
+				{
+					sprintf(PEString::s_buf, "Shadow draw calls culled: %d", SingleHandler_DRAW::GetInstance()->m_numShadowDrawCallsCulled);
+					DebugRenderer::Instance()->createTextMesh(
+						PEString::s_buf, true, false, false, false, 0,
+						Vector3(.75f, .075f, 0), 1.0f, m_pContext->m_gameThreadThreadOwnershipMask);
+				}
+
+				//texture residency
+				{
+					TextureResidencyManager *pTRM = TextureResidencyManager::Instance();
+					sprintf(PEString::s_buf, "Textures: %.1f/%.1f MB resident, %d pending", pTRM->getResidentBytes() / (1024.0f * 1024.0f), pTRM->m_budgetBytes / (1024.0f * 1024.0f), pTRM->m_numPendingRequests);
+					DebugRenderer::Instance()->createTextMesh(
+						PEString::s_buf, true, false, false, false, 0,
+						Vector3(.75f, .1f, 0), 1.0f, m_pContext->m_gameThreadThreadOwnershipMask);
+				}
+
+				//job system worker utilization (last frame)
+				if (JobSystem *pJobSystem = JobSystem::Instance())
+				{
+					JobSystem::FrameStats &stats = pJobSystem->m_lastFrameStats;
+					int len = sprintf(PEString::s_buf, "Jobs: %d run (%d on callers) %d stolen, workers:", stats.m_numJobs, stats.m_numJobsOnCallers, stats.m_numSteals);
+					for (int i = 0; i < stats.m_numWorkers; ++i)
+						len += sprintf(PEString::s_buf + len, " %.0f%%", stats.m_utilization[i] * 100.0f);
+					DebugRenderer::Instance()->createTextMesh(
+						PEString::s_buf, true, false, false, false, 0,
+						Vector3(.5f, .125f, 0), 1.0f, m_pContext->m_gameThreadThreadOwnershipMask);
+				}
+
+				//frame pipeline (last c_numStatsFrames frames)
+				{
+					FramePipeline::Stats stats = g_framePipeline.getLastStats();
+					sprintf(PEString::s_buf, "Frames in flight: %.2f/%d fence wait: game %.2f ms render %.2f ms", stats.m_avgFramesInFlight, PE_NUM_FRAMES_IN_FLIGHT, stats.m_gameWaitTime * 1000.0f, stats.m_renderWaitTime * 1000.0f);
+					DebugRenderer::Instance()->createTextMesh(
+						PEString::s_buf, true, false, false, false, 0,
+						Vector3(.5f, .15f, 0), 1.0f, m_pContext->m_gameThreadThreadOwnershipMask);
+				}
+
+				//pipeline state changes of last drawn frame (written by render thread, may be a frame behind)
+				{
+					RenderStateShadow::Stats &stats = m_pContext->getGPUScreen()->m_stateShadow.m_lastFrameStats;
+					sprintf(PEString::s_buf, "State changes: %d applied %d skipped (blend %d/%d raster %d/%d depth %d/%d sampler %d/%d)",
+						stats.getNumApplied(), stats.getNumSkipped(),
+						stats.m_applied[RenderStateType_Blend], stats.m_skipped[RenderStateType_Blend],
+						stats.m_applied[RenderStateType_Rasterizer], stats.m_skipped[RenderStateType_Rasterizer],
+						stats.m_applied[RenderStateType_DepthStencil], stats.m_skipped[RenderStateType_DepthStencil],
+						stats.m_applied[RenderStateType_Sampler], stats.m_skipped[RenderStateType_Sampler]);
+					DebugRenderer::Instance()->createTextMesh(
+						PEString::s_buf, true, false, false, false, 0,
+						Vector3(.5f, .175f, 0), 1.0f, m_pContext->m_gameThreadThreadOwnershipMask);
+				}
+
+				//shader constant uploads of last drawn frame
+				{
+					ConstantBufferRing &ring = m_pContext->getGPUScreen()->m_constantRing;
+					ConstantBufferRing::Stats &stats = ring.m_lastFrameStats;
+					sprintf(PEString::s_buf, "Constants: %.1f KB %d binds, ring %s %d KB in use %d wraps %d waits",
+						stats.m_numBytesUploaded / 1024.0f, stats.m_numBinds, ring.isActive() ? "on" : "off",
+						ring.getNumBytesInUse() / 1024, stats.m_numWraps, stats.m_numFenceWaits);
+					DebugRenderer::Instance()->createTextMesh(
+						PEString::s_buf, true, false, false, false, 0,
+						Vector3(.5f, .2f, 0), 1.0f, m_pContext->m_gameThreadThreadOwnershipMask);
+				}
+
+				//clustered lights of last gathered frame
+				if (LightClusters *pClusters = LightClusters::Instance())
+				{
+					sprintf(PEString::s_buf, "Lights: %d in %d clusters, %d hits max %d per cluster, %.3f ms",
+						pClusters->getNumLights(), LightClusters::c_numClusters, pClusters->m_lightIndices.m_size,
+						pClusters->m_maxLightsPerCluster, pClusters->m_buildTime * 1000.0f);
+					DebugRenderer::Instance()->createTextMesh(
+						PEString::s_buf, true, false, false, false, 0,
+						Vector3(.5f, .225f, 0), 1.0f, m_pContext->m_gameThreadThreadOwnershipMask);
+				}
+
+				//batched text of last frame
+				if (TextBatcher *pTextBatcher = TextBatcher::Instance())
+				{
+					TextBatcher::Stats &stats = pTextBatcher->m_lastFrameStats;
+					sprintf(PEString::s_buf, "Text: %d glyphs %d dropped in %d draw calls, %.1f KB uploaded",
+						stats.m_numGlyphs, stats.m_numDropped, stats.m_numDrawCalls, stats.m_numBytesUploaded / 1024.0f);
+					DebugRenderer::Instance()->createTextMesh(
+						PEString::s_buf, true, false, false, false, 0,
+						Vector3(.5f, .25f, 0), 1.0f, m_pContext->m_gameThreadThreadOwnershipMask);
+				}
+
+				//hot reload
+				if (HotReloadManager *pHotReload = HotReloadManager::Instance())
+				{
+					HotReloadManager::Stats stats = pHotReload->getStats();
+					sprintf(PEString::s_buf, "Hot reload: %d scripts %d shaders %d meshes %d textures, %d pending %d failed, swap %.2f ms max %.2f ms",
+						stats.m_numApplied[HotReloadManager::Kind_Script], stats.m_numApplied[HotReloadManager::Kind_Shader],
+						stats.m_numApplied[HotReloadManager::Kind_Mesh], stats.m_numApplied[HotReloadManager::Kind_Texture],
+						stats.m_numPending, stats.m_numFailed, stats.m_lastSwapMs, stats.m_maxSwapMs);
+					DebugRenderer::Instance()->createTextMesh(
+						PEString::s_buf, true, false, false, false, 0,
+						Vector3(.5f, .275f, 0), 1.0f, m_pContext->m_gameThreadThreadOwnershipMask);
+				}
+
+				//lua of last frame
+				{
+					LuaProfiler &profiler = m_pContext->getLuaEnvironment()->m_profiler;
+					LuaScriptCache::Stats cacheStats = m_pContext->getLuaEnvironment()->m_scriptCache.getStats();
+					sprintf(PEString::s_buf, "Lua: %.3f ms in %d calls, scripts %d cached %d compiled%s",
+						profiler.m_lastFrameMs, profiler.m_lastFrameCalls, cacheStats.m_numMemoryHits + cacheStats.m_numDiskHits,
+						cacheStats.m_numCompiles, profiler.isRunning() ? ", profiling" : "");
+					DebugRenderer::Instance()->createTextMesh(
+						PEString::s_buf, true, false, false, false, 0,
+						Vector3(.5f, .3f, 0), 1.0f, m_pContext->m_gameThreadThreadOwnershipMask);
+				}
+
 				//gameplay timer
 				{
 					sprintf(PEString::s_buf, "GT frame wait:%.3f pre-draw:%.3f+render wait:%.3f+render:%.3f+post-render:%.3f = %.3f sec\n", m_gameTimeBetweenFrames, m_gameThreadPreDrawFrameTime, m_gameThreadDrawWaitFrameTime, m_gameThreadDrawFrameTime, m_gameThreadPostDrawFrameTime, m_frameTime);
@@ -400,12 +578,16 @@ int ClientGame::runGameFrame()
 
 				#if PYENGINE_2_0_MULTI_THREADED
 					if (!s_RenderOnGameThread) // this variable will dynamically keep other thread waiting
-						g_drawThreadCanStart = true;
+					{
+						// render thread draws this frame while we simulate next ones
+						g_framePipeline.submitFrame();
+					}
 					else
-						runDrawThreadSingleFrame(*m_pContext); // tun on game thread
-					//PEINFO("Game thread releasing g_drawThreadLock\n");
-					g_drawThreadLock.unlock(); // release render thread lock
-					g_drawCanStartCV.signal();
+					{
+						// let render thread finish frames it has, then draw this one on game thread
+						g_framePipeline.waitForAllFrames();
+						runDrawThreadSingleFrame(*m_pContext);
+					}
 				#else
 					runDrawThreadSingleFrame(*m_pContext);
 				#endif
@@ -482,6 +664,19 @@ int ClientGame::runGameFrame()
 
 	m_gameTime += m_frameTime;
 
+	if (JobSystem *pJobSystem = JobSystem::Instance())
+		pJobSystem->frameEnd();
+
+	m_pContext->getLuaEnvironment()->m_profiler.frameEnd();
+
+	#if PE_ENABLE_TELEMETRY
+	if (Telemetry *pTelemetry = Telemetry::Instance())
+	{
+		pTelemetry->addEvents(numGeneralEvents);
+		pTelemetry->frameEnd();
+	}
+	#endif
+
 	if (!m_runGame)
 	{
 		PE::GameContext *pServer = &PE::Components::ServerGame::s_context;
@@ -492,12 +687,8 @@ int ClientGame::runGameFrame()
 
 		// this is the last iteration of game thread, wait for all other threads to be done with current frame
 		#if PYENGINE_2_0_MULTI_THREADED
-			g_drawThreadLock.lock(); // wait till previous draw is finished
-			g_drawThreadShouldExit = true;
-			
-			g_drawThreadLock.unlock(); // release render thread lock
-			// wake up render thread
-			g_drawCanStartCV.signal();
+			// render thread finishes the frame it is drawing, frames still in flight are dropped
+			g_framePipeline.requestExit();
 			
 			while (!g_drawThreadExited)
 			{
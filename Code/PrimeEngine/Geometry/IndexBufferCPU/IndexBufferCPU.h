@@ -44,6 +44,7 @@ struct IndexBufferCPU : PE::PEAllocatableAndDefragmentable
 	{
 		m_arena = arena; m_pContext = &context;
         m_dbgName[0] = '\0';
+		m_vertexCacheOptimized = false;
 	}
 
 	// Reads the specified buffer from file
@@ -67,6 +68,7 @@ struct IndexBufferCPU : PE::PEAllocatableAndDefragmentable
 
 	PEPrimitveTopology m_primitiveTopology;
 	PrimitiveTypes::Int32 m_verticesPerPolygon;
+	bool m_vertexCacheOptimized; // set by MeshOptimizer so that shared buffers are not reordered twice
 
     char m_dbgName[256];
 	PE::MemoryArena m_arena; PE::GameContext *m_pContext;
@@ -5,6 +5,7 @@
 #include "MeshCPU.h"
 
 // Outer-Engine includes
+#include <float.h>
 
 // Inter-Engine includes
 #include "PrimeEngine/APIAbstraction/Effect/EffectManager.h"
@@ -13,7 +14,9 @@
 #include "../PositionBufferCPU/PositionBufferCPUManager.h"
 #include "../NormalBufferCPU/NormalBufferCPUManager.h"
 #include "../TexCoordBufferCPU/TexCoordBufferCPUManager.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
 // Sibling/Children includes
+#include "MeshOptimizer.h"
 
 namespace PE {
 
@@ -128,8 +131,9 @@ void MeshCPU::ReadMesh(const char *filename, const char *package, const char *ta
 		m_hAdditionalNormalBuffersCPU.add(hAdditionalNormalBufferCPU);
 	}
 
-	
-
+#if PE_OPTIMIZE_MESHES_ON_LOAD
+	MeshOptimizer::optimizeMesh(*this);
+#endif
 }
 
 
@@ -15,6 +15,7 @@
 #include "../../Utils/Array/Array.h"
 #include "PrimeEngine/MainFunction/MainFunctionArgs.h"
 #include "PrimeEngine/APIAbstraction/Texture/SamplerState.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
 
 #include "../PositionBufferCPU/PositionBufferCPU.h"
 #include "../TexCoordBufferCPU/TexCoordBufferCPU.h"
@@ -36,11 +37,12 @@ namespace PE {
 struct MeshCPU : PE::PEAllocatableAndDefragmentable
 {
 	MeshCPU(PE::GameContext &context, PE::MemoryArena arena) 
-	: m_manualBufferManagement(false)
-	, m_hAdditionalVertexBuffersCPU(context, arena)
+	: m_hAdditionalVertexBuffersCPU(context, arena)
 	, m_hAdditionalTexCoordBuffersCPU(context, arena)
 	, m_hAdditionalNormalBuffersCPU(context, arena)
 	, m_hAdditionalTangentBuffersCPU(context, arena)
+	, m_manualBufferManagement(false)
+	, m_usePackedVertexFormat(PE_PACKED_VERTEX_FORMATS != 0)
 	{
 		m_arena = arena; m_pContext = &context;
 	}
@@ -76,6 +78,7 @@ struct MeshCPU : PE::PEAllocatableAndDefragmentable
 	Handle m_hSkinWeightsCPU;
 
 	PrimitiveTypes::Bool m_manualBufferManagement; // if true, this mesh wont be cached and reused
+	PrimitiveTypes::Bool m_usePackedVertexFormat; // allow DetailedMeshPacked/DetailedSkinPacked gpu vertex formats for this mesh
 
 	PE::MemoryArena m_arena; PE::GameContext *m_pContext;
 
@@ -0,0 +1,340 @@
+// APIAbstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Immediate header
+#include "MeshOptimizer.h"
+
+// Outer-Engine includes
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Utils/ErrorHandling.h"
+#include "../SkeletonCPU/SkinWeightsCPU.h"
+#include "../TangentBufferCPU/TangentBufferCPU.h"
+
+// Sibling/Children includes
+#include "MeshCPU.h"
+
+namespace PE {
+
+namespace {
+
+// Forsyth scoring. same constants as Tools/MeshOptimizer/meshoptimizer.py
+const PrimitiveTypes::Int32 kCacheSize = 32;
+const PrimitiveTypes::Float32 kCacheDecayPower = 1.5f;
+const PrimitiveTypes::Float32 kLastTriScore = 0.75f;
+const PrimitiveTypes::Float32 kValenceBoostScale = 2.0f;
+const PrimitiveTypes::Float32 kValenceBoostPower = 0.5f;
+
+PrimitiveTypes::Float32 vertexScore(PrimitiveTypes::Int32 cachePos, PrimitiveTypes::UInt32 remainingValence)
+{
+	if (remainingValence == 0)
+		return -1.0f; // no triangles left to use this vertex
+
+	PrimitiveTypes::Float32 score = 0.0f;
+	if (cachePos >= 0)
+	{
+		if (cachePos < 3)
+			score = kLastTriScore; // vertices of the last triangle get a fixed score so that we don't favor strips too much
+		else
+			score = powf(1.0f - (PrimitiveTypes::Float32)(cachePos - 3) / (kCacheSize - 3), kCacheDecayPower);
+	}
+	// vertices with few triangles left are worth finishing so that they don't have to be transformed again later
+	return score + kValenceBoostScale * powf((PrimitiveTypes::Float32)(remainingValence), -kValenceBoostPower);
+}
+
+// moves vertex data so that old vertex i ends up at remap[i]
+void permuteVertices(void *pData, PrimitiveTypes::UInt32 vertexSize, PrimitiveTypes::UInt32 numVertices, const PrimitiveTypes::UInt32 *remap)
+{
+	char *pTemp = (char *)malloc(vertexSize * numVertices);
+	memcpy(pTemp, pData, vertexSize * numVertices);
+	for (PrimitiveTypes::UInt32 i = 0; i < numVertices; ++i)
+		memcpy((char *)(pData) + remap[i] * vertexSize, pTemp + i * vertexSize, vertexSize);
+	free(pTemp);
+}
+
+void permuteFloatStream(Array<PrimitiveTypes::Float32> &values, PrimitiveTypes::UInt32 valuesPerVertex, PrimitiveTypes::UInt32 numVertices, const PrimitiveTypes::UInt32 *remap)
+{
+	PEASSERT(values.m_size == numVertices * valuesPerVertex, "Vertex stream has different number of vertices than position buffer");
+	if (numVertices)
+		permuteVertices(&values[0], sizeof(PrimitiveTypes::Float32) * valuesPerVertex, numVertices, remap);
+}
+
+}; // anonymous namespace
+
+PrimitiveTypes::Float32 MeshOptimizer::computeACMR(const PrimitiveTypes::UInt16 *indices, PrimitiveTypes::UInt32 numIndices, PrimitiveTypes::UInt32 cacheSize)
+{
+	if (numIndices < 3)
+		return 0.0f;
+
+	// FIFO cache as ring buffer
+	PrimitiveTypes::UInt32 *pCache = (PrimitiveTypes::UInt32 *)malloc(sizeof(PrimitiveTypes::UInt32) * cacheSize);
+	PrimitiveTypes::UInt32 cacheCount = 0, cacheHead = 0;
+	PrimitiveTypes::UInt32 misses = 0;
+
+	for (PrimitiveTypes::UInt32 i = 0; i < numIndices; ++i)
+	{
+		bool hit = false;
+		for (PrimitiveTypes::UInt32 c = 0; c < cacheCount; ++c)
+		{
+			if (pCache[c] == indices[i])
+			{
+				hit = true;
+				break;
+			}
+		}
+		if (hit)
+			continue;
+
+		++misses;
+		if (cacheCount < cacheSize)
+		{
+			pCache[cacheCount++] = indices[i];
+		}
+		else
+		{
+			pCache[cacheHead] = indices[i];
+			cacheHead = (cacheHead + 1) % cacheSize;
+		}
+	}
+
+	free(pCache);
+	return (PrimitiveTypes::Float32)(misses) / (numIndices / 3);
+}
+
+void MeshOptimizer::optimizeTriangleOrder(PrimitiveTypes::UInt16 *indices, PrimitiveTypes::UInt32 numIndices, PrimitiveTypes::UInt32 numVertices)
+{
+	PrimitiveTypes::UInt32 numTris = numIndices / 3;
+	if (numTris < 2)
+		return;
+
+	// per vertex list of triangles not yet added. active ones are kept in front: [offset, offset + remaining)
+	PrimitiveTypes::UInt32 *pRemaining = (PrimitiveTypes::UInt32 *)calloc(numVertices, sizeof(PrimitiveTypes::UInt32));
+	PrimitiveTypes::UInt32 *pOffsets = (PrimitiveTypes::UInt32 *)malloc(sizeof(PrimitiveTypes::UInt32) * (numVertices + 1));
+	PrimitiveTypes::UInt32 *pVertTris = (PrimitiveTypes::UInt32 *)malloc(sizeof(PrimitiveTypes::UInt32) * numIndices);
+	PrimitiveTypes::Int32 *pCachePos = (PrimitiveTypes::Int32 *)malloc(sizeof(PrimitiveTypes::Int32) * numVertices);
+	PrimitiveTypes::Float32 *pVertScore = (PrimitiveTypes::Float32 *)malloc(sizeof(PrimitiveTypes::Float32) * numVertices);
+	PrimitiveTypes::Float32 *pTriScore = (PrimitiveTypes::Float32 *)malloc(sizeof(PrimitiveTypes::Float32) * numTris);
+	bool *pTriAdded = (bool *)calloc(numTris, sizeof(bool));
+	PrimitiveTypes::UInt16 *pResult = (PrimitiveTypes::UInt16 *)malloc(sizeof(PrimitiveTypes::UInt16) * numIndices);
+
+	for (PrimitiveTypes::UInt32 i = 0; i < numIndices; ++i)
+		++pRemaining[indices[i]];
+
+	pOffsets[0] = 0;
+	for (PrimitiveTypes::UInt32 v = 0; v < numVertices; ++v)
+	{
+		pOffsets[v + 1] = pOffsets[v] + pRemaining[v];
+		pRemaining[v] = 0;
+		pCachePos[v] = -1;
+	}
+	for (PrimitiveTypes::UInt32 i = 0; i < numIndices; ++i)
+	{
+		PrimitiveTypes::UInt32 v = indices[i];
+		pVertTris[pOffsets[v] + pRemaining[v]++] = i / 3;
+	}
+	for (PrimitiveTypes::UInt32 v = 0; v < numVertices; ++v)
+		pVertScore[v] = vertexScore(-1, pRemaining[v]);
+
+	PrimitiveTypes::Int32 bestTri = 0;
+	for (PrimitiveTypes::UInt32 t = 0; t < numTris; ++t)
+	{
+		pTriScore[t] = pVertScore[indices[t * 3]] + pVertScore[indices[t * 3 + 1]] + pVertScore[indices[t * 3 + 2]];
+		if (pTriScore[t] > pTriScore[bestTri])
+			bestTri = t;
+	}
+
+	// cache has room for the 3 new vertices on top of kCacheSize so that we can see what falls out
+	PrimitiveTypes::UInt32 cache[kCacheSize + 3];
+	PrimitiveTypes::UInt32 newCache[kCacheSize + 3];
+	PrimitiveTypes::Int32 cacheCount = 0;
+	PrimitiveTypes::UInt32 numAdded = 0;
+	PrimitiveTypes::UInt32 nextUnadded = 0;
+
+	while (bestTri >= 0)
+	{
+		pTriAdded[bestTri] = true;
+		PrimitiveTypes::UInt16 *tri = &indices[bestTri * 3];
+		pResult[numAdded * 3] = tri[0]; pResult[numAdded * 3 + 1] = tri[1]; pResult[numAdded * 3 + 2] = tri[2];
+		++numAdded;
+
+		// new cache: triangle's vertices in front, then old cache without them
+		PrimitiveTypes::Int32 newCount = 0;
+		for (int k = 0; k < 3; ++k)
+		{
+			PrimitiveTypes::UInt32 v = tri[k];
+
+			// remove triangle from list of active triangles of the vertex (once per corner, so degenerate triangles work too)
+			PrimitiveTypes::UInt32 *pList = &pVertTris[pOffsets[v]];
+			for (PrimitiveTypes::UInt32 j = 0; j < pRemaining[v]; ++j)
+			{
+				if (pList[j] == (PrimitiveTypes::UInt32)(bestTri))
+				{
+					pList[j] = pList[pRemaining[v] - 1];
+					break;
+				}
+			}
+			--pRemaining[v];
+
+			if (k == 0 || (v != tri[0] && (k == 1 || v != tri[1])))
+				newCache[newCount++] = v;
+		}
+		for (PrimitiveTypes::Int32 c = 0; c < cacheCount; ++c)
+		{
+			PrimitiveTypes::UInt32 v = cache[c];
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+				newCache[newCount++] = v;
+		}
+
+		// rescore everything in the new cache. vertices past kCacheSize just fell out
+		for (PrimitiveTypes::Int32 c = 0; c < newCount; ++c)
+		{
+			PrimitiveTypes::UInt32 v = newCache[c];
+			pCachePos[v] = c < kCacheSize ? c : -1;
+			PrimitiveTypes::Float32 newScore = vertexScore(pCachePos[v], pRemaining[v]);
+			PrimitiveTypes::Float32 delta = newScore - pVertScore[v];
+			pVertScore[v] = newScore;
+			for (PrimitiveTypes::UInt32 j = 0; j < pRemaining[v]; ++j)
+				pTriScore[pVertTris[pOffsets[v] + j]] += delta;
+		}
+
+		cacheCount = newCount < kCacheSize ? newCount : kCacheSize;
+		memcpy(cache, newCache, sizeof(PrimitiveTypes::UInt32) * cacheCount);
+
+		// best next triangle is one that uses cached vertices
+		bestTri = -1;
+		PrimitiveTypes::Float32 bestScore = -1.0f;
+		for (PrimitiveTypes::Int32 c = 0; c < cacheCount; ++c)
+		{
+			PrimitiveTypes::UInt32 v = cache[c];
+			for (PrimitiveTypes::UInt32 j = 0; j < pRemaining[v]; ++j)
+			{
+				PrimitiveTypes::UInt32 t = pVertTris[pOffsets[v] + j];
+				if (pTriScore[t] > bestScore)
+				{
+					bestScore = pTriScore[t];
+					bestTri = t;
+				}
+			}
+		}
+
+		if (bestTri < 0 && numAdded < numTris)
+		{
+			// nothing in cache is useful. continue with any triangle that is left
+			while (pTriAdded[nextUnadded])
+				++nextUnadded;
+			bestTri = nextUnadded;
+		}
+	}
+
+	memcpy(indices, pResult, sizeof(PrimitiveTypes::UInt16) * numIndices);
+
+	free(pRemaining); free(pOffsets); free(pVertTris); free(pCachePos);
+	free(pVertScore); free(pTriScore); free(pTriAdded); free(pResult);
+}
+
+void MeshOptimizer::optimizeVertexFetch(MeshCPU &mcpu)
+{
+	IndexBufferCPU *pib = mcpu.m_hIndexBufferCPU.getObject<IndexBufferCPU>();
+	PositionBufferCPU *pvb = mcpu.m_hPositionBufferCPU.getObject<PositionBufferCPU>();
+	PrimitiveTypes::UInt32 numVertices = pvb->m_values.m_size / 3;
+	if (numVertices == 0)
+		return;
+
+	// new index of each vertex: order of first use, unused vertices go to the end
+	PrimitiveTypes::UInt32 *pRemap = (PrimitiveTypes::UInt32 *)malloc(sizeof(PrimitiveTypes::UInt32) * numVertices);
+	memset(pRemap, 0xFF, sizeof(PrimitiveTypes::UInt32) * numVertices);
+	PrimitiveTypes::UInt32 next = 0;
+	for (PrimitiveTypes::UInt32 i = 0; i < pib->m_values.m_size; ++i)
+	{
+		PrimitiveTypes::UInt16 v = pib->m_values[i];
+		if (pRemap[v] == 0xFFFFFFFF)
+			pRemap[v] = next++;
+	}
+	for (PrimitiveTypes::UInt32 v = 0; v < numVertices; ++v)
+	{
+		if (pRemap[v] == 0xFFFFFFFF)
+			pRemap[v] = next++;
+	}
+
+	permuteFloatStream(pvb->m_values, 3, numVertices, pRemap);
+	if (mcpu.m_hTexCoordBufferCPU.isValid())
+		permuteFloatStream(mcpu.m_hTexCoordBufferCPU.getObject<TexCoordBufferCPU>()->m_values, 2, numVertices, pRemap);
+	if (mcpu.m_hNormalBufferCPU.isValid())
+		permuteFloatStream(mcpu.m_hNormalBufferCPU.getObject<NormalBufferCPU>()->m_values, 3, numVertices, pRemap);
+	if (mcpu.m_hTangentBufferCPU.isValid())
+		permuteFloatStream(mcpu.m_hTangentBufferCPU.getObject<TangentBufferCPU>()->m_values, 3, numVertices, pRemap);
+
+	// blend shapes
+	for (PrimitiveTypes::UInt32 i = 0; i < mcpu.m_hAdditionalVertexBuffersCPU.m_size; ++i)
+		permuteFloatStream(mcpu.m_hAdditionalVertexBuffersCPU[i].getObject<PositionBufferCPU>()->m_values, 3, numVertices, pRemap);
+	for (PrimitiveTypes::UInt32 i = 0; i < mcpu.m_hAdditionalTexCoordBuffersCPU.m_size; ++i)
+		permuteFloatStream(mcpu.m_hAdditionalTexCoordBuffersCPU[i].getObject<TexCoordBufferCPU>()->m_values, 2, numVertices, pRemap);
+	for (PrimitiveTypes::UInt32 i = 0; i < mcpu.m_hAdditionalNormalBuffersCPU.m_size; ++i)
+		permuteFloatStream(mcpu.m_hAdditionalNormalBuffersCPU[i].getObject<NormalBufferCPU>()->m_values, 3, numVertices, pRemap);
+
+	if (mcpu.m_hSkinWeightsCPU.isValid())
+	{
+		// per vertex weight arrays only own a handle, so they can be moved around as raw memory
+		SkinWeightsCPU *psw = mcpu.m_hSkinWeightsCPU.getObject<SkinWeightsCPU>();
+		PEASSERT(psw->m_weightsPerVertex.m_size == numVertices, "Skin weights have different number of vertices than position buffer");
+		permuteVertices(&psw->m_weightsPerVertex[0], sizeof(Array<WeightPair>), numVertices, pRemap);
+	}
+
+	// indices and vertex ranges used by draw calls
+	pib->m_minVertexIndex = 0x7FFFFFFF;
+	pib->m_maxVertexIndex = 0;
+	for (PrimitiveTypes::UInt32 ir = 0; ir < pib->m_indexRanges.m_size; ++ir)
+	{
+		IndexRange &range = pib->m_indexRanges[ir];
+		range.m_minVertIndex = 0xFFFFFFFF;
+		range.m_maxVertIndex = 0;
+		for (PrimitiveTypes::UInt32 i = range.m_start; i <= range.m_end; ++i)
+		{
+			PrimitiveTypes::UInt32 v = pRemap[pib->m_values[i]];
+			pib->m_values[i] = (PrimitiveTypes::UInt16)(v);
+			if (v < range.m_minVertIndex) range.m_minVertIndex = v;
+			if (v > range.m_maxVertIndex) range.m_maxVertIndex = v;
+		}
+		if ((int)(range.m_minVertIndex) < pib->m_minVertexIndex) pib->m_minVertexIndex = range.m_minVertIndex;
+		if ((int)(range.m_maxVertIndex) > pib->m_maxVertexIndex) pib->m_maxVertexIndex = range.m_maxVertIndex;
+	}
+
+	free(pRemap);
+}
+
+void MeshOptimizer::optimizeMesh(MeshCPU &mcpu)
+{
+	IndexBufferCPU *pib = mcpu.m_hIndexBufferCPU.getObject<IndexBufferCPU>();
+	if (pib->m_vertexCacheOptimized || pib->m_primitiveTopology != PEPrimitveTopology_TRIANGLES || pib->m_values.m_size == 0)
+		return; // buffers are cached by MeshManager/PositionBufferCPUManager and might be shared by meshes
+
+	PrimitiveTypes::UInt32 numVertices = mcpu.m_hPositionBufferCPU.getObject<PositionBufferCPU>()->m_values.m_size / 3;
+	PrimitiveTypes::Float32 acmrBefore = computeACMR(&pib->m_values[0], pib->m_values.m_size);
+
+	// triangles can not move between ranges (materials) or bone segments (bone palettes)
+	for (PrimitiveTypes::UInt32 ir = 0; ir < pib->m_indexRanges.m_size; ++ir)
+	{
+		IndexRange &range = pib->m_indexRanges[ir];
+		if (range.m_boneSegments.m_size == 0)
+		{
+			optimizeTriangleOrder(&pib->m_values[range.m_start], range.m_end - range.m_start + 1, numVertices);
+			continue;
+		}
+		for (PrimitiveTypes::UInt32 is = 0; is < range.m_boneSegments.m_size; ++is)
+		{
+			IndexRange::BoneSegment &segment = range.m_boneSegments[is];
+			optimizeTriangleOrder(&pib->m_values[segment.m_start], segment.m_end - segment.m_start + 1, numVertices);
+		}
+	}
+
+	optimizeVertexFetch(mcpu);
+	pib->m_vertexCacheOptimized = true;
+
+	PEINFO("PE: Mesh optimization: %s ACMR %.3f -> %.3f (%d entry FIFO)", pib->m_dbgName, acmrBefore,
+		computeACMR(&pib->m_values[0], pib->m_values.m_size), PE_MESH_OPTIMIZER_REPORT_CACHE_SIZE);
+}
+
+}; // namespace PE
@@ -0,0 +1,40 @@
+#ifndef __PYENGINE_2_0_MESH_OPTIMIZER__
+#define __PYENGINE_2_0_MESH_OPTIMIZER__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+struct MeshCPU;
+
+// Load time version of Tools/MeshOptimizer/meshoptimizer.py (enabled with PE_OPTIMIZE_MESHES_ON_LOAD).
+// Reorders triangles for post-transform vertex cache and vertices for fetch locality.
+// Duplicate vertex removal changes buffer sizes and is only done by the offline tool.
+struct MeshOptimizer
+{
+	// average number of vertices transformed per triangle with a FIFO cache of cacheSize entries
+	static PrimitiveTypes::Float32 computeACMR(const PrimitiveTypes::UInt16 *indices, PrimitiveTypes::UInt32 numIndices, PrimitiveTypes::UInt32 cacheSize = PE_MESH_OPTIMIZER_REPORT_CACHE_SIZE);
+
+	// Tom Forsyth's linear-speed vertex cache optimization. reorders triangles of the list in place
+	static void optimizeTriangleOrder(PrimitiveTypes::UInt16 *indices, PrimitiveTypes::UInt32 numIndices, PrimitiveTypes::UInt32 numVertices);
+
+	// renumbers vertices in order of first use by the index buffer and reorders all vertex streams of the mesh
+	static void optimizeVertexFetch(MeshCPU &mcpu);
+
+	// triangle order inside every bone segment (so that draw calls stay the same), then vertex order. reports ACMR
+	static void optimizeMesh(MeshCPU &mcpu);
+};
+
+}; // namespace PE
+
+#endif
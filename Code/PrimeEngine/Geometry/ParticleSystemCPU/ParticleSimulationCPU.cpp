@@ -0,0 +1,422 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#if PE_PLAT_IS_WIN32 || defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+// Inter-Engine includes
+#include "PrimeEngine/APIAbstraction/Timer/Timer.h"
+#include "PrimeEngine/Jobs/JobSystem.h"
+
+// Sibling/Children includes
+#include "ParticleSimulationCPU.h"
+
+namespace PE {
+
+using namespace PrimitiveTypes;
+
+ParticleEmitterDescCPU::ParticleEmitterDescCPU()
+: m_maxParticles(1024)
+, m_spawnRate(100.0f)
+, m_spawnPos(0, 0, 0)
+, m_spawnExtents(0, 0, 0)
+, m_minVelocity(-1.0f, 1.0f, -1.0f)
+, m_maxVelocity(1.0f, 2.0f, 1.0f)
+, m_acceleration(0, -9.8f, 0)
+, m_drag(0)
+, m_minLifetime(1.0f)
+, m_maxLifetime(2.0f)
+, m_startSize(1.0f)
+, m_endSize(1.0f)
+, m_startColor(1.0f, 1.0f, 1.0f, 1.0f)
+, m_endColor(1.0f, 1.0f, 1.0f, 0.0f)
+, m_seed(1)
+{}
+
+ParticleEmitterCPU::ParticleEmitterCPU(PE::GameContext &context, PE::MemoryArena arena)
+: m_capacity(0)
+, m_numAlive(0)
+, m_spawnAccumulator(0)
+, m_random(1)
+, m_numDroppedSpawns(0)
+, m_pool(context, arena)
+, m_vertices(context, arena)
+{
+	m_arena = arena; m_pContext = &context;
+}
+
+void ParticleEmitterCPU::initialize(const ParticleEmitterDescCPU &desc)
+{
+	m_desc = desc;
+	m_capacity = (desc.m_maxParticles + 3) & ~3u; // keeps every stream 16 byte aligned
+	m_numAlive = 0;
+	m_spawnAccumulator = 0;
+	m_random = desc.m_seed;
+	m_numDroppedSpawns = 0;
+
+	m_pool.reset(m_capacity * Stream_Count);
+	m_pool.m_size = m_capacity * Stream_Count;
+	m_vertices.m_values.reset(m_capacity * 4);
+	m_vertices.m_values.m_size = m_capacity * 4;
+}
+
+static inline Float32 RandomRange(UInt32 &random, Float32 min, Float32 max)
+{
+	random = random * 1103515245 + 12345;
+	return min + (max - min) * (Float32)((random >> 16) & 0x7fff) / 32767.0f;
+}
+
+void ParticleEmitterCPU::kill(Float32 frameTime)
+{
+	Float32 *pStreams[Stream_Count];
+	for (UInt32 s = 0; s < Stream_Count; ++s)
+		pStreams[s] = getStream((Stream)(s));
+	const Float32 *pT = pStreams[Stream_T];
+	const Float32 *pTRate = pStreams[Stream_TRate];
+
+#if PE_PARTICLES_CPU_SSE
+	__m128 dt = _mm_set1_ps(frameTime);
+	__m128 one = _mm_set1_ps(1.0f);
+#endif
+
+	UInt32 i = 0;
+	while (i < m_numAlive)
+	{
+#if PE_PARTICLES_CPU_SSE
+		// skip whole groups where nothing expires
+		if ((i & 3) == 0 && i + 4 <= m_numAlive)
+		{
+			__m128 t = _mm_add_ps(_mm_load_ps(pT + i), _mm_mul_ps(_mm_load_ps(pTRate + i), dt));
+			if (_mm_movemask_ps(_mm_cmpge_ps(t, one)) == 0)
+			{
+				i += 4;
+				continue;
+			}
+		}
+#endif
+		if (pT[i] + pTRate[i] * frameTime >= 1.0f)
+		{
+			// last alive particle takes the slot and is checked next
+			--m_numAlive;
+			for (UInt32 s = 0; s < Stream_Count; ++s)
+				pStreams[s][i] = pStreams[s][m_numAlive];
+		}
+		else
+			++i;
+	}
+}
+
+UInt32 ParticleEmitterCPU::spawn(Float32 frameTime, UInt32 maxSpawn)
+{
+	m_spawnAccumulator += m_desc.m_spawnRate * frameTime;
+	UInt32 count = (UInt32)(m_spawnAccumulator);
+	m_spawnAccumulator -= (Float32)(count);
+
+	if (count > maxSpawn)
+	{
+		m_numDroppedSpawns += count - maxSpawn;
+		count = maxSpawn;
+	}
+
+	UInt32 numSpawned = spawnBurst(count);
+	m_numDroppedSpawns += count - numSpawned;
+	return numSpawned;
+}
+
+UInt32 ParticleEmitterCPU::spawnBurst(UInt32 count)
+{
+	UInt32 numFree = m_desc.m_maxParticles - m_numAlive;
+	if (count > numFree)
+		count = numFree;
+
+	Float32 *pPosX = getStream(Stream_PosX), *pPosY = getStream(Stream_PosY), *pPosZ = getStream(Stream_PosZ);
+	Float32 *pVelX = getStream(Stream_VelX), *pVelY = getStream(Stream_VelY), *pVelZ = getStream(Stream_VelZ);
+	Float32 *pT = getStream(Stream_T), *pTRate = getStream(Stream_TRate);
+	const ParticleEmitterDescCPU &d = m_desc;
+
+	for (UInt32 i = m_numAlive; i < m_numAlive + count; ++i)
+	{
+		pPosX[i] = d.m_spawnPos.m_x + RandomRange(m_random, -d.m_spawnExtents.m_x, d.m_spawnExtents.m_x);
+		pPosY[i] = d.m_spawnPos.m_y + RandomRange(m_random, -d.m_spawnExtents.m_y, d.m_spawnExtents.m_y);
+		pPosZ[i] = d.m_spawnPos.m_z + RandomRange(m_random, -d.m_spawnExtents.m_z, d.m_spawnExtents.m_z);
+		pVelX[i] = RandomRange(m_random, d.m_minVelocity.m_x, d.m_maxVelocity.m_x);
+		pVelY[i] = RandomRange(m_random, d.m_minVelocity.m_y, d.m_maxVelocity.m_y);
+		pVelZ[i] = RandomRange(m_random, d.m_minVelocity.m_z, d.m_maxVelocity.m_z);
+		pT[i] = 0;
+		Float32 lifetime = RandomRange(m_random, d.m_minLifetime, d.m_maxLifetime);
+		pTRate[i] = 1.0f / (lifetime > 0.001f ? lifetime : 0.001f);
+	}
+
+	m_numAlive += count;
+	return count;
+}
+
+// writes quads of numParticles particles from x[4] y[4] z[4] of corners, size and color of lanes
+static inline void WriteBillboards(ParticleBillboardVertex *pVerts, UInt32 numParticles,
+	const Float32 (*corners)[3][4], const Float32 (*color)[4])
+{
+	static const Float32 s_texCoords[4][2] = {{0, 1}, {1, 1}, {1, 0}, {0, 0}};
+	for (UInt32 p = 0; p < numParticles; ++p)
+	{
+		for (UInt32 c = 0; c < 4; ++c)
+		{
+			ParticleBillboardVertex &v = pVerts[p * 4 + c];
+			v.m_pos[0] = corners[c][0][p];
+			v.m_pos[1] = corners[c][1][p];
+			v.m_pos[2] = corners[c][2][p];
+			v.m_texCoord[0] = s_texCoords[c][0];
+			v.m_texCoord[1] = s_texCoords[c][1];
+			v.m_color[0] = color[0][p];
+			v.m_color[1] = color[1][p];
+			v.m_color[2] = color[2][p];
+			v.m_color[3] = color[3][p];
+		}
+	}
+}
+
+#if PE_PARTICLES_CPU_SSE
+
+void ParticleEmitterCPU::integrate(Float32 frameTime, UInt32 beginGroup, UInt32 endGroup, const Vector3 &cameraRight, const Vector3 &cameraUp)
+{
+	Float32 *pPosX = getStream(Stream_PosX), *pPosY = getStream(Stream_PosY), *pPosZ = getStream(Stream_PosZ);
+	Float32 *pVelX = getStream(Stream_VelX), *pVelY = getStream(Stream_VelY), *pVelZ = getStream(Stream_VelZ);
+	Float32 *pT = getStream(Stream_T);
+	const Float32 *pTRate = getStream(Stream_TRate);
+	ParticleBillboardVertex *pVerts = getVertices();
+	const ParticleEmitterDescCPU &d = m_desc;
+
+	Float32 damping = 1.0f - d.m_drag * frameTime;
+	__m128 dt = _mm_set1_ps(frameTime);
+	__m128 damp = _mm_set1_ps(damping > 0 ? damping : 0);
+	__m128 dvx = _mm_set1_ps(d.m_acceleration.m_x * frameTime);
+	__m128 dvy = _mm_set1_ps(d.m_acceleration.m_y * frameTime);
+	__m128 dvz = _mm_set1_ps(d.m_acceleration.m_z * frameTime);
+
+	// half size curve, pre scaled by camera axes
+	__m128 size0 = _mm_set1_ps(d.m_startSize * 0.5f);
+	__m128 dSize = _mm_set1_ps((d.m_endSize - d.m_startSize) * 0.5f);
+	__m128 rx = _mm_set1_ps(cameraRight.m_x), ry = _mm_set1_ps(cameraRight.m_y), rz = _mm_set1_ps(cameraRight.m_z);
+	__m128 ux = _mm_set1_ps(cameraUp.m_x), uy = _mm_set1_ps(cameraUp.m_y), uz = _mm_set1_ps(cameraUp.m_z);
+
+	__m128 color0[4], dColor[4];
+	for (UInt32 c = 0; c < 4; ++c)
+	{
+		color0[c] = _mm_set1_ps(d.m_startColor.m_values[c]);
+		dColor[c] = _mm_set1_ps(d.m_endColor.m_values[c] - d.m_startColor.m_values[c]);
+	}
+
+	for (UInt32 g = beginGroup; g < endGroup; ++g)
+	{
+		UInt32 i = g * 4;
+		if (i >= m_numAlive)
+			break;
+		UInt32 numInGroup = m_numAlive - i < 4 ? m_numAlive - i : 4;
+
+		// lanes past m_numAlive hold stale particles, integrating them is harmless
+		__m128 vx = _mm_add_ps(_mm_mul_ps(_mm_load_ps(pVelX + i), damp), dvx);
+		__m128 vy = _mm_add_ps(_mm_mul_ps(_mm_load_ps(pVelY + i), damp), dvy);
+		__m128 vz = _mm_add_ps(_mm_mul_ps(_mm_load_ps(pVelZ + i), damp), dvz);
+		__m128 px = _mm_add_ps(_mm_load_ps(pPosX + i), _mm_mul_ps(vx, dt));
+		__m128 py = _mm_add_ps(_mm_load_ps(pPosY + i), _mm_mul_ps(vy, dt));
+		__m128 pz = _mm_add_ps(_mm_load_ps(pPosZ + i), _mm_mul_ps(vz, dt));
+		__m128 t = _mm_add_ps(_mm_load_ps(pT + i), _mm_mul_ps(_mm_load_ps(pTRate + i), dt));
+
+		_mm_store_ps(pVelX + i, vx); _mm_store_ps(pVelY + i, vy); _mm_store_ps(pVelZ + i, vz);
+		_mm_store_ps(pPosX + i, px); _mm_store_ps(pPosY + i, py); _mm_store_ps(pPosZ + i, pz);
+		_mm_store_ps(pT + i, t);
+
+		__m128 halfSize = _mm_add_ps(size0, _mm_mul_ps(dSize, t));
+		__m128 hrx = _mm_mul_ps(rx, halfSize), hry = _mm_mul_ps(ry, halfSize), hrz = _mm_mul_ps(rz, halfSize);
+		__m128 hux = _mm_mul_ps(ux, halfSize), huy = _mm_mul_ps(uy, halfSize), huz = _mm_mul_ps(uz, halfSize);
+
+		// bottom left, bottom right, top right, top left
+		Float32 corners[4][3][4];
+		_mm_storeu_ps(corners[0][0], _mm_sub_ps(_mm_sub_ps(px, hrx), hux));
+		_mm_storeu_ps(corners[0][1], _mm_sub_ps(_mm_sub_ps(py, hry), huy));
+		_mm_storeu_ps(corners[0][2], _mm_sub_ps(_mm_sub_ps(pz, hrz), huz));
+		_mm_storeu_ps(corners[1][0], _mm_sub_ps(_mm_add_ps(px, hrx), hux));
+		_mm_storeu_ps(corners[1][1], _mm_sub_ps(_mm_add_ps(py, hry), huy));
+		_mm_storeu_ps(corners[1][2], _mm_sub_ps(_mm_add_ps(pz, hrz), huz));
+		_mm_storeu_ps(corners[2][0], _mm_add_ps(_mm_add_ps(px, hrx), hux));
+		_mm_storeu_ps(corners[2][1], _mm_add_ps(_mm_add_ps(py, hry), huy));
+		_mm_storeu_ps(corners[2][2], _mm_add_ps(_mm_add_ps(pz, hrz), huz));
+		_mm_storeu_ps(corners[3][0], _mm_add_ps(_mm_sub_ps(px, hrx), hux));
+		_mm_storeu_ps(corners[3][1], _mm_add_ps(_mm_sub_ps(py, hry), huy));
+		_mm_storeu_ps(corners[3][2], _mm_add_ps(_mm_sub_ps(pz, hrz), huz));
+
+		Float32 color[4][4];
+		for (UInt32 c = 0; c < 4; ++c)
+			_mm_storeu_ps(color[c], _mm_add_ps(color0[c], _mm_mul_ps(dColor[c], t)));
+
+		WriteBillboards(pVerts + i * 4, numInGroup, corners, color);
+	}
+}
+
+#else
+
+void ParticleEmitterCPU::integrate(Float32 frameTime, UInt32 beginGroup, UInt32 endGroup, const Vector3 &cameraRight, const Vector3 &cameraUp)
+{
+	Float32 *pPosX = getStream(Stream_PosX), *pPosY = getStream(Stream_PosY), *pPosZ = getStream(Stream_PosZ);
+	Float32 *pVelX = getStream(Stream_VelX), *pVelY = getStream(Stream_VelY), *pVelZ = getStream(Stream_VelZ);
+	Float32 *pT = getStream(Stream_T);
+	const Float32 *pTRate = getStream(Stream_TRate);
+	ParticleBillboardVertex *pVerts = getVertices();
+	const ParticleEmitterDescCPU &d = m_desc;
+
+	Float32 damping = 1.0f - d.m_drag * frameTime;
+	if (damping < 0)
+		damping = 0;
+	Vector3 dv = frameTime * d.m_acceleration;
+
+	for (UInt32 g = beginGroup; g < endGroup; ++g)
+	{
+		UInt32 first = g * 4;
+		if (first >= m_numAlive)
+			break;
+		UInt32 numInGroup = m_numAlive - first < 4 ? m_numAlive - first : 4;
+
+		Float32 corners[4][3][4];
+		Float32 color[4][4];
+		for (UInt32 lane = 0; lane < numInGroup; ++lane)
+		{
+			UInt32 i = first + lane;
+			pVelX[i] = pVelX[i] * damping + dv.m_x;
+			pVelY[i] = pVelY[i] * damping + dv.m_y;
+			pVelZ[i] = pVelZ[i] * damping + dv.m_z;
+			pPosX[i] += pVelX[i] * frameTime;
+			pPosY[i] += pVelY[i] * frameTime;
+			pPosZ[i] += pVelZ[i] * frameTime;
+			Float32 t = pT[i] = pT[i] + pTRate[i] * frameTime;
+
+			Float32 halfSize = (d.m_startSize + (d.m_endSize - d.m_startSize) * t) * 0.5f;
+			Vector3 pos(pPosX[i], pPosY[i], pPosZ[i]);
+			Vector3 r = halfSize * cameraRight, u = halfSize * cameraUp;
+			Vector3 c[4] = {pos - r - u, pos + r - u, pos + r + u, pos - r + u};
+			for (UInt32 ic = 0; ic < 4; ++ic)
+			{
+				corners[ic][0][lane] = c[ic].m_x;
+				corners[ic][1][lane] = c[ic].m_y;
+				corners[ic][2][lane] = c[ic].m_z;
+			}
+			for (UInt32 ic = 0; ic < 4; ++ic)
+				color[ic][lane] = d.m_startColor.m_values[ic] + (d.m_endColor.m_values[ic] - d.m_startColor.m_values[ic]) * t;
+		}
+
+		WriteBillboards(pVerts + first * 4, numInGroup, corners, color);
+	}
+}
+
+#endif
+
+void ParticleEmitterCPU::update(Float32 frameTime, const Vector3 &cameraRight, const Vector3 &cameraUp)
+{
+	kill(frameTime);
+	spawn(frameTime, m_desc.m_maxParticles);
+	integrate(frameTime, 0, getNumGroups(), cameraRight, cameraUp);
+}
+
+ParticleSimulationCPU::ParticleSimulationCPU(PE::GameContext &context, PE::MemoryArena arena, UInt32 frameBudget)
+: m_frameBudget(frameBudget)
+, m_numSimulated(0)
+, m_numDroppedSpawns(0)
+, m_numUpdatedParticles(0)
+, m_updateTime(0)
+, m_emitters(context, arena, 16)
+, m_firstGroups(context, arena, 16)
+, m_frameTime(0)
+{
+	m_arena = arena; m_pContext = &context;
+}
+
+void ParticleSimulationCPU::addEmitter(ParticleEmitterCPU *pEmitter)
+{
+	m_emitters.add(pEmitter);
+	m_firstGroups.add(0);
+}
+
+void ParticleSimulationCPU::removeEmitter(ParticleEmitterCPU *pEmitter)
+{
+	for (UInt32 i = 0; i < m_emitters.m_size; ++i)
+	{
+		if (m_emitters[i] == pEmitter)
+		{
+			m_emitters[i] = m_emitters[m_emitters.m_size - 1];
+			--m_emitters.m_size;
+			--m_firstGroups.m_size;
+			return;
+		}
+	}
+}
+
+// integrates groups [begin, end) of flattened range of all emitters' groups
+static void IntegrateGroupsJob(void *pParams, int begin, int end)
+{
+	ParticleSimulationCPU *pSim = (ParticleSimulationCPU *)(pParams);
+
+	// last emitter starting at or before begin
+	UInt32 ie = 0;
+	while (ie + 1 < pSim->m_emitters.m_size && pSim->m_firstGroups[ie + 1] <= (UInt32)(begin))
+		++ie;
+
+	UInt32 g = begin;
+	for (; ie < pSim->m_emitters.m_size && g < (UInt32)(end); ++ie)
+	{
+		ParticleEmitterCPU *pEmitter = pSim->m_emitters[ie];
+		UInt32 first = pSim->m_firstGroups[ie];
+		UInt32 last = first + pEmitter->getNumGroups();
+		if (last > (UInt32)(end))
+			last = end;
+		if (g < last)
+		{
+			pEmitter->integrate(pSim->m_frameTime, g - first, last - first, pSim->m_cameraRight, pSim->m_cameraUp);
+			g = last;
+		}
+	}
+}
+
+void ParticleSimulationCPU::update(Float32 frameTime, const Vector3 &cameraRight, const Vector3 &cameraUp, bool multithreaded)
+{
+	Timer t;
+
+	UInt32 numAlive = 0;
+	for (UInt32 i = 0; i < m_emitters.m_size; ++i)
+	{
+		m_emitters[i]->kill(frameTime);
+		numAlive += m_emitters[i]->m_numAlive;
+	}
+
+	// emitters earlier in the list get the budget first
+	m_numDroppedSpawns = 0;
+	for (UInt32 i = 0; i < m_emitters.m_size; ++i)
+	{
+		ParticleEmitterCPU *pEmitter = m_emitters[i];
+		UInt32 numDropped = pEmitter->m_numDroppedSpawns;
+		numAlive += pEmitter->spawn(frameTime, numAlive < m_frameBudget ? m_frameBudget - numAlive : 0);
+		m_numDroppedSpawns += pEmitter->m_numDroppedSpawns - numDropped;
+	}
+
+	UInt32 numGroups = 0;
+	for (UInt32 i = 0; i < m_emitters.m_size; ++i)
+	{
+		m_firstGroups[i] = numGroups;
+		numGroups += m_emitters[i]->getNumGroups();
+	}
+
+	m_frameTime = frameTime;
+	m_cameraRight = cameraRight;
+	m_cameraUp = cameraUp;
+
+	if (multithreaded && numAlive > PE_PARTICLES_CPU_PER_JOB)
+		JobSystem::parallelFor(numGroups, PE_PARTICLES_CPU_PER_JOB / 4, &IntegrateGroupsJob, this);
+	else
+		IntegrateGroupsJob(this, 0, numGroups);
+
+	m_numSimulated = numAlive;
+	m_numUpdatedParticles += numAlive;
+	m_updateTime += t.TickAndGetTimeDeltaInSeconds();
+}
+
+}; // namespace PE
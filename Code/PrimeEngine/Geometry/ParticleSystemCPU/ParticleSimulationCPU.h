@@ -0,0 +1,147 @@
+#ifndef __PYENGINE_2_0_PARTICLE_SIMULATION_CPU__
+#define __PYENGINE_2_0_PARTICLE_SIMULATION_CPU__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Vector3.h"
+#include "PrimeEngine/Math/Vector4.h"
+#include "../../Utils/Array/Array.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+#include "ParticleBufferCPU.h"
+
+// sse on x86 (always there on x64), scalar code with the same data layout elsewhere
+#if PE_PLAT_IS_WIN32 || defined(__SSE__)
+#define PE_PARTICLES_CPU_SSE 1
+#else
+#define PE_PARTICLES_CPU_SSE 0
+#endif
+
+namespace PE {
+
+// vertex of camera facing quad, 4 per particle (corners counter clockwise from bottom left)
+struct ParticleBillboardVertex
+{
+	PrimitiveTypes::Float32 m_pos[3];
+	PrimitiveTypes::Float32 m_texCoord[2];
+	PrimitiveTypes::Float32 m_color[4];
+};
+
+// emitter settings. ranges are uniform random per particle,
+// size and color are linear curves over lifetime of particle
+struct ParticleEmitterDescCPU
+{
+	ParticleEmitterDescCPU();
+
+	PrimitiveTypes::UInt32 m_maxParticles; // pool size, never reallocated while simulating
+	PrimitiveTypes::Float32 m_spawnRate; // particles per second
+	Vector3 m_spawnPos;
+	Vector3 m_spawnExtents; // half size of spawn box
+	Vector3 m_minVelocity, m_maxVelocity;
+	Vector3 m_acceleration; // gravity, wind..
+	PrimitiveTypes::Float32 m_drag; // fraction of velocity lost per second
+	PrimitiveTypes::Float32 m_minLifetime, m_maxLifetime; // seconds
+	PrimitiveTypes::Float32 m_startSize, m_endSize;
+	Vector4 m_startColor, m_endColor;
+	PrimitiveTypes::UInt32 m_seed;
+};
+
+// Particles of one emitter in structure of arrays pool of fixed size.
+// Dead particles are replaced by the last alive one, new ones are appended, so alive particles are always [0, m_numAlive).
+// Lifetime is stored normalized (m_t goes 0 -> 1) so curves are evaluated without a divide.
+struct ParticleEmitterCPU : PE::PEAllocatableAndDefragmentable
+{
+	enum Stream
+	{
+		Stream_PosX, Stream_PosY, Stream_PosZ,
+		Stream_VelX, Stream_VelY, Stream_VelZ,
+		Stream_T, // normalized age
+		Stream_TRate, // 1 / lifetime
+		Stream_Count
+	};
+
+	ParticleEmitterCPU(PE::GameContext &context, PE::MemoryArena arena);
+
+	void initialize(const ParticleEmitterDescCPU &desc);
+
+	// removes particles that expire during frameTime
+	void kill(PrimitiveTypes::Float32 frameTime);
+
+	// spawns particles of spawn rate, but at most maxSpawn. rest are dropped. returns number spawned
+	PrimitiveTypes::UInt32 spawn(PrimitiveTypes::Float32 frameTime, PrimitiveTypes::UInt32 maxSpawn);
+
+	// adds count particles right away (bursts). returns number that fit in pool
+	PrimitiveTypes::UInt32 spawnBurst(PrimitiveTypes::UInt32 count);
+
+	// advances particles [4 * beginGroup, 4 * endGroup) clamped to m_numAlive and writes their billboards.
+	// groups can be integrated in parallel
+	void integrate(PrimitiveTypes::Float32 frameTime, PrimitiveTypes::UInt32 beginGroup, PrimitiveTypes::UInt32 endGroup,
+		const Vector3 &cameraRight, const Vector3 &cameraUp);
+
+	// kill, spawn and integrate on calling thread
+	void update(PrimitiveTypes::Float32 frameTime, const Vector3 &cameraRight, const Vector3 &cameraUp);
+
+	PrimitiveTypes::UInt32 getNumGroups() { return (m_numAlive + 3) / 4; }
+	PrimitiveTypes::Float32 *getStream(Stream s) { return m_pool.getFirstPtr() + s * m_capacity; }
+
+	// billboards of alive particles: 4 * m_numAlive vertices (two triangles 0 1 2, 0 2 3 per particle)
+	ParticleBillboardVertex *getVertices() { return m_vertices.m_values.getFirstPtr(); }
+	PrimitiveTypes::UInt32 getNumVertices() { return m_numAlive * 4; }
+
+	ParticleEmitterDescCPU m_desc;
+	PrimitiveTypes::UInt32 m_capacity; // m_desc.m_maxParticles rounded up to 4
+	PrimitiveTypes::UInt32 m_numAlive;
+	PrimitiveTypes::Float32 m_spawnAccumulator; // fraction of particle to spawn next frame
+	PrimitiveTypes::UInt32 m_random;
+	PrimitiveTypes::UInt32 m_numDroppedSpawns; // since initialize()
+
+	Array<PrimitiveTypes::Float32> m_pool; // Stream_Count streams of m_capacity floats
+	ParticleBufferCPU<ParticleBillboardVertex> m_vertices; // 4 * m_capacity, allocated once
+
+	PE::MemoryArena m_arena; PE::GameContext *m_pContext;
+};
+
+// Steps all registered emitters once a frame under one particle budget.
+// Kill and spawn run serially per emitter (cheap), integration of all emitters is split
+// into jobs of PE_PARTICLES_CPU_PER_JOB particles.
+struct ParticleSimulationCPU : PE::PEAllocatableAndDefragmentable
+{
+	ParticleSimulationCPU(PE::GameContext &context, PE::MemoryArena arena,
+		PrimitiveTypes::UInt32 frameBudget = PE_PARTICLES_CPU_FRAME_BUDGET);
+
+	void addEmitter(ParticleEmitterCPU *pEmitter);
+	void removeEmitter(ParticleEmitterCPU *pEmitter);
+
+	void update(PrimitiveTypes::Float32 frameTime, const Vector3 &cameraRight, const Vector3 &cameraUp, bool multithreaded = true);
+
+	// throughput of update() calls so far
+	PrimitiveTypes::Float32 getParticlesPerMs() { return m_updateTime > 0 ? (PrimitiveTypes::Float32)(m_numUpdatedParticles / (m_updateTime * 1000.0)) : 0; }
+
+	PrimitiveTypes::UInt32 m_frameBudget; // alive particles of all emitters. spawns over it are dropped
+
+	// last update()
+	PrimitiveTypes::UInt32 m_numSimulated;
+	PrimitiveTypes::UInt32 m_numDroppedSpawns;
+
+	double m_numUpdatedParticles;
+	double m_updateTime; // seconds
+
+	Array<ParticleEmitterCPU *> m_emitters;
+	Array<PrimitiveTypes::UInt32> m_firstGroups; // per emitter, first group in flattened range of all groups
+	PrimitiveTypes::Float32 m_frameTime;
+	Vector3 m_cameraRight, m_cameraUp;
+
+	PE::MemoryArena m_arena; PE::GameContext *m_pContext;
+};
+
+}; // namespace PE
+
+#endif
@@ -21,6 +21,7 @@
 #include "../IndexBufferCPU/IndexBufferCPU.h"
 #include "../NormalBufferCPU/NormalBufferCPU.h"
 #include "ParticleBufferCPU.h"
+#include "ParticleSimulationCPU.h"
 
 // Sibling/Children includes
 
@@ -34,6 +35,22 @@ struct ParticleSystemCPU : PE::PEAllocatableAndDefragmentable
 		m_arena = arena; m_pContext = &context;
 	}
 
+	// simulated particles, in addition to static ones of create(). emitter can be added to a ParticleSimulationCPU
+	// or stepped alone with update()
+	ParticleEmitterCPU *createEmitter(const ParticleEmitterDescCPU &desc)
+	{
+		m_hEmitter = Handle("PARTICLE_EMITTER_CPU", sizeof(ParticleEmitterCPU));
+		ParticleEmitterCPU *pEmitter = new(m_hEmitter) ParticleEmitterCPU(*m_pContext, m_arena);
+		pEmitter->initialize(desc);
+		return pEmitter;
+	}
+
+	virtual void update(PrimitiveTypes::Float32 frameTime, const Vector3 &cameraRight, const Vector3 &cameraUp)
+	{
+		if (m_hEmitter.isValid())
+			m_hEmitter.getObject<ParticleEmitterCPU>()->update(frameTime, cameraRight, cameraUp);
+	}
+
 	virtual void create()
 	{
 
@@ -66,6 +83,7 @@ struct ParticleSystemCPU : PE::PEAllocatableAndDefragmentable
 	}
 	
 	Handle m_hParticleBufferCPU;
+	Handle m_hEmitter; // ParticleEmitterCPU, if createEmitter() was called
 	
 	Handle m_hMaterialSetCPU;
 	PE::MemoryArena m_arena; PE::GameContext *m_pContext;
@@ -141,4 +141,15 @@ Handle PositionBufferCPUManager::ReadMaterialSetCPU(const char *filename, const
 	return res;
 }
 
+PrimitiveTypes::UInt32 PositionBufferCPUManager::forgetFile(const char *filename)
+{
+	return m_map.removeStartingWith(filename)
+		+ m_iBufferCPUMap.removeStartingWith(filename)
+		+ m_tcBufferCPUMap.removeStartingWith(filename)
+		+ m_nBufferCPUMap.removeStartingWith(filename)
+		+ m_tBufferCPUMap.removeStartingWith(filename)
+		+ m_SWCPUMap.removeStartingWith(filename)
+		+ m_MatSetMap.removeStartingWith(filename);
+}
+
 }; // namespace PE
@@ -46,6 +46,9 @@ struct PositionBufferCPUManager : PE::PEAllocatableAndDefragmentable
 	Handle ReadMaterialSetCPU(const char *filename, const char *package = NULL);
 	Handle ReadSkinWeights(const char *filename, const char *package, const char *tag);
 
+	// next Read* of the file reads it again (hot reload). buffers read before are not released, meshes may use them
+	PrimitiveTypes::UInt32 forgetFile(const char *filename);
+
 	static Handle s_myHandle;
 
 	StrToHandleMap m_map;
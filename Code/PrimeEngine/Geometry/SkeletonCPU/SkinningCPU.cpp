@@ -0,0 +1,313 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <math.h>
+#if PE_PLAT_IS_WIN32 || defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+// Inter-Engine includes
+#include "PrimeEngine/APIAbstraction/Timer/Timer.h"
+#include "PrimeEngine/Jobs/JobSystem.h"
+
+// Sibling/Children includes
+#include "SkinningCPU.h"
+
+namespace PE {
+
+using namespace PrimitiveTypes;
+
+SkinningCPU::SkinningCPU(PE::GameContext &context, PE::MemoryArena arena)
+: m_numVertices(0)
+, m_numGroups(0)
+, m_numInfluences(0)
+, m_numJoints(0)
+, m_hasNormals(false)
+, m_bindPositions(context, arena)
+, m_bindNormals(context, arena)
+, m_jointIndices(context, arena)
+, m_weights(context, arena)
+, m_numSkinnedVertices(0)
+, m_skinTime(0)
+{
+	m_arena = arena; m_pContext = &context;
+}
+
+void SkinningCPU::initialize(PositionBufferCPU &positions, NormalBufferCPU *pNormals, SkinWeightsCPU &weights)
+{
+	m_numVertices = positions.m_values.m_size / 3;
+	if (weights.m_weightsPerVertex.m_size < m_numVertices)
+		m_numVertices = weights.m_weightsPerVertex.m_size;
+	m_hasNormals = pNormals && pNormals->m_values.m_size / 3 >= m_numVertices;
+	m_numGroups = (m_numVertices + 3) / 4;
+
+	m_numInfluences = 1;
+	m_numJoints = 0;
+	for (UInt32 iv = 0; iv < m_numVertices; ++iv)
+	{
+		Array<WeightPair> &vertWeights = weights.m_weightsPerVertex[iv];
+		if (vertWeights.m_size > m_numInfluences)
+			m_numInfluences = vertWeights.m_size;
+		for (UInt32 iw = 0; iw < vertWeights.m_size; ++iw)
+		{
+			if (vertWeights[iw].m_jointIndex + 1 > m_numJoints)
+				m_numJoints = vertWeights[iw].m_jointIndex + 1;
+		}
+	}
+	PEASSERT(m_numJoints <= 0x10000, "joint index does not fit in 16 bits");
+
+	// arrays are zeroed on allocation, so padding vertices and missing influences get weight 0 (joint 0)
+	m_bindPositions.reset(m_numGroups * 12);
+	m_bindPositions.m_size = m_numGroups * 12;
+	m_bindNormals.reset(m_hasNormals ? m_numGroups * 12 : 0);
+	m_bindNormals.m_size = m_hasNormals ? m_numGroups * 12 : 0;
+	m_jointIndices.reset(m_numGroups * m_numInfluences * 4);
+	m_jointIndices.m_size = m_numGroups * m_numInfluences * 4;
+	m_weights.reset(m_numGroups * m_numInfluences * 4);
+	m_weights.m_size = m_numGroups * m_numInfluences * 4;
+
+	const Float32 *pSrc = positions.m_values.getFirstPtr();
+	const Float32 *pSrcNormals = m_hasNormals ? pNormals->m_values.getFirstPtr() : NULL;
+	Float32 *pPos = m_bindPositions.getFirstPtr();
+	Float32 *pNormal = m_hasNormals ? m_bindNormals.getFirstPtr() : NULL;
+	UInt16 *pJoints = m_jointIndices.getFirstPtr();
+	Float32 *pWeights = m_weights.getFirstPtr();
+
+	for (UInt32 iv = 0; iv < m_numVertices; ++iv)
+	{
+		UInt32 group = iv / 4, lane = iv % 4;
+		for (UInt32 c = 0; c < 3; ++c)
+		{
+			pPos[group * 12 + c * 4 + lane] = pSrc[iv * 3 + c];
+			if (pNormal)
+				pNormal[group * 12 + c * 4 + lane] = pSrcNormals[iv * 3 + c];
+		}
+
+		Array<WeightPair> &vertWeights = weights.m_weightsPerVertex[iv];
+		for (UInt32 iw = 0; iw < vertWeights.m_size; ++iw)
+		{
+			UInt32 index = (group * m_numInfluences + iw) * 4 + lane;
+			pJoints[index] = (UInt16)(vertWeights[iw].m_jointIndex);
+			pWeights[index] = vertWeights[iw].m_weight;
+		}
+	}
+}
+
+void SkinningCPU::PreparePalette(const Matrix4x4 *pPalette, const Matrix4x4 *pBindInverses, UInt32 numJoints, Float32 *pRes)
+{
+	for (UInt32 i = 0; i < numJoints; ++i)
+	{
+		Matrix4x4 m = pBindInverses ? pPalette[i] * pBindInverses[i] : pPalette[i];
+		// last row is 0 0 0 1 for skinning transforms
+		memcpy(pRes, &m.m[0][0], sizeof(Float32) * c_floatsPerJoint);
+		pRes += c_floatsPerJoint;
+	}
+}
+
+struct SkinningCPUJobParams
+{
+	SkinningCPU *m_pSkinning;
+	const Float32 *m_pSkinPalette;
+	Float32 *m_pPositionsOut;
+	Float32 *m_pNormalsOut;
+};
+
+static void SkinGroupsJob(void *pParams, int begin, int end)
+{
+	SkinningCPUJobParams *p = (SkinningCPUJobParams *)(pParams);
+	p->m_pSkinning->skinGroups(p->m_pSkinPalette, begin, end, p->m_pPositionsOut, p->m_pNormalsOut);
+}
+
+void SkinningCPU::skin(const Float32 *pSkinPalette, Float32 *pPositionsOut, Float32 *pNormalsOut, bool multithreaded)
+{
+	Timer t;
+
+	if (!m_hasNormals)
+		pNormalsOut = NULL;
+
+	if (multithreaded && m_numVertices > PE_SKINNING_CPU_VERTICES_PER_JOB)
+	{
+		SkinningCPUJobParams params;
+		params.m_pSkinning = this;
+		params.m_pSkinPalette = pSkinPalette;
+		params.m_pPositionsOut = pPositionsOut;
+		params.m_pNormalsOut = pNormalsOut;
+		JobSystem::parallelFor(m_numGroups, PE_SKINNING_CPU_VERTICES_PER_JOB / 4, &SkinGroupsJob, &params);
+	}
+	else
+	{
+		skinGroups(pSkinPalette, 0, m_numGroups, pPositionsOut, pNormalsOut);
+	}
+
+	m_numSkinnedVertices += m_numVertices;
+	m_skinTime += t.TickAndGetTimeDeltaInSeconds();
+}
+
+void SkinningCPU::skin(const Float32 *pSkinPalette, PositionBufferCPU &res, NormalBufferCPU *pResNormals, bool multithreaded)
+{
+	if (res.m_values.m_capacity < m_numVertices * 3)
+		res.m_values.reset(m_numVertices * 3);
+	res.m_values.m_size = m_numVertices * 3;
+
+	Float32 *pNormalsOut = NULL;
+	if (pResNormals && m_hasNormals)
+	{
+		if (pResNormals->m_values.m_capacity < m_numVertices * 3)
+			pResNormals->m_values.reset(m_numVertices * 3);
+		pResNormals->m_values.m_size = m_numVertices * 3;
+		pNormalsOut = pResNormals->m_values.getFirstPtr();
+	}
+
+	skin(pSkinPalette, res.m_values.getFirstPtr(), pNormalsOut, multithreaded);
+}
+
+#if PE_SKINNING_CPU_SSE
+
+// writes xyz of 4 lanes of x,y,z (transposed in place) to numVertices consecutive float3
+static inline void StoreFloat3(__m128 &x, __m128 &y, __m128 &z, Float32 *pOut, UInt32 numVertices)
+{
+	__m128 w = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+	__m128 v[4] = {x, y, z, w};
+	if (numVertices == 4)
+	{
+		// overlapping stores, each one overwrites 4th float of previous one. last vertex is stored
+		// without touching the float after it: next vertices may be written by other job
+		_mm_storeu_ps(pOut, v[0]);
+		_mm_storeu_ps(pOut + 3, v[1]);
+		_mm_storeu_ps(pOut + 6, v[2]);
+		_mm_store_ss(pOut + 9, v[3]);
+		_mm_store_ss(pOut + 10, _mm_shuffle_ps(v[3], v[3], _MM_SHUFFLE(1, 1, 1, 1)));
+		_mm_store_ss(pOut + 11, _mm_shuffle_ps(v[3], v[3], _MM_SHUFFLE(2, 2, 2, 2)));
+	}
+	else
+	{
+		for (UInt32 i = 0; i < numVertices; ++i)
+		{
+			Float32 tmp[4];
+			_mm_storeu_ps(tmp, v[i]);
+			pOut[i * 3] = tmp[0]; pOut[i * 3 + 1] = tmp[1]; pOut[i * 3 + 2] = tmp[2];
+		}
+	}
+}
+
+void SkinningCPU::skinGroups(const Float32 *pSkinPalette, UInt32 beginGroup, UInt32 endGroup, Float32 *pPositionsOut, Float32 *pNormalsOut)
+{
+	const Float32 *pBindPositions = m_bindPositions.getFirstPtr();
+	const Float32 *pBindNormals = pNormalsOut ? m_bindNormals.getFirstPtr() : NULL;
+	const UInt16 *pJoints = m_jointIndices.getFirstPtr();
+	const Float32 *pWeights = m_weights.getFirstPtr();
+
+	for (UInt32 g = beginGroup; g < endGroup; ++g)
+	{
+		// blend 3x4 matrix of each of 4 vertices: rows[row][lane]
+		__m128 rows[3][4];
+		const UInt16 *pGroupJoints = pJoints + g * m_numInfluences * 4;
+		const Float32 *pGroupWeights = pWeights + g * m_numInfluences * 4;
+		for (UInt32 lane = 0; lane < 4; ++lane)
+		{
+			__m128 r0 = _mm_setzero_ps(), r1 = _mm_setzero_ps(), r2 = _mm_setzero_ps();
+			for (UInt32 k = 0; k < m_numInfluences; ++k)
+			{
+				const Float32 *pJoint = pSkinPalette + pGroupJoints[k * 4 + lane] * c_floatsPerJoint;
+				__m128 w = _mm_set1_ps(pGroupWeights[k * 4 + lane]);
+				r0 = _mm_add_ps(r0, _mm_mul_ps(w, _mm_loadu_ps(pJoint)));
+				r1 = _mm_add_ps(r1, _mm_mul_ps(w, _mm_loadu_ps(pJoint + 4)));
+				r2 = _mm_add_ps(r2, _mm_mul_ps(w, _mm_loadu_ps(pJoint + 8)));
+			}
+			rows[0][lane] = r0; rows[1][lane] = r1; rows[2][lane] = r2;
+		}
+
+		// transpose so that each register has one matrix element of all 4 vertices
+		for (UInt32 row = 0; row < 3; ++row)
+			_MM_TRANSPOSE4_PS(rows[row][0], rows[row][1], rows[row][2], rows[row][3]);
+
+		UInt32 numVertices = m_numVertices - g * 4 < 4 ? m_numVertices - g * 4 : 4;
+
+		const Float32 *pPos = pBindPositions + g * 12;
+		__m128 x = _mm_loadu_ps(pPos), y = _mm_loadu_ps(pPos + 4), z = _mm_loadu_ps(pPos + 8);
+		__m128 res[3];
+		for (UInt32 row = 0; row < 3; ++row)
+		{
+			res[row] = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(rows[row][0], x), _mm_mul_ps(rows[row][1], y)),
+				_mm_add_ps(_mm_mul_ps(rows[row][2], z), rows[row][3]));
+		}
+		StoreFloat3(res[0], res[1], res[2], pPositionsOut + g * 12, numVertices);
+
+		if (pBindNormals)
+		{
+			// no translation. renormalize since blended matrix is not orthonormal
+			const Float32 *pNormal = pBindNormals + g * 12;
+			x = _mm_loadu_ps(pNormal); y = _mm_loadu_ps(pNormal + 4); z = _mm_loadu_ps(pNormal + 8);
+			for (UInt32 row = 0; row < 3; ++row)
+			{
+				res[row] = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(rows[row][0], x), _mm_mul_ps(rows[row][1], y)),
+					_mm_mul_ps(rows[row][2], z));
+			}
+			__m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(res[0], res[0]), _mm_mul_ps(res[1], res[1])), _mm_mul_ps(res[2], res[2]));
+			__m128 invLen = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_max_ps(len2, _mm_set1_ps(1e-20f))));
+			res[0] = _mm_mul_ps(res[0], invLen); res[1] = _mm_mul_ps(res[1], invLen); res[2] = _mm_mul_ps(res[2], invLen);
+			StoreFloat3(res[0], res[1], res[2], pNormalsOut + g * 12, numVertices);
+		}
+	}
+}
+
+#else
+
+void SkinningCPU::skinGroups(const Float32 *pSkinPalette, UInt32 beginGroup, UInt32 endGroup, Float32 *pPositionsOut, Float32 *pNormalsOut)
+{
+	const Float32 *pBindPositions = m_bindPositions.getFirstPtr();
+	const Float32 *pBindNormals = pNormalsOut ? m_bindNormals.getFirstPtr() : NULL;
+	const UInt16 *pJoints = m_jointIndices.getFirstPtr();
+	const Float32 *pWeights = m_weights.getFirstPtr();
+
+	// same layout as sse version, lanes are written as loops so that compiler can vectorize them
+	for (UInt32 g = beginGroup; g < endGroup; ++g)
+	{
+		Float32 m[12][4]; // element, lane
+		memset(m, 0, sizeof(m));
+		const UInt16 *pGroupJoints = pJoints + g * m_numInfluences * 4;
+		const Float32 *pGroupWeights = pWeights + g * m_numInfluences * 4;
+		for (UInt32 k = 0; k < m_numInfluences; ++k)
+		{
+			for (UInt32 lane = 0; lane < 4; ++lane)
+			{
+				const Float32 *pJoint = pSkinPalette + pGroupJoints[k * 4 + lane] * c_floatsPerJoint;
+				Float32 w = pGroupWeights[k * 4 + lane];
+				for (UInt32 e = 0; e < 12; ++e)
+					m[e][lane] += w * pJoint[e];
+			}
+		}
+
+		UInt32 numVertices = m_numVertices - g * 4 < 4 ? m_numVertices - g * 4 : 4;
+		const Float32 *pPos = pBindPositions + g * 12;
+		const Float32 *pNormal = pBindNormals ? pBindNormals + g * 12 : NULL;
+		for (UInt32 lane = 0; lane < numVertices; ++lane)
+		{
+			Float32 x = pPos[lane], y = pPos[4 + lane], z = pPos[8 + lane];
+			Float32 *pOut = pPositionsOut + (g * 4 + lane) * 3;
+			for (UInt32 row = 0; row < 3; ++row)
+				pOut[row] = m[row * 4][lane] * x + m[row * 4 + 1][lane] * y + m[row * 4 + 2][lane] * z + m[row * 4 + 3][lane];
+
+			if (pNormal)
+			{
+				x = pNormal[lane]; y = pNormal[4 + lane]; z = pNormal[8 + lane];
+				Float32 n[3];
+				for (UInt32 row = 0; row < 3; ++row)
+					n[row] = m[row * 4][lane] * x + m[row * 4 + 1][lane] * y + m[row * 4 + 2][lane] * z;
+				Float32 len2 = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+				Float32 invLen = 1.0f / sqrtf(len2 > 1e-20f ? len2 : 1e-20f);
+				pOut = pNormalsOut + (g * 4 + lane) * 3;
+				pOut[0] = n[0] * invLen; pOut[1] = n[1] * invLen; pOut[2] = n[2] * invLen;
+			}
+		}
+	}
+}
+
+#endif
+
+}; // namespace PE
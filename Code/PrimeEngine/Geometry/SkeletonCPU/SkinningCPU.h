@@ -0,0 +1,83 @@
+#ifndef __PYENGINE_2_0_SKINNING_CPU__
+#define __PYENGINE_2_0_SKINNING_CPU__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+#include "../../Utils/Array/Array.h"
+#include "../PositionBufferCPU/PositionBufferCPU.h"
+#include "../NormalBufferCPU/NormalBufferCPU.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+#include "SkinWeightsCPU.h"
+
+// sse on x86 (always there on x64), scalar code with the same data layout elsewhere
+#if PE_PLAT_IS_WIN32 || defined(__SSE__)
+#define PE_SKINNING_CPU_SSE 1
+#else
+#define PE_SKINNING_CPU_SSE 0
+#endif
+
+namespace PE {
+
+// CPU skinning of one mesh, for headless servers and apis without compute skinning.
+// Mesh data is converted once into streams laid out for 4 vertices at a time:
+// bind positions/normals as x[4] y[4] z[4], joint indices and weights as fixed width (max influences of the mesh)
+// with 4 vertices per influence. Missing influences and padding vertices have weight 0.
+// Palette is premultiplied with bind inverses once per frame per instance (PreparePalette()) and stored as 3x4 rows,
+// so every influence is one weighted sum of 3 rows. Streams are read only, so instances can share one SkinningCPU.
+struct SkinningCPU : PE::PEAllocatableAndDefragmentable
+{
+	static const PrimitiveTypes::UInt32 c_floatsPerJoint = 12; // 3x4 rows in palette
+
+	SkinningCPU(PE::GameContext &context, PE::MemoryArena arena);
+
+	// pNormals can be NULL
+	void initialize(PositionBufferCPU &positions, NormalBufferCPU *pNormals, SkinWeightsCPU &weights);
+
+	// pRes[i] = pPalette[i] * pBindInverses[i] as 3x4 rows, numJoints * c_floatsPerJoint floats.
+	// pBindInverses can be NULL if palette already has them (SkeletonCPU::applyInverses())
+	static void PreparePalette(const Matrix4x4 *pPalette, const Matrix4x4 *pBindInverses, PrimitiveTypes::UInt32 numJoints, PrimitiveTypes::Float32 *pRes);
+
+	// skins all vertices into xyz float arrays of m_numVertices * 3. pNormalsOut can be NULL.
+	// meshes over PE_SKINNING_CPU_VERTICES_PER_JOB vertices are split across job system workers if multithreaded
+	void skin(const PrimitiveTypes::Float32 *pSkinPalette, PrimitiveTypes::Float32 *pPositionsOut, PrimitiveTypes::Float32 *pNormalsOut, bool multithreaded = true);
+
+	// sizes buffers once and skins into them
+	void skin(const PrimitiveTypes::Float32 *pSkinPalette, PositionBufferCPU &res, NormalBufferCPU *pResNormals, bool multithreaded = true);
+
+	// groups of 4 vertices [beginGroup, endGroup)
+	void skinGroups(const PrimitiveTypes::Float32 *pSkinPalette, PrimitiveTypes::UInt32 beginGroup, PrimitiveTypes::UInt32 endGroup,
+		PrimitiveTypes::Float32 *pPositionsOut, PrimitiveTypes::Float32 *pNormalsOut);
+
+	// throughput of skin() calls so far. not updated atomically: stats are off if instances sharing this are skinned in parallel
+	PrimitiveTypes::Float32 getVerticesPerMs() { return m_skinTime > 0 ? (PrimitiveTypes::Float32)(m_numSkinnedVertices / (m_skinTime * 1000.0)) : 0; }
+
+	PrimitiveTypes::UInt32 m_numVertices;
+	PrimitiveTypes::UInt32 m_numGroups; // of 4 vertices, last one is padded
+	PrimitiveTypes::UInt32 m_numInfluences; // width of joint and weight streams
+	PrimitiveTypes::UInt32 m_numJoints; // highest joint index + 1
+	bool m_hasNormals;
+
+	Array<PrimitiveTypes::Float32> m_bindPositions; // per group x[4] y[4] z[4]
+	Array<PrimitiveTypes::Float32> m_bindNormals;
+	Array<PrimitiveTypes::UInt16> m_jointIndices; // per group, per influence [4]
+	Array<PrimitiveTypes::Float32> m_weights;
+
+	double m_numSkinnedVertices;
+	double m_skinTime; // seconds
+
+	PE::MemoryArena m_arena; PE::GameContext *m_pContext;
+};
+
+}; // namespace PE
+
+#endif
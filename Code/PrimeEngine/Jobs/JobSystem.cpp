@@ -0,0 +1,432 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+#include "JobSystem.h"
+
+// Outer-Engine includes
+#include <string.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Utils/ErrorHandling.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+JobSystem *JobSystem::s_pInstance = NULL;
+
+// index of worker running on this thread, -1 for game, render, server and other threads
+static PE_THREAD_LOCAL int s_workerIndex = -1;
+
+// batches per thread in parallelFor(), more batches balance uneven items better
+#define PE_PARALLEL_FOR_BATCHES_PER_THREAD 4
+#define PE_PARALLEL_FOR_MAX_BATCHES (PE_PARALLEL_FOR_BATCHES_PER_THREAD * (PE_JOB_SYSTEM_MAX_WORKERS + 1))
+
+bool JobDeque::push(const Job &job)
+{
+	m_lock.lock();
+	if (m_bottom - m_top >= PE_JOB_QUEUE_SIZE)
+	{
+		m_lock.unlock();
+		return false;
+	}
+	m_jobs[m_bottom & (PE_JOB_QUEUE_SIZE - 1)] = job;
+	++m_bottom;
+	m_lock.unlock();
+	return true;
+}
+
+bool JobDeque::pop(Job &outJob)
+{
+	m_lock.lock();
+	if (m_bottom == m_top)
+	{
+		m_lock.unlock();
+		return false;
+	}
+	--m_bottom;
+	outJob = m_jobs[m_bottom & (PE_JOB_QUEUE_SIZE - 1)];
+	m_lock.unlock();
+	return true;
+}
+
+bool JobDeque::steal(Job &outJob)
+{
+	m_lock.lock();
+	if (m_bottom == m_top)
+	{
+		m_lock.unlock();
+		return false;
+	}
+	outJob = m_jobs[m_top & (PE_JOB_QUEUE_SIZE - 1)];
+	++m_top;
+	m_lock.unlock();
+	return true;
+}
+
+JobSystem::JobSystem(int numWorkers)
+: m_numWorkers(numWorkers)
+, m_numQueuedJobs(0)
+, m_numSleeping(0)
+, m_sleepCV(m_sleepLock)
+, m_numDeferredJobs(0)
+, m_numDeferredJobsAtomic(0)
+, m_numJobsOnCallers(0)
+, m_numJobsOnCallersAtFrameEnd(0)
+{
+	PEASSERT((PE_JOB_QUEUE_SIZE & (PE_JOB_QUEUE_SIZE - 1)) == 0, "PE_JOB_QUEUE_SIZE has to be power of 2");
+
+	memset(&m_lastFrameStats, 0, sizeof(m_lastFrameStats));
+	m_lastFrameStats.m_numWorkers = m_numWorkers;
+	m_lastFrameEndTime = m_frameTimer.TickAndGetCurrentTime();
+
+	for (int i = 0; i < m_numWorkers; ++i)
+	{
+		Worker &worker = m_workers[i];
+		worker.m_pJobSystem = this;
+		worker.m_index = i;
+		worker.m_thread.m_function = &JobSystem::WorkerThreadFunction;
+		worker.m_thread.m_pParams = &worker;
+		worker.m_thread.run();
+	}
+}
+
+void JobSystem::Construct(PE::MemoryArena arena, int numWorkers)
+{
+	if (s_pInstance)
+		return;
+
+	if (numWorkers < 0)
+	{
+		// game and render threads run jobs too while they wait, leave them their cores
+		numWorkers = Threading::GetNumHardwareThreads() - 2;
+	}
+	if (numWorkers < 1)
+		numWorkers = 1;
+	if (numWorkers > PE_JOB_SYSTEM_MAX_WORKERS)
+		numWorkers = PE_JOB_SYSTEM_MAX_WORKERS;
+
+	s_pInstance = new(arena) JobSystem(numWorkers);
+
+	PEINFO("PROGRESS: JobSystem constructed with %d worker threads\n", numWorkers);
+}
+
+void JobSystem::WorkerThreadFunction(void *params)
+{
+	Worker *pWorker = static_cast<Worker *>(params);
+	s_workerIndex = pWorker->m_index;
+	pWorker->m_pJobSystem->workerLoop(*pWorker);
+}
+
+void JobSystem::workerLoop(Worker &worker)
+{
+	Timer timer;
+	while (1)
+	{
+		Job job;
+		bool stolen = false;
+		if (findJob(worker.m_index, job, stolen))
+		{
+			timer.Tick();
+			execute(job);
+			worker.m_busyTime = worker.m_busyTime + timer.TickAndGetTimeDeltaInSeconds();
+			Threading::AtomicIncrement(&worker.m_numJobs);
+			if (stolen)
+				Threading::AtomicIncrement(&worker.m_numSteals);
+			continue;
+		}
+
+		// nothing to do. sleep until something is kicked.
+		// kick() adds to m_numQueuedJobs before it reads m_numSleeping, we do the opposite, so one of us sees the other
+		m_sleepLock.lock();
+		Threading::AtomicIncrement(&m_numSleeping);
+		while (Threading::AtomicLoad(&m_numQueuedJobs) <= 0)
+			m_sleepCV.sleep();
+		Threading::AtomicDecrement(&m_numSleeping);
+		m_sleepLock.unlock();
+	}
+}
+
+int JobSystem::getQueueIndex()
+{
+	return s_workerIndex >= 0 ? s_workerIndex : m_numWorkers;
+}
+
+bool JobSystem::findJob(int queueIndex, Job &outJob, bool &outStolen)
+{
+	outStolen = false;
+	JobDeque &own = queueIndex < m_numWorkers ? m_workers[queueIndex].m_deque : m_sharedDeque;
+	if (own.pop(outJob))
+	{
+		Threading::AtomicDecrement(&m_numQueuedJobs);
+		return true;
+	}
+
+	if (Threading::AtomicLoad(&m_numQueuedJobs) <= 0)
+		return false;
+
+	// shared queue first (jobs kicked by game/render thread), then other workers starting with our neighbor
+	if (queueIndex < m_numWorkers && m_sharedDeque.steal(outJob))
+	{
+		Threading::AtomicDecrement(&m_numQueuedJobs);
+		outStolen = true;
+		return true;
+	}
+
+	for (int i = 1; i <= m_numWorkers; ++i)
+	{
+		int victim = (queueIndex + i) % (m_numWorkers + 1);
+		if (victim == m_numWorkers)
+			continue; // shared queue, already checked
+		if (m_workers[victim].m_deque.steal(outJob))
+		{
+			Threading::AtomicDecrement(&m_numQueuedJobs);
+			outStolen = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::execute(const Job &job)
+{
+	(*job.m_function)(job.m_pParams);
+
+	if (job.m_pCounter)
+	{
+		// counter may go out of scope as soon as it reaches 0, don't touch it after that except for deferred jobs
+		JobCounter *pCounter = job.m_pCounter;
+		if (Threading::AtomicDecrement(&pCounter->m_value) == 0 && Threading::AtomicLoad(&m_numDeferredJobsAtomic) > 0)
+			kickDeferred(pCounter);
+	}
+}
+
+void JobSystem::push(const Job *pJobs, int numJobs)
+{
+	int queueIndex = getQueueIndex();
+	JobDeque &deque = queueIndex < m_numWorkers ? m_workers[queueIndex].m_deque : m_sharedDeque;
+
+	int numPushed = 0;
+	for (int i = 0; i < numJobs; ++i)
+	{
+		if (deque.push(pJobs[i]))
+		{
+			++numPushed;
+		}
+		else
+		{
+			// queue is full, this thread runs the job itself
+			if (s_workerIndex < 0)
+				Threading::AtomicIncrement(&m_numJobsOnCallers);
+			else
+				Threading::AtomicIncrement(&m_workers[s_workerIndex].m_numJobs);
+			execute(pJobs[i]);
+		}
+	}
+
+	if (numPushed == 0)
+		return;
+
+	Threading::AtomicAdd(&m_numQueuedJobs, numPushed);
+	if (Threading::AtomicLoad(&m_numSleeping) > 0)
+	{
+		m_sleepLock.lock();
+		if (numPushed > 1)
+			m_sleepCV.broadcast();
+		else
+			m_sleepCV.signal();
+		m_sleepLock.unlock();
+	}
+}
+
+void JobSystem::kick(const Job *pJobs, int numJobs)
+{
+	// counters first, otherwise a counter could reach 0 while its later jobs are not kicked yet
+	for (int i = 0; i < numJobs; ++i)
+	{
+		if (pJobs[i].m_pCounter)
+			Threading::AtomicIncrement(&pJobs[i].m_pCounter->m_value);
+	}
+	push(pJobs, numJobs);
+}
+
+void JobSystem::kickAfter(JobCounter *pDependency, const Job *pJobs, int numJobs)
+{
+	for (int i = 0; i < numJobs; ++i)
+	{
+		if (pJobs[i].m_pCounter)
+			Threading::AtomicIncrement(&pJobs[i].m_pCounter->m_value);
+	}
+
+	m_deferredLock.lock();
+	// announce deferred jobs before checking the dependency. execute() decrements the dependency before it checks for deferred jobs
+	Threading::AtomicAdd(&m_numDeferredJobsAtomic, numJobs);
+	if (pDependency->isDone() || m_numDeferredJobs + numJobs > PE_JOB_SYSTEM_MAX_DEFERRED_JOBS)
+	{
+		Threading::AtomicAdd(&m_numDeferredJobsAtomic, -numJobs);
+		m_deferredLock.unlock();
+
+		// when out of deferred slots, help until dependency is done
+		wait(pDependency);
+		push(pJobs, numJobs);
+		return;
+	}
+
+	for (int i = 0; i < numJobs; ++i)
+	{
+		m_deferred[m_numDeferredJobs].m_pDependency = pDependency;
+		m_deferred[m_numDeferredJobs].m_job = pJobs[i];
+		++m_numDeferredJobs;
+	}
+	m_deferredLock.unlock();
+}
+
+void JobSystem::kickDeferred(JobCounter *pDependency)
+{
+	Job ready[PE_JOB_SYSTEM_MAX_DEFERRED_JOBS];
+	int numReady = 0;
+
+	m_deferredLock.lock();
+	for (int i = 0; i < m_numDeferredJobs; )
+	{
+		// dependency of a deferred job is alive until the job is kicked, so it can be read here
+		if (m_deferred[i].m_pDependency == pDependency && pDependency->isDone())
+		{
+			ready[numReady++] = m_deferred[i].m_job;
+			m_deferred[i] = m_deferred[--m_numDeferredJobs];
+		}
+		else
+		{
+			++i;
+		}
+	}
+	Threading::AtomicAdd(&m_numDeferredJobsAtomic, -numReady);
+	m_deferredLock.unlock();
+
+	if (numReady)
+		push(ready, numReady);
+}
+
+void JobSystem::wait(JobCounter *pCounter)
+{
+	int queueIndex = getQueueIndex();
+	while (!pCounter->isDone())
+	{
+		Job job;
+		bool stolen = false;
+		if (findJob(queueIndex, job, stolen))
+		{
+			if (s_workerIndex < 0)
+			{
+				Threading::AtomicIncrement(&m_numJobsOnCallers);
+			}
+			else
+			{
+				Threading::AtomicIncrement(&m_workers[s_workerIndex].m_numJobs);
+				if (stolen)
+					Threading::AtomicIncrement(&m_workers[s_workerIndex].m_numSteals);
+			}
+			execute(job);
+		}
+		else
+		{
+			// remaining jobs are running on other threads
+			Threading::SleepMilliseconds(0);
+		}
+	}
+}
+
+struct ParallelForBatch
+{
+	ParallelForFunction m_function;
+	void *m_pParams;
+	int m_begin;
+	int m_end;
+};
+
+static void ParallelForJob(void *params)
+{
+	ParallelForBatch *pBatch = static_cast<ParallelForBatch *>(params);
+	(*pBatch->m_function)(pBatch->m_pParams, pBatch->m_begin, pBatch->m_end);
+}
+
+void JobSystem::parallelFor(int count, int minBatchSize, ParallelForFunction function, void *pParams)
+{
+	if (count <= 0)
+		return;
+
+	JobSystem *pJobSystem = Instance();
+	if (minBatchSize < 1)
+		minBatchSize = 1;
+
+	int numBatches = (count + minBatchSize - 1) / minBatchSize;
+	if (pJobSystem)
+	{
+		int maxBatches = PE_PARALLEL_FOR_BATCHES_PER_THREAD * (pJobSystem->m_numWorkers + 1);
+		if (numBatches > maxBatches)
+			numBatches = maxBatches;
+	}
+
+	if (!pJobSystem || numBatches <= 1)
+	{
+		(*function)(pParams, 0, count);
+		return;
+	}
+
+	ParallelForBatch batches[PE_PARALLEL_FOR_MAX_BATCHES];
+	Job jobs[PE_PARALLEL_FOR_MAX_BATCHES];
+	JobCounter counter;
+
+	for (int i = 0; i < numBatches; ++i)
+	{
+		batches[i].m_function = function;
+		batches[i].m_pParams = pParams;
+		batches[i].m_begin = (int)((long long)(count) * i / numBatches);
+		batches[i].m_end = (int)((long long)(count) * (i + 1) / numBatches);
+		jobs[i] = Job(&ParallelForJob, &batches[i], &counter);
+	}
+
+	// first batch runs on this thread right away, rest is picked up by workers (or by us in wait())
+	pJobSystem->kick(&jobs[1], numBatches - 1);
+	ParallelForJob(&batches[0]);
+	pJobSystem->wait(&counter);
+}
+
+void JobSystem::frameEnd()
+{
+	Timer::TimeType now = m_frameTimer.TickAndGetCurrentTime();
+	float frameTime = Timer::GetTimeDeltaInSeconds(m_lastFrameEndTime, now);
+	m_lastFrameEndTime = now;
+
+	FrameStats &stats = m_lastFrameStats;
+	stats.m_numWorkers = m_numWorkers;
+	stats.m_numJobs = 0;
+	stats.m_numSteals = 0;
+
+	for (int i = 0; i < m_numWorkers; ++i)
+	{
+		Worker &worker = m_workers[i];
+
+		double busyTime = worker.m_busyTime;
+		stats.m_utilization[i] = frameTime > 0 ? (float)((busyTime - worker.m_busyTimeAtFrameEnd) / frameTime) : 0.0f;
+		if (stats.m_utilization[i] > 1.0f)
+			stats.m_utilization[i] = 1.0f; // job started in previous frame
+		worker.m_busyTimeAtFrameEnd = busyTime;
+
+		long numJobs = Threading::AtomicLoad(&worker.m_numJobs);
+		stats.m_numJobs += (PrimitiveTypes::UInt32)(numJobs - worker.m_numJobsAtFrameEnd);
+		worker.m_numJobsAtFrameEnd = numJobs;
+
+		long numSteals = Threading::AtomicLoad(&worker.m_numSteals);
+		stats.m_numSteals += (PrimitiveTypes::UInt32)(numSteals - worker.m_numStealsAtFrameEnd);
+		worker.m_numStealsAtFrameEnd = numSteals;
+	}
+
+	long numJobsOnCallers = Threading::AtomicLoad(&m_numJobsOnCallers);
+	stats.m_numJobsOnCallers = (PrimitiveTypes::UInt32)(numJobsOnCallers - m_numJobsOnCallersAtFrameEnd);
+	m_numJobsOnCallersAtFrameEnd = numJobsOnCallers;
+	stats.m_numJobs += stats.m_numJobsOnCallers;
+}
+
+}; // namespace PE
@@ -0,0 +1,177 @@
+#ifndef __PYENGINE_2_0_JOB_SYSTEM_H__
+#define __PYENGINE_2_0_JOB_SYSTEM_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/APIAbstraction/Threading/Threading.h"
+#include "PrimeEngine/APIAbstraction/Timer/Timer.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+typedef void (*JobFunction)(void *pParams);
+
+// body of parallelFor(), processes items [begin, end)
+typedef void (*ParallelForFunction)(void *pParams, int begin, int end);
+
+// number of unfinished jobs kicked with this counter. incremented by kick(), decremented when a job finishes.
+// wait on it with JobSystem::wait(). must stay alive until it reaches 0
+struct JobCounter
+{
+	JobCounter() : m_value(0) {}
+
+	bool isDone() { return Threading::AtomicLoad(&m_value) == 0; }
+
+	Threading::AtomicInt m_value;
+};
+
+struct Job
+{
+	Job() : m_function(NULL), m_pParams(NULL), m_pCounter(NULL) {}
+	Job(JobFunction function, void *pParams, JobCounter *pCounter = NULL)
+		: m_function(function), m_pParams(pParams), m_pCounter(pCounter)
+	{}
+
+	JobFunction m_function;
+	void *m_pParams;
+	JobCounter *m_pCounter; // can be NULL
+};
+
+// double ended queue of one worker. owner pushes and pops at the bottom (newest job, its data is still in cache),
+// other threads steal from the top (oldest job). every queue has its own lock so it is only contended while being stolen from
+struct JobDeque
+{
+	JobDeque() : m_top(0), m_bottom(0) {}
+
+	// false if full
+	bool push(const Job &job);
+	bool pop(Job &outJob);
+	bool steal(Job &outJob);
+
+	Threading::Mutex m_lock;
+	Job m_jobs[PE_JOB_QUEUE_SIZE];
+	PrimitiveTypes::UInt32 m_top; // both grow, index into m_jobs is masked. size is m_bottom - m_top
+	PrimitiveTypes::UInt32 m_bottom;
+};
+
+// Worker pool with work stealing. Shared by all engine threads: game, render and server thread (and their jobs) can kick jobs.
+// Workers take jobs from their own queue first, then from the queue shared by non-worker threads, then steal from other workers.
+// Threads that wait for a counter run jobs until it reaches 0, so waiting inside a job doesn't deadlock.
+// Jobs must not allocate handles or send events: memory manager and component system are not thread safe.
+// Jobs should only write memory owned by their range/item and read data that no other job writes.
+struct JobSystem : PE::PEAllocatable
+{
+	// per worker utilization during last frame (between frameEnd() calls)
+	struct FrameStats
+	{
+		int m_numWorkers;
+		PrimitiveTypes::Float32 m_utilization[PE_JOB_SYSTEM_MAX_WORKERS]; // 0..1, time running jobs / frame time
+		PrimitiveTypes::UInt32 m_numJobs; // run by workers and non-worker threads
+		PrimitiveTypes::UInt32 m_numJobsOnCallers; // run by non-worker threads while waiting or because queue was full
+		PrimitiveTypes::UInt32 m_numSteals;
+	};
+
+	JobSystem(int numWorkers);
+
+	// numWorkers < 0: number of cpus minus game and render thread.
+	// does nothing if already constructed since game and server context share the pool.
+	// allocated from arena, not with a handle: headless server has no memory manager
+	static void Construct(PE::MemoryArena arena, int numWorkers = PE_JOB_SYSTEM_NUM_WORKERS);
+
+	static JobSystem *Instance() { return s_pInstance; }
+
+	// increments counters of all jobs before any of them is queued
+	void kick(const Job *pJobs, int numJobs);
+	void kick(const Job &job) { kick(&job, 1); }
+
+	// jobs are kicked once pDependency reaches 0. pDependency has to stay alive until then,
+	// so wait for counters of the jobs, not only for pDependency
+	void kickAfter(JobCounter *pDependency, const Job *pJobs, int numJobs);
+
+	// runs jobs while counter is not 0
+	void wait(JobCounter *pCounter);
+
+	// calls function for ranges of [0, count) on workers and on calling thread, returns when all are done.
+	// ranges are at least minBatchSize items. runs on calling thread if there is no job system or count is small
+	static void parallelFor(int count, int minBatchSize, ParallelForFunction function, void *pParams);
+
+	// called by game thread once a frame, computes m_lastFrameStats
+	void frameEnd();
+
+	int getNumWorkers() { return m_numWorkers; }
+
+	static JobSystem *s_pInstance;
+
+	FrameStats m_lastFrameStats;
+
+private:
+	struct Worker
+	{
+		Worker() : m_pJobSystem(NULL), m_index(0), m_busyTime(0), m_busyTimeAtFrameEnd(0), m_numJobs(0), m_numJobsAtFrameEnd(0), m_numSteals(0), m_numStealsAtFrameEnd(0) {}
+
+		JobDeque m_deque;
+		Threading::PEThread m_thread;
+		JobSystem *m_pJobSystem;
+		int m_index;
+
+		// written by worker only. read by frameEnd() for stats
+		volatile double m_busyTime;
+		double m_busyTimeAtFrameEnd;
+		Threading::AtomicInt m_numJobs;
+		long m_numJobsAtFrameEnd;
+		Threading::AtomicInt m_numSteals;
+		long m_numStealsAtFrameEnd;
+	};
+
+	struct DeferredJob
+	{
+		JobCounter *m_pDependency;
+		Job m_job;
+	};
+
+	static void WorkerThreadFunction(void *params);
+	void workerLoop(Worker &worker);
+
+	// own (or shared) queue first, then steal
+	bool findJob(int queueIndex, Job &outJob, bool &outStolen);
+	void execute(const Job &job);
+	// queues jobs, counters are already incremented
+	void push(const Job *pJobs, int numJobs);
+	void kickDeferred(JobCounter *pDependency);
+
+	// workers index into m_workers, other threads use m_numWorkers (shared queue)
+	int getQueueIndex();
+
+	int m_numWorkers;
+	Worker m_workers[PE_JOB_SYSTEM_MAX_WORKERS];
+	JobDeque m_sharedDeque; // jobs kicked by non-worker threads
+
+	Threading::AtomicInt m_numQueuedJobs;
+	Threading::AtomicInt m_numSleeping;
+	Threading::Mutex m_sleepLock;
+	Threading::ConditionVariable m_sleepCV;
+
+	DeferredJob m_deferred[PE_JOB_SYSTEM_MAX_DEFERRED_JOBS];
+	int m_numDeferredJobs; // protected by m_deferredLock
+	Threading::AtomicInt m_numDeferredJobsAtomic; // read without lock when a counter reaches 0
+	Threading::Mutex m_deferredLock;
+
+	Threading::AtomicInt m_numJobsOnCallers;
+	long m_numJobsOnCallersAtFrameEnd;
+
+	Timer m_frameTimer;
+	Timer::TimeType m_lastFrameEndTime;
+};
+
+}; // namespace PE
+
+#endif
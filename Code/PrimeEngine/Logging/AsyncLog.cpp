@@ -0,0 +1,720 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stddef.h>
+#if APIABSTRACTION_D3D9 || APIABSTRACTION_D3D11 || (APIABSTRACTION_OGL && APIABSTRACTION_GLPC)
+#define _WINSOCKAPI_   /* Prevent inclusion of winsock.h in windows.h */
+#include <windows.h>
+#endif
+
+// Inter-Engine includes
+#include "PrimeEngine/APIAbstraction/Threading/Threading.h"
+#include "PrimeEngine/APIAbstraction/Timer/Timer.h"
+
+// Sibling/Children includes
+#include "AsyncLog.h"
+
+#if PE_PLAT_IS_WIN32
+#define PE_LOG_VSNPRINTF(buf, size, format, ap) _vsnprintf_s(buf, size, _TRUNCATE, format, ap)
+#else
+#define PE_LOG_VSNPRINTF(buf, size, format, ap) vsnprintf(buf, size, format, ap)
+#endif
+
+// binary log file, native byte order (little endian on all current platforms). Tools/PyClient/logdump.py reads it
+//   file header: "PELG", u32 version
+//   Record_Site (before first message of site): u32 id, u8 severity, u8 category, u8 flags, u32 line,
+//     u16 length + file, u16 length + format, u8 numArgs, numArgs x u8 LogSite::ArgKind
+//   Record_Message: u32 site id, u32 time ms, u8 thread, u16 suppressed, u16 size + arguments
+//     (ints, doubles and pointers 8 bytes, strings u16 length + chars; preformatted sites have one string).
+//     suppressed: low 15 bits by rate limit, high bit (c_truncatedBit) arguments didn't fit in record, message
+//     ends after last recorded argument
+//   Record_Dropped: u8 thread, u32 messages dropped since last Record_Dropped of thread
+#define PE_LOG_FILE_VERSION 2
+
+namespace PE {
+
+using namespace PrimitiveTypes;
+
+volatile int LogSite::s_minSeverity = LogSeverity_Info;
+volatile int LogSite::s_categoryMask = -1;
+
+volatile long AsyncLog::s_running = 0;
+volatile long AsyncLog::s_window = 0;
+volatile long AsyncLog::s_timeMs = 0;
+int AsyncLog::s_rateLimit = PE_LOG_RATE_LIMIT;
+bool AsyncLog::s_printToConsole = true;
+AsyncLog::SinkFunction AsyncLog::s_sink = NULL;
+
+namespace {
+
+enum ERecordType
+{
+	Record_Site = 1,
+	Record_Message,
+	Record_Dropped,
+};
+
+const char *c_severityPrefixes[LogSeverity_Count] = {"PE: Info: ", "PE: Warning: ", "PE: Error: "};
+
+const UInt32 c_maxRecordSize = 1024; // header and arguments, long strings are cut
+const UInt32 c_maxStringLength = 512;
+const UInt32 c_maxTextLength = 4096;
+const UInt16 c_truncatedBit = 0x8000; // in RecordHeader::m_suppressed
+
+struct RecordHeader
+{
+	LogSite *m_pSite; // NULL: rest of ring is unused, next record is at 0
+	UInt16 m_size; // header and arguments. records start at multiples of 16
+	UInt16 m_suppressed; // by rate limit before this message, c_truncatedBit if arguments were cut
+	UInt32 m_time;
+};
+
+UInt32 RecordStride(UInt32 size) { return (size + 15) & ~15; }
+
+// single producer (thread that owns it), single consumer (log thread)
+struct Ring
+{
+	char m_data[PE_LOG_RING_SIZE];
+	Threading::AtomicInt m_head; // next write, only producer changes it
+	Threading::AtomicInt m_tail; // next read, only consumer changes it
+
+	UInt32 m_numRecorded; // producer
+	UInt32 m_numRateLimited; // producer
+	UInt32 m_numDropped; // producer
+	UInt32 m_numDroppedReported; // consumer
+
+	// false if ring is full
+	bool write(const char *pRecord, UInt32 size)
+	{
+		UInt32 stride = RecordStride(size);
+		UInt32 head = (UInt32)(m_head);
+		UInt32 tail = (UInt32)(Threading::AtomicLoadAcquire(&m_tail));
+		UInt32 start = head;
+
+		// head == tail is empty, so head never catches up with tail
+		if (head >= tail)
+		{
+			if (head + stride > PE_LOG_RING_SIZE || (head + stride == PE_LOG_RING_SIZE && tail == 0))
+			{
+				if (stride >= tail)
+					return false;
+				((RecordHeader *)(m_data + head))->m_pSite = NULL;
+				start = 0;
+			}
+		}
+		else if (head + stride >= tail)
+			return false;
+
+		memcpy(m_data + start, pRecord, size);
+		UInt32 newHead = start + stride;
+		Threading::AtomicStoreRelease(&m_head, newHead == PE_LOG_RING_SIZE ? 0 : newHead);
+		return true;
+	}
+};
+
+Ring s_rings[PE_LOG_MAX_THREADS]; // static, threads may log before or without engine allocators
+Threading::AtomicInt s_numRings = 0;
+Threading::AtomicInt s_nextSiteId = 0;
+Threading::AtomicInt s_numSynchronous = 0;
+Threading::AtomicInt s_threadDone = 1;
+Threading::AtomicInt s_numDrains = 0;
+UInt32 s_numWritten = 0; // log thread
+FILE *s_pFile = NULL;
+unsigned char s_fileGeneration = 0; // LogSite::m_writtenToFile of sites already in current file
+Threading::PEThread s_thread;
+
+PE_THREAD_LOCAL Ring *t_pRing = NULL;
+PE_THREAD_LOCAL int t_hasNoRing = 0;
+
+Ring *GetThreadRing()
+{
+	if (t_pRing)
+		return t_pRing;
+	if (t_hasNoRing)
+		return NULL;
+
+	long index = Threading::AtomicIncrement(&s_numRings) - 1;
+	if (index >= PE_LOG_MAX_THREADS)
+	{
+		t_hasNoRing = 1;
+		return NULL;
+	}
+	t_pRing = &s_rings[index];
+	return t_pRing;
+}
+
+int FormatArg(char *pText, UInt32 size, const char *spec, ...)
+{
+	va_list args;
+	va_start(args, spec);
+	int len = PE_LOG_VSNPRINTF(pText, size, spec, args);
+	va_end(args);
+	return len;
+}
+
+// one printf conversion, p points after '%'. kind is -1 for "%%", false for conversions log thread can't redo
+bool ParseConversion(const char *&p, int &kind, int &numStars)
+{
+	numStars = 0;
+	if (*p == '%')
+	{
+		++p;
+		kind = -1;
+		return true;
+	}
+
+	while (*p && strchr("-+ #0", *p))
+		++p;
+	if (*p == '*') { ++numStars; ++p; }
+	while (*p >= '0' && *p <= '9')
+		++p;
+	if (*p == '.')
+	{
+		++p;
+		if (*p == '*') { ++numStars; ++p; }
+		while (*p >= '0' && *p <= '9')
+			++p;
+	}
+
+	int intKind = LogSite::Arg_Int;
+	bool wide = false;
+	if (p[0] == 'h')
+		p += p[1] == 'h' ? 2 : 1;
+	else if (p[0] == 'l' && p[1] == 'l')
+		{ intKind = LogSite::Arg_LongLong; p += 2; }
+	else if (p[0] == 'l')
+		{ intKind = LogSite::Arg_Long; wide = true; ++p; }
+	else if (p[0] == 'q' || p[0] == 'j')
+		{ intKind = LogSite::Arg_LongLong; ++p; }
+	else if (p[0] == 'I' && p[1] == '6' && p[2] == '4')
+		{ intKind = LogSite::Arg_LongLong; p += 3; }
+	else if (p[0] == 'z' || p[0] == 't' || p[0] == 'I')
+		{ intKind = LogSite::Arg_SizeT; ++p; }
+	else if (p[0] == 'L')
+		return false; // long double
+
+	char c = *p;
+	if (!c)
+		return false;
+	++p;
+	if (strchr("diuoxXc", c))
+		kind = (c == 'c' && wide) ? -2 : intKind;
+	else if (strchr("eEfFgGaA", c))
+		kind = LogSite::Arg_Double;
+	else if (c == 's')
+		kind = wide ? -2 : LogSite::Arg_String;
+	else if (c == 'p')
+		kind = LogSite::Arg_Pointer;
+	else
+		kind = -2; // %n, %S, %C, unknown
+
+	return kind != -2;
+}
+
+// argument kinds of format. false if it has conversions log thread can't redo
+bool ParseFormat(const char *format, unsigned char *kinds, int &numKinds)
+{
+	numKinds = 0;
+	for (const char *p = format; *p;)
+	{
+		if (*p++ != '%')
+			continue;
+		int kind, numStars;
+		if (!ParseConversion(p, kind, numStars))
+			return false;
+		if (kind == -1)
+			continue;
+		if (numKinds + numStars + 1 > LogSite::c_maxArgs)
+			return false;
+		for (int i = 0; i < numStars; ++i)
+			kinds[numKinds++] = LogSite::Arg_Int;
+		kinds[numKinds++] = (unsigned char)(kind);
+	}
+	return true;
+}
+
+void Register(LogSite *pSite)
+{
+	int numKinds = 0;
+	bool ok = ParseFormat(pSite->m_format, pSite->m_argKinds, numKinds);
+	pSite->m_numArgs = ok ? (unsigned char)(numKinds) : 0;
+	pSite->m_flags = ok ? 0 : LogSite::Flag_Preformatted;
+
+	// two threads registering same site at once parse the same kinds, one of the ids is not used
+	long id = Threading::AtomicIncrement(&s_nextSiteId);
+	Threading::AtomicCompareExchange(&pSite->m_id, id, 0);
+}
+
+// string is cut to c_maxStringLength and to space left in record. sets truncated if it didn't fit whole
+char *PutString(char *p, char *pEnd, const char *str, bool &truncated)
+{
+	if (pEnd - p < 2)
+	{
+		truncated = true;
+		return p;
+	}
+	if (!str)
+		str = "(null)";
+	UInt32 len = (UInt32)(strlen(str));
+	UInt32 space = (UInt32)(pEnd - p) - 2;
+	len = len > c_maxStringLength ? c_maxStringLength : len;
+	if (len > space)
+	{
+		len = space;
+		truncated = true;
+	}
+	UInt16 len16 = (UInt16)(len);
+	memcpy(p, &len16, 2);
+	memcpy(p + 2, str, len);
+	return p + 2 + len;
+}
+
+long long GetInt(const char *&p)
+{
+	long long v;
+	memcpy(&v, p, 8);
+	p += 8;
+	return v;
+}
+
+// formats recorded arguments with format of site, the way printf would have. stops at first conversion
+// whose argument was not recorded (record was truncated)
+void FormatRecord(const LogSite *pSite, const char *pArgs, const char *pArgsEnd, char *pText, UInt32 textSize)
+{
+	char *pOut = pText, *pOutEnd = pText + textSize - 1;
+
+	if (pSite->m_flags & LogSite::Flag_Preformatted)
+	{
+		UInt16 len;
+		memcpy(&len, pArgs, 2);
+		len = len > textSize - 1 ? (UInt16)(textSize - 1) : len;
+		memcpy(pText, pArgs + 2, len);
+		pText[len] = 0;
+		return;
+	}
+
+	const char *p = pSite->m_format;
+	while (*p && pOut < pOutEnd)
+	{
+		if (*p != '%')
+		{
+			*pOut++ = *p++;
+			continue;
+		}
+
+		const char *pSpecStart = p++;
+		int kind, numStars;
+		ParseConversion(p, kind, numStars);
+		if (kind == -1)
+		{
+			*pOut++ = '%';
+			continue;
+		}
+
+		// arguments of conversion are whole in record or not there at all
+		UInt32 argSize = numStars * 8;
+		if ((UInt32)(pArgsEnd - pArgs) < argSize + 2)
+			break;
+		if (kind == LogSite::Arg_String)
+		{
+			UInt16 strLen;
+			memcpy(&strLen, pArgs + argSize, 2);
+			argSize += 2 + strLen;
+		}
+		else
+			argSize += 8;
+		if ((UInt32)(pArgsEnd - pArgs) < argSize)
+			break;
+
+		// conversion with '*' replaced by recorded width/precision
+		char spec[64];
+		char *pSpec = spec;
+		for (const char *s = pSpecStart; s < p && pSpec < spec + sizeof(spec) - 16; ++s)
+		{
+			if (*s == '*')
+			{
+				pSpec += FormatArg(pSpec, 16, "%d", (int)(GetInt(pArgs)));
+			}
+			else
+				*pSpec++ = *s;
+		}
+		*pSpec = 0;
+
+		int len = 0;
+		UInt32 space = (UInt32)(pOutEnd - pOut) + 1;
+		switch (kind)
+		{
+		case LogSite::Arg_Int: len = FormatArg(pOut, space, spec, (int)(GetInt(pArgs))); break;
+		case LogSite::Arg_Long: len = FormatArg(pOut, space, spec, (long)(GetInt(pArgs))); break;
+		case LogSite::Arg_LongLong: len = FormatArg(pOut, space, spec, GetInt(pArgs)); break;
+		case LogSite::Arg_SizeT: len = FormatArg(pOut, space, spec, (size_t)(GetInt(pArgs))); break;
+		case LogSite::Arg_Pointer: len = FormatArg(pOut, space, spec, (void *)(size_t)(GetInt(pArgs))); break;
+		case LogSite::Arg_Double:
+			{
+				double v;
+				memcpy(&v, pArgs, 8);
+				pArgs += 8;
+				len = FormatArg(pOut, space, spec, v);
+			}
+			break;
+		case LogSite::Arg_String:
+			{
+				char str[c_maxStringLength + 1];
+				UInt16 strLen;
+				memcpy(&strLen, pArgs, 2);
+				memcpy(str, pArgs + 2, strLen);
+				str[strLen] = 0;
+				pArgs += 2 + strLen;
+				len = FormatArg(pOut, space, spec, str);
+			}
+			break;
+		}
+		if (len > 0)
+			pOut += (UInt32)(len) < space ? len : space - 1;
+	}
+	*pOut = 0;
+}
+
+void Print(int severity, const char *text)
+{
+	char line[c_maxTextLength + 32];
+	FormatArg(line, sizeof(line), "%s%s\n", c_severityPrefixes[severity], text);
+#if APIABSTRACTION_PS3 || APIABSTRACTION_IOS || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
+	fputs(line, stdout);
+#else
+	OutputDebugStringA(line);
+#endif
+}
+
+void WriteSiteToFile(LogSite *pSite)
+{
+	UInt32 id = (UInt32)(pSite->m_id), line = (UInt32)(pSite->m_line);
+	unsigned char type = Record_Site, severity = (unsigned char)(pSite->m_severity), category = (unsigned char)(pSite->m_category);
+	UInt16 fileLen = (UInt16)(strlen(pSite->m_file)), formatLen = (UInt16)(strlen(pSite->m_format));
+	fwrite(&type, 1, 1, s_pFile);
+	fwrite(&id, 4, 1, s_pFile);
+	fwrite(&severity, 1, 1, s_pFile);
+	fwrite(&category, 1, 1, s_pFile);
+	fwrite(&pSite->m_flags, 1, 1, s_pFile);
+	fwrite(&line, 4, 1, s_pFile);
+	fwrite(&fileLen, 2, 1, s_pFile);
+	fwrite(pSite->m_file, 1, fileLen, s_pFile);
+	fwrite(&formatLen, 2, 1, s_pFile);
+	fwrite(pSite->m_format, 1, formatLen, s_pFile);
+	fwrite(&pSite->m_numArgs, 1, 1, s_pFile);
+	fwrite(pSite->m_argKinds, 1, pSite->m_numArgs, s_pFile);
+	pSite->m_writtenToFile = s_fileGeneration;
+}
+
+void WriteMessage(unsigned char thread, const RecordHeader &header)
+{
+	LogSite *pSite = header.m_pSite;
+	const char *pArgs = (const char *)(&header + 1);
+	const char *pArgsEnd = (const char *)(&header) + header.m_size;
+
+	char text[c_maxTextLength];
+	FormatRecord(pSite, pArgs, pArgsEnd, text, sizeof(text) - 64);
+	if (header.m_suppressed & c_truncatedBit)
+	{
+		size_t len = strlen(text);
+		FormatArg(text + len, sizeof(text) - len, " (truncated)");
+	}
+	if (header.m_suppressed & ~c_truncatedBit)
+	{
+		size_t len = strlen(text);
+		FormatArg(text + len, sizeof(text) - len, " (%d more suppressed by rate limit)", header.m_suppressed & ~c_truncatedBit);
+	}
+
+	if (AsyncLog::s_printToConsole)
+		Print(pSite->m_severity, text);
+
+	if (s_pFile)
+	{
+		if (pSite->m_writtenToFile != s_fileGeneration)
+			WriteSiteToFile(pSite);
+
+		unsigned char type = Record_Message;
+		UInt32 id = (UInt32)(pSite->m_id);
+		UInt16 argsSize = (UInt16)(pArgsEnd - pArgs);
+		fwrite(&type, 1, 1, s_pFile);
+		fwrite(&id, 4, 1, s_pFile);
+		fwrite(&header.m_time, 4, 1, s_pFile);
+		fwrite(&thread, 1, 1, s_pFile);
+		fwrite(&header.m_suppressed, 2, 1, s_pFile);
+		fwrite(&argsSize, 2, 1, s_pFile);
+		fwrite(pArgs, 1, argsSize, s_pFile);
+	}
+
+	if (AsyncLog::s_sink)
+		AsyncLog::s_sink(pSite, text);
+
+	s_numWritten++;
+}
+
+// log thread (or Stop() after log thread is done). true if there was anything
+bool DrainRings()
+{
+	bool any = false;
+	long numRings = Threading::AtomicLoad(&s_numRings);
+	numRings = numRings > PE_LOG_MAX_THREADS ? PE_LOG_MAX_THREADS : numRings;
+	for (long i = 0; i < numRings; ++i)
+	{
+		Ring &ring = s_rings[i];
+		UInt32 tail = (UInt32)(ring.m_tail);
+		UInt32 head = (UInt32)(Threading::AtomicLoadAcquire(&ring.m_head));
+		while (tail != head)
+		{
+			RecordHeader &header = *(RecordHeader *)(ring.m_data + tail);
+			if (header.m_pSite)
+			{
+				WriteMessage((unsigned char)(i), header);
+				tail += RecordStride(header.m_size);
+				tail = tail == PE_LOG_RING_SIZE ? 0 : tail;
+			}
+			else
+				tail = 0;
+			Threading::AtomicStoreRelease(&ring.m_tail, tail);
+			any = true;
+		}
+
+		UInt32 numDropped = ring.m_numDropped;
+		if (numDropped != ring.m_numDroppedReported)
+		{
+			UInt32 n = numDropped - ring.m_numDroppedReported;
+			ring.m_numDroppedReported = numDropped;
+
+			char text[128];
+			FormatArg(text, sizeof(text), "AsyncLog: log ring of thread %d was full, %d messages dropped", (int)(i), (int)(n));
+			Print(LogSeverity_Warning, text);
+			if (s_pFile)
+			{
+				unsigned char type = Record_Dropped, thread = (unsigned char)(i);
+				fwrite(&type, 1, 1, s_pFile);
+				fwrite(&thread, 1, 1, s_pFile);
+				fwrite(&n, 4, 1, s_pFile);
+			}
+			any = true;
+		}
+	}
+
+	if (any)
+	{
+		if (s_pFile)
+			fflush(s_pFile);
+		if (AsyncLog::s_printToConsole)
+			fflush(stdout);
+	}
+	return any;
+}
+
+void LogThreadFunction(void *params)
+{
+	Timer timer;
+	double time = 0;
+	while (AsyncLog::s_running)
+	{
+		bool any = DrainRings();
+		Threading::AtomicIncrement(&s_numDrains);
+
+		time += timer.TickAndGetTimeDeltaInSeconds();
+		AsyncLog::s_timeMs = (long)(time * 1000.0);
+		AsyncLog::s_window = (long)(time);
+
+		if (!any)
+			Threading::SleepMilliseconds(2);
+	}
+	Threading::AtomicStoreRelease(&s_threadDone, 1);
+}
+
+}; // namespace
+
+void AsyncLog::Start(const char *binaryFile)
+{
+#if PE_LOG_ASYNC
+	if (s_running)
+		return;
+
+	if (binaryFile)
+	{
+		s_pFile = fopen(binaryFile, "wb");
+		if (s_pFile)
+		{
+			UInt32 version = PE_LOG_FILE_VERSION;
+			fwrite("PELG", 1, 4, s_pFile);
+			fwrite(&version, 4, 1, s_pFile);
+			s_fileGeneration = s_fileGeneration == 255 ? 1 : s_fileGeneration + 1;
+		}
+		else
+			PEWARN("AsyncLog: could not open %s, no binary log", binaryFile);
+	}
+
+	s_threadDone = 0;
+	Threading::AtomicStoreRelease(&s_running, 1);
+	s_thread.m_function = &LogThreadFunction;
+	s_thread.m_pParams = NULL;
+	s_thread.run();
+#endif
+}
+
+void AsyncLog::Stop()
+{
+	if (!s_running)
+		return;
+
+	Threading::AtomicStoreRelease(&s_running, 0);
+	while (!Threading::AtomicLoadAcquire(&s_threadDone))
+		Threading::SleepMilliseconds(1);
+
+	// log thread is gone, this thread is the consumer now
+	DrainRings();
+	if (s_pFile)
+	{
+		fclose(s_pFile);
+		s_pFile = NULL;
+	}
+}
+
+void AsyncLog::Flush()
+{
+	for (int wait = 0; wait < 1000 && s_running; ++wait)
+	{
+		bool empty = true;
+		long numRings = Threading::AtomicLoad(&s_numRings);
+		for (long i = 0; i < numRings && i < PE_LOG_MAX_THREADS; ++i)
+			empty = empty && Threading::AtomicLoadAcquire(&s_rings[i].m_tail) == Threading::AtomicLoadAcquire(&s_rings[i].m_head);
+
+		if (empty)
+		{
+			// a whole pass of log thread after rings are empty, so files are flushed too
+			long drains = Threading::AtomicLoad(&s_numDrains);
+			while (s_running && Threading::AtomicLoad(&s_numDrains) < drains + 2)
+				Threading::SleepMilliseconds(1);
+			return;
+		}
+		Threading::SleepMilliseconds(1);
+	}
+}
+
+void AsyncLog::Record(LogSite *pSite, ...)
+{
+	va_list args;
+	va_start(args, pSite);
+
+	if (!pSite->m_id)
+		Register(pSite);
+
+	Ring *pRing = s_running ? GetThreadRing() : NULL;
+	if (!pRing)
+	{
+		char text[c_maxTextLength];
+		PE_LOG_VSNPRINTF(text, sizeof(text), pSite->m_format, args);
+		text[sizeof(text) - 1] = 0;
+		Print(pSite->m_severity, text);
+		Threading::AtomicIncrement(&s_numSynchronous);
+		va_end(args);
+		return;
+	}
+
+	// rate limit per call site. threads share counters without atomics, so the limit is approximate
+	UInt16 suppressed = 0;
+	if (s_rateLimit)
+	{
+		long window = s_window;
+		if (pSite->m_window != window)
+		{
+			pSite->m_window = window;
+			pSite->m_count = 0;
+		}
+		long count = pSite->m_count + 1;
+		pSite->m_count = count;
+		if (count > s_rateLimit)
+		{
+			pSite->m_suppressed = pSite->m_suppressed + 1;
+			pRing->m_numRateLimited++;
+			va_end(args);
+			return;
+		}
+		if (pSite->m_suppressed)
+		{
+			long n = pSite->m_suppressed;
+			pSite->m_suppressed = 0;
+			suppressed = (UInt16)(n > 0x7fff ? 0x7fff : n);
+		}
+	}
+
+	char record[c_maxRecordSize];
+	char *p = record + sizeof(RecordHeader), *pEnd = record + c_maxRecordSize;
+	bool truncated = false;
+	if (pSite->m_flags & LogSite::Flag_Preformatted)
+	{
+		char text[c_maxStringLength + 1];
+		PE_LOG_VSNPRINTF(text, sizeof(text), pSite->m_format, args);
+		text[c_maxStringLength] = 0;
+		p = PutString(p, pEnd, text, truncated);
+	}
+	else
+	{
+		// arguments past end of record are not recorded, message is cut after last one that fit
+		for (int i = 0; i < pSite->m_numArgs && !truncated; ++i)
+		{
+			long long v = 0;
+			switch (pSite->m_argKinds[i])
+			{
+			case LogSite::Arg_Int: v = va_arg(args, int); break;
+			case LogSite::Arg_Long: v = va_arg(args, long); break;
+			case LogSite::Arg_LongLong: v = va_arg(args, long long); break;
+			case LogSite::Arg_SizeT: v = (long long)(va_arg(args, size_t)); break;
+			case LogSite::Arg_Pointer: v = (long long)(size_t)(va_arg(args, void *)); break;
+			case LogSite::Arg_Double:
+				{
+					double d = va_arg(args, double);
+					memcpy(&v, &d, 8);
+				}
+				break;
+			case LogSite::Arg_String:
+				p = PutString(p, pEnd, va_arg(args, const char *), truncated);
+				continue;
+			}
+			if (pEnd - p < 8)
+			{
+				truncated = true;
+				break;
+			}
+			memcpy(p, &v, 8);
+			p += 8;
+		}
+	}
+	va_end(args);
+
+	RecordHeader &header = *(RecordHeader *)(record);
+	header.m_pSite = pSite;
+	header.m_size = (UInt16)(p - record);
+	header.m_suppressed = truncated ? (UInt16)(suppressed | c_truncatedBit) : suppressed;
+	header.m_time = (UInt32)(s_timeMs);
+
+	if (pRing->write(record, header.m_size))
+		pRing->m_numRecorded++;
+	else
+		pRing->m_numDropped++;
+}
+
+void AsyncLog::GetStats(Stats &stats)
+{
+	memset(&stats, 0, sizeof(stats));
+	long numRings = Threading::AtomicLoad(&s_numRings);
+	for (long i = 0; i < numRings && i < PE_LOG_MAX_THREADS; ++i)
+	{
+		stats.m_numRecorded += s_rings[i].m_numRecorded;
+		stats.m_numRateLimited += s_rings[i].m_numRateLimited;
+		stats.m_numDropped += s_rings[i].m_numDropped;
+	}
+	stats.m_numWritten = s_numWritten;
+	stats.m_numSynchronous = (UInt32)(Threading::AtomicLoad(&s_numSynchronous));
+}
+
+}; // namespace PE
@@ -0,0 +1,133 @@
+#ifndef __PYENGINE_2_0_ASYNC_LOG_H__
+#define __PYENGINE_2_0_ASYNC_LOG_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdio.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+// included by ErrorHandling.h, so everything sees it. no other engine includes here
+
+// logs format with arguments if severity and category are enabled. arguments are not evaluated otherwise
+#define PELOG(severity, category, format, ...) \
+	do { \
+		static PE::LogSite _peLogSite = {format, __FILE__, __LINE__, severity, category}; \
+		if (PE::LogSite::IsEnabled(severity, category)) \
+			PE::AsyncLog::Record(&_peLogSite, ##__VA_ARGS__); \
+	} while (0)
+
+namespace PE {
+
+enum LogSeverity
+{
+	LogSeverity_Info,
+	LogSeverity_Warning,
+	LogSeverity_Error,
+	LogSeverity_Count
+};
+
+enum LogCategory
+{
+	LogCategory_General,
+	LogCategory_Render,
+	LogCategory_Scene,
+	LogCategory_Network,
+	LogCategory_Game,
+	LogCategory_Events, // Log component
+	LogCategory_Count
+};
+
+// Static data of one PELOG() call site. Filled on first message: id and kinds of arguments parsed from format.
+// Only the log thread reads them after that
+struct LogSite
+{
+	enum Flags
+	{
+		Flag_Preformatted = 1, // format has conversions the log thread can't redo, message is formatted when recorded
+	};
+
+	enum ArgKind
+	{
+		Arg_Int, Arg_Long, Arg_LongLong, Arg_SizeT, Arg_Double, Arg_Pointer, Arg_String,
+	};
+
+	static const int c_maxArgs = 16;
+
+	const char *m_format;
+	const char *m_file;
+	int m_line;
+	int m_severity;
+	int m_category;
+
+	volatile long m_id; // 0 until registered
+	volatile long m_window; // rate limit window (AsyncLog::s_window) of m_count
+	volatile long m_count;
+	volatile long m_suppressed; // by rate limit since last recorded message
+	unsigned char m_flags;
+	unsigned char m_numArgs;
+	unsigned char m_argKinds[c_maxArgs];
+	unsigned char m_writtenToFile; // log thread only
+
+	static bool IsEnabled(int severity, int category)
+	{
+		return severity >= s_minSeverity && (s_categoryMask & (1 << category)) != 0;
+	}
+
+	static volatile int s_minSeverity;
+	static volatile int s_categoryMask;
+};
+
+// Asynchronous backend of PELOG/PEINFO/PEWARN. Record() copies raw arguments (strings by value) into a lock free
+// single producer ring of the calling thread. Log thread drains rings, formats messages, prints them and
+// writes them to binary log. Messages recorded before Start(), on threads past PE_LOG_MAX_THREADS, or with PE_LOG_ASYNC 0
+// are formatted and printed on the calling thread. Full ring drops the message and counts it
+struct AsyncLog
+{
+	// called on log thread for every message after it is printed
+	typedef void (*SinkFunction)(const LogSite *pSite, const char *text);
+
+	struct Stats
+	{
+		PrimitiveTypes::UInt32 m_numRecorded;
+		PrimitiveTypes::UInt32 m_numRateLimited;
+		PrimitiveTypes::UInt32 m_numDropped; // ring full
+		PrimitiveTypes::UInt32 m_numWritten; // by log thread
+		PrimitiveTypes::UInt32 m_numSynchronous;
+	};
+
+	// starts log thread. binaryFile may be NULL
+	static void Start(const char *binaryFile);
+
+	// drains rings and stops log thread, later messages are synchronous
+	static void Stop();
+
+	static bool IsRunning() { return s_running != 0; }
+
+	// waits until log thread has written all messages recorded so far (up to a second)
+	static void Flush();
+
+	static void Record(LogSite *pSite, ...);
+
+	static void SetSink(SinkFunction sink) { s_sink = sink; }
+
+	// sums of all threads. approximate while threads log
+	static void GetStats(Stats &stats);
+
+	static volatile long s_running;
+	static volatile long s_window; // seconds since Start(), advanced by log thread
+	static volatile long s_timeMs; // milliseconds since Start(), advanced by log thread
+	static int s_rateLimit; // 0 for no limit
+	static bool s_printToConsole;
+	static SinkFunction s_sink;
+};
+
+}; // namespace PE
+
+#endif
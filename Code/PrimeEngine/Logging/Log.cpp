@@ -13,30 +13,18 @@ Log::Log(PE::GameContext &context, PE::MemoryArena arena, Handle m_hMyself, cons
 
 void Log::handleEvent(Events::Event *pEvt)
 {
-#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA
 	if(m_isActivated)
 	{
-		char msg[128];
-		char handleNumberString [128];
-
-		StringOps::intToStr((pEvt->m_lastDistributor.m_memoryPoolIndex * MAX_NUM_BLOCKS_PER_POOL) + pEvt->m_lastDistributor.m_memoryBlockIndex, handleNumberString, 128); //Convert caller's handle number to string
-
-		//StringOps::concat(EventToStrMap::Instance()->findString(pEvt->m_type), m_tagName,  msg, 128); //Combine event name with tag
-		StringOps::concat(msg,pEvt->m_lastDistributor.getDbgName(), msg, 128); //Combine above with handle type
-		StringOps::concat(msg, " ", msg, 128); //Add a space
-		StringOps::concat(msg, handleNumberString, msg, 128); //Combine above with number representation of handle
-		
-		PEINFOSTR((LPCSTR)msg);
+		// handle type and number of caller, formatted by log thread
+		//EventToStrMap::Instance()->findString(pEvt->m_type), m_tagName
+		PELOG(PE::LogSeverity_Info, PE::LogCategory_Events, "%s %d", pEvt->m_lastDistributor.getDbgName(),
+			(int)((pEvt->m_lastDistributor.m_memoryPoolIndex * MAX_NUM_BLOCKS_PER_POOL) + pEvt->m_lastDistributor.m_memoryBlockIndex));
 	}
-#endif
 }
 
 void Log::printDebugInt(PrimitiveTypes::Int32 n)
 {
-	char msg[128];
-
-	StringOps::intToStr(n, msg, 128); 
-	PEINFOSTR(msg);
+	PEINFO("%d", n);
 }
 
 // Methods --------------------------------------------------------------
@@ -28,6 +28,15 @@ function loadLevel(level, package)
 		
         filePath = l_getGameProjRoot(l_getGameContext())..'AssetsOut'..delim..package..delim..'Levels'..delim..level
 
+        -- prefer compiled level (built by Tools/LevelCompiler) that is loaded natively in one pass.
+        -- scripted objects in it still come back through CreateGameObject().
+        -- not used if .levela changed since it was compiled
+        local compiledFilePath = string.gsub(filePath, '%.levela$', '.levelb')
+        if compiledFilePath ~= filePath and l_loadCompiledLevel(l_getGameContext(), compiledFilePath, filePath) then
+            outputDebugString('Dbg: loaded compiled level: '..compiledFilePath..'\n')
+            return
+        end
+
         outputDebugString('Dbg: file: '..filePath..'\n')
 		
         dofile(filePath)
@@ -5,10 +5,12 @@
 #include "EventGlue/EventDataCreators.h"
 #include "PrimeEngine/APIAbstraction/Effect/EffectManager.h"
 #include "PrimeEngine/GameObjectModel/GameObjectManager.h"
+#include "PrimeEngine/GameObjectModel/CompiledLevelLoader.h"
+#include "PrimeEngine/APIAbstraction/Texture/TextureResidencyManager.h"
 
 #include "../../../GlobalConfig/GlobalConfig.h"
 
-#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA
+#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA && !PE_PLAT_IS_LINUX
 #include <io.h>
 #elif APIABSTRACTION_PS3 // ps3 current folder printouts for debugging
 #include <dirent.h>
@@ -46,7 +48,14 @@ int getdir (const char *dir)
 LuaEnvironment::LuaEnvironment(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself)
 : Component(context, arena, hMyself)
 , Networkable(context, this) // cant register with networkable here because LueEnvironemntr is created before NetworkManager
+, m_runScripts(context, arena, 256)
+, m_scriptCache(context, arena)
 {
+#if PE_LUA_BYTECODE_CACHE && PE_LUA_BYTECODE_CACHE_DISK
+	char cacheDirectory[256];
+	StringOps::concat(context.getMainFunctionArgs()->gameProjRoot(), "AssetsOut/.luacache", cacheDirectory, 256);
+	m_scriptCache.setDiskDirectory(cacheDirectory);
+#endif
 
 #if APIABSTRACTION_PS3
 	getdir("/app_home/");
@@ -62,6 +71,7 @@ LuaEnvironment::LuaEnvironment(PE::GameContext &context, PE::MemoryArena arena,
 
 void LuaEnvironment::closeStates()
 {
+	m_profiler.stop();
 	for (int i = 0; i < LuaThread_Count; ++i)
 	{
 		lua_close(m_luaStates[i]);
@@ -471,7 +481,10 @@ PrimitiveTypes::Bool LuaEnvironment::runString(const char *pCommand)
 	errCode = luaL_loadbuffer(L, pCommand, strlen(pCommand), NULL);
 	if(!errCode)
 	{
-		if(0 == lua_pcall(L, 0, LUA_MULTRET, 0))
+		m_profiler.enter(L, 0, NULL);
+		errCode = lua_pcall(L, 0, LUA_MULTRET, 0);
+		m_profiler.leave();
+		if(0 == errCode)
 		{
 			return true;
 		}
@@ -484,13 +497,28 @@ PrimitiveTypes::Bool LuaEnvironment::runString(const char *pCommand)
 PrimitiveTypes::Bool LuaEnvironment::runScript(const char *pFname)
 {
 	PEINFO("PROGRESS: LuaEnvironment::runScript: %s\n", pFname);
+
+	char key[StrTPair<PrimitiveTypes::Int32>::StrSize];
+	LuaScriptCache::PathKey(pFname, key, StrTPair<PrimitiveTypes::Int32>::StrSize);
+	PrimitiveTypes::Int32 runIndex = m_runScripts.findIndex(key);
+	if (runIndex != -1)
+		++m_runScripts.m_pairs[runIndex].m_value;
+	else if (m_runScripts.m_pairs.m_size < m_runScripts.m_pairs.m_capacity)
+		m_runScripts.add(key, 1);
 	
 	PrimitiveTypes::Int32 errCode;
+#if PE_LUA_BYTECODE_CACHE
+	errCode = m_scriptCache.loadFile(L, pFname);
+#else
 	errCode = luaL_loadfile(L, pFname);
+#endif
 
 	if(!errCode)
 	{
-		if(0 == lua_pcall(L, 0, LUA_MULTRET, 0))
+		m_profiler.enter(L, 0, NULL);
+		errCode = lua_pcall(L, 0, LUA_MULTRET, 0);
+		m_profiler.leave();
+		if(0 == errCode)
 		{
 			return true;
 		}
@@ -518,10 +546,68 @@ PrimitiveTypes::Bool LuaEnvironment::runScript(const char *pFname)
 	return false;
 }
 
+PrimitiveTypes::Bool LuaEnvironment::reloadScript(const char *pFullPath, const char *pChunk, PrimitiveTypes::UInt32 size, bool &isLive)
+{
+	char key[StrTPair<PrimitiveTypes::Int32>::StrSize];
+	LuaScriptCache::PathKey(pFullPath, key, StrTPair<PrimitiveTypes::Int32>::StrSize);
+
+	// module name is file name without extension
+	char module[256];
+	const char *pName = strrchr(key, '/');
+	StringOps::writeToString(pName ? pName + 1 : key, module, 256);
+	if (char *pDot = strrchr(module, '.'))
+		*pDot = '\0';
+
+	bool isModule = false;
+	lua_getglobal(L, "package");
+	if (lua_istable(L, -1))
+	{
+		lua_getfield(L, -1, "loaded");
+		if (lua_istable(L, -1))
+		{
+			lua_getfield(L, -1, module);
+			isModule = lua_istable(L, -1);
+			lua_pop(L, 1);
+		}
+		lua_pop(L, 1);
+	}
+	lua_pop(L, 1);
+
+	isLive = isModule || m_runScripts.findIndex(key) != -1;
+	if (!isLive)
+		return false;
+
+	if (luaL_loadbuffer(L, pChunk, size, pFullPath) != 0)
+	{
+		PEWARN("LuaEnvironment: reloading %s: %s\n", pFullPath, lua_tostring(L, -1));
+		lua_pop(L, 1);
+		return false;
+	}
+
+	// module(..., package.seeall) gets module name and fills table that is already loaded
+	int nargs = 0;
+	if (isModule)
+	{
+		lua_pushstring(L, module);
+		nargs = 1;
+	}
+	m_profiler.enter(L, nargs, NULL);
+	int errCode = lua_pcall(L, nargs, 0, 0);
+	m_profiler.leave();
+	if (errCode != 0)
+	{
+		PEWARN("LuaEnvironment: error running reloaded %s: %s\n", pFullPath, lua_tostring(L, -1));
+		lua_pop(L, 1);
+		return false;
+	}
+	PEINFO("LuaEnvironment: reloaded %s\n", pFullPath);
+	return true;
+}
+
 PrimitiveTypes::Bool LuaEnvironment::runScriptDefaultPath(const char *pFname)
 {
 	char fullPath[512];
-#if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA
+#if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
     StringOps::concat(m_pContext->getMainFunctionArgs()->gameProjRoot(), "Code/PrimeEngine/Lua/", fullPath, 512);
 #else
 	StringOps::concat(m_pContext->getMainFunctionArgs()->gameProjRoot(), "Code\\PrimeEngine\\Lua\\", fullPath, 512);
@@ -573,7 +659,9 @@ PrimitiveTypes::Int32 LuaEnvironment::prepModuleFunctionCall(const char *module,
 
 PrimitiveTypes::Int32 LuaEnvironment::callPreparedFunction(int nargs, int nresults, int errfunc)
 {
+	m_profiler.enter(L, nargs, NULL);
 	int x = lua_pcall(L, nargs, nresults, 0);
+	m_profiler.leave();
 	if (x != errfunc)
 	{
 		PEASSERT(false, "Error while running function in lua VM");
@@ -584,7 +672,10 @@ PrimitiveTypes::Int32 LuaEnvironment::callPreparedFunction(int nargs, int nresul
 PrimitiveTypes::Int32 LuaEnvironment::runFunction(const char *fname, int nresults, int errfunc)
 {
 	lua_getglobal(L, fname);
-	if (lua_pcall(L, 0, nresults, 0) != errfunc)
+	m_profiler.enter(L, 0, fname);
+	int x = lua_pcall(L, 0, nresults, 0);
+	m_profiler.leave();
+	if (x != errfunc)
 	{
 		PEASSERT(false, "Error while running function in lua VM");
 	}
@@ -625,6 +716,9 @@ int LuaEnvironment::lua_getRootSceneNodeHandle(lua_State* luaVM)
 void LuaEnvironment::registerInitialLibrariesFunctions()
 {
 	luaL_openlibs(L);
+#if PE_LUA_BYTECODE_CACHE
+	LuaScriptCache::RegisterLuaFunctions(L, &m_scriptCache);
+#endif
 	// general purpose lua glue function
 	LuaGlue::registerFunctions(L);
 	luaopen_socket_core(L);
@@ -638,6 +732,7 @@ void LuaEnvironment::registerInitialLibrariesFunctions()
 	lua_register(L, "l_findluaFiles", l_findluaFiles);
 	lua_register(L, "l_getClassNameByClassId", l_getClassNameByClassId);
 	lua_register(L, "l_getGameProjRoot", l_getGameProjRoot);
+	lua_register(L, "l_loadCompiledLevel", l_loadCompiledLevel);
 	lua_register(L, "l_getLuaCommandServerPort", l_getLuaCommandServerPort);
 	lua_register(L, "l_setCreatedLuaCommandServerPort", l_setCreatedLuaCommandServerPort);
 	
@@ -654,6 +749,24 @@ int LuaEnvironment::l_getGameProjRoot(lua_State* luaVM)
 	return 1;
 }
 
+// (context, compiled level path, .levela path it was compiled from)
+// returns true if compiled level was found, is up to date and loaded. false means caller should run the .levela script
+int LuaEnvironment::l_loadCompiledLevel(lua_State* luaVM)
+{
+	PE::GameContext *pContext = (PE::GameContext *)(lua_touserdata(luaVM, -3));
+	const char *filename = lua_tostring(luaVM, -2);
+	const char *sourceFilename = lua_tostring(luaVM, -1);
+	
+	char path[512], sourcePath[512];
+	StringOps::writeToString(filename, path, 512);
+	StringOps::writeToString(sourceFilename ? sourceFilename : "", sourcePath, 512);
+	lua_pop(luaVM, 3);
+
+	bool loaded = CompiledLevelLoader::loadLevel(*pContext, path, sourcePath[0] ? sourcePath : NULL);
+	lua_pushboolean(luaVM, loaded ? 1 : 0);
+	return 1;
+}
+
 int LuaEnvironment::l_getLuaCommandServerPort(lua_State* luaVM)
 {
 	PE::GameContext *pContext = (PE::GameContext *)(lua_touserdata(luaVM, -1));
@@ -676,7 +789,7 @@ int LuaEnvironment::l_setCreatedLuaCommandServerPort(lua_State* luaVM)
 }
 int LuaEnvironment::l_getPathDelimeter(lua_State* luaVM)
 {
-#if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA
+#if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
     lua_pushstring(luaVM, "/");
 #else
     lua_pushstring(luaVM, "\\");
@@ -688,7 +801,7 @@ int LuaEnvironment::l_convertUserdataPointerToNumber(lua_State *luaVM)
 	void *ptr = lua_touserdata(luaVM, -1);
 	lua_pop(luaVM, 1);
 
-	double val = (double)((int)(ptr));
+	double val = (double)((size_t)(ptr));
 	lua_pushnumber(luaVM, val);
 	return 1;
 }
@@ -720,7 +833,7 @@ int LuaEnvironment::l_findluaFiles(lua_State* luaVM)
 
 void LuaEnvironment::findluaFilesRecursive(PE::GameContext &context, PE::MemoryArena arena, PEString &path, PEString &pattern, lua_State* luaVM, PrimitiveTypes::UInt32 &curIndex)
 {
-#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA
+#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA && !PE_PLAT_IS_LINUX
 	PEString pathTmp(context, arena);
 	pathTmp.append(path);
 	pathTmp.append(pattern);
@@ -800,6 +913,15 @@ int LuaEnvironment::l_MemoryReport(lua_State* luaVM)
 	MemoryManager::instance()->memoryReport(hReportStr.getObject(), size);
 	char *s = hReportStr.getObject<char>();
 
+	// texture residency goes into the same dictionary
+	if (TextureResidencyManager::Instance())
+	{
+		size -= 1; // closing '}'
+		TextureResidencyManager::Instance()->memoryReport(s, size, 2048);
+		s[size++] = '}';
+		s[size] = '\0';
+	}
+
 	lua_pushstring(luaVM, s);
 
 	hReportStr.release();
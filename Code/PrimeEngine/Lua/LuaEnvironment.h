@@ -20,6 +20,9 @@ extern "C" {
 #include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
 #include "../Events/Component.h"
 #include "../Utils/Array/Array.h"
+#include "../Utils/PEMap.h"
+#include "LuaScriptCache.h"
+#include "LuaProfiler.h"
 
 #include "PrimeEngine/Utils/Networkable.h"
 
@@ -96,6 +99,11 @@ struct LuaEnvironment : public Component, public Networkable
 
 	PrimitiveTypes::Bool runString(const char *pCommand);
 
+	// hot reload: runs compiled chunk of a changed script file (luaL_loadbuffer format) again if the script was
+	// run with runScript() or is a loaded module (package.loaded[file name without .lua]). isLive is false if nothing
+	// loaded the script, it is read when used (levels, game object scripts). errors are reported, not asserted
+	PrimitiveTypes::Bool reloadScript(const char *pFullPath, const char *pChunk, PrimitiveTypes::UInt32 size, bool &isLive);
+
 	PrimitiveTypes::Int32 prepFunctionCall(const char *fname);
 	PrimitiveTypes::Int32 prepModuleFunctionCall(const char *module, const char *fname);
 
@@ -112,6 +120,7 @@ struct LuaEnvironment : public Component, public Networkable
 	static int lua_getRootSceneNodeHandle(lua_State* luaVM);
 
 	static int l_getGameProjRoot(lua_State* luaVM);
+	static int l_loadCompiledLevel(lua_State* luaVM);
 	static int l_getLuaCommandServerPort(lua_State* luaVM);
 	static int l_setCreatedLuaCommandServerPort(lua_State* luaVM);
 	static int l_getPathDelimeter(lua_State* luaVM);
@@ -148,6 +157,11 @@ struct LuaEnvironment : public Component, public Networkable
 	lua_State *L;
 	lua_State * m_luaStates[LuaThread_Count];
 
+	PEMap<PrimitiveTypes::Int32> m_runScripts; // scripts run by runScript(), full path with '/' delimeters -> times run
+
+	LuaScriptCache m_scriptCache; // runScript(), dofile() and loadfile() load through it (PE_LUA_BYTECODE_CACHE)
+	LuaProfiler m_profiler; // every call from engine into lua goes through enter()/leave()
+
 	private:
 		static Handle s_myHandle;
 }; // class LuaEnvironment
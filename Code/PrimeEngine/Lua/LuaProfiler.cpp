@@ -0,0 +1,347 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+// Inter-Engine includes
+#include "PrimeEngine/Utils/ErrorHandling.h"
+
+// Sibling/Children includes
+#include "LuaProfiler.h"
+
+namespace PE {
+
+LuaProfiler *LuaProfiler::s_pRunning = NULL;
+
+LuaProfiler::LuaProfiler()
+	: m_lastFrameMs(0)
+	, m_lastFrameCalls(0)
+	, m_pL(NULL)
+	, m_originalAlloc(NULL)
+	, m_pOriginalAllocUd(NULL)
+	, m_allocatedBytes(0)
+	, m_depth(0)
+	, m_pLastStack(NULL)
+	, m_pLastFile(NULL)
+	, m_callStartTime(0)
+	, m_lastSampleTime(0)
+	, m_lastSampleAllocated(0)
+	, m_frameMs(0)
+	, m_frameCalls(0)
+{
+}
+
+LuaProfiler::~LuaProfiler()
+{
+	stop();
+}
+
+bool LuaProfiler::start(lua_State *L, PrimitiveTypes::UInt32 instructionsPerSample)
+{
+	if (s_pRunning)
+		return s_pRunning == this;
+	s_pRunning = this;
+	m_pL = L;
+
+	m_originalAlloc = lua_getallocf(L, &m_pOriginalAllocUd);
+	lua_setallocf(L, Alloc, this);
+	lua_sethook(L, Hook, LUA_MASKCOUNT, instructionsPerSample > 0 ? instructionsPerSample : 1);
+
+	m_lastSampleTime = m_timer.TickAndGetCurrentTime();
+	m_lastSampleAllocated = m_allocatedBytes;
+	PEINFO("LuaProfiler: started, sample every %d instructions\n", instructionsPerSample);
+	return true;
+}
+
+void LuaProfiler::stop()
+{
+	if (s_pRunning != this)
+		return;
+	lua_sethook(m_pL, NULL, 0, 0);
+	lua_setallocf(m_pL, m_originalAlloc, m_pOriginalAllocUd);
+	m_pL = NULL;
+	s_pRunning = NULL;
+	m_pLastStack = m_pLastFile = NULL;
+}
+
+void LuaProfiler::clear()
+{
+	m_stacks.clear();
+	m_files.clear();
+	m_pLastStack = m_pLastFile = NULL;
+}
+
+void *LuaProfiler::Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+	LuaProfiler *pProfiler = (LuaProfiler *)(ud);
+	if (nsize > osize)
+		pProfiler->m_allocatedBytes += (double)(nsize - osize);
+	return pProfiler->m_originalAlloc(pProfiler->m_pOriginalAllocUd, ptr, osize, nsize);
+}
+
+void LuaProfiler::Hook(lua_State *L, lua_Debug *ar)
+{
+	if (s_pRunning && ar->event == LUA_HOOKCOUNT)
+		s_pRunning->sample(L);
+}
+
+void LuaProfiler::attribute(Sample *pStack, Sample *pFile, Timer::TimeType now)
+{
+	double ms = Timer::GetTimeDeltaInSeconds(m_lastSampleTime, now) * 1000.0;
+	double bytes = m_allocatedBytes - m_lastSampleAllocated;
+	m_lastSampleTime = now;
+	m_lastSampleAllocated = m_allocatedBytes;
+
+	pStack->m_ms += ms;
+	pStack->m_allocatedBytes += bytes;
+	pStack->m_numSamples++;
+	if (pFile)
+	{
+		pFile->m_ms += ms;
+		pFile->m_allocatedBytes += bytes;
+		pFile->m_numSamples++;
+	}
+}
+
+// frame of folded stack: name (file:line function starts at), main chunk (file) or [C] name
+static void frameLabel(const lua_Debug &ar, const char *name, char *dest, PrimitiveTypes::UInt32 size)
+{
+	if (ar.what[0] == 'C')
+		snprintf(dest, size, "[C] %s", name ? name : "?");
+	else if (ar.what[0] == 'm')
+		snprintf(dest, size, "main chunk (%s)", ar.short_src);
+	else
+		snprintf(dest, size, "%s (%s:%d)", name ? name : "?", ar.short_src, ar.linedefined);
+	for (char *c = dest; *c; ++c)
+	{
+		if (*c == ';' || *c == '\n')
+			*c = ',';
+	}
+}
+
+void LuaProfiler::sample(lua_State *L)
+{
+	Timer::TimeType now = m_timer.TickAndGetCurrentTime();
+
+	// frames innermost first
+	std::string labels[PE_LUA_PROFILER_MAX_DEPTH];
+	int numFrames = 0;
+	std::string file;
+	lua_Debug ar;
+	for (int level = 0; numFrames < PE_LUA_PROFILER_MAX_DEPTH && lua_getstack(L, level, &ar); ++level)
+	{
+		lua_getinfo(L, "Sn", &ar);
+		const char *name = ar.name;
+		lua_Debug caller;
+		if (!name && m_depth && !lua_getstack(L, level + 1, &caller))
+			name = m_callName.c_str(); // called by engine
+		char label[256];
+		frameLabel(ar, name, label, 256);
+		labels[numFrames++] = label;
+		if (file.empty() && ar.what[0] != 'C')
+			file = ar.short_src;
+	}
+	if (!numFrames)
+		return;
+
+	// lua called not through LuaEnvironment: time since it was called is not known
+	if (!m_depth && !m_pLastStack)
+		m_lastSampleTime = now;
+
+	std::string stack;
+	for (int i = numFrames - 1; i >= 0; --i)
+	{
+		stack += labels[i];
+		if (i)
+			stack += ';';
+	}
+
+	m_pLastStack = &m_stacks[stack];
+	m_pLastFile = &m_files[file.empty() ? std::string("[C]") : file];
+	attribute(m_pLastStack, m_pLastFile, now);
+}
+
+void LuaProfiler::enter(lua_State *L, int nargs, const char *name)
+{
+	if (m_depth++)
+		return;
+	m_callStartTime = m_timer.TickAndGetCurrentTime();
+	m_frameCalls++;
+	if (m_pL)
+	{
+		m_callName = name ? name : "?";
+		lua_Debug ar;
+		lua_pushvalue(L, -(nargs + 1));
+		char label[256];
+		if (lua_isfunction(L, -1) && lua_getinfo(L, ">S", &ar))
+			frameLabel(ar, m_callName.c_str(), label, 256);
+		else
+		{
+			lua_pop(L, 1);
+			snprintf(label, 256, "%s", m_callName.c_str());
+		}
+		m_callLabel = label;
+		m_pLastStack = m_pLastFile = NULL;
+		m_lastSampleTime = m_callStartTime;
+		m_lastSampleAllocated = m_allocatedBytes;
+	}
+}
+
+void LuaProfiler::leave()
+{
+	if (!m_depth || --m_depth)
+		return;
+	Timer::TimeType now = m_timer.TickAndGetCurrentTime();
+	m_frameMs += Timer::GetTimeDeltaInSeconds(m_callStartTime, now) * 1000.0f;
+	if (m_pL)
+	{
+		// rest of call goes to last sample, or to called function if there was none
+		if (!m_pLastStack)
+			m_pLastStack = &m_stacks[m_callLabel];
+		attribute(m_pLastStack, m_pLastFile, now);
+		m_pLastStack = m_pLastFile = NULL;
+	}
+}
+
+void LuaProfiler::frameEnd()
+{
+	m_lastFrameMs = m_frameMs;
+	m_lastFrameCalls = m_frameCalls;
+	m_frameMs = 0;
+	m_frameCalls = 0;
+}
+
+LuaProfiler::Stats LuaProfiler::getStats()
+{
+	Stats stats;
+	memset(&stats, 0, sizeof(stats));
+	double ms = 0, bytes = 0;
+	for (std::map<std::string, Sample>::iterator it = m_stacks.begin(); it != m_stacks.end(); ++it)
+	{
+		stats.m_numSamples += it->second.m_numSamples;
+		ms += it->second.m_ms;
+		bytes += it->second.m_allocatedBytes;
+	}
+	stats.m_numStacks = (PrimitiveTypes::UInt32)(m_stacks.size());
+	stats.m_sampledMs = (PrimitiveTypes::Float32)(ms);
+	stats.m_allocatedKB = (PrimitiveTypes::Float32)(bytes / 1024.0);
+	return stats;
+}
+
+// innermost frame of folded stack
+static std::string leafFrame(const std::string &stack)
+{
+	size_t i = stack.rfind(';');
+	return i == std::string::npos ? stack : stack.substr(i + 1);
+}
+
+PrimitiveTypes::Float32 LuaProfiler::getFunctionSelfMs(const char *name)
+{
+	size_t len = strlen(name);
+	double ms = 0;
+	for (std::map<std::string, Sample>::iterator it = m_stacks.begin(); it != m_stacks.end(); ++it)
+	{
+		std::string leaf = leafFrame(it->first);
+		if (leaf.compare(0, len, name) == 0 && leaf.size() > len && leaf[len] == ' ')
+			ms += it->second.m_ms;
+	}
+	return (PrimitiveTypes::Float32)(ms);
+}
+
+struct LuaProfilerFunctionRow
+{
+	std::string m_name;
+	double m_selfMs, m_totalMs, m_selfBytes;
+	bool operator<(const LuaProfilerFunctionRow &other) const { return m_selfMs > other.m_selfMs; }
+};
+
+bool LuaProfiler::writeReport(const char *pathPrefix)
+{
+	std::string prefix(pathPrefix);
+	FILE *pTime = fopen((prefix + ".time.folded").c_str(), "w");
+	FILE *pAlloc = fopen((prefix + ".alloc.folded").c_str(), "w");
+	FILE *pSummary = fopen((prefix + ".txt").c_str(), "w");
+	bool ok = pTime && pAlloc && pSummary;
+
+	// functions: self time is time of stacks they are innermost in, total of stacks they are in
+	std::map<std::string, LuaProfilerFunctionRow> functions;
+	double totalMs = 0, totalBytes = 0;
+	for (std::map<std::string, Sample>::iterator it = m_stacks.begin(); ok && it != m_stacks.end(); ++it)
+	{
+		const Sample &s = it->second;
+		if (s.m_ms * 1000.0 >= 1.0)
+			fprintf(pTime, "%s %.0f\n", it->first.c_str(), s.m_ms * 1000.0);
+		if (s.m_allocatedBytes >= 1.0)
+			fprintf(pAlloc, "%s %.0f\n", it->first.c_str(), s.m_allocatedBytes);
+		totalMs += s.m_ms;
+		totalBytes += s.m_allocatedBytes;
+
+		std::vector<std::string> seen;
+		size_t begin = 0;
+		while (begin <= it->first.size())
+		{
+			size_t end = it->first.find(';', begin);
+			if (end == std::string::npos)
+				end = it->first.size();
+			std::string frame = it->first.substr(begin, end - begin);
+			LuaProfilerFunctionRow &row = functions[frame];
+			if (row.m_name.empty())
+			{
+				row.m_name = frame;
+				row.m_selfMs = row.m_totalMs = row.m_selfBytes = 0;
+			}
+			if (std::find(seen.begin(), seen.end(), frame) == seen.end())
+			{
+				row.m_totalMs += s.m_ms; // recursion counts once
+				seen.push_back(frame);
+			}
+			if (end == it->first.size())
+			{
+				row.m_selfMs += s.m_ms;
+				row.m_selfBytes += s.m_allocatedBytes;
+			}
+			begin = end + 1;
+		}
+	}
+
+	if (ok)
+	{
+		std::vector<LuaProfilerFunctionRow> rows;
+		for (std::map<std::string, LuaProfilerFunctionRow>::iterator it = functions.begin(); it != functions.end(); ++it)
+			rows.push_back(it->second);
+		std::sort(rows.begin(), rows.end());
+
+		Stats stats = getStats();
+		fprintf(pSummary, "lua profile: %d samples, %.3f ms, %.1f KB allocated\n\n", stats.m_numSamples, totalMs, totalBytes / 1024.0);
+		fprintf(pSummary, "%10s %7s %10s %12s  function\n", "self ms", "self %", "total ms", "alloc KB");
+		for (size_t i = 0; i < rows.size() && i < PE_LUA_PROFILER_REPORT_ROWS; ++i)
+		{
+			fprintf(pSummary, "%10.3f %6.1f%% %10.3f %12.1f  %s\n", rows[i].m_selfMs, totalMs > 0 ? rows[i].m_selfMs * 100.0 / totalMs : 0.0,
+				rows[i].m_totalMs, rows[i].m_selfBytes / 1024.0, rows[i].m_name.c_str());
+		}
+
+		fprintf(pSummary, "\n%10s %7s %12s  file\n", "ms", "%", "alloc KB");
+		for (std::map<std::string, Sample>::iterator it = m_files.begin(); it != m_files.end(); ++it)
+		{
+			fprintf(pSummary, "%10.3f %6.1f%% %12.1f  %s\n", it->second.m_ms, totalMs > 0 ? it->second.m_ms * 100.0 / totalMs : 0.0,
+				it->second.m_allocatedBytes / 1024.0, it->first.c_str());
+		}
+	}
+
+	if (pTime)
+		fclose(pTime);
+	if (pAlloc)
+		fclose(pAlloc);
+	if (pSummary)
+		fclose(pSummary);
+	if (!ok)
+		PEWARN("LuaProfiler: can't write report %s\n", pathPrefix);
+	return ok;
+}
+
+}; // namespace PE
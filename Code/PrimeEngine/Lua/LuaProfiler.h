@@ -0,0 +1,116 @@
+#ifndef __PYENGINE_2_0_LUA_PROFILER_H__
+#define __PYENGINE_2_0_LUA_PROFILER_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <map>
+#include <string>
+
+// Lua Stuff
+extern "C" {
+#include "../../lua_dist/src/lua.h"
+}
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/APIAbstraction/Timer/Timer.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+// Time spent in lua and a sampling profiler of it.
+// LuaEnvironment calls enter()/leave() around every call from engine into lua, that always measures lua time per frame.
+// While started, a count hook (lua_sethook, LUA_MASKCOUNT) takes a sample of the lua call stack every
+// instructionsPerSample vm instructions. Each sample gets the time and the bytes lua allocated since previous sample
+// (allocator of the state is wrapped while started). Time after last sample of a call goes to its last sample,
+// calls too short for any sample are attributed to the called function.
+// Report: folded stacks (root;...;leaf value, one per line, input of flamegraph.pl/speedscope) of time in
+// microseconds and of allocated bytes, and a summary of functions by self time and of files.
+// Samples are taken on the lua state the profiler is started on and coroutines created by it later. game thread only
+struct LuaProfiler
+{
+	struct Stats
+	{
+		PrimitiveTypes::UInt32 m_numSamples;
+		PrimitiveTypes::UInt32 m_numStacks; // distinct stacks
+		PrimitiveTypes::Float32 m_sampledMs;
+		PrimitiveTypes::Float32 m_allocatedKB;
+	};
+
+	LuaProfiler();
+	~LuaProfiler();
+
+	// false if another profiler is running
+	bool start(lua_State *L, PrimitiveTypes::UInt32 instructionsPerSample);
+	void stop();
+	bool isRunning() { return m_pL != NULL; }
+
+	// drops samples
+	void clear();
+
+	// engine calls into lua: function on top of L under nargs arguments is called. name is what engine calls it by,
+	// lua does not know names of functions called from C
+	void enter(lua_State *L, int nargs, const char *name);
+	void leave();
+
+	// game thread, end of frame: time in lua of the frame becomes m_lastFrameMs
+	void frameEnd();
+
+	// writes <pathPrefix>.time.folded, <pathPrefix>.alloc.folded and <pathPrefix>.txt. false if a file can't be written
+	bool writeReport(const char *pathPrefix);
+
+	Stats getStats();
+
+	// self time of function with this name (any file), for checks
+	PrimitiveTypes::Float32 getFunctionSelfMs(const char *name);
+
+	PrimitiveTypes::Float32 m_lastFrameMs; // time in lua of last frame
+	PrimitiveTypes::UInt32 m_lastFrameCalls; // calls from engine into lua in last frame
+
+private:
+	struct Sample
+	{
+		Sample() : m_ms(0), m_allocatedBytes(0), m_numSamples(0) {}
+		double m_ms;
+		double m_allocatedBytes;
+		PrimitiveTypes::UInt32 m_numSamples;
+	};
+
+	static void Hook(lua_State *L, lua_Debug *ar);
+	static void *Alloc(void *ud, void *ptr, size_t osize, size_t nsize);
+	void sample(lua_State *L);
+	void attribute(Sample *pStack, Sample *pFile, Timer::TimeType now);
+
+	lua_State *m_pL;
+	lua_Alloc m_originalAlloc;
+	void *m_pOriginalAllocUd;
+	double m_allocatedBytes; // by lua, since start
+
+	std::map<std::string, Sample> m_stacks; // folded stack -> samples
+	std::map<std::string, Sample> m_files; // file of innermost lua function -> samples
+
+	// current call from engine
+	PrimitiveTypes::UInt32 m_depth;
+	std::string m_callName;
+	std::string m_callLabel; // frame of called function, for calls that end before first sample
+	Sample *m_pLastStack; // last sample of current call
+	Sample *m_pLastFile;
+	Timer::TimeType m_callStartTime;
+	Timer::TimeType m_lastSampleTime;
+	double m_lastSampleAllocated;
+
+	PrimitiveTypes::Float32 m_frameMs;
+	PrimitiveTypes::UInt32 m_frameCalls;
+	Timer m_timer;
+
+	static LuaProfiler *s_pRunning;
+};
+
+}; // namespace PE
+
+#endif
@@ -0,0 +1,377 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if PE_PLAT_IS_WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// Lua Stuff
+extern "C" {
+#include "../../lua_dist/src/lauxlib.h"
+}
+
+// Inter-Engine includes
+#include "PrimeEngine/APIAbstraction/Timer/Timer.h"
+#include "PrimeEngine/Utils/StringOps.h"
+#include "PrimeEngine/Utils/ErrorHandling.h"
+
+// Sibling/Children includes
+#include "LuaScriptCache.h"
+
+namespace PE {
+
+// bump when disk entry layout changes
+#define PE_LUA_SCRIPT_CACHE_VERSION 1
+
+// disk entry: header, path (keyLength bytes, to catch path hash collisions), bytecode
+struct LuaScriptCacheDiskHeader
+{
+	char m_magic[4]; // PELC
+	PrimitiveTypes::UInt32 m_version;
+	PrimitiveTypes::UInt32 m_sourceHash[2];
+	PrimitiveTypes::UInt32 m_sourceSize;
+	PrimitiveTypes::UInt32 m_bytecodeSize;
+	PrimitiveTypes::UInt32 m_keyLength;
+};
+
+// lua_dump() writer
+struct LuaScriptCacheChunkBuffer
+{
+	char *m_pData;
+	PrimitiveTypes::UInt32 m_size;
+	PrimitiveTypes::UInt32 m_capacity;
+};
+
+static int writeChunk(lua_State *L, const void *p, size_t sz, void *ud)
+{
+	LuaScriptCacheChunkBuffer *pBuf = (LuaScriptCacheChunkBuffer *)(ud);
+	if (pBuf->m_size + sz > pBuf->m_capacity)
+	{
+		PrimitiveTypes::UInt32 capacity = pBuf->m_capacity ? pBuf->m_capacity * 2 : 4096;
+		while (capacity < pBuf->m_size + sz)
+			capacity *= 2;
+		char *pData = (char *)(realloc(pBuf->m_pData, capacity));
+		if (!pData)
+			return 1;
+		pBuf->m_pData = pData;
+		pBuf->m_capacity = capacity;
+	}
+	memcpy(pBuf->m_pData + pBuf->m_size, p, sz);
+	pBuf->m_size += (PrimitiveTypes::UInt32)(sz);
+	return 0;
+}
+
+static char *readWholeFile(const char *path, PrimitiveTypes::UInt32 &size)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f)
+		return NULL;
+	fseek(f, 0, SEEK_END);
+	long len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	char *pData = len >= 0 ? (char *)(malloc(len + 1)) : NULL;
+	if (pData && fread(pData, 1, len, f) != (size_t)(len))
+	{
+		free(pData);
+		pData = NULL;
+	}
+	fclose(f);
+	size = pData ? (PrimitiveTypes::UInt32)(len) : 0;
+	return pData;
+}
+
+LuaScriptCache::LuaScriptCache(PE::GameContext &context, PE::MemoryArena arena)
+	: m_indices(context, arena, PE_LUA_BYTECODE_CACHE_MAX_SCRIPTS)
+	, m_entries(context, arena, PE_LUA_BYTECODE_CACHE_MAX_SCRIPTS)
+{
+	m_diskDirectory[0] = '\0';
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+LuaScriptCache::~LuaScriptCache()
+{
+	clear();
+	m_entries.reset(0);
+	m_indices.m_pairs.reset(0);
+}
+
+void LuaScriptCache::clear()
+{
+	for (PrimitiveTypes::UInt32 i = 0; i < m_entries.m_size; ++i)
+		free(m_entries[i].m_pBytecode);
+	m_entries.clear();
+	m_indices.m_pairs.clear();
+	m_stats.m_numEntries = 0;
+	m_stats.m_bytecodeBytes = 0;
+}
+
+void LuaScriptCache::setDiskDirectory(const char *path)
+{
+	if (!path)
+	{
+		m_diskDirectory[0] = '\0';
+		return;
+	}
+	StringOps::writeToString(path, m_diskDirectory, 256);
+#if PE_PLAT_IS_WIN32
+	_mkdir(m_diskDirectory);
+#else
+	mkdir(m_diskDirectory, 0755);
+#endif
+}
+
+void LuaScriptCache::PathKey(const char *pPath, char *dest, PrimitiveTypes::UInt32 size)
+{
+	PrimitiveTypes::UInt32 n = 0;
+	for (const char *c = pPath; *c && n + 1 < size; ++c)
+	{
+		char ch = *c == '\\' ? '/' : *c;
+		if (ch == '/' && n > 0 && dest[n - 1] == '/')
+			continue;
+		dest[n++] = ch;
+	}
+	dest[n] = '\0';
+}
+
+void LuaScriptCache::HashSource(const char *pSource, PrimitiveTypes::UInt32 size, PrimitiveTypes::UInt32 hash[2])
+{
+	PrimitiveTypes::UInt32 fnv = 2166136261u, djb = 5381;
+	for (PrimitiveTypes::UInt32 i = 0; i < size; ++i)
+	{
+		unsigned char c = (unsigned char)(pSource[i]);
+		fnv = (fnv ^ c) * 16777619u;
+		djb = djb * 33 + c;
+	}
+	hash[0] = fnv;
+	hash[1] = djb;
+}
+
+void LuaScriptCache::diskEntryPath(const char *key, char *dest, PrimitiveTypes::UInt32 size)
+{
+	PrimitiveTypes::UInt32 hash[2];
+	HashSource(key, StringOps::length(key), hash);
+	snprintf(dest, size, "%s/%08x%08x.luac", m_diskDirectory, hash[0], hash[1]);
+}
+
+bool LuaScriptCache::readDiskEntry(const char *key, const PrimitiveTypes::UInt32 sourceHash[2], PrimitiveTypes::UInt32 sourceSize, Entry &entry)
+{
+	char path[512];
+	diskEntryPath(key, path, 512);
+	FILE *f = fopen(path, "rb");
+	if (!f)
+		return false;
+
+	LuaScriptCacheDiskHeader header;
+	char storedKey[StrTPair<PrimitiveTypes::UInt32>::StrSize];
+	PrimitiveTypes::UInt32 keyLength = StringOps::length(key);
+	bool ok = fread(&header, sizeof(header), 1, f) == 1 &&
+		memcmp(header.m_magic, "PELC", 4) == 0 && header.m_version == PE_LUA_SCRIPT_CACHE_VERSION &&
+		header.m_keyLength == keyLength && keyLength < sizeof(storedKey) &&
+		fread(storedKey, 1, keyLength, f) == keyLength && memcmp(storedKey, key, keyLength) == 0;
+	if (ok && (header.m_sourceHash[0] != sourceHash[0] || header.m_sourceHash[1] != sourceHash[1] || header.m_sourceSize != sourceSize))
+	{
+		m_stats.m_numStale++;
+		ok = false;
+	}
+	if (ok)
+	{
+		entry.m_pBytecode = (char *)(malloc(header.m_bytecodeSize));
+		ok = entry.m_pBytecode && fread(entry.m_pBytecode, 1, header.m_bytecodeSize, f) == header.m_bytecodeSize;
+		if (!ok)
+		{
+			free(entry.m_pBytecode);
+			entry.m_pBytecode = NULL;
+		}
+	}
+	fclose(f);
+	if (!ok)
+		return false;
+
+	entry.m_sourceHash[0] = sourceHash[0];
+	entry.m_sourceHash[1] = sourceHash[1];
+	entry.m_sourceSize = sourceSize;
+	entry.m_bytecodeSize = header.m_bytecodeSize;
+	return true;
+}
+
+void LuaScriptCache::writeDiskEntry(const char *key, const Entry &entry)
+{
+	char path[512], tmpPath[540];
+	diskEntryPath(key, path, 512);
+	snprintf(tmpPath, 540, "%s.%p.tmp", path, (void *)(this)); // client and server environments may write same script
+
+	LuaScriptCacheDiskHeader header;
+	memcpy(header.m_magic, "PELC", 4);
+	header.m_version = PE_LUA_SCRIPT_CACHE_VERSION;
+	header.m_sourceHash[0] = entry.m_sourceHash[0];
+	header.m_sourceHash[1] = entry.m_sourceHash[1];
+	header.m_sourceSize = entry.m_sourceSize;
+	header.m_bytecodeSize = entry.m_bytecodeSize;
+	header.m_keyLength = StringOps::length(key);
+
+	// written next to entry and renamed, so a reader never sees half of a file
+	FILE *f = fopen(tmpPath, "wb");
+	if (!f)
+		return;
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+		fwrite(key, 1, header.m_keyLength, f) == header.m_keyLength &&
+		fwrite(entry.m_pBytecode, 1, entry.m_bytecodeSize, f) == entry.m_bytecodeSize;
+	fclose(f);
+#if PE_PLAT_IS_WIN32
+	remove(path); // rename does not replace on windows
+#endif
+	if (!ok || rename(tmpPath, path) != 0)
+		remove(tmpPath);
+}
+
+void LuaScriptCache::store(const char *key, const Entry &entry)
+{
+	PrimitiveTypes::Int32 index = m_indices.findIndex(key);
+	if (index != -1)
+	{
+		Entry &old = m_entries[m_indices.m_pairs[index].m_value];
+		m_stats.m_bytecodeBytes -= old.m_bytecodeSize;
+		free(old.m_pBytecode);
+		old = entry;
+	}
+	else if (m_entries.m_size < m_entries.m_capacity)
+	{
+		m_indices.add(key, m_entries.m_size);
+		m_entries.add(entry);
+		m_stats.m_numEntries = m_entries.m_size;
+	}
+	else
+	{
+		free(entry.m_pBytecode); // full, script stays in disk cache only
+		return;
+	}
+	m_stats.m_bytecodeBytes += entry.m_bytecodeSize;
+}
+
+int LuaScriptCache::loadFile(lua_State *L, const char *path)
+{
+	PrimitiveTypes::UInt32 sourceSize;
+	char *pSource = path ? readWholeFile(path, sourceSize) : NULL;
+
+	// stdin, missing files (for the error message), precompiled files and files starting with #! are loaded by lua
+	if (!pSource || (sourceSize && (pSource[0] == '#' || pSource[0] == LUA_SIGNATURE[0])))
+	{
+		free(pSource);
+		return luaL_loadfile(L, path);
+	}
+
+	Timer timer;
+	char key[StrTPair<PrimitiveTypes::UInt32>::StrSize];
+	PathKey(path, key, StrTPair<PrimitiveTypes::UInt32>::StrSize);
+	PrimitiveTypes::UInt32 sourceHash[2];
+	HashSource(pSource, sourceSize, sourceHash);
+
+	// memory, then disk
+	PrimitiveTypes::Int32 index = m_indices.findIndex(key);
+	if (index != -1)
+	{
+		Entry &entry = m_entries[m_indices.m_pairs[index].m_value];
+		if (entry.m_sourceHash[0] == sourceHash[0] && entry.m_sourceHash[1] == sourceHash[1] && entry.m_sourceSize == sourceSize)
+		{
+			if (luaL_loadbuffer(L, entry.m_pBytecode, entry.m_bytecodeSize, path) == 0)
+			{
+				free(pSource);
+				m_stats.m_numMemoryHits++;
+				m_stats.m_cachedLoadMs += timer.TickAndGetTimeDeltaInSeconds() * 1000.0f;
+				return 0;
+			}
+			lua_pop(L, 1);
+		}
+		else
+			m_stats.m_numStale++;
+	}
+	else if (m_diskDirectory[0])
+	{
+		Entry entry;
+		if (readDiskEntry(key, sourceHash, sourceSize, entry))
+		{
+			if (luaL_loadbuffer(L, entry.m_pBytecode, entry.m_bytecodeSize, path) == 0)
+			{
+				free(pSource);
+				store(key, entry);
+				m_stats.m_numDiskHits++;
+				m_stats.m_cachedLoadMs += timer.TickAndGetTimeDeltaInSeconds() * 1000.0f;
+				return 0;
+			}
+			lua_pop(L, 1); // written by different lua build
+			free(entry.m_pBytecode);
+		}
+	}
+
+	// compile. chunk name as luaL_loadfile() gives it
+	char chunkName[StrTPair<PrimitiveTypes::UInt32>::StrSize + 1];
+	snprintf(chunkName, sizeof(chunkName), "@%s", path);
+	int errCode = luaL_loadbuffer(L, pSource, sourceSize, chunkName);
+	free(pSource);
+	m_stats.m_numCompiles++;
+	if (errCode != 0)
+		return errCode;
+
+	LuaScriptCacheChunkBuffer buf = {NULL, 0, 0};
+	if (lua_dump(L, writeChunk, &buf) == 0 && buf.m_size)
+	{
+		Entry entry;
+		entry.m_sourceHash[0] = sourceHash[0];
+		entry.m_sourceHash[1] = sourceHash[1];
+		entry.m_sourceSize = sourceSize;
+		entry.m_pBytecode = buf.m_pData;
+		entry.m_bytecodeSize = buf.m_size;
+		if (m_diskDirectory[0])
+			writeDiskEntry(key, entry);
+		store(key, entry);
+	}
+	else
+		free(buf.m_pData);
+
+	m_stats.m_compileMs += timer.TickAndGetTimeDeltaInSeconds() * 1000.0f;
+	return 0;
+}
+
+// same as dofile() and loadfile() of lua base library, with loading through cache
+
+int LuaScriptCache::l_dofile(lua_State *L)
+{
+	LuaScriptCache *pCache = (LuaScriptCache *)(lua_touserdata(L, lua_upvalueindex(1)));
+	const char *fname = luaL_optstring(L, 1, NULL);
+	int n = lua_gettop(L);
+	if (pCache->loadFile(L, fname) != 0)
+		lua_error(L);
+	lua_call(L, 0, LUA_MULTRET);
+	return lua_gettop(L) - n;
+}
+
+int LuaScriptCache::l_loadfile(lua_State *L)
+{
+	LuaScriptCache *pCache = (LuaScriptCache *)(lua_touserdata(L, lua_upvalueindex(1)));
+	const char *fname = luaL_optstring(L, 1, NULL);
+	if (pCache->loadFile(L, fname) == 0)
+		return 1;
+	lua_pushnil(L);
+	lua_insert(L, -2);
+	return 2;
+}
+
+void LuaScriptCache::RegisterLuaFunctions(lua_State *L, LuaScriptCache *pCache)
+{
+	lua_pushlightuserdata(L, pCache);
+	lua_pushcclosure(L, l_dofile, 1);
+	lua_setglobal(L, "dofile");
+
+	lua_pushlightuserdata(L, pCache);
+	lua_pushcclosure(L, l_loadfile, 1);
+	lua_setglobal(L, "loadfile");
+}
+
+}; // namespace PE
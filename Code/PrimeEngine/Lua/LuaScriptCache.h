@@ -0,0 +1,95 @@
+#ifndef __PYENGINE_2_0_LUA_SCRIPT_CACHE_H__
+#define __PYENGINE_2_0_LUA_SCRIPT_CACHE_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Lua Stuff
+extern "C" {
+#include "../../lua_dist/src/lua.h"
+}
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/Utils/PEMap.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+// Bytecode cache of script files (PE_LUA_BYTECODE_CACHE). Scripts are found by path and checked by content:
+// the source is read and hashed on every load, a cached chunk is used only if hash and size of source match, otherwise
+// the source is compiled and the entry replaced. So edited scripts are never stale, and the same script run again
+// (object scripts of levels, materials) is not parsed again.
+// Compiled chunks are kept in memory and written to a disk cache directory (one file per script, name is hash of the
+// path) so next run of the game starts from bytecode too. Disk entries are only trusted by their header, the cache
+// directory must not be writable by others
+struct LuaScriptCache
+{
+	struct Stats
+	{
+		PrimitiveTypes::UInt32 m_numMemoryHits;
+		PrimitiveTypes::UInt32 m_numDiskHits;
+		PrimitiveTypes::UInt32 m_numCompiles; // not in cache or stale
+		PrimitiveTypes::UInt32 m_numStale; // cached for a different source
+		PrimitiveTypes::UInt32 m_numEntries;
+		PrimitiveTypes::UInt32 m_bytecodeBytes; // in memory
+		PrimitiveTypes::Float32 m_compileMs; // total time of loads that compiled
+		PrimitiveTypes::Float32 m_cachedLoadMs; // total time of loads from memory or disk
+	};
+
+	LuaScriptCache(PE::GameContext &context, PE::MemoryArena arena);
+	~LuaScriptCache();
+
+	// directory for bytecode files, created if missing. NULL or never set: memory only
+	void setDiskDirectory(const char *path);
+	const char *getDiskDirectory() { return m_diskDirectory; }
+
+	// like luaL_loadfile(): pushes compiled chunk or error message, returns 0 or lua error code
+	int loadFile(lua_State *L, const char *path);
+
+	// drops memory entries (disk entries stay, they are checked on load anyway)
+	void clear();
+
+	Stats getStats() { return m_stats; }
+
+	// installs dofile() and loadfile() that go through cache into global table of L
+	static void RegisterLuaFunctions(lua_State *L, LuaScriptCache *pCache);
+
+	// same file gets same key however path was put together: '/' delimeters, no repeated delimeters
+	static void PathKey(const char *pPath, char *dest, PrimitiveTypes::UInt32 size);
+
+	// two independent 32 bit hashes (FNV-1a and djb2), 64 bits together
+	static void HashSource(const char *pSource, PrimitiveTypes::UInt32 size, PrimitiveTypes::UInt32 hash[2]);
+
+private:
+	struct Entry
+	{
+		PrimitiveTypes::UInt32 m_sourceHash[2];
+		PrimitiveTypes::UInt32 m_sourceSize;
+		char *m_pBytecode; // malloc'd
+		PrimitiveTypes::UInt32 m_bytecodeSize;
+	};
+
+	static int l_dofile(lua_State *L);
+	static int l_loadfile(lua_State *L);
+
+	bool readDiskEntry(const char *key, const PrimitiveTypes::UInt32 sourceHash[2], PrimitiveTypes::UInt32 sourceSize, Entry &entry);
+	void writeDiskEntry(const char *key, const Entry &entry);
+	void diskEntryPath(const char *key, char *dest, PrimitiveTypes::UInt32 size);
+	void store(const char *key, const Entry &entry);
+
+	PEMap<PrimitiveTypes::UInt32> m_indices; // script path with '/' delimeters -> index in m_entries
+	Array<Entry, 1> m_entries;
+	char m_diskDirectory[256];
+	Stats m_stats;
+};
+
+}; // namespace PE
+
+#endif
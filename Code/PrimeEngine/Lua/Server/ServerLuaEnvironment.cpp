@@ -27,11 +27,25 @@ int ServerLuaEnvironment::l_getGameContext(lua_State* luaVM)
 	return 1;	
 }
 
+// l_setServerTickRate(30)
+int ServerLuaEnvironment::l_setServerTickRate(lua_State* luaVM)
+{
+	int tickRate = (int)(lua_tonumber(luaVM, -1));
+	lua_pop(luaVM, 1);
+
+	ServerGame *pGame = (ServerGame *)(PE::Components::ServerGame::s_context.getGame());
+	if (pGame && tickRate > 0)
+		pGame->setTickRate(tickRate);
+
+	return 0; // no return values
+}
+
 void ServerLuaEnvironment::registerInitialLibrariesFunctions()
 {
 	LuaEnvironment::registerInitialLibrariesFunctions();
 
 	lua_register(L, "l_getGameContext", l_getGameContext);
+	lua_register(L, "l_setServerTickRate", l_setServerTickRate);
 }
 
 void ServerLuaEnvironment::do_UPDATE(Events::Event *pEvt)
@@ -21,6 +21,7 @@ struct ServerLuaEnvironment : public LuaEnvironment
 	virtual void do_UPDATE(Events::Event *pEvt);
 
 	static int l_getGameContext(lua_State* luaVM);
+	static int l_setServerTickRate(lua_State* luaVM);
 
 	int m_framesSinceLastFailedInit;
 }; // class ServerLuaEnvironment
@@ -30,6 +30,11 @@ MainFunctionArgs::MainFunctionArgs(PE::GameContext &context, PE::MemoryArena are
 		StringOps::writeToString(".\\", m_gameProjRoot, 256);
     #endif
 
+	#if PE_PLAT_IS_LINUX
+		// run from workspace root, same as windows debugdir
+		StringOps::writeToString("./", m_gameProjRoot, 256);
+	#endif
+
 	#if PE_PLAT_IS_PSVITA
 		StringOps::writeToString("app0:", m_gameProjRoot, 256);
 		//StringOps::writeToString("host0:", m_gameProjRoot, 256); // host0: maps to file serving directory. // host:C:/path can be used for absolute paths
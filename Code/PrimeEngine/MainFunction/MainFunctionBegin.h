@@ -13,6 +13,23 @@
 			params.args[iarg] = argv[iarg];
 		params.argc = argc;
 
+		//set parameters after this file's #include
+#elif PE_PLAT_IS_LINUX
+	// headless: no window, only server is initialized and run (see MainFunctionEnd.h)
+	int main(int argc, char *argv[])
+	{
+		PE::Components::ClientGame::EngineInitParams &params = PE::Components::ClientGame::EngineInitParams::s_params;
+		{
+			PE::Components::ServerGame::EngineInitParams &serverParams = PE::Components::ServerGame::EngineInitParams::s_params;
+			assert(PE::Components::ServerGame::EngineInitParams::MAX_ARGS >= argc);
+
+			for (int iarg = 0; iarg < argc; ++iarg)
+				params.args[iarg] = serverParams.args[iarg] = argv[iarg];
+			params.argc = serverParams.argc = argc;
+			if (argc > 1)
+				params.lpCmdLine = serverParams.lpCmdLine = argv[1];
+		}
+
 		//set parameters after this file's #include
 #else
 
@@ -22,6 +22,7 @@
 
 
 		// Begin Client Initialization
+		#if !APIABSTRACTION_HEADLESS
 		{
 			//initialize engine by calling the initEngine callback
 			if (!PE::Components::ClientGlobalGameCallbacks::InitEngine(PE::Components::ClientGame::s_context , PE::MemoryArena_Client)) return RETURN_VALUE;
@@ -36,6 +37,7 @@
 
 			PE::GlobalRegistry::Instance()->setInitialized(true); // since server was initializes, we must have registered classes already
 		}
+		#endif
 		// End Client Initialization
 
 		// Begin Server Initialization
@@ -55,6 +57,13 @@
 		}
 		// End Server Initialization
 
+		#if APIABSTRACTION_HEADLESS
+			PE::GlobalRegistry::Instance()->setInitialized(true);
+
+			// no client thread to keep process alive, server loop runs on this thread until SIGINT/SIGTERM
+			PE::Components::ServerGlobalGameCallbacks::getGameInstance()->runGameOnThisThread();
+			return RETURN_VALUE;
+		#endif
 
 		//Run the game
 
@@ -18,7 +18,7 @@
 // Sibling/Children includes
 
 // #define's
-#if APIABSTRACTION_D3D9 || APIABSTRACTION_D3D11 || APIABSTRACTION_OGL || PE_PLAT_IS_PSVITA
+#if APIABSTRACTION_D3D9 || APIABSTRACTION_D3D11 || APIABSTRACTION_OGL || PE_PLAT_IS_PSVITA || APIABSTRACTION_HEADLESS
 	// D3D uses Left-Handed Coordinate System
 	#define LEFT_COORDINATE_SYSTEM
 #endif
@@ -41,7 +41,7 @@ T min(const T& a, const T& b)
 namespace pemath
 {
 	PE_INLINE float sign(float f) {
-#if APIABSTRACTION_PSVITA || APIABSTRACTION_IOS || PE_PLAT_IS_PS4
+#if APIABSTRACTION_PSVITA || APIABSTRACTION_IOS || PE_PLAT_IS_PS4 || PE_PLAT_IS_LINUX
 		return (float)copysign(1.0, f);
 #else
 		return (float)_copysign(1.0, f);
@@ -40,6 +40,7 @@ void MemoryManager::Construct()
 	PEINFO("Memory manager allocated memory %dB at 0x%p\n", totalMemoryNeeded + ALLIGNMENT, ptr);
 	memset(ptr, 0, totalMemoryNeeded + ALLIGNMENT);
 	MemoryManager::s_pInstance = new MemoryManager();
+	s_pInstance->m_numBlocksAllocated = 0;
 	void *allignedPtr = nextAlligned(ptr);
 	
 	for (unsigned int i = 0; i < N_MEMORY_POOLS; i++)
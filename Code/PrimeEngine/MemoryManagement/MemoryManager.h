@@ -72,6 +72,8 @@ public:
 	// [12-15]
 	MemoryPool *m_memoryPools[1024]; // pointers to all memory pools
 
+	unsigned int m_numBlocksAllocated; // ever, i.e. Handle allocations. wraps
+
 	static MemoryManager *instance() 
 	{
 		return MemoryManager::s_pInstance;
@@ -99,6 +101,7 @@ public:
 				if (m_memoryPools[out_memoryPoolIndex]->allocateBlock(requiredSize, out_memoryBlockIndex))
 				{
 					allocated = true;
+					++m_numBlocksAllocated;
 					break;
 				}
 				else
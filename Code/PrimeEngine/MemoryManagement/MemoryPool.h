@@ -5,7 +5,7 @@
 
 #include <assert.h>
 
-#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA && !PE_PLAT_IS_PS4
+#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA && !PE_PLAT_IS_PS4 && !PE_PLAT_IS_LINUX
 	#include <process.h>
 	#include <stdlib.h>
 #else
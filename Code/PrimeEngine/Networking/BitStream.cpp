@@ -0,0 +1,262 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+#include "BitStream.h"
+
+// Outer-Engine includes
+#include <math.h>
+#include <string.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Utils/ErrorHandling.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+static const PrimitiveTypes::Float32 s_quaternionComponentMax = 0.707107f; // 1/sqrt(2)
+
+BitStreamWriter::BitStreamWriter(char *pDataStream, int capacity)
+: m_pData(pDataStream)
+, m_capacity(capacity)
+, m_bitPos(0)
+{}
+
+void BitStreamWriter::writeBits(PrimitiveTypes::UInt32 v, int numBits)
+{
+	PEASSERT(numBits >= 0 && numBits <= 32, "Can write up to 32 bits at once");
+	PEASSERT((int)((m_bitPos + numBits + 7) / 8) <= m_capacity, "Bit stream overflow: capacity %d bytes", m_capacity);
+
+	if (numBits < 32)
+		v &= (1u << numBits) - 1;
+
+	while (numBits > 0)
+	{
+		PrimitiveTypes::UInt32 byteIndex = m_bitPos / 8;
+		PrimitiveTypes::UInt32 bitInByte = m_bitPos % 8;
+		int bitsHere = 8 - (int)(bitInByte);
+		if (bitsHere > numBits)
+			bitsHere = numBits;
+
+		unsigned char mask = (unsigned char)(((1u << bitsHere) - 1) << bitInByte);
+		unsigned char bits = (unsigned char)((v << bitInByte) & mask);
+
+		// clear bits on byte start so that we don't depend on buffer contents
+		unsigned char old = bitInByte ? (unsigned char)(m_pData[byteIndex]) : 0;
+		m_pData[byteIndex] = (char)((old & ~mask) | bits);
+
+		v >>= bitsHere;
+		numBits -= bitsHere;
+		m_bitPos += bitsHere;
+	}
+}
+
+void BitStreamWriter::writeVarUInt32(PrimitiveTypes::UInt32 v)
+{
+	while (v >= 0x80)
+	{
+		writeBits((v & 0x7f) | 0x80, 8);
+		v >>= 7;
+	}
+	writeBits(v, 8);
+}
+
+void BitStreamWriter::writeVarInt32(PrimitiveTypes::Int32 v)
+{
+	writeVarUInt32(((PrimitiveTypes::UInt32)(v) << 1) ^ (PrimitiveTypes::UInt32)(v >> 31));
+}
+
+void BitStreamWriter::writeFloat32(PrimitiveTypes::Float32 v)
+{
+	PrimitiveTypes::UInt32 bits;
+	memcpy(&bits, &v, 4);
+	writeBits(bits, 32);
+}
+
+void BitStreamWriter::writeQuantizedFloat(PrimitiveTypes::Float32 v, PrimitiveTypes::Float32 min, PrimitiveTypes::Float32 max, int numBits)
+{
+	if (v < min) v = min;
+	if (v > max) v = max;
+
+	PrimitiveTypes::UInt32 maxInt = numBits < 32 ? (1u << numBits) - 1 : 0xffffffff;
+	PrimitiveTypes::Float32 t = (v - min) / (max - min);
+	writeBits((PrimitiveTypes::UInt32)(t * (PrimitiveTypes::Float32)(maxInt) + 0.5f), numBits);
+}
+
+void BitStreamWriter::writeQuantizedVector3(const Vector3 &v, PrimitiveTypes::Float32 min, PrimitiveTypes::Float32 max, int numBits)
+{
+	writeQuantizedFloat(v.m_x, min, max, numBits);
+	writeQuantizedFloat(v.m_y, min, max, numBits);
+	writeQuantizedFloat(v.m_z, min, max, numBits);
+}
+
+void BitStreamWriter::writeQuaternion(const Quaternion &q, int bitsPerComponent)
+{
+	PrimitiveTypes::Float32 c[4] = {q.m_x, q.m_y, q.m_z, q.m_w};
+
+	PrimitiveTypes::Float32 len = sqrtf(c[0] * c[0] + c[1] * c[1] + c[2] * c[2] + c[3] * c[3]);
+	int largest = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		c[i] = len > 0 ? c[i] / len : (i == 3 ? 1.0f : 0.0f);
+		if (fabsf(c[i]) > fabsf(c[largest]))
+			largest = i;
+	}
+
+	PrimitiveTypes::Float32 sign = c[largest] < 0 ? -1.0f : 1.0f;
+
+	writeBits(largest, 2);
+	for (int i = 0; i < 4; ++i)
+	{
+		if (i != largest)
+			writeQuantizedFloat(c[i] * sign, -s_quaternionComponentMax, s_quaternionComponentMax, bitsPerComponent);
+	}
+}
+
+void BitStreamWriter::writeTransform(const Matrix4x4 &m)
+{
+	writeQuantizedVector3(m.getPos(), -PE_NET_POSITION_RANGE, PE_NET_POSITION_RANGE, PE_NET_POSITION_BITS);
+	writeQuaternion(QuaternionFromMatrix(m));
+}
+
+BitStreamReader::BitStreamReader(char *pDataStream)
+: m_pData(pDataStream)
+, m_bitPos(0)
+{}
+
+PrimitiveTypes::UInt32 BitStreamReader::readBits(int numBits)
+{
+	PEASSERT(numBits >= 0 && numBits <= 32, "Can read up to 32 bits at once");
+
+	PrimitiveTypes::UInt32 v = 0;
+	int shift = 0;
+	while (numBits > 0)
+	{
+		PrimitiveTypes::UInt32 byteIndex = m_bitPos / 8;
+		PrimitiveTypes::UInt32 bitInByte = m_bitPos % 8;
+		int bitsHere = 8 - (int)(bitInByte);
+		if (bitsHere > numBits)
+			bitsHere = numBits;
+
+		PrimitiveTypes::UInt32 bits = ((unsigned char)(m_pData[byteIndex]) >> bitInByte) & ((1u << bitsHere) - 1);
+		v |= bits << shift;
+
+		shift += bitsHere;
+		numBits -= bitsHere;
+		m_bitPos += bitsHere;
+	}
+	return v;
+}
+
+PrimitiveTypes::UInt32 BitStreamReader::readVarUInt32()
+{
+	PrimitiveTypes::UInt32 v = 0;
+	for (int shift = 0; shift < 35; shift += 7)
+	{
+		PrimitiveTypes::UInt32 b = readBits(8);
+		v |= (b & 0x7f) << shift;
+		if (!(b & 0x80))
+			break;
+	}
+	return v;
+}
+
+PrimitiveTypes::Int32 BitStreamReader::readVarInt32()
+{
+	PrimitiveTypes::UInt32 v = readVarUInt32();
+	return (PrimitiveTypes::Int32)((v >> 1) ^ (0u - (v & 1)));
+}
+
+PrimitiveTypes::Float32 BitStreamReader::readFloat32()
+{
+	PrimitiveTypes::UInt32 bits = readBits(32);
+	PrimitiveTypes::Float32 v;
+	memcpy(&v, &bits, 4);
+	return v;
+}
+
+PrimitiveTypes::Float32 BitStreamReader::readQuantizedFloat(PrimitiveTypes::Float32 min, PrimitiveTypes::Float32 max, int numBits)
+{
+	PrimitiveTypes::UInt32 maxInt = numBits < 32 ? (1u << numBits) - 1 : 0xffffffff;
+	PrimitiveTypes::UInt32 i = readBits(numBits);
+	return min + (max - min) * ((PrimitiveTypes::Float32)(i) / (PrimitiveTypes::Float32)(maxInt));
+}
+
+Vector3 BitStreamReader::readQuantizedVector3(PrimitiveTypes::Float32 min, PrimitiveTypes::Float32 max, int numBits)
+{
+	Vector3 v;
+	v.m_x = readQuantizedFloat(min, max, numBits);
+	v.m_y = readQuantizedFloat(min, max, numBits);
+	v.m_z = readQuantizedFloat(min, max, numBits);
+	return v;
+}
+
+Quaternion BitStreamReader::readQuaternion(int bitsPerComponent)
+{
+	int largest = (int)(readBits(2));
+
+	PrimitiveTypes::Float32 c[4];
+	PrimitiveTypes::Float32 sumSqr = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		if (i == largest)
+			continue;
+		c[i] = readQuantizedFloat(-s_quaternionComponentMax, s_quaternionComponentMax, bitsPerComponent);
+		sumSqr += c[i] * c[i];
+	}
+	c[largest] = sumSqr < 1.0f ? sqrtf(1.0f - sumSqr) : 0.0f;
+
+	Quaternion q(c[3], c[0], c[1], c[2]);
+	q.normalize(); // quantization error
+	return q;
+}
+
+void BitStreamReader::readTransform(Matrix4x4 &out_m)
+{
+	Vector3 pos = readQuantizedVector3(-PE_NET_POSITION_RANGE, PE_NET_POSITION_RANGE, PE_NET_POSITION_BITS);
+	Quaternion q = readQuaternion();
+	out_m.setFromQuatAndPos(q, pos);
+}
+
+Quaternion QuaternionFromMatrix(const Matrix4x4 &m)
+{
+	// pick the biggest of w, x, y, z to divide by, for precision
+	PrimitiveTypes::Float32 trace = m.m[0][0] + m.m[1][1] + m.m[2][2];
+	Quaternion q;
+	if (trace > 0)
+	{
+		PrimitiveTypes::Float32 s = sqrtf(trace + 1.0f) * 2.0f; // 4w
+		q.m_w = 0.25f * s;
+		q.m_x = (m.m[2][1] - m.m[1][2]) / s;
+		q.m_y = (m.m[0][2] - m.m[2][0]) / s;
+		q.m_z = (m.m[1][0] - m.m[0][1]) / s;
+	}
+	else if (m.m[0][0] > m.m[1][1] && m.m[0][0] > m.m[2][2])
+	{
+		PrimitiveTypes::Float32 s = sqrtf(1.0f + m.m[0][0] - m.m[1][1] - m.m[2][2]) * 2.0f; // 4x
+		q.m_w = (m.m[2][1] - m.m[1][2]) / s;
+		q.m_x = 0.25f * s;
+		q.m_y = (m.m[0][1] + m.m[1][0]) / s;
+		q.m_z = (m.m[0][2] + m.m[2][0]) / s;
+	}
+	else if (m.m[1][1] > m.m[2][2])
+	{
+		PrimitiveTypes::Float32 s = sqrtf(1.0f + m.m[1][1] - m.m[0][0] - m.m[2][2]) * 2.0f; // 4y
+		q.m_w = (m.m[0][2] - m.m[2][0]) / s;
+		q.m_x = (m.m[0][1] + m.m[1][0]) / s;
+		q.m_y = 0.25f * s;
+		q.m_z = (m.m[1][2] + m.m[2][1]) / s;
+	}
+	else
+	{
+		PrimitiveTypes::Float32 s = sqrtf(1.0f + m.m[2][2] - m.m[0][0] - m.m[1][1]) * 2.0f; // 4z
+		q.m_w = (m.m[1][0] - m.m[0][1]) / s;
+		q.m_x = (m.m[0][2] + m.m[2][0]) / s;
+		q.m_y = (m.m[1][2] + m.m[2][1]) / s;
+		q.m_z = 0.25f * s;
+	}
+	return q;
+}
+
+}; // namespace PE
@@ -0,0 +1,93 @@
+#ifndef __PrimeEngineBitStream_H__
+#define __PrimeEngineBitStream_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Vector3.h"
+#include "PrimeEngine/Math/Quaternion.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+
+// Sibling/Children includes
+
+// world positions sent over network are quantized in [-range, range]
+#define PE_NET_POSITION_RANGE 2048.0f
+#define PE_NET_POSITION_BITS 20 // ~4mm steps
+
+// smallest three quaternion components are in [-1/sqrt(2), 1/sqrt(2)]
+#define PE_NET_QUATERNION_BITS 11 // ~0.05 degree
+
+namespace PE {
+
+// Writes values with arbitrary bit counts, first bit goes into lowest bit of first byte.
+// Byte order independent: both sides read the same bytes the same way.
+// Used inside packCreationData()/packGhostState(): write everything, then return getSize() bytes
+struct BitStreamWriter
+{
+	BitStreamWriter(char *pDataStream, int capacity);
+
+	void writeBits(PrimitiveTypes::UInt32 v, int numBits);
+	void writeBool(bool v) {writeBits(v ? 1 : 0, 1);}
+
+	// 7 bits per group + continuation bit. small values (ids, counts) take 1 byte
+	void writeVarUInt32(PrimitiveTypes::UInt32 v);
+	// zigzag so that small negative values are small too
+	void writeVarInt32(PrimitiveTypes::Int32 v);
+
+	void writeFloat32(PrimitiveTypes::Float32 v);
+
+	// v is clamped to [min, max] and mapped to numBits integer
+	void writeQuantizedFloat(PrimitiveTypes::Float32 v, PrimitiveTypes::Float32 min, PrimitiveTypes::Float32 max, int numBits);
+	void writeQuantizedVector3(const Vector3 &v, PrimitiveTypes::Float32 min, PrimitiveTypes::Float32 max, int numBits);
+
+	// smallest three: index of largest component (2 bits) + other three components.
+	// largest is made positive (q and -q are same rotation) and reconstructed from unit length
+	void writeQuaternion(const Quaternion &q, int bitsPerComponent = PE_NET_QUATERNION_BITS);
+
+	// position + rotation of matrix. matrix has to be orthonormal (scale is not sent)
+	void writeTransform(const Matrix4x4 &m);
+
+	// bytes written, last byte is padded
+	int getSize() const {return (int)((m_bitPos + 7) / 8);}
+
+	char *m_pData;
+	int m_capacity;
+	PrimitiveTypes::UInt32 m_bitPos;
+};
+
+struct BitStreamReader
+{
+	BitStreamReader(char *pDataStream);
+
+	PrimitiveTypes::UInt32 readBits(int numBits);
+	bool readBool() {return readBits(1) != 0;}
+
+	PrimitiveTypes::UInt32 readVarUInt32();
+	PrimitiveTypes::Int32 readVarInt32();
+
+	PrimitiveTypes::Float32 readFloat32();
+
+	PrimitiveTypes::Float32 readQuantizedFloat(PrimitiveTypes::Float32 min, PrimitiveTypes::Float32 max, int numBits);
+	Vector3 readQuantizedVector3(PrimitiveTypes::Float32 min, PrimitiveTypes::Float32 max, int numBits);
+
+	Quaternion readQuaternion(int bitsPerComponent = PE_NET_QUATERNION_BITS);
+
+	void readTransform(Matrix4x4 &out_m);
+
+	// bytes read, including padding of last byte
+	int getSize() const {return (int)((m_bitPos + 7) / 8);}
+
+	char *m_pData;
+	PrimitiveTypes::UInt32 m_bitPos;
+};
+
+// rotation part of orthonormal matrix as quaternion. inverse of Matrix4x4::setFromQuatAndPos()
+Quaternion QuaternionFromMatrix(const Matrix4x4 &m);
+
+}; // namespace PE
+#endif
@@ -26,6 +26,7 @@ extern "C"
 
 #include "PrimeEngine/Networking/StreamManager.h"
 #include "PrimeEngine/Networking/EventManager.h"
+#include "PrimeEngine/Networking/GhostManager.h"
 
 // Sibling/Children includes
 using namespace PE::Events;
@@ -95,12 +96,50 @@ void ClientNetworkManager::clientConnectToTCPServer(const char *strAddr, int por
 			m_state = ClientState_Connected;
 			
 			createNetworkConnectionContext(sock, &m_netContext);
+			m_netContext.getConnectionManager()->initializeConnected(sock);
 			m_netContextLock.unlock();
 			break;
 		}
 	}
 }
 
+void ClientNetworkManager::clientConnectToUDPServer(const char *strAddr, int port)
+{
+	if (port == 0)
+		port = PE_SERVER_PORT;
+
+	t_socket sock;
+	const char *err = /*luasocket::*/inet_trycreate(&sock, SOCK_DGRAM);
+	if (err)
+	{
+		assert(!"error creating socket occurred");
+		return;
+	}
+
+	// for udp connect only sets default destination, so this doesn't wait for server
+	t_timeout timeout;
+	timeout.block = PE_CLIENT_TO_SERVER_CONNECT_TIMEOUT;
+	timeout.total = -1.0;
+	timeout.start = 0;
+
+	err = inet_tryconnect(&sock, strAddr, port, &timeout);
+	if (err)
+	{
+		PEINFO("PE: Warning: Failed to connect to %s:%d (udp) reason: %s\n", strAddr, port, err);
+		socket_destroy(&sock);
+		return;
+	}
+
+	PEINFO("PE: Client connecting to %s:%d (udp)\n", strAddr, port);
+	m_netContextLock.lock();
+	m_state = ClientState_Connected;
+
+	createNetworkConnectionContext(sock, &m_netContext);
+	// server creates connection after connect handshake
+	m_netContext.getConnectionManager()->initializeConnectingUdp(sock);
+	m_netContextLock.unlock();
+}
+
 void ClientNetworkManager::createNetworkConnectionContext(t_socket sock, PE::NetworkContext *pNetContext)
 {
 	NetworkManager::createNetworkConnectionContext(sock, pNetContext);
@@ -120,7 +159,10 @@ void ClientNetworkManager::createNetworkConnectionContext(t_socket sock, PE::Net
 		pNetContext->getEventManager()->addDefaultComponents();
 	}
 
-	pNetContext->getConnectionManager()->initializeConnected(sock);
+	{
+		pNetContext->m_pGhostManager = new (m_arena) GhostManager(*m_pContext, m_arena, *pNetContext, Handle());
+		pNetContext->getGhostManager()->addDefaultComponents();
+	}
 
 	addComponent(pNetContext->getConnectionManager()->getHandle());
 	addComponent(pNetContext->getStreamManager()->getHandle());
@@ -143,7 +185,8 @@ void ClientNetworkManager::do_UPDATE(PE::Events::Event *pEvt)
 	{
 		if (m_state == ClientState_Connected)
 		{
-			if (!m_netContext.getConnectionManager()->connected())
+			ConnectionManager *pConnectionManager = m_netContext.getConnectionManager();
+			if (!pConnectionManager->connected() && !pConnectionManager->connecting())
 			{
 				// disconnect happened
 				m_state = ClientState_Disconnected;
@@ -186,6 +229,7 @@ void ClientNetworkManager::debugRender(int &threadOwnershipMask, float xoffset /
 	m_netContextLock.lock();
 	
 	m_netContext.getEventManager()->debugRender(threadOwnershipMask, xoffset + dx, yoffset + dy);
+	m_netContext.getGhostManager()->debugRender(threadOwnershipMask, xoffset + dx + 0.5f, yoffset + dy);
 	
 	m_netContextLock.unlock();
 }
@@ -213,6 +257,7 @@ void ClientNetworkManager::SetLuaFunctions(PE::Components::LuaEnvironment *pLuaE
 	*/
 	static const struct luaL_Reg l_functions[] = {
 		{"l_clientConnectToTCPServer", l_clientConnectToTCPServer},
+		{"l_clientConnectToUDPServer", l_clientConnectToUDPServer},
 		{NULL, NULL} // sentinel
 	};
 
@@ -245,5 +290,22 @@ int ClientNetworkManager::l_clientConnectToTCPServer(lua_State *luaVM)
 	return 0; // no return values
 }
 
+int ClientNetworkManager::l_clientConnectToUDPServer(lua_State *luaVM)
+{
+	lua_Number lPort = lua_tonumber(luaVM, -1);
+	int port = (int)(lPort);
+
+	const char *strAddr = lua_tostring(luaVM, -2);
+
+	GameContext *pContext = (GameContext *)(lua_touserdata(luaVM, -3));
+
+	lua_pop(luaVM, 3);
+
+	ClientNetworkManager *pClientNetwManager = (ClientNetworkManager *)(pContext->getNetworkManager());
+	pClientNetwManager->clientConnectToUDPServer(strAddr, port);
+
+	return 0; // no return values
+}
+
 }; // namespace Components
 }; // namespace PE
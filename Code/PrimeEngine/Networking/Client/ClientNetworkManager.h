@@ -48,6 +48,10 @@ struct ClientNetworkManager : public NetworkManager
 
 	void clientConnectToTCPServer(const char *strAddr, int port);
 
+	// udp connection to server's udp socket (same port as tcp). server creates the connection
+	// when first datagram arrives, connection is dropped if server doesn't reply in PE_UDP_CONNECTION_TIMEOUT
+	void clientConnectToUDPServer(const char *strAddr, int port);
+
 	virtual void createNetworkConnectionContext(t_socket sock, PE::NetworkContext *pNetContext);
 
 	// Component ------------------------------------------------------------
@@ -72,6 +76,8 @@ struct ClientNetworkManager : public NetworkManager
 	//
 	static int l_clientConnectToTCPServer(lua_State *luaVM);
 	//
+	static int l_clientConnectToUDPServer(lua_State *luaVM);
+	//
 	//////////////////////////////////////////////////////////////////////////
 
 	//////////////////////////////////////////////////////////////////////////
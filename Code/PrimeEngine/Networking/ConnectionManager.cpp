@@ -5,6 +5,7 @@
 #include "ConnectionManager.h"
 
 // Outer-Engine includes
+#include <algorithm>
 
 // Inter-Engine includes
 
@@ -20,8 +21,15 @@ extern "C"
 #include "../../../GlobalConfig/GlobalConfig.h"
 #include "PrimeEngine/Events/StandardEvents.h"
 
+#include "PrimeEngine/Networking/NetworkManager.h"
+
 // Sibling/Children includes
 #include "StreamManager.h"
+#include "EventManager.h"
+#include "GhostManager.h"
+#include "SocketPoller.h"
+
+#include "PrimeEngine/Profiling/Benchmark.h"
 
 using namespace PE::Events;
 
@@ -32,16 +40,59 @@ PE_IMPLEMENT_CLASS1(ConnectionManager, Component);
 
 ConnectionManager::ConnectionManager(PE::GameContext &context, PE::MemoryArena arena, PE::NetworkContext &netContext, Handle hMyself)
 : Component(context, arena, hMyself)
-, m_state(ConnectionManagerState_Disconnected)
-, m_bytesNeededForNextPacket(0)
-, m_bytesBuffered(0)
 {
 	m_pNetContext = &netContext;
+	reset();
 }
 
 ConnectionManager::~ConnectionManager()
 {
+	for (unsigned int i = 0; i < m_sendQueue.size(); ++i)
+		pefree(m_arena, m_sendQueue[i]);
+}
+
+void ConnectionManager::reset()
+{
+	m_state = ConnectionManagerState_Disconnected;
+	m_bytesNeededForNextPacket = 0;
+	m_bytesBuffered = 0;
 
+	m_ackSimulation.clear();
+
+	for (unsigned int i = 0; i < m_sendQueue.size(); ++i)
+		pefree(m_arena, m_sendQueue[i]);
+	m_sendQueue.clear();
+	m_sendQueueOffset = 0;
+	m_sendQueueBytes = 0;
+
+	m_pPoller = NULL;
+	m_numBytesSent = 0;
+	m_numBytesReceived = 0;
+	m_transport = Transport_TCP;
+
+	m_udpSentPackets.clear();
+	m_udpDelayedDatagrams.clear();
+	m_udpOwnsSocket = true;
+	memset(&m_udpPeerAddr, 0, sizeof(m_udpPeerAddr));
+	m_udpLocalSequence = 0;
+	m_udpRemoteSequence = 0;
+	m_udpRemoteAckBits = 0;
+	m_udpReceivedAnyPacket = false;
+	m_udpAckPending = false;
+	m_udpNewestAcked = 0;
+	m_udpReceivedAnyAck = false;
+	m_udpNow = 0;
+	m_udpLastSendTime = -1.0e9;
+	m_udpLastReceiveTime = 0;
+	m_udpRtt = 0.1;
+	m_udpConnectCookie = 0;
+	m_udpSimLossPercent = 0;
+	m_udpSimLatency = 0;
+	m_udpSimJitter = 0;
+	m_udpSimRandom = 12345;
+	m_udpNumPacketsSent = 0;
+	m_udpNumPacketsLost = 0;
+	m_udpNumDuplicatesReceived = 0;
 }
 
 void ConnectionManager::initializeConnected(t_socket sock)
@@ -51,6 +102,33 @@ void ConnectionManager::initializeConnected(t_socket sock)
 
 	// if socket is blocking we might stall on reads
 	socket_setnonblocking(&m_sock);
+
+	SocketPoller::SetNoDelay(m_sock);
+}
+
+void ConnectionManager::initializeConnectedUdp(t_socket sock, const struct sockaddr_in *pPeerAddr)
+{
+	m_sock = sock;
+	m_state = ConnectionManagerState_Connected;
+	m_transport = Transport_UDP;
+
+	m_udpOwnsSocket = pPeerAddr == NULL;
+	if (pPeerAddr)
+		m_udpPeerAddr = *pPeerAddr;
+	else
+		socket_setnonblocking(&m_sock);
+
+	m_udpNow = timeout_gettime();
+	m_udpLastReceiveTime = m_udpNow;
+}
+
+void ConnectionManager::initializeConnectingUdp(t_socket sock)
+{
+	initializeConnectedUdp(sock, NULL);
+
+	// first request goes out with next update
+	m_state = ConnectionManagerState_Connecting;
+	m_udpConnectCookie = 0;
 }
 
 void ConnectionManager::addDefaultComponents()
@@ -63,7 +141,23 @@ void ConnectionManager::addDefaultComponents()
 void ConnectionManager::disconnect()
 {
 	m_state = ConnectionManagerState_Disconnected;
-	socket_destroy(&m_sock);
+
+	if (m_transport == Transport_TCP || m_udpOwnsSocket)
+	{
+		if (m_pPoller)
+			m_pPoller->remove(m_sock);
+		socket_destroy(&m_sock);
+	}
+	// else shared udp socket of server
+
+	for (unsigned int i = 0; i < m_sendQueue.size(); ++i)
+		pefree(m_arena, m_sendQueue[i]);
+	m_sendQueue.clear();
+	m_sendQueueOffset = 0;
+	m_sendQueueBytes = 0;
+
+	// managers of dead connection may be released before next update, nothing is notified anymore
+	m_ackSimulation.clear();
 }
 
 void ConnectionManager::sendPacket(Packet *pPacket, TransmissionRecord *pTransmissionRecord)
@@ -75,38 +169,46 @@ void ConnectionManager::sendPacket(Packet *pPacket, TransmissionRecord *pTransmi
 		return;
 	}
 
-	t_timeout timeout; // timeout supports managing timeouts of multiple blocking alls by using total.
-	// but if total is < 0 it just uses block value for each blocking call
-	timeout.block = PE_SOCKET_SEND_TIMEOUT;
-	timeout.total = -1.0;
-	timeout.start = 0;
-
-	p_timeout tm = &timeout;
-	size_t total = 0;
 	PrimitiveTypes::Int32 packetSize;
 	StreamManager::ReadInt32(&pPacket->m_data[0] /*= &pPacket->m_packetDataSizeInInet*/, packetSize);
-	size_t count = packetSize;
 
-	int err = IO_DONE;
+	if (m_transport == Transport_UDP)
+	{
+		PEASSERT(packetSize <= PE_UDP_MAX_PACKET_SIZE, "Packet of %d bytes doesn't fit in datagram", packetSize);
+
+		char datagram[PE_UDP_MAX_DATAGRAM_SIZE];
+		int size = writeUdpHeader(datagram, UdpDatagram_Packet, m_udpLocalSequence);
+		memcpy(&datagram[size], &pPacket->m_data[0], packetSize);
+		size += packetSize;
+
+		sendDatagram(datagram, size);
 
-	while (total < count && err == IO_DONE) {
-		size_t done;
-		size_t step = (count-total <= PE_SOCKET_SEND_STEPSIZE)? count-total: PE_SOCKET_SEND_STEPSIZE;
+		// stream manager is notified about this packet once it is acked or considered lost
+		UdpSentPacket sent;
+		sent.m_sequence = m_udpLocalSequence++;
+		sent.m_sendTime = m_udpNow;
+		sent.m_acked = false;
+		m_udpSentPackets.push_back(sent);
+		m_udpNumPacketsSent++;
 
-		err = socket_send(&m_sock, &pPacket->m_data[total], step, &done, tm);
-		total += done;
+		return;
 	}
 
-	if (err != IO_DONE)
+	if (m_sendQueueBytes + packetSize > PE_SOCKET_SEND_QUEUE_MAX_BYTES)
 	{
-		if (err == IO_CLOSED)
-			PEINFO("PE: Warning: Socket disconnected.\n", socket_strerror(err));
-		else
-			PEINFO("PE: Warning: Socket error on send: %s. Will disconnect.\n", socket_strerror(err));
+		PEINFO("PE: Warning: Send queue is full (%d bytes), other side is not receiving. Will disconnect.\n", m_sendQueueBytes);
 		disconnect();
-	
+
 		return;
 	}
+
+	m_numBytesSent += packetSize;
+
+	// stream manager frees its packet right after this call
+	Packet *pQueued = (Packet *)(pemalloc(m_arena, packetSize));
+	memcpy(&pQueued->m_data[0], &pPacket->m_data[0], packetSize);
+	m_sendQueue.push_back(pQueued);
+	m_sendQueueBytes += packetSize;
 	
 	// since we are using tcp, we know packets are reliable
 	// in future we will sue UDP with actual ACK packets
@@ -117,15 +219,109 @@ void ConnectionManager::sendPacket(Packet *pPacket, TransmissionRecord *pTransmi
 	m_ackSimulation.push_back(sim);
 }
 
-void ConnectionManager::receivePackets()
+void ConnectionManager::flushSendQueue()
 {
 	if (m_state != ConnectionManagerState_Connected)
+		return;
+
+	if (m_transport == Transport_UDP)
+	{
+		if (m_udpAckPending || m_udpNow - m_udpLastSendTime >= PE_UDP_KEEPALIVE_INTERVAL)
+		{
+			char datagram[PE_UDP_HEADER_SIZE];
+			int size = writeUdpHeader(datagram, UdpDatagram_Ack, 0);
+			sendDatagram(datagram, size);
+		}
+		return;
+	}
+
+	while (m_sendQueue.size())
+	{
+		const char *ppData[PE_SOCKET_MAX_GATHER_BUFFERS];
+		int sizes[PE_SOCKET_MAX_GATHER_BUFFERS];
+		int count = 0;
+		for (unsigned int i = 0; i < m_sendQueue.size() && count < PE_SOCKET_MAX_GATHER_BUFFERS; ++i, ++count)
+		{
+			PrimitiveTypes::Int32 packetSize;
+			StreamManager::ReadInt32(&m_sendQueue[i]->m_data[0], packetSize);
+			int offset = i == 0 ? m_sendQueueOffset : 0;
+			ppData[count] = &m_sendQueue[i]->m_data[offset];
+			sizes[count] = packetSize - offset;
+		}
+
+		size_t sent = 0;
+		int err = SocketPoller::SendGather(m_sock, ppData, sizes, count, &sent);
+
+		if (err == IO_TIMEOUT)
+			break; // socket buffer is full, continue when socket is writable
+
+		if (err != IO_DONE)
+		{
+			if (err == IO_CLOSED)
+				PEINFO("PE: Warning: Socket disconnected.\n", socket_strerror(err));
+			else
+				PEINFO("PE: Warning: Socket error on send: %s. Will disconnect.\n", socket_strerror(err));
+			disconnect();
+
+			return;
+		}
+
+		// pop fully sent packets
+		m_sendQueueBytes -= (int)(sent);
+		size_t left = sent;
+		for (int i = 0; i < count; ++i)
+		{
+			if (left < (size_t)(sizes[i]))
+			{
+				m_sendQueueOffset += (int)(left);
+				break;
+			}
+
+			left -= sizes[i];
+			pefree(m_arena, m_sendQueue.front());
+			m_sendQueue.erase(m_sendQueue.begin());
+			m_sendQueueOffset = 0;
+		}
+
+		if (sent == 0)
+			break;
+	}
+
+	if (m_pPoller)
+		m_pPoller->setWantWrite(m_sock, m_sendQueue.size() > 0);
+}
+
+void ConnectionManager::receivePackets()
+{
+	if (m_state == ConnectionManagerState_Disconnected)
 	{
 		// cant send since not connected
 
 		return;
 	}
 
+	if (m_transport == Transport_UDP)
+	{
+		PEASSERT(m_udpOwnsSocket, "Datagrams of shared socket are received by network manager");
+
+		t_timeout timeout;
+		timeout.block = 0;
+		timeout.total = -1.0;
+		timeout.start = 0;
+
+		// one datagram per recv
+		while (m_state != ConnectionManagerState_Disconnected)
+		{
+			size_t got = 0;
+			int err = socket_recv(&m_sock, m_buffer, PE_SOCKET_RECEIVE_BUFFER_SIZE, &got, &timeout);
+			if (err != IO_DONE)
+				break; // nothing left. errors (like port unreachable before server is up) are not fatal for udp
+
+			receiveDatagram(m_buffer, (int)(got));
+		}
+		return;
+	}
+
 	t_timeout timeout; // timeout supports managing timeouts of multiple blocking calls by using total.
 	// but if total is < 0 it just uses block value for each blocking call
 	timeout.block = PE_SOCKET_RECEIVE_TIMEOUT; // if is 0, then is not blocking
@@ -152,6 +348,7 @@ void ConnectionManager::receivePackets()
             return;
         }
         m_bytesBuffered += got;
+        m_numBytesReceived += (PrimitiveTypes::UInt32)(got);
         
         bool maybeHaveMoreData = m_bytesBuffered == PE_SOCKET_RECEIVE_BUFFER_SIZE;
 	
@@ -197,7 +394,18 @@ void ConnectionManager::receivePackets()
 
 void ConnectionManager::do_UPDATE(Events::Event *pEvt)
 {
-	receivePackets();
+	if (m_transport == Transport_UDP)
+	{
+		m_udpNow = timeout_gettime();
+		if (m_udpOwnsSocket && !m_pPoller)
+			receivePackets();
+		updateUdp();
+		return;
+	}
+
+	if (!m_pPoller)
+		receivePackets();
+
 	// ack packet simulation
 	for (unsigned int i = 0; i < m_ackSimulation.size(); ++i)
 	{
@@ -210,51 +418,528 @@ void ConnectionManager::do_UPDATE(Events::Event *pEvt)
 	m_ackSimulation.clear();
 }
 
-#if 0 // template
+//////////////////////////////////////////////////////////////////////////
+// UDP transport
+//////////////////////////////////////////////////////////////////////////
+
+// sequence numbers wrap around
+static bool sequenceGreaterThan(PrimitiveTypes::UInt32 a, PrimitiveTypes::UInt32 b)
+{
+	return (PrimitiveTypes::Int32)(a - b) > 0;
+}
+
+bool ConnectionManager::IsUdpDatagram(const char *pData, int size)
+{
+	if (size < PE_UDP_HEADER_SIZE)
+		return false;
+
+	int protocolId = ((unsigned char)(pData[0]) << 8) | (unsigned char)(pData[1]);
+	return protocolId == PE_UDP_PROTOCOL_ID;
+}
+
+int ConnectionManager::WriteUdpControlDatagram(char *pData, int type, PrimitiveTypes::UInt32 value)
+{
+	int size = 0;
+	pData[size++] = (char)((PE_UDP_PROTOCOL_ID >> 8) & 0xff);
+	pData[size++] = (char)(PE_UDP_PROTOCOL_ID & 0xff);
+	pData[size++] = (char)(type);
+	size += StreamManager::WriteInt32((PrimitiveTypes::Int32)(value), &pData[size]);
+	size += StreamManager::WriteInt32(0, &pData[size]);
+	size += StreamManager::WriteInt32(0, &pData[size]);
+	PEASSERT(size == PE_UDP_HEADER_SIZE, "Wrong udp header size");
+
+	return size;
+}
+
+int ConnectionManager::ReadUdpControlDatagram(const char *pData, int size, PrimitiveTypes::UInt32 &out_value)
+{
+	if (!IsUdpDatagram(pData, size))
+		return 0;
+
+	PrimitiveTypes::Int32 value;
+	StreamManager::ReadInt32((char *)(&pData[3]), value);
+	out_value = (PrimitiveTypes::UInt32)(value);
+
+	return (unsigned char)(pData[2]) & ~UdpDatagram_AcksValid;
+}
+
+int ConnectionManager::writeUdpHeader(char *pData, int type, PrimitiveTypes::UInt32 sequence)
+{
+	if (m_udpReceivedAnyPacket)
+		type |= UdpDatagram_AcksValid;
+
+	int size = 0;
+	pData[size++] = (char)((PE_UDP_PROTOCOL_ID >> 8) & 0xff);
+	pData[size++] = (char)(PE_UDP_PROTOCOL_ID & 0xff);
+	pData[size++] = (char)(type);
+	size += StreamManager::WriteInt32((PrimitiveTypes::Int32)(sequence), &pData[size]);
+	size += StreamManager::WriteInt32((PrimitiveTypes::Int32)(m_udpRemoteSequence), &pData[size]);
+	size += StreamManager::WriteInt32((PrimitiveTypes::Int32)(m_udpRemoteAckBits), &pData[size]);
+	PEASSERT(size == PE_UDP_HEADER_SIZE, "Wrong udp header size");
+
+	// every datagram carries acks
+	m_udpAckPending = false;
+	m_udpLastSendTime = m_udpNow;
+
+	return size;
+}
+
+void ConnectionManager::sendDatagram(const char *pData, int size)
+{
+	if (m_udpSimLossPercent || m_udpSimLatency > 0 || m_udpSimJitter > 0)
+	{
+		m_udpSimRandom = m_udpSimRandom * 1103515245 + 12345;
+		if ((int)((m_udpSimRandom >> 16) % 100) < m_udpSimLossPercent)
+			return; // dropped
+
+		m_udpSimRandom = m_udpSimRandom * 1103515245 + 12345;
+		float jitter = m_udpSimJitter * (float)((m_udpSimRandom >> 16) & 0x7fff) / 32767.0f;
+
+		m_udpDelayedDatagrams.push_back(UdpDelayedDatagram());
+		UdpDelayedDatagram &delayed = m_udpDelayedDatagrams.back();
+		delayed.m_releaseTime = m_udpNow + m_udpSimLatency + jitter;
+		delayed.m_size = size;
+		memcpy(delayed.m_data, pData, size);
+		return;
+	}
+
+	t_timeout timeout;
+	timeout.block = 0;
+	timeout.total = -1.0;
+	timeout.start = 0;
+
+	m_numBytesSent += size;
+
+	// errors are ignored: datagram is lost and will be detected as such by acks
+	size_t sent;
+	if (m_udpOwnsSocket)
+		socket_send(&m_sock, pData, size, &sent, &timeout);
+	else
+		socket_sendto(&m_sock, pData, size, &sent, (SA *)(&m_udpPeerAddr), sizeof(m_udpPeerAddr), &timeout);
+}
+
+void ConnectionManager::sendConnectRequest()
+{
+	char datagram[PE_UDP_HEADER_SIZE];
+	int size = WriteUdpControlDatagram(datagram, UdpDatagram_Connect, m_udpConnectCookie);
+	m_udpLastSendTime = m_udpNow;
+	sendDatagram(datagram, size);
+}
+
+void ConnectionManager::setUdpConditions(int lossPercent, float latency, float jitter)
+{
+	m_udpSimLossPercent = lossPercent;
+	m_udpSimLatency = latency;
+	m_udpSimJitter = jitter;
+}
+
+void ConnectionManager::receiveDatagram(char *pData, int size)
+{
+	if (m_state == ConnectionManagerState_Disconnected || !IsUdpDatagram(pData, size))
+		return;
+
+	int read = 2; // protocol id
+	int type = (unsigned char)(pData[read++]);
+	PrimitiveTypes::Int32 sequence, ack, ackBits;
+	read += StreamManager::ReadInt32(&pData[read], sequence);
+	read += StreamManager::ReadInt32(&pData[read], ack);
+	read += StreamManager::ReadInt32(&pData[read], ackBits);
+
+	if (m_state == ConnectionManagerState_Connecting && type == UdpDatagram_Challenge)
+	{
+		// server creates connection only for request that has cookie of our address
+		m_udpConnectCookie = (PrimitiveTypes::UInt32)(sequence);
+		sendConnectRequest();
+		return;
+	}
+
+	// datagram is checked whole before any of it is used. a packet that is not passed to stream manager
+	// must not be acked, or sender would never resend guaranteed events of it
+	bool isPacket = (type & ~UdpDatagram_AcksValid) == UdpDatagram_Packet;
+	int packetSize = size - read;
+	if (isPacket)
+	{
+		PrimitiveTypes::Int32 packetSizeInHeader = 0;
+		if (packetSize >= PE_PACKET_HEADER)
+			StreamManager::ReadInt32(&pData[read], packetSizeInHeader);
+		if (packetSize < PE_PACKET_HEADER || packetSizeInHeader != packetSize)
+		{
+			PEINFO("PE: Warning: Received malformed udp packet (%d bytes, header says %d)\n", packetSize, packetSizeInHeader);
+			return;
+		}
+	}
+	else if ((type & ~UdpDatagram_AcksValid) != UdpDatagram_Ack)
+		return; // unknown type, or connect/challenge that is not expected in this state
+
+	// anything else from server means it created our connection
+	if (m_state == ConnectionManagerState_Connecting)
+		m_state = ConnectionManagerState_Connected;
+
+	m_udpLastReceiveTime = m_udpNow;
+	m_numBytesReceived += size;
+
+	// acks of our packets
+	if (type & UdpDatagram_AcksValid)
+	{
+		PrimitiveTypes::UInt32 uack = (PrimitiveTypes::UInt32)(ack);
+		if (!m_udpReceivedAnyAck || sequenceGreaterThan(uack, m_udpNewestAcked))
+			m_udpNewestAcked = uack;
+		m_udpReceivedAnyAck = true;
+
+		for (unsigned int i = 0; i < m_udpSentPackets.size(); ++i)
+		{
+			UdpSentPacket &sent = m_udpSentPackets[i];
+			if (sent.m_acked)
+				continue;
+
+			PrimitiveTypes::Int32 d = (PrimitiveTypes::Int32)(uack - sent.m_sequence);
+			if (d == 0 || (d > 0 && d <= 32 && ((PrimitiveTypes::UInt32)(ackBits) & (1u << (d - 1)))))
+			{
+				sent.m_acked = true;
+				m_udpRtt = m_udpRtt * 0.9 + (m_udpNow - sent.m_sendTime) * 0.1;
+			}
+		}
+	}
+
+	if (!isPacket)
+		return;
+
+	// sequence of received packets
+	PrimitiveTypes::UInt32 useq = (PrimitiveTypes::UInt32)(sequence);
+	if (!m_udpReceivedAnyPacket)
+	{
+		m_udpRemoteSequence = useq;
+		m_udpRemoteAckBits = 0;
+		m_udpReceivedAnyPacket = true;
+	}
+	else if (sequenceGreaterThan(useq, m_udpRemoteSequence))
+	{
+		PrimitiveTypes::UInt32 shift = useq - m_udpRemoteSequence;
+		if (shift < 32)
+			m_udpRemoteAckBits = (m_udpRemoteAckBits << shift) | (1u << (shift - 1));
+		else if (shift == 32)
+			m_udpRemoteAckBits = 1u << 31;
+		else
+			m_udpRemoteAckBits = 0;
+		m_udpRemoteSequence = useq;
+	}
+	else
+	{
+		PrimitiveTypes::UInt32 d = m_udpRemoteSequence - useq;
+		if (d == 0 || d > 32 || (m_udpRemoteAckBits & (1u << (d - 1))))
+		{
+			// duplicate, or too old to be acked (sender considers it lost and resends what matters)
+			m_udpNumDuplicatesReceived++;
+			return;
+		}
+		m_udpRemoteAckBits |= 1u << (d - 1);
+	}
+	m_udpAckPending = true;
+
+	// packets can come out of order, event manager orders guaranteed events and ghost manager keeps newest state
+	PE::Packet *pPacket = (PE::Packet *)(pemalloc(m_arena, packetSize));
+	memcpy(&pPacket->m_data[0], &pData[read], packetSize);
+
+	m_pNetContext->getStreamManager()->receivePacket(pPacket);
+
+	pefree(m_arena, pPacket);
+}
+
+void ConnectionManager::updateUdp()
+{
+	if (m_state == ConnectionManagerState_Disconnected)
+		return;
+
+	// simulated latency
+	if (m_udpDelayedDatagrams.size())
+	{
+		int simLossPercent = m_udpSimLossPercent;
+		float simLatency = m_udpSimLatency, simJitter = m_udpSimJitter;
+		m_udpSimLossPercent = 0; m_udpSimLatency = 0; m_udpSimJitter = 0; // send for real
+
+		for (unsigned int i = 0; i < m_udpDelayedDatagrams.size();)
+		{
+			if (m_udpDelayedDatagrams[i].m_releaseTime <= m_udpNow)
+			{
+				sendDatagram(m_udpDelayedDatagrams[i].m_data, m_udpDelayedDatagrams[i].m_size);
+				m_udpDelayedDatagrams.erase(m_udpDelayedDatagrams.begin() + i);
+			}
+			else
+				++i;
+		}
+
+		m_udpSimLossPercent = simLossPercent; m_udpSimLatency = simLatency; m_udpSimJitter = simJitter;
+	}
+
+	// requests or challenges may be lost, repeated until server answers or connection times out
+	if (m_state == ConnectionManagerState_Connecting && m_udpNow - m_udpLastSendTime >= PE_UDP_KEEPALIVE_INTERVAL)
+		sendConnectRequest();
+
+	// notify in send order. stop at first packet that is neither acked nor lost yet
+	double lossTimeout = m_udpRtt * 2.0 + PE_UDP_LOSS_TIMEOUT_MARGIN;
+	while (m_udpSentPackets.size())
+	{
+		UdpSentPacket &sent = m_udpSentPackets.front();
+		if (!sent.m_acked)
+		{
+			bool newerAcked = m_udpReceivedAnyAck && (PrimitiveTypes::Int32)(m_udpNewestAcked - sent.m_sequence) >= PE_UDP_NACK_THRESHOLD;
+			bool timedOut = m_udpNow - sent.m_sendTime > lossTimeout;
+			if (!newerAcked && !timedOut)
+				break;
+
+			m_udpNumPacketsLost++;
+		}
+
+		bool delivered = sent.m_acked;
+		m_udpSentPackets.pop_front();
+		m_pNetContext->getStreamManager()->processNotification(delivered);
+	}
+
+	if (m_udpNow - m_udpLastReceiveTime > PE_UDP_CONNECTION_TIMEOUT)
+	{
+		PEINFO("PE: Warning: Nothing received for %.1f seconds. Will disconnect.\n", (float)(m_udpNow - m_udpLastReceiveTime));
+		disconnect();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+//////////////////////////////////////////////////////////////////////////
+
+// receives benchmark events. registered with network manager only during benchmark
+struct UdpBenchmarkTarget : public Component, public Networkable
+{
+	UdpBenchmarkTarget(PE::GameContext &context, PE::MemoryArena arena, Networkable::NetworkId networkId)
+	: Component(context, arena, Handle())
+	, Networkable(context, this, networkId)
+	, m_pReceiveTimes(NULL)
+	, m_pNow(NULL)
+	, m_numReceived(0)
+	, m_numOutOfOrder(0)
+	, m_lastReceived(-1)
+	{}
+
+	virtual PE::MetaInfo *net_getClassMetaInfo() {return &Component::s_metaInfo;}
+
+	virtual void handleEvent(Events::Event *pEvt)
+	{
+		// index of event is sent in client id field
+		int index = ((Event_SERVER_CLIENT_CONNECTION_ACK *)(pEvt))->m_clientId;
+		if (index != m_lastReceived + 1)
+			m_numOutOfOrder++;
+		m_lastReceived = index;
+
+		if ((*m_pReceiveTimes)[index] < 0)
+			m_numReceived++;
+		(*m_pReceiveTimes)[index] = *m_pNow;
+	}
+
+	std::vector<double> *m_pReceiveTimes;
+	double *m_pNow;
+	int m_numReceived;
+	int m_numOutOfOrder;
+	int m_lastReceived;
+};
+
+void ConnectionManager::RunUdpLoopbackBenchmark(PE::GameContext &context, PE::MemoryArena arena, int numFrames, int lossPercent, float latency, float jitter, BenchmarkResult *pResult)
+{
+	const double frameTime = 1.0 / 60.0;
+	const int maxSettleFrames = 60 * 30;
+	const Networkable::NetworkId targetNetworkId = 0x7ffffff0;
+
+	NetworkManager *pNetworkManager = context.getNetworkManager();
+	if (!pNetworkManager || pNetworkManager->m_networkables.find(targetNetworkId) != pNetworkManager->m_networkables.end())
+	{
+		PEINFO("PE: Udp benchmark: needs network manager and free network id\n");
+		return;
+	}
+
+	// two localhost sockets connected to each other
+	t_socket socks[2];
+	unsigned short ports[2];
+	for (int i = 0; i < 2; ++i)
+	{
+		const char *err = inet_trycreate(&socks[i], SOCK_DGRAM);
+		if (!err)
+			err = inet_trybind(&socks[i], "127.0.0.1", 0);
+		if (err)
+		{
+			PEINFO("PE: Udp benchmark: could not open socket: %s\n", err);
+			if (i)
+				socket_destroy(&socks[0]);
+			return;
+		}
+		struct sockaddr_in addr;
+		socklen_t addrLen = sizeof(addr);
+		getsockname(socks[i], (SA *)(&addr), &addrLen);
+		ports[i] = ntohs(addr.sin_port);
+	}
+
+	t_timeout timeout;
+	timeout.block = 0;
+	timeout.total = -1.0;
+	timeout.start = 0;
+	inet_tryconnect(&socks[0], "127.0.0.1", ports[1], &timeout);
+	inet_tryconnect(&socks[1], "127.0.0.1", ports[0], &timeout);
+
+	// sender (0) and receiver (1) stacks
+	NetworkContext contexts[2];
+	for (int i = 0; i < 2; ++i)
+	{
+		contexts[i].m_clientId = i ? -1 : 0;
+		contexts[i].m_pConnectionManager = new (arena) ConnectionManager(context, arena, contexts[i], Handle());
+		contexts[i].m_pStreamManager = new (arena) StreamManager(context, arena, contexts[i], Handle());
+		contexts[i].m_pEventManager = new (arena) EventManager(context, arena, contexts[i], Handle());
+		contexts[i].m_pGhostManager = new (arena) GhostManager(context, arena, contexts[i], Handle());
+
+		contexts[i].getConnectionManager()->initializeConnectedUdp(socks[i], NULL);
+		contexts[i].getConnectionManager()->setUdpConditions(lossPercent, latency, jitter);
+		contexts[i].getConnectionManager()->m_udpNow = 0; // simulated time
+		contexts[i].getConnectionManager()->m_udpLastReceiveTime = 0;
+	}
+
+	std::vector<double> sendTimes(numFrames, 0);
+	std::vector<double> receiveTimes(numFrames, -1.0);
+	double now = 0;
+
+	UdpBenchmarkTarget target(context, arena, targetNetworkId);
+	target.m_pReceiveTimes = &receiveTimes;
+	target.m_pNow = &now;
+	pNetworkManager->m_networkables[targetNetworkId] = &target;
+
+	Timer timer;
+	int frame = 0;
+	for (; frame < numFrames + maxSettleFrames; ++frame)
+	{
+		now = frame * frameTime;
+		Timer frameTimer;
+
+		if (frame < numFrames)
+		{
+			Event_SERVER_CLIENT_CONNECTION_ACK evt(context);
+			evt.m_clientId = frame;
+			sendTimes[frame] = now;
+			contexts[0].getEventManager()->scheduleEvent(&evt, &target, true);
+		}
+		else if (target.m_numReceived == numFrames)
+			break;
+
+		// same order as Event_UPDATE: connection manager, then stream manager
+		for (int i = 0; i < 2; ++i)
+		{
+			ConnectionManager *pConnectionManager = contexts[i].getConnectionManager();
+			pConnectionManager->m_udpNow = now;
+			pConnectionManager->receivePackets();
+			pConnectionManager->updateUdp();
+			contexts[i].getStreamManager()->sendNextPackets();
+			pConnectionManager->flushSendQueue();
+		}
+
+		if (pResult)
+		{
+			pResult->addTiming("transport", frameTimer.TickAndGetTimeDeltaInSeconds());
+			pResult->sampleMemory();
+		}
+	}
+
+	if (pResult)
+		pResult->m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	pNetworkManager->m_networkables.erase(targetNetworkId);
+
+	std::vector<double> latencies;
+	for (int i = 0; i < numFrames; ++i)
+		if (receiveTimes[i] >= 0)
+			latencies.push_back(receiveTimes[i] - sendTimes[i]);
+	std::sort(latencies.begin(), latencies.end());
+
+	ConnectionManager *pSender = contexts[0].getConnectionManager();
+	EventManager *pSenderEvents = contexts[0].getEventManager();
+
+	// malformed packet with newest sequence: dropped without being acked
+	ConnectionManager *pReceiver = contexts[1].getConnectionManager();
+	PrimitiveTypes::UInt32 remoteSequence = pReceiver->m_udpRemoteSequence;
+	char corrupt[PE_UDP_HEADER_SIZE + PE_PACKET_HEADER + 4];
+	int corruptSize = pSender->writeUdpHeader(corrupt, UdpDatagram_Packet, pSender->m_udpLocalSequence + 1);
+	corruptSize += StreamManager::WriteInt32(1000, &corrupt[corruptSize]); // size in packet header doesn't match
+	corruptSize += StreamManager::WriteInt32(0, &corrupt[corruptSize]);
+	pReceiver->receiveDatagram(corrupt, corruptSize);
+	bool corruptNotAcked = pReceiver->m_udpRemoteSequence == remoteSequence;
+
+	PEINFO("PE: Udp loopback benchmark: %d events, %d%% loss, %.0f ms latency, %.0f ms jitter (both directions, %.1f ms frames)\n",
+		numFrames, lossPercent, latency * 1000.0f, jitter * 1000.0f, (float)(frameTime * 1000.0));
+	if (latencies.size())
+	{
+		int n = (int)(latencies.size());
+		PEINFO("PE:   event delivery latency: p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.1f ms\n",
+			(float)(latencies[n / 2] * 1000.0), (float)(latencies[n * 9 / 10] * 1000.0),
+			(float)(latencies[n * 99 / 100] * 1000.0), (float)(latencies[n - 1] * 1000.0));
+	}
+	PEINFO("PE:   delivered %d of %d events (%d out of order), %d resent, %d duplicates discarded\n",
+		target.m_numReceived, numFrames, target.m_numOutOfOrder, pSenderEvents->m_numEventsResent,
+		contexts[1].getEventManager()->m_numDuplicateEventsReceived);
+	PEINFO("PE:   sender: %d packets, %d lost, rtt %.1f ms\n", pSender->m_udpNumPacketsSent, pSender->m_udpNumPacketsLost, (float)(pSender->m_udpRtt * 1000.0));
+	PEINFO("PE:   malformed packet acked: %s\n", corruptNotAcked ? "no" : "yes");
+	PEASSERT(target.m_numReceived == numFrames && target.m_numOutOfOrder == 0, "Guaranteed events were lost or reordered");
+
+	if (pResult)
+	{
+		pResult->m_ok = target.m_numReceived == numFrames && target.m_numOutOfOrder == 0 && corruptNotAcked;
+		pResult->m_numFrames = frame;
+		if (latencies.size())
+		{
+			int n = (int)(latencies.size());
+			pResult->setCounter("latencyP50Ms", latencies[n / 2] * 1000.0);
+			pResult->setCounter("latencyP99Ms", latencies[n * 99 / 100] * 1000.0);
+			pResult->setCounter("latencyMaxMs", latencies[n - 1] * 1000.0);
+		}
+		pResult->setCounter("delivered", target.m_numReceived);
+		pResult->setCounter("resent", pSenderEvents->m_numEventsResent);
+		pResult->setCounter("packetsSent", pSender->m_udpNumPacketsSent);
+		pResult->setCounter("packetsLost", pSender->m_udpNumPacketsLost);
+	}
+
+	for (int i = 0; i < 2; ++i)
+	{
+		contexts[i].getConnectionManager()->disconnect();
+		delete contexts[i].getConnectionManager();
+		delete contexts[i].getStreamManager();
+		delete contexts[i].getEventManager();
+		delete contexts[i].getGhostManager();
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // ConnectionManager Lua Interface
 //////////////////////////////////////////////////////////////////////////
 //
 void ConnectionManager::SetLuaFunctions(PE::Components::LuaEnvironment *pLuaEnv, lua_State *luaVM)
 {
-	/*
 	static const struct luaL_Reg l_functions[] = {
-		{"l_clientConnectToTCPServer", l_clientConnectToTCPServer},
+		{"l_runUdpLoopbackBenchmark", l_runUdpLoopbackBenchmark},
 		{NULL, NULL} // sentinel
 	};
 
 	luaL_register(luaVM, 0, l_functions);
-	*/
-
-	lua_register(luaVM, "l_clientConnectToTCPServer", l_clientConnectToTCPServer);
-
-
-	// run a script to add additional functionality to Lua side of Skin
-	// that is accessible from Lua
-// #if APIABSTRACTION_IOS
-// 	LuaEnvironment::Instance()->runScriptWorkspacePath("Code/PrimeEngine/Scene/Skin.lua");
-// #else
-// 	LuaEnvironment::Instance()->runScriptWorkspacePath("Code\\PrimeEngine\\Scene\\Skin.lua");
-// #endif
-
 }
 
-int ConnectionManager::l_clientConnectToTCPServer(lua_State *luaVM)
+// root.PE.Components.ConnectionManager.l_runUdpLoopbackBenchmark(l_getGameContext(), 600, 10, 50, 10)
+// frames, loss percent, latency ms, jitter ms
+int ConnectionManager::l_runUdpLoopbackBenchmark(lua_State *luaVM)
 {
-	lua_Number lPort = lua_tonumber(luaVM, -1);
-	int port = (int)(lPort);
-
-	const char *strAddr = lua_tostring(luaVM, -2);
+	float jitter = (float)(lua_tonumber(luaVM, -1)) / 1000.0f;
+	float latency = (float)(lua_tonumber(luaVM, -2)) / 1000.0f;
+	int lossPercent = (int)(lua_tonumber(luaVM, -3));
+	int numFrames = (int)(lua_tonumber(luaVM, -4));
 
-	GameContext *pContext = (GameContext *)(lua_touserdata(luaVM, -3));
+	GameContext *pContext = (GameContext *)(lua_touserdata(luaVM, -5));
 
-	lua_pop(luaVM, 3);
+	lua_pop(luaVM, 5);
 
-	pContext->getConnectionManager()->clientConnectToTCPServer(strAddr, port);
+	RunUdpLoopbackBenchmark(*pContext, pContext->getDefaultMemoryArena(), numFrames, lossPercent, latency, jitter);
 
 	return 0; // no return values
 }
-#endif
 //////////////////////////////////////////////////////////////////////////
 
 	
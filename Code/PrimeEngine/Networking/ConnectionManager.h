@@ -7,6 +7,7 @@
 // Outer-Engine includes
 #include <assert.h>
 #include <vector>
+#include <deque>
 
 // Inter-Engine includes
 
@@ -23,7 +24,20 @@ extern "C"
 #include "PrimeEngine/Networking/NetworkContext.h"
 #include "Packet.h"
 
+// udp datagram: protocol id (2), type (1), sequence (4), ack (4), ack bits (4), then packet
+#define PE_UDP_PROTOCOL_ID 0x5045
+#define PE_UDP_HEADER_SIZE 15
+#define PE_UDP_MAX_DATAGRAM_SIZE 1200 // below ethernet MTU so that datagrams are not fragmented
+#define PE_UDP_MAX_PACKET_SIZE (PE_UDP_MAX_DATAGRAM_SIZE - PE_UDP_HEADER_SIZE)
+
+// packet is considered lost if a packet sent this many packets later is acked, or after
+// 2 * rtt + PE_UDP_LOSS_TIMEOUT_MARGIN seconds without ack
+#define PE_UDP_NACK_THRESHOLD 3
+#define PE_UDP_LOSS_TIMEOUT_MARGIN 0.05
+
 namespace PE {
+struct SocketPoller;
+struct BenchmarkResult;
 namespace Components {
 
 struct ConnectionManager : public Component
@@ -35,25 +49,103 @@ struct ConnectionManager : public Component
 
 	virtual ~ConnectionManager();
 
-	// note: there is no connecting state. connecting is done by network mananger
+	// note: tcp connecting is done by network mananger. only udp client of server is connecting until server answers
 	// once this connection manager disconnects, it never reconnects on its own
 
 	enum EConnectionManagerState
 	{
 		ConnectionManagerState_Disconnected = 0,
 		ConnectionManagerState_Connected,
+		ConnectionManagerState_Connecting, // udp: sending connect requests, nothing else is sent
 		ConnectionManagerState_Count
 	};
 
+	// tcp: reliable stream, every packet is delivered, in order.
+	// udp: packets have sequence numbers and every datagram acks last 33 received packets.
+	// stream manager is notified of delivered/lost packets in send order and event manager resends only guaranteed events
+	enum ETransport
+	{
+		Transport_TCP = 0,
+		Transport_UDP,
+		Transport_Count
+	};
+
+	enum EUdpDatagramType
+	{
+		UdpDatagram_Packet = 1, // has sequence number and stream manager packet
+		UdpDatagram_Ack = 2, // only acks and keeps connection alive
+		UdpDatagram_Connect = 3, // client asks server for connection. sequence field is cookie of last challenge (0 at first)
+		UdpDatagram_Challenge = 4, // server answer to connect with wrong cookie. sequence field is cookie of client address
+		UdpDatagram_AcksValid = 0x80 // flag: ack fields are valid (something was received)
+	};
+
 	// Methods -----------------------------------------------------------------
 	virtual void initializeConnected(t_socket sock);
 
+	// udp. if pPeerAddr is NULL, sock is connected to peer and is owned by this connection manager.
+	// otherwise sock is shared by server for all udp connections and datagrams are sent to pPeerAddr
+	void initializeConnectedUdp(t_socket sock, const struct sockaddr_in *pPeerAddr);
+
+	// udp client of server: sock is connected to server and owned by this connection manager. sends connect requests
+	// and answers challenge of server until server sends anything else, then is connected
+	void initializeConnectingUdp(t_socket sock);
+
+	ETransport getTransport() const {return m_transport;}
+
+	// max size of packet that stream manager fills in
+	int getMaxPacketSize() const {return m_transport == Transport_UDP ? PE_UDP_MAX_PACKET_SIZE : PE_PACKET_TOTAL_SIZE;}
+
+	// tcp: queues copy of packet. queue is sent by flushSendQueue()
+	// udp: sends datagram right away
 	void sendPacket(Packet *pPacket, TransmissionRecord *pTransmissionRecord);
-	
+
+	// sends as much of queued packets as socket accepts with one gather write per PE_SOCKET_MAX_GATHER_BUFFERS packets
+	// called by stream manager after filling packets and by network manager when poller reports socket writable
+	// udp: sends ack datagram if received packets were not acked by a packet this update, or as keep alive
+	void flushSendQueue();
+
+	// reads everything available into m_buffer and passes complete packets to stream manager
 	void receivePackets();
+
+	// once set, network manager receives data and flushes sends when poller reports socket ready,
+	// so this connection manager doesn't poll its socket every update
+	void setPoller(SocketPoller *pPoller) {m_pPoller = pPoller;}
+
+	// udp: processes one datagram received from peer. called by receivePackets() or by
+	// server network manager for datagrams received on shared socket
+	void receiveDatagram(char *pData, int size);
+
+	// udp: notifies stream manager of delivered and lost packets in send order, sends delayed datagrams
+	// and disconnects if peer is silent. uses m_udpNow
+	void updateUdp();
+
+	// udp: simulates bad network for datagrams sent by this connection manager
+	void setUdpConditions(int lossPercent, float latency, float jitter);
+
+	static bool IsUdpDatagram(const char *pData, int size);
+
+	// connect and challenge datagrams have no acks, value is in sequence field. returns PE_UDP_HEADER_SIZE
+	static int WriteUdpControlDatagram(char *pData, int type, PrimitiveTypes::UInt32 value);
+
+	// type of datagram without UdpDatagram_AcksValid flag and value of sequence field. 0 if not a datagram
+	static int ReadUdpControlDatagram(const char *pData, int size, PrimitiveTypes::UInt32 &out_value);
+
+	// writes header with current acks into pData, returns PE_UDP_HEADER_SIZE
+	int writeUdpHeader(char *pData, int type, PrimitiveTypes::UInt32 sequence);
+
+	// sends datagram to peer, or delays/drops it if network conditions are simulated
+	void sendDatagram(const char *pData, int size);
+
+	// while connecting
+	void sendConnectRequest();
+
 	bool connected() const {return m_state == ConnectionManagerState_Connected;}
+	bool connecting() const {return m_state == ConnectionManagerState_Connecting;}
 	void disconnect();
 
+	// back to state of new connection manager (disconnected, tcp, no stats). server reuses managers of dead connections
+	void reset();
+
 	// Component ------------------------------------------------------------
 	virtual void addDefaultComponents();
 
@@ -63,17 +155,22 @@ struct ConnectionManager : public Component
 
 	// Loading -----------------------------------------------------------------
 
-#if 0 // template
+	// Benchmark -----------------------------------------------------------------
+
+	// connects two udp connection managers over localhost with simulated loss and latency in both directions,
+	// sends one guaranteed event per frame and reports event delivery latency percentiles. optionally records into pResult
+	static void RunUdpLoopbackBenchmark(PE::GameContext &context, PE::MemoryArena arena, int numFrames, int lossPercent, float latency, float jitter, BenchmarkResult *pResult = NULL);
+
 	//////////////////////////////////////////////////////////////////////////
-	// Skin Lua Interface
+	// ConnectionManager Lua Interface
 	//////////////////////////////////////////////////////////////////////////
 	//
 	static void SetLuaFunctions(PE::Components::LuaEnvironment *pLuaEnv, lua_State *luaVM);
 	//
-	static int l_clientConnectToTCPServer(lua_State *luaVM);
+	static int l_runUdpLoopbackBenchmark(lua_State *luaVM);
 	//
 	//////////////////////////////////////////////////////////////////////////
-#endif
+
 	//////////////////////////////////////////////////////////////////////////
 	// Member variables 
 	//////////////////////////////////////////////////////////////////////////
@@ -94,6 +191,64 @@ struct ConnectionManager : public Component
 	int m_bytesBuffered;
 	char m_buffer[PE_SOCKET_RECEIVE_BUFFER_SIZE];
 
+	std::vector<Packet *> m_sendQueue; // packets allocated with packet size, not PE_PACKET_TOTAL_SIZE
+	int m_sendQueueOffset; // bytes of first queued packet already sent
+	int m_sendQueueBytes; // not sent yet
+
+	SocketPoller *m_pPoller;
+
+	// stats. tcp: packet bytes, udp: datagram bytes including header
+	PrimitiveTypes::UInt32 m_numBytesSent;
+	PrimitiveTypes::UInt32 m_numBytesReceived;
+
+	ETransport m_transport;
+
+	// udp
+	struct UdpSentPacket
+	{
+		PrimitiveTypes::UInt32 m_sequence;
+		double m_sendTime;
+		bool m_acked;
+	};
+	std::deque<UdpSentPacket> m_udpSentPackets; // not notified yet, in send order (same as stream manager's transmission records)
+
+	struct UdpDelayedDatagram
+	{
+		double m_releaseTime;
+		int m_size;
+		char m_data[PE_UDP_MAX_DATAGRAM_SIZE];
+	};
+	std::vector<UdpDelayedDatagram> m_udpDelayedDatagrams; // simulated latency
+
+	bool m_udpOwnsSocket;
+	struct sockaddr_in m_udpPeerAddr; // if socket is shared
+
+	PrimitiveTypes::UInt32 m_udpLocalSequence; // of next packet sent
+	PrimitiveTypes::UInt32 m_udpRemoteSequence; // newest packet received
+	PrimitiveTypes::UInt32 m_udpRemoteAckBits; // bit i: packet m_udpRemoteSequence - 1 - i was received
+	bool m_udpReceivedAnyPacket;
+	bool m_udpAckPending; // received packets since last datagram was sent
+
+	PrimitiveTypes::UInt32 m_udpNewestAcked; // newest of our packets peer acked
+	bool m_udpReceivedAnyAck;
+
+	double m_udpNow; // seconds. set every update, or by benchmark
+	double m_udpLastSendTime;
+	double m_udpLastReceiveTime;
+	double m_udpRtt; // smoothed round trip time
+
+	PrimitiveTypes::UInt32 m_udpConnectCookie; // from challenge of server, sent back in connect requests
+
+	int m_udpSimLossPercent;
+	float m_udpSimLatency;
+	float m_udpSimJitter;
+	PrimitiveTypes::UInt32 m_udpSimRandom;
+
+	// stats
+	PrimitiveTypes::UInt32 m_udpNumPacketsSent;
+	PrimitiveTypes::UInt32 m_udpNumPacketsLost; // notified as lost
+	PrimitiveTypes::UInt32 m_udpNumDuplicatesReceived;
+
 };
 }; // namespace Components
 }; // namespace PE
@@ -37,13 +37,19 @@ EventManager::EventManager(PE::GameContext &context, PE::MemoryArena arena, PE::
 : Component(context, arena, hMyself)
 , m_transmitterNextEvtOrderId(1) // start at 1 since id = 0 is not ordered
 , m_transmitterNumEventsNotAcked(0)
+, m_transmitterFirstNotDeliveredOrderId(1)
+, m_numEventsResent(0)
+, m_numEventsScheduled(0)
+, m_eventBytesScheduled(0)
 
 // receiver
 , m_receiverFirstEvtOrderId(1) // start at 1 since id = 0 is not ordered
+, m_numDuplicateEventsReceived(0)
 {
 	m_pNetContext = &netContext;
 
 	memset(&m_receivedEvents[0], 0, sizeof(m_receivedEvents));
+	memset(&m_transmitterDelivered[0], 0, sizeof(m_transmitterDelivered));
 }
 
 EventManager::~EventManager()
@@ -84,7 +90,7 @@ void EventManager::scheduleEvent(PE::Networkable *pNetworkableEvent, PE::Network
 
 
 	//write ordering id (0 = not guaranteed)
-	dataSize += StreamManager::WriteInt32(back.m_orderId, &back.m_payload[dataSize]);
+	dataSize += StreamManager::WriteVarUInt32(back.m_orderId, &back.m_payload[dataSize]);
 	
 	//target
 	dataSize += StreamManager::WriteNetworkId(pNetworkableTarget->m_networkId, &back.m_payload[dataSize]);
@@ -96,17 +102,27 @@ void EventManager::scheduleEvent(PE::Networkable *pNetworkableEvent, PE::Network
 		assert(!"Event's class id is -1, need to add it to global registry");
 	}
 
-	dataSize += StreamManager::WriteInt32(classId, &back.m_payload[dataSize]);
+	dataSize += StreamManager::WriteVarUInt32(classId, &back.m_payload[dataSize]);
 	
 	dataSize += pNetworkableEvent->packCreationData(&back.m_payload[dataSize]);
 	
 	back.m_size = dataSize;
+
+	m_numEventsScheduled++;
+	m_eventBytesScheduled += dataSize;
 	
 }
 
 int EventManager::haveEventsToSend()
 {
-	return m_eventsToSend.size() > 0;
+	int num = 0;
+	for (unsigned int i = 0; i < m_eventsToSend.size(); ++i, ++num)
+	{
+		EventTransmissionData &evt = m_eventsToSend[i];
+		if (evt.m_isGuaranteed && evt.m_orderId >= m_transmitterFirstNotDeliveredOrderId + PE_EVENT_SLIDING_WINDOW)
+			break; // receiver has no room for it until older events are delivered
+	}
+	return num;
 }
 
 int EventManager::fillInNextPacket(char *pDataStream, TransmissionRecord *pRecord, int packetSizeAllocated, bool &out_usefulDataSent, bool &out_wantToSendMore)
@@ -119,8 +135,12 @@ int EventManager::fillInNextPacket(char *pDataStream, TransmissionRecord *pRecor
 
 	int eventsReallySent = 0;
 
+	// number of events is one byte since we never have more than PE_MAX_EVENT_JAM
+	PEASSERT(PE_MAX_EVENT_JAM < 128, "Event count has to fit in one byte varint");
+	if (eventsToSend > PE_MAX_EVENT_JAM)
+		eventsToSend = PE_MAX_EVENT_JAM;
 	int size = 0;
-	size += StreamManager::WriteInt32(eventsToSend, &pDataStream[size]);
+	size += StreamManager::WriteVarUInt32(eventsToSend, &pDataStream[size]);
 
 	int sizeLeft = packetSizeAllocated - size;
 
@@ -161,7 +181,7 @@ int EventManager::fillInNextPacket(char *pDataStream, TransmissionRecord *pRecor
 	}
 	
 	//write real value into the beginning of event chunk
-	StreamManager::WriteInt32(eventsReallySent, &pDataStream[0 /* the number of events is stored in the beginning and we already wrote value into here*/]);
+	StreamManager::WriteVarUInt32(eventsReallySent, &pDataStream[0 /* the number of events is stored in the beginning and we already wrote value into here*/]);
 	
 	// we are sending useful data only if we are sending events
 	out_usefulDataSent = eventsReallySent > 0;
@@ -171,7 +191,8 @@ int EventManager::fillInNextPacket(char *pDataStream, TransmissionRecord *pRecor
 
 void EventManager::processNotification(TransmissionRecord *pTransmittionRecord, bool delivered)
 {
-	for (unsigned int i = 0; i < pTransmittionRecord->m_sentEvents.size(); ++i)
+	// backwards so that resent events stay in the order they were sent
+	for (int i = (int)(pTransmittionRecord->m_sentEvents.size()) - 1; i >= 0; --i)
 	{
 		EventTransmissionData &evt = pTransmittionRecord->m_sentEvents[i];
 
@@ -181,13 +202,17 @@ void EventManager::processNotification(TransmissionRecord *pTransmittionRecord,
 			{
 				//we're good, can pop this event off front
 				m_transmitterNumEventsNotAcked--; // will advance sliding window
+
+				int indexInWindow = evt.m_orderId - m_transmitterFirstNotDeliveredOrderId;
+				PEASSERT(indexInWindow >= 0 && indexInWindow < PE_EVENT_SLIDING_WINDOW, "Delivered event %d is outside of transmitter sliding window", evt.m_orderId);
+				m_transmitterDelivered[indexInWindow] = true;
 			}
 			else
 			{
-				// need to readjust our sliding window and make sure we start sending events starting at at least this event
-				assert(!"Not supported for now!");
+				// packet was lost (unreliable transport). resend event before newer events. receiver orders events by order id
 				m_eventsToSend.push_front(evt);
 				m_transmitterNumEventsNotAcked--; // will advance sliding window since we need to resend this event
+				m_numEventsResent++;
 			}
 		}
 		else
@@ -197,6 +222,18 @@ void EventManager::processNotification(TransmissionRecord *pTransmittionRecord,
 			// event wasn't guaranteed, we can forget about it
 		}
 	}
+
+	// advance transmitter sliding window
+	int numDelivered = 0;
+	while (numDelivered < PE_EVENT_SLIDING_WINDOW && m_transmitterDelivered[numDelivered])
+		numDelivered++;
+
+	if (numDelivered)
+	{
+		memmove(&m_transmitterDelivered[0], &m_transmitterDelivered[numDelivered], sizeof(bool) * (PE_EVENT_SLIDING_WINDOW - numDelivered));
+		memset(&m_transmitterDelivered[PE_EVENT_SLIDING_WINDOW - numDelivered], 0, sizeof(bool) * numDelivered);
+		m_transmitterFirstNotDeliveredOrderId += numDelivered;
+	}
 }
 
 void EventManager::debugRender(int &threadOwnershipMask, float xoffset/* = 0*/, float yoffset/* = 0*/)
@@ -238,7 +275,8 @@ void EventManager::debugRender(int &threadOwnershipMask, float xoffset/* = 0*/,
 		tmpBuf, true, false, false, false, 0,
 		Vector3(xoffset + dx, yoffset + dy * 2, 0), 0.7f, threadOwnershipMask);
 
-	sprintf(PEString::s_buf, "Send next id: %d", m_transmitterNextEvtOrderId);
+	sprintf(PEString::s_buf, "Send next id: %d Avg event size: %.1f bytes Resent: %d Duplicates: %d", m_transmitterNextEvtOrderId,
+		m_numEventsScheduled ? (float)(m_eventBytesScheduled) / (float)(m_numEventsScheduled) : 0.0f, m_numEventsResent, m_numDuplicateEventsReceived);
 	DebugRenderer::Instance()->createTextMesh(
 		PEString::s_buf, true, false, false, false, 0,
 		Vector3(xoffset + dx, yoffset + dy * 3, 0), 1.0f, threadOwnershipMask);
@@ -249,14 +287,15 @@ void EventManager::debugRender(int &threadOwnershipMask, float xoffset/* = 0*/,
 int EventManager::receiveNextPacket(char *pDataStream)
 {
 	int read = 0;
-	PrimitiveTypes::Int32 numEvents;
+	PrimitiveTypes::UInt32 numEvents;
 	
-	read += StreamManager::ReadInt32(&pDataStream[read], numEvents);
+	read += StreamManager::ReadVarUInt32(&pDataStream[read], numEvents);
 
-	for (int i = 0; i < numEvents; ++i)
+	for (PrimitiveTypes::UInt32 i = 0; i < numEvents; ++i)
 	{
-		PrimitiveTypes::Int32 evtOrderId;
-		read += StreamManager::ReadInt32(&pDataStream[read], evtOrderId); // 0 means not guaranteed, > 0 means ordering id
+		PrimitiveTypes::UInt32 orderId;
+		read += StreamManager::ReadVarUInt32(&pDataStream[read], orderId); // 0 means not guaranteed, > 0 means ordering id
+		PrimitiveTypes::Int32 evtOrderId = (PrimitiveTypes::Int32)(orderId);
 		
 		Networkable::NetworkId networkId;
 		read += StreamManager::ReadNetworkId(&pDataStream[read], networkId);
@@ -282,8 +321,8 @@ int EventManager::receiveNextPacket(char *pDataStream)
 			assert(!"Network id was not registered with any object! Event will be dismissed");
 		}
 
-		PrimitiveTypes::Int32 classId;
-		read += StreamManager::ReadInt32(&pDataStream[read], classId);
+		PrimitiveTypes::UInt32 classId;
+		read += StreamManager::ReadVarUInt32(&pDataStream[read], classId);
 
 		GlobalRegistry *globalRegistry = GlobalRegistry::Instance();
 		MetaInfo *pMetaInfo = globalRegistry->getMetaInfo(classId);
@@ -313,8 +352,9 @@ int EventManager::receiveNextPacket(char *pDataStream)
 			int indexInEventsArray = evtOrderId - m_receiverFirstEvtOrderId;
 			if (indexInEventsArray < 0)
 			{
-				// received an old event, discard
-				PEASSERT(false, "Received event order id %d that precedes current sliding window currently starting at %d. We dont support this situation (old events)\n", evtOrderId, m_receiverFirstEvtOrderId);
+				// received an old event, discard. happens with unreliable transport when packet
+				// was considered lost but arrived, and event was resent
+				m_numDuplicateEventsReceived++;
 				delete pEvt;
 			}
 			else if (indexInEventsArray >= PE_EVENT_SLIDING_WINDOW)
@@ -326,8 +366,8 @@ int EventManager::receiveNextPacket(char *pDataStream)
 			}
 			else if (m_receivedEvents[indexInEventsArray].m_pEvent)
 			{
-				// this event has already been received. discard
-				PEASSERT(false, "Received event order id %d that has already been received We dont support this situation\n", evtOrderId);
+				// this event has already been received. discard (see above)
+				m_numDuplicateEventsReceived++;
 				delete pEvt;
 			}
 			else
@@ -45,6 +45,7 @@ struct EventManager : public Component
 	void scheduleEvent(PE::Networkable *pNetworkable, PE::Networkable *pNetworkableTarget, bool guaranteed);
 
 	/// called by stream manager to see how many events to send
+	/// guaranteed events are held back while receiver's sliding window has no room for them
 	int haveEventsToSend();
 
 	/// called by StreamManager to put queued up events in packet
@@ -85,9 +86,20 @@ struct EventManager : public Component
 	int m_transmitterNextEvtOrderId;
 	int m_transmitterNumEventsNotAcked; //= number of events stored in TransmissionRecords
 
+	// transmitter copy of receiver sliding window. receiver can only store events with order id in
+	// [first not delivered, first not delivered + PE_EVENT_SLIDING_WINDOW), so newer events wait in m_eventsToSend
+	int m_transmitterFirstNotDeliveredOrderId;
+	bool m_transmitterDelivered[PE_EVENT_SLIDING_WINDOW]; // [i] is set if event m_transmitterFirstNotDeliveredOrderId + i was delivered
+	PrimitiveTypes::UInt32 m_numEventsResent;
+
+	// stats: average serialized event size (header + payload)
+	PrimitiveTypes::UInt32 m_numEventsScheduled;
+	PrimitiveTypes::UInt32 m_eventBytesScheduled;
+
 
 	// receiver
 	int m_receiverFirstEvtOrderId; // evtOrderId of first element in m_receivedEvents
+	PrimitiveTypes::UInt32 m_numDuplicateEventsReceived; // resent events that were delivered already (unreliable transport)
 
 	EventReceptionData m_receivedEvents[PE_EVENT_SLIDING_WINDOW];
 
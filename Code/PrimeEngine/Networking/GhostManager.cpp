@@ -0,0 +1,621 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+#include "GhostManager.h"
+
+// Outer-Engine includes
+#include <algorithm>
+#include <math.h>
+
+// Inter-Engine includes
+
+#include "../Lua/LuaEnvironment.h"
+
+#include "../../../GlobalConfig/GlobalConfig.h"
+
+#include "PrimeEngine/Events/StandardEvents.h"
+#include "PrimeEngine/Networking/NetworkManager.h"
+
+#include "PrimeEngine/Scene/DebugRenderer.h"
+#include "PrimeEngine/Profiling/Benchmark.h"
+
+// Sibling/Children includes
+#include "StreamManager.h"
+
+using namespace PE::Events;
+
+namespace PE {
+namespace Components {
+
+PE_IMPLEMENT_CLASS1(GhostManager, Component);
+
+static PrimitiveTypes::UInt32 countBits(PrimitiveTypes::UInt32 mask)
+{
+	PrimitiveTypes::UInt32 n = 0;
+	for (; mask; mask &= mask - 1)
+		++n;
+	return n;
+}
+
+static bool ghostPriorityGreater(const GhostManager::GhostRecord *a, const GhostManager::GhostRecord *b)
+{
+	return a->m_priority > b->m_priority;
+}
+
+GhostManager::GhostManager(PE::GameContext &context, PE::MemoryArena arena, PE::NetworkContext &netContext, Handle hMyself)
+: Component(context, arena, hMyself)
+, m_applyReceivedGhosts(true)
+, m_nextUpdateId(1) // 0 means never received
+, m_numGhostUpdatesSent(0)
+, m_numWordsSent(0)
+, m_bytesSent(0)
+{
+	m_pNetContext = &netContext;
+}
+
+GhostManager::~GhostManager()
+{
+
+}
+
+void GhostManager::initialize()
+{
+
+}
+
+void GhostManager::addDefaultComponents()
+{
+	Component::addDefaultComponents();
+}
+
+void GhostManager::addGhost(PE::Networkable *pNetworkable)
+{
+	PEASSERT(pNetworkable->m_networkId != Networkable::s_NetworkId_Invalid, "Ghosted objects need network id so that receiver can find them");
+
+	GhostMap::iterator it = m_ghosts.find(pNetworkable->m_networkId);
+	if (it != m_ghosts.end())
+		return; // already ghosted
+
+	GhostRecord &g = m_ghosts[pNetworkable->m_networkId];
+	memset(&g, 0, sizeof(GhostRecord));
+	g.m_pNetworkable = pNetworkable;
+}
+
+void GhostManager::removeGhost(PE::Networkable *pNetworkable)
+{
+	GhostMap::iterator it = m_ghosts.find(pNetworkable->m_networkId);
+	if (it == m_ghosts.end())
+		return;
+
+	std::vector<GhostRecord *>::iterator q = std::find(m_sendQueue.begin(), m_sendQueue.end(), &it->second);
+	if (q != m_sendQueue.end())
+		m_sendQueue.erase(q);
+
+	// transmission records that still reference this ghost will just not find it
+	m_ghosts.erase(it);
+}
+
+void GhostManager::prepareToSend()
+{
+	m_sendQueue.clear();
+
+	char buf[PE_GHOST_MAX_STATE_WORDS * 4];
+
+	for (GhostMap::iterator it = m_ghosts.begin(); it != m_ghosts.end(); ++it)
+	{
+		GhostRecord &g = it->second;
+
+		int size = g.m_pNetworkable->packGhostState(buf);
+		PEASSERT(size <= PE_GHOST_MAX_STATE_WORDS * 4, "Ghost state of %d bytes is too big, max is %d", size, PE_GHOST_MAX_STATE_WORDS * 4);
+
+		g.m_numWords = (size + 3) / 4;
+		memset(&buf[size], 0, g.m_numWords * 4 - size);
+		memcpy(&g.m_state[0], buf, g.m_numWords * 4);
+
+		g.m_changedMask = 0;
+		for (PrimitiveTypes::UInt32 w = 0; w < g.m_numWords; ++w)
+		{
+			PrimitiveTypes::UInt32 bit = 1u << w;
+
+			if ((g.m_ackedMask & bit) && g.m_ackedState[w] == g.m_state[w])
+				continue; // client has it
+
+			if ((g.m_inFlightMask & bit) && g.m_sentState[w] == g.m_state[w])
+				continue; // on its way, will be resent if dropped
+
+			g.m_changedMask |= bit;
+		}
+
+		if (g.m_changedMask)
+		{
+			g.m_priority += g.m_pNetworkable->getGhostPriority(m_pNetContext->getClientId());
+			m_sendQueue.push_back(&g);
+		}
+	}
+
+	std::sort(m_sendQueue.begin(), m_sendQueue.end(), ghostPriorityGreater);
+}
+
+int GhostManager::haveGhostsToSend()
+{
+	int num = 0;
+	for (unsigned int i = 0; i < m_sendQueue.size(); ++i)
+		if (m_sendQueue[i]->m_changedMask)
+			++num;
+	return num;
+}
+
+int GhostManager::fillInNextPacket(char *pDataStream, TransmissionRecord *pRecord, int packetSizeAllocated, bool &out_usefulDataSent, bool &out_wantToSendMore)
+{
+	out_usefulDataSent = false;
+	// ghosts only use space that is left in packets of this update. ghosts that didn't fit keep
+	// their priority and will be first next update, so we never need extra packets for them
+	out_wantToSendMore = false;
+
+	int size = 0;
+	size += StreamManager::WriteInt32(0, &pDataStream[size]); // number of ghosts, written at the end
+
+	int headerSize = size + 4; // + update id
+	if (packetSizeAllocated < headerSize)
+		return size;
+
+	PrimitiveTypes::UInt32 updateId = m_nextUpdateId;
+	size += StreamManager::WriteInt32(updateId, &pDataStream[size]);
+
+	int ghostsReallySent = 0;
+
+	for (unsigned int i = 0; i < m_sendQueue.size(); ++i)
+	{
+		GhostRecord &g = *m_sendQueue[i];
+		if (!g.m_changedMask)
+			continue; // sent in previous packet of this update
+
+		int ghostSize = StreamManager::GetVarUInt32Size(g.m_pNetworkable->m_networkId) + StreamManager::GetVarUInt32Size(g.m_changedMask)
+			+ StreamManager::GetVarUInt32Size(g.m_numWords) + 4 * countBits(g.m_changedMask);
+		if (ghostSize > packetSizeAllocated - size)
+			continue; // doesn't fit, but lower priority smaller ones might
+
+		pRecord->m_sentGhosts.push_back(GhostTransmissionData());
+		GhostTransmissionData &sent = pRecord->m_sentGhosts.back();
+		sent.m_networkId = g.m_pNetworkable->m_networkId;
+		sent.m_updateId = updateId;
+		sent.m_mask = g.m_changedMask;
+
+		size += StreamManager::WriteNetworkId(sent.m_networkId, &pDataStream[size]);
+		size += StreamManager::WriteVarUInt32(sent.m_mask, &pDataStream[size]);
+		// so receiver knows when it has every word, words of a lost first update are only resent when its loss is reported
+		size += StreamManager::WriteVarUInt32(g.m_numWords, &pDataStream[size]);
+
+		for (PrimitiveTypes::UInt32 w = 0; w < g.m_numWords; ++w)
+		{
+			PrimitiveTypes::UInt32 bit = 1u << w;
+			if (!(g.m_changedMask & bit))
+				continue;
+
+			// state words are already in network format
+			memcpy(&pDataStream[size], &g.m_state[w], 4);
+			size += 4;
+
+			sent.m_words[w] = g.m_state[w];
+			g.m_sentState[w] = g.m_state[w];
+			g.m_sentUpdateId[w] = updateId;
+		}
+
+		g.m_inFlightMask |= g.m_changedMask;
+		m_numWordsSent += countBits(g.m_changedMask);
+		g.m_changedMask = 0;
+		g.m_priority = 0;
+
+		++ghostsReallySent;
+	}
+
+	if (!ghostsReallySent)
+	{
+		// no update id needed
+		return headerSize - 4;
+	}
+
+	StreamManager::WriteInt32(ghostsReallySent, &pDataStream[0]);
+
+	++m_nextUpdateId;
+	m_numGhostUpdatesSent += ghostsReallySent;
+	m_bytesSent += size;
+
+	out_usefulDataSent = true;
+
+	return size;
+}
+
+void GhostManager::processNotification(TransmissionRecord *pTransmittionRecord, bool delivered)
+{
+	for (unsigned int i = 0; i < pTransmittionRecord->m_sentGhosts.size(); ++i)
+	{
+		GhostTransmissionData &sent = pTransmittionRecord->m_sentGhosts[i];
+
+		GhostMap::iterator it = m_ghosts.find(sent.m_networkId);
+		if (it == m_ghosts.end())
+			continue; // ghost was removed
+
+		GhostRecord &g = it->second;
+
+		for (PrimitiveTypes::UInt32 w = 0; w < PE_GHOST_MAX_STATE_WORDS; ++w)
+		{
+			PrimitiveTypes::UInt32 bit = 1u << w;
+			if (!(sent.m_mask & bit))
+				continue;
+
+			if (delivered)
+			{
+				// notifications come in order of sending, so this is the newest value client has
+				g.m_ackedState[w] = sent.m_words[w];
+				g.m_ackedMask |= bit;
+			}
+
+			// if word was sent again later, that send is still in flight
+			if (g.m_sentUpdateId[w] == sent.m_updateId)
+				g.m_inFlightMask &= ~bit;
+		}
+	}
+}
+
+int GhostManager::receiveNextPacket(char *pDataStream)
+{
+	int read = 0;
+	PrimitiveTypes::Int32 numGhosts;
+	read += StreamManager::ReadInt32(&pDataStream[read], numGhosts);
+
+	if (!numGhosts)
+		return read;
+
+	PrimitiveTypes::Int32 updateId;
+	read += StreamManager::ReadInt32(&pDataStream[read], updateId);
+
+	for (int i = 0; i < numGhosts; ++i)
+	{
+		Networkable::NetworkId networkId;
+		read += StreamManager::ReadNetworkId(&pDataStream[read], networkId);
+
+		PrimitiveTypes::UInt32 mask;
+		read += StreamManager::ReadVarUInt32(&pDataStream[read], mask);
+
+		PrimitiveTypes::UInt32 numWords;
+		read += StreamManager::ReadVarUInt32(&pDataStream[read], numWords);
+
+		GhostReceptionMap::iterator it = m_receivedGhosts.find(networkId);
+		if (it == m_receivedGhosts.end())
+		{
+			it = m_receivedGhosts.insert(std::make_pair(networkId, GhostReceptionData())).first;
+			memset(&it->second, 0, sizeof(GhostReceptionData));
+		}
+		GhostReceptionData &r = it->second;
+		r.m_numWords = numWords < PE_GHOST_MAX_STATE_WORDS ? numWords : PE_GHOST_MAX_STATE_WORDS;
+
+		bool changed = false;
+		for (PrimitiveTypes::UInt32 w = 0; w < PE_GHOST_MAX_STATE_WORDS; ++w)
+		{
+			if (!(mask & (1u << w)))
+				continue;
+
+			if ((PrimitiveTypes::UInt32)(updateId) >= r.m_updateId[w])
+			{
+				memcpy(&r.m_state[w], &pDataStream[read], 4);
+				r.m_updateId[w] = updateId;
+				r.m_receivedMask |= 1u << w;
+				changed = true;
+			}
+			read += 4;
+		}
+
+		// words never received would be zeros: don't apply until client has all of them
+		PrimitiveTypes::UInt32 allWordsMask = r.m_numWords >= 32 ? 0xFFFFFFFFu : (1u << r.m_numWords) - 1;
+		bool complete = (r.m_receivedMask & allWordsMask) == allWordsMask;
+
+		if (changed && complete && m_applyReceivedGhosts)
+		{
+			// object might not exist on this client (e.g. different game setup), state is kept anyway
+			NetworkManager *pNetworkManager = m_pContext->getNetworkManager();
+			NetworkManager::NetworkableMap::iterator itObj = pNetworkManager->m_networkables.find(networkId);
+			if (itObj != pNetworkManager->m_networkables.end())
+				itObj->second->unpackGhostState((char *)(&r.m_state[0]));
+		}
+	}
+
+	return read;
+}
+
+void GhostManager::debugRender(int &threadOwnershipMask, float xoffset/* = 0*/, float yoffset/* = 0*/)
+{
+	float dy = 0.025f;
+	float dx = 0.01f;
+	sprintf(PEString::s_buf, "Ghost Manager:");
+	DebugRenderer::Instance()->createTextMesh(
+		PEString::s_buf, true, false, false, false, 0,
+		Vector3(xoffset, yoffset, 0), 1.0f, threadOwnershipMask);
+
+	sprintf(PEString::s_buf, "Ghosts: %d Waiting: %d Received: %d", (int)(m_ghosts.size()), haveGhostsToSend(), (int)(m_receivedGhosts.size()));
+	DebugRenderer::Instance()->createTextMesh(
+		PEString::s_buf, true, false, false, false, 0,
+		Vector3(xoffset + dx, yoffset + dy, 0), 1.0f, threadOwnershipMask);
+
+	sprintf(PEString::s_buf, "Updates sent: %u Words: %u Bytes: %u", m_numGhostUpdatesSent, m_numWordsSent, m_bytesSent);
+	DebugRenderer::Instance()->createTextMesh(
+		PEString::s_buf, true, false, false, false, 0,
+		Vector3(xoffset + dx, yoffset + dy * 2, 0), 1.0f, threadOwnershipMask);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Loopback benchmark
+//////////////////////////////////////////////////////////////////////////
+
+// stand-in for a networked game object: transform + a couple of gameplay fields
+struct LoopbackGhost : public Networkable
+{
+	LoopbackGhost(PE::GameContext &context)
+	: Networkable(context, this)
+	, m_health(100)
+	, m_animState(0)
+	, m_pAll(NULL)
+	, m_numAll(0)
+	{
+		m_transform.loadIdentity();
+	}
+
+	virtual PE::MetaInfo *net_getClassMetaInfo() {return NULL;}
+
+	virtual int packGhostState(char *pDataStream)
+	{
+		int size = 0;
+		size += StreamManager::WriteTransform(m_transform, &pDataStream[size]);
+		size += StreamManager::WriteInt32(m_health, &pDataStream[size]);
+		size += StreamManager::WriteInt32(m_animState, &pDataStream[size]);
+		return size;
+	}
+
+	// client i controls object i, closer objects are more relevant
+	virtual PrimitiveTypes::Float32 getGhostPriority(int clientId)
+	{
+		Vector3 d = m_transform.getPos() - m_pAll[clientId % m_numAll].m_transform.getPos();
+		return 1.0f / (1.0f + d.length() * 0.1f);
+	}
+
+	Matrix4x4 m_transform;
+	PrimitiveTypes::Int32 m_health;
+	PrimitiveTypes::Int32 m_animState;
+
+	LoopbackGhost *m_pAll;
+	int m_numAll;
+};
+
+static void simulateLoopbackGhosts(std::vector<LoopbackGhost *> &objects, int frame, bool moving)
+{
+	float t = frame / 60.0f;
+	for (unsigned int i = 0; i < objects.size(); ++i)
+	{
+		LoopbackGhost &o = *objects[i];
+
+		// half of objects keep moving on circles, rest stand and only change gameplay state sometimes
+		if (moving && (i % 2) == 0)
+		{
+			float a = t * 0.5f + i;
+			float r = 10.0f + i;
+			o.m_transform.loadIdentity();
+			o.m_transform.turnRight(a);
+			o.m_transform.setPos(Vector3(cosf(a) * r, 0, sinf(a) * r));
+		}
+
+		if (moving && ((frame + i * 7) % 90) == 0)
+			o.m_animState = (o.m_animState + 1) % 4;
+
+		if (moving && ((frame + i * 13) % 120) == 0)
+			o.m_health = o.m_health > 10 ? o.m_health - 10 : 100;
+	}
+}
+
+void GhostManager::RunLoopbackBenchmark(PE::GameContext &context, PE::MemoryArena arena, int numClients, int numObjects, int numFrames, BenchmarkResult *pResult)
+{
+	const float framesPerSecond = 60.0f;
+	const int dropPercent = 5;
+	const int settleFrames = 30;
+
+	Timer timer;
+
+	std::vector<LoopbackGhost *> objects;
+	LoopbackGhost *pObjects = (LoopbackGhost *)(pemalloc(arena, sizeof(LoopbackGhost) * numObjects));
+	for (int i = 0; i < numObjects; ++i)
+	{
+		LoopbackGhost *pObj = new (&pObjects[i]) LoopbackGhost(context);
+		pObj->m_networkId = Networkable::s_NetworkId_FirstDynamic + i;
+		pObj->m_pAll = pObjects;
+		pObj->m_numAll = numObjects;
+		objects.push_back(pObj);
+	}
+
+	std::vector<NetworkContext> senderContexts(numClients);
+	std::vector<NetworkContext> receiverContexts(numClients);
+	for (int c = 0; c < numClients; ++c)
+	{
+		senderContexts[c].m_clientId = c;
+		senderContexts[c].m_pGhostManager = new (arena) GhostManager(context, arena, senderContexts[c], Handle());
+		receiverContexts[c].m_pGhostManager = new (arena) GhostManager(context, arena, receiverContexts[c], Handle());
+		receiverContexts[c].getGhostManager()->m_applyReceivedGhosts = false;
+
+		for (int i = 0; i < numObjects; ++i)
+			if (i != c) // client's own object is not ghosted to it
+				senderContexts[c].getGhostManager()->addGhost(objects[i]);
+	}
+
+	char *pPacket = (char *)(pemalloc(arena, PE_PACKET_TOTAL_SIZE));
+
+	// what current code does: whole state as guaranteed event every time something changes
+	// event = order id (2) + target id (1) + class id (2) + state, packet = size + event count + events
+	const int eventHeaderSize = 5;
+	char stateBuf[PE_GHOST_MAX_STATE_WORDS * 4];
+	int fullStateSize = objects[0]->packGhostState(stateBuf);
+	std::vector<Matrix4x4> prevTransforms(numObjects);
+	std::vector<PrimitiveTypes::Int32> prevHealth(numObjects), prevAnim(numObjects);
+	std::vector<bool> changed(numObjects);
+
+	PrimitiveTypes::UInt32 random = 12345;
+	double ghostBytes = 0, eventBytes = 0;
+	int maxPacketSize = 0;
+	int numPackets = 0, numDropped = 0;
+
+	if (pResult)
+		pResult->m_setupTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	for (int frame = 0; frame < numFrames + settleFrames; ++frame)
+	{
+		bool measuring = frame < numFrames;
+		Timer frameTimer;
+
+		for (int i = 0; i < numObjects; ++i)
+		{
+			prevTransforms[i] = objects[i]->m_transform;
+			prevHealth[i] = objects[i]->m_health;
+			prevAnim[i] = objects[i]->m_animState;
+		}
+
+		simulateLoopbackGhosts(objects, frame, measuring);
+
+		int numChanged = 0;
+		for (int i = 0; i < numObjects; ++i)
+		{
+			changed[i] = memcmp(&prevTransforms[i], &objects[i]->m_transform, sizeof(Matrix4x4)) ||
+				prevHealth[i] != objects[i]->m_health || prevAnim[i] != objects[i]->m_animState;
+			if (changed[i])
+				++numChanged;
+		}
+
+		for (int c = 0; c < numClients; ++c)
+		{
+			GhostManager *pSender = senderContexts[c].getGhostManager();
+			GhostManager *pReceiver = receiverContexts[c].getGhostManager();
+
+			if (measuring)
+			{
+				int changedForClient = numChanged - ((c < numObjects && changed[c]) ? 1 : 0);
+				if (changedForClient)
+					eventBytes += PE_PACKET_HEADER + 1 + changedForClient * (eventHeaderSize + fullStateSize);
+			}
+
+			pSender->prepareToSend();
+			if (!pSender->haveGhostsToSend())
+				continue;
+
+			TransmissionRecord record;
+			bool usefulDataSent, wantToSendMore;
+			int size = PE_PACKET_HEADER;
+			size += StreamManager::WriteVarUInt32(0, &pPacket[size]); // no events
+			size += pSender->fillInNextPacket(&pPacket[size], &record, PE_PACKET_TOTAL_SIZE - size, usefulDataSent, wantToSendMore);
+
+			if (measuring)
+			{
+				ghostBytes += size;
+				maxPacketSize = size > maxPacketSize ? size : maxPacketSize;
+				++numPackets;
+			}
+
+			random = random * 1103515245 + 12345;
+			bool delivered = !measuring || ((random >> 16) % 100) >= (PrimitiveTypes::UInt32)(dropPercent);
+			if (delivered)
+				pReceiver->receiveNextPacket(&pPacket[PE_PACKET_HEADER + 1]);
+			else
+				++numDropped;
+
+			pSender->processNotification(&record, delivered);
+		}
+
+		if (pResult && measuring)
+		{
+			pResult->addTiming("replication", frameTimer.TickAndGetTimeDeltaInSeconds());
+			pResult->sampleMemory();
+		}
+	}
+
+	if (pResult)
+		pResult->m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	// after settling without drops, every client has to have exact state of every object, all words received
+	int mismatches = 0;
+	for (int c = 0; c < numClients; ++c)
+	{
+		GhostManager *pReceiver = receiverContexts[c].getGhostManager();
+		for (int i = 0; i < numObjects; ++i)
+		{
+			if (i == c)
+				continue;
+			int size = objects[i]->packGhostState(stateBuf);
+			GhostReceptionMap::iterator it = pReceiver->m_receivedGhosts.find(objects[i]->m_networkId);
+			PrimitiveTypes::UInt32 numWords = (size + 3) / 4;
+			PrimitiveTypes::UInt32 allWordsMask = numWords >= 32 ? 0xFFFFFFFFu : (1u << numWords) - 1;
+			if (it == pReceiver->m_receivedGhosts.end() || memcmp(&it->second.m_state[0], stateBuf, size)
+				|| it->second.m_numWords != numWords || (it->second.m_receivedMask & allWordsMask) != allWordsMask)
+				++mismatches;
+		}
+	}
+
+	float seconds = numFrames / framesPerSecond;
+	PEINFO("PE: Ghost loopback benchmark: %d clients, %d objects, %d frames, %d%% packet loss\n", numClients, numObjects, numFrames, dropPercent);
+	PEINFO("PE:   ghosts: %.1f bytes/sec per client (%d packets, %d dropped, max packet %d bytes)\n",
+		(float)(ghostBytes / seconds / numClients), numPackets, numDropped, maxPacketSize);
+	PEINFO("PE:   full state events: %.1f bytes/sec per client\n", (float)(eventBytes / seconds / numClients));
+	PEINFO("PE:   state mismatches after settle: %d\n", mismatches);
+	PEASSERT(mismatches == 0, "Ghost replication lost state");
+
+	if (pResult)
+	{
+		pResult->m_ok = mismatches == 0;
+		pResult->m_numFrames = numFrames;
+		pResult->setCounter("ghostBytesPerSecPerClient", ghostBytes / seconds / numClients);
+		pResult->setCounter("eventBytesPerSecPerClient", eventBytes / seconds / numClients);
+		pResult->setCounter("packets", numPackets);
+		pResult->setCounter("dropped", numDropped);
+		pResult->setCounter("maxPacketBytes", maxPacketSize);
+		pResult->setCounter("mismatches", mismatches);
+	}
+
+	pefree(arena, pPacket);
+	for (int c = 0; c < numClients; ++c)
+	{
+		delete senderContexts[c].getGhostManager();
+		delete receiverContexts[c].getGhostManager();
+	}
+	for (int i = 0; i < numObjects; ++i)
+		objects[i]->~LoopbackGhost();
+	pefree(arena, pObjects);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// GhostManager Lua Interface
+//////////////////////////////////////////////////////////////////////////
+//
+void GhostManager::SetLuaFunctions(PE::Components::LuaEnvironment *pLuaEnv, lua_State *luaVM)
+{
+	static const struct luaL_Reg l_functions[] = {
+		{"l_runLoopbackBenchmark", l_runLoopbackBenchmark},
+		{NULL, NULL} // sentinel
+	};
+
+	luaL_register(luaVM, 0, l_functions);
+}
+
+// root.PE.Components.GhostManager.l_runLoopbackBenchmark(l_getGameContext(), 32, 64, 600)
+int GhostManager::l_runLoopbackBenchmark(lua_State *luaVM)
+{
+	int numFrames = (int)(lua_tonumber(luaVM, -1));
+	int numObjects = (int)(lua_tonumber(luaVM, -2));
+	int numClients = (int)(lua_tonumber(luaVM, -3));
+
+	GameContext *pContext = (GameContext *)(lua_touserdata(luaVM, -4));
+
+	lua_pop(luaVM, 4);
+
+	RunLoopbackBenchmark(*pContext, pContext->getDefaultMemoryArena(), numClients, numObjects, numFrames);
+
+	return 0; // no return values
+}
+//////////////////////////////////////////////////////////////////////////
+
+}; // namespace Components
+}; // namespace PE
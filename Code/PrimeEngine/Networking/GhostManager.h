@@ -0,0 +1,141 @@
+#ifndef __PrimeEngineGhostManager_H__
+#define __PrimeEngineGhostManager_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+#include <vector>
+#include <map>
+
+// Inter-Engine includes
+
+#include "../Events/Component.h"
+
+extern "C"
+{
+#include "../../luasocket_dist/src/socket.h"
+};
+
+#include "PrimeEngine/Networking/NetworkContext.h"
+#include "PrimeEngine/Utils/Networkable.h"
+
+// Sibling/Children includes
+#include "Packet.h"
+
+namespace PE {
+
+struct BenchmarkResult;
+
+namespace Components {
+
+// Replicates continuous state of Networkables (ghosts) to one connection.
+// Unlike events, ghost state is not queued: every update the current state is diffed against the state
+// the client acknowledged and only changed words are sent. Lost packets don't need resending since
+// the words just stay different from acked state and go out again with their latest value.
+// Ghosts compete for the space left in packets after events, by accumulated priority.
+struct GhostManager : public Component
+{
+	PE_DECLARE_CLASS(GhostManager);
+
+	// Constructor -------------------------------------------------------------
+	GhostManager(PE::GameContext &context, PE::MemoryArena arena, PE::NetworkContext &netContext, Handle hMyself);
+
+	virtual ~GhostManager();
+
+	// Methods -----------------------------------------------------------------
+	virtual void initialize();
+
+	/// called by gameplay code to start/stop replicating object to this connection
+	/// object has to be registered with the same network id on receiving side
+	void addGhost(PE::Networkable *pNetworkable);
+	void removeGhost(PE::Networkable *pNetworkable);
+
+	/// called by stream manager once per update before filling packets
+	/// packs state of all ghosts, finds changed words and accumulates priorities
+	void prepareToSend();
+
+	/// called by stream manager to see how many ghosts have changes to send
+	int haveGhostsToSend();
+
+	/// called by StreamManager to put highest priority ghost deltas that fit in packet
+	int fillInNextPacket(char *pDataStream, TransmissionRecord *pRecord, int packetSizeAllocated, bool &out_usefulDataSent, bool &out_wantToSendMore);
+
+	/// called by StreamManager to process transmission record deliver notification
+	void processNotification(TransmissionRecord *pTransmittionRecord, bool delivered);
+
+	int receiveNextPacket(char *pDataStream);
+
+	void debugRender(int &threadOwnershipMask, float xoffset = 0, float yoffset = 0);
+
+	// Component ------------------------------------------------------------
+	virtual void addDefaultComponents();
+
+	// Individual events -------------------------------------------------------
+
+	// Benchmark -----------------------------------------------------------------
+
+	// runs numClients sender/receiver ghost manager pairs in process (no sockets) with numObjects moving objects
+	// and reports bytes/sec per client compared to sending full state events. optionally records into pResult
+	static void RunLoopbackBenchmark(PE::GameContext &context, PE::MemoryArena arena, int numClients, int numObjects, int numFrames, BenchmarkResult *pResult = NULL);
+
+	//////////////////////////////////////////////////////////////////////////
+	// GhostManager Lua Interface
+	//////////////////////////////////////////////////////////////////////////
+	//
+	static void SetLuaFunctions(PE::Components::LuaEnvironment *pLuaEnv, lua_State *luaVM);
+	//
+	static int l_runLoopbackBenchmark(lua_State *luaVM);
+	//
+	//////////////////////////////////////////////////////////////////////////
+
+	//////////////////////////////////////////////////////////////////////////
+	// Member variables
+	//////////////////////////////////////////////////////////////////////////
+
+	// transmitter side state of one ghost
+	struct GhostRecord
+	{
+		PE::Networkable *m_pNetworkable;
+		PrimitiveTypes::Float32 m_priority; // accumulates while ghost has changes that are not sent
+		PrimitiveTypes::UInt32 m_numWords;
+		PrimitiveTypes::UInt32 m_changedMask; // words to send this update
+		PrimitiveTypes::UInt32 m_ackedMask; // words client has
+		PrimitiveTypes::UInt32 m_inFlightMask; // words sent but not acked or dropped yet
+		PrimitiveTypes::UInt32 m_state[PE_GHOST_MAX_STATE_WORDS]; // current state
+		PrimitiveTypes::UInt32 m_ackedState[PE_GHOST_MAX_STATE_WORDS];
+		PrimitiveTypes::UInt32 m_sentState[PE_GHOST_MAX_STATE_WORDS]; // last value sent, valid if in flight
+		PrimitiveTypes::UInt32 m_sentUpdateId[PE_GHOST_MAX_STATE_WORDS];
+	};
+
+	// receiver side state of one ghost
+	struct GhostReceptionData
+	{
+		PrimitiveTypes::UInt32 m_numWords; // of sender's state
+		PrimitiveTypes::UInt32 m_receivedMask; // words received at least once. state is applied once all are
+		PrimitiveTypes::UInt32 m_state[PE_GHOST_MAX_STATE_WORDS];
+		PrimitiveTypes::UInt32 m_updateId[PE_GHOST_MAX_STATE_WORDS]; // to not apply older data if packets come out of order
+	};
+
+	typedef std::map<Networkable::NetworkId, GhostRecord> GhostMap;
+	GhostMap m_ghosts;
+
+	std::vector<GhostRecord *> m_sendQueue; // ghosts with changes, highest priority first
+
+	typedef std::map<Networkable::NetworkId, GhostReceptionData> GhostReceptionMap;
+	GhostReceptionMap m_receivedGhosts;
+	bool m_applyReceivedGhosts; // if false, received state is only stored (loopback benchmark)
+
+	PrimitiveTypes::UInt32 m_nextUpdateId;
+
+	// stats
+	PrimitiveTypes::UInt32 m_numGhostUpdatesSent;
+	PrimitiveTypes::UInt32 m_numWordsSent;
+	PrimitiveTypes::UInt32 m_bytesSent;
+
+	PE::NetworkContext *m_pNetContext;
+};
+}; // namespace Components
+}; // namespace PE
+#endif
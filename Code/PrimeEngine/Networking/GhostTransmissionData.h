@@ -0,0 +1,29 @@
+#ifndef __PrimeEngineGhostTransmissionData_H__
+#define __PrimeEngineGhostTransmissionData_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/Networkable.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+// state words of one ghost that were put in a packet
+// once the packet is acknowledged these values are what the client has
+struct GhostTransmissionData
+{
+	Networkable::NetworkId m_networkId;
+	PrimitiveTypes::UInt32 m_updateId; // id of ghost update chunk the words were sent in
+	PrimitiveTypes::UInt32 m_mask; // bit per state word
+	PrimitiveTypes::UInt32 m_words[PE_GHOST_MAX_STATE_WORDS];
+};
+
+}; // namespace PE
+#endif
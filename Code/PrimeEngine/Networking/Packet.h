@@ -11,6 +11,9 @@
 // if hit this, need to throttle network
 #define PE_MAX_EVENT_JAM 16 
 
+// max size of ghost state in 4 byte words (one bit per word in delta mask)
+#define PE_GHOST_MAX_STATE_WORDS 32
+
 // API Abstraction
 #include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
 
@@ -23,6 +26,7 @@
 
 // Sibling/Children includes
 #include "EventTransmissionData.h"
+#include "GhostTransmissionData.h"
 
 namespace PE {
 
@@ -35,6 +39,8 @@ struct TransmissionRecord
 
 	std::vector<EventTransmissionData> m_sentEvents;
 
+	std::vector<GhostTransmissionData> m_sentGhosts;
+
 	TransmissionRecord *m_pNextTransmission;
 };
 
@@ -22,9 +22,11 @@ extern "C"
 #include "PrimeEngine/GameObjectModel/GameObjectManager.h"
 #include "PrimeEngine/Events/StandardEvents.h"
 #include "PrimeEngine/Scene/DebugRenderer.h"
+#include "PrimeEngine/Profiling/Benchmark.h"
 
 #include "PrimeEngine/Networking/StreamManager.h"
 #include "PrimeEngine/Networking/EventManager.h"
+#include "PrimeEngine/Networking/GhostManager.h"
 
 // Sibling/Children includes
 #include "ServerConnectionManager.h"
@@ -40,6 +42,9 @@ PE_IMPLEMENT_CLASS1(ServerNetworkManager, NetworkManager);
 ServerNetworkManager::ServerNetworkManager(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself)
 : NetworkManager(context, arena, hMyself)
 , m_clientConnections(context, arena, PE_SERVER_MAX_CONNECTIONS)
+, m_numLiveConnections(0)
+, m_udpOpen(false)
+, m_udpCookieSecret(0)
 {
 	m_state = ServerState_Uninitialized;
 }
@@ -48,6 +53,8 @@ ServerNetworkManager::~ServerNetworkManager()
 {
 	if (m_state != ServerState_Uninitialized)
 		socket_destroy(&m_sock);
+	if (m_udpOpen)
+		socket_destroy(&m_udpSock);
 }
 
 void ServerNetworkManager::addDefaultComponents()
@@ -63,6 +70,9 @@ void ServerNetworkManager::initNetwork()
 	NetworkManager::initNetwork();
 
 	serverOpenTCPSocket();
+
+	if (m_state == ServerState_ConnectionListening)
+		serverOpenUDPSocket();
 }
 
 void ServerNetworkManager::serverOpenTCPSocket()
@@ -110,25 +120,77 @@ void ServerNetworkManager::serverOpenTCPSocket()
 		return;
 	}
 
+	m_poller.add(m_sock, NULL);
+
 	m_state = ServerState_ConnectionListening;
 }
 
+void ServerNetworkManager::serverOpenUDPSocket()
+{
+	const char *err = /*luasocket::*/inet_trycreate(&m_udpSock, SOCK_DGRAM);
+	if (!err)
+	{
+		err = inet_trybind(&m_udpSock, "0.0.0.0", m_serverPort);
+		if (err)
+			socket_destroy(&m_udpSock);
+	}
+
+	if (err)
+	{
+		PEINFO("PE: Warning: Could not open udp socket on port %d, only tcp clients can connect. Err: %s\n", m_serverPort, err);
+		return;
+	}
+
+	socket_setnonblocking(&m_udpSock);
+	m_poller.add(m_udpSock, &m_udpSock);
+	m_udpOpen = true;
+
+	// cookies of connect challenges can't be guessed from earlier runs
+	double now = timeout_gettime();
+	PrimitiveTypes::UInt32 words[2];
+	memcpy(words, &now, sizeof(words));
+	m_udpCookieSecret = words[0] ^ words[1] ^ ((PrimitiveTypes::UInt32)(rand()) << 16) ^ (PrimitiveTypes::UInt32)(rand());
+}
+
+// murmur3 finalizer
+static PrimitiveTypes::UInt32 mix32(PrimitiveTypes::UInt32 h)
+{
+	h ^= h >> 16; h *= 0x85ebca6b;
+	h ^= h >> 13; h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+PrimitiveTypes::UInt32 ServerNetworkManager::udpConnectCookie(PrimitiveTypes::UInt32 addr, PrimitiveTypes::UInt16 port)
+{
+	PrimitiveTypes::UInt32 h = mix32(mix32(m_udpCookieSecret ^ addr) ^ port);
+	return h ? h : 1; // 0 is cookie of first request
+}
 
-void ServerNetworkManager::createNetworkConnectionContext(t_socket sock,  int clientId, PE::NetworkContext *pNetContext)
+
+void ServerNetworkManager::createNetworkConnectionContext(t_socket sock,  int clientId, PE::NetworkContext *pNetContext, const struct sockaddr_in *pUdpPeerAddr /* = NULL*/)
 {
 	
 	pNetContext->m_clientId = clientId;
 
 	NetworkManager::createNetworkConnectionContext(sock, pNetContext);
 
+	// slot of dead connection keeps its connection and stream manager (they stay registered as components)
+	if (pNetContext->getConnectionManager())
+	{
+		pNetContext->getConnectionManager()->reset();
+		pNetContext->getStreamManager()->reset();
+	}
+	else
 	{
 		pNetContext->m_pConnectionManager = new (m_arena) ServerConnectionManager(*m_pContext, m_arena, *pNetContext, Handle());
 		pNetContext->getConnectionManager()->addDefaultComponents();
-	}
 
-	{
 		pNetContext->m_pStreamManager = new (m_arena) StreamManager(*m_pContext, m_arena, *pNetContext, Handle());
 		pNetContext->getStreamManager()->addDefaultComponents();
+
+		addComponent(pNetContext->getConnectionManager()->getHandle());
+		addComponent(pNetContext->getStreamManager()->getHandle());
 	}
 
 	{
@@ -136,10 +198,91 @@ void ServerNetworkManager::createNetworkConnectionContext(t_socket sock,  int cl
 		pNetContext->getEventManager()->addDefaultComponents();
 	}
 
-	pNetContext->getConnectionManager()->initializeConnected(sock);
+	{
+		pNetContext->m_pGhostManager = new (m_arena) GhostManager(*m_pContext, m_arena, *pNetContext, Handle());
+		pNetContext->getGhostManager()->addDefaultComponents();
+
+		for (unsigned int i = 0; i < m_ghosts.size(); ++i)
+			if (m_ghosts[i].m_exceptClient != clientId)
+				pNetContext->getGhostManager()->addGhost(m_ghosts[i].m_pNetworkable);
+	}
 
-	addComponent(pNetContext->getConnectionManager()->getHandle());
-	addComponent(pNetContext->getStreamManager()->getHandle());
+	if (pUdpPeerAddr)
+	{
+		// datagrams of shared socket are received in do_UPDATE()
+		pNetContext->getConnectionManager()->initializeConnectedUdp(sock, pUdpPeerAddr);
+	}
+	else
+	{
+		pNetContext->getConnectionManager()->initializeConnected(sock);
+
+		// socket is serviced by one poller wait in do_UPDATE() instead of connection manager polling it
+		pNetContext->getConnectionManager()->setPoller(&m_poller);
+		m_poller.add(sock, pNetContext);
+	}
+}
+
+int ServerNetworkManager::acquireClientSlot()
+{
+	for (unsigned int i = 0; i < m_clientConnections.m_size; ++i)
+	{
+		if (!m_clientConnections[i].getEventManager())
+			return i;
+	}
+
+	if (m_clientConnections.m_size >= PE_SERVER_MAX_CONNECTIONS)
+		return -1;
+
+	m_clientConnections.add(NetworkContext());
+	return m_clientConnections.m_size - 1;
+}
+
+void ServerNetworkManager::releaseDeadConnections()
+{
+	std::vector<int> releasedClients;
+
+	m_connectionsMutex.lock();
+	for (unsigned int i = 0; i < m_clientConnections.m_size; ++i)
+	{
+		NetworkContext &netContext = m_clientConnections[i];
+		if (!netContext.getEventManager() || netContext.getConnectionManager()->connected())
+			continue;
+
+		ConnectionManager *pConnectionManager = netContext.getConnectionManager();
+		if (pConnectionManager->getTransport() == ConnectionManager::Transport_UDP)
+		{
+			std::pair<PrimitiveTypes::UInt32, PrimitiveTypes::UInt16> key(ntohl(pConnectionManager->m_udpPeerAddr.sin_addr.s_addr), ntohs(pConnectionManager->m_udpPeerAddr.sin_port));
+			m_udpClients.erase(key);
+		}
+
+		// event and ghost managers are not components of network manager, so they can be deleted.
+		// released slot is the one without event manager
+		delete netContext.getEventManager();
+		delete netContext.getGhostManager();
+		netContext.m_pEventManager = NULL;
+		netContext.m_pGhostManager = NULL;
+		netContext.m_clientId = -1;
+
+		m_numLiveConnections--;
+		releasedClients.push_back(i);
+	}
+	m_connectionsMutex.unlock();
+
+	for (unsigned int i = 0; i < releasedClients.size(); ++i)
+	{
+		int clientId = releasedClients[i];
+
+		// objects of client are not ghosted to other clients anymore
+		for (int g = (int)(m_ghosts.size()) - 1; g >= 0; --g)
+		{
+			if (m_ghosts[g].m_exceptClient == clientId)
+				removeGhostFromAll(m_ghosts[g].m_pNetworkable);
+		}
+
+		Event_SERVER_CLIENT_DISCONNECTED evt;
+		evt.m_clientId = clientId;
+		m_pContext->getGameObjectManager()->handleEvent(&evt);
+	}
 }
 
 
@@ -148,42 +291,156 @@ void ServerNetworkManager::do_UPDATE(Events::Event *pEvt)
 {
 	NetworkManager::do_UPDATE(pEvt);
 
+	if (m_state != ServerState_ConnectionListening)
+		return;
+
+	// one wait for all sockets. cost depends on number of sockets that are ready, not number of connections
+	SocketPoller::Event events[PE_SERVER_MAX_CONNECTIONS + 1];
+	int numEvents = m_poller.wait(0, events, PE_SERVER_MAX_CONNECTIONS + 1);
+
+	for (int i = 0; i < numEvents; ++i)
+	{
+		SocketPoller::Event &evt = events[i];
+		if (!evt.m_pUserData)
+		{
+			acceptConnections();
+			continue;
+		}
+
+		if (evt.m_pUserData == &m_udpSock)
+		{
+			receiveDatagrams();
+			continue;
+		}
+
+		NetworkContext *pNetContext = (NetworkContext *)(evt.m_pUserData);
+		ConnectionManager *pConnectionManager = pNetContext->getConnectionManager();
+
+		if (evt.m_readable || evt.m_error)
+			pConnectionManager->receivePackets(); // reports errors and disconnects
+
+		if (evt.m_writable)
+			pConnectionManager->flushSendQueue();
+	}
+
+	releaseDeadConnections();
+}
+
+void ServerNetworkManager::acceptConnections()
+{
 	t_timeout timeout; // timeout supports managing timeouts of multiple blocking alls by using total.
 	// but if total is < 0 it just uses block value for each blocking call
 	timeout.block = 0;
 	timeout.total = -1.0;
 	timeout.start = 0;
 
-	t_socket sock;
-	int err = socket_accept(&m_sock, &sock, NULL, NULL, &timeout);
-	if (err != IO_DONE)
+	while (true)
 	{
-		const char *s = socket_strerror(err);
-		return;
-	}
+		t_socket sock;
+		int err = socket_accept(&m_sock, &sock, NULL, NULL, &timeout);
+		if (err != IO_DONE)
+			return; // no more pending connections
 
-	if (err == IO_DONE)
-	{
 		m_connectionsMutex.lock();
-		m_clientConnections.add(NetworkContext());
-		int clientIndex = m_clientConnections.m_size-1;
+		int clientIndex = acquireClientSlot();
+		if (clientIndex < 0)
+		{
+			m_connectionsMutex.unlock();
+			PEINFO("PE: Warning: Server is full (%d connections). Dropping new connection.\n", PE_SERVER_MAX_CONNECTIONS);
+			socket_destroy(&sock);
+			continue;
+		}
+
 		NetworkContext &netContext = m_clientConnections[clientIndex];
 
 		// create a tribes stack for this connection
 		createNetworkConnectionContext(sock, clientIndex, &netContext);
+		m_numLiveConnections++;
 		m_connectionsMutex.unlock();
 
 		PE::Events::Event_SERVER_CLIENT_CONNECTION_ACK evt(*m_pContext);
 		evt.m_clientId = clientIndex;
 
 		netContext.getEventManager()->scheduleEvent(&evt, m_pContext->getGameObjectManager(), true);
+	}
+}
+
+void ServerNetworkManager::receiveDatagrams()
+{
+	t_timeout timeout;
+	timeout.block = 0;
+	timeout.total = -1.0;
+	timeout.start = 0;
 
+	char buffer[PE_SOCKET_RECEIVE_BUFFER_SIZE];
+
+	while (true)
+	{
+		struct sockaddr_in addr;
+		socklen_t addrLen = sizeof(addr);
+		size_t got = 0;
+		int err = socket_recvfrom(&m_udpSock, buffer, sizeof(buffer), &got, (SA *)(&addr), &addrLen, &timeout);
+		if (err != IO_DONE)
+			return; // nothing left (or icmp error of some peer, which is not fatal for shared socket)
+
+		if (!ConnectionManager::IsUdpDatagram(buffer, (int)(got)))
+			continue;
+
+		std::pair<PrimitiveTypes::UInt32, PrimitiveTypes::UInt16> key(ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port));
+		std::map<std::pair<PrimitiveTypes::UInt32, PrimitiveTypes::UInt16>, int>::iterator it = m_udpClients.find(key);
+
+		int clientIndex;
+		if (it != m_udpClients.end())
+			clientIndex = it->second;
+		else
+		{
+			// only connect request creates connection, and only if it has cookie of its address. the cookie proves that
+			// sender receives on that address, so spoofed or stray datagrams don't take slots
+			PrimitiveTypes::UInt32 cookie = 0;
+			if (ConnectionManager::ReadUdpControlDatagram(buffer, (int)(got), cookie) != ConnectionManager::UdpDatagram_Connect)
+				continue;
+
+			PrimitiveTypes::UInt32 expectedCookie = udpConnectCookie(key.first, key.second);
+			if (cookie != expectedCookie)
+			{
+				// challenge is not bigger than request
+				char challenge[PE_UDP_HEADER_SIZE];
+				int size = ConnectionManager::WriteUdpControlDatagram(challenge, ConnectionManager::UdpDatagram_Challenge, expectedCookie);
+				size_t sent;
+				socket_sendto(&m_udpSock, challenge, size, &sent, (SA *)(&addr), sizeof(addr), &timeout);
+				continue;
+			}
+
+			m_connectionsMutex.lock();
+			clientIndex = acquireClientSlot();
+			if (clientIndex < 0)
+			{
+				m_connectionsMutex.unlock();
+				PEINFO("PE: Warning: Server is full (%d connections). Dropping udp datagram of new connection.\n", PE_SERVER_MAX_CONNECTIONS);
+				continue;
+			}
+
+			NetworkContext &netContext = m_clientConnections[clientIndex];
+
+			createNetworkConnectionContext(m_udpSock, clientIndex, &netContext, &addr);
+			m_numLiveConnections++;
+			m_connectionsMutex.unlock();
+
+			m_udpClients[key] = clientIndex;
+
+			PE::Events::Event_SERVER_CLIENT_CONNECTION_ACK evt(*m_pContext);
+			evt.m_clientId = clientIndex;
+
+			netContext.getEventManager()->scheduleEvent(&evt, m_pContext->getGameObjectManager(), true);
+		}
+
+		m_clientConnections[clientIndex].getConnectionManager()->receiveDatagram(buffer, (int)(got));
 	}
 }
 
 void ServerNetworkManager::debugRender(int &threadOwnershipMask, float xoffset /* = 0*/, float yoffset /* = 0*/)
 {
-	sprintf(PEString::s_buf, "Server: Port %d %d Connections", m_serverPort, m_clientConnections.m_size);
+	sprintf(PEString::s_buf, "Server: Port %d %d Connections", m_serverPort, m_numLiveConnections);
 	DebugRenderer::Instance()->createTextMesh(
 		PEString::s_buf, true, false, false, false, 0,
 		Vector3(xoffset, yoffset, 0), 1.0f, threadOwnershipMask);
@@ -195,14 +452,18 @@ void ServerNetworkManager::debugRender(int &threadOwnershipMask, float xoffset /
 	m_connectionsMutex.lock();
 	for (unsigned int i = 0; i < m_clientConnections.m_size; ++i)
 	{
+		NetworkContext &netContext = m_clientConnections[i];
+		if (!netContext.getEventManager())
+			continue; // released
+
 		sprintf(PEString::s_buf, "Connection[%d]:", i);
 	
 		DebugRenderer::Instance()->createTextMesh(
 		PEString::s_buf, true, false, false, false, 0,
 		Vector3(xoffset, yoffset + dy + evtManagerDy * i, 0), 1.0f, threadOwnershipMask);
 
-		NetworkContext &netContext = m_clientConnections[i];
 		netContext.getEventManager()->debugRender(threadOwnershipMask, xoffset + dx, yoffset + dy * 2.0f + evtManagerDy * i);
+		netContext.getGhostManager()->debugRender(threadOwnershipMask, xoffset + dx + 0.5f, yoffset + dy * 2.0f + evtManagerDy * i);
 	}
 	m_connectionsMutex.unlock();
 }
@@ -211,15 +472,399 @@ void ServerNetworkManager::scheduleEventToAllExcept(PE::Networkable *pNetworkabl
 {
 	for (unsigned int i = 0; i < m_clientConnections.m_size; ++i)
 	{
-		if ((int)(i) == exceptClient)
+		NetworkContext &netContext = m_clientConnections[i];
+		if ((int)(i) == exceptClient || !netContext.getEventManager())
 			continue;
 
-		NetworkContext &netContext = m_clientConnections[i];
 		netContext.getEventManager()->scheduleEvent(pNetworkable, pNetworkableTarget, true);
 	}
 }
 
+void ServerNetworkManager::ghostToAllExcept(PE::Networkable *pNetworkable, int exceptClient)
+{
+	m_connectionsMutex.lock();
+
+	for (unsigned int i = 0; i < m_ghosts.size(); ++i)
+	{
+		PEASSERT(m_ghosts[i].m_pNetworkable != pNetworkable, "Object is already ghosted");
+	}
+
+	ServerGhost ghost;
+	ghost.m_pNetworkable = pNetworkable;
+	ghost.m_exceptClient = exceptClient;
+	m_ghosts.push_back(ghost);
+
+	for (unsigned int i = 0; i < m_clientConnections.m_size; ++i)
+	{
+		NetworkContext &netContext = m_clientConnections[i];
+		if ((int)(i) == exceptClient || !netContext.getGhostManager())
+			continue;
+
+		netContext.getGhostManager()->addGhost(pNetworkable);
+	}
+
+	m_connectionsMutex.unlock();
+}
+
+void ServerNetworkManager::removeGhostFromAll(PE::Networkable *pNetworkable)
+{
+	m_connectionsMutex.lock();
+
+	for (unsigned int i = 0; i < m_ghosts.size(); ++i)
+	{
+		if (m_ghosts[i].m_pNetworkable == pNetworkable)
+		{
+			m_ghosts.erase(m_ghosts.begin() + i);
+			break;
+		}
+	}
+
+	for (unsigned int i = 0; i < m_clientConnections.m_size; ++i)
+	{
+		NetworkContext &netContext = m_clientConnections[i];
+		if (netContext.getGhostManager())
+			netContext.getGhostManager()->removeGhost(pNetworkable);
+	}
+
+	m_connectionsMutex.unlock();
+}
+
+
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+//////////////////////////////////////////////////////////////////////////
+
+// connection managers of server are not updated through events here. stream managers are not updated,
+// udp connections only send acks
+static void UpdateServer(ServerNetworkManager *pServer)
+{
+	for (unsigned int i = 0; i < pServer->m_clientConnections.m_size; ++i)
+	{
+		NetworkContext &netContext = pServer->m_clientConnections[i];
+		if (!netContext.getEventManager())
+			continue;
+		netContext.getConnectionManager()->do_UPDATE(NULL);
+		netContext.getConnectionManager()->flushSendQueue();
+	}
+	pServer->do_UPDATE(NULL);
+}
+
+// object of one client that is ghosted to the others
+struct ChurnGhost : public Networkable
+{
+	ChurnGhost(PE::GameContext &context)
+	: Networkable(context, this)
+	, m_value(0)
+	{}
+
+	virtual PE::MetaInfo *net_getClassMetaInfo() {return NULL;}
+
+	virtual int packGhostState(char *pDataStream)
+	{
+		return StreamManager::WriteInt32(m_value, pDataStream);
+	}
+
+	PrimitiveTypes::Int32 m_value;
+};
+
+// connects tcp client and returns its client id, or -1
+static int ConnectTcpClient(ServerNetworkManager *pServer, t_socket &sock)
+{
+	t_timeout timeout;
+	timeout.block = 1.0;
+	timeout.total = -1.0;
+	timeout.start = 0;
+
+	if (inet_trycreate(&sock, SOCK_STREAM))
+		return -1;
+	timeout_markstart(&timeout);
+	if (inet_tryconnect(&sock, "127.0.0.1", pServer->m_serverPort, &timeout))
+	{
+		socket_destroy(&sock);
+		return -1;
+	}
+
+	// new client is in first slot that is not in use yet
+	std::vector<bool> used(pServer->m_clientConnections.m_size);
+	for (unsigned int i = 0; i < used.size(); ++i)
+		used[i] = pServer->m_clientConnections[i].getEventManager() != NULL;
+
+	int numLive = pServer->m_numLiveConnections;
+	double start = timeout_gettime();
+	while (pServer->m_numLiveConnections == numLive && timeout_gettime() - start < 1.0)
+		pServer->do_UPDATE(NULL);
+
+	for (unsigned int i = 0; i < pServer->m_clientConnections.m_size; ++i)
+	{
+		if ((i >= used.size() || !used[i]) && pServer->m_clientConnections[i].getEventManager())
+			return i;
+	}
+	return -1;
+}
+
+// updates server until numLive connections are alive or a second passes
+static bool UpdateServerUntilLive(ServerNetworkManager *pServer, int numLive)
+{
+	double start = timeout_gettime();
+	while (true)
+	{
+		UpdateServer(pServer);
+		if (pServer->m_numLiveConnections == numLive)
+			return true;
+		if (timeout_gettime() - start > 1.0)
+			return false;
+	}
+}
+
+// udp client from localPort (0: any) connects to server. returns connected client connection manager or NULL
+static ConnectionManager *ConnectUdpClient(PE::GameContext &context, PE::MemoryArena arena, ServerNetworkManager *pServer,
+	NetworkContext &netContext, unsigned short &localPort)
+{
+	t_socket sock;
+	const char *err = inet_trycreate(&sock, SOCK_DGRAM);
+	if (!err)
+	{
+		err = inet_trybind(&sock, "127.0.0.1", localPort);
+		if (err)
+			socket_destroy(&sock);
+	}
+	if (err)
+		return NULL;
+
+	struct sockaddr_in addr;
+	socklen_t addrLen = sizeof(addr);
+	getsockname(sock, (SA *)(&addr), &addrLen);
+	localPort = ntohs(addr.sin_port);
+
+	t_timeout timeout;
+	timeout.block = 0;
+	timeout.total = -1.0;
+	timeout.start = 0;
+	inet_tryconnect(&sock, "127.0.0.1", pServer->m_serverPort, &timeout);
+
+	ConnectionManager *pClient = new (arena) ConnectionManager(context, arena, netContext, Handle());
+	netContext.m_pConnectionManager = pClient;
+	pClient->initializeConnectingUdp(sock);
+
+	// connect request, challenge, connect request with cookie, ack of new connection
+	double start = timeout_gettime();
+	while (timeout_gettime() - start < 1.0)
+	{
+		pClient->m_udpNow = timeout_gettime();
+		pClient->receivePackets();
+		pClient->updateUdp();
+		UpdateServer(pServer);
+		if (pClient->connected())
+			return pClient;
+	}
+
+	pClient->disconnect();
+	delete pClient;
+	netContext.m_pConnectionManager = NULL;
+	return NULL;
+}
+
+void ServerNetworkManager::RunChurnBenchmark(PE::GameContext &context, PE::MemoryArena arena, int numClients, int numRounds, BenchmarkResult *pResult)
+{
+	if (numClients > PE_SERVER_MAX_CONNECTIONS)
+		numClients = PE_SERVER_MAX_CONNECTIONS;
+
+	ServerNetworkManager *pServer = new (arena) ServerNetworkManager(context, arena, Handle());
+	pServer->addDefaultComponents();
+	pServer->serverOpenTCPSocket();
+	if (pServer->m_state == ServerState_ConnectionListening)
+		pServer->serverOpenUDPSocket();
+	if (!pServer->m_udpOpen)
+	{
+		PEINFO("PE: Server churn benchmark: could not open server sockets\n");
+		delete pServer;
+		return;
+	}
+
+	t_timeout timeout;
+	timeout.block = 1.0;
+	timeout.total = -1.0;
+	timeout.start = 0;
+
+	std::vector<t_socket> clientSocks;
+	int numRoundsOk = 0;
+	int numConnections = 0;
+	double startTime = timeout_gettime();
+	for (int round = 0; round < numRounds; ++round)
+	{
+		for (int i = 0; i < numClients; ++i)
+		{
+			t_socket sock;
+			if (inet_trycreate(&sock, SOCK_STREAM))
+				break;
+			timeout_markstart(&timeout);
+			if (inet_tryconnect(&sock, "127.0.0.1", pServer->m_serverPort, &timeout))
+			{
+				socket_destroy(&sock);
+				break;
+			}
+			clientSocks.push_back(sock);
+		}
+
+		bool accepted = UpdateServerUntilLive(pServer, (int)(clientSocks.size())) && (int)(clientSocks.size()) == numClients;
+		numConnections += pServer->m_numLiveConnections;
+
+		for (unsigned int i = 0; i < clientSocks.size(); ++i)
+			socket_destroy(&clientSocks[i]);
+		clientSocks.clear();
+
+		bool released = UpdateServerUntilLive(pServer, 0);
+		if (accepted && released)
+			numRoundsOk++;
+	}
+	double time = timeout_gettime() - startTime;
+
+	// udp: datagram that is not a connect request doesn't create connection
+	bool strayIgnored = false;
+	{
+		t_socket sock;
+		if (!inet_trycreate(&sock, SOCK_DGRAM))
+		{
+			char datagram[PE_UDP_HEADER_SIZE];
+			int size = ConnectionManager::WriteUdpControlDatagram(datagram, ConnectionManager::UdpDatagram_Ack, 0);
+			timeout_markstart(&timeout);
+			inet_tryconnect(&sock, "127.0.0.1", pServer->m_serverPort, &timeout);
+			size_t sent;
+			socket_send(&sock, datagram, size, &sent, &timeout);
+			strayIgnored = !UpdateServerUntilLive(pServer, 1) && pServer->m_numLiveConnections == 0;
+			socket_destroy(&sock);
+		}
+	}
+
+	// udp: client connects through challenge, its connection dies, and it connects again from same address and port
+	bool udpConnected = false, udpReconnected = false;
+	{
+		NetworkContext clientContext;
+		unsigned short localPort = 0;
+		ConnectionManager *pClient = ConnectUdpClient(context, arena, pServer, clientContext, localPort);
+		udpConnected = pClient && pServer->m_numLiveConnections == 1;
+		if (pClient)
+		{
+			pClient->disconnect();
+			delete pClient;
+		}
+
+		// like timeout of server side
+		for (unsigned int i = 0; i < pServer->m_clientConnections.m_size; ++i)
+		{
+			NetworkContext &netContext = pServer->m_clientConnections[i];
+			if (netContext.getEventManager() && netContext.getConnectionManager()->connected())
+				netContext.getConnectionManager()->disconnect();
+		}
+		UpdateServerUntilLive(pServer, 0);
+
+		NetworkContext reconnectContext;
+		pClient = udpConnected ? ConnectUdpClient(context, arena, pServer, reconnectContext, localPort) : NULL;
+		udpReconnected = pClient && pServer->m_numLiveConnections == 1;
+		if (pClient)
+		{
+			pClient->disconnect();
+			delete pClient;
+		}
+	}
 
+	// object of client a is ghosted to client b until client a disconnects
+	bool ghostSent = false, ghostRemoved = false;
+	{
+		t_socket sockA, sockB;
+		int clientA = ConnectTcpClient(pServer, sockA);
+		int clientB = clientA >= 0 ? ConnectTcpClient(pServer, sockB) : -1;
+		if (clientB >= 0)
+		{
+			ChurnGhost ghost(context);
+			ghost.m_networkId = Networkable::s_NetworkId_FirstDynamic;
+			pServer->ghostToAllExcept(&ghost, clientA);
+
+			GhostManager *pGhostsOfB = pServer->m_clientConnections[clientB].getGhostManager();
+			pGhostsOfB->prepareToSend();
+			ghostSent = pGhostsOfB->haveGhostsToSend() == 1;
+
+			socket_destroy(&sockA);
+			UpdateServerUntilLive(pServer, 1);
+
+			// changed state of removed ghost is not sent
+			ghost.m_value = 1;
+			pGhostsOfB->prepareToSend();
+			ghostRemoved = pServer->m_ghosts.size() == 0 && pGhostsOfB->m_ghosts.size() == 0 && pGhostsOfB->haveGhostsToSend() == 0;
+
+			// removed already if test failed
+			pServer->removeGhostFromAll(&ghost);
+			socket_destroy(&sockB);
+		}
+		else if (clientA >= 0)
+			socket_destroy(&sockA);
+		UpdateServerUntilLive(pServer, 0);
+	}
+
+	int numSlots = pServer->m_clientConnections.m_size;
+	bool ok = numRoundsOk == numRounds && numSlots <= numClients && strayIgnored && udpConnected && udpReconnected && ghostSent && ghostRemoved;
+
+	PEINFO("PE: Server churn benchmark: %d rounds of %d tcp clients, %d connections accepted in %.1f ms\n", numRounds, numClients, numConnections, (float)(time * 1000.0));
+	PEINFO("PE:   %d of %d rounds accepted and released all clients, %d slots used\n", numRoundsOk, numRounds, numSlots);
+	PEINFO("PE:   udp: stray datagram ignored: %s, connected: %s, reconnected from same port: %s\n",
+		strayIgnored ? "yes" : "no", udpConnected ? "yes" : "no", udpReconnected ? "yes" : "no");
+	PEINFO("PE:   ghost of client sent to other client: %s, stops when owner disconnects: %s\n", ghostSent ? "yes" : "no", ghostRemoved ? "yes" : "no");
+
+	if (pResult)
+	{
+		pResult->m_ok = ok;
+		pResult->m_numFrames = numRounds;
+		pResult->setCounter("connections", numConnections);
+		pResult->setCounter("slots", numSlots);
+		pResult->setCounter("roundsOk", numRoundsOk);
+		pResult->setCounter("udpReconnected", udpReconnected ? 1 : 0);
+		pResult->setCounter("ghostRemoved", ghostRemoved ? 1 : 0);
+	}
+
+	for (unsigned int i = 0; i < pServer->m_clientConnections.m_size; ++i)
+	{
+		NetworkContext &netContext = pServer->m_clientConnections[i];
+		if (netContext.getConnectionManager()->connected())
+			netContext.getConnectionManager()->disconnect();
+		delete netContext.getConnectionManager();
+		delete netContext.getStreamManager();
+		delete netContext.getEventManager();
+		delete netContext.getGhostManager();
+	}
+	delete pServer;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// ServerNetworkManager Lua Interface
+//////////////////////////////////////////////////////////////////////////
+//
+void ServerNetworkManager::SetLuaFunctions(PE::Components::LuaEnvironment *pLuaEnv, lua_State *luaVM)
+{
+	static const struct luaL_Reg l_functions[] = {
+		{"l_runSocketBenchmark", l_runSocketBenchmark},
+		{NULL, NULL} // sentinel
+	};
+
+	luaL_register(luaVM, 0, l_functions);
+}
+
+// root.PE.Components.ServerNetworkManager.l_runSocketBenchmark(256, 600, 10, 3)
+int ServerNetworkManager::l_runSocketBenchmark(lua_State *luaVM)
+{
+	int packetsPerReply = (int)(lua_tonumber(luaVM, -1));
+	int activePercent = (int)(lua_tonumber(luaVM, -2));
+	int numFrames = (int)(lua_tonumber(luaVM, -3));
+	int numClients = (int)(lua_tonumber(luaVM, -4));
+
+	lua_pop(luaVM, 4);
+
+	SocketPoller::RunLocalhostBenchmark(numClients, numFrames, activePercent, packetsPerReply);
+
+	return 0; // no return values
+}
+//////////////////////////////////////////////////////////////////////////
 
 #if 0 // template
 //////////////////////////////////////////////////////////////////////////
@@ -6,6 +6,8 @@
 
 // Outer-Engine includes
 #include <assert.h>
+#include <vector>
+#include <map>
 
 // Inter-Engine includes
 
@@ -14,9 +16,10 @@
 // Sibling/Children includes
 
 #include "PrimeEngine/Networking/NetworkManager.h"
+#include "PrimeEngine/Networking/SocketPoller.h"
 
 namespace PE {
-
+struct BenchmarkResult;
 namespace Components {
 
 
@@ -40,13 +43,41 @@ struct ServerNetworkManager : public NetworkManager
 
 	void serverOpenTCPSocket();
 
-	virtual void createNetworkConnectionContext(t_socket sock, int clientId, PE::NetworkContext *pNetContext);
+	// udp socket on same port as tcp. shared by all udp connections
+	void serverOpenUDPSocket();
+
+	// accepts all pending connections. called when poller reports listening socket readable
+	void acceptConnections();
+
+	// reads all pending datagrams and passes them to connection of sender address.
+	// unknown address gets a challenge for its connect request, connect request with cookie of challenge creates new connection
+	void receiveDatagrams();
+
+	// cookie of challenge for address, port. depends on secret picked when udp socket is opened
+	PrimitiveTypes::UInt32 udpConnectCookie(PrimitiveTypes::UInt32 addr, PrimitiveTypes::UInt16 port);
+
+	// pUdpPeerAddr is NULL for tcp connections. for udp connections sock is the shared udp socket
+	// slot of dead connection is reused with its connection and stream manager
+	virtual void createNetworkConnectionContext(t_socket sock, int clientId, PE::NetworkContext *pNetContext, const struct sockaddr_in *pUdpPeerAddr = NULL);
+
+	// first released slot of m_clientConnections, or new one. -1 if server is full. called with m_connectionsMutex locked
+	int acquireClientSlot();
+
+	// deletes event and ghost managers of connections that disconnected, which releases their slots. end of do_UPDATE().
+	// ghosts of released client (exceptClient of ghostToAllExcept()) are removed from all, then game object manager
+	// gets Event_SERVER_CLIENT_DISCONNECTED
+	void releaseDeadConnections();
 
 	void debugRender(int &threadOwnershipMask, float xoffset = 0, float yoffset = 0);
 
 	// forward to event manager
 	void scheduleEventToAllExcept(PE::Networkable *pNetworkable, PE::Networkable *pNetworkableTarget, int exceptClient);
 
+	// forward to ghost managers. clients that connect later get the ghost too.
+	// object is ghosted until removeGhostFromAll(), or until exceptClient (client that owns it) disconnects
+	void ghostToAllExcept(PE::Networkable *pNetworkable, int exceptClient);
+	void removeGhostFromAll(PE::Networkable *pNetworkable);
+
 
 	// Component ------------------------------------------------------------
 	virtual void addDefaultComponents();
@@ -57,13 +88,21 @@ struct ServerNetworkManager : public NetworkManager
 
 	// Loading -----------------------------------------------------------------
 
+	// Benchmark -----------------------------------------------------------------
+
+	// separate server on its own port: numClients localhost tcp clients connect and disconnect numRounds times.
+	// checks that slots of dead connections are reused, that udp connections are only created by connect handshake
+	// and that udp client can connect again from same address once its connection died, and that objects of a client
+	// stop being ghosted to others when it disconnects. optionally records into pResult
+	static void RunChurnBenchmark(PE::GameContext &context, PE::MemoryArena arena, int numClients, int numRounds, BenchmarkResult *pResult = NULL);
+
 	//////////////////////////////////////////////////////////////////////////
-	// Skin Lua Interface
+	// ServerNetworkManager Lua Interface
 	//////////////////////////////////////////////////////////////////////////
 	//
-	//static void SetLuaFunctions(PE::Components::LuaEnvironment *pLuaEnv, lua_State *luaVM);
+	static void SetLuaFunctions(PE::Components::LuaEnvironment *pLuaEnv, lua_State *luaVM);
 	//
-	//static int l_clientConnectToTCPServer(lua_State *luaVM);
+	static int l_runSocketBenchmark(lua_State *luaVM);
 	//
 	//////////////////////////////////////////////////////////////////////////
 
@@ -75,7 +114,23 @@ struct ServerNetworkManager : public NetworkManager
 	/*luasocket::*/t_socket m_sock;
 	EServerState m_state;
 
-	Array<NetworkContext> m_clientConnections;
+	Array<NetworkContext> m_clientConnections; // index is client id. released slots have no event manager
+	int m_numLiveConnections;
+
+	/*luasocket::*/t_socket m_udpSock;
+	bool m_udpOpen;
+	std::map<std::pair<PrimitiveTypes::UInt32, PrimitiveTypes::UInt16>, int> m_udpClients; // address, port -> client index
+	PrimitiveTypes::UInt32 m_udpCookieSecret;
+
+	// listening socket (user data NULL), udp socket (user data &m_udpSock) and tcp client sockets (user data NetworkContext *)
+	SocketPoller m_poller;
+
+	struct ServerGhost
+	{
+		PE::Networkable *m_pNetworkable;
+		int m_exceptClient;
+	};
+	std::vector<ServerGhost> m_ghosts;
 	Threading::Mutex m_connectionsMutex;
 };
 }; // namespace Components
@@ -0,0 +1,486 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+#include "SocketPoller.h"
+
+// Outer-Engine includes
+#include <vector>
+#include <string.h>
+
+#if PE_SOCKET_POLLER_USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#if !defined(_WIN32)
+#include <sys/uio.h>
+#endif
+
+// Inter-Engine includes
+#include "PrimeEngine/Utils/ErrorHandling.h"
+#include "PrimeEngine/APIAbstraction/Timer/Timer.h"
+#include "PrimeEngine/Profiling/Benchmark.h"
+
+extern "C"
+{
+#include "../../luasocket_dist/src/inet.h"
+};
+
+#include "../../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+SocketPoller::SocketPoller()
+{
+#if PE_SOCKET_POLLER_USE_EPOLL
+	m_epollFd = epoll_create1(0);
+	PEASSERT(m_epollFd >= 0, "Could not create epoll instance");
+#endif
+}
+
+SocketPoller::~SocketPoller()
+{
+#if PE_SOCKET_POLLER_USE_EPOLL
+	if (m_epollFd >= 0)
+		close(m_epollFd);
+#endif
+}
+
+bool SocketPoller::add(t_socket sock, void *pUserData)
+{
+	PEASSERT(m_sockets.find(sock) == m_sockets.end(), "Socket is already added to poller");
+
+#if PE_SOCKET_POLLER_USE_EPOLL
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.ptr = pUserData;
+	if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, sock, &ev) != 0)
+	{
+		PEINFO("PE: Warning: Could not add socket to epoll: %s\n", socket_strerror(errno));
+		return false;
+	}
+#else
+	if (m_sockets.size() >= FD_SETSIZE)
+	{
+		PEINFO("PE: Warning: Could not add socket to poller, FD_SETSIZE (%d) sockets already added\n", (int)(FD_SETSIZE));
+		return false;
+	}
+#endif
+
+	SocketData data;
+	data.m_pUserData = pUserData;
+	data.m_wantWrite = false;
+	m_sockets[sock] = data;
+	return true;
+}
+
+void SocketPoller::remove(t_socket sock)
+{
+	std::map<t_socket, SocketData>::iterator it = m_sockets.find(sock);
+	if (it == m_sockets.end())
+		return;
+
+#if PE_SOCKET_POLLER_USE_EPOLL
+	struct epoll_event ev; // ignored, but old kernels require non null
+	epoll_ctl(m_epollFd, EPOLL_CTL_DEL, sock, &ev);
+#endif
+
+	m_sockets.erase(it);
+}
+
+void SocketPoller::setWantWrite(t_socket sock, bool wantWrite)
+{
+	std::map<t_socket, SocketData>::iterator it = m_sockets.find(sock);
+	PEASSERT(it != m_sockets.end(), "Socket is not added to poller");
+
+	if (it->second.m_wantWrite == wantWrite)
+		return;
+	it->second.m_wantWrite = wantWrite;
+
+#if PE_SOCKET_POLLER_USE_EPOLL
+	struct epoll_event ev;
+	ev.events = EPOLLIN | (wantWrite ? EPOLLOUT : 0);
+	ev.data.ptr = it->second.m_pUserData;
+	epoll_ctl(m_epollFd, EPOLL_CTL_MOD, sock, &ev);
+#endif
+}
+
+int SocketPoller::wait(int timeoutMs, Event *out_events, int maxEvents)
+{
+	if (maxEvents <= 0)
+		return 0;
+
+#if PE_SOCKET_POLLER_USE_EPOLL
+	struct epoll_event evs[PE_SERVER_MAX_CONNECTIONS + 1];
+	if (maxEvents > PE_SERVER_MAX_CONNECTIONS + 1)
+		maxEvents = PE_SERVER_MAX_CONNECTIONS + 1;
+
+	int n;
+	do {
+		n = epoll_wait(m_epollFd, evs, maxEvents, timeoutMs);
+	} while (n < 0 && errno == EINTR);
+
+	if (n < 0)
+	{
+		PEINFO("PE: Warning: epoll_wait failed: %s\n", socket_strerror(errno));
+		return 0;
+	}
+
+	for (int i = 0; i < n; ++i)
+	{
+		out_events[i].m_pUserData = evs[i].data.ptr;
+		out_events[i].m_readable = (evs[i].events & EPOLLIN) != 0;
+		out_events[i].m_writable = (evs[i].events & EPOLLOUT) != 0;
+		out_events[i].m_error = (evs[i].events & (EPOLLERR | EPOLLHUP)) != 0;
+	}
+	return n;
+#else
+	if (m_sockets.empty())
+		return 0;
+
+	fd_set rfds, wfds, efds;
+	FD_ZERO(&rfds);
+	FD_ZERO(&wfds);
+	FD_ZERO(&efds);
+
+	t_socket maxSock = 0;
+	for (std::map<t_socket, SocketData>::iterator it = m_sockets.begin(); it != m_sockets.end(); ++it)
+	{
+		FD_SET(it->first, &rfds);
+		FD_SET(it->first, &efds);
+		if (it->second.m_wantWrite)
+			FD_SET(it->first, &wfds);
+		if (it->first > maxSock)
+			maxSock = it->first;
+	}
+
+	t_timeout timeout;
+	timeout.block = timeoutMs < 0 ? -1.0 : timeoutMs / 1000.0;
+	timeout.total = -1.0;
+	timeout_markstart(&timeout);
+
+	int ret = socket_select(maxSock + 1, &rfds, &wfds, &efds, &timeout);
+	if (ret <= 0)
+		return 0;
+
+	int n = 0;
+	for (std::map<t_socket, SocketData>::iterator it = m_sockets.begin(); it != m_sockets.end() && n < maxEvents; ++it)
+	{
+		bool readable = FD_ISSET(it->first, &rfds) != 0;
+		bool writable = FD_ISSET(it->first, &wfds) != 0;
+		bool error = FD_ISSET(it->first, &efds) != 0;
+		if (!readable && !writable && !error)
+			continue;
+
+		out_events[n].m_pUserData = it->second.m_pUserData;
+		out_events[n].m_readable = readable;
+		out_events[n].m_writable = writable;
+		out_events[n].m_error = error;
+		++n;
+	}
+	return n;
+#endif
+}
+
+int SocketPoller::SendGather(t_socket sock, const char * const *ppData, const int *sizes, int count, size_t *out_sent)
+{
+	*out_sent = 0;
+	if (count > PE_SOCKET_MAX_GATHER_BUFFERS)
+		count = PE_SOCKET_MAX_GATHER_BUFFERS;
+
+#if defined(_WIN32)
+	WSABUF bufs[PE_SOCKET_MAX_GATHER_BUFFERS];
+	for (int i = 0; i < count; ++i)
+	{
+		bufs[i].buf = (CHAR *)(ppData[i]);
+		bufs[i].len = (ULONG)(sizes[i]);
+	}
+
+	DWORD sent = 0;
+	if (WSASend(sock, bufs, (DWORD)(count), &sent, 0, NULL, NULL) == SOCKET_ERROR)
+	{
+		int err = WSAGetLastError();
+		return err == WSAEWOULDBLOCK ? IO_TIMEOUT : err;
+	}
+	*out_sent = sent;
+	return IO_DONE;
+#else
+	struct iovec iov[PE_SOCKET_MAX_GATHER_BUFFERS];
+	for (int i = 0; i < count; ++i)
+	{
+		iov[i].iov_base = (void *)(ppData[i]);
+		iov[i].iov_len = (size_t)(sizes[i]);
+	}
+
+	while (true)
+	{
+		ssize_t sent = writev(sock, iov, count); // SIGPIPE is ignored by socket_open()
+		if (sent >= 0)
+		{
+			*out_sent = (size_t)(sent);
+			return IO_DONE;
+		}
+		if (errno == EINTR)
+			continue;
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+			return IO_TIMEOUT;
+		return errno == EPIPE ? IO_CLOSED : errno;
+	}
+#endif
+}
+
+void SocketPoller::SetNoDelay(t_socket sock)
+{
+	int val = 1;
+	setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char *)(&val), sizeof(val));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+//////////////////////////////////////////////////////////////////////////
+
+#define PE_SOCKET_BENCHMARK_MESSAGE_SIZE 64
+
+struct SocketBenchmarkStats
+{
+	double m_seconds;
+	int m_bytesReceived;
+	int m_sendCalls;
+};
+
+// drains everything available on non-blocking socket. returns bytes received
+static int benchmarkDrain(t_socket *pSock, char *buf)
+{
+	t_timeout timeout;
+	timeout.block = 0;
+	timeout.total = -1.0;
+	timeout.start = 0;
+
+	int total = 0;
+	while (true)
+	{
+		size_t got = 0;
+		int err = socket_recv(pSock, buf, PE_SOCKET_RECEIVE_BUFFER_SIZE, &got, &timeout);
+		total += (int)(got);
+		if (err != IO_DONE)
+			break;
+	}
+	return total;
+}
+
+// what server does for one connection: receive, then reply if something was received
+static void benchmarkServe(t_socket *pSock, char *buf, const char *reply, int packetsPerReply, bool gather, SocketBenchmarkStats &stats)
+{
+	int got = benchmarkDrain(pSock, buf);
+	stats.m_bytesReceived += got;
+	if (!got || !packetsPerReply)
+		return;
+
+	t_timeout timeout;
+	timeout.block = 0;
+	timeout.total = -1.0;
+	timeout.start = 0;
+
+	if (gather)
+	{
+		const char *ppData[PE_SOCKET_MAX_GATHER_BUFFERS];
+		int sizes[PE_SOCKET_MAX_GATHER_BUFFERS];
+		for (int i = 0; i < packetsPerReply; ++i)
+		{
+			ppData[i] = reply;
+			sizes[i] = PE_SOCKET_BENCHMARK_MESSAGE_SIZE;
+		}
+		size_t sent;
+		SocketPoller::SendGather(*pSock, ppData, sizes, packetsPerReply, &sent);
+		++stats.m_sendCalls;
+	}
+	else
+	{
+		for (int i = 0; i < packetsPerReply; ++i)
+		{
+			size_t sent;
+			socket_send(pSock, reply, PE_SOCKET_BENCHMARK_MESSAGE_SIZE, &sent, &timeout);
+			++stats.m_sendCalls;
+		}
+	}
+}
+
+static void benchmarkRunFrames(std::vector<t_socket> &clientSocks, std::vector<t_socket> &serverSocks, SocketPoller *pPoller,
+	int numFrames, int activePercent, int packetsPerReply, SocketBenchmarkStats &stats)
+{
+	char buf[PE_SOCKET_RECEIVE_BUFFER_SIZE];
+	char message[PE_SOCKET_BENCHMARK_MESSAGE_SIZE];
+	memset(message, 0x5a, sizeof(message));
+
+	t_timeout timeout;
+	timeout.block = 0;
+	timeout.total = -1.0;
+	timeout.start = 0;
+
+	int numClients = (int)(clientSocks.size());
+	std::vector<SocketPoller::Event> events(numClients + 1);
+
+	stats.m_seconds = 0;
+	stats.m_bytesReceived = 0;
+	stats.m_sendCalls = 0;
+
+	Timer timer;
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		// clients send (not measured)
+		for (int i = 0; i < numClients; ++i)
+		{
+			if ((i * 37 + frame * 11) % 100 < activePercent)
+			{
+				size_t sent;
+				socket_send(&clientSocks[i], message, sizeof(message), &sent, &timeout);
+			}
+		}
+
+		// server update
+		Timer::TimeType t0 = timer.TickAndGetCurrentTime();
+
+		if (pPoller)
+		{
+			int n = pPoller->wait(0, &events[0], numClients);
+			for (int e = 0; e < n; ++e)
+				benchmarkServe((t_socket *)(events[e].m_pUserData), buf, message, packetsPerReply, true, stats);
+		}
+		else
+		{
+			for (int i = 0; i < numClients; ++i)
+				benchmarkServe(&serverSocks[i], buf, message, packetsPerReply, false, stats);
+		}
+
+		Timer::TimeType t1 = timer.TickAndGetCurrentTime();
+		stats.m_seconds += Timer::GetTimeDeltaInSeconds(t0, t1);
+
+		// clients receive replies (not measured)
+		for (int i = 0; i < numClients; ++i)
+			benchmarkDrain(&clientSocks[i], buf);
+	}
+
+	// anything that arrived after the last measured update
+	for (int i = 0; i < numClients; ++i)
+		stats.m_bytesReceived += benchmarkDrain(&serverSocks[i], buf);
+}
+
+void SocketPoller::RunLocalhostBenchmark(int numClients, int numFrames, int activePercent, int packetsPerReply, BenchmarkResult *pResult)
+{
+	if (numClients > PE_SERVER_MAX_CONNECTIONS)
+	{
+		PEINFO("PE: Socket benchmark: clamping %d clients to PE_SERVER_MAX_CONNECTIONS (%d)\n", numClients, PE_SERVER_MAX_CONNECTIONS);
+		numClients = PE_SERVER_MAX_CONNECTIONS;
+	}
+	if (packetsPerReply > PE_SOCKET_MAX_GATHER_BUFFERS)
+		packetsPerReply = PE_SOCKET_MAX_GATHER_BUFFERS;
+	if (packetsPerReply < 0)
+		packetsPerReply = 0;
+
+	t_socket listenSock;
+	const char *err = inet_trycreate(&listenSock, SOCK_STREAM);
+	if (!err)
+		err = inet_trybind(&listenSock, "127.0.0.1", 0); // any free port
+	if (!err)
+		err = inet_trylisten(&listenSock, numClients);
+	if (err)
+	{
+		PEINFO("PE: Socket benchmark: could not open listen socket: %s\n", err);
+		return;
+	}
+
+	struct sockaddr_in addr;
+	socklen_t addrLen = sizeof(addr);
+	getsockname(listenSock, (SA *)(&addr), &addrLen);
+	unsigned short port = ntohs(addr.sin_port);
+
+	t_timeout timeout;
+	timeout.block = 1.0;
+	timeout.total = -1.0;
+
+	std::vector<t_socket> clientSocks;
+	std::vector<t_socket> serverSocks;
+	for (int i = 0; i < numClients; ++i)
+	{
+		t_socket clientSock, serverSock;
+		if (inet_trycreate(&clientSock, SOCK_STREAM))
+			break;
+		socket_setnonblocking(&clientSock);
+
+		timeout_markstart(&timeout);
+		if (inet_tryconnect(&clientSock, "127.0.0.1", port, &timeout))
+		{
+			socket_destroy(&clientSock);
+			break;
+		}
+
+		timeout_markstart(&timeout);
+		if (socket_accept(&listenSock, &serverSock, NULL, NULL, &timeout) != IO_DONE)
+		{
+			socket_destroy(&clientSock);
+			break;
+		}
+		socket_setnonblocking(&serverSock);
+
+		// like ConnectionManager. otherwise nagle defers small sends to after the measured update
+		SocketPoller::SetNoDelay(serverSock);
+		SocketPoller::SetNoDelay(clientSock);
+
+		clientSocks.push_back(clientSock);
+		serverSocks.push_back(serverSock);
+	}
+	socket_destroy(&listenSock);
+
+	if ((int)(clientSocks.size()) < numClients)
+		PEINFO("PE: Socket benchmark: only %d of %d connections opened (file descriptor limit?)\n", (int)(clientSocks.size()), numClients);
+	numClients = (int)(clientSocks.size());
+
+	if (numClients)
+	{
+		SocketPoller poller;
+		for (int i = 0; i < numClients; ++i)
+			poller.add(serverSocks[i], &serverSocks[i]);
+
+		SocketBenchmarkStats idlePolling, idlePoller, loadPolling, loadPoller;
+		benchmarkRunFrames(clientSocks, serverSocks, NULL, numFrames, 0, packetsPerReply, idlePolling);
+		benchmarkRunFrames(clientSocks, serverSocks, &poller, numFrames, 0, packetsPerReply, idlePoller);
+		benchmarkRunFrames(clientSocks, serverSocks, NULL, numFrames, activePercent, packetsPerReply, loadPolling);
+		benchmarkRunFrames(clientSocks, serverSocks, &poller, numFrames, activePercent, packetsPerReply, loadPoller);
+
+		double usPerFrame = 1.0e6 / numFrames;
+		PEINFO("PE: Socket benchmark: %d localhost clients, %d frames, %s\n", numClients, numFrames, PE_SOCKET_POLLER_USE_EPOLL ? "epoll" : "select");
+		PEINFO("PE:   idle: per-connection polling %.1f us/frame, poller %.1f us/frame\n",
+			idlePolling.m_seconds * usPerFrame, idlePoller.m_seconds * usPerFrame);
+		PEINFO("PE:   %d%% clients active, %d packets per reply: per-connection polling %.1f us/frame (%d sends), poller + gather %.1f us/frame (%d sends)\n",
+			activePercent, packetsPerReply,
+			loadPolling.m_seconds * usPerFrame, loadPolling.m_sendCalls,
+			loadPoller.m_seconds * usPerFrame, loadPoller.m_sendCalls);
+		PEASSERT(loadPolling.m_bytesReceived == loadPoller.m_bytesReceived, "Poller missed data: %d vs %d bytes", loadPoller.m_bytesReceived, loadPolling.m_bytesReceived);
+
+		if (pResult)
+		{
+			pResult->m_ok = loadPolling.m_bytesReceived == loadPoller.m_bytesReceived;
+			pResult->m_numFrames = numFrames;
+			pResult->m_runTime = idlePolling.m_seconds + idlePoller.m_seconds + loadPolling.m_seconds + loadPoller.m_seconds;
+			pResult->setCounter("connections", numClients);
+			pResult->setCounter("idlePollingUsPerFrame", idlePolling.m_seconds * usPerFrame);
+			pResult->setCounter("idlePollerUsPerFrame", idlePoller.m_seconds * usPerFrame);
+			pResult->setCounter("loadPollingUsPerFrame", loadPolling.m_seconds * usPerFrame);
+			pResult->setCounter("loadPollerUsPerFrame", loadPoller.m_seconds * usPerFrame);
+			pResult->setCounter("loadPollingSends", loadPolling.m_sendCalls);
+			pResult->setCounter("loadPollerSends", loadPoller.m_sendCalls);
+		}
+	}
+	else if (pResult)
+		pResult->m_ok = false;
+
+	for (int i = 0; i < numClients; ++i)
+	{
+		socket_destroy(&clientSocks[i]);
+		socket_destroy(&serverSocks[i]);
+	}
+}
+
+}; // namespace PE
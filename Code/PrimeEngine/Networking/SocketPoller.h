@@ -0,0 +1,91 @@
+#ifndef __PrimeEngineSocketPoller_H__
+#define __PrimeEngineSocketPoller_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <assert.h>
+#include <map>
+
+// Inter-Engine includes
+
+extern "C"
+{
+#include "../../luasocket_dist/src/socket.h"
+};
+
+// Sibling/Children includes
+
+// epoll scales with number of ready sockets, select() with number of registered sockets
+// and is limited by FD_SETSIZE (64 on windows)
+#if defined(__linux__)
+#define PE_SOCKET_POLLER_USE_EPOLL 1
+#else
+#define PE_SOCKET_POLLER_USE_EPOLL 0
+#endif
+
+// max buffers sent with one gather write (writev/WSASend)
+#define PE_SOCKET_MAX_GATHER_BUFFERS 64
+
+namespace PE {
+
+struct BenchmarkResult;
+
+// Readiness based socket I/O: all registered sockets are waited on with one call
+// and only sockets that are ready are returned, so idle connections cost nothing per update.
+// Sockets should be non-blocking, the poller only reports readiness.
+struct SocketPoller
+{
+	struct Event
+	{
+		void *m_pUserData; // as passed to add()
+		bool m_readable; // data or incoming connection (or eof, recv will report it)
+		bool m_writable;
+		bool m_error; // error or hangup. recv/send will return the error
+	};
+
+	SocketPoller();
+	~SocketPoller();
+
+	bool add(t_socket sock, void *pUserData);
+	void remove(t_socket sock);
+
+	// writable events are only reported for sockets that want them.
+	// set when send would block and clear once everything is sent, otherwise wait() returns immediately
+	void setWantWrite(t_socket sock, bool wantWrite);
+
+	// returns number of events written. timeoutMs 0 doesn't block, < 0 blocks until something is ready
+	int wait(int timeoutMs, Event *out_events, int maxEvents);
+
+	int getNumSockets() const {return (int)(m_sockets.size());}
+
+	// sends count buffers with one system call (writev/WSASend) without blocking.
+	// returns IO_DONE if something was sent, IO_TIMEOUT if socket buffer is full, or error
+	static int SendGather(t_socket sock, const char * const *ppData, const int *sizes, int count, size_t *out_sent);
+
+	// disables nagle. packets of one update are already sent with one gather write, so waiting
+	// for more data only adds latency
+	static void SetNoDelay(t_socket sock);
+
+	// opens numClients localhost tcp connections and compares server update cost of
+	// polling every connection with non-blocking recv/send against waiting on poller and servicing ready sockets only.
+	// each frame activePercent of clients send a packet and server replies with packetsPerReply packets (0 for receive only).
+	// optionally records per frame costs as counters of pResult
+	static void RunLocalhostBenchmark(int numClients, int numFrames, int activePercent, int packetsPerReply, BenchmarkResult *pResult = NULL);
+
+	struct SocketData
+	{
+		void *m_pUserData;
+		bool m_wantWrite;
+	};
+
+	std::map<t_socket, SocketData> m_sockets;
+
+#if PE_SOCKET_POLLER_USE_EPOLL
+	int m_epollFd;
+#endif
+};
+
+}; // namespace PE
+#endif
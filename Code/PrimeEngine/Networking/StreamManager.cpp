@@ -22,6 +22,8 @@ extern "C"
 
 // Sibling/Children includes
 #include "EventManager.h"
+#include "GhostManager.h"
+#include "BitStream.h"
 #include "ConnectionManager.h"
 
 #if APIABSTRACTION_PS3
@@ -39,10 +41,9 @@ PE_IMPLEMENT_CLASS1(StreamManager, Component);
 
 StreamManager::StreamManager(PE::GameContext &context, PE::MemoryArena arena, PE::NetworkContext &netContext, Handle hMyself)
 : Component(context, arena, hMyself)
-, m_transmissionRecords(1024)
 {
-	m_nextIdToTransmit = 0;
 	m_pNetContext = &netContext;
+	reset();
 }
 
 StreamManager::~StreamManager()
@@ -55,20 +56,35 @@ void StreamManager::initialize()
 
 }
 
+void StreamManager::reset()
+{
+	m_transmissionRecords.clear();
+	m_firstIdNotYetReceived = 0;
+	m_nextIdToTransmit = 0;
+	m_nextIdToBeAcknowledged = 0;
+}
+
 
 void StreamManager::sendNextPackets()
 {
+	GhostManager *pGhostManager = m_pNetContext->getGhostManager();
+
+	// ghost state is packed and diffed once per update
+	pGhostManager->prepareToSend();
+
+	// udp packets are kept under MTU
+	int maxPacketSize = m_pNetContext->getConnectionManager()->getMaxPacketSize();
+
     while (true)
     {
         int size = PE_PACKET_HEADER; // space for size
-        int sizeLeft = PE_PACKET_TOTAL_SIZE - size;
+        int sizeLeft = maxPacketSize - size;
 
         // allocate data for next packet
 	
         int numEvents = m_pNetContext->getEventManager()->haveEventsToSend();
 
-        //todo: other managers
-        int numGhosts = 0;
+        int numGhosts = pGhostManager->haveGhostsToSend();
 
         if (numEvents || numGhosts) //todo: other managers
         {
@@ -82,8 +98,15 @@ void StreamManager::sendNextPackets()
             bool wantToSendMoreEvents = false;
             //event manager
             {
-                sizeLeft = PE_PACKET_TOTAL_SIZE - size;
-                size += m_pNetContext->getEventManager()->fillInNextPacket(&pPacket->m_data[size], &record, sizeLeft, usefulEventDataSent, wantToSendMoreEvents);
+                if (numEvents)
+                {
+                    sizeLeft = maxPacketSize - size - 4; // leave space for number of ghosts
+                    size += m_pNetContext->getEventManager()->fillInNextPacket(&pPacket->m_data[size], &record, sizeLeft, usefulEventDataSent, wantToSendMoreEvents);
+                }
+                else
+                {
+                    size += StreamManager::WriteVarUInt32(0, &pPacket->m_data[size]); // no events
+                }
             }
 
             //other managers fillin here
@@ -91,14 +114,14 @@ void StreamManager::sendNextPackets()
             bool usefulGhostDataSent = false;
             bool wantToSendMoreGhosts = false;
             
-            // ghost manager
+            // ghost manager: fills whatever space events left
             {
-                sizeLeft = PE_PACKET_TOTAL_SIZE - size;
-                size += 0;//m_pNetContext->getEventManager()->fillInNextPacket(&pPacket->m_data[size], &record, sizeLeft, usefulGhostDataSent, wantToSendMoreGhosts);
+                sizeLeft = maxPacketSize - size;
+                size += pGhostManager->fillInNextPacket(&pPacket->m_data[size], &record, sizeLeft, usefulGhostDataSent, wantToSendMoreGhosts);
             }
 
             assert(size > PE_PACKET_HEADER);// we should have filled in something!
-            if (size > PE_PACKET_HEADER)
+            if (usefulEventDataSent || usefulGhostDataSent)
             {
                 StreamManager::WriteInt32(size, &pPacket->m_data[0] /*= &pPacket->m_packetDataSizeInInet*/); // header was allocated in the beginning
                 record.m_id = ++m_nextIdToTransmit;
@@ -129,6 +152,8 @@ void StreamManager::processNotification(bool delivered)
 
 
 	m_pNetContext->getEventManager()->processNotification(&record, delivered);
+
+	m_pNetContext->getGhostManager()->processNotification(&record, delivered);
 	
     // todo: other managers here..
 
@@ -138,7 +163,14 @@ void StreamManager::processNotification(bool delivered)
 
 void StreamManager::do_UPDATE(Events::Event *pEvt)
 {
+	// dead connection, its event and ghost managers may be released already
+	if (!m_pNetContext->getConnectionManager()->connected())
+		return;
+
 	sendNextPackets();
+
+	// all packets of this update go out with one gather write
+	m_pNetContext->getConnectionManager()->flushSendQueue();
 }
 
 void StreamManager::addDefaultComponents()
@@ -205,6 +237,9 @@ void StreamManager::receivePacket(Packet *pPacket)
 	// events are packed first
 	read += m_pNetContext->getEventManager()->receiveNextPacket(&pPacket->m_data[read]);
 
+	// then ghosts
+	read += m_pNetContext->getGhostManager()->receiveNextPacket(&pPacket->m_data[read]);
+
 	assert(packetSize == read);
 }
 
@@ -308,15 +343,66 @@ int StreamManager::ReadMatrix4x4(char *pDataStream, Matrix4x4 &out_v)
 	return read;
 }
 
+int StreamManager::WriteVarUInt32(PrimitiveTypes::UInt32 v, char *pDataStream)
+{
+	BitStreamWriter w(pDataStream, 5);
+	w.writeVarUInt32(v);
+	return w.getSize();
+}
+
+int StreamManager::ReadVarUInt32(char *pDataStream, PrimitiveTypes::UInt32 &out_v)
+{
+	BitStreamReader r(pDataStream);
+	out_v = r.readVarUInt32();
+	return r.getSize();
+}
+
+int StreamManager::GetVarUInt32Size(PrimitiveTypes::UInt32 v)
+{
+	int size = 1;
+	for (; v >= 0x80; v >>= 7)
+		++size;
+	return size;
+}
+
+int StreamManager::WriteVarInt32(PrimitiveTypes::Int32 v, char *pDataStream)
+{
+	BitStreamWriter w(pDataStream, 5);
+	w.writeVarInt32(v);
+	return w.getSize();
+}
+
+int StreamManager::ReadVarInt32(char *pDataStream, PrimitiveTypes::Int32 &out_v)
+{
+	BitStreamReader r(pDataStream);
+	out_v = r.readVarInt32();
+	return r.getSize();
+}
+
+int StreamManager::WriteTransform(const Matrix4x4 &v, char *pDataStream)
+{
+	BitStreamWriter w(pDataStream, 16);
+	w.writeTransform(v);
+	return w.getSize();
+}
+
+int StreamManager::ReadTransform(char *pDataStream, Matrix4x4 &out_v)
+{
+	BitStreamReader r(pDataStream);
+	r.readTransform(out_v);
+	return r.getSize();
+}
+
 int StreamManager::WriteNetworkId(Networkable::NetworkId v, char *pDataStream)
 {
-	return WriteInt32(v, pDataStream);
+	// preassigned ids are small and dynamic ones start at 1000, so 1-2 bytes
+	return WriteVarUInt32(v, pDataStream);
 }
 
 int StreamManager::ReadNetworkId(char *pDataStream, Networkable::NetworkId &out_v)
 {
-	PrimitiveTypes::Int32 v;
-	int res = ReadInt32(pDataStream, v);
+	PrimitiveTypes::UInt32 v;
+	int res = ReadVarUInt32(pDataStream, v);
 	out_v = v;
 	return res;
 }
@@ -40,6 +40,9 @@ struct StreamManager : public Component
 	// Methods -----------------------------------------------------------------
 	virtual void initialize();
 
+	// forgets transmission records and ids. server reuses stream managers of dead connections
+	void reset();
+
 	void sendNextPackets();
 
 	void receivePacket(Packet *pPacket);
@@ -58,6 +61,18 @@ struct StreamManager : public Component
 	static int WriteMatrix4x4(const Matrix4x4 &v, char *pDataStream);
 	static int ReadMatrix4x4(char *pDataStream, Matrix4x4 &out_v);
 
+	// variable length (1 byte for < 128, see BitStream.h)
+	static int WriteVarUInt32(PrimitiveTypes::UInt32 v, char *pDataStream);
+	static int ReadVarUInt32(char *pDataStream, PrimitiveTypes::UInt32 &out_v);
+	static int GetVarUInt32Size(PrimitiveTypes::UInt32 v);
+
+	static int WriteVarInt32(PrimitiveTypes::Int32 v, char *pDataStream);
+	static int ReadVarInt32(char *pDataStream, PrimitiveTypes::Int32 &out_v);
+
+	// quantized position + smallest three quaternion, 12 bytes instead of 64 for WriteMatrix4x4
+	static int WriteTransform(const Matrix4x4 &v, char *pDataStream);
+	static int ReadTransform(char *pDataStream, Matrix4x4 &out_v);
+
 	static int WriteNetworkId(Networkable::NetworkId v, char *pDataStream);
 	static int ReadNetworkId(char *pDataStream, Networkable::NetworkId &out_v);
 
@@ -22,6 +22,7 @@
 #include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
 #include "PrimeEngine/MainFunction/MainFunctionArgs.h"
 #include "PrimeEngine/FileSystem/FileReader.h"
+#include "PrimeEngine/FileSystem/HotReloadManager.h"
 #include "PrimeEngine/Geometry/PositionBufferCPU/PositionBufferCPU.h"
 #include "PrimeEngine/Geometry/IndexBufferCPU/IndexBufferCPU.h"
 #include "PrimeEngine/APIAbstraction/GPUBuffers/VertexBufferGPUManager.h"
@@ -52,6 +53,7 @@
 #include "Networking/Server/ServerConnectionManager.h"
 #include "Networking/StreamManager.h"
 #include "Networking/EventManager.h"
+#include "Networking/GhostManager.h"
 
 
 #include "PrimeEngine/APIAbstraction/Input/Input.h"
@@ -65,6 +67,7 @@
 
 #include "Logging/Log.h"
 #include "Profiling/Profiling.h"
+#include "Jobs/JobSystem.h"
 #include "Game/Common/GlobalRegistry.h"
 
 
@@ -92,6 +95,8 @@
 #include "Scene/LineMesh.h"
 #include "Scene/DefaultAnimationSM.h"
 #include "Scene/RootSceneNode.h"
+#include "Scene/LightClusters.h"
+#include "Scene/TextBatcher.h"
 #include "Scene/CameraSceneNode.h"
 #include "Scene/TextSceneNode.h"
 #include "Scene/InstancingSceneNode.h"
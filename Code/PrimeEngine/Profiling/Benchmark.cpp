@@ -0,0 +1,473 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+#include "Benchmark.h"
+
+// Outer-Engine includes
+#include <string.h>
+#include <algorithm>
+#include <time.h>
+
+#if PE_PLAT_IS_LINUX
+#include <sys/resource.h>
+#endif
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/MemoryManager.h"
+#include "PrimeEngine/Game/Common/GlobalRegistry.h"
+#include "PrimeEngine/Game/Server/ServerGame.h"
+#include "PrimeEngine/Lua/Server/ServerLuaEnvironment.h"
+#include "PrimeEngine/Logging/Log.h"
+#include "PrimeEngine/GameObjectModel/GameObjectManager.h"
+#include "PrimeEngine/Networking/Server/ServerNetworkManager.h"
+#include "PrimeEngine/Networking/ConnectionManager.h"
+#include "PrimeEngine/Networking/GhostManager.h"
+#include "PrimeEngine/Networking/SocketPoller.h"
+#include "PrimeEngine/Geometry/PositionBufferCPU/PositionBufferCPUManager.h"
+#include "PrimeEngine/Geometry/NormalBufferCPU/NormalBufferCPUManager.h"
+#include "PrimeEngine/Geometry/TexCoordBufferCPU/TexCoordBufferCPUManager.h"
+#include "PrimeEngine/MainFunction/MainFunctionArgs.h"
+#include "PrimeEngine/Scene/PhysicsManager.h"
+#include "PrimeEngine/Jobs/JobSystem.h"
+#include "PrimeEngine/Geometry/MaterialCPU/MaterialCPU.h"
+#include "PrimeEngine/APIAbstraction/Texture/SamplerState.h"
+#include "PrimeEngine/APIAbstraction/Effect/PEAlphaBlendState.h"
+#include "PrimeEngine/APIAbstraction/Effect/PERasterizerState.h"
+#include "PrimeEngine/APIAbstraction/Effect/PEDepthStencilState.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+using namespace Components;
+
+PrimitiveTypes::UInt32 Benchmark::s_random = 1;
+
+//////////////////////////////////////////////////////////////////////////
+// BenchmarkResult
+//////////////////////////////////////////////////////////////////////////
+
+static void getPoolUsage(PrimitiveTypes::UInt32 &bytes, PrimitiveTypes::UInt32 &blocks)
+{
+	bytes = blocks = 0;
+	for (unsigned int i = 0; i < N_MEMORY_POOLS; i++)
+	{
+		MemoryPool *pPool = MemoryManager::instance()->m_memoryPools[i * 4];
+		PrimitiveTypes::UInt32 used = pPool->getNumBlocks() - pPool->getNumFreeBlocks();
+		bytes += used * pPool->getBlockSize();
+		blocks += used;
+	}
+}
+
+BenchmarkResult::BenchmarkResult(const char *name, const char *type)
+: m_name(name)
+, m_type(type)
+, m_ok(true)
+, m_numFrames(0)
+, m_setupTime(0)
+, m_runTime(0)
+, m_poolBlocksPeak(0)
+{
+	getPoolUsage(m_poolBytesAtStart, m_poolBlocksPeak);
+	m_poolBytesAtEnd = m_poolBytesPeak = m_poolBytesAtStart;
+}
+
+void BenchmarkResult::addTiming(const char *subsystem, double seconds)
+{
+	for (unsigned int i = 0; i < m_timings.size(); ++i)
+	{
+		if (m_timings[i].m_name == subsystem)
+		{
+			m_timings[i].m_samples.push_back((float)(seconds));
+			return;
+		}
+	}
+	m_timings.push_back(Timing());
+	m_timings.back().m_name = subsystem;
+	m_timings.back().m_samples.push_back((float)(seconds));
+}
+
+static void setValue(std::vector<BenchmarkResult::Value> &values, const char *name, double value)
+{
+	for (unsigned int i = 0; i < values.size(); ++i)
+	{
+		if (values[i].m_name == name)
+		{
+			values[i].m_value = value;
+			return;
+		}
+	}
+	BenchmarkResult::Value v;
+	v.m_name = name;
+	v.m_value = value;
+	values.push_back(v);
+}
+
+void BenchmarkResult::setCounter(const char *name, double value)
+{
+	setValue(m_counters, name, value);
+}
+
+void BenchmarkResult::setParam(const char *name, double value)
+{
+	setValue(m_params, name, value);
+}
+
+void BenchmarkResult::sampleMemory()
+{
+	PrimitiveTypes::UInt32 blocks;
+	getPoolUsage(m_poolBytesAtEnd, blocks);
+	m_poolBytesPeak = m_poolBytesAtEnd > m_poolBytesPeak ? m_poolBytesAtEnd : m_poolBytesPeak;
+	m_poolBlocksPeak = blocks > m_poolBlocksPeak ? blocks : m_poolBlocksPeak;
+}
+
+// names are identifiers and asset names, only quotes and backslashes need escaping
+static void writeJsonString(FILE *f, const char *str)
+{
+	fputc('"', f);
+	for (const char *c = str; *c; ++c)
+	{
+		if (*c == '"' || *c == '\\')
+			fputc('\\', f);
+		if ((unsigned char)(*c) >= 0x20)
+			fputc(*c, f);
+	}
+	fputc('"', f);
+}
+
+static void writeJsonValues(FILE *f, const char *key, const std::vector<BenchmarkResult::Value> &values)
+{
+	fprintf(f, "      \"%s\": {", key);
+	for (unsigned int i = 0; i < values.size(); ++i)
+	{
+		fprintf(f, "%s", i ? ", " : "");
+		writeJsonString(f, values[i].m_name.c_str());
+		fprintf(f, ": %.9g", values[i].m_value);
+	}
+	fprintf(f, "},\n");
+}
+
+void BenchmarkResult::writeJson(FILE *f)
+{
+	fprintf(f, "    {\n");
+	fprintf(f, "      \"name\": ");
+	writeJsonString(f, m_name.c_str());
+	fprintf(f, ",\n      \"type\": ");
+	writeJsonString(f, m_type.c_str());
+	fprintf(f, ",\n      \"ok\": %s,\n", m_ok ? "true" : "false");
+	fprintf(f, "      \"frames\": %d,\n", m_numFrames);
+	fprintf(f, "      \"setupMs\": %.4f,\n", m_setupTime * 1000.0);
+	fprintf(f, "      \"runMs\": %.4f,\n", m_runTime * 1000.0);
+	writeJsonValues(f, "params", m_params);
+	writeJsonValues(f, "counters", m_counters);
+
+	// per subsystem frame time distribution in ms
+	fprintf(f, "      \"timings\": {");
+	for (unsigned int i = 0; i < m_timings.size(); ++i)
+	{
+		std::vector<float> sorted = m_timings[i].m_samples;
+		std::sort(sorted.begin(), sorted.end());
+		int n = (int)(sorted.size());
+		double total = 0;
+		for (int j = 0; j < n; ++j)
+			total += sorted[j];
+
+		fprintf(f, "%s\n        ", i ? "," : "");
+		writeJsonString(f, m_timings[i].m_name.c_str());
+		fprintf(f, ": {\"samples\": %d, \"totalMs\": %.4f, \"avgMs\": %.5f, \"minMs\": %.5f, \"p50Ms\": %.5f, \"p95Ms\": %.5f, \"maxMs\": %.5f}",
+			n, total * 1000.0, total * 1000.0 / n, sorted[0] * 1000.0, sorted[n / 2] * 1000.0, sorted[n * 95 / 100] * 1000.0, sorted[n - 1] * 1000.0);
+	}
+	fprintf(f, "%s},\n", m_timings.size() ? "\n      " : "");
+
+	fprintf(f, "      \"memory\": {\"poolBytesAtStart\": %u, \"poolBytesAtEnd\": %u, \"poolBytesPeak\": %u, \"poolBlocksPeak\": %u}\n",
+		m_poolBytesAtStart, m_poolBytesAtEnd, m_poolBytesPeak, m_poolBlocksPeak);
+	fprintf(f, "    }");
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+//////////////////////////////////////////////////////////////////////////
+
+int Benchmark::initEngine(PE::GameContext &context, PE::MemoryArena arena, const char *lpCmdLine)
+{
+	AsyncLog::Start(NULL);
+	PEINFO("Benchmark: Benchmark::initEngine()\n");
+
+	MemoryManager::Construct();
+
+	#if PE_PLAT_IS_WIN32
+		context.m_pMPArgs = new(arena) MainFunctionArgs(context, arena, lpCmdLine, GetModuleHandle(NULL));
+	#else
+		context.m_pMPArgs = new(arena) MainFunctionArgs(context, arena, lpCmdLine);
+	#endif
+
+	context.m_pLuaEnv = new(arena) ServerLuaEnvironment(context, arena, Handle());
+	context.getLuaEnvironment()->registerInitialLibrariesFunctions();
+	// server environment does not load materials, but scenarios read meshes on cpu (like ClientGame::initEngine())
+	MaterialCPU::SetLuaFunctions(context.getLuaEnvironment(), context.getLuaEnvironment()->L);
+	context.getLuaEnvironment()->run();
+	context.getLuaEnvironment()->runString("require \"MaterialLoader\"");
+
+	PE::Register(context.getLuaEnvironment(), PE::GlobalRegistry::Instance());
+
+	{
+		context.m_pLog = new(arena) Log(context, arena, Handle());
+		context.getLog()->addDefaultComponents();
+	}
+
+	context.getLuaEnvironment()->addDefaultComponents();
+
+	// network manager is needed by network benchmarks (networkable registry), but server does not listen
+	{
+		context.m_pNetworkManager = new (arena) ServerNetworkManager(context, arena, Handle());
+		context.getNetworkManager()->addDefaultComponents();
+	}
+	context.getLuaEnvironment()->m_networkId = Networkable::s_NetworkId_LuaEnvironment;
+	context.getLuaEnvironment()->registerWithNetwork(context.getNetworkManager());
+
+	{
+		context.m_pGameObjectManager = new(arena) GameObjectManager(context, arena, Handle());
+		context.getGameObjectManager()->addDefaultComponents();
+	}
+
+	// cpu side of asset loading
+	PositionBufferCPUManager::Construct(context, arena);
+	NormalBufferCPUManager::Construct(context, arena);
+	TexCoordBufferCPUManager::Construct(context, arena);
+
+	// navmesh obstacle queries and physics scenario use it
+	PhysicsManager::Construct(context, arena);
+
+	Timer::Initialize();
+
+	// physics runs its collision phase as parallelFor
+	JobSystem::Construct(arena);
+
+	// pipeline state objects, without api objects on headless. renderstate scenario binds them
+	SamplerStateManager::ConstructAndInitialize(context, arena);
+	RenderStateCache::Construct(arena);
+	PERasterizerStateManager::ConstructAndInitialize(context, arena);
+	PEAlphaBlendStateManager::ConstructAndInitialize(context, arena);
+	PEDepthStencilStateManager::ConstructAndInitialize(context, arena);
+
+	PE::GlobalRegistry::Instance()->setInitialized(true);
+	return 1;
+}
+
+double Benchmark::GetNumberParam(PE::GameContext &context, BenchmarkResult &result, const char *name, double defaultValue)
+{
+	lua_State *L = context.getLuaEnvironment()->L;
+	lua_getfield(L, -1, name);
+	double value = lua_isnumber(L, -1) ? lua_tonumber(L, -1) : defaultValue;
+	lua_pop(L, 1);
+
+	result.setParam(name, value);
+	return value;
+}
+
+const char *Benchmark::GetStringParam(PE::GameContext &context, const char *name, const char *defaultValue)
+{
+	lua_State *L = context.getLuaEnvironment()->L;
+	lua_getfield(L, -1, name);
+	// string stays valid while scenario table is on stack
+	const char *value = lua_isstring(L, -1) ? lua_tostring(L, -1) : defaultValue;
+	lua_pop(L, 1);
+	return value;
+}
+
+void Benchmark::Seed(PrimitiveTypes::UInt32 seed)
+{
+	s_random = seed;
+}
+
+PrimitiveTypes::UInt32 Benchmark::Random()
+{
+	s_random = s_random * 1103515245 + 12345;
+	return (s_random >> 16) & 0x7fff;
+}
+
+float Benchmark::RandomFloat(float min, float max)
+{
+	return min + (max - min) * (float)(Random()) / 32767.0f;
+}
+
+bool Benchmark::runScenarioScript(PE::GameContext &context, PE::MemoryArena arena, const char *scriptWorkspacePath,
+	const char *filter, std::vector<BenchmarkResult *> &results)
+{
+	LuaEnvironment *pLuaEnv = context.getLuaEnvironment();
+	if (!pLuaEnv->runScriptWorkspacePath(scriptWorkspacePath))
+	{
+		PEINFO("Benchmark: could not run scenario script %s\n", scriptWorkspacePath);
+		return false;
+	}
+
+	lua_State *L = pLuaEnv->L;
+	lua_getglobal(L, "Scenarios");
+	if (!lua_istable(L, -1))
+	{
+		PEINFO("Benchmark: %s has to define table 'Scenarios'\n", scriptWorkspacePath);
+		lua_pop(L, 1);
+		return false;
+	}
+
+	int numScenarios = (int)(lua_objlen(L, -1));
+	for (int i = 1; i <= numScenarios; ++i)
+	{
+		lua_rawgeti(L, -1, i);
+		if (!lua_istable(L, -1))
+		{
+			lua_pop(L, 1);
+			continue;
+		}
+
+		const char *name = GetStringParam(context, "name", "");
+		const char *type = GetStringParam(context, "type", "");
+		if (filter && !strstr(name, filter))
+		{
+			lua_pop(L, 1);
+			continue;
+		}
+
+		PEINFO("Benchmark: running scenario %s (%s)\n", name, type);
+
+		BenchmarkResult *pResult = new BenchmarkResult(name, type);
+		Seed((PrimitiveTypes::UInt32)(GetNumberParam(context, *pResult, "seed", 1)));
+
+		Timer timer;
+		if (strcmp(type, "navmesh") == 0)
+			RunNavmeshScenario(context, arena, *pResult);
+		else if (strcmp(type, "physics") == 0)
+			RunPhysicsScenario(context, arena, *pResult);
+		else if (strcmp(type, "skinning") == 0)
+			RunSkinningScenario(context, arena, *pResult);
+		else if (strcmp(type, "particles") == 0)
+			RunParticlesScenario(context, arena, *pResult);
+		else if (strcmp(type, "renderstate") == 0)
+			RunRenderStateScenario(context, arena, *pResult);
+		else if (strcmp(type, "constants") == 0)
+			RunConstantsScenario(context, arena, *pResult);
+		else if (strcmp(type, "lights") == 0)
+			RunLightsScenario(context, arena, *pResult);
+		else if (strcmp(type, "log") == 0)
+			RunLogScenario(context, arena, *pResult);
+		else if (strcmp(type, "text") == 0)
+			RunTextScenario(context, arena, *pResult);
+		else if (strcmp(type, "hotreload") == 0)
+			RunHotReloadScenario(context, arena, *pResult);
+		else if (strcmp(type, "lua") == 0)
+			RunLuaScenario(context, arena, *pResult);
+		else if (strcmp(type, "crowd") == 0)
+			RunCrowdScenario(context, arena, *pResult);
+		else if (strcmp(type, "level") == 0)
+			RunLevelScenario(context, arena, *pResult);
+		else if (strcmp(type, "ghosts") == 0)
+		{
+			int numClients = (int)(GetNumberParam(context, *pResult, "clients", 32));
+			int numObjects = (int)(GetNumberParam(context, *pResult, "objects", 64));
+			int numFrames = (int)(GetNumberParam(context, *pResult, "frames", 600));
+			GhostManager::RunLoopbackBenchmark(context, arena, numClients, numObjects, numFrames, pResult);
+		}
+		else if (strcmp(type, "udp") == 0)
+		{
+			int numFrames = (int)(GetNumberParam(context, *pResult, "frames", 600));
+			int lossPercent = (int)(GetNumberParam(context, *pResult, "loss", 10));
+			float latency = (float)(GetNumberParam(context, *pResult, "latency", 50)) / 1000.0f; // ms
+			float jitter = (float)(GetNumberParam(context, *pResult, "jitter", 10)) / 1000.0f;
+			ConnectionManager::RunUdpLoopbackBenchmark(context, arena, numFrames, lossPercent, latency, jitter, pResult);
+		}
+		else if (strcmp(type, "sockets") == 0)
+		{
+			int numClients = (int)(GetNumberParam(context, *pResult, "clients", 256));
+			int numFrames = (int)(GetNumberParam(context, *pResult, "frames", 600));
+			int activePercent = (int)(GetNumberParam(context, *pResult, "active", 10));
+			int packetsPerReply = (int)(GetNumberParam(context, *pResult, "packetsPerReply", 3));
+			SocketPoller::RunLocalhostBenchmark(numClients, numFrames, activePercent, packetsPerReply, pResult);
+		}
+		else if (strcmp(type, "server") == 0)
+		{
+			int numClients = (int)(GetNumberParam(context, *pResult, "clients", 64));
+			int numRounds = (int)(GetNumberParam(context, *pResult, "rounds", 10));
+			ServerNetworkManager::RunChurnBenchmark(context, arena, numClients, numRounds, pResult);
+		}
+		else
+		{
+			PEINFO("Benchmark: unknown scenario type '%s'\n", type);
+			pResult->m_ok = false;
+		}
+
+		// network benchmarks time their own frames
+		if (pResult->m_runTime == 0)
+			pResult->m_runTime = timer.TickAndGetTimeDeltaInSeconds() - pResult->m_setupTime;
+		pResult->sampleMemory();
+
+		PEINFO("Benchmark: %s: %s, %d frames, setup %.1f ms, run %.1f ms\n", name, pResult->m_ok ? "ok" : "FAILED",
+			pResult->m_numFrames, (float)(pResult->m_setupTime * 1000.0), (float)(pResult->m_runTime * 1000.0));
+
+		results.push_back(pResult);
+		lua_pop(L, 1);
+	}
+
+	lua_pop(L, 1);
+	return true;
+}
+
+static const char *platformName()
+{
+#if PE_PLAT_IS_LINUX && APIABSTRACTION_HEADLESS
+	return "linux-headless";
+#elif APIABSTRACTION_D3D11
+	return "win32d3d11";
+#elif APIABSTRACTION_D3D9
+	return "win32d3d9";
+#elif APIABSTRACTION_GLPC
+	return "win32gl";
+#elif APIABSTRACTION_IOS
+	return "ios";
+#else
+	return "unknown";
+#endif
+}
+
+bool Benchmark::writeReport(const char *filename, const char *tag, std::vector<BenchmarkResult *> &results)
+{
+	FILE *f = fopen(filename, "w");
+	if (!f)
+	{
+		PEINFO("Benchmark: could not open %s for writing\n", filename);
+		return false;
+	}
+
+	fprintf(f, "{\n");
+	fprintf(f, "  \"version\": %d,\n", PE_BENCHMARK_REPORT_VERSION);
+	fprintf(f, "  \"tag\": ");
+	writeJsonString(f, tag ? tag : "");
+	fprintf(f, ",\n  \"platform\": \"%s\",\n", platformName());
+#ifdef _DEBUG
+	fprintf(f, "  \"configuration\": \"Debug\",\n");
+#else
+	fprintf(f, "  \"configuration\": \"Release\",\n");
+#endif
+	fprintf(f, "  \"timestamp\": %u,\n", (unsigned int)(time(NULL)));
+
+	// process peak includes memory allocated outside of memory manager pools (pemalloc, lua, stl)
+#if PE_PLAT_IS_LINUX
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	fprintf(f, "  \"peakProcessMemoryKB\": %ld,\n", usage.ru_maxrss);
+#endif
+
+	fprintf(f, "  \"scenarios\": [\n");
+	for (unsigned int i = 0; i < results.size(); ++i)
+	{
+		results[i]->writeJson(f);
+		fprintf(f, "%s\n", i + 1 < results.size() ? "," : "");
+	}
+	fprintf(f, "  ]\n}\n");
+	fclose(f);
+
+	PEINFO("Benchmark: wrote %d scenario results to %s\n", (int)(results.size()), filename);
+	return true;
+}
+
+}; // namespace PE
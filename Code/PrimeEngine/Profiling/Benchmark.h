@@ -0,0 +1,165 @@
+#ifndef __PYENGINE_2_0_BENCHMARK_H__
+#define __PYENGINE_2_0_BENCHMARK_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Game/Common/GameContext.h"
+#include "PrimeEngine/APIAbstraction/Timer/Timer.h"
+
+// Sibling/Children includes
+
+// bump when json layout changes so that tools comparing runs across commits can tell
+#define PE_BENCHMARK_REPORT_VERSION 1
+
+// all scenarios step simulation with this fixed frame time so that runs are reproducible
+#define PE_BENCHMARK_FRAME_TIME (1.0f / 60.0f)
+
+namespace PE {
+
+// Results of one benchmark scenario: per frame timings of named subsystems, counters and memory samples.
+// Written to json as min/avg/p50/p95/max per subsystem so that regressions show up in the tail too.
+struct BenchmarkResult
+{
+	BenchmarkResult(const char *name, const char *type);
+
+	// one sample per frame and subsystem
+	void addTiming(const char *subsystem, double seconds);
+	void setCounter(const char *name, double value);
+	void setParam(const char *name, double value);
+
+	// samples memory manager pool usage and keeps the peak. called once per frame by scenarios
+	void sampleMemory();
+
+	void writeJson(FILE *f);
+
+	struct Timing
+	{
+		std::string m_name;
+		std::vector<float> m_samples; // seconds
+	};
+
+	struct Value
+	{
+		std::string m_name;
+		double m_value;
+	};
+
+	std::string m_name;
+	std::string m_type;
+	bool m_ok; // scenario could run (assets found etc.)
+	int m_numFrames;
+	double m_setupTime; // seconds, loading and creating objects
+	double m_runTime; // seconds, all frames
+
+	std::vector<Value> m_params;
+	std::vector<Value> m_counters;
+	std::vector<Timing> m_timings; // in order of first sample
+
+	// memory manager pools (handles), in bytes of used blocks
+	PrimitiveTypes::UInt32 m_poolBytesAtStart;
+	PrimitiveTypes::UInt32 m_poolBytesAtEnd;
+	PrimitiveTypes::UInt32 m_poolBytesPeak;
+	PrimitiveTypes::UInt32 m_poolBlocksPeak;
+};
+
+// adds time between construction and destruction as one sample of subsystem
+struct BenchmarkTimer
+{
+	BenchmarkTimer(BenchmarkResult &result, const char *subsystem)
+	: m_result(result)
+	, m_subsystem(subsystem)
+	{
+		m_timer.Tick();
+	}
+
+	~BenchmarkTimer()
+	{
+		m_result.addTiming(m_subsystem, m_timer.TickAndGetTimeDeltaInSeconds());
+	}
+
+	BenchmarkResult &m_result;
+	const char *m_subsystem;
+	Timer m_timer;
+};
+
+// Boots the engine without window, renderer or network listening and runs scripted scenarios.
+// Scenario script (Code/Benchmark/Scenarios.lua) defines a global table 'Scenarios', each entry a table with
+// 'name', 'type' and numeric/string parameters of that type:
+//   navmesh  - agents pathing on a navmesh: count, frames, navmesh, package, repathFrames
+//   physics  - dynamic spheres falling onto static boxes: count, statics, frames
+//   skinning - cpu animated and skinned characters: count, frames, mesh, skeleton, animSet, package, threads, tolerance
+//   particles - cpu particle emitters (ParticleSimulationCPU): count, particles (per emitter), frames, threads, budget
+//   renderstate - pipeline state binds through RenderStateShadow (stub backend on headless): count (draws), techniques, frames, sorted
+//   constants - per object constants through ConstantBufferRing over cpu mock backend that checks wraparound and fences:
+//               count (objects), size (bytes per object), frames, ringKB, gpuLatency (frames)
+//   lights   - clustered light assignment (LightClusters) checked against brute force:
+//               count, frames, verifyEvery (frames), spots (ratio), minRange, maxRange
+//   log      - PELOG calls through AsyncLog (filtered, rate limited, queued, from job workers), written to file:
+//               count (filtered/rate limited calls), queued, batch, parallel, file, textFile
+//   text     - glyph batched text (TextBatcher) written every frame and checked against glyph table:
+//               strings, chars (per string), frames, world (ratio of in world strings), verifyEvery (frames)
+//   hotreload - HotReloadManager picks up script and texture edits on disk (linux): edits, timeout (ms per edit),
+//               smallTexture, bigTexture (Default package textures of different size written over each other)
+//   lua      - lua bytecode cache on script side of level load, and profiler on per frame lua calls: level, package,
+//              passes (of level scripts with warm cache), frames, instructionsPerSample
+//   crowd    - two blocks of agents swapping sides through each other with CrowdSimulation avoidance, compared to none
+//              and checked for same result on one thread: count, ticks, checkTicks (determinism), overlapEvery, speed,
+//              minProgress (of distance walking alone would cover)
+//   level    - level load (meta scripts and cpu assets): level, package
+//   ghosts   - GhostManager::RunLoopbackBenchmark: clients, objects, frames
+//   udp      - ConnectionManager::RunUdpLoopbackBenchmark: frames, loss, latency, jitter (ms)
+//   sockets  - SocketPoller::RunLocalhostBenchmark: clients, frames, active, packetsPerReply
+//   server   - ServerNetworkManager::RunChurnBenchmark (own server on free port): clients, rounds
+// Every scenario may set 'seed'. Results are written as one json document.
+struct Benchmark
+{
+	// like ServerGame::initEngine() but also constructs the memory manager, cpu asset managers and physics manager
+	// and does not open server sockets
+	static int initEngine(PE::GameContext &context, PE::MemoryArena arena, const char *lpCmdLine);
+
+	// runs scenarios of script whose name contains filter (all if NULL) and appends results
+	static bool runScenarioScript(PE::GameContext &context, PE::MemoryArena arena, const char *scriptWorkspacePath,
+		const char *filter, std::vector<BenchmarkResult *> &results);
+
+	// tag identifies the build (i.e. commit hash) in the report
+	static bool writeReport(const char *filename, const char *tag, std::vector<BenchmarkResult *> &results);
+
+	// scenarios, see BenchmarkScenarios.cpp. lua table of scenario is on top of stack
+	static void RunNavmeshScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+	static void RunPhysicsScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+	static void RunSkinningScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+	static void RunParticlesScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+	static void RunRenderStateScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+	static void RunConstantsScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+	static void RunLightsScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+	static void RunLogScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+	static void RunTextScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+	static void RunHotReloadScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+	static void RunLuaScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+	static void RunCrowdScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+	static void RunLevelScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result);
+
+	// reads field of scenario table on top of lua stack. numbers are recorded as params of result
+	static double GetNumberParam(PE::GameContext &context, BenchmarkResult &result, const char *name, double defaultValue);
+	static const char *GetStringParam(PE::GameContext &context, const char *name, const char *defaultValue);
+
+	// deterministic random numbers, seeded per scenario
+	static void Seed(PrimitiveTypes::UInt32 seed);
+	static PrimitiveTypes::UInt32 Random();
+	static float RandomFloat(float min, float max);
+
+	static PrimitiveTypes::UInt32 s_random;
+};
+
+}; // namespace PE
+
+#endif
@@ -0,0 +1,1800 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+#include "Benchmark.h"
+
+// Outer-Engine includes
+#include <math.h>
+#include <string>
+#include <set>
+#include <algorithm>
+#include <deque>
+#if PE_PLAT_IS_LINUX
+#include <sys/stat.h>
+#include <unistd.h>
+#include <dirent.h>
+#endif
+
+// Inter-Engine includes
+#include "PrimeEngine/Lua/LuaEnvironment.h"
+#include "PrimeEngine/Scene/NavmeshComponent.h"
+#include "PrimeEngine/Scene/PhysicsManager.h"
+#include "PrimeEngine/Geometry/MeshCPU/MeshCPU.h"
+#include "PrimeEngine/Geometry/SkeletonCPU/SkeletonCPU.h"
+#include "PrimeEngine/Geometry/SkeletonCPU/AnimationSetCPU.h"
+#include "PrimeEngine/Geometry/SkeletonCPU/SkinWeightsCPU.h"
+#include "PrimeEngine/Geometry/SkeletonCPU/SkinningCPU.h"
+#include "PrimeEngine/Geometry/PositionBufferCPU/PositionBufferCPU.h"
+#include "PrimeEngine/Geometry/NormalBufferCPU/NormalBufferCPU.h"
+#include "PrimeEngine/Geometry/ParticleSystemCPU/ParticleSimulationCPU.h"
+#include "PrimeEngine/Jobs/JobSystem.h"
+#include "PrimeEngine/Render/RenderStateCache.h"
+#include "PrimeEngine/Render/ConstantBufferRing.h"
+#include "PrimeEngine/Scene/LightClusters.h"
+#include "PrimeEngine/Scene/CrowdSimulation.h"
+#include "PrimeEngine/Scene/TextBatcher.h"
+#include "PrimeEngine/FileSystem/HotReloadManager.h"
+#include "PrimeEngine/APIAbstraction/Texture/GPUTextureManager.h"
+#include "PrimeEngine/MemoryManagement/MemoryManager.h"
+#include "PrimeEngine/APIAbstraction/Texture/SamplerState.h"
+#include "PrimeEngine/APIAbstraction/Effect/PEAlphaBlendState.h"
+#include "PrimeEngine/APIAbstraction/Effect/PERasterizerState.h"
+#include "PrimeEngine/APIAbstraction/Effect/PEDepthStencilState.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+using namespace Components;
+
+//////////////////////////////////////////////////////////////////////////
+// navmesh: agents (like SoldierNPC) walking to random targets on the level navmesh
+//////////////////////////////////////////////////////////////////////////
+
+struct BenchmarkAgent
+{
+	Vector3 m_pos;
+	std::vector<Vector3> m_path;
+	unsigned int m_nextWaypoint;
+	int m_framesSinceRepath;
+};
+
+static Vector3 randomTriangleCenter(NavmeshComponent *pNavmesh)
+{
+	PrimitiveTypes::UInt32 tri = Benchmark::Random() % pNavmesh->getTriangleCount();
+	return pNavmesh->getTriangle(tri).center;
+}
+
+void Benchmark::RunNavmeshScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	int numAgents = (int)(GetNumberParam(context, result, "count", 64));
+	int numFrames = (int)(GetNumberParam(context, result, "frames", 600));
+	int repathFrames = (int)(GetNumberParam(context, result, "repathFrames", 120));
+	float speed = (float)(GetNumberParam(context, result, "speed", 200.0));
+	const char *navmeshName = GetStringParam(context, "navmesh", "ccontrollvl0.navmesh");
+	const char *package = GetStringParam(context, "package", "CharacterControl");
+
+	Timer timer;
+
+	Handle hNavmesh("NAVMESH", sizeof(NavmeshComponent));
+	NavmeshComponent *pNavmesh = new(hNavmesh) NavmeshComponent(context, arena, hNavmesh);
+	pNavmesh->addDefaultComponents();
+	if (!pNavmesh->loadFromFile(navmeshName, package) || pNavmesh->getTriangleCount() == 0)
+	{
+		PEINFO("Benchmark: could not load navmesh %s from %s\n", navmeshName, package);
+		result.m_ok = false;
+		return;
+	}
+
+	std::vector<BenchmarkAgent> agents(numAgents);
+	for (int i = 0; i < numAgents; ++i)
+	{
+		agents[i].m_pos = randomTriangleCenter(pNavmesh);
+		agents[i].m_nextWaypoint = 0;
+		agents[i].m_framesSinceRepath = repathFrames; // all path on first frame
+	}
+	result.m_setupTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	Array<Vector3> path(context, arena);
+	int numPaths = 0, numFailed = 0;
+	double numWaypoints = 0;
+	float step = speed * PE_BENCHMARK_FRAME_TIME;
+
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		{
+			BenchmarkTimer t(result, "pathfinding");
+			for (int i = 0; i < numAgents; ++i)
+			{
+				BenchmarkAgent &a = agents[i];
+				if (a.m_nextWaypoint < a.m_path.size() && a.m_framesSinceRepath < repathFrames)
+					continue;
+
+				path.clear();
+				a.m_path.clear();
+				a.m_nextWaypoint = 0;
+				a.m_framesSinceRepath = 0;
+				++numPaths;
+				if (pNavmesh->findPath(a.m_pos, randomTriangleCenter(pNavmesh), path))
+				{
+					for (PrimitiveTypes::UInt32 w = 0; w < path.m_size; ++w)
+						a.m_path.push_back(path[w]);
+					numWaypoints += path.m_size;
+				}
+				else
+					++numFailed;
+			}
+		}
+
+		{
+			BenchmarkTimer t(result, "movement");
+			for (int i = 0; i < numAgents; ++i)
+			{
+				BenchmarkAgent &a = agents[i];
+				++a.m_framesSinceRepath;
+				float left = step;
+				while (a.m_nextWaypoint < a.m_path.size() && left > 0)
+				{
+					Vector3 toTarget = a.m_path[a.m_nextWaypoint] - a.m_pos;
+					float dist = toTarget.length();
+					if (dist <= left)
+					{
+						a.m_pos = a.m_path[a.m_nextWaypoint++];
+						left -= dist;
+					}
+					else
+					{
+						a.m_pos += toTarget * (left / dist);
+						left = 0;
+					}
+				}
+			}
+		}
+
+		result.sampleMemory();
+	}
+
+	result.m_numFrames = numFrames;
+	result.setCounter("triangles", pNavmesh->getTriangleCount());
+	result.setCounter("paths", numPaths);
+	result.setCounter("failedPaths", numFailed);
+	result.setCounter("avgWaypoints", numPaths > numFailed ? numWaypoints / (numPaths - numFailed) : 0);
+	result.m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	pNavmesh->~NavmeshComponent();
+	hNavmesh.release();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// physics: dynamic spheres falling onto a ground box and random static boxes
+//////////////////////////////////////////////////////////////////////////
+
+static Handle createBenchmarkPhysics(PE::GameContext &context, PE::MemoryArena arena, bool isStatic)
+{
+	Handle h("PHYSICS_COMPONENT", sizeof(PhysicsComponent));
+	PhysicsComponent *p = new(h) PhysicsComponent(context, arena, h);
+	p->addDefaultComponents();
+	p->isStatic = isStatic;
+	p->shapeType = isStatic ? PhysicsComponent::AABB : PhysicsComponent::SPHERE;
+	PhysicsManager::Instance()->addComponent(h);
+	return h;
+}
+
+void Benchmark::RunPhysicsScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	int numBodies = (int)(GetNumberParam(context, result, "count", 256));
+	int numStatics = (int)(GetNumberParam(context, result, "statics", 64));
+	int numFrames = (int)(GetNumberParam(context, result, "frames", 600));
+	const float extent = 100.0f; // bodies spawn over [-extent, extent] in x and z
+
+	Timer timer;
+
+	PhysicsManager *pPhysicsManager = PhysicsManager::Instance();
+	PrimitiveTypes::UInt32 firstComponent = pPhysicsManager->m_physicsComponents.m_size;
+
+	// not linked to scene nodes, so world aabbs are set here instead of synced every frame
+	PhysicsComponent *pGround = createBenchmarkPhysics(context, arena, true).getObject<PhysicsComponent>();
+	pGround->worldAABBMin = Vector3(-extent * 2, -1.0f, -extent * 2);
+	pGround->worldAABBMax = Vector3(extent * 2, 0.0f, extent * 2);
+
+	for (int i = 0; i < numStatics; ++i)
+	{
+		PhysicsComponent *p = createBenchmarkPhysics(context, arena, true).getObject<PhysicsComponent>();
+		Vector3 center(RandomFloat(-extent, extent), 0.0f, RandomFloat(-extent, extent));
+		Vector3 halfSize(RandomFloat(1.0f, 8.0f), RandomFloat(1.0f, 10.0f), RandomFloat(1.0f, 8.0f));
+		p->position = center;
+		p->worldAABBMin = Vector3(center.m_x - halfSize.m_x, 0.0f, center.m_z - halfSize.m_z);
+		p->worldAABBMax = Vector3(center.m_x + halfSize.m_x, halfSize.m_y * 2.0f, center.m_z + halfSize.m_z);
+	}
+
+	std::vector<PhysicsComponent *> bodies;
+	for (int i = 0; i < numBodies; ++i)
+	{
+		PhysicsComponent *p = createBenchmarkPhysics(context, arena, false).getObject<PhysicsComponent>();
+		p->sphereRadius = RandomFloat(0.5f, 1.5f);
+		p->position = Vector3(RandomFloat(-extent, extent), RandomFloat(5.0f, 50.0f), RandomFloat(-extent, extent));
+		p->velocity = Vector3(RandomFloat(-5.0f, 5.0f), 0.0f, RandomFloat(-5.0f, 5.0f));
+		bodies.push_back(p);
+	}
+	result.m_setupTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		{
+			BenchmarkTimer t(result, "physics");
+			pPhysicsManager->update(PE_BENCHMARK_FRAME_TIME);
+		}
+		result.sampleMemory();
+	}
+
+	// sanity: nothing should fall through the ground
+	int numBelowGround = 0;
+	for (int i = 0; i < numBodies; ++i)
+		if (bodies[i]->position.m_y < -1.0f)
+			++numBelowGround;
+
+	result.m_numFrames = numFrames;
+	result.setCounter("bodies", numBodies);
+	result.setCounter("statics", numStatics + 1);
+	result.setCounter("belowGround", numBelowGround);
+	result.m_ok = numBelowGround == 0;
+	result.m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	for (PrimitiveTypes::UInt32 i = firstComponent; i < pPhysicsManager->m_physicsComponents.m_size; ++i)
+	{
+		pPhysicsManager->m_physicsComponents[i].getObject<PhysicsComponent>()->~PhysicsComponent();
+		pPhysicsManager->m_physicsComponents[i].release();
+	}
+	pPhysicsManager->m_physicsComponents.m_size = firstComponent;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// skinning: animated characters, palette on cpu and vertices skinned on cpu with SkinningCPU
+// (headless has no gpu, so this measures the cpu side of what the skin shaders get).
+// first frame is checked against SkeletonCPU::testCreatePositionBufferCPU()
+//////////////////////////////////////////////////////////////////////////
+
+void Benchmark::RunSkinningScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	int numCharacters = (int)(GetNumberParam(context, result, "count", 32));
+	int numFrames = (int)(GetNumberParam(context, result, "frames", 300));
+	const char *meshName = GetStringParam(context, "mesh", "SoldierTransform.mesha");
+	const char *skeletonName = GetStringParam(context, "skeleton", "soldier_Soldier_Skeleton.skela");
+	const char *animSetName = GetStringParam(context, "animSet", "soldier_Soldier_Skeleton.animseta");
+	const char *package = GetStringParam(context, "package", "Soldier");
+	bool multithreaded = GetNumberParam(context, result, "threads", 1) != 0; // split meshes across job system workers
+	double tolerance = GetNumberParam(context, result, "tolerance", 0.001); // relative to position length (at least 1)
+
+	Timer timer;
+
+	Handle hSkel("SkeletonCPU", sizeof(SkeletonCPU));
+	SkeletonCPU *pSkel = new(hSkel) SkeletonCPU(context, arena);
+	pSkel->ReadSkeleton(skeletonName, package);
+
+	Handle hAnimSet("ANIMATION_SET_CPU", sizeof(AnimationSetCPU));
+	AnimationSetCPU *pAnimSet = new(hAnimSet) AnimationSetCPU(context, arena);
+	pAnimSet->ReadAnimationSet(animSetName, package, *pSkel);
+
+	MeshCPU mesh(context, arena);
+	mesh.ReadMesh(meshName, package, "");
+
+	if (!mesh.m_hSkinWeightsCPU.isValid() || pAnimSet->m_animations.m_size == 0)
+	{
+		PEINFO("Benchmark: %s has no skin weights or %s has no animations\n", meshName, animSetName);
+		result.m_ok = false;
+		return;
+	}
+
+	PositionBufferCPU *pPositions = mesh.m_hPositionBufferCPU.getObject<PositionBufferCPU>();
+	NormalBufferCPU *pNormals = mesh.m_hNormalBufferCPU.isValid() ? mesh.m_hNormalBufferCPU.getObject<NormalBufferCPU>() : NULL;
+	SkinWeightsCPU *pWeights = mesh.m_hSkinWeightsCPU.getObject<SkinWeightsCPU>();
+	PrimitiveTypes::UInt32 numJoints = pSkel->m_numJoints;
+
+	SkinningCPU skinning(context, arena);
+	skinning.initialize(*pPositions, pNormals, *pWeights);
+	PrimitiveTypes::UInt32 numVertices = skinning.m_numVertices;
+	if (skinning.m_numJoints > numJoints)
+	{
+		PEINFO("Benchmark: %s references joint %d, skeleton has %d\n", meshName, skinning.m_numJoints - 1, numJoints);
+		result.m_ok = false;
+		return;
+	}
+
+	// each character plays its own animation with own start frame
+	std::vector<PrimitiveTypes::UInt32> animIndices(numCharacters), startFrames(numCharacters);
+	for (int i = 0; i < numCharacters; ++i)
+	{
+		animIndices[i] = Random() % pAnimSet->m_animations.m_size;
+		startFrames[i] = Random();
+	}
+
+	Array<Matrix4x4> palette(context, arena, numJoints);
+	palette.m_size = numJoints;
+	std::vector<float> palettes(numCharacters * numJoints * SkinningCPU::c_floatsPerJoint);
+	std::vector<float> skinned(numVertices * 3), skinnedNormals(numVertices * 3);
+	double checksum = 0;
+	double skinningTime = 0;
+	double maxError = 0;
+	double referenceTime = 0;
+
+	result.m_setupTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		{
+			BenchmarkTimer t(result, "animation");
+			for (int i = 0; i < numCharacters; ++i)
+			{
+				AnimationCPU &anim = pAnimSet->m_animations[animIndices[i]];
+				PrimitiveTypes::UInt32 animFrame = (startFrames[i] + frame) % anim.m_frames.m_size;
+				pSkel->prepareMatrixPalette(anim, animFrame, palette);
+				SkinningCPU::PreparePalette(palette.getFirstPtr(), pSkel->getBindInversesPtr(), numJoints, &palettes[i * numJoints * SkinningCPU::c_floatsPerJoint]);
+			}
+		}
+
+		{
+			BenchmarkTimer t(result, "skinning");
+			Timer skinTimer;
+			for (int i = 0; i < numCharacters; ++i)
+			{
+				skinning.skin(&palettes[i * numJoints * SkinningCPU::c_floatsPerJoint], &skinned[0], &skinnedNormals[0], multithreaded);
+				checksum += skinned[(i % numVertices) * 3 + 1]; // keep results alive
+			}
+			skinningTime += skinTimer.TickAndGetTimeDeltaInSeconds();
+		}
+
+		// compare with per vertex reference (needs a weight set for every vertex)
+		if (frame == 0 && pWeights->m_weightsPerVertex.m_size == pPositions->m_values.m_size / 3)
+		{
+			PositionBufferCPU reference(context, arena);
+			for (int i = 0; i < numCharacters; ++i)
+			{
+				AnimationCPU &anim = pAnimSet->m_animations[animIndices[i]];
+				pSkel->prepareMatrixPalette(anim, startFrames[i] % anim.m_frames.m_size, palette);
+
+				Timer referenceTimer;
+				pSkel->testCreatePositionBufferCPU(reference, palette, palette, *pPositions, *pWeights);
+				referenceTime += referenceTimer.TickAndGetTimeDeltaInSeconds();
+
+				skinning.skin(&palettes[i * numJoints * SkinningCPU::c_floatsPerJoint], &skinned[0], NULL, false);
+				for (PrimitiveTypes::UInt32 v = 0; v < numVertices; ++v)
+				{
+					Vector3 ref(reference.m_values[v * 3], reference.m_values[v * 3 + 1], reference.m_values[v * 3 + 2]);
+					Vector3 res(skinned[v * 3], skinned[v * 3 + 1], skinned[v * 3 + 2]);
+					double error = (ref - res).length() / (ref.length() > 1.0f ? ref.length() : 1.0f);
+					if (!(error <= maxError)) // nan counts as error
+						maxError = error == error ? error : 1e30;
+				}
+			}
+		}
+
+		result.sampleMemory();
+	}
+
+	result.m_numFrames = numFrames;
+	result.setCounter("characters", numCharacters);
+	result.setCounter("joints", numJoints);
+	result.setCounter("vertices", numVertices);
+	result.setCounter("influences", skinning.m_numInfluences);
+	result.setCounter("animations", pAnimSet->m_animations.m_size);
+	result.setCounter("verticesPerMs", skinningTime > 0 ? (double)(numVertices) * numCharacters * numFrames / (skinningTime * 1000.0) : 0);
+	if (referenceTime > 0)
+	{
+		result.setCounter("referenceVerticesPerMs", (double)(numVertices) * numCharacters / (referenceTime * 1000.0));
+		result.setCounter("maxError", maxError);
+	}
+	result.m_ok = checksum == checksum && maxError <= tolerance; // no nans, same as reference
+	result.m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	pAnimSet->~AnimationSetCPU();
+	hAnimSet.release();
+	pSkel->~SkeletonCPU();
+	hSkel.release();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// particles: cpu simulated emitters with full pools, billboards written every frame
+//////////////////////////////////////////////////////////////////////////
+
+void Benchmark::RunParticlesScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	int numEmitters = (int)(GetNumberParam(context, result, "count", 16));
+	int numParticles = (int)(GetNumberParam(context, result, "particles", 4096)); // per emitter
+	int numFrames = (int)(GetNumberParam(context, result, "frames", 300));
+	bool multithreaded = GetNumberParam(context, result, "threads", 1) != 0;
+	PrimitiveTypes::UInt32 budget = (PrimitiveTypes::UInt32)(GetNumberParam(context, result, "budget", PE_PARTICLES_CPU_FRAME_BUDGET));
+
+	Timer timer;
+
+	ParticleSimulationCPU simulation(context, arena, budget);
+	std::vector<ParticleEmitterCPU *> emitters;
+	std::vector<Handle> emitterHandles;
+	for (int i = 0; i < numEmitters; ++i)
+	{
+		ParticleEmitterDescCPU desc;
+		desc.m_maxParticles = numParticles;
+		desc.m_minLifetime = 1.0f;
+		desc.m_maxLifetime = 3.0f;
+		desc.m_spawnRate = numParticles / 2.0f; // pool stays about full
+		desc.m_spawnPos = Vector3(RandomFloat(-100.0f, 100.0f), 0.0f, RandomFloat(-100.0f, 100.0f));
+		desc.m_spawnExtents = Vector3(1.0f, 0.0f, 1.0f);
+		desc.m_minVelocity = Vector3(-2.0f, 5.0f, -2.0f);
+		desc.m_maxVelocity = Vector3(2.0f, 10.0f, 2.0f);
+		desc.m_drag = 0.5f;
+		desc.m_startSize = 0.5f;
+		desc.m_endSize = 2.0f;
+		desc.m_startColor = Vector4(1.0f, 0.8f, 0.2f, 1.0f);
+		desc.m_endColor = Vector4(0.2f, 0.2f, 0.2f, 0.0f);
+		desc.m_seed = Random() + 1;
+
+		Handle hEmitter("PARTICLE_EMITTER_CPU", sizeof(ParticleEmitterCPU));
+		ParticleEmitterCPU *pEmitter = new(hEmitter) ParticleEmitterCPU(context, arena);
+		pEmitter->initialize(desc);
+		pEmitter->spawnBurst(numParticles); // start from steady state
+		simulation.addEmitter(pEmitter);
+		emitters.push_back(pEmitter);
+		emitterHandles.push_back(hEmitter);
+	}
+	result.m_setupTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	Vector3 cameraRight(1.0f, 0, 0), cameraUp(0, 1.0f, 0);
+	double numSimulated = 0;
+	double checksum = 0;
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		{
+			BenchmarkTimer t(result, "particles");
+			simulation.update(PE_BENCHMARK_FRAME_TIME, cameraRight, cameraUp, multithreaded);
+		}
+		numSimulated += simulation.m_numSimulated;
+
+		ParticleEmitterCPU *pEmitter = emitters[frame % numEmitters];
+		if (pEmitter->m_numAlive)
+			checksum += pEmitter->getVertices()[(frame % pEmitter->m_numAlive) * 4].m_pos[1]; // keep results alive
+		result.sampleMemory();
+	}
+
+	result.m_numFrames = numFrames;
+	result.setCounter("emitters", numEmitters);
+	result.setCounter("particles", numFrames ? numSimulated / numFrames : 0); // average alive
+	result.setCounter("droppedSpawns", simulation.m_numDroppedSpawns); // last frame
+	result.setCounter("workers", multithreaded && JobSystem::Instance() ? JobSystem::Instance()->getNumWorkers() : 0);
+	result.setCounter("particlesPerMs", simulation.getParticlesPerMs());
+	result.m_ok = checksum == checksum && numSimulated <= (double)(budget) * numFrames;
+	result.m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	for (int i = 0; i < numEmitters; ++i)
+	{
+		emitters[i]->~ParticleEmitterCPU();
+		emitterHandles[i].release();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// renderstate: draws with random techniques (blend, rasterizer, depth state and two samplers) bound through
+// a RenderStateShadow like Effect::setCurrent() and SA_Bind_Resource do. counts state changes sent vs skipped
+//////////////////////////////////////////////////////////////////////////
+
+struct BenchmarkTechnique
+{
+	PEAlphaBlendState *m_pBlendState;
+	PERasterizerState *m_pRasterizerState;
+	PEDepthStencilState *m_pDepthStencilState;
+	SamplerState *m_pSamplers[2];
+};
+
+void Benchmark::RunRenderStateScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	int numDraws = (int)(GetNumberParam(context, result, "count", 2000)); // per frame
+	int numTechniques = (int)(GetNumberParam(context, result, "techniques", 16));
+	int numFrames = (int)(GetNumberParam(context, result, "frames", 300));
+	bool sorted = GetNumberParam(context, result, "sorted", 0) != 0; // draws grouped by technique
+
+	Timer timer;
+
+	static const ESamplerState s_samplers[] = {
+		SamplerState_NoMips_MinTexelLerp_NoMagTexelLerp_Clamp, SamplerState_NoMips_NoMinTexelLerp_NoMagTexelLerp_Wrap,
+		SamplerState_MipLerp_MinTexelLerp_MagTexelLerp_Wrap, SamplerState_MipLerp_MinTexelLerp_MagTexelLerp_Clamp};
+	std::vector<BenchmarkTechnique> techniques(numTechniques);
+	for (int i = 0; i < numTechniques; ++i)
+	{
+		BenchmarkTechnique &t = techniques[i];
+		// mostly opaque, culled, depth tested like the level
+		t.m_pBlendState = context.getAlphaBlendStateManager()->getAlphaBlendState(Random() % 4 ? PEAlphaBlendState_NoBlend : PEAlphaBlendState_DefaultRGBLerp_A_DestUnchanged);
+		t.m_pRasterizerState = context.getRasterizerStateManager()->getRasterizerState(Random() % 4 ? PERasterizerState_SolidTriBackCull : (E_PERasterizerState)(Random() % PERasterizerState_Count));
+		t.m_pDepthStencilState = context.getDepthStencilStateManager()->getDepthStencilState(Random() % 8 ? PEDepthStencilState_ZBuffer : PEDepthStencilState_NoZBuffer);
+		for (int s = 0; s < 2; ++s)
+			t.m_pSamplers[s] = &SamplerStateManager::getInstance()->getSamplerState(s_samplers[Random() % 4]);
+	}
+
+	std::vector<int> draws(numDraws);
+	RenderStateShadow shadow;
+	result.m_setupTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	double numApplied = 0, numSkipped = 0;
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		for (int i = 0; i < numDraws; ++i)
+			draws[i] = Random() % numTechniques;
+		if (sorted)
+			std::sort(draws.begin(), draws.end());
+
+		{
+			BenchmarkTimer t(result, "bindStates");
+			shadow.invalidate();
+			for (int i = 0; i < numDraws; ++i)
+			{
+				BenchmarkTechnique &tech = techniques[draws[i]];
+				if (shadow.shouldApply(RenderStateType_Blend, 0, tech.m_pBlendState))
+					tech.m_pBlendState->bindToPipeline(NULL);
+				if (shadow.shouldApply(RenderStateType_Rasterizer, 0, tech.m_pRasterizerState))
+					tech.m_pRasterizerState->bindToPipeline(NULL);
+				if (shadow.shouldApply(RenderStateType_DepthStencil, 0, tech.m_pDepthStencilState))
+					tech.m_pDepthStencilState->bindToPipeline(NULL);
+				for (int s = 0; s < 2; ++s)
+					shadow.shouldApply(RenderStateType_Sampler, s, tech.m_pSamplers[s]); // no sampler api calls on headless
+			}
+			shadow.frameEnd();
+		}
+
+		numApplied += shadow.m_lastFrameStats.getNumApplied();
+		numSkipped += shadow.m_lastFrameStats.getNumSkipped();
+	}
+
+	RenderStateCache *pCache = RenderStateCache::Instance();
+	result.m_numFrames = numFrames;
+	result.setCounter("draws", numDraws);
+	result.setCounter("uniqueStates", pCache->m_numStates);
+	result.setCounter("sharedStates", pCache->m_numHits); // manager states that reused an existing state object
+	result.setCounter("appliedPerFrame", numApplied / numFrames);
+	result.setCounter("skippedPerFrame", numSkipped / numFrames);
+	result.setCounter("skippedPercent", numApplied + numSkipped > 0 ? numSkipped * 100.0 / (numApplied + numSkipped) : 0);
+	result.m_ok = numApplied + numSkipped == (double)(numDraws) * 5 * numFrames;
+	result.m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// constants: per object constants written through ConstantBufferRing into cpu memory.
+// mock gpu finishes a frame gpuLatency frames after it was submitted and checks every range it "reads"
+// still has what was written, and every map is checked against ranges of frames gpu has not finished
+//////////////////////////////////////////////////////////////////////////
+
+struct BenchmarkMockConstantBackend : public ConstantBufferRingBackend
+{
+	struct Range
+	{
+		PrimitiveTypes::UInt32 m_offset, m_size;
+		PrimitiveTypes::UInt32 m_value; // every word of range
+	};
+
+	struct Frame
+	{
+		PrimitiveTypes::UInt32 m_fence;
+		std::vector<Range> m_ranges;
+	};
+
+	BenchmarkMockConstantBackend(PrimitiveTypes::UInt32 size, PrimitiveTypes::UInt32 alignment, PrimitiveTypes::UInt32 gpuLatency)
+	: m_memory(size / 4), m_blockFences(size / alignment, 0), m_alignment(alignment), m_gpuLatency(gpuLatency),
+	m_lastFence(0), m_lastCompletedFence(0), m_numBadMaps(0), m_numCorruptedRanges(0), m_numBinds(0), m_numStalls(0)
+	{}
+
+	virtual void *map(PrimitiveTypes::UInt32 offset, PrimitiveTypes::UInt32 size)
+	{
+		// every alignment block remembers fence of last frame that wrote it. block can be written again
+		// only after that fence completed (current frame's fence is m_lastFence + 1)
+		bool bad = offset % m_alignment != 0 || offset + size > m_memory.size() * 4;
+		for (PrimitiveTypes::UInt32 b = offset / m_alignment; !bad && b < (offset + size + m_alignment - 1) / m_alignment; ++b)
+		{
+			bad = m_blockFences[b] > m_lastCompletedFence;
+			m_blockFences[b] = m_lastFence + 1;
+		}
+		if (bad)
+			m_numBadMaps++;
+		return &m_memory[offset / 4];
+	}
+
+	virtual void unmap(PrimitiveTypes::UInt32 offset, PrimitiveTypes::UInt32 size)
+	{
+		Range r = {offset, size, m_memory[offset / 4]};
+		m_current.push_back(r);
+	}
+
+	virtual void bindRange(PrimitiveTypes::UInt32 slot, PrimitiveTypes::UInt32 offset, PrimitiveTypes::UInt32 size)
+	{
+		m_numBinds++;
+	}
+
+	virtual PrimitiveTypes::UInt32 insertFence()
+	{
+		Frame frame;
+		frame.m_fence = ++m_lastFence;
+		frame.m_ranges.swap(m_current);
+		m_submitted.push_back(frame);
+
+		// gpu runs m_gpuLatency frames behind
+		if (m_lastFence > m_gpuLatency)
+			completeUpTo(m_lastFence - m_gpuLatency);
+		return m_lastFence;
+	}
+
+	virtual bool isFenceComplete(PrimitiveTypes::UInt32 fence)
+	{
+		return fence <= m_lastCompletedFence;
+	}
+
+	virtual void waitForFence(PrimitiveTypes::UInt32 fence)
+	{
+		if (fence > m_lastCompletedFence)
+			m_numStalls++;
+		completeUpTo(fence);
+	}
+
+	// gpu reads constants of frames up to fence
+	void completeUpTo(PrimitiveTypes::UInt32 fence)
+	{
+		while (!m_submitted.empty() && m_submitted.front().m_fence <= fence)
+		{
+			Frame &frame = m_submitted.front();
+			for (unsigned int i = 0; i < frame.m_ranges.size(); ++i)
+			{
+				Range &r = frame.m_ranges[i];
+				for (PrimitiveTypes::UInt32 w = 0; w < r.m_size / 4; ++w)
+				{
+					if (m_memory[r.m_offset / 4 + w] != r.m_value)
+					{
+						m_numCorruptedRanges++;
+						break;
+					}
+				}
+			}
+			m_lastCompletedFence = frame.m_fence;
+			m_submitted.pop_front();
+		}
+	}
+
+	std::vector<PrimitiveTypes::UInt32> m_memory;
+	std::vector<PrimitiveTypes::UInt32> m_blockFences;
+	PrimitiveTypes::UInt32 m_alignment;
+	PrimitiveTypes::UInt32 m_gpuLatency;
+	PrimitiveTypes::UInt32 m_lastFence, m_lastCompletedFence;
+	std::vector<Range> m_current; // written this frame
+	std::deque<Frame> m_submitted; // not finished by gpu
+
+	PrimitiveTypes::UInt32 m_numBadMaps; // misaligned or overlapping memory gpu still reads
+	PrimitiveTypes::UInt32 m_numCorruptedRanges; // overwritten before gpu read them
+	PrimitiveTypes::UInt32 m_numBinds;
+	PrimitiveTypes::UInt32 m_numStalls;
+};
+
+void Benchmark::RunConstantsScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	int numObjects = (int)(GetNumberParam(context, result, "count", 2000)); // per frame
+	int size = (int)(GetNumberParam(context, result, "size", 336)) & ~3; // like SetPerObjectConstantsShaderAction::Data on d3d11
+	int numFrames = (int)(GetNumberParam(context, result, "frames", 300));
+	int ringSize = (int)(GetNumberParam(context, result, "ringKB", PE_CONSTANT_BUFFER_RING_SIZE / 1024)) * 1024;
+	int gpuLatency = (int)(GetNumberParam(context, result, "gpuLatency", PE_NUM_FRAMES_IN_FLIGHT - 1));
+
+	Timer timer;
+
+	static const PrimitiveTypes::UInt32 c_alignment = 256; // d3d11.1 constant buffer offsets
+	BenchmarkMockConstantBackend backend(ringSize, c_alignment, gpuLatency);
+	ConstantBufferRing ring;
+	ring.initialize(&backend, ringSize, c_alignment);
+
+	std::vector<PrimitiveTypes::UInt32> data(size / 4);
+	result.m_setupTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	double numBytes = 0, numBinds = 0, numWraps = 0, numWaits = 0, numOverflows = 0;
+	PrimitiveTypes::UInt32 value = 0;
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		{
+			BenchmarkTimer t(result, "upload");
+			ring.beginFrame();
+			for (int i = 0; i < numObjects; ++i)
+			{
+				++value;
+				for (unsigned int w = 0; w < data.size(); ++w)
+					data[w] = value;
+				ring.uploadAndBind(2, &data[0], size);
+			}
+			ring.endFrame();
+		}
+
+		ConstantBufferRing::Stats &stats = ring.m_lastFrameStats;
+		numBytes += stats.m_numBytesUploaded;
+		numBinds += stats.m_numBinds;
+		numWraps += stats.m_numWraps;
+		numWaits += stats.m_numFenceWaits;
+		numOverflows += stats.m_numOverflows;
+	}
+
+	// gpu reads what is still in flight
+	backend.completeUpTo(backend.m_lastFence);
+
+	result.m_numFrames = numFrames;
+	result.setCounter("objects", numObjects);
+	result.setCounter("bytesPerFrame", numBytes / numFrames);
+	result.setCounter("bindsPerFrame", numBinds / numFrames);
+	result.setCounter("wraps", numWraps);
+	result.setCounter("fenceWaits", numWaits);
+	result.setCounter("overflows", numOverflows);
+	result.setCounter("badMaps", backend.m_numBadMaps);
+	result.setCounter("corruptedRanges", backend.m_numCorruptedRanges);
+	result.m_ok = backend.m_numBadMaps == 0 && backend.m_numCorruptedRanges == 0 && numWaits == backend.m_numStalls &&
+		numBinds + numOverflows == (double)(numObjects) * numFrames && numBinds == backend.m_numBinds;
+	result.m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// lights: random point and spot lights in view frustum binned by LightClusters every frame.
+// cluster lists of verified frames are compared with brute force of every light against every cluster
+//////////////////////////////////////////////////////////////////////////
+
+void Benchmark::RunLightsScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	int numLights = (int)(GetNumberParam(context, result, "count", 100));
+	int numFrames = (int)(GetNumberParam(context, result, "frames", 300));
+	int verifyEvery = (int)(GetNumberParam(context, result, "verifyEvery", 30));
+	float spotRatio = (float)(GetNumberParam(context, result, "spots", 0.5));
+	float minRange = (float)(GetNumberParam(context, result, "minRange", 1.0));
+	float maxRange = (float)(GetNumberParam(context, result, "maxRange", 8.0));
+
+	Timer timer;
+
+	Handle hClusters("LIGHT_CLUSTERS", sizeof(LightClusters));
+	LightClusters *pClusters = new(hClusters) LightClusters(context, arena);
+
+	// like CameraSceneNode: 60 degree vertical fov, 16:9
+	PrimitiveTypes::Float32 nearZ = 0.05f, farZ = 200.0f, yScale = 1.0f / tanf(0.5f * 60.0f * PrimitiveTypes::Constants::c_Pi_F32 / 180.0f), xScale = yScale / (16.0f / 9.0f);
+	pClusters->setFrustum(xScale, yScale, nearZ, farZ);
+
+	// lights in view space: camera at origin looking down +z
+	Matrix4x4 worldToView;
+	worldToView.loadIdentity();
+
+	std::vector<SetPerObjectGroupConstantsShaderAction::hlsl_Light> lights(numLights); // value initialized: zeroed point lights
+	std::vector<Vector3> velocities(numLights);
+	for (int i = 0; i < numLights; ++i)
+	{
+		SetPerObjectGroupConstantsShaderAction::hlsl_Light &l = lights[i];
+		float z = RandomFloat(1.0f, 60.0f);
+		l.pos = Vector3(RandomFloat(-1.1f, 1.1f) * z / xScale, RandomFloat(-1.1f, 1.1f) * z / yScale, z);
+		l.range = RandomFloat(minRange, maxRange);
+		if (RandomFloat(0, 1.0f) < spotRatio)
+		{
+			l.type = 2.0f;
+			l.dir = Vector3(RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-1.0f, 1.0f));
+			l.spotPower = RandomFloat(2.0f, 64.0f);
+		}
+		velocities[i] = Vector3(RandomFloat(-2.0f, 2.0f), RandomFloat(-1.0f, 1.0f), RandomFloat(-2.0f, 2.0f));
+	}
+	result.m_setupTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	double numHits = 0;
+	PrimitiveTypes::UInt32 maxPerCluster = 0;
+	int numMismatches = 0, numVerified = 0;
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		for (int i = 0; i < numLights; ++i)
+			lights[i].pos = lights[i].pos + PE_BENCHMARK_FRAME_TIME * velocities[i];
+
+		{
+			BenchmarkTimer t(result, "clusters");
+			pClusters->clearLights();
+			for (int i = 0; i < numLights; ++i)
+				pClusters->addLight(lights[i], worldToView);
+			pClusters->build();
+		}
+		numHits += pClusters->m_lightIndices.m_size;
+		maxPerCluster = pClusters->m_maxLightsPerCluster > maxPerCluster ? pClusters->m_maxLightsPerCluster : maxPerCluster;
+
+		if (verifyEvery > 0 && (frame % verifyEvery == 0 || frame == numFrames - 1))
+		{
+			BenchmarkTimer t(result, "bruteforce");
+			numVerified++;
+			PrimitiveTypes::UInt32 numBruteHits = 0;
+			for (PrimitiveTypes::UInt32 c = 0; c < LightClusters::c_numClusters; ++c)
+			{
+				// list has to be exactly the lights touching the cluster, ascending
+				PrimitiveTypes::UInt32 n = 0;
+				for (PrimitiveTypes::UInt32 i = 0; i < pClusters->getNumLights(); ++i)
+				{
+					if (!pClusters->lightTouchesCluster(i, c))
+						continue;
+					if (n >= pClusters->m_clusterCounts[c] || pClusters->m_lightIndices[pClusters->m_clusterOffsets[c] + n] != i)
+						numMismatches++;
+					n++;
+				}
+				if (n != pClusters->m_clusterCounts[c])
+					numMismatches++;
+				numBruteHits += n;
+			}
+			if (numBruteHits != pClusters->m_lightIndices.m_size)
+				numMismatches++;
+		}
+		result.sampleMemory();
+	}
+
+	result.m_numFrames = numFrames;
+	result.setCounter("lights", numLights);
+	result.setCounter("clusters", LightClusters::c_numClusters);
+	result.setCounter("hitsPerFrame", numFrames ? numHits / numFrames : 0);
+	result.setCounter("maxPerCluster", maxPerCluster);
+	result.setCounter("verifiedFrames", numVerified);
+	result.setCounter("mismatches", numMismatches);
+	result.m_ok = numMismatches == 0 && (numLights == 0 || numHits > 0);
+	result.m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	hClusters.release();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// log: cost of PELOG calls that are filtered out, rate limited and queued to log thread,
+// compared with formatting and writing on calling thread. checks log thread formats like printf
+// and binary file has every written message
+//////////////////////////////////////////////////////////////////////////
+
+static PrimitiveTypes::UInt32 s_benchmarkLogNumMessages = 0;
+static std::vector<std::string> s_benchmarkLogChecks;
+
+static void benchmarkLogSink(const LogSite *pSite, const char *text)
+{
+	s_benchmarkLogNumMessages++;
+	if (pSite->m_category == LogCategory_Scene)
+		s_benchmarkLogChecks.push_back(text);
+}
+
+static void benchmarkLogParallel(void *pParams, int begin, int end)
+{
+	for (int i = begin; i < end; ++i)
+		PELOG(LogSeverity_Info, LogCategory_Game, "worker message %d of %s", i, "parallel");
+}
+
+void Benchmark::RunLogScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	int numCalls = (int)(GetNumberParam(context, result, "count", 1000000)); // filtered and rate limited
+	int numQueued = (int)(GetNumberParam(context, result, "queued", 100000));
+	int batchSize = (int)(GetNumberParam(context, result, "batch", 1000)); // queued calls between flushes
+	int numParallel = (int)(GetNumberParam(context, result, "parallel", 100000));
+	const char *binaryFile = GetStringParam(context, "file", "BenchmarkLog.bin");
+	const char *textFile = GetStringParam(context, "textFile", "BenchmarkLog.txt");
+
+	// own log thread writing to file, nothing to console
+	bool wasRunning = AsyncLog::IsRunning();
+	AsyncLog::Stop();
+	bool printToConsole = AsyncLog::s_printToConsole;
+	int rateLimit = AsyncLog::s_rateLimit;
+	AsyncLog::s_printToConsole = false;
+	AsyncLog::SetSink(&benchmarkLogSink);
+	s_benchmarkLogNumMessages = 0;
+	s_benchmarkLogChecks.clear();
+	AsyncLog::Start(binaryFile);
+
+	AsyncLog::Stats statsBefore;
+	AsyncLog::GetStats(statsBefore);
+
+	Timer totalTimer, timer;
+
+	// filtered out by category: only the check at call site
+	LogSite::s_categoryMask = ~(1 << LogCategory_Game);
+	timer.Tick();
+	for (int i = 0; i < numCalls; ++i)
+		PELOG(LogSeverity_Info, LogCategory_Game, "filtered %d %f %s", i, i * 0.5, "text");
+	double filteredTime = timer.TickAndGetTimeDeltaInSeconds();
+	LogSite::s_categoryMask = -1;
+
+	// one call site over and over: first PE_LOG_RATE_LIMIT per second are queued, rest only counted
+	AsyncLog::s_rateLimit = PE_LOG_RATE_LIMIT;
+	timer.Tick();
+	for (int i = 0; i < numCalls; ++i)
+		PELOG(LogSeverity_Info, LogCategory_Game, "rate limited %d %f %s", i, i * 0.5, "text");
+	double rateLimitedTime = timer.TickAndGetTimeDeltaInSeconds();
+	AsyncLog::Flush();
+
+	// queued: batches fit in ring, log thread catches up in between
+	AsyncLog::s_rateLimit = 0;
+	double queuedTime = 0;
+	for (int i = 0; i < numQueued; i += batchSize)
+	{
+		int end = i + batchSize < numQueued ? i + batchSize : numQueued;
+		timer.Tick();
+		for (int j = i; j < end; ++j)
+			PELOG(LogSeverity_Info, LogCategory_Game, "queued %d %f %s", j, j * 0.5, "text");
+		queuedTime += timer.TickAndGetTimeDeltaInSeconds();
+		AsyncLog::Flush();
+	}
+
+	// what every call used to cost, without console: format and write on calling thread
+	FILE *pSyncFile = fopen(textFile, "wb");
+	timer.Tick();
+	for (int i = 0; pSyncFile && i < numQueued; ++i)
+	{
+		char text[256];
+		int len = sprintf(text, "PE: Info: queued %d %f %s\n", i, i * 0.5, "text");
+		fwrite(text, 1, len, pSyncFile);
+	}
+	double syncTime = timer.TickAndGetTimeDeltaInSeconds();
+	if (pSyncFile)
+		fclose(pSyncFile);
+
+	// job workers log at the same time, each into its own ring
+	{
+		BenchmarkTimer t(result, "parallel");
+		JobSystem::parallelFor(numParallel, 256, &benchmarkLogParallel, NULL);
+	}
+	AsyncLog::Flush();
+
+	// log thread has to format every conversion like printf
+	int numMismatches = 0;
+	{
+		char expected[8][256];
+		int numExpected = 0;
+		const char *str = "string";
+		long long big = -1234567890123LL;
+		sprintf(expected[numExpected++], "check %d %5.2f %s %x %lld %c %% %-6s|", -42, 3.14159, str, 0xbeef, big, 'z', "ab");
+		PELOG(LogSeverity_Info, LogCategory_Scene, "check %d %5.2f %s %x %lld %c %% %-6s|", -42, 3.14159, str, 0xbeef, big, 'z', "ab");
+		sprintf(expected[numExpected++], "stars %*d %.*f %lu %zu", 8, 7, 3, 2.5, 123456789UL, (size_t)(99));
+		PELOG(LogSeverity_Info, LogCategory_Scene, "stars %*d %.*f %lu %zu", 8, 7, 3, 2.5, 123456789UL, (size_t)(99));
+		sprintf(expected[numExpected++], "null %s %e", (const char *)"(null)", 1e-7);
+		PELOG(LogSeverity_Info, LogCategory_Scene, "null %s %e", (const char *)(NULL), 1e-7);
+		// long double can't be recorded raw, formatted on calling thread
+		sprintf(expected[numExpected++], "preformatted %.3Lf %d", (long double)(1.5), 5);
+		PELOG(LogSeverity_Info, LogCategory_Scene, "preformatted %.3Lf %d", (long double)(1.5), 5);
+		// arguments that don't fit in record: strings are cut, message ends after last recorded argument
+		std::string longA(699, 'a'), longB(699, 'b');
+		PELOG(LogSeverity_Info, LogCategory_Scene, "long %s %s %d %d", longA.c_str(), longB.c_str(), 1, 2);
+		AsyncLog::Flush();
+
+		if ((int)(s_benchmarkLogChecks.size()) != numExpected + 1)
+			numMismatches++;
+		for (int i = 0; i < numExpected && i < (int)(s_benchmarkLogChecks.size()); ++i)
+		{
+			if (s_benchmarkLogChecks[i] != expected[i])
+			{
+				PEINFO("Benchmark: log mismatch '%s' expected '%s'", s_benchmarkLogChecks[i].c_str(), expected[i]);
+				numMismatches++;
+			}
+		}
+		if ((int)(s_benchmarkLogChecks.size()) > numExpected)
+		{
+			const std::string &text = s_benchmarkLogChecks[numExpected];
+			std::string prefix = "long " + longA.substr(0, 512) + " bbb";
+			const char *suffix = " (truncated)";
+			size_t suffixLen = strlen(suffix);
+			if (text.compare(0, prefix.size(), prefix) != 0 || text.size() < suffixLen ||
+				text.compare(text.size() - suffixLen, suffixLen, suffix) != 0 || text.find(" 1 2") != std::string::npos)
+			{
+				PEINFO("Benchmark: truncated log message mismatch, %d chars", (int)(text.size()));
+				numMismatches++;
+			}
+		}
+	}
+
+	AsyncLog::Stats stats;
+	AsyncLog::GetStats(stats);
+	AsyncLog::Stop();
+	AsyncLog::SetSink(NULL);
+	AsyncLog::s_printToConsole = printToConsole;
+	AsyncLog::s_rateLimit = rateLimit;
+
+	PrimitiveTypes::UInt32 numRecorded = stats.m_numRecorded - statsBefore.m_numRecorded;
+	PrimitiveTypes::UInt32 numDropped = stats.m_numDropped - statsBefore.m_numDropped;
+	PrimitiveTypes::UInt32 numRateLimited = stats.m_numRateLimited - statsBefore.m_numRateLimited;
+
+	// binary file: count message records
+	int numFileMessages = 0;
+	bool fileOk = false;
+	if (FILE *f = fopen(binaryFile, "rb"))
+	{
+		std::vector<unsigned char> data;
+		unsigned char buf[4096];
+		size_t n;
+		while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+			data.insert(data.end(), buf, buf + n);
+		fclose(f);
+
+		size_t offset = 8;
+		fileOk = data.size() >= 8 && memcmp(&data[0], "PELG", 4) == 0;
+		while (fileOk && offset < data.size())
+		{
+			unsigned char type = data[offset++];
+			PrimitiveTypes::UInt16 len;
+			if (type == 1) // site
+			{
+				offset += 13;
+				memcpy(&len, &data[offset - 2], 2);
+				offset += len;
+				memcpy(&len, &data[offset], 2);
+				offset += 2 + len;
+				offset += 1 + data[offset];
+			}
+			else if (type == 2) // message
+			{
+				offset += 13;
+				memcpy(&len, &data[offset - 2], 2);
+				offset += len;
+				numFileMessages++;
+			}
+			else if (type == 3) // dropped
+				offset += 5;
+			else
+				fileOk = false;
+		}
+	}
+
+	result.m_numFrames = 1;
+	result.setCounter("nsPerFilteredCall", filteredTime * 1e9 / numCalls);
+	result.setCounter("nsPerRateLimitedCall", rateLimitedTime * 1e9 / numCalls);
+	result.setCounter("nsPerQueuedCall", queuedTime * 1e9 / numQueued);
+	result.setCounter("nsPerSynchronousCall", syncTime * 1e9 / numQueued);
+	result.setCounter("recorded", numRecorded);
+	result.setCounter("rateLimited", numRateLimited);
+	result.setCounter("dropped", numDropped);
+	result.setCounter("written", s_benchmarkLogNumMessages);
+	result.setCounter("fileMessages", numFileMessages);
+	result.setCounter("mismatches", numMismatches);
+	result.m_ok = numMismatches == 0 && fileOk && numRecorded == s_benchmarkLogNumMessages &&
+		(PrimitiveTypes::UInt32)(numFileMessages) == s_benchmarkLogNumMessages &&
+		numRecorded + numDropped + numRateLimited == (PrimitiveTypes::UInt32)(numCalls + numQueued + numParallel) + 5; // filtered calls aren't recorded
+	result.m_runTime = totalTimer.TickAndGetTimeDeltaInSeconds();
+
+	if (wasRunning)
+		AsyncLog::Start(NULL);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// text: debug text strings written into TextBatcher vertex arrays every frame, like DebugRenderer does.
+// no gpu buffers on headless, so this is the cpu side only. quads and tex coords of verified frames are
+// compared with glyph table and string layout, and no Handles may be allocated while writing
+//////////////////////////////////////////////////////////////////////////
+
+void Benchmark::RunTextScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	int numStrings = (int)(GetNumberParam(context, result, "strings", 250));
+	int numChars = (int)(GetNumberParam(context, result, "chars", 40));
+	int numFrames = (int)(GetNumberParam(context, result, "frames", 300));
+	int verifyEvery = (int)(GetNumberParam(context, result, "verifyEvery", 30));
+	float worldRatio = (float)(GetNumberParam(context, result, "world", 0.1));
+
+	Timer timer;
+
+	Handle hBatcher("TEXT_BATCHER", sizeof(TextBatcher));
+	TextBatcher *pBatcher = new(hBatcher) TextBatcher(context, arena);
+
+	struct TextString
+	{
+		std::string m_text;
+		Vector3 m_pos;
+		float m_scale;
+		bool m_world;
+	};
+	std::vector<TextString> strings(numStrings);
+	for (int i = 0; i < numStrings; ++i)
+	{
+		TextString &s = strings[i];
+		s.m_text.resize(numChars);
+		for (int c = 0; c < numChars; ++c)
+			s.m_text[c] = (char)(32 + (int)(RandomFloat(0, 94.99f)));
+		s.m_world = RandomFloat(0, 1.0f) < worldRatio;
+		s.m_scale = s.m_world ? RandomFloat(0.05f, 0.5f) : RandomFloat(0.5f, 1.5f);
+		s.m_pos = s.m_world ? Vector3(RandomFloat(-50.0f, 50.0f), RandomFloat(0, 10.0f), RandomFloat(-50.0f, 50.0f))
+			: Vector3(RandomFloat(-1.0f, 0.5f), RandomFloat(-1.0f, 1.0f), 0);
+	}
+	result.m_setupTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	double numGlyphs = 0, numDropped = 0;
+	PrimitiveTypes::UInt32 numHandleAllocs = 0;
+	int numMismatches = 0, numVerified = 0;
+	for (int frame = 0; frame < numFrames; ++frame)
+	{
+		// strings move like labels of moving objects
+		for (int i = 0; i < numStrings; ++i)
+			strings[i].m_pos.m_y += strings[i].m_world ? PE_BENCHMARK_FRAME_TIME : 0;
+
+		PrimitiveTypes::UInt32 numBlocksBefore = MemoryManager::instance()->m_numBlocksAllocated;
+		{
+			BenchmarkTimer t(result, "write");
+			for (int i = 0; i < numStrings; ++i)
+			{
+				const TextString &s = strings[i];
+				if (s.m_world)
+					pBatcher->addWorldText(s.m_text.c_str(), s.m_pos, s.m_scale, (PrimitiveTypes::Int32)(s.m_text.size()));
+				else
+					pBatcher->addOverlayText(s.m_text.c_str(), s.m_pos.m_x, s.m_pos.m_y, s.m_scale, (PrimitiveTypes::Int32)(s.m_text.size()));
+			}
+		}
+		numHandleAllocs += MemoryManager::instance()->m_numBlocksAllocated - numBlocksBefore;
+
+		if (verifyEvery > 0 && (frame % verifyEvery == 0 || frame == numFrames - 1))
+		{
+			BenchmarkTimer t(result, "verify");
+			numVerified++;
+			PrimitiveTypes::UInt32 next[TextBatcher::Batch_Count] = {0, 0};
+			for (int i = 0; i < numStrings; ++i)
+			{
+				const TextString &s = strings[i];
+				TextBatcher::Batch batch = s.m_world ? TextBatcher::Batch_World : TextBatcher::Batch_Overlay;
+				Vector3 advance, down;
+				if (s.m_world)
+				{
+					advance = Vector3(s.m_scale, 0, 0);
+					down = Vector3(0, -2.0f * s.m_scale, 0);
+				}
+				else
+				{
+					float w = pBatcher->getOverlayGlyphWidth(s.m_scale);
+					advance = Vector3(w, 0, 0);
+					down = Vector3(0, -2.0f * w * pBatcher->m_aspectRatio, 0);
+				}
+
+				for (int c = 0; c < numChars; ++c)
+				{
+					PrimitiveTypes::UInt32 g = next[batch]++;
+					if (g >= pBatcher->getNumGlyphs(batch))
+						continue; // dropped
+					TextBatcher::Glyph ref;
+					TextBatcher::ComputeGlyph((unsigned char)(s.m_text[c]), ref);
+					Vector3 corners[4];
+					corners[0] = s.m_pos + (float)(c) * advance;
+					corners[1] = corners[0] + advance;
+					corners[2] = corners[1] + down;
+					corners[3] = corners[0] + down;
+					float refU[4] = {ref.m_u0, ref.m_u1, ref.m_u1, ref.m_u0};
+					float refV[4] = {ref.m_v0, ref.m_v0, ref.m_v1, ref.m_v1};
+					for (int v = 0; v < 4; ++v)
+					{
+						const PrimitiveTypes::Float32 *pPos = pBatcher->getPositions(batch) + (g * 4 + v) * TextBatcher::c_posStride;
+						const PrimitiveTypes::Float32 *pTc = pBatcher->getTexCoords(batch) + (g * 4 + v) * TextBatcher::c_texCoordStride;
+						// glyph origins are accumulated, allow for rounding
+						if ((Vector3(pPos[0], pPos[1], pPos[2]) - corners[v]).length() > 1e-3f * (1.0f + corners[v].length())
+							|| pTc[0] != refU[v] || pTc[1] != refV[v])
+							numMismatches++;
+					}
+				}
+			}
+			for (int b = 0; b < TextBatcher::Batch_Count; ++b)
+				if (pBatcher->getNumGlyphs((TextBatcher::Batch)(b)) != (next[b] < pBatcher->m_maxGlyphs[b] ? next[b] : pBatcher->m_maxGlyphs[b]))
+					numMismatches++;
+		}
+
+		pBatcher->nextFrame();
+		numGlyphs += pBatcher->m_lastFrameStats.m_numGlyphs;
+		numDropped += pBatcher->m_lastFrameStats.m_numDropped;
+		result.sampleMemory();
+	}
+
+	result.m_numFrames = numFrames;
+	double glyphsPerFrame = numFrames ? numGlyphs / numFrames : 0;
+	result.setCounter("glyphsPerFrame", glyphsPerFrame);
+	result.setCounter("droppedPerFrame", numFrames ? numDropped / numFrames : 0);
+	result.setCounter("handleAllocs", numHandleAllocs);
+	result.setCounter("verifiedFrames", numVerified);
+	result.setCounter("mismatches", numMismatches);
+	result.m_ok = numMismatches == 0 && numHandleAllocs == 0 && numDropped == 0 && glyphsPerFrame == (double)(numStrings) * numChars;
+	result.m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	hBatcher.release();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// hotreload: edits a script and a texture in a scratch package on disk (AssetsOut/HotReloadTest) and waits for
+// HotReloadManager to swap them in: script function returns the new value, same TextureGPU has size of new file.
+// then writes a script with syntax error, that has to be reported and old script kept
+//////////////////////////////////////////////////////////////////////////
+
+static bool writeBenchmarkFile(const char *path, const char *data, size_t size)
+{
+	FILE *f = fopen(path, "wb");
+	if (!f)
+		return false;
+	bool ok = fwrite(data, 1, size, f) == size;
+	fclose(f);
+	return ok;
+}
+
+static bool copyBenchmarkFile(const char *src, const char *dst)
+{
+	FILE *f = fopen(src, "rb");
+	if (!f)
+		return false;
+	std::string data;
+	char buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+		data.append(buf, n);
+	fclose(f);
+	return writeBenchmarkFile(dst, data.data(), data.size());
+}
+
+// one game frame of hot reload: swap whatever is ready
+static void hotReloadFrame(PE::GameContext &context, HotReloadManager *pManager, BenchmarkResult &result)
+{
+	bool replacesGPUResources;
+	if (pManager->hasReadyReloads(replacesGPUResources))
+	{
+		BenchmarkTimer t(result, "swap");
+		pManager->applyReadyReloads_needsRC(context.m_gameThreadThreadOwnershipMask);
+	}
+	result.m_numFrames++;
+	Threading::SleepMilliseconds(1);
+}
+
+void Benchmark::RunHotReloadScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	int numEdits = (int)(GetNumberParam(context, result, "edits", 5));
+	double timeoutMs = GetNumberParam(context, result, "timeout", 2000);
+	const char *smallTexture = GetStringParam(context, "smallTexture", "black.dds");
+	const char *bigTexture = GetStringParam(context, "bigTexture", "noise.dds");
+
+#if PE_PLAT_IS_LINUX
+	Timer timer;
+	lua_State *L = context.getLuaEnvironment()->L;
+	const char *root = context.getMainFunctionArgs()->gameProjRoot();
+
+	std::string package = std::string(root) + "AssetsOut/HotReloadTest";
+	std::string scriptsDir = package + "/Scripts/", texturesDir = package + "/Textures/";
+	std::string scriptPath = scriptsDir + "hr_script.lua", texturePath = texturesDir + "hr_texture.dds";
+	std::string smallPath = std::string(root) + "AssetsOut/Default/Textures/" + smallTexture;
+	std::string bigPath = std::string(root) + "AssetsOut/Default/Textures/" + bigTexture;
+	mkdir(package.c_str(), 0755);
+	mkdir(scriptsDir.c_str(), 0755);
+	mkdir(texturesDir.c_str(), 0755);
+
+	// texture managers are not part of headless engine, GPUTextureManager::Construct() would build a random texture
+	bool ownTextureManager = !GPUTextureManager::s_myHandle.isValid();
+	if (ownTextureManager)
+	{
+		GPUTextureManager::s_myHandle = Handle("GPU_TEXTURE_MANAGER", sizeof(GPUTextureManager));
+		new(GPUTextureManager::s_myHandle) GPUTextureManager(context, arena);
+	}
+	bool ownResidencyManager = !TextureResidencyManager::Instance();
+	if (ownResidencyManager)
+		TextureResidencyManager::Construct(context, arena);
+
+	char text[256];
+	sprintf(text, "function hotReloadTestValue() return %d end\n", 1);
+	bool ok = writeBenchmarkFile(scriptPath.c_str(), text, strlen(text)) && copyBenchmarkFile(smallPath.c_str(), texturePath.c_str());
+	ok = ok && context.getLuaEnvironment()->runScript(scriptPath.c_str());
+	Handle hTexture = GPUTextureManager::Instance()->createBumpTextureGPU("hr_texture.dds", "HotReloadTest");
+	TextureGPU *pTexture = hTexture.getObject<TextureGPU>();
+	PrimitiveTypes::UInt32 smallBytes = pTexture->m_residentBytes;
+
+	Handle hManager("HOT_RELOAD_MANAGER", sizeof(HotReloadManager));
+	HotReloadManager *pManager = new(hManager) HotReloadManager(context, arena);
+	const char *directories[] = {package.c_str()};
+	ok = ok && pManager->start(directories, 1);
+	result.m_setupTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	int numReloaded = 0, numMismatches = 0;
+	PrimitiveTypes::UInt32 bigBytes = 0;
+	double sumLatencyMs = 0, maxLatencyMs = 0;
+	for (int edit = 1; ok && edit <= numEdits; ++edit)
+	{
+		HotReloadManager::Stats before = pManager->getStats();
+		int value = edit + 1;
+		sprintf(text, "function hotReloadTestValue() return %d end\n", value);
+		bool big = edit % 2 == 1;
+		writeBenchmarkFile(scriptPath.c_str(), text, strlen(text));
+		copyBenchmarkFile(big ? bigPath.c_str() : smallPath.c_str(), texturePath.c_str());
+
+		Timer editTimer;
+		double waitedMs = 0;
+		HotReloadManager::Stats stats = before;
+		while (waitedMs < timeoutMs && (stats.m_numApplied[HotReloadManager::Kind_Script] == before.m_numApplied[HotReloadManager::Kind_Script] ||
+			stats.m_numApplied[HotReloadManager::Kind_Texture] == before.m_numApplied[HotReloadManager::Kind_Texture]))
+		{
+			hotReloadFrame(context, pManager, result);
+			stats = pManager->getStats();
+			waitedMs += editTimer.TickAndGetTimeDeltaInSeconds() * 1000.0;
+		}
+		if (waitedMs >= timeoutMs)
+		{
+			PEWARN("hotreload: edit %d was not reloaded in %.0f ms\n", edit, timeoutMs);
+			break;
+		}
+		numReloaded++;
+		sumLatencyMs += waitedMs;
+		maxLatencyMs = waitedMs > maxLatencyMs ? waitedMs : maxLatencyMs;
+
+		lua_getglobal(L, "hotReloadTestValue");
+		int got = lua_pcall(L, 0, 1, 0) == 0 ? (int)(lua_tonumber(L, -1)) : -1;
+		lua_pop(L, 1);
+		if (got != value)
+			numMismatches++;
+
+		// same TextureGPU, new file
+		if (big)
+			bigBytes = pTexture->m_residentBytes;
+		if (big ? pTexture->m_residentBytes == smallBytes : pTexture->m_residentBytes != smallBytes)
+			numMismatches++;
+	}
+
+	// syntax error is reported, old script stays
+	bool failureReported = false;
+	if (ok && numReloaded == numEdits)
+	{
+		HotReloadManager::Stats before = pManager->getStats();
+		const char *broken = "function hotReloadTestValue() return end end\n";
+		writeBenchmarkFile(scriptPath.c_str(), broken, strlen(broken));
+		Timer editTimer;
+		double waitedMs = 0;
+		while (waitedMs < timeoutMs && !failureReported)
+		{
+			hotReloadFrame(context, pManager, result);
+			failureReported = pManager->getStats().m_numFailed > before.m_numFailed;
+			waitedMs += editTimer.TickAndGetTimeDeltaInSeconds() * 1000.0;
+		}
+		lua_getglobal(L, "hotReloadTestValue");
+		int got = lua_pcall(L, 0, 1, 0) == 0 ? (int)(lua_tonumber(L, -1)) : -1;
+		lua_pop(L, 1);
+		if (got != numEdits + 1)
+			numMismatches++;
+	}
+
+	HotReloadManager::Stats stats = pManager->getStats();
+	pManager->stop();
+	result.m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	result.setCounter("reloadedEdits", numReloaded);
+	result.setCounter("avgLatencyMs", numReloaded ? sumLatencyMs / numReloaded : 0);
+	result.setCounter("maxLatencyMs", maxLatencyMs);
+	result.setCounter("maxSwapMs", stats.m_maxSwapMs);
+	result.setCounter("watchedDirectories", stats.m_numWatchedDirectories);
+	result.setCounter("textureBytesSmall", smallBytes);
+	result.setCounter("textureBytesBig", bigBytes);
+	result.setCounter("failureReported", failureReported ? 1 : 0);
+	result.setCounter("mismatches", numMismatches);
+	result.m_ok = ok && numReloaded == numEdits && numMismatches == 0 && failureReported && bigBytes != smallBytes &&
+		stats.m_maxSwapMs <= PE_HOT_RELOAD_FRAME_BUDGET_MS;
+
+	hManager.getObject<HotReloadManager>()->~HotReloadManager();
+	hManager.release();
+	if (ownResidencyManager)
+	{
+		TextureResidencyManager::s_myHandle.release();
+		TextureResidencyManager::s_myHandle = Handle();
+	}
+	if (ownTextureManager)
+	{
+		GPUTextureManager::s_myHandle.release();
+		GPUTextureManager::s_myHandle = Handle();
+	}
+
+	unlink(scriptPath.c_str());
+	unlink(texturePath.c_str());
+	rmdir(scriptsDir.c_str());
+	rmdir(texturesDir.c_str());
+	rmdir(package.c_str());
+#else
+	PEWARN("hotreload: no file watching on this platform\n");
+	result.m_ok = false;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+// lua: script side of level load (collectLevelAssets(), every object's meta script is dofile'd) with empty bytecode
+// cache, with cache in memory and from disk cache. source edited to same size has to be compiled again.
+// then event handler like functions called from engine every frame with and without profiler: profiler has to
+// find the function that takes time and allocates, and report has to be written
+//////////////////////////////////////////////////////////////////////////
+
+// runs collectLevelAssets(level, package), returns number of objects or -1
+static int collectLevelScripts(lua_State *L, const char *level, const char *package)
+{
+	lua_getglobal(L, "collectLevelAssets");
+	lua_pushstring(L, level);
+	lua_pushstring(L, package);
+	if (lua_pcall(L, 2, 2, 0) != 0)
+	{
+		PEINFO("Benchmark: collectLevelAssets failed: %s\n", lua_tostring(L, -1));
+		lua_pop(L, 1);
+		return -1;
+	}
+	int numObjects = (int)(lua_tonumber(L, -2));
+	lua_pop(L, 2);
+	return numObjects;
+}
+
+// loads script through cache and returns what it returns, or -1
+static int runCachedScript(LuaScriptCache &cache, lua_State *L, const char *path)
+{
+	if (cache.loadFile(L, path) != 0)
+	{
+		lua_pop(L, 1);
+		return -1;
+	}
+	int value = lua_pcall(L, 0, 1, 0) == 0 ? (int)(lua_tonumber(L, -1)) : -1;
+	lua_pop(L, 1);
+	return value;
+}
+
+void Benchmark::RunLuaScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	const char *level = GetStringParam(context, "level", "ccontrollvl0.x_level.levela");
+	const char *package = GetStringParam(context, "package", "CharacterControl");
+	int numPasses = (int)(GetNumberParam(context, result, "passes", 10));
+	int numFrames = (int)(GetNumberParam(context, result, "frames", 300));
+	int instructionsPerSample = (int)(GetNumberParam(context, result, "instructionsPerSample", PE_LUA_PROFILER_INSTRUCTIONS_PER_SAMPLE));
+
+	LuaEnvironment *pEnv = context.getLuaEnvironment();
+	lua_State *L = pEnv->L;
+	LuaScriptCache &cache = pEnv->m_scriptCache;
+	LuaProfiler &profiler = pEnv->m_profiler;
+	const char *root = context.getMainFunctionArgs()->gameProjRoot();
+	Timer timer;
+
+	std::string originalDiskDirectory(cache.getDiskDirectory());
+	std::string scratch = std::string(root) + "AssetsOut/.luacache_benchmark";
+	bool ok = true;
+
+	// compile, memory
+	cache.setDiskDirectory(NULL);
+	cache.clear();
+	LuaScriptCache::Stats before = cache.getStats();
+	Timer passTimer;
+	int numObjects = collectLevelScripts(L, level, package);
+	double coldMs = passTimer.TickAndGetTimeDeltaInSeconds() * 1000.0;
+	LuaScriptCache::Stats cold = cache.getStats();
+	ok = ok && numObjects > 0;
+
+	double warmMs = 0;
+	for (int pass = 1; ok && pass < numPasses; ++pass)
+	{
+		BenchmarkTimer t(result, "warmPass");
+		ok = collectLevelScripts(L, level, package) == numObjects;
+	}
+	warmMs = passTimer.TickAndGetTimeDeltaInSeconds() * 1000.0 / (numPasses > 1 ? numPasses - 1 : 1);
+	LuaScriptCache::Stats warm = cache.getStats();
+
+	// disk: first pass fills it, second one starts with empty memory
+	cache.setDiskDirectory(scratch.c_str());
+	cache.clear();
+	ok = ok && collectLevelScripts(L, level, package) == numObjects;
+	cache.clear();
+	LuaScriptCache::Stats beforeDisk = cache.getStats();
+	passTimer.Tick();
+	ok = ok && collectLevelScripts(L, level, package) == numObjects;
+	double diskMs = passTimer.TickAndGetTimeDeltaInSeconds() * 1000.0;
+	LuaScriptCache::Stats disk = cache.getStats();
+
+	// same size edit is not missed
+	std::string stalePath = scratch + "/stale_test.lua";
+	int staleValues[2] = {-1, -1};
+	LuaScriptCache::Stats beforeStale = cache.getStats();
+	for (int i = 0; i < 2; ++i)
+	{
+		FILE *f = fopen(stalePath.c_str(), "w");
+		if (f)
+		{
+			fprintf(f, "return %d\n", i + 1);
+			fclose(f);
+		}
+		staleValues[i] = runCachedScript(cache, L, stalePath.c_str());
+	}
+	LuaScriptCache::Stats stale = cache.getStats();
+	bool staleDetected = staleValues[0] == 1 && staleValues[1] == 2 && stale.m_numStale > beforeStale.m_numStale;
+	result.m_setupTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	// clean up scratch cache, back to cache of the game
+	remove(stalePath.c_str());
+#if PE_PLAT_IS_LINUX
+	if (DIR *pDir = opendir(scratch.c_str()))
+	{
+		while (struct dirent *pEntry = readdir(pDir))
+		{
+			if (pEntry->d_name[0] != '.')
+				remove((scratch + "/" + pEntry->d_name).c_str());
+		}
+		closedir(pDir);
+	}
+	rmdir(scratch.c_str());
+#endif
+	cache.setDiskDirectory(originalDiskDirectory.empty() ? NULL : originalDiskDirectory.c_str());
+	cache.clear();
+
+	// event handler like functions: one allocates a table per item, the other only adds numbers
+	ok = ok && pEnv->runString(
+		"function luaProfileHot() local t = {} for i = 1, 2000 do t[i] = { i, i * 2 } end return #t end\n"
+		"function luaProfileCold() local s = 0 for i = 1, 200 do s = s + i end return s end\n");
+	// first round warms up lua heap and is not counted
+	double frameMsOff = 0, frameMsOn = 0;
+	for (int round = 0; ok && round < 3; ++round)
+	{
+		bool withProfiler = round == 2;
+		if (withProfiler)
+		{
+			profiler.clear();
+			profiler.start(L, instructionsPerSample);
+		}
+		double sumMs = 0;
+		for (int frame = 0; frame < numFrames; ++frame)
+		{
+			pEnv->runFunction("luaProfileHot", 0, 0);
+			pEnv->runFunction("luaProfileCold", 0, 0);
+			profiler.frameEnd();
+			sumMs += profiler.m_lastFrameMs;
+			result.m_numFrames++;
+		}
+		if (round)
+			(withProfiler ? frameMsOn : frameMsOff) = sumMs / (numFrames ? numFrames : 1);
+	}
+	profiler.stop();
+
+	LuaProfiler::Stats profile = profiler.getStats();
+	float hotMs = profiler.getFunctionSelfMs("luaProfileHot");
+	float coldFunctionMs = profiler.getFunctionSelfMs("luaProfileCold");
+
+	// report has the function in both flame graphs
+	std::string reportPrefix = std::string(root) + "BenchmarkLuaProfile";
+	bool reportOk = profiler.writeReport(reportPrefix.c_str());
+	const char *suffixes[] = {".time.folded", ".alloc.folded", ".txt"};
+	for (int i = 0; i < 3; ++i)
+	{
+		std::string path = reportPrefix + suffixes[i];
+		if (i < 2)
+		{
+			bool found = false;
+			if (FILE *f = fopen(path.c_str(), "r"))
+			{
+				char line[1024];
+				while (!found && fgets(line, sizeof(line), f))
+					found = strstr(line, "luaProfileHot (") != NULL;
+				fclose(f);
+			}
+			reportOk = reportOk && found;
+		}
+		remove(path.c_str());
+	}
+	profiler.clear();
+	result.m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	result.sampleMemory();
+	result.setCounter("objects", numObjects);
+	result.setCounter("scripts", cold.m_numCompiles - before.m_numCompiles);
+	result.setCounter("coldPassMs", coldMs);
+	result.setCounter("warmPassMs", warmMs);
+	result.setCounter("diskPassMs", diskMs);
+	result.setCounter("warmSpeedup", warmMs > 0 ? coldMs / warmMs : 0);
+	result.setCounter("compileMs", cold.m_compileMs - before.m_compileMs);
+	result.setCounter("memoryHits", warm.m_numMemoryHits - cold.m_numMemoryHits);
+	result.setCounter("diskHits", disk.m_numDiskHits - beforeDisk.m_numDiskHits);
+	result.setCounter("bytecodeKB", warm.m_bytecodeBytes / 1024.0);
+	result.setCounter("staleDetected", staleDetected ? 1 : 0);
+	result.setCounter("luaFrameMs", frameMsOff);
+	result.setCounter("luaFrameMsProfiled", frameMsOn);
+	result.setCounter("samples", profile.m_numSamples);
+	result.setCounter("hotFunctionMs", hotMs);
+	result.setCounter("coldFunctionMs", coldFunctionMs);
+	result.setCounter("allocatedKB", profile.m_allocatedKB);
+	result.setCounter("reportOk", reportOk ? 1 : 0);
+
+	// every load of warm passes from memory, every script of disk pass from disk
+	PrimitiveTypes::UInt32 numScripts = cold.m_numCompiles - before.m_numCompiles;
+	PrimitiveTypes::UInt32 loadsPerPass = numScripts + cold.m_numMemoryHits - before.m_numMemoryHits;
+	result.m_ok = ok && numScripts > 0 &&
+		warm.m_numCompiles == cold.m_numCompiles && warm.m_numMemoryHits - cold.m_numMemoryHits == loadsPerPass * (numPasses - 1) &&
+		disk.m_numCompiles == beforeDisk.m_numCompiles && disk.m_numDiskHits - beforeDisk.m_numDiskHits == numScripts &&
+		staleDetected && profile.m_numSamples > 0 && hotMs > coldFunctionMs && profile.m_allocatedKB > 0 && reportOk;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// crowd: two blocks of agents walk through each other to swap sides, steered by CrowdSimulation every tick.
+// same ticks without avoidance give overlaps to compare with. first ticks are run again on workers and on one thread,
+// positions have to be bitwise the same
+//////////////////////////////////////////////////////////////////////////
+
+// agents of two blocks facing each other, goals on the other side. small offsets of goals break the symmetry
+static void SetupCrowd(CrowdSimulation &crowd, int count, float speed, std::vector<Vector3> &goals)
+{
+	const float spacing = 2.5f, gap = 10.0f;
+	int perBlock = (count + 1) / 2;
+	int cols = (int)(ceilf(sqrtf((float)(perBlock))));
+	float width = cols * spacing;
+
+	crowd.clear();
+	goals.resize(count);
+	for (int i = 0; i < count; ++i)
+	{
+		int block = i & 1, k = i >> 1;
+		float side = block ? 1.0f : -1.0f;
+
+		CrowdAgent agent;
+		agent.m_pos = Vector3(side * (0.5f * gap + (k / cols) * spacing), 0, (k % cols - 0.5f * cols) * spacing);
+		agent.m_maxSpeed = speed;
+		crowd.addAgent(agent);
+
+		goals[i] = Vector3(-side * (0.5f * gap + width - (k / cols) * spacing), 0, agent.m_pos.m_z + ((i * 7919) % 13 - 6) * 0.02f);
+	}
+}
+
+static void TickCrowd(CrowdSimulation &crowd, const std::vector<Vector3> &goals, float frameTime)
+{
+	for (PrimitiveTypes::UInt32 i = 0; i < crowd.getNumAgents(); ++i)
+	{
+		CrowdAgent &agent = crowd.getAgent(i);
+		Vector3 toGoal = goals[i] - agent.m_pos;
+		float dist = toGoal.length();
+		float speed = dist < agent.m_maxSpeed * frameTime ? dist / frameTime : agent.m_maxSpeed;
+		agent.m_preferredVelocity = dist > 0.0001f ? toGoal * (speed / dist) : Vector3();
+	}
+	crowd.step(frameTime);
+	crowd.integrate(frameTime);
+}
+
+void Benchmark::RunCrowdScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	int count = (int)(GetNumberParam(context, result, "count", 1000));
+	int numTicks = (int)(GetNumberParam(context, result, "ticks", 300));
+	int checkTicks = (int)(GetNumberParam(context, result, "checkTicks", 60));
+	int overlapEvery = (int)(GetNumberParam(context, result, "overlapEvery", 10));
+	float speed = (float)(GetNumberParam(context, result, "speed", 8.0));
+	float minProgress = (float)(GetNumberParam(context, result, "minProgress", 0.5));
+	checkTicks = checkTicks < numTicks ? checkTicks : numTicks;
+
+	Timer timer;
+
+	CrowdSimulation crowd(context, arena);
+	std::vector<Vector3> goals;
+	SetupCrowd(crowd, count, speed, goals);
+
+	std::vector<float> startDist(count);
+	for (int i = 0; i < count; ++i)
+		startDist[i] = (goals[i] - crowd.getAgent(i).m_pos).length();
+	result.m_setupTime = timer.TickAndGetTimeDeltaInSeconds();
+
+	// avoidance
+	std::vector<Vector3> checkPositions(count);
+	double totalMs = 0, maxMs = 0;
+	PrimitiveTypes::UInt32 overlaps = 0, maxOverlaps = 0;
+	for (int tick = 0; tick < numTicks; ++tick)
+	{
+		Timer::TimeType t0 = timer.TickAndGetCurrentTime();
+		{
+			BenchmarkTimer t(result, "crowd");
+			TickCrowd(crowd, goals, PE_BENCHMARK_FRAME_TIME);
+		}
+		double ms = Timer::GetTimeDeltaInSeconds(t0, timer.TickAndGetCurrentTime()) * 1000.0;
+		totalMs += ms;
+		maxMs = ms > maxMs ? ms : maxMs;
+
+		if (tick + 1 == checkTicks)
+		{
+			for (int i = 0; i < count; ++i)
+				checkPositions[i] = crowd.getAgent(i).m_pos;
+		}
+		if (overlapEvery > 0 && (tick % overlapEvery == 0 || tick == numTicks - 1))
+		{
+			PrimitiveTypes::UInt32 n = crowd.countOverlaps(0.9f);
+			overlaps += n;
+			maxOverlaps = n > maxOverlaps ? n : maxOverlaps;
+		}
+		result.sampleMemory();
+	}
+
+	// progress: distance covered towards goals compared to walking there alone
+	double progress = 0;
+	float freeDist = speed * PE_BENCHMARK_FRAME_TIME * numTicks;
+	for (int i = 0; i < count; ++i)
+	{
+		float covered = startDist[i] - (goals[i] - crowd.getAgent(i).m_pos).length();
+		float possible = startDist[i] < freeDist ? startDist[i] : freeDist;
+		progress += possible > 0 ? covered / possible : 1.0f;
+	}
+	progress = count ? progress / count : 1.0;
+
+	// no avoidance, same ticks
+	PrimitiveTypes::UInt32 overlapsWithout = 0;
+	{
+		BenchmarkTimer t(result, "withoutAvoidance");
+		SetupCrowd(crowd, count, speed, goals);
+		crowd.m_avoidance = false;
+		for (int tick = 0; tick < numTicks; ++tick)
+		{
+			TickCrowd(crowd, goals, PE_BENCHMARK_FRAME_TIME);
+			if (overlapEvery > 0 && (tick % overlapEvery == 0 || tick == numTicks - 1))
+				overlapsWithout += crowd.countOverlaps(0.9f);
+		}
+		crowd.m_avoidance = true;
+	}
+
+	// determinism: again on workers, then on calling thread only
+	int numDifferent = 0;
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		BenchmarkTimer t(result, "determinism");
+		SetupCrowd(crowd, count, speed, goals);
+		crowd.m_serial = pass == 1;
+		for (int tick = 0; tick < checkTicks; ++tick)
+			TickCrowd(crowd, goals, PE_BENCHMARK_FRAME_TIME);
+		crowd.m_serial = false;
+
+		for (int i = 0; i < count; ++i)
+		{
+			if (memcmp(&checkPositions[i], &crowd.getAgent(i).m_pos, sizeof(Vector3)) != 0)
+				numDifferent++;
+		}
+	}
+
+	result.m_numFrames = numTicks;
+	result.setCounter("agents", count);
+	result.setCounter("msPerTick", numTicks ? totalMs / numTicks : 0);
+	result.setCounter("maxMsPerTick", maxMs);
+	result.setCounter("overlaps", overlaps);
+	result.setCounter("maxOverlaps", maxOverlaps);
+	result.setCounter("overlapsWithoutAvoidance", overlapsWithout);
+	result.setCounter("progress", progress);
+	result.setCounter("nondeterministicAgents", numDifferent);
+	result.m_ok = numDifferent == 0 && progress >= minProgress && (overlapsWithout == 0 || overlaps * 10 < overlapsWithout);
+	result.m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// level: runs level script and object meta scripts (collectLevelAssets() in scenario script)
+// and reads every referenced mesh with its buffers on cpu
+//////////////////////////////////////////////////////////////////////////
+
+void Benchmark::RunLevelScenario(PE::GameContext &context, PE::MemoryArena arena, BenchmarkResult &result)
+{
+	const char *level = GetStringParam(context, "level", "ccontrollvl0.x_level.levela");
+	const char *package = GetStringParam(context, "package", "CharacterControl");
+
+	lua_State *L = context.getLuaEnvironment()->L;
+
+	Timer timer;
+
+	// collectLevelAssets(level, package) returns number of objects and array of {mesh, package}
+	int numObjects = 0;
+	std::vector<std::pair<std::string, std::string> > meshes;
+	{
+		BenchmarkTimer t(result, "scripts");
+		lua_getglobal(L, "collectLevelAssets");
+		lua_pushstring(L, level);
+		lua_pushstring(L, package);
+		if (lua_pcall(L, 2, 2, 0) != 0)
+		{
+			PEINFO("Benchmark: collectLevelAssets failed: %s\n", lua_tostring(L, -1));
+			lua_pop(L, 1);
+			result.m_ok = false;
+			return;
+		}
+
+		numObjects = (int)(lua_tonumber(L, -2));
+		int numMeshes = (int)(lua_objlen(L, -1));
+		for (int i = 1; i <= numMeshes; ++i)
+		{
+			lua_rawgeti(L, -1, i);
+			lua_rawgeti(L, -1, 1);
+			lua_rawgeti(L, -2, 2);
+			meshes.push_back(std::make_pair(std::string(lua_tostring(L, -2)), std::string(lua_tostring(L, -1))));
+			lua_pop(L, 3);
+		}
+		lua_pop(L, 2);
+	}
+
+	// like MeshManager, every mesh is read once no matter how many objects use it
+	std::set<std::pair<std::string, std::string> > uniqueMeshes(meshes.begin(), meshes.end());
+	double numVertices = 0;
+	{
+		BenchmarkTimer t(result, "meshes");
+		for (std::set<std::pair<std::string, std::string> >::iterator it = uniqueMeshes.begin(); it != uniqueMeshes.end(); ++it)
+		{
+			MeshCPU mesh(context, arena);
+			mesh.ReadMesh(it->first.c_str(), it->second.c_str(), "");
+			numVertices += mesh.m_hPositionBufferCPU.getObject<PositionBufferCPU>()->m_values.m_size / 3;
+		}
+	}
+
+	result.sampleMemory();
+	result.m_numFrames = 1;
+	result.setCounter("objects", numObjects);
+	result.setCounter("meshInstances", (double)(meshes.size()));
+	result.setCounter("meshes", (double)(uniqueMeshes.size()));
+	result.setCounter("vertices", numVertices);
+	result.m_ok = numObjects > 0;
+	result.m_setupTime = 0;
+	result.m_runTime = timer.TickAndGetTimeDeltaInSeconds();
+}
+
+}; // namespace PE
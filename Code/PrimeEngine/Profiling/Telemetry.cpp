@@ -0,0 +1,355 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+#include "Telemetry.h"
+
+// Outer-Engine includes
+#include <string.h>
+
+// Inter-Engine includes
+extern "C"
+{
+#include "PrimeEngine/../luasocket_dist/src/inet.h"
+};
+
+#include "PrimeEngine/MemoryManagement/MemoryManager.h"
+#include "PrimeEngine/Game/Client/ClientGame.h"
+#include "PrimeEngine/Game/Server/ServerGame.h"
+#include "PrimeEngine/Networking/Client/ClientNetworkManager.h"
+#include "PrimeEngine/Networking/ConnectionManager.h"
+#include "PrimeEngine/Networking/EventManager.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+using namespace Components;
+
+Handle Telemetry::s_myHandle;
+
+static void writeU8(std::vector<char> &buf, PrimitiveTypes::UInt32 v)
+{
+	buf.push_back((char)(v & 0xff));
+}
+
+static void writeU16(std::vector<char> &buf, PrimitiveTypes::UInt32 v)
+{
+	buf.push_back((char)(v & 0xff));
+	buf.push_back((char)((v >> 8) & 0xff));
+}
+
+static void writeU32(std::vector<char> &buf, PrimitiveTypes::UInt32 v)
+{
+	buf.push_back((char)(v & 0xff));
+	buf.push_back((char)((v >> 8) & 0xff));
+	buf.push_back((char)((v >> 16) & 0xff));
+	buf.push_back((char)((v >> 24) & 0xff));
+}
+
+static void writeF32(std::vector<char> &buf, PrimitiveTypes::Float32 v)
+{
+	PrimitiveTypes::UInt32 bits;
+	memcpy(&bits, &v, 4);
+	writeU32(buf, bits);
+}
+
+// writes record header and returns its position. size is filled in by endRecord()
+static int beginRecord(std::vector<char> &buf, Telemetry::ERecordType type)
+{
+	int start = (int)(buf.size());
+	writeU8(buf, type);
+	writeU8(buf, 0);
+	writeU16(buf, 0);
+	return start;
+}
+
+static void endRecord(std::vector<char> &buf, int start)
+{
+	int size = (int)(buf.size()) - start;
+	PEASSERT(size < 0x10000, "Telemetry record too big");
+	buf[start + 2] = (char)(size & 0xff);
+	buf[start + 3] = (char)((size >> 8) & 0xff);
+}
+
+Telemetry::Telemetry(PE::GameContext &context, PE::MemoryArena arena)
+: m_pContext(&context)
+, m_arena(arena)
+, m_listening(false)
+, m_port(0)
+, m_frameIndex(0)
+, m_numEventsSinceSample(0)
+, m_numSamplesDropped(0)
+{
+	openListenSocket();
+}
+
+Telemetry::~Telemetry()
+{
+	for (unsigned int i = 0; i < m_readers.size(); ++i)
+		socket_destroy(&m_readers[i].m_sock);
+
+	if (m_listening)
+		socket_destroy(&m_listenSock);
+}
+
+void Telemetry::openListenSocket()
+{
+	// local tools only
+	for (int port = PE_TELEMETRY_PORT; port < PE_TELEMETRY_PORT + 10; ++port)
+	{
+		const char *err = inet_trycreate(&m_listenSock, SOCK_STREAM);
+		if (err)
+			break;
+
+		err = inet_trybind(&m_listenSock, "127.0.0.1", (unsigned short)(port));
+		if (!err)
+			err = inet_trylisten(&m_listenSock, PE_TELEMETRY_MAX_READERS);
+
+		if (!err)
+		{
+			socket_setnonblocking(&m_listenSock);
+			m_listening = true;
+			m_port = (unsigned short)(port);
+			PEINFO("PE: Telemetry: listening on port %d\n", port);
+			return;
+		}
+
+		socket_destroy(&m_listenSock);
+	}
+
+	PEINFO("PE: Warning: Telemetry: could not open listening socket\n");
+}
+
+void Telemetry::acceptReaders()
+{
+	t_timeout timeout;
+	timeout.block = 0;
+	timeout.total = -1.0;
+	timeout.start = 0;
+
+	while (true)
+	{
+		t_socket sock;
+		if (socket_accept(&m_listenSock, &sock, NULL, NULL, &timeout) != IO_DONE)
+			return;
+
+		if (m_readers.size() >= PE_TELEMETRY_MAX_READERS)
+		{
+			socket_destroy(&sock);
+			continue;
+		}
+
+		socket_setnonblocking(&sock);
+
+		m_readers.push_back(Reader());
+		Reader &reader = m_readers.back();
+		reader.m_sock = sock;
+		reader.m_rate = PE_TELEMETRY_DEFAULT_RATE;
+		reader.m_timeSinceSample = 0;
+		reader.m_framesSinceSample = 0;
+		reader.m_maxFrameTime = 0;
+		reader.m_numEventsSinceSample = 0;
+		reader.m_controlBytes = 0;
+
+		writeHello(reader.m_pending, reader.m_rate);
+	}
+}
+
+bool Telemetry::receiveControl(Reader &reader)
+{
+	t_timeout timeout;
+	timeout.block = 0;
+	timeout.total = -1.0;
+	timeout.start = 0;
+
+	while (true)
+	{
+		size_t got = 0;
+		int err = socket_recv(&reader.m_sock, &reader.m_control[reader.m_controlBytes], 4 - reader.m_controlBytes, &got, &timeout);
+		if (err == IO_TIMEOUT)
+			return true;
+		if (err != IO_DONE)
+			return false; // closed
+
+		reader.m_controlBytes += (int)(got);
+		if (reader.m_controlBytes == 4)
+		{
+			const unsigned char *c = (const unsigned char *)(reader.m_control);
+			PrimitiveTypes::UInt32 rate = c[0] | (c[1] << 8) | (c[2] << 16) | ((PrimitiveTypes::UInt32)(c[3]) << 24);
+			reader.m_rate = rate < 1 ? 1 : (rate > PE_TELEMETRY_MAX_RATE ? PE_TELEMETRY_MAX_RATE : rate);
+			reader.m_controlBytes = 0;
+		}
+	}
+}
+
+bool Telemetry::flush(Reader &reader)
+{
+	t_timeout timeout;
+	timeout.block = 0;
+	timeout.total = -1.0;
+	timeout.start = 0;
+
+	while (reader.m_pending.size())
+	{
+		size_t sent = 0;
+		int err = socket_send(&reader.m_sock, &reader.m_pending[0], reader.m_pending.size(), &sent, &timeout);
+		if (sent)
+			reader.m_pending.erase(reader.m_pending.begin(), reader.m_pending.begin() + sent);
+		if (err == IO_TIMEOUT)
+			return true; // socket buffer is full, rest goes out next frame
+		if (err != IO_DONE)
+			return false;
+	}
+	return true;
+}
+
+void Telemetry::frameEnd()
+{
+	m_frameIndex++;
+
+	if (!m_listening)
+		return;
+
+	acceptReaders();
+
+	ClientGame *pGame = (ClientGame *)(m_pContext->getGame());
+	PrimitiveTypes::Float32 frameTime = pGame ? pGame->m_frameTime : 0;
+
+	for (unsigned int i = 0; i < m_readers.size();)
+	{
+		Reader &reader = m_readers[i];
+
+		reader.m_timeSinceSample += frameTime;
+		reader.m_framesSinceSample++;
+		reader.m_numEventsSinceSample += m_numEventsSinceSample;
+		if (frameTime > reader.m_maxFrameTime)
+			reader.m_maxFrameTime = frameTime;
+
+		bool ok = receiveControl(reader);
+
+		if (ok && reader.m_timeSinceSample * reader.m_rate >= 1.0f)
+		{
+			// don't let a stalled reader grow the buffer, drop sample instead
+			if (reader.m_pending.size() < PE_TELEMETRY_MAX_PENDING_BYTES)
+				writeSample(reader.m_pending, reader);
+			else
+				m_numSamplesDropped++;
+
+			reader.m_timeSinceSample = 0;
+			reader.m_framesSinceSample = 0;
+			reader.m_maxFrameTime = 0;
+			reader.m_numEventsSinceSample = 0;
+		}
+
+		if (ok)
+			ok = flush(reader);
+
+		if (!ok)
+		{
+			socket_destroy(&reader.m_sock);
+			m_readers.erase(m_readers.begin() + i);
+			continue;
+		}
+		++i;
+	}
+
+	m_numEventsSinceSample = 0;
+}
+
+void Telemetry::writeHello(std::vector<char> &buf, PrimitiveTypes::UInt32 rate)
+{
+	int rec = beginRecord(buf, Record_Hello);
+	writeU32(buf, PE_TELEMETRY_PROTOCOL_VERSION);
+	writeU32(buf, rate);
+	writeU16(buf, N_MEMORY_POOLS);
+	for (unsigned int i = 0; i < N_MEMORY_POOLS; i++)
+	{
+		MemoryPool *pPool = MemoryManager::instance()->m_memoryPools[i * 4];
+		writeU32(buf, pPool->getBlockSize());
+		writeU32(buf, pPool->getNumBlocks());
+	}
+	endRecord(buf, rec);
+}
+
+void Telemetry::writeSample(std::vector<char> &buf, Reader &reader)
+{
+	// frame
+	{
+		ClientGame *pGame = (ClientGame *)(m_pContext->getGame());
+
+		int rec = beginRecord(buf, Record_Frame);
+		writeU32(buf, m_frameIndex);
+		writeU32(buf, reader.m_framesSinceSample);
+		writeF32(buf, pGame->m_gameTime);
+		writeF32(buf, reader.m_maxFrameTime);
+		writeF32(buf, pGame->m_frameTime);
+		writeF32(buf, pGame->m_gameTimeBetweenFrames);
+		writeF32(buf, pGame->m_gameThreadPreDrawFrameTime);
+		writeF32(buf, pGame->m_gameThreadDrawWaitFrameTime);
+		writeF32(buf, pGame->m_gameThreadDrawFrameTime);
+		writeF32(buf, pGame->m_gameThreadPostDrawFrameTime);
+		writeU32(buf, reader.m_numEventsSinceSample);
+		endRecord(buf, rec);
+	}
+
+	// pool occupancy
+	{
+		int rec = beginRecord(buf, Record_Pools);
+		writeU16(buf, N_MEMORY_POOLS);
+		for (unsigned int i = 0; i < N_MEMORY_POOLS; i++)
+		{
+			MemoryPool *pPool = MemoryManager::instance()->m_memoryPools[i * 4];
+			writeU32(buf, pPool->getNumBlocks() - pPool->getNumFreeBlocks());
+		}
+		endRecord(buf, rec);
+	}
+
+	// client connection
+	ClientNetworkManager *pNM = (ClientNetworkManager *)(m_pContext->getNetworkManager());
+	if (pNM)
+	{
+		pNM->m_netContextLock.lock();
+
+		NetworkContext &netContext = pNM->getNetworkContext();
+		ConnectionManager *pCM = netContext.getConnectionManager();
+		EventManager *pEM = netContext.getEventManager();
+
+		int rec = beginRecord(buf, Record_Network);
+		writeU8(buf, pCM && pCM->connected() ? 1 : 0);
+		writeU8(buf, pCM ? pCM->getTransport() : 0);
+		writeU32(buf, pCM ? pCM->m_numBytesSent : 0);
+		writeU32(buf, pCM ? pCM->m_numBytesReceived : 0);
+		writeU32(buf, pEM ? pEM->m_numEventsScheduled : 0);
+		writeU32(buf, pEM ? pEM->m_numEventsResent : 0);
+		writeU32(buf, pEM ? pEM->m_numDuplicateEventsReceived : 0);
+		writeU32(buf, pCM ? pCM->m_sendQueueBytes : 0);
+		writeU32(buf, pCM ? pCM->m_udpNumPacketsSent : 0);
+		writeU32(buf, pCM ? pCM->m_udpNumPacketsLost : 0);
+		writeF32(buf, pCM ? (PrimitiveTypes::Float32)(pCM->m_udpRtt * 1000.0) : 0);
+		endRecord(buf, rec);
+
+		pNM->m_netContextLock.unlock();
+	}
+
+	// server running in this process
+	ServerGame *pServerGame = (ServerGame *)(ServerGame::s_context.getGame());
+	if (pServerGame)
+	{
+		ServerGame::TickStats stats = pServerGame->m_lastTickStats;
+		double total = stats.m_cpuTime + stats.m_idleTime;
+
+		int rec = beginRecord(buf, Record_ServerTick);
+		writeU16(buf, pServerGame->m_tickRate);
+		writeU32(buf, stats.m_numTicks);
+		writeF32(buf, stats.m_numTicks ? (PrimitiveTypes::Float32)(stats.m_cpuTime * 1000.0 / stats.m_numTicks) : 0);
+		writeF32(buf, (PrimitiveTypes::Float32)(stats.m_maxTickCpuTime * 1000.0));
+		writeF32(buf, total > 0 ? (PrimitiveTypes::Float32)(stats.m_idleTime * 100.0 / total) : 0);
+		writeU32(buf, stats.m_numSkippedTicks);
+		endRecord(buf, rec);
+	}
+
+	endRecord(buf, beginRecord(buf, Record_SampleEnd));
+}
+
+}; // namespace PE
@@ -0,0 +1,120 @@
+#ifndef __PYENGINE_2_0_TELEMETRY_H__
+#define __PYENGINE_2_0_TELEMETRY_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <vector>
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/PEClassDecl.h"
+#include "PrimeEngine/Game/Common/GameContext.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+extern "C"
+{
+#include "PrimeEngine/../luasocket_dist/src/socket.h"
+};
+
+// Sibling/Children includes
+
+// bump when record layout changes. Tools/PyClient/telemetry.py has to match
+#define PE_TELEMETRY_PROTOCOL_VERSION 1
+
+namespace PE {
+
+// Streams binary samples of engine stats to local tcp readers (Tools/PyClient/telemetry.py).
+// Readers connect to PE_TELEMETRY_PORT and may send a little endian u32 at any time to set their sample rate in Hz.
+// Every sample is a sequence of records, all values little endian:
+//   record header: u8 type, u8 0, u16 size of record including header
+//   Record_Hello (sent once on connect): u32 version, u32 rate, u16 numPools, numPools x (u32 blockSize, u32 numBlocks)
+//   Record_Frame: u32 frame index, u32 frames since last sample, f32 game time, f32 max frame time since last sample,
+//     f32 frame time, f32 between frames, f32 pre draw, f32 draw wait, f32 draw, f32 post draw, u32 events since last sample
+//   Record_Pools: u16 numPools, numPools x u32 used blocks
+//   Record_Network: u8 connected, u8 transport, u32 bytes sent, u32 bytes received, u32 events scheduled,
+//     u32 events resent, u32 duplicate events received, u32 send queue bytes, u32 udp packets sent, u32 udp packets lost, f32 udp rtt ms
+//   Record_ServerTick (last server report interval): u16 tick rate, u32 ticks, f32 avg cpu ms, f32 max cpu ms, f32 idle percent, u32 skipped ticks
+//   Record_SampleEnd: no data
+// Network and server records are only present if there is a network manager/server.
+// Counters are totals since start, readers compute rates from differences.
+struct Telemetry : PE::PEAllocatableAndDefragmentable
+{
+	enum ERecordType
+	{
+		Record_Hello = 1,
+		Record_Frame,
+		Record_Pools,
+		Record_Network,
+		Record_ServerTick,
+		Record_SampleEnd,
+		Record_Count
+	};
+
+	Telemetry(PE::GameContext &context, PE::MemoryArena arena);
+	~Telemetry();
+
+	static void Construct(PE::GameContext &context, PE::MemoryArena arena)
+	{
+		s_myHandle = Handle("TELEMETRY", sizeof(Telemetry));
+		/* Telemetry *pTelemetry = */ new(s_myHandle) Telemetry(context, arena);
+	}
+
+	static Telemetry *Instance()
+	{
+		return s_myHandle.isValid() ? s_myHandle.getObject<Telemetry>() : NULL;
+	}
+
+	// counts events processed by game thread this frame
+	void addEvents(PrimitiveTypes::UInt32 numEvents) { m_numEventsSinceSample += numEvents; }
+
+	// called by game thread at end of frame, after frame times are stored in game.
+	// accepts readers, reads their rate requests and sends samples to readers that are due
+	void frameEnd();
+
+	struct Reader
+	{
+		t_socket m_sock;
+		PrimitiveTypes::UInt32 m_rate; // samples per second
+		PrimitiveTypes::Float32 m_timeSinceSample;
+		PrimitiveTypes::UInt32 m_framesSinceSample;
+		PrimitiveTypes::Float32 m_maxFrameTime;
+		PrimitiveTypes::UInt32 m_numEventsSinceSample;
+		std::vector<char> m_pending; // not sent yet since socket buffer was full
+		char m_control[4]; // partially received rate request
+		int m_controlBytes;
+	};
+
+	static Handle s_myHandle;
+
+	PE::GameContext *m_pContext;
+	PE::MemoryArena m_arena;
+
+	t_socket m_listenSock;
+	bool m_listening;
+	unsigned short m_port;
+
+	std::vector<Reader> m_readers;
+
+	PrimitiveTypes::UInt32 m_frameIndex;
+	PrimitiveTypes::UInt32 m_numEventsSinceSample; // since last frameEnd()
+	PrimitiveTypes::UInt32 m_numSamplesDropped; // reader was too slow
+
+private:
+	void openListenSocket();
+	void acceptReaders();
+	// false if reader disconnected
+	bool receiveControl(Reader &reader);
+	bool flush(Reader &reader);
+
+	// appends records to buffer
+	void writeHello(std::vector<char> &buf, PrimitiveTypes::UInt32 rate);
+	void writeSample(std::vector<char> &buf, Reader &reader);
+};
+
+}; // namespace PE
+
+#endif
@@ -0,0 +1,154 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <string.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Utils/ErrorHandling.h"
+
+// Sibling/Children includes
+#include "ConstantBufferRing.h"
+
+namespace PE {
+
+using namespace PrimitiveTypes;
+
+ConstantBufferRing::ConstantBufferRing()
+: m_pBackend(NULL)
+, m_size(0)
+, m_alignment(1)
+, m_head(0)
+, m_numBytesInUse(0)
+, m_numFrameBytes(0)
+, m_firstPendingFrame(0)
+, m_numPendingFrames(0)
+{
+	memset(&m_stats, 0, sizeof(m_stats));
+	memset(&m_lastFrameStats, 0, sizeof(m_lastFrameStats));
+}
+
+void ConstantBufferRing::initialize(ConstantBufferRingBackend *pBackend, UInt32 size, UInt32 alignment)
+{
+	PEASSERT(alignment && (alignment & (alignment - 1)) == 0, "Ring alignment has to be power of 2");
+	PEASSERT(size % alignment == 0, "Ring size has to be multiple of alignment");
+
+	m_pBackend = pBackend;
+	m_size = size;
+	m_alignment = alignment;
+	m_head = 0;
+	m_numBytesInUse = 0;
+	m_numFrameBytes = 0;
+	m_firstPendingFrame = 0;
+	m_numPendingFrames = 0;
+}
+
+bool ConstantBufferRing::releaseOldestFrame(bool wait)
+{
+	PendingFrame &frame = m_pendingFrames[m_firstPendingFrame];
+	if (!m_pBackend->isFenceComplete(frame.m_fence))
+	{
+		if (!wait)
+			return false;
+		m_pBackend->waitForFence(frame.m_fence);
+		m_stats.m_numFenceWaits++;
+	}
+
+	m_numBytesInUse -= frame.m_numBytes;
+	m_firstPendingFrame = (m_firstPendingFrame + 1) % c_maxPendingFrames;
+	m_numPendingFrames--;
+	return true;
+}
+
+bool ConstantBufferRing::allocate(UInt32 size, UInt32 &offset)
+{
+	UInt32 alignedSize = (size + m_alignment - 1) & ~(m_alignment - 1);
+
+	// bytes in use are [m_head - m_numBytesInUse, m_head) wrapped around, allocation goes right after them
+	UInt32 start, skipped;
+	for (;;)
+	{
+		if (m_numBytesInUse == 0)
+			m_head = 0; // empty, no need to skip end of buffer
+
+		start = m_head;
+		skipped = 0;
+		if (start + alignedSize > m_size)
+		{
+			skipped = m_size - start;
+			start = 0;
+		}
+
+		if (m_numBytesInUse + skipped + alignedSize <= m_size)
+			break;
+
+		if (m_numPendingFrames == 0)
+		{
+			// current frame alone fills the ring
+			m_stats.m_numOverflows++;
+			return false;
+		}
+		releaseOldestFrame(true);
+	}
+
+	m_head = start + alignedSize;
+	if (skipped || m_head == m_size)
+		m_stats.m_numWraps++;
+	if (m_head == m_size)
+		m_head = 0;
+	m_numBytesInUse += skipped + alignedSize;
+	m_numFrameBytes += skipped + alignedSize;
+	m_stats.m_numAllocations++;
+
+	offset = start;
+	return true;
+}
+
+bool ConstantBufferRing::uploadAndBind(UInt32 slot, const void *pData, UInt32 size)
+{
+	if (!m_pBackend)
+		return false;
+
+	UInt32 offset;
+	if (!allocate(size, offset))
+		return false;
+
+	void *pDest = m_pBackend->map(offset, size);
+	memcpy(pDest, pData, size);
+	m_pBackend->unmap(offset, size);
+
+	m_pBackend->bindRange(slot, offset, size);
+
+	countUpload(size, 1);
+	return true;
+}
+
+void ConstantBufferRing::beginFrame()
+{
+	if (!m_pBackend)
+		return;
+
+	while (m_numPendingFrames && releaseOldestFrame(false))
+	{}
+}
+
+void ConstantBufferRing::endFrame()
+{
+	if (m_pBackend)
+	{
+		if (m_numPendingFrames == c_maxPendingFrames)
+			releaseOldestFrame(true);
+
+		PendingFrame &frame = m_pendingFrames[(m_firstPendingFrame + m_numPendingFrames) % c_maxPendingFrames];
+		frame.m_fence = m_pBackend->insertFence();
+		frame.m_numBytes = m_numFrameBytes;
+		m_numPendingFrames++;
+		m_numFrameBytes = 0;
+	}
+
+	m_lastFrameStats = m_stats;
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+}; // namespace PE
@@ -0,0 +1,114 @@
+#ifndef __PYENGINE_2_0_CONSTANT_BUFFER_RING_H__
+#define __PYENGINE_2_0_CONSTANT_BUFFER_RING_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+// Gpu memory behind a ConstantBufferRing. D3D11 implementation is in D3D11Renderer.cpp,
+// benchmark has a cpu only one that checks ring never hands out memory gpu still reads
+struct ConstantBufferRingBackend
+{
+	virtual ~ConstantBufferRingBackend() {}
+
+	// cpu pointer to write [offset, offset + size) of ring memory
+	virtual void *map(PrimitiveTypes::UInt32 offset, PrimitiveTypes::UInt32 size) = 0;
+	virtual void unmap(PrimitiveTypes::UInt32 offset, PrimitiveTypes::UInt32 size) = 0;
+
+	// binds [offset, offset + size) as constant buffer slot of all shader stages
+	virtual void bindRange(PrimitiveTypes::UInt32 slot, PrimitiveTypes::UInt32 offset, PrimitiveTypes::UInt32 size) = 0;
+
+	// fence after all gpu work submitted so far. fences complete in order
+	virtual PrimitiveTypes::UInt32 insertFence() = 0;
+	virtual bool isFenceComplete(PrimitiveTypes::UInt32 fence) = 0;
+	virtual void waitForFence(PrimitiveTypes::UInt32 fence) = 0;
+};
+
+// Linear allocator of shader constants over one large gpu buffer. Allocations of a frame follow each other,
+// endFrame() closes them with a fence and their bytes are reused only after the fence completes.
+// Allocation that doesn't fit before the end of buffer wraps to 0, skipped bytes are released with the frame.
+// Render thread only.
+struct ConstantBufferRing
+{
+	static const PrimitiveTypes::UInt32 c_maxPendingFrames = PE_NUM_FRAMES_IN_FLIGHT + 2;
+
+	struct Stats
+	{
+		PrimitiveTypes::UInt32 m_numBytesUploaded; // also by uploads that bypass ring (countUpload())
+		PrimitiveTypes::UInt32 m_numBinds;
+		PrimitiveTypes::UInt32 m_numAllocations;
+		PrimitiveTypes::UInt32 m_numWraps;
+		PrimitiveTypes::UInt32 m_numFenceWaits; // allocations that waited for gpu to free space
+		PrimitiveTypes::UInt32 m_numOverflows; // allocations that didn't fit even in empty ring
+	};
+
+	ConstantBufferRing();
+
+	// size in bytes, alignment is power of 2 (offset granularity of backend's bindRange())
+	void initialize(ConstantBufferRingBackend *pBackend, PrimitiveTypes::UInt32 size, PrimitiveTypes::UInt32 alignment);
+
+	// apis without offset binds don't have a backend and upload constants the old way
+	bool isActive() { return m_pBackend != NULL; }
+
+	// false if size bytes don't fit even after waiting for all previous frames
+	bool allocate(PrimitiveTypes::UInt32 size, PrimitiveTypes::UInt32 &offset);
+
+	// copies data into ring and binds it to slot. false if ring is not active or out of space,
+	// then caller uploads data the old way
+	bool uploadAndBind(PrimitiveTypes::UInt32 slot, const void *pData, PrimitiveTypes::UInt32 size);
+
+	// for stats of uploads that don't go through ring
+	void countUpload(PrimitiveTypes::UInt32 numBytes, PrimitiveTypes::UInt32 numBinds)
+	{
+		m_stats.m_numBytesUploaded += numBytes;
+		m_stats.m_numBinds += numBinds;
+	}
+
+	// releases space of frames the gpu is done with
+	void beginFrame();
+
+	// fences allocations of this frame, starts new stats frame
+	void endFrame();
+
+	PrimitiveTypes::UInt32 getSize() { return m_size; }
+	PrimitiveTypes::UInt32 getNumBytesInUse() { return m_numBytesInUse; }
+	PrimitiveTypes::UInt32 getNumPendingFrames() { return m_numPendingFrames; }
+
+	Stats m_stats; // current frame
+	Stats m_lastFrameStats;
+
+private:
+	// true if released. waits for the fence if wait is set
+	bool releaseOldestFrame(bool wait);
+
+	struct PendingFrame
+	{
+		PrimitiveTypes::UInt32 m_fence;
+		PrimitiveTypes::UInt32 m_numBytes;
+	};
+
+	ConstantBufferRingBackend *m_pBackend;
+	PrimitiveTypes::UInt32 m_size;
+	PrimitiveTypes::UInt32 m_alignment;
+	PrimitiveTypes::UInt32 m_head; // next allocation starts here (or at 0 if it doesn't fit)
+	PrimitiveTypes::UInt32 m_numBytesInUse; // ending at m_head, by pending frames and current frame
+	PrimitiveTypes::UInt32 m_numFrameBytes; // of current frame
+
+	PendingFrame m_pendingFrames[c_maxPendingFrames]; // fifo, oldest first
+	PrimitiveTypes::UInt32 m_firstPendingFrame;
+	PrimitiveTypes::UInt32 m_numPendingFrames;
+};
+
+}; // namespace PE
+
+#endif
@@ -6,15 +6,106 @@
 #if APIABSTRACTION_D3D11
 
 // Outer-Engine includes
+#include <d3d11_1.h>
 
 // Inter-Engine includes
 #include "PrimeEngine/APIAbstraction/Texture/Texture.h"
+#include "PrimeEngine/APIAbstraction/Threading/Threading.h"
 
 // Sibling/Children includes
 #include "D3D11Renderer.h"
 
 namespace PE {
 
+// ConstantBufferRing memory: one dynamic constant buffer written with no overwrite maps and bound
+// by ranges (d3d11.1). fences are event queries
+struct D3D11ConstantBufferRingBackend : public ConstantBufferRingBackend, public PEAllocatable
+{
+	static const PrimitiveTypes::UInt32 c_numQueries = ConstantBufferRing::c_maxPendingFrames + 1;
+
+	D3D11ConstantBufferRingBackend(ID3D11Device *pDevice, ID3D11DeviceContext1 *pContext, PrimitiveTypes::UInt32 size)
+	: m_pContext(pContext), m_pBuffer(NULL), m_lastFence(0), m_lastCompletedFence(0)
+	{
+		D3D11_BUFFER_DESC desc;
+		desc.ByteWidth = size;
+		desc.Usage = D3D11_USAGE_DYNAMIC;
+		desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		desc.MiscFlags = 0;
+		desc.StructureByteStride = 0;
+		HRESULT hr = pDevice->CreateBuffer(&desc, NULL, &m_pBuffer);
+		PEASSERT(SUCCEEDED(hr), "Error creating constant buffer ring");
+
+		D3D11_QUERY_DESC queryDesc;
+		queryDesc.Query = D3D11_QUERY_EVENT;
+		queryDesc.MiscFlags = 0;
+		for (PrimitiveTypes::UInt32 i = 0; i < c_numQueries; ++i)
+		{
+			hr = pDevice->CreateQuery(&queryDesc, &m_pQueries[i]);
+			PEASSERT(SUCCEEDED(hr), "Error creating constant buffer ring fence");
+		}
+	}
+
+	virtual void *map(PrimitiveTypes::UInt32 offset, PrimitiveTypes::UInt32 size)
+	{
+		// ring guarantees gpu is not reading this range
+		D3D11_MAPPED_SUBRESOURCE mapped;
+		HRESULT hr = m_pContext->Map(m_pBuffer, 0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mapped);
+		PEASSERT(SUCCEEDED(hr), "Error mapping constant buffer ring");
+		return (char *)(mapped.pData) + offset;
+	}
+
+	virtual void unmap(PrimitiveTypes::UInt32 offset, PrimitiveTypes::UInt32 size)
+	{
+		m_pContext->Unmap(m_pBuffer, 0);
+	}
+
+	virtual void bindRange(PrimitiveTypes::UInt32 slot, PrimitiveTypes::UInt32 offset, PrimitiveTypes::UInt32 size)
+	{
+		// in 16 byte constants, count has to be multiple of 16
+		UINT firstConstant = offset / 16;
+		UINT numConstants = ((size + 255) & ~255) / 16;
+		m_pContext->CSSetConstantBuffers1(slot, 1, &m_pBuffer, &firstConstant, &numConstants);
+		m_pContext->VSSetConstantBuffers1(slot, 1, &m_pBuffer, &firstConstant, &numConstants);
+		m_pContext->GSSetConstantBuffers1(slot, 1, &m_pBuffer, &firstConstant, &numConstants);
+		m_pContext->PSSetConstantBuffers1(slot, 1, &m_pBuffer, &firstConstant, &numConstants);
+	}
+
+	virtual PrimitiveTypes::UInt32 insertFence()
+	{
+		// ring never has more than c_maxPendingFrames fences pending, so query of a fence is not reused before it completes
+		++m_lastFence;
+		m_pContext->End(m_pQueries[m_lastFence % c_numQueries]);
+		return m_lastFence;
+	}
+
+	virtual bool isFenceComplete(PrimitiveTypes::UInt32 fence)
+	{
+		if (fence <= m_lastCompletedFence)
+			return true;
+		if (m_pContext->GetData(m_pQueries[fence % c_numQueries], NULL, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+			return false;
+		m_lastCompletedFence = fence;
+		return true;
+	}
+
+	virtual void waitForFence(PrimitiveTypes::UInt32 fence)
+	{
+		if (fence <= m_lastCompletedFence)
+			return;
+		// flushes so that the query is submitted
+		while (m_pContext->GetData(m_pQueries[fence % c_numQueries], NULL, 0, 0) != S_OK)
+			Threading::SleepMilliseconds(0);
+		m_lastCompletedFence = fence;
+	}
+
+	ID3D11DeviceContext1 *m_pContext;
+	ID3D11Buffer *m_pBuffer;
+	ID3D11Query *m_pQueries[c_numQueries];
+	PrimitiveTypes::UInt32 m_lastFence;
+	PrimitiveTypes::UInt32 m_lastCompletedFence;
+};
+
 D3D11Renderer::D3D11Renderer(PE::GameContext &context, unsigned int width, unsigned int height)
 	:IRenderer(context, width, height)
 {
@@ -226,6 +317,29 @@ D3D11Renderer::D3D11Renderer(PE::GameContext &context, unsigned int width, unsig
 		m_pDepthStencilBuffer, 0, &m_pDepthStencilView);
 
 	setRenderTargetsAndViewportWithDepth();
+
+	// per object constants ring needs constant buffer offsets (d3d11.1 runtime and driver support)
+	m_pConstantRingBackend = NULL;
+	ID3D11DeviceContext1 *pContext1 = NULL;
+	if (SUCCEEDED(m_pD3DContext->QueryInterface(__uuidof(ID3D11DeviceContext1), (void **)(&pContext1))))
+	{
+		D3D11_FEATURE_DATA_D3D11_OPTIONS options;
+		memset(&options, 0, sizeof(options));
+		m_pD3DDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options));
+		if (options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer)
+		{
+			m_pConstantRingBackend = new(context.getDefaultMemoryArena()) D3D11ConstantBufferRingBackend(m_pD3DDevice, pContext1, PE_CONSTANT_BUFFER_RING_SIZE);
+			m_constantRing.initialize(m_pConstantRingBackend, PE_CONSTANT_BUFFER_RING_SIZE, 256);
+		}
+		else
+		{
+			pContext1->Release();
+		}
+	}
+	if (!m_pConstantRingBackend)
+	{
+		OutputDebugStringA("PyEgnine2.0: No constant buffer offsets, constants are uploaded per object\n");
+	}
 }
 
 
@@ -76,6 +76,7 @@ public:
 	PrimitiveTypes::Bool m_nv3DvisionOn;
 	Vector4 m_clearColor;
 	bool m_wantVSync;
+	ConstantBufferRingBackend *m_pConstantRingBackend; // NULL if device can't bind constant buffer ranges
 friend class IRenderer;
 };
 
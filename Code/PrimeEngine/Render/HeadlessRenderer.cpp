@@ -0,0 +1,59 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+#if APIABSTRACTION_HEADLESS
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+
+// Sibling/Children includes
+#include "HeadlessRenderer.h"
+
+namespace PE {
+
+// IRenderer static method implementation
+
+void IRenderer::Construct(PE::GameContext &context, unsigned int width, unsigned int height)
+{
+	PE::Handle h("Headless_GPUScreen", sizeof(HeadlessRenderer));
+	HeadlessRenderer *pScreen = new(h) HeadlessRenderer(context, width, height);
+	context.m_pGPUScreen = pScreen;
+}
+
+bool IRenderer::checkForErrors(const char *situation)
+{
+	return true;
+}
+
+void IRenderer::checkRenderBufferComplete()
+{
+}
+
+// there is no api context to bind, lock still serializes threads that think they own it
+void IRenderer::AcquireRenderContextOwnership(int &threadOwnershipMask)
+{
+	bool needAssert = (threadOwnershipMask & Threading::RenderContext) > 0;
+
+	if (needAssert)
+	{
+		assert(!needAssert);
+	}
+
+	m_renderLock.lock();
+
+	threadOwnershipMask = threadOwnershipMask | Threading::RenderContext;
+}
+
+void IRenderer::ReleaseRenderContextOwnership(int &threadOwnershipMask)
+{
+	assert((threadOwnershipMask & Threading::RenderContext));
+
+	m_renderLock.unlock();
+
+	threadOwnershipMask = threadOwnershipMask & ~Threading::RenderContext;
+}
+
+}; // namespace PE
+
+#endif // APIABSTRACTION_HEADLESS
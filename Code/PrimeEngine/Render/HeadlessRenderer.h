@@ -0,0 +1,55 @@
+#ifndef __PYENGINE_2_0_HEADLESS_RENDERER_H___
+#define __PYENGINE_2_0_HEADLESS_RENDERER_H___
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+#if APIABSTRACTION_HEADLESS
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/Utils/PEClassDecl.h"
+#include "PrimeEngine/Math/Vector4.h"
+
+// Sibling/Children includes
+#include "IRenderer.h"
+
+namespace PE {
+
+// Implementation of IRenderer for builds without graphics (dedicated server, load tests).
+// There is no device or window, every call is a no-op
+class HeadlessRenderer : public IRenderer
+{
+public:
+	HeadlessRenderer(PE::GameContext &context, unsigned int width, unsigned int height)
+	: IRenderer(context, width, height)
+	, m_width(width)
+	, m_height(height)
+	{}
+
+	virtual void swap(PrimitiveTypes::Bool vsync = false) {}
+
+	virtual PrimitiveTypes::UInt32 getWidth() { return m_width; }
+	virtual PrimitiveTypes::UInt32 getHeight() { return m_height; }
+
+	virtual void setClearColor(Vector4 color) {}
+	virtual void setVSync(bool useVsync) {}
+
+	virtual void clear() {}
+
+	virtual void setRenderTargetsAndViewportWithNoDepth(TextureGPU *pDestColorTex = 0, bool clear = false) {}
+	virtual void setRenderTargetsAndViewportWithDepth(TextureGPU *pDestColorTex = 0, TextureGPU *pDestDepthTex = 0, bool clearRenderTargte = false, bool clearDepth = false) {}
+	virtual void setDepthStencilOnlyRenderTargetAndViewport(TextureGPU *pDestDepthTex, bool clear = false) {}
+
+	virtual void endRenderTarget(TextureGPU *pTex) {}
+	virtual void endFrame() {}
+
+	PrimitiveTypes::UInt32 m_width, m_height;
+};
+
+}; // namespace PE
+
+#endif // APIABSTRACTION_HEADLESS
+#endif // File guard
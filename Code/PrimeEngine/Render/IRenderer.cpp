@@ -15,6 +15,7 @@ IRenderer::IRenderer(PE::GameContext &context, unsigned int width, unsigned int
 	m_psProfile[0] = '\0';
 
 	m_renderMode = RenderMode_DefaultGlow;
+	m_validateFrame = PE_RENDER_VALIDATE_FRAME != 0;
 	
 #if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA
 	m_renderMode = RenderMode_DefaultNoPostProcess;
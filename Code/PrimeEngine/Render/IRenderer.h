@@ -14,6 +14,8 @@
 #include "PrimeEngine/APIAbstraction/Threading/Threading.h"
 #include "PrimeEngine/Utils/PEClassDecl.h"
 // Sibling/Children includes
+#include "RenderStateCache.h"
+#include "ConstantBufferRing.h"
 
 namespace PE {
 	class D3D11Renderer;
@@ -74,6 +76,15 @@ public:
 
 	RenderMode m_renderMode;
 
+	// state objects last sent to api, unchanged state is not sent again. invalidated every frame
+	RenderStateShadow m_stateShadow;
+
+	// per object constants of a frame, inactive if api can't bind buffer ranges. also counts constant uploads of other apis
+	ConstantBufferRing m_constantRing;
+
+	// check for api errors once per frame (PE_RENDER_VALIDATE_FRAME)
+	bool m_validateFrame;
+
 };
 
 }; // namespace PE
@@ -0,0 +1,114 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <string.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Utils/ErrorHandling.h"
+
+// Sibling/Children includes
+#include "RenderStateCache.h"
+
+namespace PE {
+
+using namespace PrimitiveTypes;
+
+RenderStateCache *RenderStateCache::s_pInstance = NULL;
+
+void RenderStateCache::Construct(PE::MemoryArena arena)
+{
+	s_pInstance = new(arena) RenderStateCache();
+}
+
+RenderStateCache::RenderStateCache()
+: m_numStates(0)
+, m_numLookups(0)
+, m_numHits(0)
+{
+}
+
+void *RenderStateCache::find(const RenderStateDesc &desc)
+{
+	++m_numLookups;
+	for (UInt32 i = desc.getHash() & (c_maxStates - 1);; i = (i + 1) & (c_maxStates - 1))
+	{
+		Entry &e = m_entries[i];
+		if (!e.m_pState)
+			return NULL;
+		if (e.m_desc == desc)
+		{
+			++m_numHits;
+			return e.m_pState;
+		}
+	}
+}
+
+void RenderStateCache::add(const RenderStateDesc &desc, void *pState)
+{
+	PEASSERT(m_numStates < c_maxStates - 1, "RenderStateCache is full, increase c_maxStates");
+	for (UInt32 i = desc.getHash() & (c_maxStates - 1);; i = (i + 1) & (c_maxStates - 1))
+	{
+		Entry &e = m_entries[i];
+		if (!e.m_pState || e.m_desc == desc)
+		{
+			if (!e.m_pState)
+				++m_numStates;
+			e.m_desc = desc;
+			e.m_pState = pState;
+			return;
+		}
+	}
+}
+
+UInt32 RenderStateShadow::Stats::getNumApplied() const
+{
+	UInt32 res = 0;
+	for (UInt32 i = 0; i < RenderStateType_Count; ++i)
+		res += m_applied[i];
+	return res;
+}
+
+UInt32 RenderStateShadow::Stats::getNumSkipped() const
+{
+	UInt32 res = 0;
+	for (UInt32 i = 0; i < RenderStateType_Count; ++i)
+		res += m_skipped[i];
+	return res;
+}
+
+RenderStateShadow::RenderStateShadow()
+{
+	invalidate();
+	memset(&m_stats, 0, sizeof(m_stats));
+	memset(&m_lastFrameStats, 0, sizeof(m_lastFrameStats));
+}
+
+bool RenderStateShadow::shouldApply(RenderStateType type, UInt32 slot, const void *pState)
+{
+	if (slot < c_maxSlots)
+	{
+		if (m_applied[type][slot] == pState)
+		{
+			++m_stats.m_skipped[type];
+			return false;
+		}
+		m_applied[type][slot] = pState;
+	}
+	++m_stats.m_applied[type];
+	return true;
+}
+
+void RenderStateShadow::invalidate()
+{
+	memset(m_applied, 0, sizeof(m_applied));
+}
+
+void RenderStateShadow::frameEnd()
+{
+	m_lastFrameStats = m_stats;
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+}; // namespace PE
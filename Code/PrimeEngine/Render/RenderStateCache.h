@@ -0,0 +1,115 @@
+#ifndef __PYENGINE_2_0_RENDER_STATE_CACHE_H__
+#define __PYENGINE_2_0_RENDER_STATE_CACHE_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Utils/PEClassDecl.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+enum RenderStateType
+{
+	RenderStateType_Blend,
+	RenderStateType_Rasterizer,
+	RenderStateType_DepthStencil,
+	RenderStateType_Sampler,
+
+	RenderStateType_Count
+};
+
+// api independent settings of a pipeline state object packed into bits. settings that have no effect
+// (i.e. blend factors when blending is off) are left 0 so that equivalent states have equal descriptors.
+// immutable once the state object is created
+struct RenderStateDesc
+{
+	RenderStateDesc() : m_type(RenderStateType_Count), m_bits(0) {}
+	RenderStateDesc(RenderStateType type, PrimitiveTypes::UInt32 bits) : m_type(type), m_bits(bits) {}
+
+	PrimitiveTypes::UInt32 getHash() const
+	{
+		PrimitiveTypes::UInt32 h = (m_bits ^ ((PrimitiveTypes::UInt32)(m_type) << 28)) * 2654435761u;
+		return h ^ (h >> 16);
+	}
+
+	bool operator==(const RenderStateDesc &other) const { return m_type == other.m_type && m_bits == other.m_bits; }
+
+	RenderStateType m_type;
+	PrimitiveTypes::UInt32 m_bits;
+};
+
+// Unique state objects by descriptor. State managers look up a descriptor before creating the api object,
+// so every combination of settings exists once and bound state can be compared by pointer (RenderStateShadow).
+// Filled on render thread at startup.
+struct RenderStateCache : PE::PEAllocatable
+{
+	static const PrimitiveTypes::UInt32 c_maxStates = 256; // power of 2, open addressing
+
+	static void Construct(PE::MemoryArena arena);
+	static RenderStateCache *Instance() { return s_pInstance; }
+
+	RenderStateCache();
+
+	// NULL if no state with this descriptor was added
+	void *find(const RenderStateDesc &desc);
+	void add(const RenderStateDesc &desc, void *pState);
+
+	struct Entry
+	{
+		Entry() : m_pState(NULL) {}
+
+		RenderStateDesc m_desc;
+		void *m_pState; // NULL: free
+	};
+
+	Entry m_entries[c_maxStates];
+	PrimitiveTypes::UInt32 m_numStates;
+	PrimitiveTypes::UInt32 m_numLookups;
+	PrimitiveTypes::UInt32 m_numHits; // lookups that found a state to share
+
+	static RenderStateCache *s_pInstance;
+};
+
+// Copy of state objects last sent to the api (kept by IRenderer). Bind code asks shouldApply() before
+// sending a state so that state unchanged since the previous draw is not sent again.
+// Render thread only.
+struct RenderStateShadow
+{
+	static const PrimitiveTypes::UInt32 c_maxSlots = 16; // sampler slots. states in higher slots are always applied
+
+	struct Stats
+	{
+		PrimitiveTypes::UInt32 m_applied[RenderStateType_Count];
+		PrimitiveTypes::UInt32 m_skipped[RenderStateType_Count];
+
+		PrimitiveTypes::UInt32 getNumApplied() const;
+		PrimitiveTypes::UInt32 getNumSkipped() const;
+	};
+
+	RenderStateShadow();
+
+	// true if pState is not what was last applied to slot (0 for all but samplers). records it as applied
+	bool shouldApply(RenderStateType type, PrimitiveTypes::UInt32 slot, const void *pState);
+
+	// api state could have been changed by other code: next state of every type and slot is applied
+	void invalidate();
+
+	// counts of the frame go to m_lastFrameStats
+	void frameEnd();
+
+	const void *m_applied[RenderStateType_Count][c_maxSlots];
+	Stats m_stats; // current frame
+	Stats m_lastFrameStats;
+};
+
+}; // namespace PE
+
+#endif
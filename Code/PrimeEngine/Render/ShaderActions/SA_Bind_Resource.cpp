@@ -22,7 +22,7 @@ SA_Bind_Resource::SA_Bind_Resource(
 	PE::GameContext &context, PE::MemoryArena arena,
 	EGpuResourceSlot bufferId,
 	ESamplerState samplerState,
-	API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(ID3D11ShaderResourceView* pShaderResource, IDirect3DTexture9* pTextureResource, GLuint texture, void texture),
+	API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(ID3D11ShaderResourceView* pShaderResource, IDirect3DTexture9* pTextureResource, GLuint texture, void *texture),
 	const char *dbgStr/* = NULL*/
 )
 : ShaderAction()
@@ -42,7 +42,7 @@ SA_Bind_Resource::SA_Bind_Resource(
 void SA_Bind_Resource::set(
 	EGpuResourceSlot bufferId,
 	ESamplerState samplerState,
-	API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(ID3D11ShaderResourceView* pShaderResource, IDirect3DTexture9* pTextureResource, GLuint texture, void texture),
+	API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(ID3D11ShaderResourceView* pShaderResource, IDirect3DTexture9* pTextureResource, GLuint texture, void *texture),
 	const char *dbgStr/* = NULL*/
 	)
 {
@@ -95,7 +95,8 @@ void SA_Bind_Resource::bindToPipeline(Effect *pCurEffect /* = NULL*/)
 		pDevice->GSSetShaderResources(m_bufferId, 1, &pRV);
 		pDevice->PSSetShaderResources(m_bufferId, 1, &pRV);
 		*/
-		if (m_samplerState != SamplerState_INVALID)
+		if (m_samplerState != SamplerState_INVALID
+			&& m_pContext->getGPUScreen()->m_stateShadow.shouldApply(RenderStateType_Sampler, m_bufferId, &SamplerStateManager::getInstance()->getSamplerState(m_samplerState)))
 		{
 			SamplerState &ss = SamplerStateManager::getInstance()->getSamplerState(m_samplerState);
 
@@ -138,8 +139,11 @@ void SA_Bind_Resource::bindToPipeline(Effect *pCurEffect /* = NULL*/)
 				PEINFO("SA_Bind_Resource::bindToPipeline(): Binding Sampler %d to slot s %d \n", int(m_samplerState), m_bufferId);
 #endif
 				SamplerState &ss = SamplerStateManager::getInstance()->getSamplerState(m_samplerState);
-				pDeviceContext->VSSetSamplers(m_bufferId, 1, &ss.m_pd3dSamplerState);
-				pDeviceContext->PSSetSamplers(m_bufferId, 1, &ss.m_pd3dSamplerState);
+				if (m_pContext->getGPUScreen()->m_stateShadow.shouldApply(RenderStateType_Sampler, m_bufferId, &ss))
+				{
+					pDeviceContext->VSSetSamplers(m_bufferId, 1, &ss.m_pd3dSamplerState);
+					pDeviceContext->PSSetSamplers(m_bufferId, 1, &ss.m_pd3dSamplerState);
+				}
 			}
 		}
 		else
@@ -321,7 +325,7 @@ void SA_Bind_Resource::releaseData()
 {} // no data held
 
 
-#if !APIABSTRACTION_D3D9 && !APIABSTRACTION_D3D11 && !PE_PLAT_IS_PSVITA
+#if !APIABSTRACTION_D3D9 && !APIABSTRACTION_D3D11 && !PE_PLAT_IS_PSVITA && !APIABSTRACTION_HEADLESS
 static void FindSamplerBinding(Components::Effect *pEffect, SA_Bind_Resource::ApiBindingType &resBinding, const char *name)
 {
 #if APIABSTRACTION_IOS 
@@ -73,14 +73,14 @@ struct SA_Bind_Resource : ShaderAction
 		PE::GameContext &context, PE::MemoryArena arena,
 		EGpuResourceSlot bufferId,
 		ESamplerState samplerState,
-		API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(ID3D11ShaderResourceView* pShaderResource, IDirect3DTexture9* pTextureResource, GLuint texture, void texture),
+		API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(ID3D11ShaderResourceView* pShaderResource, IDirect3DTexture9* pTextureResource, GLuint texture, void *texture),
 		const char *dbgStr = NULL
 	);
 
 	void set(
 		EGpuResourceSlot bufferId,
 		ESamplerState samplerState,
-		API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(ID3D11ShaderResourceView* pShaderResource, IDirect3DTexture9* pTextureResource, GLuint texture, void texture),
+		API_CHOOSE_DX11_DX9_OGL_PSVITA_NO_PAREN(ID3D11ShaderResourceView* pShaderResource, IDirect3DTexture9* pTextureResource, GLuint texture, void *texture),
 		const char *dbgStr = NULL
 	);
 
@@ -97,7 +97,7 @@ struct SA_Bind_Resource : ShaderAction
 #endif
 
 
-#if !APIABSTRACTION_D3D9 && !APIABSTRACTION_D3D11 && !PE_PLAT_IS_PSVITA
+#if !APIABSTRACTION_D3D9 && !APIABSTRACTION_D3D11 && !PE_PLAT_IS_PSVITA && !APIABSTRACTION_HEADLESS
 	// in non dx9/dx11 and not vita we need to track sampler ids per effect:
 
 #if PE_PLAT_IS_PSVITA
@@ -20,7 +20,11 @@ void SetInstanceControlConstantsShaderAction::bindToPipeline(Effect *pCurEffect
 		ID3D11Device *pDevice = pD3D11Renderer->m_pD3DDevice;
 		ID3D11DeviceContext *pDeviceContext = pD3D11Renderer->m_pD3DContext;
 
-		Effect::setConstantBuffer(pDevice, pDeviceContext, s_pBuffer, 5, &m_data, sizeof(Data));
+		if (!pD3D11Renderer->m_constantRing.uploadAndBind(5, &m_data, sizeof(Data)))
+		{
+			Effect::setConstantBuffer(pDevice, pDeviceContext, s_pBuffer, 5, &m_data, sizeof(Data));
+			pD3D11Renderer->m_constantRing.countUpload(sizeof(Data), 1);
+		}
 	#elif APIABSTRACTION_D3D9
     
         int float4PerLight = 7;
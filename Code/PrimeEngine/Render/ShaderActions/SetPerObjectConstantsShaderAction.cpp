@@ -26,7 +26,12 @@ void SetPerObjectConstantsShaderAction::bindToPipeline(Effect *pCurEffect /* = N
 	ID3D11Device *pDevice = pD3D11Renderer->m_pD3DDevice;
 	ID3D11DeviceContext *pDeviceContext = pD3D11Renderer->m_pD3DContext;
 
-	Effect::setConstantBuffer(pDevice, pDeviceContext, s_pBuffer, 2, &m_data, sizeof(Data));
+	// frame's constants go linearly into one ring, draw binds its range. own buffer if ring is not available or full
+	if (!pD3D11Renderer->m_constantRing.uploadAndBind(2, &m_data, sizeof(Data)))
+	{
+		Effect::setConstantBuffer(pDevice, pDeviceContext, s_pBuffer, 2, &m_data, sizeof(Data));
+		pD3D11Renderer->m_constantRing.countUpload(sizeof(Data), 1);
+	}
 #	elif APIABSTRACTION_D3D9
 	//assert(sizeof(m_data) == 77 * 4 * sizeof(float)); // the data is synced to take 78 float4 registers on GPU
     
@@ -41,107 +46,88 @@ void SetPerObjectConstantsShaderAction::bindToPipeline(Effect *pCurEffect /* = N
 	assert(SUCCEEDED(hr));
 	hr = pDevice->SetPixelShaderConstantF(78, (const float *)(&m_data), dataTouse / (4*sizeof(float)));
 	assert(SUCCEEDED(hr));
+	pD3D9Renderer->m_constantRing.countUpload(dataTouse * 2, 2);
 #elif APIABSTRACTION_OGL
 	if (pCurEffect)
 	{
 		ExternalPerTechniqueData &data = pCurEffect->m_externalPerTechniqueData;
+
+		// no per call error checks here, they sync with driver. errors are checked once per frame (IRenderer::m_validateFrame)
 	
         #if APIABSTRACTION_IOS
 
         glUniformMatrix4fv(data.m_cbPerObject_c2_cgparameters.v_gWVP, 1, GL_FALSE,
                                  (const GLfloat*)(&m_data.gWVP));
-        IRenderer::checkForErrors("setting parameter values\n");
         
         //glUniformMatrix4fv(data.m_cbPerObject_c2_cgparameters.f_gWVP, 1, GL_FALSE,
         //                         (const GLfloat*)(&m_data.gWVP));
-        //IRenderer::checkForErrors("setting parameter values\n");
         
         glUniformMatrix4fv(data.m_cbPerObject_c2_cgparameters.v_gW, 1, GL_FALSE,
                                  (const GLfloat*)(&m_data.gW));
-        IRenderer::checkForErrors("setting parameter values\n");
         
         //glUniformMatrix4fv(data.m_cbPerObject_c2_cgparameters.f_gW, 1, GL_FALSE,
         //                         (const GLfloat*)(&m_data.gW));
-        //IRenderer::checkForErrors("setting parameter values\n");
         
         glUniformMatrix4fv(data.m_cbPerObject_c2_cgparameters.v_gUnused, 1, GL_FALSE,
                                  (const GLfloat*)(&m_data.gUnused));
-        IRenderer::checkForErrors("setting parameter values\n");
         
         //glUniformMatrix4fv(data.m_cbPerObject_c2_cgparameters.f_gUnused, 1, GL_FALSE,
         //                         (const GLfloat*)(&m_data.gUnused));
-        //IRenderer::checkForErrors("setting parameter values\n");
         
         glUniform4fv(data.m_cbPerObject_c2_cgparameters.v_gVertexBufferWeights, 1,
                             (const GLfloat*)(&m_data.gVertexBufferWeights));
-        IRenderer::checkForErrors("setting parameter values\n");
         
         //glUniform4fv(data.m_cbPerObject_c2_cgparameters.f_gVertexBufferWeights, 1,
         //                    (const GLfloat*)(&m_data.gVertexBufferWeights));
-        //IRenderer::checkForErrors("setting parameter values\n");
         
         glUniformMatrix4fv(data.m_cbPerObject_c2_cgparameters.v_gWVPInverse, 1, GL_FALSE,
                                  (const GLfloat*)(&m_data.gWVPInverse));
-        IRenderer::checkForErrors("setting parameter values\n");
         
         //glUniformMatrix4fv(data.m_cbPerObject_c2_cgparameters.f_gWVPInverse, 1, GL_FALSE,
         //                         (const GLfloat*)(&m_data.gWVPInverse));
-        //IRenderer::checkForErrors("setting parameter values\n");
         
         
         if (m_useBones)
         {
             glUniformMatrix4fv(data.m_cbPerObject_c2_cgparameters.v_gJoints, sizeof(m_data.gJoints)/sizeof(Matrix4x4), GL_FALSE,
                                       (const GLfloat*)(&m_data.gJoints[0]));
-            IRenderer::checkForErrors("setting parameter values\n");
         }
         
         
         //glUniformMatrix4fv(data.m_cbPerObject_c2_cgparameters.f_gJoints, sizeof(m_data.gJoints)/sizeof(Matrix4x4), GL_FALSE,
         //                   (const GLfloat*)(&m_data.gJoints[0]));
-        //IRenderer::checkForErrors("setting parameter values\n");
 
         #else
 		    cgGLSetMatrixParameterfc(data.m_cbPerObject_c2_cgparameters.v_gWVP,
                 (const GLfloat*)(&m_data.gWVP));//cgSetParameterValuefc(v_gWVP, sizeof(m_data) / sizeof(float), (const GLfloat*)(&m_data.gWVP));
-            IRenderer::checkForErrors("setting v_gWVP parameter values\n");
 
             cgGLSetMatrixParameterfc(data.m_cbPerObject_c2_cgparameters.f_gWVP,
 			(const GLfloat*)(&m_data.gWVP)); //cgSetParameterValuefc(f_gWVP, sizeof(m_data) / sizeof(float), (const GLfloat*)(&m_data.gWVP));
-            IRenderer::checkForErrors("setting f_gWVP parameter values\n");
 
 			    
             cgGLSetMatrixParameterfc(data.m_cbPerObject_c2_cgparameters.v_gW,
 			(const GLfloat*)(&m_data.gW));
-            IRenderer::checkForErrors("setting v_gW parameter values\n");
 
             cgGLSetMatrixParameterfc(data.m_cbPerObject_c2_cgparameters.f_gW,
 			(const GLfloat*)(&m_data.gW));
-            IRenderer::checkForErrors("setting f_gW parameter values\n");
 
             cgGLSetMatrixParameterfc(data.m_cbPerObject_c2_cgparameters.v_gUnused,
 			(const GLfloat*)(&m_data.gUnused));
-            IRenderer::checkForErrors("setting v_gUnused parameter values\n");
 
             cgGLSetMatrixParameterfc(data.m_cbPerObject_c2_cgparameters.f_gUnused,
 			(const GLfloat*)(&m_data.gUnused));
-            IRenderer::checkForErrors("setting f_gUnused parameter values\n");
 
             cgGLSetParameter4fv(data.m_cbPerObject_c2_cgparameters.v_gVertexBufferWeights,
 			(const GLfloat*)(&m_data.gVertexBufferWeights));
-            IRenderer::checkForErrors("setting v_gVertexBufferWeights parameter values\n");
 
             cgGLSetParameter4fv(data.m_cbPerObject_c2_cgparameters.f_gVertexBufferWeights,
 			(const GLfloat*)(&m_data.gVertexBufferWeights));
-            IRenderer::checkForErrors("setting f_gVertexBufferWeights parameter values\n");
 
             cgGLSetMatrixParameterfc(data.m_cbPerObject_c2_cgparameters.v_gWVPInverse,
 			(const GLfloat*)(&m_data.gWVPInverse));
-            IRenderer::checkForErrors("setting v_gWVPInverse parameter values\n");
 
             cgGLSetMatrixParameterfc(data.m_cbPerObject_c2_cgparameters.f_gWVPInverse,
 			(const GLfloat*)(&m_data.gWVPInverse));
-            IRenderer::checkForErrors("setting f_gWVPInverse parameter values\n");
 
             if (m_useBones)
 			{
@@ -153,13 +139,22 @@ void SetPerObjectConstantsShaderAction::bindToPipeline(Effect *pCurEffect /* = N
 
                 cgGLSetMatrixParameterArrayfc(data.m_cbPerObject_c2_cgparameters.v_gJoints, 0, sizeof(m_data.gJoints)/sizeof(Matrix4x4),
                                               (const GLfloat*)(&m_data.gJoints[0]));
-                IRenderer::checkForErrors("setting v_gJoints parameter values\n");
 
 				
 
 
             }
         #endif
+
+		{
+			PrimitiveTypes::UInt32 numBytes = sizeof(m_data) - (m_useBones ? 0 : sizeof(m_data.gJoints));
+			#if APIABSTRACTION_IOS
+			pCurEffect->m_pContext->getGPUScreen()->m_constantRing.countUpload(numBytes, m_useBones ? 6 : 5);
+			#else
+			// vertex and fragment program parameters
+			pCurEffect->m_pContext->getGPUScreen()->m_constantRing.countUpload(numBytes * 2, m_useBones ? 11 : 10);
+			#endif
+		}
         
 			//cgGLUpdateProgramParameters(pCurEffect->m_cgVertexProgram);
             //cgGLUpdateProgramParameters(pCurEffect->m_cgFragmentProgram);
@@ -1,6 +1,7 @@
 #include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
 #include "RenderJob.h"
 #include "PrimeEngine/Scene/DrawList.h"
+#include "FramePipeline.h"
 
 #if APIABSTRACTION_IOS
 #import <QuartzCore/QuartzCore.h>
@@ -31,9 +32,6 @@ void drawThreadFunctionJob(void *params)
 	g_drawThreadExited = false;
 	g_drawThreadInitializationLock.unlock();
 
-	//acquire rendring thread lock so that we can sleep on it until game thread wakes us up
-	g_drawThreadLock.lock();
-
 	// now we can signal main thread that this thread is initialized
 	g_drawThreadInitializedCV.signal();
     while (1)
@@ -47,24 +45,18 @@ void drawThreadFunctionJob(void *params)
 
 void runDrawThreadSingleFrameThreaded(PE::GameContext &ctx)
 {
-	while (!g_drawThreadCanStart && !g_drawThreadShouldExit)
-    {
-		bool success = g_drawCanStartCV.sleep();
-        assert(success);
-    }
-	g_drawThreadCanStart = false; // set to false for next frame
-
-	//PEINFO("Draw thread got g_drawThreadLock\n");
-
-	if (g_drawThreadShouldExit)
+	// sleep until game thread submits a frame
+	if (!g_framePipeline.beginRenderFrame())
 	{
 		//right now game thread is waiting on this thread to finish
-		g_drawThreadLock.unlock();
 		g_drawThreadExited = true;
 		return;
 	}
 
 	runDrawThreadSingleFrame(ctx);
+
+	// draw lists of this frame can be reused by game thread
+	g_framePipeline.endRenderFrame();
 }
 
 void runDrawThreadSingleFrame(PE::GameContext &ctx)
@@ -73,6 +65,16 @@ void runDrawThreadSingleFrame(PE::GameContext &ctx)
 	
 	ctx.getGPUScreen()->AcquireRenderContextOwnership(threadOwnershipMask);
 
+	// per frame data of the frame being drawn. game thread may already be gathering later frames
+	EffectManager::Instance()->m_currentViewProjMatrix = DrawList::InstanceReadOnly()->m_viewProjMatrix;
+	EffectManager::Instance()->m_doMotionBlur = DrawList::InstanceReadOnly()->m_doMotionBlur;
+
+	// other code may have changed api state since last frame
+	ctx.getGPUScreen()->m_stateShadow.invalidate();
+
+	// constants of frames the gpu finished can be overwritten
+	ctx.getGPUScreen()->m_constantRing.beginFrame();
+
 	#if PE_ENABLE_GPU_PROFILING
 	Timer t;
 	PE::Profiling::Profiler::Instance()->startEventQuery(Profiling::Group_DrawThread, IRenderer::Instance()->getDevice(), t.GetTime(), "DrawThread");
@@ -202,10 +204,13 @@ void runDrawThreadSingleFrame(PE::GameContext &ctx)
     }
             
 	ctx.getGPUScreen()->endFrame();
+	ctx.getGPUScreen()->m_stateShadow.frameEnd();
+	ctx.getGPUScreen()->m_constantRing.endFrame();
 
     // Flip screen
 	ctx.getGPUScreen()->swap(false);
-    PE::IRenderer::checkForErrors("");
+	if (ctx.getGPUScreen()->m_validateFrame)
+		PE::IRenderer::checkForErrors("frame validation");
 
 			
 	#if PE_ENABLE_GPU_PROFILING
@@ -215,6 +220,8 @@ void runDrawThreadSingleFrame(PE::GameContext &ctx)
 		Profiling::Profiler::Instance()->update(Profiling::Group_DrawThread, PE_DETAILED_GPU_PROFILING, true, time, t);
 	#endif
 
+	DrawList::swapReadOnly();
+
 	ctx.getGPUScreen()->ReleaseRenderContextOwnership(threadOwnershipMask);
 }
 
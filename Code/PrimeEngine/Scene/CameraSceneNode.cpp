@@ -13,6 +13,8 @@ CameraSceneNode::CameraSceneNode(PE::GameContext &context, PE::MemoryArena arena
 {
 	m_near = 0.05f;
 	m_far = 2000.0f;
+	m_cullingNear = 1.0f;
+	m_cullingFar = 50.0f;
 }
 void CameraSceneNode::addDefaultComponents()
 {
@@ -79,77 +81,100 @@ void CameraSceneNode::computeFrustumPlanes()
 	// Use REAL camera frustum for culling but with YELLOW FRUSTUM planes
 	// This means we use the real camera's projection matrix but extract planes from yellow frustum
 	
-	// Create yellow frustum projection matrix for plane extraction
-	float yellowNear = 1.0f;   // Yellow frustum near plane (close to camera)
-	float yellowFar = 50.0f;   // Yellow frustum far plane (reasonable range)
 	float actualFOV = 0.33f * PrimitiveTypes::Constants::c_Pi_F32;  // Same as real camera
 	
-	// Create yellow frustum projection matrix
-	Matrix4x4 yellowProj = CameraOps::CreateProjectionMatrix(actualFOV, 
+	// Create yellow frustum projection matrix (m_cullingNear is close to camera, m_cullingFar is reasonable range)
+	m_cullingViewToProjectedTransform = CameraOps::CreateProjectionMatrix(actualFOV, 
 		(float)(m_pContext->getGPUScreen()->getWidth()) / (float)(m_pContext->getGPUScreen()->getHeight()),
-		yellowNear, yellowFar);
+		m_cullingNear, m_cullingFar);
 	
 	// Use yellow frustum projection for plane extraction
 	// Standard matrix order: Projection * View
-	Matrix4x4 viewProj = yellowProj * m_worldToViewTransform;
+	Matrix4x4 viewProj = m_cullingViewToProjectedTransform * m_worldToViewTransform;
 	
+	ExtractFrustumPlanes(viewProj, m_frustumPlanes);
+}
+
+void CameraSceneNode::ExtractFrustumPlanes(const Matrix4x4 &viewProj, FrustumPlane planes[6],
+	float minX, float maxX, float minY, float maxY)
+{
 	// Extract the 6 frustum planes from the view-projection matrix
 	// Each plane is defined by: ax + by + cz + d = 0
 	// where (a,b,c) is the normal and d is the distance
 	// Using row extraction (transposed for this engine's matrix layout)
+	// With the default window [-1, 1] the side planes are row 3 +/- row 0 (or row 1).
+	// A narrower window [min, max] gives x >= min * w -> row 0 - min * row 3, x <= max * w -> max * row 3 - row 0
+	const float (&m)[4][4] = viewProj.m;
 	
-	// Left plane (row 3 + row 0)
-	m_frustumPlanes[0].normal.m_x = (float)(viewProj.m[3][0] + viewProj.m[0][0]);
-	m_frustumPlanes[0].normal.m_y = (float)(viewProj.m[3][1] + viewProj.m[0][1]);
-	m_frustumPlanes[0].normal.m_z = (float)(viewProj.m[3][2] + viewProj.m[0][2]);
-	m_frustumPlanes[0].distance = (float)(viewProj.m[3][3] + viewProj.m[0][3]);
+	// Left plane
+	planes[0].normal.m_x = m[0][0] - minX * m[3][0];
+	planes[0].normal.m_y = m[0][1] - minX * m[3][1];
+	planes[0].normal.m_z = m[0][2] - minX * m[3][2];
+	planes[0].distance = m[0][3] - minX * m[3][3];
 	
-	// Right plane (row 3 - row 0)
-	m_frustumPlanes[1].normal.m_x = (float)(viewProj.m[3][0] - viewProj.m[0][0]);
-	m_frustumPlanes[1].normal.m_y = (float)(viewProj.m[3][1] - viewProj.m[0][1]);
-	m_frustumPlanes[1].normal.m_z = (float)(viewProj.m[3][2] - viewProj.m[0][2]);
-	m_frustumPlanes[1].distance = (float)(viewProj.m[3][3] - viewProj.m[0][3]);
+	// Right plane
+	planes[1].normal.m_x = maxX * m[3][0] - m[0][0];
+	planes[1].normal.m_y = maxX * m[3][1] - m[0][1];
+	planes[1].normal.m_z = maxX * m[3][2] - m[0][2];
+	planes[1].distance = maxX * m[3][3] - m[0][3];
 	
-	// Bottom plane (row 3 + row 1)
-	m_frustumPlanes[2].normal.m_x = (float)(viewProj.m[3][0] + viewProj.m[1][0]);
-	m_frustumPlanes[2].normal.m_y = (float)(viewProj.m[3][1] + viewProj.m[1][1]);
-	m_frustumPlanes[2].normal.m_z = (float)(viewProj.m[3][2] + viewProj.m[1][2]);
-	m_frustumPlanes[2].distance = (float)(viewProj.m[3][3] + viewProj.m[1][3]);
+	// Bottom plane
+	planes[2].normal.m_x = m[1][0] - minY * m[3][0];
+	planes[2].normal.m_y = m[1][1] - minY * m[3][1];
+	planes[2].normal.m_z = m[1][2] - minY * m[3][2];
+	planes[2].distance = m[1][3] - minY * m[3][3];
 	
-	// Top plane (row 3 - row 1)
-	m_frustumPlanes[3].normal.m_x = (float)(viewProj.m[3][0] - viewProj.m[1][0]);
-	m_frustumPlanes[3].normal.m_y = (float)(viewProj.m[3][1] - viewProj.m[1][1]);
-	m_frustumPlanes[3].normal.m_z = (float)(viewProj.m[3][2] - viewProj.m[1][2]);
-	m_frustumPlanes[3].distance = (float)(viewProj.m[3][3] - viewProj.m[1][3]);
+	// Top plane
+	planes[3].normal.m_x = maxY * m[3][0] - m[1][0];
+	planes[3].normal.m_y = maxY * m[3][1] - m[1][1];
+	planes[3].normal.m_z = maxY * m[3][2] - m[1][2];
+	planes[3].distance = maxY * m[3][3] - m[1][3];
 	
 	// Near plane (row 3 + row 2)
-	m_frustumPlanes[4].normal.m_x = (float)(viewProj.m[3][0] + viewProj.m[2][0]);
-	m_frustumPlanes[4].normal.m_y = (float)(viewProj.m[3][1] + viewProj.m[2][1]);
-	m_frustumPlanes[4].normal.m_z = (float)(viewProj.m[3][2] + viewProj.m[2][2]);
-	m_frustumPlanes[4].distance = (float)(viewProj.m[3][3] + viewProj.m[2][3]);
+	planes[4].normal.m_x = m[3][0] + m[2][0];
+	planes[4].normal.m_y = m[3][1] + m[2][1];
+	planes[4].normal.m_z = m[3][2] + m[2][2];
+	planes[4].distance = m[3][3] + m[2][3];
 	
 	// Far plane (row 3 - row 2)
-	m_frustumPlanes[5].normal.m_x = (float)(viewProj.m[3][0] - viewProj.m[2][0]);
-	m_frustumPlanes[5].normal.m_y = (float)(viewProj.m[3][1] - viewProj.m[2][1]);
-	m_frustumPlanes[5].normal.m_z = (float)(viewProj.m[3][2] - viewProj.m[2][2]);
-	m_frustumPlanes[5].distance = (float)(viewProj.m[3][3] - viewProj.m[2][3]);
+	planes[5].normal.m_x = m[3][0] - m[2][0];
+	planes[5].normal.m_y = m[3][1] - m[2][1];
+	planes[5].normal.m_z = m[3][2] - m[2][2];
+	planes[5].distance = m[3][3] - m[2][3];
 	
 	// Normalize all planes and flip to point inward
 	for (int i = 0; i < 6; i++)
 	{
-		float length = m_frustumPlanes[i].normal.length();
+		float length = planes[i].normal.length();
 		if (length > 0.0f)
 		{
-			m_frustumPlanes[i].normal = m_frustumPlanes[i].normal / length;
-			m_frustumPlanes[i].distance /= length;
+			planes[i].normal = planes[i].normal / length;
+			planes[i].distance /= length;
 			
 			// Flip normals to point inward
-			m_frustumPlanes[i].normal = m_frustumPlanes[i].normal * -1.0f;
-			m_frustumPlanes[i].distance = -m_frustumPlanes[i].distance;
+			planes[i].normal = planes[i].normal * -1.0f;
+			planes[i].distance = -planes[i].distance;
 		}
 	}
 }
 
+void CameraSceneNode::getCullingFrustumCorners(Vector3 corners[8])
+{
+	// invert the culling projection for x and y: x_view = x_ndc * depth / m00. view space looks down +z in this engine
+	Matrix4x4 viewToWorld = m_worldToViewTransform.inverse();
+	float depths[2] = {m_cullingNear, m_cullingFar};
+	for (int iDepth = 0; iDepth < 2; ++iDepth)
+	{
+		float d = depths[iDepth];
+		float halfW = d / m_cullingViewToProjectedTransform.m[0][0];
+		float halfH = d / m_cullingViewToProjectedTransform.m[1][1];
+		corners[iDepth * 4 + 0] = viewToWorld * Vector3( halfW,  halfH, d);
+		corners[iDepth * 4 + 1] = viewToWorld * Vector3(-halfW,  halfH, d);
+		corners[iDepth * 4 + 2] = viewToWorld * Vector3(-halfW, -halfH, d);
+		corners[iDepth * 4 + 3] = viewToWorld * Vector3( halfW, -halfH, d);
+	}
+}
+
 bool CameraSceneNode::isAABBInsideFrustum(const Vector3& min, const Vector3& max)
 {
 	// Test AABB against all 6 frustum planes
@@ -17,6 +17,7 @@
 #include "PrimeEngine/Math/Vector3.h"
 
 #include "SceneNode.h"
+#include "FrustumPlane.h"
 
 
 // Sibling/Children includes
@@ -24,30 +25,6 @@
 namespace PE {
 namespace Components {
 
-// Frustum plane structure for culling
-struct FrustumPlane
-{
-	Vector3 normal;    // Plane normal (pointing inward toward frustum center)
-	float distance;    // Distance from origin
-	
-	FrustumPlane() : normal(Vector3(0.0f, 0.0f, 0.0f)), distance(0.0f) {}
-	FrustumPlane(const Vector3& n, float d) : normal(n), distance(d) {}
-	
-	// Test if a point is inside the plane (for this engine's convention)
-	bool isPointInside(const Vector3& point)
-	{
-		float dotProduct = normal.dotProduct(point);
-		return (dotProduct + distance) <= 0.0f;  // Inside if negative for this engine
-	}
-	
-	// Test if a sphere is inside the plane
-	bool isSphereInside(const Vector3& center, float radius)
-	{
-		float dotProduct = normal.dotProduct(center);
-		return (dotProduct + distance) <= radius;  // Inside if within radius margin
-	}
-};
-
 struct CameraSceneNode : public SceneNode
 {
 
@@ -66,6 +43,12 @@ struct CameraSceneNode : public SceneNode
 
 	// Frustum culling functions
 	void computeFrustumPlanes();
+	// extracts 6 planes (this engine's convention: inside if dot + distance <= 0) from a view-projection matrix.
+	// the clip space x,y window can be narrowed from [-1, 1] to crop the frustum (used by shadow caster culling)
+	static void ExtractFrustumPlanes(const Matrix4x4 &viewProj, FrustumPlane planes[6],
+		float minX = -1.0f, float maxX = 1.0f, float minY = -1.0f, float maxY = 1.0f);
+	// world space corners of the culling frustum: near plane (0-3) then far plane (4-7)
+	void getCullingFrustumCorners(Vector3 corners[8]);
 	bool isAABBInsideFrustum(const Vector3& min, const Vector3& max);
 	bool isSphereInsideFrustum(const Vector3& center, float radius);
 	
@@ -80,6 +63,8 @@ struct CameraSceneNode : public SceneNode
 	Matrix4x4 m_worldTransform2;
 	Matrix4x4 m_viewToProjectedTransform; // objects in local (view) space are multiplied by this to get them to screen space
 	float m_near, m_far;
+	float m_cullingNear, m_cullingFar; // culling frustum is tighter than rendering frustum
+	Matrix4x4 m_cullingViewToProjectedTransform;
 	
 	// Frustum planes for culling (6 planes: left, right, top, bottom, near, far)
 	FrustumPlane m_frustumPlanes[6];
@@ -0,0 +1,506 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <math.h>
+#include <string.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/APIAbstraction/Timer/Timer.h"
+#include "PrimeEngine/Jobs/JobSystem.h"
+
+// Sibling/Children includes
+#include "CrowdSimulation.h"
+
+namespace PE {
+
+using namespace PrimitiveTypes;
+
+// 2d math of the ground plane: Vector2 m_x is world x, m_y is world z
+
+static const Float32 c_epsilon = 0.00001f;
+
+static inline Vector2 add(const Vector2 &a, const Vector2 &b) { return Vector2(a.m_x + b.m_x, a.m_y + b.m_y); }
+static inline Vector2 sub(const Vector2 &a, const Vector2 &b) { return Vector2(a.m_x - b.m_x, a.m_y - b.m_y); }
+static inline Vector2 mul(const Vector2 &a, Float32 s) { return Vector2(a.m_x * s, a.m_y * s); }
+static inline Float32 dot(const Vector2 &a, const Vector2 &b) { return a.m_x * b.m_x + a.m_y * b.m_y; }
+static inline Float32 det(const Vector2 &a, const Vector2 &b) { return a.m_x * b.m_y - a.m_y * b.m_x; }
+static inline Float32 lengthSqr(const Vector2 &a) { return dot(a, a); }
+static inline Vector2 normalized(const Vector2 &a) { Float32 l = sqrtf(lengthSqr(a)); return l > c_epsilon ? mul(a, 1.0f / l) : Vector2(); }
+static inline Vector2 ground(const Vector3 &v) { return Vector2(v.m_x, v.m_z); }
+
+// velocities allowed by a neighbour: left of line through m_point along m_direction (unit)
+struct OrcaLine
+{
+	Vector2 m_point;
+	Vector2 m_direction;
+};
+
+// velocity on line lineNo closest to optVelocity (or furthest along it if directionOpt) that is within speed circle
+// and allowed by lines before lineNo. false if there is none
+static bool LinearProgram1(const OrcaLine *pLines, UInt32 lineNo, Float32 radius, const Vector2 &optVelocity, bool directionOpt, Vector2 &result)
+{
+	const OrcaLine &line = pLines[lineNo];
+	Float32 dotProduct = dot(line.m_point, line.m_direction);
+	Float32 discriminant = dotProduct * dotProduct + radius * radius - lengthSqr(line.m_point);
+	if (discriminant < 0.0f)
+		return false; // line misses speed circle
+
+	Float32 sqrtDiscriminant = sqrtf(discriminant);
+	Float32 tLeft = -dotProduct - sqrtDiscriminant;
+	Float32 tRight = -dotProduct + sqrtDiscriminant;
+
+	for (UInt32 i = 0; i < lineNo; ++i)
+	{
+		Float32 denominator = det(line.m_direction, pLines[i].m_direction);
+		Float32 numerator = det(pLines[i].m_direction, sub(line.m_point, pLines[i].m_point));
+
+		if (fabsf(denominator) <= c_epsilon)
+		{
+			// parallel lines
+			if (numerator < 0.0f)
+				return false;
+			continue;
+		}
+
+		Float32 t = numerator / denominator;
+		if (denominator >= 0.0f)
+			tRight = t < tRight ? t : tRight;
+		else
+			tLeft = t > tLeft ? t : tLeft;
+
+		if (tLeft > tRight)
+			return false;
+	}
+
+	if (directionOpt)
+	{
+		result = add(line.m_point, mul(line.m_direction, dot(optVelocity, line.m_direction) > 0.0f ? tRight : tLeft));
+	}
+	else
+	{
+		Float32 t = dot(line.m_direction, sub(optVelocity, line.m_point));
+		if (t < tLeft)
+			t = tLeft;
+		else if (t > tRight)
+			t = tRight;
+		result = add(line.m_point, mul(line.m_direction, t));
+	}
+	return true;
+}
+
+// velocity closest to optVelocity within speed circle allowed by all lines.
+// returns numLines, or index of first line that could not be satisfied (result is best before it)
+static UInt32 LinearProgram2(const OrcaLine *pLines, UInt32 numLines, Float32 radius, const Vector2 &optVelocity, bool directionOpt, Vector2 &result)
+{
+	if (directionOpt)
+		result = mul(optVelocity, radius); // optVelocity is unit
+	else if (lengthSqr(optVelocity) > radius * radius)
+		result = mul(normalized(optVelocity), radius);
+	else
+		result = optVelocity;
+
+	for (UInt32 i = 0; i < numLines; ++i)
+	{
+		if (det(pLines[i].m_direction, sub(pLines[i].m_point, result)) > 0.0f)
+		{
+			// result is not allowed by line i, best is on it
+			Vector2 tempResult = result;
+			if (!LinearProgram1(pLines, i, radius, optVelocity, directionOpt, result))
+			{
+				result = tempResult;
+				return i;
+			}
+		}
+	}
+	return numLines;
+}
+
+// no velocity is allowed by all lines: velocity that minimizes largest distance into forbidden side of lines from beginLine on
+static void LinearProgram3(const OrcaLine *pLines, UInt32 numLines, UInt32 beginLine, Float32 radius, Vector2 &result)
+{
+	OrcaLine projLines[PE_CROWD_MAX_NEIGHBORS];
+	Float32 distance = 0.0f;
+
+	for (UInt32 i = beginLine; i < numLines; ++i)
+	{
+		if (det(pLines[i].m_direction, sub(pLines[i].m_point, result)) <= distance)
+			continue;
+
+		// result violates line i more than the others: project other lines on it
+		UInt32 numProjLines = 0;
+		for (UInt32 j = 0; j < i; ++j)
+		{
+			OrcaLine line;
+			Float32 determinant = det(pLines[i].m_direction, pLines[j].m_direction);
+
+			if (fabsf(determinant) <= c_epsilon)
+			{
+				if (dot(pLines[i].m_direction, pLines[j].m_direction) > 0.0f)
+					continue; // same direction
+				line.m_point = mul(add(pLines[i].m_point, pLines[j].m_point), 0.5f);
+			}
+			else
+			{
+				line.m_point = add(pLines[i].m_point, mul(pLines[i].m_direction, det(pLines[j].m_direction, sub(pLines[i].m_point, pLines[j].m_point)) / determinant));
+			}
+
+			line.m_direction = normalized(sub(pLines[j].m_direction, pLines[i].m_direction));
+			projLines[numProjLines++] = line;
+		}
+
+		Vector2 tempResult = result;
+		if (LinearProgram2(projLines, numProjLines, radius, Vector2(-pLines[i].m_direction.m_y, pLines[i].m_direction.m_x), true, result) < numProjLines)
+		{
+			// can only fail by floating point error, keep previous result
+			result = tempResult;
+		}
+
+		distance = det(pLines[i].m_direction, sub(pLines[i].m_point, result));
+	}
+}
+
+CrowdSimulation::CrowdSimulation(PE::GameContext &context, PE::MemoryArena arena)
+: m_avoidance(true)
+, m_serial(false)
+, m_stepTime(0)
+, m_agents(context, arena, 64)
+, m_bucketStart(context, arena, 256)
+, m_bucketAgents(context, arena, 64)
+, m_agentBuckets(context, arena, 64)
+, m_hashMask(0)
+, m_frameTime(0)
+{}
+
+void CrowdSimulation::buildHash()
+{
+	UInt32 numAgents = m_agents.m_size;
+
+	// at least twice as many buckets as agents, few cells share a bucket
+	UInt32 numBuckets = 64;
+	while (numBuckets < numAgents * 2)
+		numBuckets *= 2;
+	m_hashMask = numBuckets - 1;
+
+	if (m_bucketStart.m_capacity < numBuckets + 1)
+		m_bucketStart.reset(numBuckets + 1);
+	m_bucketStart.m_size = numBuckets + 1;
+	if (m_bucketAgents.m_capacity < numAgents)
+		m_bucketAgents.reset(numAgents);
+	m_bucketAgents.m_size = numAgents;
+	if (m_agentBuckets.m_capacity < numAgents)
+		m_agentBuckets.reset(numAgents);
+	m_agentBuckets.m_size = numAgents;
+
+	UInt32 *pStart = m_bucketStart.getFirstPtr();
+	memset(pStart, 0, sizeof(UInt32) * (numBuckets + 1));
+
+	// counting sort by bucket, agents of a bucket stay in index order
+	const Float32 invCellSize = 1.0f / PE_CROWD_NEIGHBOR_DIST;
+	for (UInt32 i = 0; i < numAgents; ++i)
+	{
+		const Vector3 &pos = m_agents[i].m_pos;
+		UInt32 b = cellHash((Int32)(floorf(pos.m_x * invCellSize)), (Int32)(floorf(pos.m_z * invCellSize)));
+		m_agentBuckets[i] = b;
+		++pStart[b];
+	}
+
+	UInt32 sum = 0;
+	for (UInt32 b = 0; b < numBuckets; ++b)
+	{
+		UInt32 count = pStart[b];
+		pStart[b] = sum;
+		sum += count;
+	}
+	pStart[numBuckets] = sum;
+
+	// fill, pStart[b] advances to start of next bucket
+	for (UInt32 i = 0; i < numAgents; ++i)
+		m_bucketAgents[pStart[m_agentBuckets[i]]++] = i;
+	for (UInt32 b = numBuckets; b > 0; --b)
+		pStart[b] = pStart[b - 1];
+	pStart[0] = 0;
+}
+
+UInt32 CrowdSimulation::findNeighbors(UInt32 agent, UInt32 *pNeighbors, Float32 *pDistSq)
+{
+	const Vector3 &pos = m_agents[agent].m_pos;
+	const Float32 invCellSize = 1.0f / PE_CROWD_NEIGHBOR_DIST;
+	const Float32 rangeSq = PE_CROWD_NEIGHBOR_DIST * PE_CROWD_NEIGHBOR_DIST;
+	Int32 cx = (Int32)(floorf(pos.m_x * invCellSize));
+	Int32 cz = (Int32)(floorf(pos.m_z * invCellSize));
+
+	UInt32 buckets[9];
+	UInt32 numBuckets = 0;
+	UInt32 numNeighbors = 0;
+
+	for (Int32 dz = -1; dz <= 1; ++dz)
+	{
+		for (Int32 dx = -1; dx <= 1; ++dx)
+		{
+			// neighbour cells can share a bucket, visit it once
+			UInt32 b = cellHash(cx + dx, cz + dz);
+			bool visited = false;
+			for (UInt32 k = 0; k < numBuckets; ++k)
+				visited |= buckets[k] == b;
+			if (visited)
+				continue;
+			buckets[numBuckets++] = b;
+
+			for (UInt32 s = m_bucketStart[b], e = m_bucketStart[b + 1]; s < e; ++s)
+			{
+				UInt32 other = m_bucketAgents[s];
+				if (other == agent)
+					continue;
+
+				const Vector3 &otherPos = m_agents[other].m_pos;
+				Float32 x = otherPos.m_x - pos.m_x, z = otherPos.m_z - pos.m_z;
+				Float32 distSq = x * x + z * z;
+				if (distSq >= rangeSq)
+					continue;
+
+				// insert into nearest PE_CROWD_MAX_NEIGHBORS, ordered by distance then index.
+				// buckets are visited in arbitrary order, the order makes result independent of it
+				if (numNeighbors == PE_CROWD_MAX_NEIGHBORS)
+				{
+					UInt32 last = numNeighbors - 1;
+					if (distSq > pDistSq[last] || (distSq == pDistSq[last] && other > pNeighbors[last]))
+						continue;
+					--numNeighbors;
+				}
+
+				UInt32 k = numNeighbors++;
+				while (k > 0 && (pDistSq[k - 1] > distSq || (pDistSq[k - 1] == distSq && pNeighbors[k - 1] > other)))
+				{
+					pDistSq[k] = pDistSq[k - 1];
+					pNeighbors[k] = pNeighbors[k - 1];
+					--k;
+				}
+				pDistSq[k] = distSq;
+				pNeighbors[k] = other;
+			}
+		}
+	}
+	return numNeighbors;
+}
+
+void CrowdSimulation::computeNewVelocity(UInt32 agent)
+{
+	CrowdAgent &a = m_agents[agent];
+
+	if (a.m_static)
+	{
+		a.m_newVelocity = Vector3();
+		return;
+	}
+
+	Vector2 preferred = ground(a.m_preferredVelocity);
+	if (!m_avoidance)
+	{
+		a.m_newVelocity = Vector3(preferred.m_x, a.m_preferredVelocity.m_y, preferred.m_y);
+		return;
+	}
+
+	UInt32 neighbors[PE_CROWD_MAX_NEIGHBORS];
+	Float32 distSqs[PE_CROWD_MAX_NEIGHBORS];
+	UInt32 numNeighbors = findNeighbors(agent, neighbors, distSqs);
+
+	Vector2 pos = ground(a.m_pos);
+	Vector2 velocity = ground(a.m_velocity);
+
+	// direction to a neighbour in the same spot: opposite for the two of them
+	Vector2 samePosDir(1.0f, 0.0f);
+
+	// separation
+	Vector2 push;
+	for (UInt32 k = 0; k < numNeighbors; ++k)
+	{
+		const CrowdAgent &other = m_agents[neighbors[k]];
+		Float32 range = (a.m_radius + other.m_radius) * PE_CROWD_SEPARATION_RANGE;
+		Float32 dist = sqrtf(distSqs[k]);
+		if (dist >= range)
+			continue;
+
+		Vector2 dir = dist > c_epsilon ? mul(sub(ground(other.m_pos), pos), 1.0f / dist) : (agent < neighbors[k] ? samePosDir : mul(samePosDir, -1.0f));
+		push = sub(push, mul(dir, 1.0f - dist / range));
+	}
+	preferred = add(preferred, mul(push, PE_CROWD_SEPARATION_WEIGHT * a.m_maxSpeed));
+
+	// queueing: don't push into an agent ahead in own lane that goes the same way slower
+	Float32 preferredSpeed = sqrtf(lengthSqr(preferred));
+	if (preferredSpeed > a.m_maxSpeed)
+		preferredSpeed = a.m_maxSpeed;
+	Vector2 preferredDir = normalized(preferred);
+	for (UInt32 k = 0; k < numNeighbors && preferredSpeed > c_epsilon; ++k)
+	{
+		const CrowdAgent &other = m_agents[neighbors[k]];
+		if (other.m_static)
+			continue; // avoided, not followed
+
+		Vector2 relPos = sub(ground(other.m_pos), pos);
+		Float32 ahead = dot(relPos, preferredDir);
+		Float32 combinedRadius = a.m_radius + other.m_radius;
+		if (ahead <= 0.0f || ahead > combinedRadius + PE_CROWD_QUEUE_DISTANCE || fabsf(det(preferredDir, relPos)) >= combinedRadius)
+			continue;
+
+		Float32 otherSpeed = dot(ground(other.m_velocity), preferredDir);
+		if (otherSpeed > 0.0f && otherSpeed < preferredSpeed) // coming towards us: avoidance handles it
+			preferredSpeed = otherSpeed;
+	}
+	preferred = mul(preferredDir, preferredSpeed);
+
+	// orca half planes
+	OrcaLine lines[PE_CROWD_MAX_NEIGHBORS];
+	const Float32 invTimeHorizon = 1.0f / PE_CROWD_TIME_HORIZON;
+	const Float32 invFrameTime = 1.0f / m_frameTime;
+
+	for (UInt32 k = 0; k < numNeighbors; ++k)
+	{
+		const CrowdAgent &other = m_agents[neighbors[k]];
+		Vector2 relPos = sub(ground(other.m_pos), pos);
+		Vector2 relVel = sub(velocity, ground(other.m_velocity));
+		Float32 distSq = distSqs[k];
+		Float32 combinedRadius = a.m_radius + other.m_radius;
+		Float32 combinedRadiusSq = combinedRadius * combinedRadius;
+
+		OrcaLine &line = lines[k];
+		Vector2 u;
+
+		if (distSq > combinedRadiusSq)
+		{
+			// no collision yet. w: from cutoff center (velocity obstacle truncated at time horizon) to relative velocity
+			Vector2 w = sub(relVel, mul(relPos, invTimeHorizon));
+			Float32 wLengthSq = lengthSqr(w);
+			Float32 dotProduct = dot(w, relPos);
+
+			if (dotProduct < 0.0f && dotProduct * dotProduct > combinedRadiusSq * wLengthSq)
+			{
+				// project on cutoff circle
+				Float32 wLength = sqrtf(wLengthSq);
+				Vector2 unitW = mul(w, 1.0f / wLength);
+				line.m_direction = Vector2(unitW.m_y, -unitW.m_x);
+				u = mul(unitW, combinedRadius * invTimeHorizon - wLength);
+			}
+			else
+			{
+				// project on legs
+				Float32 leg = sqrtf(distSq - combinedRadiusSq);
+				if (det(relPos, w) > 0.0f)
+					line.m_direction = mul(Vector2(relPos.m_x * leg - relPos.m_y * combinedRadius, relPos.m_x * combinedRadius + relPos.m_y * leg), 1.0f / distSq);
+				else
+					line.m_direction = mul(Vector2(relPos.m_x * leg + relPos.m_y * combinedRadius, -relPos.m_x * combinedRadius + relPos.m_y * leg), -1.0f / distSq);
+
+				u = sub(mul(line.m_direction, dot(relVel, line.m_direction)), relVel);
+			}
+		}
+		else
+		{
+			// already overlapping: get apart within this step
+			Vector2 w = sub(relVel, mul(relPos, invFrameTime));
+			Float32 wLength = sqrtf(lengthSqr(w));
+			Vector2 unitW;
+			if (wLength > c_epsilon)
+				unitW = mul(w, 1.0f / wLength);
+			else if (distSq > c_epsilon * c_epsilon)
+				unitW = mul(relPos, -1.0f / sqrtf(distSq));
+			else
+				unitW = agent < neighbors[k] ? mul(samePosDir, -1.0f) : samePosDir;
+
+			line.m_direction = Vector2(unitW.m_y, -unitW.m_x);
+			u = mul(unitW, combinedRadius * invFrameTime - wLength);
+		}
+
+		// half of avoiding is done by other agent, static agents leave all of it to this one
+		line.m_point = add(velocity, mul(u, other.m_static ? 1.0f : 0.5f));
+	}
+
+	Vector2 result;
+	UInt32 lineFail = LinearProgram2(lines, numNeighbors, a.m_maxSpeed, preferred, false, result);
+	if (lineFail < numNeighbors)
+		LinearProgram3(lines, numNeighbors, lineFail, a.m_maxSpeed, result);
+
+	a.m_newVelocity = Vector3(result.m_x, a.m_preferredVelocity.m_y, result.m_y);
+}
+
+void CrowdSimulation::ComputeJob(void *pParams, int begin, int end)
+{
+	CrowdSimulation *pCrowd = static_cast<CrowdSimulation *>(pParams);
+	for (int i = begin; i < end; ++i)
+		pCrowd->computeNewVelocity((UInt32)(i));
+}
+
+void CrowdSimulation::step(Float32 frameTime)
+{
+	Timer t;
+	Timer::TimeType start = t.TickAndGetCurrentTime();
+
+	m_frameTime = frameTime > c_epsilon ? frameTime : c_epsilon;
+
+	if (m_avoidance)
+		buildHash();
+
+	if (m_serial)
+		ComputeJob(this, 0, m_agents.m_size);
+	else
+		JobSystem::parallelFor(m_agents.m_size, PE_CROWD_AGENTS_PER_JOB, &ComputeJob, this);
+
+	m_stepTime = (Float32)(Timer::GetTimeDeltaInSeconds(start, t.TickAndGetCurrentTime()));
+}
+
+void CrowdSimulation::integrate(Float32 frameTime)
+{
+	for (UInt32 i = 0; i < m_agents.m_size; ++i)
+	{
+		CrowdAgent &a = m_agents[i];
+		a.m_pos += a.m_newVelocity * frameTime;
+		a.m_velocity = a.m_newVelocity;
+	}
+}
+
+UInt32 CrowdSimulation::countOverlaps(Float32 fraction)
+{
+	buildHash();
+
+	// all agents of 3x3 cells, not just nearest ones: without avoidance many overlap
+	const Float32 invCellSize = 1.0f / PE_CROWD_NEIGHBOR_DIST;
+	UInt32 numOverlaps = 0;
+	for (UInt32 i = 0; i < m_agents.m_size; ++i)
+	{
+		const CrowdAgent &a = m_agents[i];
+		Int32 cx = (Int32)(floorf(a.m_pos.m_x * invCellSize));
+		Int32 cz = (Int32)(floorf(a.m_pos.m_z * invCellSize));
+
+		UInt32 buckets[9];
+		UInt32 numBuckets = 0;
+		for (Int32 dz = -1; dz <= 1; ++dz)
+		{
+			for (Int32 dx = -1; dx <= 1; ++dx)
+			{
+				UInt32 b = cellHash(cx + dx, cz + dz);
+				bool visited = false;
+				for (UInt32 k = 0; k < numBuckets; ++k)
+					visited |= buckets[k] == b;
+				if (visited)
+					continue;
+				buckets[numBuckets++] = b;
+
+				for (UInt32 s = m_bucketStart[b], e = m_bucketStart[b + 1]; s < e; ++s)
+				{
+					UInt32 other = m_bucketAgents[s];
+					if (other <= i)
+						continue; // each pair once
+
+					const CrowdAgent &o = m_agents[other];
+					Float32 x = o.m_pos.m_x - a.m_pos.m_x, z = o.m_pos.m_z - a.m_pos.m_z;
+					Float32 minDist = (a.m_radius + o.m_radius) * fraction;
+					if (x * x + z * z < minDist * minDist)
+						++numOverlaps;
+				}
+			}
+		}
+	}
+	return numOverlaps;
+}
+
+}; // namespace PE
@@ -0,0 +1,92 @@
+#ifndef __PYENGINE_2_0_CROWD_SIMULATION_H__
+#define __PYENGINE_2_0_CROWD_SIMULATION_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Vector3.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+namespace PE {
+
+// agent of crowd. avoidance is on the ground plane (x and z), y of new velocity is y of preferred velocity
+struct CrowdAgent
+{
+	CrowdAgent()
+		: m_radius(PE_CROWD_DEFAULT_RADIUS), m_maxSpeed(0), m_static(false)
+	{}
+
+	Vector3 m_pos;
+	Vector3 m_velocity; // of last step, what neighbours expect this agent to keep doing
+	Vector3 m_preferredVelocity; // towards goal (waypoint), at most m_maxSpeed
+	PrimitiveTypes::Float32 m_radius;
+	PrimitiveTypes::Float32 m_maxSpeed;
+	bool m_static; // doesn't move (standing soldier). others go around it and take all of avoiding on themselves
+
+	// result of step()
+	Vector3 m_newVelocity;
+};
+
+// Local avoidance of crowd agents (ORCA, reciprocal velocity obstacles as in RVO2) with separation and queueing.
+// step() puts agents in a uniform spatial hash (cell size = PE_CROWD_NEIGHBOR_DIST), then each agent, in jobs of
+// PE_CROWD_AGENTS_PER_JOB agents:
+// - takes its PE_CROWD_MAX_NEIGHBORS nearest agents (ties by index)
+// - separation: preferred velocity is pushed away from agents closer than PE_CROWD_SEPARATION_RANGE x combined radius
+// - queueing: behind an agent going the same way in its lane it does not want to be faster than that agent
+// - builds a half plane of allowed velocities per neighbour (no collision for PE_CROWD_TIME_HORIZON seconds) and
+//   picks the allowed velocity closest to preferred one with a 2d linear program; if no velocity is allowed, the one
+//   that least violates the half planes
+// Every agent reads only inputs and writes only its own m_newVelocity, so result does not depend on how agents are
+// split into jobs: same inputs give bitwise same result on any number of workers.
+struct CrowdSimulation
+{
+	CrowdSimulation(PE::GameContext &context, PE::MemoryArena arena);
+
+	void clear() { m_agents.clear(); }
+	PrimitiveTypes::UInt32 addAgent(const CrowdAgent &agent) { m_agents.add(agent); return m_agents.m_size - 1; }
+	CrowdAgent &getAgent(PrimitiveTypes::UInt32 index) { return m_agents[index]; }
+	PrimitiveTypes::UInt32 getNumAgents() { return m_agents.m_size; }
+
+	// computes m_newVelocity of all agents for a step of frameTime seconds
+	void step(PrimitiveTypes::Float32 frameTime);
+
+	// moves agents by m_newVelocity and makes it their m_velocity. for users that don't move agents themselves
+	void integrate(PrimitiveTypes::Float32 frameTime);
+
+	// pairs of agents closer than fraction x combined radius (of current positions)
+	PrimitiveTypes::UInt32 countOverlaps(PrimitiveTypes::Float32 fraction);
+
+	bool m_avoidance; // false: m_newVelocity is preferred velocity, nothing else (for comparison)
+	bool m_serial; // false: jobs on job system
+	PrimitiveTypes::Float32 m_stepTime; // seconds, last step()
+
+private:
+	void buildHash();
+	PrimitiveTypes::UInt32 cellHash(PrimitiveTypes::Int32 cx, PrimitiveTypes::Int32 cz) { return ((PrimitiveTypes::UInt32)(cx) * 73856093u ^ (PrimitiveTypes::UInt32)(cz) * 19349663u) & m_hashMask; }
+	PrimitiveTypes::UInt32 findNeighbors(PrimitiveTypes::UInt32 agent, PrimitiveTypes::UInt32 *pNeighbors, PrimitiveTypes::Float32 *pDistSq);
+	void computeNewVelocity(PrimitiveTypes::UInt32 agent);
+
+	static void ComputeJob(void *pParams, int begin, int end);
+
+	Array<CrowdAgent, 1> m_agents;
+
+	// spatial hash: agents of bucket b are m_bucketAgents[m_bucketStart[b] .. m_bucketStart[b + 1])
+	Array<PrimitiveTypes::UInt32, 1> m_bucketStart;
+	Array<PrimitiveTypes::UInt32, 1> m_bucketAgents;
+	Array<PrimitiveTypes::UInt32, 1> m_agentBuckets;
+	PrimitiveTypes::UInt32 m_hashMask;
+	PrimitiveTypes::Float32 m_frameTime;
+};
+
+}; // namespace PE
+
+#endif
@@ -8,9 +8,9 @@
 
 // Sibling/Children includes
 #include "DebugRenderer.h"
-#include "PrimeEngine/Scene/TextMesh.h"
 #include "PrimeEngine/Scene/LineMesh.h"
-#include "PrimeEngine/Scene/TextSceneNode.h"
+#include "PrimeEngine/Scene/TextBatcher.h"
+#include "PrimeEngine/Scene/DrawList.h"
 #include "PrimeEngine/Scene/RootSceneNode.h"
 #include "PrimeEngine/Events/StandardEvents.h"
 #include "PrimeEngine/Scene/MeshManager.h"
@@ -42,15 +42,15 @@ void DebugRenderer::Construct(PE::GameContext &context, PE::MemoryArena arena)
 // Constructor -------------------------------------------------------------
 DebugRenderer::DebugRenderer(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself)
 : SceneNode(context, arena, hMyself)
+, m_textEntries(context, arena, NUM_TextEntries)
+, m_textChars(context, arena, NUM_TextChars)
+, m_numDroppedTexts(0)
 , m_lineLists(context, arena, NUM_LineLists)
-, m_numFreeing(0)
 {
 	for (int i = 0; i < NUM_LineLists; ++i)
 		m_lineLists.add(Array<float>(context, arena));
 
-	m_numAvaialble = NUM_TextSceneNodes;
-	for (int i = 0; i < NUM_TextSceneNodes; i++)
-		m_hAvailableSNs[i] = i;
+	m_projectionViewTransform.loadIdentity();
 
 	m_numAvailableLineLists = NUM_LineLists;
 	for (int i = 0; i < NUM_LineLists; i++)
@@ -65,7 +65,7 @@ void DebugRenderer::addDefaultComponents()
 	PE_REGISTER_EVENT_HANDLER(Events::Event_PRE_GATHER_DRAWCALLS, DebugRenderer::do_PRE_GATHER_DRAWCALLS);
 	
 	m_currentlyDrawnLineMesh = 0;
-	for (int i = 0 ; i < 2; ++i)
+	for (int i = 0 ; i < NUM_LineMeshes; ++i)
 	{
 		m_hLineMeshes[i] = PE::Handle("LINEMESH", sizeof(LineMesh));
 		LineMesh *pLineMesh = new(m_hLineMeshes[i]) LineMesh(*m_pContext, m_arena, m_hLineMeshes[i]);
@@ -189,41 +189,37 @@ void DebugRenderer::createLineMesh(bool hasTransform, const Matrix4x4 &transform
 
 void DebugRenderer::createTextMesh(const char *str, bool isOverlay2D, bool is3D, bool is3DFacedToCamera, bool is3DFacedToCameraLockedYAxis, float timeToLive, Vector3 pos, float scale, int &threadOwnershipMask)
 {
-	if (EnableDebugRendering && m_numAvaialble)
+	if (!EnableDebugRendering)
+		return;
+
+	int len = StringOps::length(str);
+	if (m_textEntries.m_size == m_textEntries.m_capacity || m_textChars.m_size + len > m_textChars.m_capacity)
 	{
-		int index = m_hAvailableSNs[--m_numAvaialble];
-		Handle &h = m_hSNPool[index];
-		TextSceneNode *pTextSN = 0;
-		if (h.isValid())
-		{
-			//scene node has already been created
-			pTextSN = h.getObject<TextSceneNode>();
-			assert(pTextSN->isEnabled() == false); // this SN should never be in the available list if it is enabled
-			pTextSN->setSelfAndMeshAssetEnabled(true);
-		}
-		else
-		{
-			h = PE::Handle("TEXT_SCENE_NODE", sizeof(TextSceneNode));
-			pTextSN = new(h) TextSceneNode(*m_pContext, m_arena, h);
-			pTextSN->addDefaultComponents();
-			addComponent(h);
-		}
-		m_lifetimes[index] = timeToLive;
-		TextSceneNode::DrawType drawType = TextSceneNode::InWorld;
-		if (isOverlay2D)
-		{
-			drawType = TextSceneNode::Overlay2D;
-		
-			// modify position to fit [-1,1] coordinates
-			pos.m_x = -1.0f + 2.0f * pos.m_x;
-			pos.m_y = -1.0f + 2.0f * (1.0f - pos.m_y);
-		}
-		if (is3DFacedToCamera)
-			drawType = TextSceneNode::Overlay2D_3DPos;
-		pTextSN->loadFromString_needsRC(str, drawType, threadOwnershipMask);
-		pTextSN->m_base.setPos(pos);
-		pTextSN->m_scale = scale;
-	}	
+		++m_numDroppedTexts;
+		return;
+	}
+
+	TextEntry e;
+	e.m_drawType = TextEntry::InWorld;
+	if (isOverlay2D)
+	{
+		e.m_drawType = TextEntry::Overlay2D;
+
+		// modify position to fit [-1,1] coordinates
+		pos.m_x = -1.0f + 2.0f * pos.m_x;
+		pos.m_y = -1.0f + 2.0f * (1.0f - pos.m_y);
+	}
+	if (is3DFacedToCamera)
+		e.m_drawType = TextEntry::Overlay2D_3DPos;
+	e.m_pos = pos;
+	e.m_scale = scale;
+	e.m_lifetime = timeToLive;
+	e.m_firstChar = m_textChars.m_size;
+	e.m_length = len;
+	m_textEntries.add(e);
+
+	memcpy(m_textChars.getFirstPtr() + m_textChars.m_size, str, len);
+	m_textChars.m_size += len;
 }
 
 void DebugRenderer::do_PRE_GATHER_DRAWCALLS(Events::Event *pEvt)
@@ -232,29 +228,8 @@ void DebugRenderer::do_PRE_GATHER_DRAWCALLS(Events::Event *pEvt)
 	Events::Event_PRE_GATHER_DRAWCALLS *pDrawEvent = NULL;
 	pDrawEvent = (Events::Event_PRE_GATHER_DRAWCALLS *)(pEvt);
 
-	while (m_numFreeing)
-	{
-		m_hAvailableSNs[m_numAvaialble++] = m_hFreeingSNs[--m_numFreeing];
-	}
-
-	for (int i = 0; i < NUM_TextSceneNodes; i++)
-	{
-		PE::Handle &h = m_hSNPool[i];
-		if (h.isValid())
-		{
-			TextSceneNode *pTextSN = h.getObject<TextSceneNode>();
-			if (pTextSN->isEnabled())
-			{
-				if (m_lifetimes[i] < 0.0f)
-				{
-					pTextSN->setSelfAndMeshAssetEnabled(false);
-					m_hFreeingSNs[m_numFreeing++] = i;
-				}
-
-				m_lifetimes[i] -= 1.0f;
-			}
-		}
-	}
+	// text is expired in postPreDraw() after it is written
+	m_projectionViewTransform = pDrawEvent->m_projectionViewTransform;
 
 	int totalSize = 0;
 	for (int i =0; i < NUM_LineLists; i++)
@@ -281,6 +256,8 @@ void DebugRenderer::postPreDraw(int &threadOwnershipMask)
 #ifdef _DEBUG
 	//printf("DEBUG: DebugRenderer::postPreDraw called\n");
 #endif
+	drawTexts(threadOwnershipMask);
+
 	// need to generate lines meshes in this method
 
 	//first get size of existing
@@ -330,7 +307,7 @@ void DebugRenderer::postPreDraw(int &threadOwnershipMask)
 	pLineMesh->setEnabled(false);
 	pLineMeshInstance->setEnabled(false);
 
-	m_currentlyDrawnLineMesh = (m_currentlyDrawnLineMesh+1)%2;
+	m_currentlyDrawnLineMesh = (m_currentlyDrawnLineMesh+1)%NUM_LineMeshes;
 	pLineMesh = m_hLineMeshes[m_currentlyDrawnLineMesh].getObject<LineMesh>();
 	pLineMeshInstance = m_hLineMeshInstances[m_currentlyDrawnLineMesh].getObject<MeshInstance>();
 	
@@ -356,5 +333,56 @@ void DebugRenderer::postPreDraw(int &threadOwnershipMask)
 	vertexData.reset(0);
 }
 
+void DebugRenderer::drawTexts(int &threadOwnershipMask)
+{
+	TextBatcher *pBatcher = TextBatcher::Instance();
+	if (!pBatcher->hasGPUResources())
+		pBatcher->createGPUResources_needsRC(threadOwnershipMask);
+
+	float glyphW = pBatcher->getOverlayGlyphWidth(1.0f);
+	const char *pChars = m_textChars.getFirstPtr();
+	for (unsigned int i = 0; i < m_textEntries.m_size; ++i)
+	{
+		TextEntry &e = m_textEntries[i];
+		const char *str = pChars + e.m_firstChar;
+
+		if (e.m_drawType == TextEntry::Overlay2D)
+			pBatcher->addOverlayText(str, e.m_pos.m_x, e.m_pos.m_y, e.m_scale, e.m_length);
+		else if (e.m_drawType == TextEntry::InWorld)
+			pBatcher->addWorldText(str, e.m_pos, 1.0f, e.m_length); // in world text was never scaled
+		else
+		{
+			Vector3 pos = m_projectionViewTransform * e.m_pos;
+			if (pos.m_x < -1.0f || pos.m_x > 1.0f || pos.m_z <= 0.0f || pos.m_z > 1.0f)
+				continue;
+			pBatcher->addOverlayText(str, pos.m_x - glyphW * e.m_length * .5f, pos.m_y, 1.0f, e.m_length);
+		}
+	}
+
+	// this frame's draw list has been gathered, text goes on top of it
+	pBatcher->upload_needsRC();
+	pBatcher->gatherDrawCalls(DrawList::Instance(), m_projectionViewTransform);
+	pBatcher->nextFrame();
+
+	// text that lived timeToLive + 1 frames is removed, strings of remaining ones are moved down
+	unsigned int numKept = 0;
+	int numChars = 0;
+	char *pMovedChars = m_textChars.getFirstPtr();
+	for (unsigned int i = 0; i < m_textEntries.m_size; ++i)
+	{
+		TextEntry e = m_textEntries[i];
+		e.m_lifetime -= 1.0f;
+		if (e.m_lifetime < 0.0f)
+			continue;
+
+		memmove(pMovedChars + numChars, pMovedChars + e.m_firstChar, e.m_length);
+		e.m_firstChar = numChars;
+		numChars += e.m_length;
+		m_textEntries[numKept++] = e;
+	}
+	m_textEntries.m_size = numKept;
+	m_textChars.m_size = numChars;
+}
+
 }; // namespace Components
 }; //namespace PE
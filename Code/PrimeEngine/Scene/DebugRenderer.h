@@ -15,6 +15,7 @@
 #include "../Math/Vector3.h"
 #include "../Math/Matrix4x4.h"
 #include "SceneNode.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
 
 // Sibling/Children includes
 namespace PE {
@@ -58,6 +59,8 @@ struct DebugRenderer : public SceneNode
 	virtual void do_PRE_GATHER_DRAWCALLS(Events::Event *pEvt);
 	
 	void postPreDraw(int &threadOwnershipMask);
+	// writes text into TextBatcher and adds its draw calls to current draw list. called by postPreDraw()
+	void drawTexts(int &threadOwnershipMask);
 	// Component ------------------------------------------------------------
 
 	virtual void addDefaultComponents();
@@ -65,18 +68,37 @@ struct DebugRenderer : public SceneNode
 	
 	private:
 		static Handle s_myHandle;
-		Handle m_hMyTextMesh;
-		static const int NUM_TextSceneNodes = 64;
-		Handle m_hSNPool[NUM_TextSceneNodes];
-		int m_hFreeingSNs[NUM_TextSceneNodes];
-		int m_hAvailableSNs[NUM_TextSceneNodes];
-		float m_lifetimes[NUM_TextSceneNodes];
-		int m_numAvaialble;
-		int m_numFreeing;
-
-
-		Handle m_hLineMeshes[2]; // we will alternate between two meshes so that we can generate new one while old one is in draw call
-		Handle m_hLineMeshInstances[2];
+
+		// text is kept as strings and written into TextBatcher every frame
+		struct TextEntry
+		{
+			enum DrawType
+			{
+				Overlay2D, // pos is in [-1, 1]
+				Overlay2D_3DPos, // world pos is projected, text is centered on it
+				InWorld,
+			};
+
+			Vector3 m_pos;
+			float m_scale;
+			float m_lifetime;
+			int m_drawType;
+			int m_firstChar; // in m_textChars
+			int m_length;
+		};
+		static const int NUM_TextEntries = 1024;
+		static const int NUM_TextChars = 64 * 1024;
+		Array<TextEntry> m_textEntries;
+		Array<char> m_textChars; // strings of m_textEntries, in the same order
+		int m_numDroppedTexts;
+		Matrix4x4 m_projectionViewTransform; // of last PRE_GATHER_DRAWCALLS
+
+
+		// we will cycle through meshes so that we can generate new one while old ones are in draw lists in flight
+		// mesh generated in pre render is gathered next frame, so it is used until that frame is drawn
+		static const int NUM_LineMeshes = PE_NUM_FRAMES_IN_FLIGHT + 1;
+		Handle m_hLineMeshes[NUM_LineMeshes];
+		Handle m_hLineMeshInstances[NUM_LineMeshes];
 		int m_currentlyDrawnLineMesh;
 		static const int NUM_LineLists = (5 * 1024);
 		Array<Array<float> > m_lineLists;
@@ -12,9 +12,10 @@ namespace Components {
 
 PE_IMPLEMENT_CLASS1(DrawList, Component);
 
-Handle DrawList::s_normalLists[2] = {Handle(), Handle()};
-Handle DrawList::s_zOnlyLists[2] = {Handle(), Handle()};
+Handle DrawList::s_normalLists[PE_NUM_FRAMES_IN_FLIGHT];
+Handle DrawList::s_zOnlyLists[PE_NUM_FRAMES_IN_FLIGHT];
 PrimitiveTypes::UInt32 DrawList::m_curBuffer = 0;
+PrimitiveTypes::UInt32 DrawList::m_curReadBuffer = 0;
 
 void DrawList::importMesh(Handle hMesh)
 {
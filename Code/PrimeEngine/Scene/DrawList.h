@@ -19,6 +19,7 @@
 #include "PrimeEngine/APIAbstraction/GPUBuffers/IndexBufferGPU.h"
 //#include "PrimeEngine/APIAbstraction/Effect/Lighting.h"
 #include "PrimeEngine/Events/StandardEvents.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
 
 // Sibling/Children includes
 
@@ -71,15 +72,19 @@ struct DrawList : public Component
 	{
 		m_hMyself = hMyself;
 		m_numDrawCalls = 0;
+		m_viewProjMatrix.loadIdentity();
+		m_doMotionBlur = false;
 
 
 	}
 	virtual ~DrawList(){}
 
 	// Singleton ---------------------------------------------------------------
+	// one normal and one z only list per frame in flight. game thread writes Instance(), render thread
+	// reads InstanceReadOnly(). FramePipeline makes sure game thread doesn't reuse a list that is still drawn
 	static void Construct(PE::GameContext &context, PE::MemoryArena arena)
 	{
-		for (PrimitiveTypes::UInt32 ibuf = 0; ibuf < 2; ibuf++)
+		for (PrimitiveTypes::UInt32 ibuf = 0; ibuf < PE_NUM_FRAMES_IN_FLIGHT; ibuf++)
 		{
 			s_normalLists[ibuf] = Handle("DRAW_LIST", sizeof(DrawList));
 			DrawList *pDrawList = new(s_normalLists[ibuf]) DrawList(context, arena, s_normalLists[ibuf]);
@@ -90,6 +95,7 @@ struct DrawList : public Component
 			pZOnlyDrawList->addDefaultComponents();
 		}
 		m_curBuffer = 0;
+		m_curReadBuffer = 0;
 	}
 
 	static DrawList *Instance()
@@ -104,12 +110,12 @@ struct DrawList : public Component
 
 	static DrawList *InstanceReadOnly()
 	{
-		return s_normalLists[(m_curBuffer + 1) % 2].getObject<DrawList>();
+		return s_normalLists[m_curReadBuffer].getObject<DrawList>();
 	}
 
 	static DrawList *ZOnlyInstanceReadOnly()
 	{
-		return s_zOnlyLists[(m_curBuffer+1) % 2].getObject<DrawList>();
+		return s_zOnlyLists[m_curReadBuffer].getObject<DrawList>();
 	}
 
 	// Methods
@@ -157,7 +163,11 @@ struct DrawList : public Component
 		}
 	}
 
-	static void swap() {m_curBuffer = (m_curBuffer + 1) % 2;}
+	// game thread is done with the frame, next frame is gathered into next lists
+	static void swap() {m_curBuffer = (m_curBuffer + 1) % PE_NUM_FRAMES_IN_FLIGHT;}
+
+	// render thread is done with the frame, next frame is drawn from next lists
+	static void swapReadOnly() {m_curReadBuffer = (m_curReadBuffer + 1) % PE_NUM_FRAMES_IN_FLIGHT;}
 
 	static void creteCustomZOnlyDrawList(PE::GameContext &context, PE::MemoryArena arena)
 	{
@@ -171,15 +181,20 @@ struct DrawList : public Component
 		pZOnlyDrawListB->addDefaultComponents();
 	}
 
-	static Handle s_normalLists[2]; // handle to itself
-	static Handle s_zOnlyLists[2];
+	static Handle s_normalLists[PE_NUM_FRAMES_IN_FLIGHT]; // handle to itself
+	static Handle s_zOnlyLists[PE_NUM_FRAMES_IN_FLIGHT];
 
-	static PrimitiveTypes::UInt32 m_curBuffer;
+	static PrimitiveTypes::UInt32 m_curBuffer; // written by game thread
+	static PrimitiveTypes::UInt32 m_curReadBuffer; // written by render thread
 	Handle m_hMyself; // handle to itself
 	Handle m_hParent;
 	Handle m_hComponentParent;
 	
 	
+	// per frame data that render thread needs besides draw calls. set by game thread when gathering
+	Matrix4x4 m_viewProjMatrix; // of camera, used by post processing
+	bool m_doMotionBlur;
+
 	// Per Draw Call components
 	PrimitiveTypes::UInt32 m_numDrawCalls;
 
@@ -0,0 +1,39 @@
+#ifndef __PYENGINE_2_0_FRUSTUM_PLANE_H__
+#define __PYENGINE_2_0_FRUSTUM_PLANE_H__
+
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Inter-Engine includes
+#include "PrimeEngine/Math/Vector3.h"
+
+namespace PE {
+namespace Components {
+
+// Frustum plane structure for culling
+struct FrustumPlane
+{
+	Vector3 normal;    // Plane normal (pointing inward toward frustum center)
+	float distance;    // Distance from origin
+	
+	FrustumPlane() : normal(Vector3(0.0f, 0.0f, 0.0f)), distance(0.0f) {}
+	FrustumPlane(const Vector3& n, float d) : normal(n), distance(d) {}
+	
+	// Test if a point is inside the plane (for this engine's convention)
+	bool isPointInside(const Vector3& point)
+	{
+		float dotProduct = normal.dotProduct(point);
+		return (dotProduct + distance) <= 0.0f;  // Inside if negative for this engine
+	}
+	
+	// Test if a sphere is inside the plane
+	bool isSphereInside(const Vector3& center, float radius)
+	{
+		float dotProduct = normal.dotProduct(center);
+		return (dotProduct + distance) <= radius;  // Inside if within radius margin
+	}
+};
+
+}; // namespace Components
+}; // namespace PE
+#endif
@@ -1,5 +1,6 @@
 #include "Light.h"
 #include "SceneNode.h"
+#include "CameraSceneNode.h"
 #include "../Lua/LuaEnvironment.h"
 #include "PrimeEngine/Events/StandardEvents.h"
 #include "PrimeEngine/Math/CameraOps.h"
@@ -38,6 +39,65 @@ void Light::do_CALCULATE_TRANSFORMATIONS(Events::Event *pEvt)
 	m_cbuffer.pos = pos;
 
 }
+void Light::computeShadowCasterPlanes(CameraSceneNode *pCam)
+{
+	Matrix4x4 lightViewProj = m_viewToProjectedTransform * m_worldToViewTransform;
+
+	float minX = -1.0f, maxX = 1.0f, minY = -1.0f, maxY = 1.0f;
+	float maxDepth = 0.0f;
+	bool crop = pCam != NULL;
+
+	if (crop)
+	{
+		Vector3 corners[8];
+		pCam->getCullingFrustumCorners(corners);
+
+		float cMinX = 1.0f, cMaxX = -1.0f, cMinY = 1.0f, cMaxY = -1.0f;
+		for (int i = 0; i < 8; ++i)
+		{
+			const float (&m)[4][4] = lightViewProj.m;
+			const Vector3 &p = corners[i];
+			float x = m[0][0] * p.m_x + m[0][1] * p.m_y + m[0][2] * p.m_z + m[0][3];
+			float y = m[1][0] * p.m_x + m[1][1] * p.m_y + m[1][2] * p.m_z + m[1][3];
+			float w = m[3][0] * p.m_x + m[3][1] * p.m_y + m[3][2] * p.m_z + m[3][3];
+			if (w <= 0.0001f)
+			{
+				// part of camera frustum is behind the light. can't project it, use whole light frustum
+				crop = false;
+				break;
+			}
+			x /= w; y /= w;
+			if (i == 0 || x < cMinX) cMinX = x;
+			if (i == 0 || x > cMaxX) cMaxX = x;
+			if (i == 0 || y < cMinY) cMinY = y;
+			if (i == 0 || y > cMaxY) cMaxY = y;
+			// w is light view space depth for CameraOps perspective projection
+			if (w > maxDepth) maxDepth = w;
+		}
+
+		if (crop)
+		{
+			// an empty window (min > max) means camera sees nothing lit by this light: everything gets culled
+			minX = cMinX > -1.0f ? cMinX : -1.0f;
+			maxX = cMaxX < 1.0f ? cMaxX : 1.0f;
+			minY = cMinY > -1.0f ? cMinY : -1.0f;
+			maxY = cMaxY < 1.0f ? cMaxY : 1.0f;
+		}
+	}
+
+	CameraSceneNode::ExtractFrustumPlanes(lightViewProj, m_shadowCasterPlanes, minX, maxX, minY, maxY);
+
+	if (crop)
+	{
+		// casters further from the light than the furthest visible receiver can't shadow it
+		// far plane: depth <= maxDepth where depth is row 2 of light view transform (orthonormal, no need to normalize)
+		Vector3 lightDir(m_worldToViewTransform.m[2][0], m_worldToViewTransform.m[2][1], m_worldToViewTransform.m[2][2]);
+		float farDist = m_worldToViewTransform.m[2][3] - maxDepth;
+		if (farDist > m_shadowCasterPlanes[5].distance) // same normal as light's far plane: larger distance means tighter plane
+			m_shadowCasterPlanes[5] = FrustumPlane(lightDir, farDist);
+	}
+}
+
 PrimitiveTypes::Bool Light::castsShadow(){
 	return isTheShadowCaster;
 }
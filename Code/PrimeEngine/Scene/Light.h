@@ -17,10 +17,13 @@
 
 #include "PrimeEngine/Render/ShaderActions/SetPerObjectGroupConstantsShaderAction.h"
 // Sibling/Children includes
+#include "FrustumPlane.h"
 
 namespace PE {
 namespace Components {
 
+struct CameraSceneNode;
+
 struct Light : public Component
 {
 
@@ -73,6 +76,11 @@ struct Light : public Component
 	virtual PrimitiveTypes::Bool castsShadow(); //Determines if the light has the shadow caster boolean = true
 	virtual void setCastsShadow(PrimitiveTypes::Bool b); //Set this light to cast a shadow, make all other lights not cast shadows
 
+	// Fills m_shadowCasterPlanes with the light frustum used to cull the Z-only pass.
+	// If pCam is provided the frustum is cropped to the part of light space that can see the camera's culling frustum
+	// (caster volume): casters outside of it can not throw shadows onto anything visible
+	void computeShadowCasterPlanes(CameraSceneNode *pCam);
+
 	// Individual events -------------------------------------------------------
 
 	Handle m_hParent;
@@ -80,6 +88,7 @@ struct Light : public Component
 	Matrix4x4 m_worldTransform; // is calculated before every draw via Events::CALULCATE_TRANSFORMATIONS
 	Matrix4x4 m_worldToViewTransform; // objects in world space are multiplied by this to get them into camera's coordinate system (view space)
 	Matrix4x4 m_viewToProjectedTransform; // objects in local (view) space are multiplied by this to get them to screen space
+	FrustumPlane m_shadowCasterPlanes[6]; // calculated by computeShadowCasterPlanes()
 
 	SetPerObjectGroupConstantsShaderAction::hlsl_Light m_cbuffer; // gpu mirror : values that will be set into gpu registers vi shader action hlsl_cbPerObjectGroup_c1
 };
@@ -0,0 +1,291 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <math.h>
+#include <string.h>
+#if PE_PLAT_IS_WIN32 || defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+// Inter-Engine includes
+#include "PrimeEngine/APIAbstraction/Timer/Timer.h"
+
+// Sibling/Children includes
+#include "LightClusters.h"
+
+namespace PE {
+
+using namespace PrimitiveTypes;
+
+const Float32 LightClusters::c_spotCutoff = 1.0f / 256.0f;
+
+LightClusters *LightClusters::s_pInstance = NULL;
+
+void LightClusters::Construct(PE::GameContext &context, PE::MemoryArena arena)
+{
+	Handle h("LIGHT_CLUSTERS", sizeof(LightClusters));
+	s_pInstance = new(h) LightClusters(context, arena);
+}
+
+LightClusters::LightClusters(PE::GameContext &context, PE::MemoryArena arena)
+: m_lightIndices(context, arena, 16 * 1024)
+, m_directionalLights(context, arena, PE_LIGHT_CLUSTERS_MAX_LIGHTS)
+, m_lightClusterCounts(context, arena, PE_LIGHT_CLUSTERS_MAX_LIGHTS)
+, m_maxLightsPerCluster(0)
+, m_buildTime(0)
+, m_xScale(0), m_yScale(0), m_nearZ(0), m_farZ(0)
+, m_lights(context, arena, PE_LIGHT_CLUSTERS_MAX_LIGHTS)
+, m_hits(context, arena, 16 * 1024)
+{
+	m_arena = arena; m_pContext = &context;
+
+	memset(m_clusterOffsets, 0, sizeof(m_clusterOffsets));
+	memset(m_clusterCounts, 0, sizeof(m_clusterCounts));
+	setFrustum(1.0f, 1.0f, 0.1f, 100.0f);
+}
+
+void LightClusters::setFrustum(Float32 xScale, Float32 yScale, Float32 nearZ, Float32 farZ)
+{
+	if (xScale == m_xScale && yScale == m_yScale && nearZ == m_nearZ && farZ == m_farZ)
+		return;
+
+	m_xScale = xScale;
+	m_yScale = yScale;
+	m_nearZ = nearZ;
+	m_farZ = farZ;
+
+	for (UInt32 k = 0; k <= c_slices; ++k)
+		m_sliceZ[k] = nearZ * powf(farZ / nearZ, (Float32)(k) / (Float32)(c_slices));
+	m_sliceZ[c_slices] = farZ;
+
+	for (UInt32 k = 0; k < c_slices; ++k)
+	{
+		Float32 z[2] = {m_sliceZ[k], m_sliceZ[k + 1]};
+		for (UInt32 y = 0; y < c_tilesY; ++y)
+		{
+			Float32 ndcY[2] = {-1.0f + 2.0f * y / c_tilesY, -1.0f + 2.0f * (y + 1) / c_tilesY};
+			for (UInt32 x = 0; x < c_tilesX; ++x)
+			{
+				Float32 ndcX[2] = {-1.0f + 2.0f * x / c_tilesX, -1.0f + 2.0f * (x + 1) / c_tilesX};
+
+				// box around the 8 corners of the froxel
+				Float32 minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f;
+				for (UInt32 iz = 0; iz < 2; ++iz)
+				{
+					for (UInt32 i = 0; i < 2; ++i)
+					{
+						Float32 vx = ndcX[i] * z[iz] / xScale;
+						Float32 vy = ndcY[i] * z[iz] / yScale;
+						minX = vx < minX ? vx : minX; maxX = vx > maxX ? vx : maxX;
+						minY = vy < minY ? vy : minY; maxY = vy > maxY ? vy : maxY;
+					}
+				}
+
+				UInt32 c = getClusterIndex(x, y, k);
+				m_minX[c] = minX; m_maxX[c] = maxX;
+				m_minY[c] = minY; m_maxY[c] = maxY;
+				m_minZ[c] = z[0]; m_maxZ[c] = z[1];
+
+				m_centerX[c] = (minX + maxX) * 0.5f;
+				m_centerY[c] = (minY + maxY) * 0.5f;
+				m_centerZ[c] = (z[0] + z[1]) * 0.5f;
+				Float32 hx = (maxX - minX) * 0.5f, hy = (maxY - minY) * 0.5f, hz = (z[1] - z[0]) * 0.5f;
+				m_radius[c] = sqrtf(hx * hx + hy * hy + hz * hz);
+			}
+		}
+	}
+}
+
+int LightClusters::addLight(const ClusterLight &light)
+{
+	if (m_lights.m_size >= PE_LIGHT_CLUSTERS_MAX_LIGHTS)
+		return -1;
+	m_lights.add(light);
+	return m_lights.m_size - 1;
+}
+
+int LightClusters::addLight(const SetPerObjectGroupConstantsShaderAction::hlsl_Light &light, Matrix4x4 &worldToView)
+{
+	// same interpretation of type as RenderLight() in lighthelper.fx
+	ClusterLight l;
+	l.m_pos = worldToView * light.pos;
+	l.m_range = light.range;
+	l.m_dir = Vector3(
+		worldToView.m[0][0] * light.dir.m_x + worldToView.m[0][1] * light.dir.m_y + worldToView.m[0][2] * light.dir.m_z,
+		worldToView.m[1][0] * light.dir.m_x + worldToView.m[1][1] * light.dir.m_y + worldToView.m[1][2] * light.dir.m_z,
+		worldToView.m[2][0] * light.dir.m_x + worldToView.m[2][1] * light.dir.m_y + worldToView.m[2][2] * light.dir.m_z);
+	l.m_cosCone = -1.0f;
+	l.m_sinCone = 0;
+	l.m_type = ClusterLight::Type_Point;
+
+	if (light.type >= 0.1f && light.type < 1.1f)
+	{
+		l.m_type = ClusterLight::Type_Directional;
+	}
+	else if (light.type >= 1.1f && light.type < 2.1f && light.spotPower > 0)
+	{
+		// spot factor pow(cos, spotPower) is under c_spotCutoff outside of this cone
+		Float32 len = l.m_dir.length();
+		if (len > 0)
+		{
+			l.m_dir = (1.0f / len) * l.m_dir;
+			l.m_type = ClusterLight::Type_Spot;
+			l.m_cosCone = powf(c_spotCutoff, 1.0f / light.spotPower);
+			l.m_sinCone = sqrtf(1.0f - l.m_cosCone * l.m_cosCone);
+		}
+	}
+	return addLight(l);
+}
+
+// sphere of light vs cluster box, then for spot lights cone vs cluster bounding sphere.
+// build() does exactly the same operations in the same order 4 clusters at a time, so results match bit for bit
+bool LightClusters::lightTouchesCluster(UInt32 light, UInt32 c)
+{
+	ClusterLight &l = m_lights[light];
+	if (l.m_type == ClusterLight::Type_Directional)
+		return false;
+
+	Float32 dx = m_minX[c] - l.m_pos.m_x, dx2 = l.m_pos.m_x - m_maxX[c];
+	Float32 dy = m_minY[c] - l.m_pos.m_y, dy2 = l.m_pos.m_y - m_maxY[c];
+	Float32 dz = m_minZ[c] - l.m_pos.m_z, dz2 = l.m_pos.m_z - m_maxZ[c];
+	dx = dx > dx2 ? dx : dx2; dx = dx > 0 ? dx : 0;
+	dy = dy > dy2 ? dy : dy2; dy = dy > 0 ? dy : 0;
+	dz = dz > dz2 ? dz : dz2; dz = dz > 0 ? dz : 0;
+	Float32 d2 = (dx * dx + dy * dy) + dz * dz;
+	if (!(d2 <= l.m_range * l.m_range))
+		return false;
+
+	if (l.m_type != ClusterLight::Type_Spot)
+		return true;
+
+	Float32 vx = m_centerX[c] - l.m_pos.m_x, vy = m_centerY[c] - l.m_pos.m_y, vz = m_centerZ[c] - l.m_pos.m_z;
+	Float32 lenSq = (vx * vx + vy * vy) + vz * vz;
+	Float32 v1 = (vx * l.m_dir.m_x + vy * l.m_dir.m_y) + vz * l.m_dir.m_z;
+	Float32 perpSq = lenSq - v1 * v1;
+	perpSq = perpSq > 0 ? perpSq : 0;
+	Float32 distToCone = l.m_cosCone * sqrtf(perpSq) - v1 * l.m_sinCone;
+	Float32 r = m_radius[c];
+	bool culled = (distToCone > r) || (v1 > r + l.m_range) || (v1 < 0 - r);
+	return !culled;
+}
+
+void LightClusters::build()
+{
+	Timer timer;
+
+	UInt32 numLights = m_lights.m_size;
+	m_directionalLights.clear();
+	m_hits.clear();
+	m_lightClusterCounts.m_size = numLights;
+	memset(m_lightClusterCounts.getFirstPtr(), 0, numLights * sizeof(UInt32));
+	memset(m_clusterCounts, 0, sizeof(m_clusterCounts));
+
+	Float32 sliceScale = (Float32)(c_slices) / logf(m_farZ / m_nearZ);
+
+	for (UInt32 i = 0; i < numLights; ++i)
+	{
+		ClusterLight &l = m_lights[i];
+		if (l.m_type == ClusterLight::Type_Directional)
+		{
+			m_directionalLights.add((UInt16)(i));
+			continue;
+		}
+
+		// slices the sphere's depth range overlaps, one more on each side against rounding of log
+		Float32 zMin = l.m_pos.m_z - l.m_range, zMax = l.m_pos.m_z + l.m_range;
+		if (zMax <= 0)
+			continue;
+		int firstSlice = zMin > 0 ? (int)(floorf(logf(zMin / m_nearZ) * sliceScale)) - 1 : 0;
+		int lastSlice = (int)(floorf(logf(zMax / m_nearZ) * sliceScale)) + 1;
+		if (lastSlice < 0 || firstSlice >= (int)(c_slices))
+			continue;
+		firstSlice = firstSlice < 0 ? 0 : firstSlice;
+		lastSlice = lastSlice >= (int)(c_slices) ? (int)(c_slices) - 1 : lastSlice;
+
+		bool spot = l.m_type == ClusterLight::Type_Spot;
+		UInt32 numHitsBefore = m_hits.m_size;
+		UInt32 first = firstSlice * c_tilesPerSlice, end = (lastSlice + 1) * c_tilesPerSlice;
+
+#if PE_LIGHT_CLUSTERS_SSE
+		__m128 zero = _mm_setzero_ps();
+		__m128 px = _mm_set1_ps(l.m_pos.m_x), py = _mm_set1_ps(l.m_pos.m_y), pz = _mm_set1_ps(l.m_pos.m_z);
+		__m128 rangeSq = _mm_set1_ps(l.m_range * l.m_range), range = _mm_set1_ps(l.m_range);
+		__m128 dirX = _mm_set1_ps(l.m_dir.m_x), dirY = _mm_set1_ps(l.m_dir.m_y), dirZ = _mm_set1_ps(l.m_dir.m_z);
+		__m128 cosCone = _mm_set1_ps(l.m_cosCone), sinCone = _mm_set1_ps(l.m_sinCone);
+
+		for (UInt32 c = first; c < end; c += 4)
+		{
+			__m128 dx = _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(m_minX + c), px), _mm_sub_ps(px, _mm_loadu_ps(m_maxX + c)));
+			__m128 dy = _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(m_minY + c), py), _mm_sub_ps(py, _mm_loadu_ps(m_maxY + c)));
+			__m128 dz = _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(m_minZ + c), pz), _mm_sub_ps(pz, _mm_loadu_ps(m_maxZ + c)));
+			dx = _mm_max_ps(dx, zero);
+			dy = _mm_max_ps(dy, zero);
+			dz = _mm_max_ps(dz, zero);
+			__m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			int mask = _mm_movemask_ps(_mm_cmple_ps(d2, rangeSq));
+
+			if (mask && spot)
+			{
+				__m128 vx = _mm_sub_ps(_mm_loadu_ps(m_centerX + c), px);
+				__m128 vy = _mm_sub_ps(_mm_loadu_ps(m_centerY + c), py);
+				__m128 vz = _mm_sub_ps(_mm_loadu_ps(m_centerZ + c), pz);
+				__m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+				__m128 v1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, dirX), _mm_mul_ps(vy, dirY)), _mm_mul_ps(vz, dirZ));
+				__m128 perpSq = _mm_max_ps(_mm_sub_ps(lenSq, _mm_mul_ps(v1, v1)), zero);
+				__m128 distToCone = _mm_sub_ps(_mm_mul_ps(cosCone, _mm_sqrt_ps(perpSq)), _mm_mul_ps(v1, sinCone));
+				__m128 r = _mm_loadu_ps(m_radius + c);
+				__m128 culled = _mm_or_ps(_mm_cmpgt_ps(distToCone, r),
+					_mm_or_ps(_mm_cmpgt_ps(v1, _mm_add_ps(r, range)), _mm_cmplt_ps(v1, _mm_sub_ps(zero, r))));
+				mask &= ~_mm_movemask_ps(culled);
+			}
+
+			while (mask)
+			{
+				UInt32 j = (mask & 1) ? 0 : (mask & 2) ? 1 : (mask & 4) ? 2 : 3;
+				mask &= mask - 1;
+				m_hits.add(((c + j) << 16) | i);
+				m_clusterCounts[c + j]++;
+			}
+		}
+#else
+		for (UInt32 c = first; c < end; ++c)
+		{
+			if (lightTouchesCluster(i, c))
+			{
+				m_hits.add((c << 16) | i);
+				m_clusterCounts[c]++;
+			}
+		}
+#endif
+		m_lightClusterCounts[i] = m_hits.m_size - numHitsBefore;
+	}
+
+	// compact lists: offsets are prefix sums of counts, hits are in light order so lists are sorted
+	UInt32 offset = 0;
+	m_maxLightsPerCluster = 0;
+	for (UInt32 c = 0; c < c_numClusters; ++c)
+	{
+		m_clusterOffsets[c] = offset;
+		offset += m_clusterCounts[c];
+		m_maxLightsPerCluster = m_clusterCounts[c] > m_maxLightsPerCluster ? m_clusterCounts[c] : m_maxLightsPerCluster;
+	}
+
+	if (m_lightIndices.m_capacity < offset)
+		m_lightIndices.reset(m_hits.m_capacity);
+	m_lightIndices.m_size = offset;
+
+	UInt16 filled[c_numClusters];
+	memset(filled, 0, sizeof(filled));
+	UInt16 *pIndices = m_lightIndices.getFirstPtr();
+	for (UInt32 h = 0; h < m_hits.m_size; ++h)
+	{
+		UInt32 c = m_hits[h] >> 16;
+		pIndices[m_clusterOffsets[c] + filled[c]++] = (UInt16)(m_hits[h] & 0xffff);
+	}
+
+	m_buildTime = timer.TickAndGetTimeDeltaInSeconds();
+}
+
+}; // namespace PE
@@ -0,0 +1,123 @@
+#ifndef __PYENGINE_2_0_LIGHT_CLUSTERS_H__
+#define __PYENGINE_2_0_LIGHT_CLUSTERS_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Vector3.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/Render/ShaderActions/SetPerObjectGroupConstantsShaderAction.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+// sse on x86 (always there on x64), scalar code with the same math elsewhere
+#if PE_PLAT_IS_WIN32 || defined(__SSE__)
+#define PE_LIGHT_CLUSTERS_SSE 1
+#else
+#define PE_LIGHT_CLUSTERS_SSE 0
+#endif
+
+namespace PE {
+
+// light as it is binned, in camera view space (x right, y up, z depth)
+struct ClusterLight
+{
+	enum Type
+	{
+		Type_Point = 0,
+		Type_Directional = 1,
+		Type_Spot = 2,
+	};
+
+	Vector3 m_pos;
+	PrimitiveTypes::Float32 m_range;
+	Vector3 m_dir; // spot only, normalized
+	PrimitiveTypes::Float32 m_cosCone, m_sinCone; // spot only, half angle of cone
+	PrimitiveTypes::UInt32 m_type;
+};
+
+// Clustered (froxel) light assignment. View frustum is split into PE_LIGHT_CLUSTERS_TILES_X x TILES_Y screen tiles
+// and PE_LIGHT_CLUSTERS_SLICES depth slices (exponential, so clusters are about as deep as wide).
+// build() tests every local light against view space bounding boxes of clusters in its depth range, 4 clusters at a time:
+// sphere vs box for point and spot lights, then cone vs cluster bounding sphere for spot lights.
+// Result is compact: per cluster offset and count into one light index list, indices ascending.
+// Directional lights touch every cluster and are kept in a separate list.
+struct LightClusters : PE::PEAllocatableAndDefragmentable
+{
+	static const PrimitiveTypes::UInt32 c_tilesX = PE_LIGHT_CLUSTERS_TILES_X;
+	static const PrimitiveTypes::UInt32 c_tilesY = PE_LIGHT_CLUSTERS_TILES_Y;
+	static const PrimitiveTypes::UInt32 c_slices = PE_LIGHT_CLUSTERS_SLICES;
+	static const PrimitiveTypes::UInt32 c_tilesPerSlice = c_tilesX * c_tilesY; // multiple of 4
+	static const PrimitiveTypes::UInt32 c_numClusters = c_tilesPerSlice * c_slices;
+
+	// spot light cone ends where pow(cos, spotPower) falls under this
+	static const PrimitiveTypes::Float32 c_spotCutoff;
+
+	LightClusters(PE::GameContext &context, PE::MemoryArena arena);
+
+	static void Construct(PE::GameContext &context, PE::MemoryArena arena);
+	static LightClusters *Instance() { return s_pInstance; }
+
+	// cluster bounds for projection (xScale = proj.m[0][0], yScale = proj.m[1][1]) and depth range.
+	// only recomputed when they change
+	void setFrustum(PrimitiveTypes::Float32 xScale, PrimitiveTypes::Float32 yScale, PrimitiveTypes::Float32 nearZ, PrimitiveTypes::Float32 farZ);
+
+	void clearLights() { m_lights.clear(); }
+
+	// returns light index, or -1 if PE_LIGHT_CLUSTERS_MAX_LIGHTS lights were added already
+	int addLight(const ClusterLight &light);
+	int addLight(const SetPerObjectGroupConstantsShaderAction::hlsl_Light &light, Matrix4x4 &worldToView);
+
+	// bins all lights
+	void build();
+
+	// reference: does light touch cluster. same math as build(), one cluster at a time
+	bool lightTouchesCluster(PrimitiveTypes::UInt32 light, PrimitiveTypes::UInt32 cluster);
+
+	PrimitiveTypes::UInt32 getClusterIndex(PrimitiveTypes::UInt32 x, PrimitiveTypes::UInt32 y, PrimitiveTypes::UInt32 slice)
+	{
+		return slice * c_tilesPerSlice + y * c_tilesX + x;
+	}
+
+	PrimitiveTypes::UInt32 getNumLights() { return m_lights.m_size; }
+
+	// result of build() -----------------------------------------------------
+
+	PrimitiveTypes::UInt32 m_clusterOffsets[c_numClusters]; // into m_lightIndices
+	PrimitiveTypes::UInt16 m_clusterCounts[c_numClusters];
+	Array<PrimitiveTypes::UInt16> m_lightIndices;
+	Array<PrimitiveTypes::UInt16> m_directionalLights;
+	Array<PrimitiveTypes::UInt32> m_lightClusterCounts; // per light, number of clusters it touches
+
+	PrimitiveTypes::UInt32 m_maxLightsPerCluster;
+	PrimitiveTypes::Float32 m_buildTime; // seconds, last build()
+
+	// cluster bounds ------------------------------------------------------
+
+	PrimitiveTypes::Float32 m_xScale, m_yScale, m_nearZ, m_farZ;
+	PrimitiveTypes::Float32 m_sliceZ[c_slices + 1]; // depth where slice starts
+
+	// structure of arrays per cluster so 4 neighbour clusters are tested at once
+	PrimitiveTypes::Float32 m_minX[c_numClusters], m_minY[c_numClusters], m_minZ[c_numClusters];
+	PrimitiveTypes::Float32 m_maxX[c_numClusters], m_maxY[c_numClusters], m_maxZ[c_numClusters];
+	PrimitiveTypes::Float32 m_centerX[c_numClusters], m_centerY[c_numClusters], m_centerZ[c_numClusters], m_radius[c_numClusters];
+
+	Array<ClusterLight> m_lights;
+	Array<PrimitiveTypes::UInt32, 1> m_hits; // build(): cluster << 16 | light, in light order
+
+	PE::MemoryArena m_arena; PE::GameContext *m_pContext;
+
+	static LightClusters *s_pInstance;
+};
+
+}; // namespace PE
+
+#endif
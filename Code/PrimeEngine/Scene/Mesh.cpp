@@ -125,7 +125,21 @@ void chooseEffects(MaterialCPU &curMatCpu, bool hasBlendShapes, EPEVertexFormat
 	// choose effect for each material
 	if (!hasBlendShapes)
 	{
-		if (format == PEVertexFormat_DetailedMesh || format == PEVertexFormat_DetailedSkin)
+		if (format == PEVertexFormat_DetailedMeshPacked || format == PEVertexFormat_DetailedSkinPacked)
+		{
+			PEASSERT(hasBumpMap, "DetailedMesh has to have a normal map. the geometry should have been reduced to StdMesh before if normal map is not present");
+			if (format == PEVertexFormat_DetailedMeshPacked)
+			{
+				effects.add(EffectManager::Instance()->getEffectHandle("DetailedMeshPacked_Shadowed_A_Glow_Tech"));
+				shadowMapEffects.add(EffectManager::Instance()->getEffectHandle("DetailedMeshPacked_ZOnly_Tech"));
+			}
+			else
+			{
+				effects.add(EffectManager::Instance()->getEffectHandle("DetailedSkinPacked_Shadowed_A_Glow_Tech"));
+				shadowMapEffects.add(EffectManager::Instance()->getEffectHandle("DetailedSkinPacked_ZOnly_Tech"));
+			}
+		}
+		else if (format == PEVertexFormat_DetailedMesh || format == PEVertexFormat_DetailedSkin)
 		{
 			PEASSERT(hasBumpMap, "DetailedMesh has to have a normal map. the geometry should have been reduced to StdMesh before if normal map is not present");
 			//todo : have glow and no glow versions
@@ -242,7 +256,8 @@ void Mesh::loadFromMeshCPU_needsRC(MeshCPU &mcpu, int &threadOwnershipMask)
 		m_instanceEffects.add(PEStaticVector<Handle, 4>());
 		
 		chooseEffects(curMatCpu, hasBlendShapes, format, m_effects[im], m_zOnlyEffects[im], m_instanceEffects[im]);
-		if (m_effects[im].m_size)
+		// reloaded meshes (hot reload) already have their effects
+		if (m_effects[im].m_size && m_components.indexOf(m_effects[im][0]) == PrimitiveTypes::Constants::c_MaxUInt32)
 			addComponent(m_effects[im][0]);
 	}
 }
@@ -361,6 +376,19 @@ EPEVertexFormat Mesh::updateGeoFromMeshCPU_needsRC(MeshCPU &mcpu, int &threadOwn
     
     PE::IRenderer::checkForErrors("");
 
+	// detailed geometry can be stored in packed formats. techniques given by material preferred technique names
+	// and blend shapes only exist for unpacked formats
+	if ((res == PEVertexFormat_DetailedMesh || res == PEVertexFormat_DetailedSkin) && mcpu.m_usePackedVertexFormat &&
+		mcpu.m_hAdditionalVertexBuffersCPU.m_size == 0)
+	{
+		bool canPack = VertexBufferGPUManager::canUsePackedVertexFormat(mcpu.m_hTexCoordBufferCPU, mcpu.m_hSkinWeightsCPU);
+		for (PrimitiveTypes::UInt32 im = 0; canPack && im < matSetCpu.m_materials.m_size; im++)
+			canPack = matSetCpu.m_materials[im].m_preferredTechName[0] == '\0';
+
+		if (canPack)
+			res = (res == PEVertexFormat_DetailedMesh) ? PEVertexFormat_DetailedMeshPacked : PEVertexFormat_DetailedSkinPacked;
+	}
+
 	switch (res)
 	{
 	case PEVertexFormat_ColoredMinimalMesh:
@@ -413,6 +441,19 @@ EPEVertexFormat Mesh::updateGeoFromMeshCPU_needsRC(MeshCPU &mcpu, int &threadOwn
 				);
 		}
 		break;
+	case PEVertexFormat_DetailedMeshPacked:
+	case PEVertexFormat_DetailedSkinPacked:
+		{
+			m_hVertexBufferGPU = VertexBufferGPUManager::Instance()->createPackedGPUBufferFromVBufTCBufSWBufNBufTBuf(
+				mcpu.m_hPositionBufferCPU,
+				mcpu.m_hTexCoordBufferCPU,
+				res == PEVertexFormat_DetailedSkinPacked ? mcpu.m_hSkinWeightsCPU : Handle(),
+				mcpu.m_hNormalBufferCPU,
+				mcpu.m_hTangentBufferCPU,
+				!mcpu.m_manualBufferManagement
+				);
+		}
+		break;
 	}
 	
 
@@ -14,6 +14,9 @@
 #include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
 
 #include "PrimeEngine/Geometry/SkeletonCPU/SkeletonCPU.h"
+#include "PrimeEngine/Geometry/PositionBufferCPU/PositionBufferCPUManager.h"
+#include "PrimeEngine/Geometry/NormalBufferCPU/NormalBufferCPUManager.h"
+#include "PrimeEngine/Geometry/TexCoordBufferCPU/TexCoordBufferCPUManager.h"
 
 #include "PrimeEngine/Scene/RootSceneNode.h"
 #include "PrimeEngine/Scene/DebugRenderer.h"
@@ -132,5 +135,33 @@ void MeshManager::registerAsset(const PE::Handle &h)
 	m_assets.add(key, h);
 }
 
+bool MeshManager::reloadAsset(const char *asset, const char *package, int &threadOwnershipMask)
+{
+	char key[StrTPair<Handle>::StrSize];
+	sprintf(key, "%s/%s", package, asset);
+
+	int index = m_assets.findIndex(key);
+	if (index == -1 || !StringOps::endswith(asset, "mesha"))
+		return false; // not loaded yet, will be read on first use. skeletons are not reloaded
+
+	MeshCPU mcpu(*m_pContext, m_arena);
+	mcpu.ReadMesh(asset, package, "");
+	if (!mcpu.hasAABB())
+		mcpu.buildLocalAABBFromMeshBuffer();
+
+	// old gpu buffers are released here, draw lists in flight must not use them anymore
+	Mesh *pMesh = m_assets.m_pairs[index].m_value.getObject<Mesh>();
+	pMesh->loadFromMeshCPU_needsRC(mcpu, threadOwnershipMask);
+	return true;
+}
+
+PrimitiveTypes::UInt32 MeshManager::forgetFile(const char *filename)
+{
+	PrimitiveTypes::UInt32 n = PositionBufferCPUManager::Instance()->forgetFile(filename);
+	n += NormalBufferCPUManager::Instance()->m_map.removeStartingWith(filename);
+	n += TexCoordBufferCPUManager::Instance()->m_map.removeStartingWith(filename);
+	return n;
+}
+
 }; // namespace Components
 }; // namespace PE
@@ -37,6 +37,13 @@ struct MeshManager : Component
 	// for when asset is manually added from outside. it will get autogeenrated key
 	void registerAsset(const Handle &h);
 
+	// hot reload: reads mesh again into the same Mesh, so handles to it stay valid. false if mesh was not loaded.
+	// cached files it was built from have to be forgotten first (forgetFile()), or they are not read again
+	bool reloadAsset(const char *asset, const char *package, int &threadOwnershipMask);
+
+	// next mesh read reads the buffer, material set or skin weights file again
+	static PrimitiveTypes::UInt32 forgetFile(const char *filename);
+
 	PEMap<PE::Handle> m_assets;
 };
 
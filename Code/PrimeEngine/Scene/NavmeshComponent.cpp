@@ -13,6 +13,7 @@
 #include "PrimeEngine/Scene/DebugRenderer.h"
 #include "PrimeEngine/Scene/PhysicsManager.h"
 #include "PrimeEngine/Scene/PhysicsComponent.h"
+#include "PrimeEngine/Events/StandardEvents.h"
 
 // For debug output and string functions
 #include <stdio.h>
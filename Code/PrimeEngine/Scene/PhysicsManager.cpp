@@ -5,6 +5,7 @@
 #include "PrimeEngine/Events/StandardEvents.h"
 #include "SceneNode.h"
 #include "DebugRenderer.h"
+#include "PrimeEngine/Jobs/JobSystem.h"
 #include <cmath>
 
 namespace PE {
@@ -116,6 +117,83 @@ static bool testSphereAABB(const PhysicsComponent* sphere, const PhysicsComponen
 	return false;
 }
 
+// Push sphere out of the AABB and remove velocity going into the surface
+static void resolveCollision(CollisionInfo& collision)
+{
+    // Add a small separation buffer to prevent immediate re-collision
+    const float SEPARATION_BUFFER = 0.01f;  // 1cm safety margin
+    float totalSeparation = collision.penetrationDepth + SEPARATION_BUFFER;
+    
+    // Separate the objects (push sphere out of AABB)
+    collision.object1->position.m_x += collision.normal.m_x * totalSeparation;
+    collision.object1->position.m_y += collision.normal.m_y * totalSeparation;
+    collision.object1->position.m_z += collision.normal.m_z * totalSeparation;
+    
+    // Calculate velocity along collision normal
+    float velocityAlongNormal = 
+        collision.object1->velocity.m_x * collision.normal.m_x +
+        collision.object1->velocity.m_y * collision.normal.m_y +
+        collision.object1->velocity.m_z * collision.normal.m_z;
+    
+    // Remove velocity component going into the surface
+    if (velocityAlongNormal < 0.0f)
+    {
+        // Remove normal component
+        collision.object1->velocity.m_x -= velocityAlongNormal * collision.normal.m_x;
+        collision.object1->velocity.m_y -= velocityAlongNormal * collision.normal.m_y;
+        collision.object1->velocity.m_z -= velocityAlongNormal * collision.normal.m_z;
+        
+        // Apply friction to tangential velocity (sliding)
+        const float FRICTION = 0.95f;  // 5% velocity loss per collision
+        collision.object1->velocity.m_x *= FRICTION;
+        collision.object1->velocity.m_z *= FRICTION;  // Don't apply to Y (vertical)
+    }
+}
+
+// parallelFor body: collides dynamic spheres [begin, end) of m_physicsComponents against all static AABBs.
+// runs on job system workers, only writes to the dynamic spheres of its range
+void PhysicsManager::CollideRange(void *pParams, int begin, int end)
+{
+    PhysicsManager *pManager = static_cast<PhysicsManager *>(pParams);
+    const PrimitiveTypes::UInt32 numComponents = pManager->m_physicsComponents.m_size;
+    
+    // contacts of one sphere. if it touches more AABBs at once, the first batch is resolved before detecting the rest
+    const int MAX_CONTACTS = 16;
+    CollisionInfo contacts[MAX_CONTACTS];
+    
+    for (int i = begin; i < end; i++)
+    {
+        PhysicsComponent *pDynamic = pManager->m_physicsComponents[i].getObject<PhysicsComponent>();
+        if (!pDynamic || pDynamic->isStatic || pDynamic->shapeType != PhysicsComponent::SPHERE)
+            continue;  // Only test dynamic spheres
+        
+        int numContacts = 0;
+        
+        // Test against all static AABBs
+        for (PrimitiveTypes::UInt32 j = 0; j < numComponents; j++)
+        {
+            if ((PrimitiveTypes::UInt32)i == j) continue;  // Don't test against self
+            
+            PhysicsComponent *pStatic = pManager->m_physicsComponents[j].getObject<PhysicsComponent>();
+            if (!pStatic || !pStatic->isStatic || pStatic->shapeType != PhysicsComponent::AABB)
+                continue;  // Only test against static AABBs
+            
+            if (testSphereAABB(pDynamic, pStatic, contacts[numContacts]))
+            {
+                if (++numContacts == MAX_CONTACTS)
+                {
+                    for (int c = 0; c < numContacts; c++)
+                        resolveCollision(contacts[c]);
+                    numContacts = 0;
+                }
+            }
+        }
+        
+        for (int c = 0; c < numContacts; c++)
+            resolveCollision(contacts[c]);
+    }
+}
+
 void PhysicsManager::update(float deltaTime)
 {
     // Gravity constant (m/s^2) - negative Y is down
@@ -358,70 +436,10 @@ void PhysicsManager::update(float deltaTime)
         pPhysics->position.m_z += pPhysics->velocity.m_z * deltaTime;
     }
     
-    // PHASE 2: Detect collisions
-    Array<CollisionInfo> collisions(*m_pContext, m_arena, 64);
-
-    
-    for (PrimitiveTypes::UInt32 i = 0; i < m_physicsComponents.m_size; i++)
-    {
-        PhysicsComponent *pDynamic = m_physicsComponents[i].getObject<PhysicsComponent>();
-        if (!pDynamic || pDynamic->isStatic || pDynamic->shapeType != PhysicsComponent::SPHERE)
-            continue;  // Only test dynamic spheres
-        
-        // Test against all static AABBs
-        for (PrimitiveTypes::UInt32 j = 0; j < m_physicsComponents.m_size; j++)
-        {
-            if (i == j) continue;  // Don't test against self
-            
-            PhysicsComponent *pStatic = m_physicsComponents[j].getObject<PhysicsComponent>();
-            if (!pStatic || !pStatic->isStatic || pStatic->shapeType != PhysicsComponent::AABB)
-                continue;  // Only test against static AABBs
-            
-            // Test collision
-            CollisionInfo info;
-            
-            if (testSphereAABB(pDynamic, pStatic, info))
-            {
-                collisions.add(info);
-            }
-        }
-    }
-    
-    // PHASE 3: Resolve collisions (simple response for now)
-    
-    for (PrimitiveTypes::UInt32 i = 0; i < collisions.m_size; i++)
-    {
-        CollisionInfo& collision = collisions[i];
-        
-        // Add a small separation buffer to prevent immediate re-collision
-        const float SEPARATION_BUFFER = 0.01f;  // 1cm safety margin
-        float totalSeparation = collision.penetrationDepth + SEPARATION_BUFFER;
-        
-        // Separate the objects (push sphere out of AABB)
-        collision.object1->position.m_x += collision.normal.m_x * totalSeparation;
-        collision.object1->position.m_y += collision.normal.m_y * totalSeparation;
-        collision.object1->position.m_z += collision.normal.m_z * totalSeparation;
-        
-        // Calculate velocity along collision normal
-        float velocityAlongNormal = 
-            collision.object1->velocity.m_x * collision.normal.m_x +
-            collision.object1->velocity.m_y * collision.normal.m_y +
-            collision.object1->velocity.m_z * collision.normal.m_z;
-        
-        // Remove velocity component going into the surface
-        if (velocityAlongNormal < 0.0f)
-        {
-            // Remove normal component
-            collision.object1->velocity.m_x -= velocityAlongNormal * collision.normal.m_x;
-            collision.object1->velocity.m_y -= velocityAlongNormal * collision.normal.m_y;
-            collision.object1->velocity.m_z -= velocityAlongNormal * collision.normal.m_z;
-            
-            // Apply friction to tangential velocity (sliding)
-            const float FRICTION = 0.95f;  // 5% velocity loss per collision
-            collision.object1->velocity.m_x *= FRICTION;
-            collision.object1->velocity.m_z *= FRICTION;  // Don't apply to Y (vertical)
-        }
-    }
+    // PHASE 2 + 3: Detect and resolve collisions of dynamic spheres against static AABBs.
+    // A collision only moves its dynamic sphere and statics never move, so every sphere is independent
+    // and spheres are processed in parallel. Each sphere still detects all of its contacts before resolving them.
+    JobSystem::parallelFor(m_physicsComponents.m_size, 16, &PhysicsManager::CollideRange, this);
     
     // PHASE 4: Write positions back to SceneNodes (dynamic objects only)
     for (PrimitiveTypes::UInt32 i = 0; i < m_physicsComponents.m_size; i++)
@@ -49,8 +49,11 @@ struct PhysicsManager : public Component
     void addComponent(Handle hPhysicsComponent);
     void update(float deltaTime);
 
+    // collision phase of update() for a range of components, run as JobSystem::parallelFor
+    static void CollideRange(void *pParams, int begin, int end);
+
     // List of all physics components
-    Array<Handle> m_physicsComponents;
+    Array<Handle, 1> m_physicsComponents; // grows past initial capacity for larger levels
 };
 
 }; // namespace Components
@@ -4,6 +4,9 @@
 
 #include "Light.h"
 #include "DrawList.h"
+#include "LightClusters.h"
+#include "CameraManager.h"
+#include "CameraSceneNode.h"
 
 #include "PrimeEngine/APIAbstraction/Effect/EffectManager.h"
 #include "../Lua/LuaEnvironment.h"
@@ -88,6 +91,7 @@ void RootSceneNode::do_GATHER_DRAWCALLS(Events::Event *pEvt)
 
 		// the light that drops shadows is defined by a boolean isShadowCaster in maya light objects
 		PrimitiveTypes::UInt32 iDestLight = 0;
+		int shadowCaster = -1;
 		if (pRoot->m_lights.m_size)
 		{
 			for(PrimitiveTypes::UInt32 i=0; i<(pRoot->m_lights.m_size); i++){
@@ -99,19 +103,70 @@ void RootSceneNode::do_GATHER_DRAWCALLS(Events::Event *pEvt)
 					
 					psvPerObjectGroup->m_data.gLights[iDestLight] = pLight->m_cbuffer;
 					iDestLight++;
+					shadowCaster = i;
 
 					break;
 				}
 			}
 		}
-		for (PrimitiveTypes::UInt32 iLight = 0;iLight < pRoot->m_lights.m_size; iLight++)
+
+		// bin lights into view clusters. shaders have fixed light slots, so clusters decide which lights get them:
+		// directional lights, then local lights covering most clusters. lights that touch no cluster are off screen
+		LightClusters *pClusters = pDrawEvent ? LightClusters::Instance() : NULL;
+		Camera *pCam = CameraManager::Instance()->getActiveCamera();
+		CameraSceneNode *pCamSN = pCam ? pCam->getCamSceneNode() : NULL;
+		if (pClusters && pCamSN)
 		{
-			Light *pLight = pRoot->m_lights[iLight].getObject<Light>();
-			if(pLight->castsShadow())
-				continue;
-			psvPerObjectGroup->m_data.gLights[iDestLight] = pLight->m_cbuffer;
-			iDestLight++;
+			pClusters->setFrustum(pDrawEvent->m_projectionTransform.m[0][0], pDrawEvent->m_projectionTransform.m[1][1], pCamSN->m_near, pCamSN->m_far);
+			pClusters->clearLights();
+			for (PrimitiveTypes::UInt32 iLight = 0; iLight < pRoot->m_lights.m_size; iLight++)
+				pClusters->addLight(pRoot->m_lights[iLight].getObject<Light>()->m_cbuffer, pCamSN->m_worldToViewTransform);
+			pClusters->build();
+
+			for (PrimitiveTypes::UInt32 i = 0; i < pClusters->m_directionalLights.m_size && iDestLight < SetPerObjectGroupConstantsShaderAction::NUM_LIGHT_SOURCES_DATAS; i++)
+			{
+				PrimitiveTypes::UInt32 iLight = pClusters->m_directionalLights[i];
+				if ((int)(iLight) == shadowCaster)
+					continue;
+				psvPerObjectGroup->m_data.gLights[iDestLight++] = pRoot->m_lights[iLight].getObject<Light>()->m_cbuffer;
+			}
+
+			PrimitiveTypes::UInt16 candidates[PE_LIGHT_CLUSTERS_MAX_LIGHTS];
+			PrimitiveTypes::UInt32 numCandidates = 0;
+			for (PrimitiveTypes::UInt32 iLight = 0; iLight < pClusters->getNumLights(); iLight++)
+			{
+				if (pClusters->m_lightClusterCounts[iLight] && (int)(iLight) != shadowCaster)
+					candidates[numCandidates++] = (PrimitiveTypes::UInt16)(iLight);
+			}
+
+			// partial selection sort, only as many as there are slots left
+			for (PrimitiveTypes::UInt32 i = 0; i < numCandidates && iDestLight < SetPerObjectGroupConstantsShaderAction::NUM_LIGHT_SOURCES_DATAS; i++)
+			{
+				PrimitiveTypes::UInt32 best = i;
+				for (PrimitiveTypes::UInt32 j = i + 1; j < numCandidates; j++)
+				{
+					if (pClusters->m_lightClusterCounts[candidates[j]] > pClusters->m_lightClusterCounts[candidates[best]])
+						best = j;
+				}
+				PrimitiveTypes::UInt16 tmp = candidates[i]; candidates[i] = candidates[best]; candidates[best] = tmp;
+				psvPerObjectGroup->m_data.gLights[iDestLight++] = pRoot->m_lights[candidates[i]].getObject<Light>()->m_cbuffer;
+			}
 		}
+		else
+		{
+			for (PrimitiveTypes::UInt32 iLight = 0;iLight < pRoot->m_lights.m_size && iDestLight < SetPerObjectGroupConstantsShaderAction::NUM_LIGHT_SOURCES_DATAS; iLight++)
+			{
+				Light *pLight = pRoot->m_lights[iLight].getObject<Light>();
+				if(pLight->castsShadow())
+					continue;
+				psvPerObjectGroup->m_data.gLights[iDestLight] = pLight->m_cbuffer;
+				iDestLight++;
+			}
+		}
+
+		// unused slots: zero range point lights don't light anything
+		for (; iDestLight < SetPerObjectGroupConstantsShaderAction::NUM_LIGHT_SOURCES_DATAS; iDestLight++)
+			memset(&psvPerObjectGroup->m_data.gLights[iDestLight], 0, sizeof(SetPerObjectGroupConstantsShaderAction::hlsl_Light));
 	}
 }
 }; // namespace Components
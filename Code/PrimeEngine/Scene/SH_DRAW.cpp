@@ -10,6 +10,7 @@
 #include "PrimeEngine/APIAbstraction/GPUMaterial/GPUMaterialSet.h"
 #include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
 #include "PrimeEngine/APIAbstraction/Texture/Texture.h"
+#include "PrimeEngine/APIAbstraction/Texture/TextureResidencyManager.h"
 #include "PrimeEngine/APIAbstraction/Effect/EffectManager.h"
 #include "PrimeEngine/APIAbstraction/GPUBuffers/VertexBufferGPUManager.h"
 #include "PrimeEngine/Lua/LuaEnvironment.h"
@@ -175,6 +176,65 @@ void MeshHelpers::setZOnlyEffectOfTopEffectSecuence(Mesh *pObj, Handle hNewEffec
 	}
 }
 
+// reports how big the mesh is on screen to texture streaming, so that the right mips get resident
+static void requestTextureMips(Mesh *pMeshCaller, GPUMaterialSet *pGpuMatSet, const Matrix4x4 &defaultWorldMatrix, Events::Event_GATHER_DRAWCALLS *pDrawEvent, PrimitiveTypes::UInt32 screenHeight)
+{
+	TextureResidencyManager *pTRM = TextureResidencyManager::Instance();
+	if (!pTRM)
+		return;
+
+	// size of the closest visible instance in pixels. without a bounding box we don't know, so ask for full detail
+	PrimitiveTypes::Float32 screenPixels = -1.0f;
+	if (pMeshCaller->hasAABB())
+	{
+		bool anyVisible = false;
+		Vector3 extents = pMeshCaller->getLocalAABB().extents;
+		for (int iInst = 0; iInst < pMeshCaller->m_instances.m_size; ++iInst)
+		{
+			MeshInstance *pInst = pMeshCaller->m_instances[iInst].getObject<MeshInstance>();
+			if (pInst->m_culledOut)
+				continue;
+			anyVisible = true;
+
+			Matrix4x4 instanceWorldMatrix = defaultWorldMatrix;
+			Handle hInstanceParentSN = pInst->getFirstParentByType<SceneNode>();
+			if (hInstanceParentSN.isValid())
+				instanceWorldMatrix = hInstanceParentSN.getObject<SceneNode>()->m_worldTransform;
+
+			Vector3 scale(instanceWorldMatrix.getU().length(), instanceWorldMatrix.getV().length(), instanceWorldMatrix.getN().length());
+			PrimitiveTypes::Float32 radius = Vector3(extents.m_x * scale.m_x, extents.m_y * scale.m_y, extents.m_z * scale.m_z).length();
+			Vector3 center = instanceWorldMatrix * pMeshCaller->getLocalAABB().center;
+			PrimitiveTypes::Float32 dist = (center - pDrawEvent->m_eyePos).length() - radius;
+			if (dist < 0.01f)
+				dist = 0.01f; // camera is inside the bounding sphere
+
+			// projected diameter: m[1][1] of projection is cot(fovy/2)
+			PrimitiveTypes::Float32 pixels = radius / dist * pDrawEvent->m_projectionTransform.m[1][1] * (PrimitiveTypes::Float32)(screenHeight);
+			if (pixels > screenPixels)
+				screenPixels = pixels;
+		}
+
+		// all instances culled: nothing on screen needs its mips, so don't keep them recently used
+		if (!anyVisible)
+			return;
+	}
+
+	for (PrimitiveTypes::UInt32 iMat = 0; iMat < pGpuMatSet->m_materials.m_size; ++iMat)
+	{
+		GPUMaterial &mat = pGpuMatSet->m_materials[iMat];
+		for (PrimitiveTypes::UInt32 iTex = 0; iTex < mat.m_textures.m_size; ++iTex)
+		{
+			TextureGPU *pTex = mat.m_textures[iTex].getObject<TextureGPU>();
+			if (!pTex->m_streamed)
+				continue;
+			if (screenPixels < 0.0f)
+				pTRM->requestMip(pTex, 0);
+			else
+				pTRM->requestForScreenSize(pTex, screenPixels);
+		}
+	}
+}
+
 PE_IMPLEMENT_SINGLETON_CLASS1(SingleHandler_DRAW, Component);
 
 void SingleHandler_DRAW::do_GATHER_DRAWCALLS(Events::Event *pEvt)
@@ -310,6 +370,73 @@ void SingleHandler_DRAW::do_GATHER_DRAWCALLS(Events::Event *pEvt)
         }
     }
     
+    // SHADOW CASTER CULLING - test each mesh instance against the light's caster volume
+    if (pZOnlyDrawEvent && pZOnlyDrawEvent->m_cullShadowCasters && pMeshCaller->hasAABB())
+    {
+        pMeshCaller->m_numVisibleInstances = 0;
+
+        Vector3 localCorners[8];
+        pMeshCaller->getAABBCorners(localCorners);
+
+        for (int iInst = 0; iInst < pMeshCaller->m_instances.m_size; ++iInst)
+        {
+            MeshInstance *pInst = pMeshCaller->m_instances[iInst].getObject<MeshInstance>();
+
+            Handle hInstanceParentSN = pInst->getFirstParentByType<SceneNode>();
+            if (!hInstanceParentSN.isValid())
+            {
+                // allow skeleton to be in chain
+                SkeletonInstance *pParentSkelInstance = pInst->getFirstParentByTypePtr<SkeletonInstance>();
+                if (pParentSkelInstance)
+                    hInstanceParentSN = pParentSkelInstance->getFirstParentByType<SceneNode>();
+            }
+
+            if (!hInstanceParentSN.isValid())
+            {
+                // can't place it in the world, keep it as a caster
+                ++pMeshCaller->m_numVisibleInstances;
+                continue;
+            }
+
+            Matrix4x4 &instanceWorldMatrix = hInstanceParentSN.getObject<SceneNode>()->m_worldTransform;
+            Vector3 aabbMin = instanceWorldMatrix * localCorners[0];
+            Vector3 aabbMax = aabbMin;
+            for (int i = 1; i < 8; i++)
+            {
+                Vector3 c = instanceWorldMatrix * localCorners[i];
+                if (c.m_x < aabbMin.m_x) aabbMin.m_x = c.m_x;
+                if (c.m_y < aabbMin.m_y) aabbMin.m_y = c.m_y;
+                if (c.m_z < aabbMin.m_z) aabbMin.m_z = c.m_z;
+                if (c.m_x > aabbMax.m_x) aabbMax.m_x = c.m_x;
+                if (c.m_y > aabbMax.m_y) aabbMax.m_y = c.m_y;
+                if (c.m_z > aabbMax.m_z) aabbMax.m_z = c.m_z;
+            }
+
+            // casters only need to overlap the volume, so unlike camera culling above we reject only boxes fully outside of a plane
+            for (int plane = 0; plane < 6; plane++)
+            {
+                if (pZOnlyDrawEvent->m_frustumPlanes[plane].isAABBOutside(aabbMin, aabbMax))
+                {
+                    pInst->m_culledOut = true;
+                    break;
+                }
+            }
+
+            if (!pInst->m_culledOut)
+                ++pMeshCaller->m_numVisibleInstances;
+        }
+
+        int numCulled = pMeshCaller->m_instances.m_size - pMeshCaller->m_numVisibleInstances;
+        if (numCulled)
+        {
+            // z only pass has no instanced effects, each instance would have been one draw call per range
+            IndexBufferGPU *pibGPU = pMeshCaller->m_hIndexBufferGPU.isValid() ? pMeshCaller->m_hIndexBufferGPU.getObject<IndexBufferGPU>() : 0;
+            m_numShadowDrawCallsCulled += numCulled * MeshHelpers::getNumberOfRangeCalls(pibGPU);
+        }
+
+        if (pMeshCaller->m_numVisibleInstances == 0)
+            return;
+    }
 
 	DrawList *pDrawList = pDrawEvent ? DrawList::Instance() : DrawList::ZOnlyInstance();
 	
@@ -363,6 +490,9 @@ void SingleHandler_DRAW::do_GATHER_DRAWCALLS(Events::Event *pEvt)
 	
 	projectionViewWorldMatrix = projectionViewWorldMatrix * worldMatrix;
 
+	if (pDrawEvent)
+		requestTextureMips(pMeshCaller, pGpuMatSet, worldMatrix, pDrawEvent, m_pContext->getGPUScreen()->getHeight());
+
 #ifdef _DEBUG
 	// ========== TOGGLE: MESH AABB DEBUG RENDERING ==========
 	// Set to true to show green AABB boxes for frustum culling volumes
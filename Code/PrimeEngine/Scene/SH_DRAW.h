@@ -30,6 +30,7 @@ struct SingleHandler_DRAW : public Component
 	PE_DECLARE_SINGLETON_CLASS(SingleHandler_DRAW);
 
 	SingleHandler_DRAW(PE::GameContext &context, PE::MemoryArena arena, Handle hMyself) : Component(context, arena, hMyself)
+	, m_numShadowDrawCallsCulled(0)
 	{}
 
 	virtual ~SingleHandler_DRAW(){}
@@ -51,6 +52,10 @@ struct SingleHandler_DRAW : public Component
 		p->addDefaultComponents();
 	}
 
+	// number of draw calls not recorded into Z-only draw list this frame because the caster was outside of the shadow caster volume
+	// reset by game thread before Z-only gather
+	PrimitiveTypes::UInt32 m_numShadowDrawCallsCulled;
+
 private:
 	void gatherDrawCallsForRange(Mesh *pMeshCaller, DrawList *pDrawList, PE::Handle *pHVBs, int vbCount, Vector4 &vbWeights, int iRange,
 		Events::Event_GATHER_DRAWCALLS *pDrawEvent, Events::Event_GATHER_DRAWCALLS_Z_ONLY *pZOnlyDrawEvent
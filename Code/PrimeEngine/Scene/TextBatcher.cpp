@@ -0,0 +1,286 @@
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+#include <string.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/APIAbstraction/GPUBuffers/VertexBufferGPU.h"
+#include "PrimeEngine/APIAbstraction/GPUBuffers/IndexBufferGPU.h"
+#include "PrimeEngine/APIAbstraction/GPUBuffers/VertexBufferGPUManager.h"
+#include "PrimeEngine/APIAbstraction/GPUMaterial/GPUMaterialSet.h"
+#include "PrimeEngine/APIAbstraction/Texture/Texture.h"
+#include "PrimeEngine/APIAbstraction/Texture/TextureResidencyManager.h"
+#include "PrimeEngine/APIAbstraction/Effect/EffectManager.h"
+#include "PrimeEngine/Geometry/IndexBufferCPU/IndexBufferCPU.h"
+#include "PrimeEngine/Geometry/MaterialCPU/MaterialSetCPU.h"
+#include "PrimeEngine/Render/ShaderActions/SetPerObjectConstantsShaderAction.h"
+
+// Sibling/Children includes
+#include "TextBatcher.h"
+#include "DrawList.h"
+
+namespace PE {
+
+using namespace PrimitiveTypes;
+
+const Float32 TextBatcher::c_charsInFullLine = 50.0f; // 100 characters from -1 to 1
+
+TextBatcher *TextBatcher::s_pInstance = NULL;
+
+void TextBatcher::Construct(PE::GameContext &context, PE::MemoryArena arena)
+{
+	Handle h("TEXT_BATCHER", sizeof(TextBatcher));
+	s_pInstance = new(h) TextBatcher(context, arena);
+}
+
+void TextBatcher::ComputeGlyph(unsigned char c, Glyph &out)
+{
+	const Float32 cell = 1.0f / 16.0f;
+	const Float32 halfTexel = 1.0f / 512.0f / 2.0f;
+	Float32 u = cell * Float32(c % 16);
+	Float32 v = cell * Float32(c / 16);
+	out.m_u0 = u + halfTexel;
+	out.m_v0 = v + halfTexel;
+	out.m_u1 = u + cell - halfTexel;
+	out.m_v1 = v + cell - halfTexel;
+}
+
+TextBatcher::TextBatcher(PE::GameContext &context, PE::MemoryArena arena)
+: m_aspectRatio(1.0f)
+, m_curFrameBuffer(0)
+{
+	m_arena = arena; m_pContext = &context;
+
+	for (UInt32 c = 0; c < 256; ++c)
+		ComputeGlyph((unsigned char)(c), m_glyphs[c]);
+
+	m_maxGlyphs[Batch_Overlay] = PE_TEXT_MAX_OVERLAY_GLYPHS;
+	m_maxGlyphs[Batch_World] = PE_TEXT_MAX_WORLD_GLYPHS;
+
+	// allocated once at full size and zeroed, so normals of interleaved vertices stay 0
+	for (UInt32 b = 0; b < Batch_Count; ++b)
+	{
+		m_numGlyphs[b] = 0;
+		m_positions[b].init(context, arena);
+		m_positions[b].reset(m_maxGlyphs[b] * 4 * c_posStride);
+#if APIABSTRACTION_OGL
+		m_texCoords[b].init(context, arena);
+		m_texCoords[b].reset(m_maxGlyphs[b] * 4 * c_texCoordStride);
+#endif
+	}
+
+	if (IRenderer *pScreen = context.getGPUScreen())
+		m_aspectRatio = Float32(pScreen->getWidth()) / Float32(pScreen->getHeight());
+
+	memset(&m_curStats, 0, sizeof(m_curStats));
+	memset(&m_lastFrameStats, 0, sizeof(m_lastFrameStats));
+}
+
+void TextBatcher::createGPUResources_needsRC(int &threadOwnershipMask)
+{
+	// quads (0, 1, 2) (2, 3, 0) for the biggest batch. ranges are set to number of glyphs when gathered
+	UInt32 maxGlyphs = m_maxGlyphs[Batch_Overlay] > m_maxGlyphs[Batch_World] ? m_maxGlyphs[Batch_Overlay] : m_maxGlyphs[Batch_World];
+	PEASSERT(maxGlyphs * 4 <= 65536, "Text batch doesn't fit 16 bit indices");
+
+	IndexBufferCPU ib(*m_pContext, m_arena);
+	ib.m_values.reset(maxGlyphs * 6);
+	for (UInt32 ig = 0; ig < maxGlyphs; ++ig)
+	{
+		UInt16 v = UInt16(ig * 4);
+		ib.m_values.add(v, v + 1, v + 2);
+		ib.m_values.add(v + 2, v + 3, v);
+	}
+	ib.m_indexRanges.reset(Batch_Count * c_numFrameBuffers);
+	ib.m_vertsPerFacePerRange.reset(Batch_Count * c_numFrameBuffers);
+	for (UInt32 ir = 0; ir < Batch_Count * c_numFrameBuffers; ++ir)
+	{
+		IndexRange range(*m_pContext, m_arena);
+		range.m_start = 0;
+		range.m_end = 5;
+		range.m_minVertIndex = 0;
+		range.m_maxVertIndex = 3;
+		ib.m_indexRanges.add(range);
+		ib.m_vertsPerFacePerRange.add(3);
+	}
+	ib.m_minVertexIndex = 0;
+	ib.m_maxVertexIndex = maxGlyphs * 4 - 1;
+	ib.m_primitiveTopology = PEPrimitveTopology_TRIANGLES;
+	ib.m_verticesPerPolygon = 3;
+	strcpy(ib.m_dbgName, "TextBatcher");
+
+	m_hIndexBufferGPU = Handle("INDEX_BUFFER_GPU", sizeof(IndexBufferGPU));
+	IndexBufferGPU *pibGPU = new(m_hIndexBufferGPU) IndexBufferGPU(*m_pContext, m_arena);
+	pibGPU->createGPUBuffer(ib);
+
+	ib.m_values.reset(0);
+	ib.m_indexRanges.reset(0);
+	ib.m_vertsPerFacePerRange.reset(0);
+
+	for (UInt32 b = 0; b < Batch_Count; ++b)
+	{
+		for (UInt32 i = 0; i < c_numFrameBuffers; ++i)
+		{
+			Handle &h = m_hVertexBuffersGPU[b][i];
+			h = Handle("VERTEX_BUFFER_GPU", sizeof(VertexBufferGPU));
+			VertexBufferGPU *pvb = new(h) VertexBufferGPU(*m_pContext, m_arena);
+			pvb->createDynamicGPUBuffer_StdMesh(m_maxGlyphs[b] * 4);
+#if APIABSTRACTION_OGL && OGL_USE_VERTEX_BUFFER_ARRAYS
+			pvb->linkIndexBuffer(*m_hIndexBufferGPU.getObject<IndexBufferGPU>());
+#endif
+		}
+	}
+
+	Handle hMatSetCPU("MATERIAL_SET_CPU", sizeof(MaterialSetCPU));
+	MaterialSetCPU *pmscpu = new(hMatSetCPU) MaterialSetCPU(*m_pContext, m_arena);
+	pmscpu->createSetWithOneTexturedMaterial("font512.dds", "Default", SamplerState_NoMips_NoMinTexelLerp_NoMagTexelLerp_Clamp);
+	m_hMaterialSetGPU = VertexBufferGPUManager::Instance()->createMatSetGPUFromMatSetCPU(hMatSetCPU);
+
+	m_hEffects[Batch_Overlay] = EffectManager::Instance()->getEffectHandle("StdMesh_2D_Diffuse_A_RGBIntensity_Tech");
+	m_hEffects[Batch_World] = EffectManager::Instance()->getEffectHandle("StdMesh_Diffuse_Tech");
+}
+
+UInt32 TextBatcher::writeGlyphs(Batch batch, const char *str, Int32 length, const Vector3 &origin, const Vector3 &advance, const Vector3 &down)
+{
+	UInt32 len = length < 0 ? (UInt32)(strlen(str)) : (UInt32)(length);
+	UInt32 first = m_numGlyphs[batch];
+	UInt32 n = len;
+	if (first + n > m_maxGlyphs[batch])
+	{
+		n = m_maxGlyphs[batch] - first;
+		m_curStats.m_numDropped += len - n;
+	}
+
+	Float32 *pPos = getPositions(batch) + first * 4 * c_posStride;
+	Float32 *pTc = getTexCoords(batch) + first * 4 * c_texCoordStride;
+
+	// corners: top left, top right, bottom right, bottom left
+	Vector3 p0 = origin;
+	for (UInt32 i = 0; i < n; ++i)
+	{
+		const Glyph &g = m_glyphs[(unsigned char)(str[i])];
+		Vector3 p1 = p0 + advance;
+		Vector3 p2 = p1 + down;
+		Vector3 p3 = p0 + down;
+
+		pPos[0] = p0.m_x; pPos[1] = p0.m_y; pPos[2] = p0.m_z;
+		pPos[c_posStride] = p1.m_x; pPos[c_posStride + 1] = p1.m_y; pPos[c_posStride + 2] = p1.m_z;
+		pPos[c_posStride * 2] = p2.m_x; pPos[c_posStride * 2 + 1] = p2.m_y; pPos[c_posStride * 2 + 2] = p2.m_z;
+		pPos[c_posStride * 3] = p3.m_x; pPos[c_posStride * 3 + 1] = p3.m_y; pPos[c_posStride * 3 + 2] = p3.m_z;
+
+		pTc[0] = g.m_u0; pTc[1] = g.m_v0;
+		pTc[c_texCoordStride] = g.m_u1; pTc[c_texCoordStride + 1] = g.m_v0;
+		pTc[c_texCoordStride * 2] = g.m_u1; pTc[c_texCoordStride * 2 + 1] = g.m_v1;
+		pTc[c_texCoordStride * 3] = g.m_u0; pTc[c_texCoordStride * 3 + 1] = g.m_v1;
+
+		pPos += c_posStride * 4;
+		pTc += c_texCoordStride * 4;
+		p0 = p1;
+	}
+
+	m_numGlyphs[batch] += n;
+	m_curStats.m_numGlyphs += n;
+	return n;
+}
+
+UInt32 TextBatcher::addOverlayText(const char *str, Float32 x, Float32 y, Float32 scale, Int32 length)
+{
+	Float32 w = getOverlayGlyphWidth(scale);
+	// glyph cell is twice as high as wide
+	return writeGlyphs(Batch_Overlay, str, length, Vector3(x, y, 0), Vector3(w, 0, 0), Vector3(0, -2.0f * w * m_aspectRatio, 0));
+}
+
+UInt32 TextBatcher::addWorldText(const char *str, const Vector3 &pos, Float32 scale, Int32 length)
+{
+	return writeGlyphs(Batch_World, str, length, pos, Vector3(scale, 0, 0), Vector3(0, -2.0f * scale, 0));
+}
+
+void TextBatcher::upload_needsRC()
+{
+	if (!hasGPUResources())
+		return;
+
+	for (UInt32 b = 0; b < Batch_Count; ++b)
+	{
+		UInt32 numVertices = m_numGlyphs[b] * 4;
+		if (!numVertices)
+			continue;
+
+		VertexBufferGPU *pvb = m_hVertexBuffersGPU[b][m_curFrameBuffer].getObject<VertexBufferGPU>();
+#if APIABSTRACTION_OGL
+		pvb->updateDynamicStdMesh(m_positions[b].getFirstPtr(), m_texCoords[b].getFirstPtr(), numVertices);
+		m_curStats.m_numBytesUploaded += numVertices * (c_posStride + c_texCoordStride) * sizeof(Float32);
+#else
+		pvb->updateDynamicStdMesh(m_positions[b].getFirstPtr(), NULL, numVertices);
+		m_curStats.m_numBytesUploaded += numVertices * c_posStride * sizeof(Float32);
+#endif
+	}
+}
+
+void TextBatcher::gatherDrawCalls(Components::DrawList *pDrawList, const Matrix4x4 &projectionView)
+{
+	if (!hasGPUResources())
+		return;
+
+	IndexBufferGPU *pibGPU = m_hIndexBufferGPU.getObject<IndexBufferGPU>();
+	GPUMaterial &mat = m_hMaterialSetGPU.getObject<GPUMaterialSet>()->m_materials[0];
+
+	for (UInt32 b = 0; b < Batch_Count; ++b)
+	{
+		if (!m_numGlyphs[b])
+			continue;
+
+		// each ring buffer has its own range, so ranges of frames in flight are not changed
+		UInt32 iRange = b * c_numFrameBuffers + m_curFrameBuffer;
+		IndexRange &range = pibGPU->m_indexRanges[iRange];
+		range.m_end = m_numGlyphs[b] * 6 - 1;
+		range.m_maxVertIndex = m_numGlyphs[b] * 4 - 1;
+
+		pDrawList->beginDrawCallRecord(mat.m_dbgName);
+		pDrawList->setIndexBuffer(m_hIndexBufferGPU, iRange);
+		pDrawList->setVertexBuffer(m_hVertexBuffersGPU[b][m_curFrameBuffer]);
+		pDrawList->setInstanceCount(1, 0);
+		mat.createShaderActions(pDrawList);
+		pDrawList->setEffect(m_hEffects[b]);
+
+		Handle &hsvPerObject = pDrawList->nextShaderValue();
+		hsvPerObject = Handle("RAW_DATA", sizeof(SetPerObjectConstantsShaderAction));
+		SetPerObjectConstantsShaderAction *psvPerObject = new(hsvPerObject) SetPerObjectConstantsShaderAction();
+		memset(&psvPerObject->m_data, 0, sizeof(SetPerObjectConstantsShaderAction::Data));
+
+		// overlay vertices are already in screen space
+		Matrix4x4 identity;
+		identity.loadIdentity();
+		psvPerObject->m_data.gWVP = b == Batch_World ? projectionView : identity;
+		psvPerObject->m_data.gWVPInverse = psvPerObject->m_data.gWVP.inverse();
+		psvPerObject->m_data.gW = identity;
+		psvPerObject->m_data.gVertexBufferWeights = Vector4(1.0f, 0, 0, 0);
+
+		++m_curStats.m_numDrawCalls;
+	}
+
+	// font is always drawn at full size
+	if (TextureResidencyManager *pTRM = TextureResidencyManager::Instance())
+	{
+		for (UInt32 iTex = 0; iTex < mat.m_textures.m_size; ++iTex)
+		{
+			TextureGPU *pTex = mat.m_textures[iTex].getObject<TextureGPU>();
+			if (pTex->m_streamed)
+				pTRM->requestMip(pTex, 0);
+		}
+	}
+}
+
+void TextBatcher::nextFrame()
+{
+	for (UInt32 b = 0; b < Batch_Count; ++b)
+		m_numGlyphs[b] = 0;
+
+	m_curFrameBuffer = (m_curFrameBuffer + 1) % c_numFrameBuffers;
+
+	m_lastFrameStats = m_curStats;
+	memset(&m_curStats, 0, sizeof(m_curStats));
+}
+
+}; // namespace PE
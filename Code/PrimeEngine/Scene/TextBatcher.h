@@ -0,0 +1,139 @@
+#ifndef __PYENGINE_2_0_TEXT_BATCHER_H__
+#define __PYENGINE_2_0_TEXT_BATCHER_H__
+
+#define NOMINMAX
+// API Abstraction
+#include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
+
+// Outer-Engine includes
+
+// Inter-Engine includes
+#include "PrimeEngine/MemoryManagement/Handle.h"
+#include "PrimeEngine/PrimitiveTypes/PrimitiveTypes.h"
+#include "PrimeEngine/Math/Vector3.h"
+#include "PrimeEngine/Math/Matrix4x4.h"
+#include "PrimeEngine/Utils/Array/Array.h"
+#include "PrimeEngine/../../GlobalConfig/GlobalConfig.h"
+
+// Sibling/Children includes
+
+namespace PE {
+namespace Components {
+struct DrawList;
+};
+
+// Glyph batched text. Strings are written straight into per frame vertex arrays from a precomputed glyph table
+// (font512.dds, 16x16 glyphs), one array per batch: screen space text and in world text.
+// Every frame the arrays are uploaded into the next vertex buffer of a ring of PE_NUM_FRAMES_IN_FLIGHT + 1 dynamic
+// vertex buffers per batch (buffers in draw lists in flight are never written) and drawn with one draw call per batch.
+// All buffers share one static quad index buffer. Nothing is allocated per string or per frame except draw list values
+struct TextBatcher : PE::PEAllocatableAndDefragmentable
+{
+	enum Batch
+	{
+		Batch_Overlay, // screen space, x and y in [-1, 1]
+		Batch_World,
+		Batch_Count
+	};
+
+	static const PrimitiveTypes::UInt32 c_numFrameBuffers = PE_NUM_FRAMES_IN_FLIGHT + 1;
+
+	// ogl has separate position and tex coord buffers, other apis one interleaved StdMesh buffer (position, tex coord, normal)
+#if APIABSTRACTION_OGL
+	static const PrimitiveTypes::UInt32 c_posStride = 3;
+	static const PrimitiveTypes::UInt32 c_texCoordStride = 2;
+	static const PrimitiveTypes::UInt32 c_texCoordOffset = 0;
+#else
+	static const PrimitiveTypes::UInt32 c_posStride = 3 + 2 + 3;
+	static const PrimitiveTypes::UInt32 c_texCoordStride = 3 + 2 + 3;
+	static const PrimitiveTypes::UInt32 c_texCoordOffset = 3;
+#endif
+
+	// screen space glyph is 1/c_charsInFullLine of half of screen wide at scale 1
+	static const PrimitiveTypes::Float32 c_charsInFullLine;
+
+	struct Glyph
+	{
+		PrimitiveTypes::Float32 m_u0, m_v0, m_u1, m_v1;
+	};
+
+	struct Stats
+	{
+		PrimitiveTypes::UInt32 m_numGlyphs;
+		PrimitiveTypes::UInt32 m_numDropped; // over PE_TEXT_MAX_*_GLYPHS
+		PrimitiveTypes::UInt32 m_numDrawCalls;
+		PrimitiveTypes::UInt32 m_numBytesUploaded;
+	};
+
+	TextBatcher(PE::GameContext &context, PE::MemoryArena arena);
+
+	static void Construct(PE::GameContext &context, PE::MemoryArena arena);
+	static TextBatcher *Instance() { return s_pInstance; }
+
+	// tex coords of glyph c in font512.dds, half a texel inside the cell
+	static void ComputeGlyph(unsigned char c, Glyph &out);
+
+	// vertex buffers, index buffer, font material and effects. called on first use by DebugRenderer
+	void createGPUResources_needsRC(int &threadOwnershipMask);
+	bool hasGPUResources() { return m_hIndexBufferGPU.isValid(); }
+
+	// screen space text. x, y is top left corner of first glyph in [-1, 1]. returns number of glyphs written.
+	// length -1 means str is null terminated
+	PrimitiveTypes::UInt32 addOverlayText(const char *str, PrimitiveTypes::Float32 x, PrimitiveTypes::Float32 y, PrimitiveTypes::Float32 scale, PrimitiveTypes::Int32 length = -1);
+
+	// text in xy plane at pos, glyphs are scale wide and 2 * scale high
+	PrimitiveTypes::UInt32 addWorldText(const char *str, const Vector3 &pos, PrimitiveTypes::Float32 scale, PrimitiveTypes::Int32 length = -1);
+
+	PrimitiveTypes::Float32 getOverlayGlyphWidth(PrimitiveTypes::Float32 scale) { return scale / c_charsInFullLine; }
+
+	// copies glyphs of this frame into current vertex buffers of the ring
+	void upload_needsRC();
+
+	// one draw call per non empty batch. projectionView is used for in world text
+	void gatherDrawCalls(Components::DrawList *pDrawList, const Matrix4x4 &projectionView);
+
+	// clears glyphs and moves to next buffers of the ring. stats of the finished frame go to m_lastFrameStats
+	void nextFrame();
+
+	PrimitiveTypes::UInt32 getNumGlyphs(Batch batch) { return m_numGlyphs[batch]; }
+	PrimitiveTypes::Float32 *getPositions(Batch batch) { return m_positions[batch].getFirstPtr(); }
+	PrimitiveTypes::Float32 *getTexCoords(Batch batch) // with c_texCoordOffset added
+	{
+#if APIABSTRACTION_OGL
+		return m_texCoords[batch].getFirstPtr();
+#else
+		return m_positions[batch].getFirstPtr() + c_texCoordOffset;
+#endif
+	}
+
+	Glyph m_glyphs[256];
+
+	PrimitiveTypes::UInt32 m_maxGlyphs[Batch_Count];
+	PrimitiveTypes::UInt32 m_numGlyphs[Batch_Count];
+	Array<PrimitiveTypes::Float32> m_positions[Batch_Count]; // 4 vertices per glyph, c_posStride floats each
+#if APIABSTRACTION_OGL
+	Array<PrimitiveTypes::Float32> m_texCoords[Batch_Count];
+#endif
+	PrimitiveTypes::Float32 m_aspectRatio; // of screen, width / height
+
+	// gpu resources
+	Handle m_hVertexBuffersGPU[Batch_Count][c_numFrameBuffers];
+	Handle m_hIndexBufferGPU; // range batch * c_numFrameBuffers + frame buffer is updated when gathered
+	Handle m_hMaterialSetGPU;
+	Handle m_hEffects[Batch_Count];
+	PrimitiveTypes::UInt32 m_curFrameBuffer;
+
+	Stats m_curStats;
+	Stats m_lastFrameStats;
+
+	PE::MemoryArena m_arena; PE::GameContext *m_pContext;
+
+	static TextBatcher *s_pInstance;
+
+private:
+	PrimitiveTypes::UInt32 writeGlyphs(Batch batch, const char *str, PrimitiveTypes::Int32 length, const Vector3 &origin, const Vector3 &advance, const Vector3 &down);
+};
+
+}; // namespace PE
+
+#endif
@@ -16,6 +16,7 @@
 
 // Sibling/Children includes
 #include "TextMesh.h"
+#include "TextBatcher.h"
 #include "SceneNode.h"
 #include "CameraManager.h"
 #include "../Lua/LuaEnvironment.h"
@@ -55,10 +56,15 @@ void TextMesh::loadFromString_needsRC(const char *str, const char *techName, int
 	TexCoordBufferCPU *pTCB = mcpu.m_hTexCoordBufferCPU.getObject<TexCoordBufferCPU>();
 	NormalBufferCPU *pNB = mcpu.m_hNormalBufferCPU.getObject<NormalBufferCPU>();
 	IndexBufferCPU *pIB = mcpu.m_hIndexBufferCPU.getObject<IndexBufferCPU>();
+	// arrays are zeroed when reset, so normals are already 0. values are written through pointers
 	pVB->m_values.reset(len * 4 * 3); // 4 verts * (x,y,z)
 	pTCB->m_values.reset(len * 4 * 2);
 	pNB->m_values.reset(len * 4 * 3);
 	pIB->m_values.reset(len * 6); // 2 tris
+	pVB->m_values.m_size = len * 4 * 3;
+	pTCB->m_values.m_size = len * 4 * 2;
+	pNB->m_values.m_size = len * 4 * 3;
+	pIB->m_values.m_size = len * 6;
 
 	pIB->m_indexRanges[0].m_start = 0;
 	pIB->m_indexRanges[0].m_end = len * 6 - 1;
@@ -79,33 +85,31 @@ void TextMesh::loadFromString_needsRC(const char *str, const char *techName, int
 	m_textLength = (float)(len);
 	float curX = 0;
 	float curY = 0;
-	float pixSize2 = 1.0f / 512.0f / 2.0f;
+	float *pPos = pVB->m_values.getFirstPtr();
+	float *pTc = pTCB->m_values.getFirstPtr();
+	PrimitiveTypes::UInt16 *pInd = pIB->m_values.getFirstPtr();
 	for (int ic = 0; ic < len; ic++)
 	{
-		char c = str[ic];
-		int row = int(c) / 16;
-		int column = int(c) % 16;
-		float tcx = 1.0f / 16.0f * float(column);
-		float tcy = 1.0f / 16.0f * float(row);
-		pVB->m_values.add(curX, curY, 0); // top lef
-		pVB->m_values.add(curX + w, curY, 0); // top right
-		pVB->m_values.add(curX + w, curY-h, 0);
-		pVB->m_values.add(curX, curY-h, 0);
-
-		pIB->m_values.add(ic * 4 + 0, ic * 4 + 1, ic * 4 + 2);
-		pIB->m_values.add(ic * 4 + 2, ic * 4 + 3, ic * 4 + 0);
-
-		float dx = pixSize2;
-		float dy = pixSize2;
-		pTCB->m_values.add(tcx + dx , tcy + dy); // top left
-		pTCB->m_values.add(tcx + 1.0f/16.0f - dx, tcy + dy); // top right
-		pTCB->m_values.add(tcx + 1.0f/16.0f - dx, tcy + 1.0f/16.0f - dy);
-		pTCB->m_values.add(tcx + dx, tcy + 1.0f/16.0f - dy);
-		
-		pNB->m_values.add(0, 0, 0);
-		pNB->m_values.add(0, 0, 0);
-		pNB->m_values.add(0, 0, 0);
-		pNB->m_values.add(0, 0, 0);
+		TextBatcher::Glyph g;
+		TextBatcher::ComputeGlyph((unsigned char)(str[ic]), g);
+
+		pPos[0] = curX; pPos[1] = curY; pPos[2] = 0; // top left
+		pPos[3] = curX + w; pPos[4] = curY; pPos[5] = 0; // top right
+		pPos[6] = curX + w; pPos[7] = curY - h; pPos[8] = 0;
+		pPos[9] = curX; pPos[10] = curY - h; pPos[11] = 0;
+		pPos += 12;
+
+		PrimitiveTypes::UInt16 v = PrimitiveTypes::UInt16(ic * 4);
+		pInd[0] = v; pInd[1] = v + 1; pInd[2] = v + 2;
+		pInd[3] = v + 2; pInd[4] = v + 3; pInd[5] = v;
+		pInd += 6;
+
+		pTc[0] = g.m_u0; pTc[1] = g.m_v0; // top left
+		pTc[2] = g.m_u1; pTc[3] = g.m_v0; // top right
+		pTc[4] = g.m_u1; pTc[5] = g.m_v1;
+		pTc[6] = g.m_u0; pTc[7] = g.m_v1;
+		pTc += 8;
+
 		curX += w;
 	}
 
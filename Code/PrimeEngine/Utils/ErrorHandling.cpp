@@ -20,20 +20,21 @@ bool PEASSERT(bool expr, const char *format, ...)
 
 	if (!(expr))
 	{
+		PE::AsyncLog::Flush(); // messages that lead here go out first
 		char buf[256];
 		//char newFrmt[256];
 		//sprintf(newFrmt, "%s%s", format, "\nAbort Execution?");
 		va_list ap;
 		// You will get an unused variable message here -- ignore it.
 		va_start(ap, format);
-#if APIABSTRACTION_PS3 || APIABSTRACTION_IOS || PE_PLAT_IS_PSVITA
+#if APIABSTRACTION_PS3 || APIABSTRACTION_IOS || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
 		vsprintf(buf, format, ap);
 #else
 		vsprintf_s<256>(buf, format, ap);
 #endif
 		va_end(ap);
 		assert(false);
-#if !APIABSTRACTION_IOS && !APIABSTRACTION_PS3 && !PE_PLAT_IS_PSVITA
+#if !APIABSTRACTION_IOS && !APIABSTRACTION_PS3 && !PE_PLAT_IS_PSVITA && !PE_PLAT_IS_LINUX
 		switch (MessageBoxA(0, buf, "PyEngine Error", MB_ABORTRETRYIGNORE))
 		{
 		case IDABORT:
@@ -56,17 +57,18 @@ bool PEASSERT(bool expr, const char *format, ...)
 void
 PEERROR(	const char *format, ...)
 {
+	PE::AsyncLog::Flush();
 	char buf[256];
 	va_list ap;
 	// You will get an unused variable message here -- ignore it.
 	va_start(ap, format);
-#if APIABSTRACTION_PS3 || APIABSTRACTION_IOS || PE_PLAT_IS_PSVITA
+#if APIABSTRACTION_PS3 || APIABSTRACTION_IOS || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
 	vsprintf(buf, format, ap);
 #else
 	vsprintf_s<256>(buf, format, ap);
 #endif
 	va_end(ap);
-#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA
+#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA && !PE_PLAT_IS_LINUX
 	switch (MessageBoxA(0, buf, "PyEngine Error", MB_ABORTRETRYIGNORE))
 	{
 	case IDABORT:
@@ -83,7 +85,7 @@ _PEPRINT(	const char *format, ...)
 	va_list ap;
 	// You will get an unused variable message here -- ignore it.
 	va_start(ap, format);
-#if APIABSTRACTION_PS3 || APIABSTRACTION_IOS || PE_PLAT_IS_PSVITA
+#if APIABSTRACTION_PS3 || APIABSTRACTION_IOS || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
 	vsprintf(buf, format, ap);
 	printf(buf);
 #else
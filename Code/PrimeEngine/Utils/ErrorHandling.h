@@ -6,6 +6,10 @@
 
 // Outer-Engine includes
 #include <assert.h>
+
+// Inter-Engine includes
+#include "PrimeEngine/Logging/AsyncLog.h"
+
 #ifdef _DEBUG
 	#define PEDebugAssert(...) PEASSERT(__VA_ARGS__)
 #else
@@ -22,9 +26,10 @@ PEERROR(	const char *format, ...);
 
 void _PEPRINT(const char *format, ...);
 
-#define PEINFO(format, ...) _PEPRINT("PE: Info: " format "\n", ##__VA_ARGS__)
+// recorded by AsyncLog, formatted and printed by log thread
+#define PEINFO(format, ...) PELOG(PE::LogSeverity_Info, PE::LogCategory_General, format, ##__VA_ARGS__)
 #define PEINFOSTR(str) PEINFO("%s", str)
-#define PEWARN(format, ...) _PEPRINT("PE: Warning: " format "\n", ##__VA_ARGS__)
+#define PEWARN(format, ...) PELOG(PE::LogSeverity_Warning, PE::LogCategory_General, format, ##__VA_ARGS__)
 #endif
 
 
@@ -45,6 +45,15 @@ struct Networkable
 	// usually used in game classes
 	virtual int packStateData(char *pDataStream){assert(!"This function is not overridden by this class and should not be called! Make sure to implement override of this function in current class"); return 0;}
 
+	// ghosting: state that is continuously replicated by GhostManager. state is diffed in 4 byte words
+	// against what the client acknowledged, so keep fields that change together next to each other
+	// size has to be <= PE_GHOST_MAX_STATE_WORDS * 4
+	virtual int packGhostState(char *pDataStream){assert(!"This function is not overridden by this class and should not be called! Make sure to implement override of this function in current class"); return 0;}
+	virtual int unpackGhostState(char *pDataStream){assert(!"This function is not overridden by this class and should not be called! Make sure to implement override of this function in current class"); return 0;}
+
+	// relevance of this object to a client. ghosts with higher priority get packet space first
+	virtual PrimitiveTypes::Float32 getGhostPriority(int clientId){return 1.0f;}
+
 	// methods to allow to know what class this networkable is networking over
 	virtual PE::MetaInfo *net_getClassMetaInfo() = 0;
 
@@ -81,6 +81,16 @@ struct PEMap : PE::PEAllocatable
 		return *((T*)(0));
 	}
 
+	// removes pair with the key. returns false if there was none
+	bool remove(const char *pKey)
+	{
+		PrimitiveTypes::Int32 i = findIndex(pKey);
+		if (i == -1)
+			return false;
+		m_pairs.remove(i);
+		return true;
+	}
+
 	~PEMap()
 	{
 	}
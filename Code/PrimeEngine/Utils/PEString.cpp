@@ -8,7 +8,7 @@ const char* PEString::generateScriptPathname(PE::GameContext &context, const cha
 {
 	if (module != NULL && StringOps::length(module) > 0)
 	{
-#if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA
+#if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
 		StringOps::concat(context.getMainFunctionArgs()->gameProjRoot(), "Code/", out_path, len);
 		StringOps::concat(out_path, module, out_path, len);
 		StringOps::concat(out_path, "/", out_path, len);
@@ -26,7 +26,7 @@ const char* PEString::generateScriptPathname(PE::GameContext &context, const cha
 	else
 	{
 		// if package is not provided default to Default package
-#if APIABSTRACTION_IOS
+#if APIABSTRACTION_IOS || PE_PLAT_IS_LINUX
 		StringOps::concat(context.getMainFunctionArgs()->gameProjRoot(), "Code/PrimeEngine/", out_path, len);
 		StringOps::concat(out_path, folder, out_path, len);
 		StringOps::concat(out_path, "/", out_path, len);
@@ -45,7 +45,7 @@ void PEString::generatePathname(PE::GameContext &context, const char *filename,
 {
 	if (package != NULL && StringOps::length(package) > 0)
 	{
-#if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA
+#if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
         StringOps::concat(context.getMainFunctionArgs()->gameProjRoot(), "AssetsOut/", out_path, len);
         StringOps::concat(out_path, package, out_path, len);
         StringOps::concat(out_path, "/", out_path, len);
@@ -63,7 +63,7 @@ void PEString::generatePathname(PE::GameContext &context, const char *filename,
 	else
 	{
 		// if package is not provided default to Default package
-#if APIABSTRACTION_IOS
+#if APIABSTRACTION_IOS || PE_PLAT_IS_LINUX
 		StringOps::concat(context.getMainFunctionArgs()->gameProjRoot(), "AssetsOut/Default/", out_path, len);
         StringOps::concat(out_path, assetType, out_path, len);
         StringOps::concat(out_path, "/", out_path, len);
@@ -99,7 +99,7 @@ void PEString::append(PrimitiveTypes::Int32 val)
 	char str[256];
 	PrimitiveTypes::UInt32 l = StringOps::length(m_data.m_dataHandle.getObject<char>());
 	StringOps::writeToString(m_data.m_dataHandle.getObject<char>(), str, l+1);
-#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA
+#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA && !PE_PLAT_IS_LINUX
 	sprintf_s(str, 256, "%s%d", str, val);
 #else
 	sprintf(str, "%s%d", str, val);
@@ -112,7 +112,7 @@ void PEString::append(PrimitiveTypes::Float32 val)
 	char str[256];
 	PrimitiveTypes::UInt32 l = StringOps::length(m_data.m_dataHandle.getObject<char>());
 	StringOps::writeToString(m_data.m_dataHandle.getObject<char>(), str, l+1);
-#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA
+#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA && !PE_PLAT_IS_LINUX
 	sprintf_s(str, 256,"%s%f", str, val);
 #else
 	sprintf(str, "%s%f", str, val);
@@ -127,7 +127,7 @@ void PEString::append(const char *val)
 	PrimitiveTypes::UInt32 l = StringOps::length(m_data.m_dataHandle.getObject<char>());
 	StringOps::writeToString(m_data.m_dataHandle.getObject<char>(), str, l+1);
 
-#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA
+#if !APIABSTRACTION_PS3 && !APIABSTRACTION_IOS && !PE_PLAT_IS_PSVITA && !PE_PLAT_IS_LINUX
 	sprintf_s(str, 256, "%s%s", str, val);
 #else
 	sprintf(str, "%s%s", str, val);
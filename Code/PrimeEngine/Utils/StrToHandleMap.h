@@ -78,6 +78,21 @@ struct StrToHandleMap : PE::PEAllocatable
 		return res;
 	}
 
+	// removes pairs whose key starts with prefix (maps of loaded files are keyed filename + tag). returns number removed
+	PrimitiveTypes::UInt32 removeStartingWith(const char *prefix)
+	{
+		PrimitiveTypes::UInt32 n = 0;
+		for (PrimitiveTypes::UInt32 i = m_pairs.m_size; i > 0; i--)
+		{
+			if (StringOps::startsswith(m_pairs[i - 1].m_str, prefix))
+			{
+				m_pairs.remove(i - 1);
+				++n;
+			}
+		}
+		return n;
+	}
+
 	~StrToHandleMap()
 	{
 	}
@@ -6,7 +6,7 @@
 #include "PrimeEngine/APIAbstraction/APIAbstractionDefines.h"
 
 // Outer-Engine includes
-#if APIABSTRACTION_D3D9 | APIABSTRACTION_D3D11 | APIABSTRACTION_OGL | PE_PLAT_IS_PSVITA | PE_PLAT_IS_PS4
+#if APIABSTRACTION_D3D9 | APIABSTRACTION_D3D11 | APIABSTRACTION_OGL | PE_PLAT_IS_PSVITA | PE_PLAT_IS_PS4 | PE_PLAT_IS_LINUX
 #include <string.h>
 #include <stdio.h>
 #endif
@@ -27,7 +27,7 @@ inline unsigned int writeToString(const char *a, char *dest, PrimitiveTypes::UIn
 {
 	if (a)
 	{
-#if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA
+#if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
 		sprintf(dest, "%s", a);
 #else
 		sprintf_s(dest, maxSize, "%s", a);
@@ -43,7 +43,7 @@ inline unsigned int writeToString(const char *a, char *dest, PrimitiveTypes::UIn
 
 inline void concat(const char *a, const char *b, char *dest, PrimitiveTypes::UInt32 size)
 {
-#		if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA
+#		if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
 			sprintf(dest, "%s%s", a, b);
 #		else
 			sprintf_s(dest, size, "%s%s", a, b);
@@ -74,7 +74,7 @@ inline void wideStringToString(const wchar_t *a, char *dest, PrimitiveTypes::UIn
 
 inline char* intToStr(PrimitiveTypes::Int32 value, char* buffer, PrimitiveTypes::UInt32 size) {
 	
-#		if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA
+#		if APIABSTRACTION_IOS || APIABSTRACTION_PS3 || PE_PLAT_IS_PSVITA || PE_PLAT_IS_LINUX
 			sprintf(buffer, "%d", value);
 #		else
 			sprintf_s(buffer, size, "%d", value);
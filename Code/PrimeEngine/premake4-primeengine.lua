@@ -13,7 +13,7 @@ project("PrimeEngine-".._OPTIONS["platformapi"])
     
 	
 	
-	if _OPTIONS["platformapi"] ~= "ios" then
+	if _OPTIONS["platformapi"] ~= "ios" and _OPTIONS["platformapi"] ~= "linux-headless" then
 		-- MSFT based platfroms: PC DX9, PC DX11, PC GL
 		
 		--excludes { "src/usocket.c", "src/unix.c"}
@@ -68,6 +68,12 @@ project("PrimeEngine-".._OPTIONS["platformapi"])
         excludes { "Application/IOS*.*", "Render/IOS*.*", "Game/Client/IOS*.*", "Events/StandardIOS*.*" }
 	end
 	
+	if _OPTIONS["platformapi"] == "linux-headless" then
+		-- Linux, no graphics api: renderer and application are no-ops
+	else
+		excludes { "Application/Headless*.*", "Render/Headless*.*" }
+	end
+	
 	
 	
 	
@@ -4,7 +4,7 @@ project("luasocket_dist-".._OPTIONS["platformapi"])
 	language "C"
 	files { "**.h", "**.c" }
 	
-	if _OPTIONS["platformapi"] ~= "ios" then
+	if _OPTIONS["platformapi"] ~= "ios" and _OPTIONS["platformapi"] ~= "linux-headless" then
 		excludes { "src/usocket.c", "src/unix.c" }
 	else
 		excludes { "src/wsocket.c", "src/unix.c" }
@@ -49,7 +49,7 @@ int opt_reuseaddr(lua_State *L, p_socket ps)
 /* enables reuse of local address */
 int opt_exclusiveaddr(lua_State *L, p_socket ps)
 {
-#if PE_PLAT_IS_IOS || PE_PLAT_IS_PS3 || PE_PLAT_IS_PSVITA || PE_PLAT_IS_PS4
+#if PE_PLAT_IS_IOS || PE_PLAT_IS_PS3 || PE_PLAT_IS_PSVITA || PE_PLAT_IS_PS4 || PE_PLAT_IS_LINUX
 	printf("SO_EXCLUSIVEADDRUSE is not available");
     lua_pushnumber(L, 1);
     return 1;
@@ -148,7 +148,7 @@ double timeout_gettime(void) {
 }
 #else
 double timeout_gettime(void) {
-#if APIABSTRACTION_IOS
+#if APIABSTRACTION_IOS || PE_PLAT_IS_LINUX
     struct timeval v;
     gettimeofday(&v, (struct timezone *) NULL);
     
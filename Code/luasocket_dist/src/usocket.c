@@ -12,7 +12,7 @@
 \*=========================================================================*/
 #include <string.h> 
 
-#if APIABSTRACTION_IOS
+#if APIABSTRACTION_IOS || PE_PLAT_IS_LINUX
 #include <signal.h>
 #endif
 
@@ -412,7 +412,7 @@ int socket_recvfrom(p_socket ps, char *data, size_t count, size_t *got,
 * Put socket into blocking mode
 \*-------------------------------------------------------------------------*/
 void socket_setblocking(p_socket ps) {
-#if APIABSTRACTION_IOS
+#if APIABSTRACTION_IOS || PE_PLAT_IS_LINUX
     int flags = fcntl(*ps, F_GETFL, 0);
     flags &= (~(O_NONBLOCK));
     fcntl(*ps, F_SETFL, flags);
@@ -427,7 +427,7 @@ void socket_setblocking(p_socket ps) {
 * Put socket into non-blocking mode
 \*-------------------------------------------------------------------------*/
 void socket_setnonblocking(p_socket ps) {
-#if APIABSTRACTION_IOS
+#if APIABSTRACTION_IOS || PE_PLAT_IS_LINUX
     int flags = fcntl(*ps, F_GETFL, 0);
     flags |= O_NONBLOCK;
     fcntl(*ps, F_SETFL, flags);
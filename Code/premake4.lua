@@ -7,6 +7,7 @@ newoption {
 		{ "win32d3d11",   "Win 32 D3D 11" },
 		{ "win32gl",      "Win32 OpenGL" },
 		{ "ios",          "iOS" },
+		{ "linux-headless", "Linux, no graphics (dedicated server)" },
 	}
 }
 _OPTIONS["platformapi"] = tostring(_OPTIONS["platformapi"])
@@ -21,6 +22,7 @@ solution("PEWorkspace-".._OPTIONS["platformapi"])
 	if _OPTIONS["platformapi"] == "win32d3d9"   then _platforms = { "x32" };       defines { "APIABSTRACTION_D3D9=1", "PE_PLAT_API=0x0101", "PE_PLAT_IS_WIN32=1", "PE_API_IS_D3D9=1" } end
 	if _OPTIONS["platformapi"] == "win32d3d11"  then _platforms = { "x32" };       defines { "APIABSTRACTION_D3D11=1", "PE_PLAT_API=0x0102", "PE_PLAT_IS_WIN32=1", "PE_API_IS_D3D11=1" } end
 	if _OPTIONS["platformapi"] == "win32gl"     then _platforms = { "x32" };       defines { "APIABSTRACTION_OGL=1", "APIABSTRACTION_GLPC=1", "PE_PLAT_API=0x0104", "PE_PLAT_IS_WIN32=1", "PE_API_IS_GL=1" } end
+	if _OPTIONS["platformapi"] == "linux-headless" then _platforms = { "x64" };    defines { "APIABSTRACTION_HEADLESS=1", "PE_PLAT_API=0x1008", "PE_PLAT_IS_LINUX=1", "PE_API_IS_HEADLESS=1", "PE_64_BIT=1" } end
 	
 	platforms(_platforms)
 	
@@ -44,6 +46,11 @@ solution("PEWorkspace-".._OPTIONS["platformapi"])
 		defines { "__USE_IOS_GLES__" }
 	end
 	
+	if _OPTIONS["platformapi"] == "linux-headless" then
+		buildoptions { "-Wno-write-strings" } -- engine code passes string literals as char *
+		links { "pthread", "rt", "dl" }
+	end
+	
 	flags { "EnableSSE", "EnableSSE2" }
 	
 	flags { "NoIncrementalLink" }
@@ -94,6 +101,9 @@ solution("PEWorkspace-".._OPTIONS["platformapi"])
 		flags { "Optimize" }
 	
 	dofile("CharacterControl/premake4-charactercontrol.lua")
+	if (_OPTIONS["platformapi"] ~= "ios") then
+		dofile("Benchmark/premake4-benchmark.lua")
+	end
 
 	dofile("lua_dist/premake4-lua_dist.lua")
 	dofile("luasocket_dist/premake4-luasocket_dist.lua")
@@ -2,10 +2,23 @@
 #define PE_GLOBAL_CONFIG_H
 
 #define PE_SERVER_PORT 1660
+// server sockets are serviced through SocketPoller. select() fallback is limited by FD_SETSIZE (64 on windows)
+#if defined(__linux__)
+#define PE_SERVER_MAX_CONNECTIONS 512
+#else
 #define PE_SERVER_MAX_CONNECTIONS 32
+#endif
 #define PE_CLIENT_LUA_COMMAND_SERVER_PORT 1417
 #define PE_SERVER_LUA_COMMAND_SERVER_PORT 1500
 
+// binary stats stream for local tools (Tools/PyClient/telemetry.py). see Profiling/Telemetry.h
+#define PE_ENABLE_TELEMETRY 1
+#define PE_TELEMETRY_PORT 1419
+#define PE_TELEMETRY_MAX_READERS 4
+#define PE_TELEMETRY_DEFAULT_RATE 10 // samples per second, readers can request their own rate
+#define PE_TELEMETRY_MAX_RATE 240
+#define PE_TELEMETRY_MAX_PENDING_BYTES (64 * 1024) // per reader. samples are dropped while reader is behind
+
 
 #define PE_CLIENT_TO_SERVER_CONNECT_TIMEOUT 1000
 
@@ -15,6 +28,53 @@
 
 #define PE_SOCKET_SEND_STEPSIZE 8192
 #define PE_SOCKET_RECEIVE_BUFFER_SIZE 8192
+// packets that didn't fit in socket send buffer wait in connection's send queue. if queue grows over this
+// the other side is not reading and connection is dropped
+#define PE_SOCKET_SEND_QUEUE_MAX_BYTES (64 * 1024)
+
+// udp transport: connection is dropped if nothing is received for CONNECTION_TIMEOUT seconds.
+// ack only datagram is sent if nothing else was sent for KEEPALIVE_INTERVAL seconds
+#define PE_UDP_CONNECTION_TIMEOUT 10.0
+#define PE_UDP_KEEPALIVE_INTERVAL 0.5
+
+// server simulation runs at fixed tick rate (can be changed with l_setServerTickRate()). late ticks are run
+// back to back up to MAX_CATCH_UP_TICKS, beyond that ticks are skipped
+#define PE_SERVER_TICK_RATE 60
+#define PE_SERVER_MAX_CATCH_UP_TICKS 4
+// server thread sleeps until this many seconds before next tick and yields the rest, since sleep overshoots
+#define PE_SERVER_SLEEP_MARGIN 0.002
+// seconds between server tick stats printed to log
+#define PE_SERVER_TICK_REPORT_INTERVAL 10.0
+
+// job system worker threads shared by game, render and server threads. -1: number of cpus minus game and render thread
+#define PE_JOB_SYSTEM_NUM_WORKERS -1
+#define PE_JOB_SYSTEM_MAX_WORKERS 16
+// jobs per worker queue, power of 2. kicking a job into a full queue runs it right away
+#define PE_JOB_QUEUE_SIZE 256
+// jobs waiting for a dependency (JobSystem::kickAfter()). when full kickAfter() waits for the dependency
+#define PE_JOB_SYSTEM_MAX_DEFERRED_JOBS 128
+
+// frames of draw lists (and other per frame render data) in flight between game and render thread.
+// game thread can gather frame N+1 and N+2 while render thread draws frame N. 2 is plain double buffering
+#define PE_NUM_FRAMES_IN_FLIGHT 3
+
+// per object shader constants of a frame are written linearly into one ring buffer (ConstantBufferRing) and draws
+// bind ranges of it. needs d3d11.1 constant buffer offsets, other apis set constants as before
+#define PE_CONSTANT_BUFFER_RING_SIZE (4 * 1024 * 1024)
+// one api error check per frame after swap instead of after every call. IRenderer::m_validateFrame toggles it at runtime
+#define PE_RENDER_VALIDATE_FRAME 1
+// clustered light assignment (LightClusters): screen tiles x, y and exponential depth slices of view frustum
+#define PE_LIGHT_CLUSTERS_TILES_X 16
+#define PE_LIGHT_CLUSTERS_TILES_Y 8
+#define PE_LIGHT_CLUSTERS_SLICES 24
+#define PE_LIGHT_CLUSTERS_MAX_LIGHTS 4096
+// PEINFO/PEWARN only record format and arguments into a ring of the calling thread, log thread formats and writes them (AsyncLog).
+// 0 formats and prints on calling thread
+#define PE_LOG_ASYNC 1
+#define PE_LOG_RING_SIZE (64 * 1024) // bytes per thread
+#define PE_LOG_MAX_THREADS 16 // threads past this log synchronously
+#define PE_LOG_RATE_LIMIT 32 // messages per call site per second, more are counted and dropped
+#define PE_LOG_BINARY_FILE "PELog.bin" // every message in binary form, Tools/PyClient/logdump.py expands it
 
 
 
@@ -39,9 +99,80 @@
 #define PE_MAX_FRAMES_IN_ANIMATION (30)
 #define PE_MAX_ANIMATIONS_IN_BUFFER (16)
 
+// cpu skinning (SkinningCPU): meshes with more vertices are split into jobs of this many vertices
+#define PE_SKINNING_CPU_VERTICES_PER_JOB 1024
+
+// cpu particles (ParticleSimulationCPU): alive particles of all emitters, spawns over it are dropped.
+// emitters are integrated in jobs of PER_JOB particles
+#define PE_PARTICLES_CPU_FRAME_BUDGET (64 * 1024)
+#define PE_PARTICLES_CPU_PER_JOB 2048
+
+
+// glyph batched text (TextBatcher): glyphs per frame of all screen space and all in world text.
+// more are dropped. 4 vertices per glyph must fit 16 bit indices (<= 16384)
+#define PE_TEXT_MAX_OVERLAY_GLYPHS 12288
+#define PE_TEXT_MAX_WORLD_GLYPHS 2048
+
+// hot reload (HotReloadManager): a watcher thread reloads scripts, shaders, meshes and textures changed on disk.
+// prepared reloads are swapped in at start of game frames, at most FRAME_BUDGET_MS of swap work per frame (at least
+// one reload). a file is reloaded when it was not written to for SETTLE_MS
+#define PE_HOT_RELOAD 1
+#define PE_HOT_RELOAD_FRAME_BUDGET_MS 4.0f
+#define PE_HOT_RELOAD_SETTLE_MS 100
+
+// lua bytecode cache (LuaScriptCache): dofile(), loadfile() and LuaEnvironment::runScript() use compiled chunks of
+// scripts whose source did not change. MAX_SCRIPTS are kept in memory. with DISK compiled chunks are also written to
+// AssetsOut/.luacache for next runs. off by default: source has to be read and hashed anyway, for the small object
+// scripts of levels reading a disk entry costs about as much as compiling
+#define PE_LUA_BYTECODE_CACHE 1
+#define PE_LUA_BYTECODE_CACHE_MAX_SCRIPTS 1024
+#define PE_LUA_BYTECODE_CACHE_DISK 0
+
+// lua profiler (LuaProfiler): 1 samples lua of game thread from start and writes LuaProfile.* to game project root
+// at exit. a sample every INSTRUCTIONS_PER_SAMPLE vm instructions, of at most MAX_DEPTH frames
+#define PE_LUA_PROFILER 0
+#define PE_LUA_PROFILER_INSTRUCTIONS_PER_SAMPLE 1000
+#define PE_LUA_PROFILER_MAX_DEPTH 32
+#define PE_LUA_PROFILER_REPORT_ROWS 40
+
+// crowd local avoidance (CrowdSimulation): 1 steers walking soldiers around each other and standing soldiers.
+// agents avoid their MAX_NEIGHBORS nearest within NEIGHBOR_DIST (also cell size of spatial hash) for TIME_HORIZON
+// seconds ahead, in jobs of AGENTS_PER_JOB. preferred velocity is pushed away from agents closer than SEPARATION_RANGE
+// x combined radius (by WEIGHT x max speed at contact) and slowed behind agents in own lane within QUEUE_DISTANCE.
+// a soldier that is held back for BLOCKED_TIME seconds within ARRIVAL_SLACK of its waypoint counts as arrived
+#define PE_CROWD 1
+#define PE_CROWD_DEFAULT_RADIUS 0.75f
+#define PE_CROWD_MAX_NEIGHBORS 10
+#define PE_CROWD_NEIGHBOR_DIST 6.0f
+#define PE_CROWD_TIME_HORIZON 1.5f
+#define PE_CROWD_AGENTS_PER_JOB 64
+#define PE_CROWD_SEPARATION_RANGE 1.2f
+#define PE_CROWD_SEPARATION_WEIGHT 0.5f
+#define PE_CROWD_QUEUE_DISTANCE 0.5f
+#define PE_CROWD_ARRIVAL_SLACK 2.0f
+#define PE_CROWD_BLOCKED_TIME 1.0f
+
 
 #define PE_MAX_NUM_OF_BUFFER_STEPS (64)
 
+// texture streaming: textures start with mips up to INITIAL_MIP_SIZE resident, higher mips are streamed
+// in based on on-screen size and least recently used mips are evicted when over budget
+#define PE_TEXTURE_STREAMING 1
+#define PE_TEXTURE_STREAMING_BUDGET_MB 128
+#define PE_TEXTURE_STREAMING_INITIAL_MIP_SIZE 64
+#define PE_TEXTURE_STREAMING_UPLOAD_KB_PER_FRAME 4096
+
+// mesh optimization: Tools/MeshOptimizer/meshoptimizer.py does it offline. this enables triangle and vertex
+// reordering for vertex cache and fetch locality at load time for meshes that were not optimized offline
+#define PE_OPTIMIZE_MESHES_ON_LOAD 0
+#define PE_MESH_OPTIMIZER_REPORT_CACHE_SIZE 16 // FIFO cache size for ACMR report
+
+// packed vertex formats: DetailedMesh/DetailedSkin geometry is uploaded as DetailedMeshPacked/DetailedSkinPacked
+// (half float tex coords, octahedral snorm16 normals and tangents, 8 bit skin weights and indices) unless
+// MeshCPU::m_usePackedVertexFormat is cleared or tex coords are outside of +-MAX_TEXCOORD (half float precision)
+#define PE_PACKED_VERTEX_FORMATS 1
+#define PE_PACKED_VERTEX_FORMATS_MAX_TEXCOORD 4.0f
+
 //code genration control
 
 #define PE_PERFORM_REDUNDANCY_MEMORY_CHECKS 0
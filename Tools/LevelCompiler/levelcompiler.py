@@ -0,0 +1,227 @@
+# levelcompiler.py
+# compiles a .levela (list of LevelLoader.CreateGameObject() calls) together with the meta scripts
+# it references into a binary .levelb that PrimeEngine loads natively (see CompiledLevelLoader.h)
+#
+# usage: python levelcompiler.py <AssetsOut path> <package> <level.levela> [<level.levela> ...]
+#   e.g. python levelcompiler.py ../../AssetsOut CharacterControl ccontrollvl0.x_level.levela
+#
+# objects whose meta script uses StaticMesh.lua, Skin.lua or LightSource.lua are flattened into
+# native records. everything else is written as a script record and still runs through Lua.
+
+import os
+import re
+import struct
+import sys
+
+MAGIC = 0x424C4550 # 'PELB'
+VERSION = 3
+
+RECORD_STATIC_MESH = 0
+RECORD_SKIN = 1
+RECORD_LIGHT = 2
+RECORD_SCRIPT = 3
+
+# magic, version, numRecords, stringTableSize, size and FNV-1a hash of .levela, numDependencies
+HEADER_FORMAT = '<7I'
+# meta script name, package, size and FNV-1a hash. every meta script that was read is one
+DEPENDENCY_FORMAT = '<4I'
+# type, name, matrix[16], peuuid[4], mesh/skel/animset name+package, default animset/anim,
+# lightType, isShadowCaster, diffuse[4], spec[4], ambient[4], attenuation[3], spotPower, range,
+# metaScript, metaScriptPackage
+RECORD_FORMAT = '<2I16f4I6I2i2I4f4f4f3f2f2I'
+
+LIGHT_TYPES = {'point' : 0, 'directional' : 1, 'spot' : 2}
+
+createGameObjectRe = re.compile(r'^\s*LevelLoader\.CreateGameObject\((.*)\)\s*$')
+metaAssignRe = re.compile(r'''^\s*args\[['"](\w+)['"]\]\s*=\s*(.+?)\s*$''')
+
+class StringTable:
+    def __init__(self):
+        self.data = '\0' # offset 0 is the empty string
+        self.offsets = {'' : 0}
+    def add(self, s):
+        if s is None:
+            s = ''
+        if s not in self.offsets:
+            self.offsets[s] = len(self.data)
+            self.data += s + '\0'
+        return self.offsets[s]
+
+def splitArgs(argString):
+    # splits on commas that are not inside quotes
+    args = []
+    cur = ''
+    quote = None
+    for c in argString:
+        if quote:
+            cur += c
+            if c == quote:
+                quote = None
+        elif c in '\'"':
+            quote = c
+            cur += c
+        elif c == ',':
+            args.append(cur.strip())
+            cur = ''
+        else:
+            cur += c
+    if cur.strip() != '':
+        args.append(cur.strip())
+    return args
+
+def parseLuaValue(v):
+    v = v.strip()
+    if v.endswith(';'):
+        v = v[:-1].strip()
+    if len(v) >= 2 and v[0] == v[-1] and v[0] in '\'"':
+        return v[1:-1]
+    if v.startswith('{') and v.endswith('}'):
+        return [parseLuaValue(x) for x in splitArgs(v[1:-1])]
+    if v == 'true':
+        return True
+    if v == 'false':
+        return False
+    if v == 'nil':
+        return None
+    try:
+        if v.lower().startswith('0x'):
+            return int(v, 16)
+        return float(v)
+    except ValueError:
+        raise ValueError('unsupported lua value: ' + v)
+
+def readMetaScript(path):
+    # returns dictionary of args[] assignments, or None if script does anything we can not flatten
+    args = {}
+    for line in open(path, 'r'):
+        line = line.split('--', 1)[0].strip()
+        if line == '' or line.startswith('function fillMetaInfoTable') or line == 'end':
+            continue
+        m = metaAssignRe.match(line)
+        if not m:
+            return None
+        try:
+            args[m.group(1)] = parseLuaValue(m.group(2))
+        except ValueError:
+            return None
+    return args
+
+def floats(args, key, count):
+    v = args.get(key)
+    if not isinstance(v, list) or len(v) != count:
+        raise KeyError(key)
+    return [float(x) for x in v]
+
+def buildRecord(strings, name, matrix, metaScript, metaScriptPackage, peuuid, meta):
+    rec = {
+        'type' : RECORD_SCRIPT,
+        'mesh' : ('', ''), 'skel' : ('', ''), 'animset' : ('', ''),
+        'defaultAnim' : (-1, -1),
+        'lightType' : 0, 'isShadowCaster' : 0,
+        'diffuse' : [0.0] * 4, 'spec' : [0.0] * 4, 'ambient' : [0.0] * 4, 'attenuation' : [0.0] * 3,
+        'spotPower' : 0.0, 'range' : 0.0,
+    }
+    try:
+        if meta is not None and meta.get('myScriptPackage') == 'Default':
+            script = meta.get('myScript')
+            if script == 'StaticMesh.lua':
+                rec['mesh'] = (meta['meshName'], meta['meshPackage'])
+                rec['type'] = RECORD_STATIC_MESH
+            elif script == 'Skin.lua':
+                rec['mesh'] = (meta['meshName'], meta['meshPackage'])
+                rec['skel'] = (meta['skelName'], meta['skelPackage'])
+                rec['animset'] = (meta['animsetName'], meta['animsetPackage'])
+                if meta.get('defaultAnimSet') is not None and meta.get('defaultAnim') is not None:
+                    rec['defaultAnim'] = (int(meta['defaultAnimSet']), int(meta['defaultAnim']))
+                rec['type'] = RECORD_SKIN
+            elif script == 'LightSource.lua':
+                rec['lightType'] = LIGHT_TYPES.get(meta['lightType'], 0)
+                rec['isShadowCaster'] = 1 if meta.get('isShadowCaster') else 0
+                rec['diffuse'] = floats(meta, 'diffuse', 4)
+                rec['spec'] = floats(meta, 'spec', 4)
+                rec['ambient'] = floats(meta, 'ambient', 4)
+                rec['attenuation'] = floats(meta, 'attenuation', 3)
+                rec['spotPower'] = float(meta['spotPower'])
+                rec['range'] = float(meta['range'])
+                rec['type'] = RECORD_LIGHT
+    except KeyError:
+        # incomplete meta data, let Lua deal with it the same way it does for .levela
+        rec['type'] = RECORD_SCRIPT
+
+    values = [rec['type'], strings.add(name)] + matrix + peuuid
+    for (assetName, assetPackage) in (rec['mesh'], rec['skel'], rec['animset']):
+        values += [strings.add(assetName), strings.add(assetPackage)]
+    values += list(rec['defaultAnim'])
+    values += [rec['lightType'], rec['isShadowCaster']]
+    values += rec['diffuse'] + rec['spec'] + rec['ambient'] + rec['attenuation']
+    values += [rec['spotPower'], rec['range']]
+    values += [strings.add(metaScript), strings.add(metaScriptPackage)]
+    return rec['type'], struct.pack(RECORD_FORMAT, *values)
+
+# same hash as CompiledLevelLoader checks the .levela and meta scripts against
+def fnv1a(data):
+    h = 2166136261
+    for b in bytearray(data):
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+def compileLevel(assetsOut, package, levelName):
+    levelPath = os.path.join(assetsOut, package, 'Levels', levelName)
+    outPath = re.sub(r'\.levela$', '.levelb', levelPath)
+    if outPath == levelPath:
+        print('Error: %s is not a .levela file' % levelPath)
+        return False
+
+    strings = StringTable()
+    records = []
+    dependencies = {} # (metaScript, metaScriptPackage) -> packed dependency, loader checks them before using records
+    counts = [0, 0, 0, 0]
+    for line in open(levelPath, 'r'):
+        m = createGameObjectRe.match(line)
+        if not m:
+            if line.strip() != '':
+                print('Warning: skipping unsupported line in %s: %s' % (levelName, line.strip()))
+            continue
+        args = [parseLuaValue(a) for a in splitArgs(m.group(1))]
+        name = args[0]
+        matrix = [float(x) for x in args[1:17]]
+        metaScript, metaScriptPackage = args[17], args[18]
+        peuuid = [int(x) & 0xFFFFFFFF for x in args[19:23]]
+        if len(peuuid) != 4:
+            peuuid = [0, 0, 0, 0]
+
+        meta = None
+        if metaScriptPackage != 'Raw':
+            metaPath = os.path.join(assetsOut, metaScriptPackage, 'Levels', metaScript)
+            if os.path.exists(metaPath):
+                meta = readMetaScript(metaPath)
+                if (metaScript, metaScriptPackage) not in dependencies:
+                    metaSource = open(metaPath, 'rb').read()
+                    dependencies[(metaScript, metaScriptPackage)] = struct.pack(DEPENDENCY_FORMAT,
+                        strings.add(metaScript), strings.add(metaScriptPackage), len(metaSource), fnv1a(metaSource))
+
+        recType, packed = buildRecord(strings, name, matrix, metaScript, metaScriptPackage, peuuid, meta)
+        counts[recType] += 1
+        records.append(packed)
+
+    f = open(outPath, 'wb')
+    source = open(levelPath, 'rb').read()
+    f.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, len(records), len(strings.data), len(source), fnv1a(source), len(dependencies)))
+    for r in records:
+        f.write(r)
+    for key in sorted(dependencies):
+        f.write(dependencies[key])
+    f.write(strings.data.encode('latin-1') if sys.version_info[0] >= 3 else strings.data)
+    f.close()
+
+    print('Compiled %s: %d static meshes, %d skins, %d lights, %d scripted objects, %d meta scripts' % (outPath, counts[RECORD_STATIC_MESH], counts[RECORD_SKIN], counts[RECORD_LIGHT], counts[RECORD_SCRIPT], len(dependencies)))
+    return True
+
+if __name__ == '__main__':
+    if len(sys.argv) < 4:
+        print('usage: python levelcompiler.py <AssetsOut path> <package> <level.levela> [<level.levela> ...]')
+        sys.exit(1)
+    ok = True
+    for level in sys.argv[3:]:
+        ok = compileLevel(sys.argv[1], sys.argv[2], level) and ok
+    sys.exit(0 if ok else 1)
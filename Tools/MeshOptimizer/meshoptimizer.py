@@ -0,0 +1,335 @@
+# meshoptimizer.py
+# offline optimization of exported meshes (.mesha and the buffers it references)
+#   1. removes duplicate vertices (exact match of every vertex stream: position, texcoord, normal, tangent,
+#      skin weights and blend shape streams). exporters write one vertex per triangle corner
+#   2. reorders triangles inside every bone segment for post-transform vertex cache
+#      (Tom Forsyth's linear-speed vertex cache optimization)
+#   3. reorders vertices in order of first use by the index buffer, for vertex fetch locality
+#
+# triangles never move between bone segments or material ranges, so draw calls stay the same.
+# prints ACMR (average cache miss ratio: transformed vertices per triangle, FIFO cache) before and after.
+#
+# usage: python meshoptimizer.py [--write] [--cache N] <AssetsOut path> [<package> ...]
+#   without --write only the report is printed. with --write the buffers are rewritten in place
+#   e.g. python meshoptimizer.py ../../AssetsOut Default CharacterControl
+
+import os
+import sys
+
+REPORT_CACHE_SIZE = 16 # FIFO cache size used for ACMR report (post-transform cache of older gpus)
+
+# maya exporter and fbx exporter write different headers, engine does not check them
+POSITION_HEADERS = ('VERTEX_BUFFER', 'POSITION_BUFFER_V1')
+TEXCOORD_HEADERS = ('TEXCOORD_BUFFER', 'TEX_COORD_BUFFER')
+
+# Forsyth scoring
+FS_CACHE_SIZE = 32
+FS_CACHE_DECAY_POWER = 1.5
+FS_LAST_TRI_SCORE = 0.75
+FS_VALENCE_BOOST_SCALE = 2.0
+FS_VALENCE_BOOST_POWER = 0.5
+
+class Stream:
+    # one vertex attribute file. values are kept as strings so that unchanged data is written back exactly
+    def __init__(self, folder, filename, headers, valuesPerVertex):
+        self.folder = folder
+        self.filename = filename
+        self.headers = headers # accepted headers. the one read is written back
+        self.header = None
+        self.valuesPerVertex = valuesPerVertex
+        self.vertices = []
+
+    def path(self, packagePath):
+        return os.path.join(packagePath, self.folder, self.filename)
+
+    def read(self, packagePath):
+        tokens = open(self.path(packagePath), 'r').read().split()
+        if tokens[0] not in self.headers:
+            raise ValueError('%s: expected %s' % (self.filename, ' or '.join(self.headers)))
+        self.header = tokens[0]
+        n = int(tokens[1])
+        pos = 2
+        for i in range(n):
+            if self.valuesPerVertex is None:
+                # skin weights: count followed by (joint, weight, local joint) triples
+                nj = int(tokens[pos])
+                self.vertices.append(tuple(tokens[pos:pos + 1 + nj * 3]))
+                pos += 1 + nj * 3
+            else:
+                self.vertices.append(tuple(tokens[pos:pos + self.valuesPerVertex]))
+                pos += self.valuesPerVertex
+
+    def write(self, packagePath):
+        f = open(self.path(packagePath), 'w')
+        f.write('%s\n%d\n' % (self.header, len(self.vertices)))
+        for v in self.vertices:
+            if self.valuesPerVertex is None:
+                f.write('%s\n' % v[0])
+                for j in range(int(v[0])):
+                    f.write('%s\n' % ' '.join(v[1 + j * 3: 4 + j * 3]))
+            else:
+                f.write('%s\n' % ' '.join(v))
+        f.close()
+
+class IndexBuffer:
+    def __init__(self, filename):
+        self.filename = filename
+        self.ranges = [] # list of ranges, range is list of bone segments: (bones, indices)
+
+    def path(self, packagePath):
+        return os.path.join(packagePath, 'IndexBuffers', self.filename)
+
+    def read(self, packagePath):
+        tokens = open(self.path(packagePath), 'r').read().split()
+        if tokens[0] != 'INDEX_BUFFER' or int(tokens[1]) != 3:
+            raise ValueError('%s: only triangle index buffers are supported' % self.filename)
+        numSets = int(tokens[3])
+        pos = 4
+        for s in range(numSets):
+            segments = []
+            numSegments = int(tokens[pos]); pos += 1
+            for b in range(numSegments):
+                numBones = int(tokens[pos]); pos += 1
+                bones = tokens[pos:pos + numBones]; pos += numBones
+                numPolys = int(tokens[pos]); pos += 1
+                indices = [int(x) for x in tokens[pos:pos + numPolys * 3]]; pos += numPolys * 3
+                segments.append((bones, indices))
+            self.ranges.append(segments)
+
+    def allIndices(self):
+        res = []
+        for segments in self.ranges:
+            for (bones, indices) in segments:
+                res += indices
+        return res
+
+    def remap(self, remap):
+        self.ranges = [[(bones, [remap[i] for i in indices]) for (bones, indices) in segments] for segments in self.ranges]
+
+    def write(self, packagePath):
+        f = open(self.path(packagePath), 'w')
+        f.write('INDEX_BUFFER\n3\n%d\n%d\n' % (len(self.allIndices()) // 3, len(self.ranges)))
+        for segments in self.ranges:
+            f.write('%d\n' % len(segments))
+            for (bones, indices) in segments:
+                f.write('%d\n' % len(bones))
+                if len(bones):
+                    f.write('%s \n' % ' '.join(bones))
+                f.write('%d\n' % (len(indices) // 3))
+                for t in range(0, len(indices), 3):
+                    f.write('%d %d %d \n' % (indices[t], indices[t + 1], indices[t + 2]))
+        f.close()
+
+def computeACMR(indices, cacheSize = None):
+    # FIFO post-transform cache simulation
+    cacheSize = cacheSize or REPORT_CACHE_SIZE
+    if len(indices) == 0:
+        return 0.0
+    cache = []
+    inCache = set()
+    misses = 0
+    for i in indices:
+        if i not in inCache:
+            misses += 1
+            cache.append(i)
+            inCache.add(i)
+            if len(cache) > cacheSize:
+                inCache.discard(cache.pop(0))
+    return float(misses) / (len(indices) // 3)
+
+def forsythVertexScore(cachePos, remainingValence):
+    if remainingValence == 0:
+        return -1.0
+    score = 0.0
+    if cachePos >= 0:
+        if cachePos < 3:
+            score = FS_LAST_TRI_SCORE
+        else:
+            score = (1.0 - float(cachePos - 3) / (FS_CACHE_SIZE - 3)) ** FS_CACHE_DECAY_POWER
+    return score + FS_VALENCE_BOOST_SCALE * (remainingValence ** -FS_VALENCE_BOOST_POWER)
+
+def optimizeTriangleOrder(indices):
+    numTris = len(indices) // 3
+    if numTris <= 1:
+        return list(indices)
+
+    vertTris = {}
+    for t in range(numTris):
+        for k in range(3):
+            vertTris.setdefault(indices[t * 3 + k], []).append(t)
+
+    remaining = dict((v, len(tris)) for (v, tris) in vertTris.items())
+    cachePos = dict((v, -1) for v in vertTris)
+    vertScore = dict((v, forsythVertexScore(-1, remaining[v])) for v in vertTris)
+    triScore = [sum(vertScore[indices[t * 3 + k]] for k in range(3)) for t in range(numTris)]
+    triAdded = [False] * numTris
+
+    cache = []
+    result = []
+    bestTri = max(range(numTris), key = lambda t: triScore[t])
+    nextUnadded = 0
+    while bestTri >= 0:
+        triAdded[bestTri] = True
+        tri = indices[bestTri * 3: bestTri * 3 + 3]
+        result += tri
+
+        for v in tri:
+            remaining[v] -= 1
+            vertTris[v].remove(bestTri)
+            if v in cache:
+                cache.remove(v)
+            cache.insert(0, v)
+
+        evicted = cache[FS_CACHE_SIZE:]
+        cache = cache[:FS_CACHE_SIZE]
+        for v in evicted:
+            cachePos[v] = -1
+
+        # rescore vertices in cache (and evicted ones) and their triangles
+        touched = set()
+        for (pos, v) in enumerate(cache):
+            cachePos[v] = pos
+        for v in cache + evicted:
+            newScore = forsythVertexScore(cachePos[v], remaining[v])
+            delta = newScore - vertScore[v]
+            vertScore[v] = newScore
+            for t in vertTris[v]:
+                triScore[t] += delta
+                touched.add(t)
+
+        bestTri = -1
+        bestScore = -1.0
+        for t in touched:
+            if triScore[t] > bestScore:
+                bestScore = triScore[t]
+                bestTri = t
+
+        if bestTri < 0:
+            # cache has nothing useful. take next triangle that is left
+            while nextUnadded < numTris and triAdded[nextUnadded]:
+                nextUnadded += 1
+            if nextUnadded < numTris:
+                bestTri = nextUnadded
+    return result
+
+def readMesh(packagePath, meshFilename):
+    lines = [l.strip() for l in open(os.path.join(packagePath, 'Meshes', meshFilename), 'r') if l.strip() != '']
+    if lines[0] != 'MESH':
+        raise ValueError('%s is not a mesh' % meshFilename)
+
+    streams = [Stream('PositionBuffers', lines[1], POSITION_HEADERS, 3)]
+    ib = IndexBuffer(lines[2])
+    if lines[3] != 'none':
+        streams.append(Stream('TexCoordBuffers', lines[3], TEXCOORD_HEADERS, 2))
+    if lines[4] != 'none':
+        streams.append(Stream('NormalBuffers', lines[4], ('NORMAL_BUFFER',), 3))
+    if lines[5] != 'none':
+        streams.append(Stream('TangentBuffers', lines[5], ('TANGENT_BUFFER',), 3))
+    if len(lines) > 7 and lines[7] != 'none':
+        streams.append(Stream('SkinWeights', lines[7], ('SKIN_WEIGHTS',), None))
+    # blend shapes: position, texcoord, normal triples after skin weights
+    for i in range(8, len(lines) - 2, 3):
+        streams.append(Stream('PositionBuffers', lines[i], POSITION_HEADERS, 3))
+        streams.append(Stream('TexCoordBuffers', lines[i + 1], TEXCOORD_HEADERS, 2))
+        streams.append(Stream('NormalBuffers', lines[i + 2], ('NORMAL_BUFFER',), 3))
+
+    for s in streams:
+        s.read(packagePath)
+    ib.read(packagePath)
+
+    numVerts = len(streams[0].vertices)
+    for s in streams:
+        if len(s.vertices) != numVerts:
+            raise ValueError('%s: %s has %d vertices, position buffer has %d' % (meshFilename, s.filename, len(s.vertices), numVerts))
+    return streams, ib
+
+def applyVertexRemap(streams, ib, remap, newCount):
+    # remap[old] = new. several old vertices can map to the same new one (duplicates)
+    for s in streams:
+        newVertices = [None] * newCount
+        for (old, new) in enumerate(remap):
+            if new >= 0:
+                newVertices[new] = s.vertices[old]
+        s.vertices = newVertices
+    ib.remap(remap)
+
+def optimizeMesh(packagePath, meshFilename, write, sharedFiles):
+    streams, ib = readMesh(packagePath, meshFilename)
+    numVertsBefore = len(streams[0].vertices)
+    acmrBefore = computeACMR(ib.allIndices())
+
+    files = [s.path(packagePath) for s in streams] + [ib.path(packagePath)]
+    if any(sharedFiles.get(f, 0) > 1 for f in files):
+        print('%-50s skipped: buffers are shared with other meshes' % meshFilename)
+        return
+
+    # 1. dedupe
+    unique = {}
+    remap = []
+    for v in range(numVertsBefore):
+        key = tuple(s.vertices[v] for s in streams)
+        remap.append(unique.setdefault(key, len(unique)))
+    applyVertexRemap(streams, ib, remap, len(unique))
+
+    # 2. triangle order inside each bone segment
+    ib.ranges = [[(bones, optimizeTriangleOrder(indices)) for (bones, indices) in segments] for segments in ib.ranges]
+
+    # 3. vertex order of first use. unreferenced vertices are dropped
+    remap = [-1] * len(unique)
+    numUsed = 0
+    for i in ib.allIndices():
+        if remap[i] < 0:
+            remap[i] = numUsed
+            numUsed += 1
+    applyVertexRemap(streams, ib, remap, numUsed)
+
+    acmrAfter = computeACMR(ib.allIndices())
+    print('%-50s verts %6d -> %6d   ACMR %.3f -> %.3f' % (meshFilename, numVertsBefore, numUsed, acmrBefore, acmrAfter))
+
+    if write:
+        for s in streams:
+            s.write(packagePath)
+        ib.write(packagePath)
+
+def countBufferUsage(packagePath, meshFilenames):
+    # buffers referenced by more than one mesh can't be reordered for just one of them
+    usage = {}
+    for m in meshFilenames:
+        try:
+            streams, ib = readMesh(packagePath, m)
+        except (ValueError, IOError, IndexError):
+            continue
+        for f in set([s.path(packagePath) for s in streams] + [ib.path(packagePath)]):
+            usage[f] = usage.get(f, 0) + 1
+    return usage
+
+def optimizePackage(assetsOut, package, write):
+    packagePath = os.path.join(assetsOut, package)
+    meshesPath = os.path.join(packagePath, 'Meshes')
+    if not os.path.isdir(meshesPath):
+        return
+    meshFilenames = sorted([m for m in os.listdir(meshesPath) if m.endswith('.mesha')])
+    usage = countBufferUsage(packagePath, meshFilenames)
+    print('%s:' % package)
+    for m in meshFilenames:
+        try:
+            optimizeMesh(packagePath, m, write, usage)
+        except (ValueError, IOError, IndexError) as e:
+            print('%-50s skipped: %s' % (m, e))
+
+if __name__ == '__main__':
+    args = sys.argv[1:]
+    write = '--write' in args
+    if write:
+        args.remove('--write')
+    if '--cache' in args:
+        i = args.index('--cache')
+        REPORT_CACHE_SIZE = int(args[i + 1])
+        del args[i:i + 2]
+    if len(args) < 1:
+        print('usage: python meshoptimizer.py [--write] [--cache N] <AssetsOut path> [<package> ...]')
+        sys.exit(1)
+    packages = args[1:] or sorted(os.listdir(args[0]))
+    print('ACMR is computed with %d entry FIFO cache%s' % (REPORT_CACHE_SIZE, '' if write else ' (report only, use --write to rewrite buffers)'))
+    for p in packages:
+        optimizePackage(args[0], p, write)
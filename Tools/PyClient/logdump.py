@@ -0,0 +1,177 @@
+# Expands binary log written by the engine's log thread (see Code/PrimeEngine/Logging/AsyncLog.cpp) into text
+# usage: python logdump.py [PELog.bin] [--severity info|warning|error] [--category name] [--thread n]
+import sys
+import re
+import struct
+
+FILE_VERSION = 2
+
+RECORD_SITE = 1
+RECORD_MESSAGE = 2
+RECORD_DROPPED = 3
+
+SEVERITIES = ('Info', 'Warning', 'Error')
+CATEGORIES = ('General', 'Render', 'Scene', 'Network', 'Game', 'Events')
+
+ARG_INT, ARG_LONG, ARG_LONGLONG, ARG_SIZET, ARG_DOUBLE, ARG_POINTER, ARG_STRING = range(7)
+FLAG_PREFORMATTED = 1
+TRUNCATED_BIT = 0x8000 # in suppressed of message: arguments didn't fit in record, message ends after last recorded one
+
+# printf conversion: flags, width, precision, length modifier, conversion
+CONVERSION = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|q|j|z|t|I64|I)?([diuoxXceEfFgGaAspn%])')
+
+class Site:
+    def __init__(self, id, severity, category, flags, line, file, format, kinds):
+        self.id = id
+        self.severity = severity
+        self.category = category
+        self.flags = flags
+        self.line = line
+        self.file = file
+        self.format = format
+        self.kinds = kinds
+
+def decodeArgs(site, data):
+    args = []
+    offset = 0
+    kinds = (ARG_STRING,) if site.flags & FLAG_PREFORMATTED else site.kinds
+    for kind in kinds:
+        if offset >= len(data):
+            break
+        if kind == ARG_STRING:
+            length, = struct.unpack_from('<H', data, offset)
+            args.append(data[offset + 2:offset + 2 + length].decode('latin-1'))
+            offset += 2 + length
+        elif kind == ARG_DOUBLE:
+            args.append(struct.unpack_from('<d', data, offset)[0])
+            offset += 8
+        else:
+            args.append(struct.unpack_from('<q', data, offset)[0])
+            offset += 8
+    return args
+
+# formats like printf of the engine would have: python % formatting without c length modifiers
+def formatMessage(site, args):
+    if site.flags & FLAG_PREFORMATTED:
+        return args[0] if args else ''
+
+    out = []
+    pos = 0
+    args = list(args)
+    for m in CONVERSION.finditer(site.format):
+        out.append(site.format[pos:m.start()])
+        pos = m.end()
+        flags, width, precision, length, conversion = m.groups()
+        if conversion == '%':
+            out.append('%')
+            continue
+        if width == '*':
+            width = str(args.pop(0)) if args else ''
+        if precision == '*':
+            precision = str(args.pop(0)) if args else ''
+        if not args:
+            return ''.join(out) # truncated record, engine stops here too
+        value = args.pop(0)
+        spec = '%' + flags + (width or '') + ('.' + precision if precision is not None else '')
+        if conversion == 'p':
+            out.append((spec + 'x') % (value & 0xffffffffffffffff))
+        elif conversion in 'uoxX' and isinstance(value, int):
+            bits = 32 if length in (None, 'h', 'hh') else 64
+            out.append((spec + ('d' if conversion == 'u' else conversion)) % (value & ((1 << bits) - 1)))
+        elif conversion in 'di' and length in (None, 'h', 'hh'):
+            value &= 0xffffffff
+            out.append((spec + 'd') % (value - (1 << 32) if value & 0x80000000 else value))
+        elif conversion == 'c':
+            out.append((spec + 'c') % chr(value & 0xff))
+        elif conversion in 'aA':
+            out.append(float(value).hex())
+        else:
+            out.append((spec + conversion) % value)
+    out.append(site.format[pos:])
+    return ''.join(out)
+
+# yields (kind, ...) tuples: ('message', site, timeMs, thread, suppressed, text), ('dropped', thread, count).
+# text of truncated messages ends with ' (truncated)'
+def readLog(data):
+    if data[0:4] != b'PELG':
+        raise ValueError('not an engine binary log')
+    version, = struct.unpack_from('<I', data, 4)
+    if version != FILE_VERSION:
+        raise ValueError('log version %d, expected %d' % (version, FILE_VERSION))
+
+    sites = {}
+    offset = 8
+    while offset < len(data):
+        type = data[offset]
+        offset += 1
+        if type == RECORD_SITE:
+            id, severity, category, flags, line, fileLen = struct.unpack_from('<IBBBIH', data, offset)
+            offset += 13
+            file = data[offset:offset + fileLen].decode('latin-1')
+            offset += fileLen
+            formatLen, = struct.unpack_from('<H', data, offset)
+            offset += 2
+            format = data[offset:offset + formatLen].decode('latin-1')
+            offset += formatLen
+            numArgs = data[offset]
+            kinds = tuple(data[offset + 1:offset + 1 + numArgs])
+            offset += 1 + numArgs
+            sites[id] = Site(id, severity, category, flags, line, file, format, kinds)
+        elif type == RECORD_MESSAGE:
+            id, timeMs, thread, suppressed, size = struct.unpack_from('<IIBHH', data, offset)
+            offset += 13
+            site = sites[id]
+            text = formatMessage(site, decodeArgs(site, data[offset:offset + size]))
+            if suppressed & TRUNCATED_BIT:
+                text += ' (truncated)'
+                suppressed &= ~TRUNCATED_BIT
+            offset += size
+            yield ('message', site, timeMs, thread, suppressed, text)
+        elif type == RECORD_DROPPED:
+            thread, count = struct.unpack_from('<BI', data, offset)
+            offset += 5
+            yield ('dropped', thread, count)
+        else:
+            raise ValueError('bad record type %d at %d' % (type, offset - 1))
+
+def main(args):
+    filename = 'PELog.bin'
+    minSeverity = 0
+    category = None
+    thread = None
+    i = 0
+    while i < len(args):
+        if args[i] == '--severity':
+            minSeverity = [s.lower() for s in SEVERITIES].index(args[i + 1].lower())
+            i += 2
+        elif args[i] == '--category':
+            category = [c.lower() for c in CATEGORIES].index(args[i + 1].lower())
+            i += 2
+        elif args[i] == '--thread':
+            thread = int(args[i + 1])
+            i += 2
+        else:
+            filename = args[i]
+            i += 1
+
+    with open(filename, 'rb') as f:
+        data = f.read()
+
+    for record in readLog(data):
+        if record[0] == 'dropped':
+            if thread is None or record[1] == thread:
+                print('           [%2d] log ring full, %d messages dropped' % (record[1], record[2]))
+            continue
+        kind, site, timeMs, recordThread, suppressed, text = record
+        if site.severity < minSeverity or (category is not None and site.category != category):
+            continue
+        if thread is not None and recordThread != thread:
+            continue
+        line = '%10.3f [%2d] %s %s: %s' % (timeMs / 1000.0, recordThread, SEVERITIES[site.severity],
+            CATEGORIES[site.category] if site.category < len(CATEGORIES) else site.category, text.rstrip('\n'))
+        if suppressed:
+            line += ' (%d more suppressed by rate limit)' % suppressed
+        print(line)
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
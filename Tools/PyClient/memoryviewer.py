@@ -43,6 +43,9 @@ class MemoryViewer:
         
         self.total = Tkinter.Label(self.reportFrame2, text=         "Total Memory Used: %d MB", justify = Tkinter.LEFT)
         self.total.pack(side=Tkinter.TOP)
+        
+        self.textures = Tkinter.Label(self.reportFrame2, text=      "Textures Resident: %d MB", justify = Tkinter.LEFT)
+        self.textures.pack(side=Tkinter.TOP)
             
         self.frames = []
         self.labelsToDestroy = []
@@ -100,6 +103,10 @@ class MemoryViewer:
             i += 1
         self.totalAllocated.config(text="Total Memory Allocated: %d MB" % (allocated / (1024*1024)))
         self.total.config(text="Total Memory Used: %d MB (%d%s)" % (used / (1024*1024), int(float(used)*100/float(allocated)), '%'))
+        if 'textures' in dict:
+            t = dict['textures']
+            self.textures.config(text="Textures Resident: %.1f / %.1f MB (%d pending, %d streamed, %d mips in, %d evicted)" % (
+                float(t['resident']) / (1024*1024), float(t['budget']) / (1024*1024), t['pending'], t['streamed'], t['in'], t['evicted']))
 ######################################################################
 
 # Create demo in root window for testing.
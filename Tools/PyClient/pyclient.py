@@ -52,6 +52,29 @@ class CodeTemplate_l_clientConnectToTCPServer(CodeTemplate):
         #self.textEntry.delete('1.0', 'end')
         self.textEntry.insert(INSERT, 'root.PE.Components.ClientNetworkManager.l_clientConnectToTCPServer(l_getGameContext(), "127.0.0.1", 0)\n')
 
+class CodeTemplate_l_clientConnectToUDPServer(CodeTemplate):
+    def __init__(self, frame, textEntry):
+        CodeTemplate.__init__(self, frame, 'l_clientConnectToUDPServer()', textEntry)
+    def produce(self):
+        #self.textEntry.delete('1.0', 'end')
+        self.textEntry.insert(INSERT, 'root.PE.Components.ClientNetworkManager.l_clientConnectToUDPServer(l_getGameContext(), "127.0.0.1", 0)\n')
+
+class CodeTemplate_UdpLoopbackBenchmark(CodeTemplate):
+    def __init__(self, frame, textEntry):
+        CodeTemplate.__init__(self, frame, 'UdpLoopbackBenchmark', textEntry)
+    def produce(self):
+        #self.textEntry.delete('1.0', 'end')
+        self.textEntry.insert(INSERT, '--l_runUdpLoopbackBenchmark(context, <frames at 60hz>, <loss percent>, <latency ms>, <jitter ms>)\n')
+        self.textEntry.insert(INSERT, 'root.PE.Components.ConnectionManager.l_runUdpLoopbackBenchmark(l_getGameContext(), 600, 10, 50, 10)\n')
+
+class CodeTemplate_GhostLoopbackBenchmark(CodeTemplate):
+    def __init__(self, frame, textEntry):
+        CodeTemplate.__init__(self, frame, 'GhostLoopbackBenchmark', textEntry)
+    def produce(self):
+        #self.textEntry.delete('1.0', 'end')
+        self.textEntry.insert(INSERT, '--l_runLoopbackBenchmark(context, <clients>, <objects>, <frames at 60hz>)\n')
+        self.textEntry.insert(INSERT, 'root.PE.Components.GhostManager.l_runLoopbackBenchmark(l_getGameContext(), 32, 64, 600)\n')
+
 class CodeTemplate_OutputDebugString(CodeTemplate):
     def __init__(self, frame, textEntry):
         CodeTemplate.__init__(self, frame, "OutputDebugString", textEntry)
@@ -317,6 +340,9 @@ class PyClient:
         self.textEntry.pack(side=BOTTOM)
  
         CodeTemplate_l_clientConnectToTCPServer(self.debugFrame, self.textEntry)
+        CodeTemplate_l_clientConnectToUDPServer(self.debugFrame, self.textEntry)
+        CodeTemplate_GhostLoopbackBenchmark(self.debugFrame, self.textEntry)
+        CodeTemplate_UdpLoopbackBenchmark(self.debugFrame, self.textEntry)
         CodeTemplate_l_changeRenderMode(self.debugFrame, self.textEntry)
         CodeTemplate_OutputDebugString(self.debugFrame, self.textEntry)
         CodeTemplate_CreateSoldier(self.createFrame, self.textEntry)
@@ -0,0 +1,111 @@
+# Reader for binary telemetry stream of the engine (see Code/PrimeEngine/Profiling/Telemetry.h)
+# usage: python telemetry.py [host] [port] [rate]
+import sys
+import socket
+import struct
+
+PROTOCOL_VERSION = 1
+DEFAULT_PORT = 1419
+
+RECORD_HELLO = 1
+RECORD_FRAME = 2
+RECORD_POOLS = 3
+RECORD_NETWORK = 4
+RECORD_SERVER_TICK = 5
+RECORD_SAMPLE_END = 6
+
+FRAME_FIELDS = ('frameIndex', 'frames', 'gameTime', 'maxFrameTime', 'frameTime', 'betweenFrames',
+    'preDraw', 'drawWait', 'draw', 'postDraw', 'events')
+NETWORK_FIELDS = ('connected', 'transport', 'bytesSent', 'bytesReceived', 'eventsScheduled',
+    'eventsResent', 'duplicateEvents', 'sendQueueBytes', 'udpPacketsSent', 'udpPacketsLost', 'rttMs')
+SERVER_TICK_FIELDS = ('tickRate', 'ticks', 'cpuAvgMs', 'cpuMaxMs', 'idlePercent', 'skipped')
+
+class TelemetryReader:
+    def __init__(self, host = '127.0.0.1', port = DEFAULT_PORT, rate = None):
+        self.sock = socket.create_connection((host, port))
+        self.buf = b''
+        self.pools = [] # (block size, number of blocks)
+        self.sample = {}
+        if rate:
+            self.setRate(rate)
+
+    def setRate(self, rate):
+        self.sock.sendall(struct.pack('<I', rate))
+
+    def close(self):
+        self.sock.close()
+
+    # returns next complete sample as dict: 'frame', 'pools', 'network', 'serverTick' (if available)
+    def readSample(self):
+        while True:
+            sample = self.parse()
+            if sample is not None:
+                return sample
+            data = self.sock.recv(65536)
+            if not data:
+                raise EOFError('engine closed telemetry connection')
+            self.buf += data
+
+    # parses records in buffer, returns sample once its end record is parsed
+    def parse(self):
+        while len(self.buf) >= 4:
+            type, pad, size = struct.unpack_from('<BBH', self.buf, 0)
+            if len(self.buf) < size:
+                return None
+            body = self.buf[4:size]
+            self.buf = self.buf[size:]
+
+            if type == RECORD_HELLO:
+                version, rate, numPools = struct.unpack_from('<IIH', body, 0)
+                if version != PROTOCOL_VERSION:
+                    raise ValueError('telemetry version %d, reader supports %d' % (version, PROTOCOL_VERSION))
+                self.pools = [struct.unpack_from('<II', body, 10 + i * 8) for i in range(numPools)]
+            elif type == RECORD_FRAME:
+                self.sample['frame'] = dict(zip(FRAME_FIELDS, struct.unpack_from('<IIffffffffI', body, 0)))
+            elif type == RECORD_POOLS:
+                numPools = struct.unpack_from('<H', body, 0)[0]
+                used = struct.unpack_from('<%dI' % numPools, body, 2)
+                self.sample['pools'] = [{'bs': bs, 'nb': nb, 'used': u} for ((bs, nb), u) in zip(self.pools, used)]
+            elif type == RECORD_NETWORK:
+                self.sample['network'] = dict(zip(NETWORK_FIELDS, struct.unpack_from('<BBIIIIIIIIf', body, 0)))
+            elif type == RECORD_SERVER_TICK:
+                self.sample['serverTick'] = dict(zip(SERVER_TICK_FIELDS, struct.unpack_from('<HIfffI', body, 0)))
+            elif type == RECORD_SAMPLE_END:
+                sample = self.sample
+                self.sample = {}
+                return sample
+            # unknown records are skipped
+        return None
+
+def formatSample(sample, prev):
+    f = sample['frame']
+    line = 'frame %d: %.2f ms (max %.2f ms, %d frames) draw wait %.2f ms, %d events' % (
+        f['frameIndex'], f['frameTime'] * 1000.0, f['maxFrameTime'] * 1000.0, f['frames'], f['drawWait'] * 1000.0, f['events'])
+    if 'pools' in sample:
+        used = sum(p['bs'] * p['used'] for p in sample['pools'])
+        allocated = sum(p['bs'] * p['nb'] for p in sample['pools'])
+        line += ' | mem %.1f/%.1f MB' % (used / (1024.0 * 1024.0), allocated / (1024.0 * 1024.0))
+    if 'network' in sample:
+        n = sample['network']
+        if prev and 'network' in prev:
+            p = prev['network']
+            line += ' | net +%d B out +%d B in' % (n['bytesSent'] - p['bytesSent'], n['bytesReceived'] - p['bytesReceived'])
+        line += ' resent %d lost %d rtt %.1f ms' % (n['eventsResent'], n['udpPacketsLost'], n['rttMs'])
+    if 'serverTick' in sample:
+        s = sample['serverTick']
+        line += ' | server %d Hz cpu %.2f ms idle %.0f%%' % (s['tickRate'], s['cpuAvgMs'], s['idlePercent'])
+    return line
+
+if __name__ == '__main__':
+    host = sys.argv[1] if len(sys.argv) > 1 else '127.0.0.1'
+    port = int(sys.argv[2]) if len(sys.argv) > 2 else DEFAULT_PORT
+    rate = int(sys.argv[3]) if len(sys.argv) > 3 else None
+    reader = TelemetryReader(host, port, rate)
+    prev = None
+    try:
+        while True:
+            sample = reader.readSample()
+            print(formatSample(sample, prev))
+            prev = sample
+    except (KeyboardInterrupt, EOFError):
+        reader.close()